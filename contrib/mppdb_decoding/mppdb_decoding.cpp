@@ -17,7 +17,22 @@
  * mppdb_decoding.cpp
  *        logical decoding output plugin (json)
  *
+ * With output-format 'binary', the changes are sent in a binary format
+ * instead, which spares the text conversion of the values. Integers are in
+ * network byte order, and names are a uint32 length followed by the bytes.
  *
+ *   'B' xid(8)                            BEGIN
+ *   'C' xid(8) csn(8) commit time(8)      COMMIT
+ *   'S' xid(8), 'E' xid(8)                start, end of a streamed block
+ *   'A' xid(8)                            abort of a streamed transaction
+ *   'c' xid(8) csn(8) commit time(8)      commit of a streamed transaction
+ *   'I' | 'U' | 'D' table name            a change, followed by the new tuple,
+ *       ['N' tuple] ['O' tuple]           and the old key if there is one
+ *
+ * A tuple is the number of columns(2), and for each column its name, type
+ * oid(4) and value: 'n' for null, 'u' for an unchanged toasted value, 'b'
+ * length(4) and the binary send format of the type, or 't' length(4) and the
+ * text output if the type has no send function.
  *
  * IDENTIFICATION
  *        contrib/mppdb_decoding/mppdb_decoding.cpp
@@ -32,6 +47,7 @@
 #include "catalog/pg_class.h"
 #include "catalog/pg_type.h"
 
+#include "libpq/pqformat.h"
 #include "nodes/parsenodes.h"
 
 #include "replication/output_plugin.h"
@@ -62,8 +78,26 @@ typedef struct {
     bool skip_empty_xacts;
     bool xact_wrote_changes;
     bool only_local;
+    bool in_streamed_block;
+    bool binary_format;
+    MemoryContext relcache_context; /* for binary_relcache, lives as long as the decoding */
+    HTAB* binary_relcache;          /* BinaryRelEntry by relation oid */
 } TestDecodingData;
 
+/*
+ * The send functions of the columns of a relation, so the binary format
+ * doesn't look up the types for every column of every change. The entry is
+ * rebuilt when the column types of the relation no longer match.
+ */
+typedef struct BinaryRelEntry {
+    Oid relid; /* hash key */
+    int natts;
+    Oid* typids;
+    bool* typisvarlena;
+    bool* hassend;     /* false when the type has no send function, and funcs is its output function */
+    FmgrInfo* funcs;
+} BinaryRelEntry;
+
 static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions* opt, bool is_init);
 static void pg_decode_shutdown(LogicalDecodingContext* ctx);
 static void pg_decode_begin_txn(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
@@ -73,6 +107,14 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
 static void pg_decode_change(
     LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation rel, ReorderBufferChange* change);
 static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id);
+static void pg_output_binary_event(StringInfo out, char type, ReorderBufferTXN* txn, bool committed);
+static void pg_decode_change_binary(LogicalDecodingContext* ctx, Relation relation, ReorderBufferChange* change);
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_output_stream_start(
+    LogicalDecodingContext* ctx, TestDecodingData* data, ReorderBufferTXN* txn, bool last_write);
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
 void _PG_init(void)
 {
@@ -90,6 +132,10 @@ void _PG_output_plugin_init(OutputPluginCallbacks* cb)
     cb->commit_cb = pg_decode_commit_txn;
     cb->filter_by_origin_cb = pg_decode_filter;
     cb->shutdown_cb = pg_decode_shutdown;
+    cb->stream_start_cb = pg_decode_stream_start;
+    cb->stream_stop_cb = pg_decode_stream_stop;
+    cb->stream_abort_cb = pg_decode_stream_abort;
+    cb->stream_commit_cb = pg_decode_stream_commit;
 }
 
 /* initialize this plugin */
@@ -104,6 +150,12 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
         ALLOCSET_DEFAULT_MINSIZE,
         ALLOCSET_DEFAULT_INITSIZE,
         ALLOCSET_DEFAULT_MAXSIZE);
+    data->relcache_context = AllocSetContextCreate(ctx->context,
+        "binary relation cache",
+        ALLOCSET_SMALL_MINSIZE,
+        ALLOCSET_SMALL_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE);
+    data->binary_relcache = NULL;
     data->include_xids = true;
     data->include_timestamp = false;
     data->skip_empty_xacts = false;
@@ -161,6 +213,23 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                 ereport(ERROR,
                     (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                         errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
+        } else if (strcmp(elem->defname, "output-format") == 0) {
+            if (elem->arg == NULL || strcmp(strVal(elem->arg), "json") == 0)
+                data->binary_format = false;
+            else if (strcmp(strVal(elem->arg), "binary") == 0)
+                data->binary_format = true;
+            else
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
+        } else if (strcmp(elem->defname, "stream-changes") == 0) {
+
+            if (elem->arg == NULL)
+                opt->streaming = true;
+            else if (!parse_bool(strVal(elem->arg), &opt->streaming))
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
         } else {
             ereport(ERROR,
                 (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -168,6 +237,9 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                         "option \"%s\" = \"%s\" is unknown", elem->defname, elem->arg ? strVal(elem->arg) : "(null)")));
         }
     }
+
+    if (data->binary_format)
+        opt->output_type = OUTPUT_PLUGIN_BINARY_OUTPUT;
 }
 
 /* cleanup this plugin's resources */
@@ -177,6 +249,7 @@ static void pg_decode_shutdown(LogicalDecodingContext* ctx)
 
     /* cleanup our own resources via memory context reset */
     MemoryContextDelete(data->context);
+    MemoryContextDelete(data->relcache_context);
 }
 
 /* BEGIN callback */
@@ -194,7 +267,9 @@ static void pg_decode_begin_txn(LogicalDecodingContext* ctx, ReorderBufferTXN* t
 static void pg_output_begin(LogicalDecodingContext* ctx, TestDecodingData* data, ReorderBufferTXN* txn, bool last_write)
 {
     OutputPluginPrepareWrite(ctx, last_write);
-    if (data->include_xids)
+    if (data->binary_format)
+        pg_output_binary_event(ctx->out, 'B', txn, false);
+    else if (data->include_xids)
         appendStringInfo(ctx->out, "BEGIN %lu", txn->xid);
     else
         appendStringInfoString(ctx->out, "BEGIN");
@@ -210,6 +285,12 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
         return;
 
     OutputPluginPrepareWrite(ctx, true);
+    if (data->binary_format) {
+        pg_output_binary_event(ctx->out, 'C', txn, true);
+        OutputPluginWrite(ctx, true);
+        return;
+    }
+
     if (data->include_xids)
         appendStringInfo(ctx->out, "COMMIT %lu", txn->xid);
     else
@@ -222,6 +303,98 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
     OutputPluginWrite(ctx, true);
 }
 
+/* start of a block of changes of a transaction that is still in progress */
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    data->in_streamed_block = true;
+    data->xact_wrote_changes = false;
+    if (data->skip_empty_xacts)
+        return;
+
+    pg_output_stream_start(ctx, data, txn, true);
+}
+
+static void pg_output_stream_start(
+    LogicalDecodingContext* ctx, TestDecodingData* data, ReorderBufferTXN* txn, bool last_write)
+{
+    OutputPluginPrepareWrite(ctx, last_write);
+    if (data->binary_format)
+        pg_output_binary_event(ctx->out, 'S', txn, false);
+    else if (data->include_xids)
+        appendStringInfo(ctx->out, "opening a streamed block for transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "opening a streamed block for transaction");
+    OutputPluginWrite(ctx, last_write);
+}
+
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    data->in_streamed_block = false;
+    if (data->skip_empty_xacts && !data->xact_wrote_changes)
+        return;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->binary_format)
+        pg_output_binary_event(ctx->out, 'E', txn, false);
+    else if (data->include_xids)
+        appendStringInfo(ctx->out, "closing a streamed block for transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "closing a streamed block for transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->binary_format)
+        pg_output_binary_event(ctx->out, 'A', txn, false);
+    else if (data->include_xids)
+        appendStringInfo(ctx->out, "aborting streamed transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "aborting streamed transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->binary_format) {
+        pg_output_binary_event(ctx->out, 'c', txn, true);
+        OutputPluginWrite(ctx, true);
+        return;
+    }
+
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "committing streamed transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "committing streamed transaction");
+
+    if (data->include_timestamp)
+        appendStringInfo(ctx->out, " (at %s)", timestamptz_to_str(txn->commit_time));
+    appendStringInfo(ctx->out, " CSN %lu", txn->csn);
+
+    OutputPluginWrite(ctx, true);
+}
+
+/* a transaction boundary in the binary format */
+static void pg_output_binary_event(StringInfo out, char type, ReorderBufferTXN* txn, bool committed)
+{
+    pq_sendbyte(out, (uint8)type);
+    pq_sendint64(out, (uint64)txn->xid);
+    if (committed) {
+        pq_sendint64(out, (uint64)txn->csn);
+        pq_sendint64(out, (uint64)txn->commit_time);
+    }
+}
+
 static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id)
 {
     TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
@@ -356,6 +529,207 @@ static void tuple_to_jsoninfo(
         cJSON_AddItemToArray(cols_val, col_val);
     }
 }
+/* free the arrays of a BinaryRelEntry */
+static void binary_rel_entry_free(BinaryRelEntry* entry)
+{
+    if (entry->natts == 0)
+        return;
+    pfree(entry->typids);
+    pfree(entry->typisvarlena);
+    pfree(entry->hassend);
+    pfree(entry->funcs);
+    entry->natts = 0;
+}
+
+/* the cached send functions of the columns of relation, see BinaryRelEntry */
+static BinaryRelEntry* get_binary_rel_entry(TestDecodingData* data, Relation relation)
+{
+    TupleDesc tupdesc = RelationGetDescr(relation);
+    Oid relid = RelationGetRelid(relation);
+    BinaryRelEntry* entry = NULL;
+    bool found = false;
+    bool valid = false;
+    MemoryContext old;
+    int natt;
+
+    if (data->binary_relcache == NULL) {
+        HASHCTL ctl;
+        errno_t rc = memset_s(&ctl, sizeof(ctl), 0, sizeof(ctl));
+        securec_check(rc, "", "");
+        ctl.keysize = sizeof(Oid);
+        ctl.entrysize = sizeof(BinaryRelEntry);
+        ctl.hash = oid_hash;
+        ctl.hcxt = data->relcache_context;
+        data->binary_relcache =
+            hash_create("mppdb_decoding binary relations", 128, &ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+    }
+
+    entry = (BinaryRelEntry*)hash_search(data->binary_relcache, &relid, HASH_ENTER, &found);
+    if (!found)
+        entry->natts = 0;
+
+    valid = found && entry->natts == tupdesc->natts;
+    for (natt = 0; valid && natt < tupdesc->natts; natt++)
+        valid = (entry->typids[natt] == tupdesc->attrs[natt]->atttypid);
+    if (valid)
+        return entry;
+
+    binary_rel_entry_free(entry);
+    old = MemoryContextSwitchTo(data->relcache_context);
+    entry->typids = (Oid*)palloc0(sizeof(Oid) * Max(tupdesc->natts, 1));
+    entry->typisvarlena = (bool*)palloc0(sizeof(bool) * Max(tupdesc->natts, 1));
+    entry->hassend = (bool*)palloc0(sizeof(bool) * Max(tupdesc->natts, 1));
+    entry->funcs = (FmgrInfo*)palloc0(sizeof(FmgrInfo) * Max(tupdesc->natts, 1));
+    MemoryContextSwitchTo(old);
+
+    for (natt = 0; natt < tupdesc->natts; natt++) {
+        Form_pg_attribute attr = tupdesc->attrs[natt];
+        HeapTuple typeTuple;
+        Form_pg_type pt;
+        Oid func;
+
+        entry->typids[natt] = attr->atttypid;
+        if (attr->attisdropped || attr->attnum < 0)
+            continue;
+
+        typeTuple = SearchSysCache1(TYPEOID, ObjectIdGetDatum(attr->atttypid));
+        if (!HeapTupleIsValid(typeTuple))
+            ereport(ERROR,
+                (errcode(ERRCODE_CACHE_LOOKUP_FAILED), errmsg("cache lookup failed for type %u", attr->atttypid)));
+        pt = (Form_pg_type)GETSTRUCT(typeTuple);
+        entry->typisvarlena[natt] = (!pt->typbyval) && (pt->typlen == -1);
+        entry->hassend[natt] = OidIsValid(pt->typsend);
+        func = entry->hassend[natt] ? pt->typsend : pt->typoutput;
+        ReleaseSysCache(typeTuple);
+
+        fmgr_info_cxt(func, &entry->funcs[natt], data->relcache_context);
+    }
+    entry->natts = tupdesc->natts;
+    return entry;
+}
+
+static void binary_append_name(StringInfo s, const char* name)
+{
+    uint32 len = (uint32)strlen(name);
+
+    pq_sendint32(s, len);
+    pq_sendbytes(s, name, (int)len);
+}
+
+/* append the tuple 'tuple' to s in the binary format */
+static void tuple_to_binary(
+    StringInfo s, TupleDesc tupdesc, const BinaryRelEntry* entry, HeapTuple tuple, bool skip_nulls)
+{
+    int natt;
+    int countpos = s->len;
+    uint16 count = 0;
+    errno_t rc = EOK;
+
+    /* the number of columns, filled in at the end */
+    pq_sendint16(s, 0);
+    if (HEAP_TUPLE_IS_COMPRESSED(tuple->t_data))
+        return;
+    if ((int)HeapTupleHeaderGetNatts(tuple->t_data, tupdesc) > tupdesc->natts)
+        return;
+
+    for (natt = 0; natt < tupdesc->natts; natt++) {
+        Form_pg_attribute attr = tupdesc->attrs[natt];
+        Oid typid = attr->atttypid;
+        Datum origval;
+        bool isnull = false;
+
+        /* see tuple_to_jsoninfo() */
+        if (attr->attisdropped || attr->attnum < 0)
+            continue;
+
+        origval = heap_getattr(tuple, natt + 1, tupdesc, &isnull);
+        if (isnull && skip_nulls)
+            continue;
+
+        binary_append_name(s, NameStr(attr->attname));
+        pq_sendint32(s, (uint32)typid);
+        count++;
+
+        if (isnull) {
+            pq_sendbyte(s, 'n');
+            continue;
+        }
+
+        if (entry->typisvarlena[natt] && VARATT_IS_EXTERNAL_ONDISK_B(origval)) {
+            pq_sendbyte(s, 'u');
+            continue;
+        }
+        if (entry->typisvarlena[natt])
+            origval = PointerGetDatum(PG_DETOAST_DATUM(origval));
+
+        if (entry->hassend[natt]) {
+            bytea* val = SendFunctionCall(&entry->funcs[natt], origval);
+
+            pq_sendbyte(s, 'b');
+            pq_sendint32(s, (uint32)(VARSIZE(val) - VARHDRSZ));
+            pq_sendbytes(s, VARDATA(val), (int)(VARSIZE(val) - VARHDRSZ));
+        } else {
+            char* val = OutputFunctionCall(&entry->funcs[natt], origval);
+
+            pq_sendbyte(s, 't');
+            pq_sendint32(s, (uint32)strlen(val));
+            pq_sendbytes(s, val, (int)strlen(val));
+        }
+    }
+
+    count = htons(count);
+    rc = memcpy_s(s->data + countpos, sizeof(uint16), &count, sizeof(uint16));
+    securec_check(rc, "", "");
+}
+
+/* the change callback of the binary format */
+static void pg_decode_change_binary(LogicalDecodingContext* ctx, Relation relation, ReorderBufferChange* change)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+    TupleDesc tupdesc = RelationGetDescr(relation);
+    BinaryRelEntry* entry = get_binary_rel_entry(data, relation);
+    MemoryContext old;
+    char op;
+
+    switch (change->action) {
+        case REORDER_BUFFER_CHANGE_INSERT:
+            op = 'I';
+            break;
+        case REORDER_BUFFER_CHANGE_UPDATE:
+            op = 'U';
+            break;
+        case REORDER_BUFFER_CHANGE_DELETE:
+            op = 'D';
+            break;
+        default:
+            Assert(false);
+            return;
+    }
+
+    /* Avoid leaking memory by using and resetting our own context */
+    old = MemoryContextSwitchTo(data->context);
+
+    OutputPluginPrepareWrite(ctx, true);
+
+    pq_sendbyte(ctx->out, (uint8)op);
+    binary_append_name(ctx->out,
+        quote_qualified_identifier(
+            get_namespace_name(RelationGetNamespace(relation)), NameStr(RelationGetForm(relation)->relname)));
+
+    if (change->action != REORDER_BUFFER_CHANGE_DELETE && change->data.tp.newtuple != NULL) {
+        pq_sendbyte(ctx->out, 'N');
+        tuple_to_binary(ctx->out, tupdesc, entry, &change->data.tp.newtuple->tuple, false);
+    }
+    if (change->action != REORDER_BUFFER_CHANGE_INSERT && change->data.tp.oldtuple != NULL) {
+        pq_sendbyte(ctx->out, 'O');
+        tuple_to_binary(ctx->out, tupdesc, entry, &change->data.tp.oldtuple->tuple, true);
+    }
+
+    MemoryContextSwitchTo(old);
+    MemoryContextReset(data->context);
+    OutputPluginWrite(ctx, true);
+}
+
 /*
  * callback for individual changed tuples
  */
@@ -369,12 +743,20 @@ static void pg_decode_change(
     char* res = NULL;
     data = (TestDecodingData*)ctx->output_plugin_private;
 
-    /* output BEGIN if we haven't yet */
+    /* output BEGIN, or the start of the streamed block, if we haven't yet */
     if (data->skip_empty_xacts && !data->xact_wrote_changes) {
-        pg_output_begin(ctx, data, txn, false);
+        if (data->in_streamed_block)
+            pg_output_stream_start(ctx, data, txn, false);
+        else
+            pg_output_begin(ctx, data, txn, false);
     }
     data->xact_wrote_changes = true;
 
+    if (data->binary_format) {
+        pg_decode_change_binary(ctx, relation, change);
+        return;
+    }
+
     class_form = RelationGetForm(relation);
     tupdesc = RelationGetDescr(relation);
 
@@ -45,6 +45,7 @@ typedef struct {
     bool skip_empty_xacts;
     bool xact_wrote_changes;
     bool only_local;
+    bool in_streamed_block;
 } TestDecodingData;
 
 static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions* opt, bool is_init);
@@ -56,6 +57,12 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
 static void pg_decode_change(
     LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation rel, ReorderBufferChange* change);
 static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id);
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_output_stream_start(
+    LogicalDecodingContext* ctx, TestDecodingData* data, ReorderBufferTXN* txn, bool last_write);
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
 void _PG_init(void)
 {
@@ -73,6 +80,10 @@ void _PG_output_plugin_init(OutputPluginCallbacks* cb)
     cb->commit_cb = pg_decode_commit_txn;
     cb->filter_by_origin_cb = pg_decode_filter;
     cb->shutdown_cb = pg_decode_shutdown;
+    cb->stream_start_cb = pg_decode_stream_start;
+    cb->stream_stop_cb = pg_decode_stream_stop;
+    cb->stream_abort_cb = pg_decode_stream_abort;
+    cb->stream_commit_cb = pg_decode_stream_commit;
 }
 
 /* initialize this plugin */
@@ -144,6 +155,14 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                 ereport(ERROR,
                     (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                         errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
+        } else if (strcmp(elem->defname, "stream-changes") == 0) {
+
+            if (elem->arg == NULL)
+                opt->streaming = true;
+            else if (!parse_bool(strVal(elem->arg), &opt->streaming))
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
         } else {
             ereport(ERROR,
                 (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -205,6 +224,75 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
     OutputPluginWrite(ctx, true);
 }
 
+/* start of a block of changes of a transaction that is still in progress */
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    data->in_streamed_block = true;
+    data->xact_wrote_changes = false;
+    if (data->skip_empty_xacts)
+        return;
+
+    pg_output_stream_start(ctx, data, txn, true);
+}
+
+static void pg_output_stream_start(
+    LogicalDecodingContext* ctx, TestDecodingData* data, ReorderBufferTXN* txn, bool last_write)
+{
+    OutputPluginPrepareWrite(ctx, last_write);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "opening a streamed block for transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "opening a streamed block for transaction");
+    OutputPluginWrite(ctx, last_write);
+}
+
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    data->in_streamed_block = false;
+    if (data->skip_empty_xacts && !data->xact_wrote_changes)
+        return;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "closing a streamed block for transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "closing a streamed block for transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "aborting streamed transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "aborting streamed transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "committing streamed transaction %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "committing streamed transaction");
+
+    if (data->include_timestamp)
+        appendStringInfo(ctx->out, " (at %s)", timestamptz_to_str(txn->commit_time));
+    appendStringInfo(ctx->out, " CSN %lu", txn->csn);
+
+    OutputPluginWrite(ctx, true);
+}
+
 static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id)
 {
     TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
@@ -354,9 +442,12 @@ static void pg_decode_change(
 
     data = (TestDecodingData*)ctx->output_plugin_private;
 
-    /* output BEGIN if we haven't yet */
+    /* output BEGIN, or the start of the streamed block, if we haven't yet */
     if (data->skip_empty_xacts && !data->xact_wrote_changes) {
-        pg_output_begin(ctx, data, txn, false);
+        if (data->in_streamed_block)
+            pg_output_stream_start(ctx, data, txn, false);
+        else
+            pg_output_begin(ctx, data, txn, false);
     }
     data->xact_wrote_changes = true;
 
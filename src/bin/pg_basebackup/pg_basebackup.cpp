@@ -40,6 +40,8 @@
 #include "receivelog.h"
 #include "streamutil.h"
 #include "bin/elog.h"
+#include "replication/basebackup.h"
+#include "bin/backup_stream.h"
 
 /* Global options */
 char *basedir = NULL;
@@ -52,6 +54,12 @@ int compresslevel = 0;
 bool includewal = true;
 bool streamwal = true;
 bool fastcheckpoint = false;
+/* start location of an incremental backup merged into basedir, NULL for a full backup */
+char *incremental_lsn = NULL;
+/* number of parallel streams of the backup */
+int backup_jobs = 1;
+/* ask the server to compress the streams with LZ4 */
+bool stream_compress = false;
 
 extern char **tblspaceDirectory;
 extern int tblspaceCount;
@@ -63,6 +71,10 @@ extern int standby_message_timeout; /* 10 sec = default */
 static uint64 totalsize;
 static uint64 totaldone;
 
+/* the streams of a parallel backup are received by several threads */
+#define ADD_TOTALDONE(n) ((void)__sync_fetch_and_add(&totaldone, (uint64)(n)))
+
+/* State of applying the incremental tar member being received, see IncrementalFileHeader */
 /* Pipe to communicate with background wal receiver process */
 #ifndef WIN32
 static int bgpipe[2] = {-1, -1};
@@ -86,7 +98,8 @@ static void verify_dir_is_empty_or_create(char *dirname);
 static void progress_report(int tablespacenum, const char *filename);
 
 static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum);
-static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum);
+static bool ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum);
+static void check_incremental_start_location(const char *dirname);
 static void BaseBackup(void);
 static void backup_dw_file(const char *target_dir);
 
@@ -120,6 +133,12 @@ static void usage(void)
     printf(_("  %s [OPTION]...\n"), progname);
     printf(_("\nOptions controlling the output:\n"));
     printf(_("  -D, --pgdata=DIRECTORY receive base backup into directory\n"));
+    printf(_("  -i, --incremental=LSN  receive only blocks changed since LSN, and merge them into\n"
+        "                         the previous backup in directory; LSN must not be past the\n"
+        "                         START WAL LOCATION in its backup_label\n"));
+    printf(_("  -j, --jobs=NUM         receive the backup in NUM parallel streams\n"));
+    printf(_("  -C, --stream-compression=lz4\n"
+        "                         compress the backup streams on the server\n"));
     printf(_("\nGeneral options:\n"));
     printf(_("  -c, --checkpoint=fast|spread\n"
         "                         set fast or spread checkpointing\n"));
@@ -379,8 +398,11 @@ static void verify_dir_is_empty_or_create(char *dirname)
         case 2:
 
             /*
-             * Exists, not empty
+             * Exists, not empty. That's expected when merging an incremental
+             * backup into the previous one.
              */
+            if (incremental_lsn != NULL)
+                return;
             fprintf(stderr, _("%s: directory \"%s\" exists but is not empty\n"), progname, dirname);
             disconnect_and_exit(1);
         case -1:
@@ -496,6 +518,7 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 #define MAX_REALPATH_LEN 4096
     char filename[MAXPGPATH];
     char *copybuf = NULL;
+    char *recvbuf = NULL;
     FILE *tarfile = NULL;
     errno_t errorno = EOK;
     char Lrealpath[MAX_REALPATH_LEN + 1] = {0};
@@ -607,12 +630,12 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
     }
 
     while (true) {
-        if (copybuf != NULL) {
-            PQfreemem(copybuf);
-            copybuf = NULL;
+        if (recvbuf != NULL) {
+            PQfreemem(recvbuf);
+            recvbuf = NULL;
         }
 
-        int r = PQgetCopyData(conn, &copybuf, 0);
+        int r = PQgetCopyData(conn, &recvbuf, 0);
         if (r == -1) {
             /*
              * End of chunk. Close file (but not stdout).
@@ -665,6 +688,12 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
             disconnect_and_exit(1);
         }
 
+        copybuf = recvbuf;
+        if (stream_compress && (r = DecompressBackupData(recvbuf, r, &copybuf)) < 0) {
+            fprintf(stderr, _("%s: could not decompress COPY data\n"), progname);
+            disconnect_and_exit(1);
+        }
+
 #ifdef HAVE_LIBZ
         if (ztarfile != NULL) {
             writeGzFile(ztarfile, copybuf, r, filename);
@@ -676,14 +705,14 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
                 disconnect_and_exit(1);
             }
         }
-        totaldone += r;
-        if (showprogress)
+        ADD_TOTALDONE(r);
+        if (showprogress && !InBackupStreamThread)
             progress_report(rownum, filename);
     } /* while (1) */
 
-    if (copybuf != NULL) {
-        PQfreemem(copybuf);
-        copybuf = NULL;
+    if (recvbuf != NULL) {
+        PQfreemem(recvbuf);
+        recvbuf = NULL;
     }
 
     if (tarfile != NULL) {
@@ -692,16 +721,6 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
     }
 }
 
-static PGresult *backup_get_result(PGconn *conn)
-{
-    PGresult *res = PQgetResult(conn);
-    if (PQresultStatus(res) != PGRES_COPY_OUT) {
-        fprintf(stderr, _("%s: could not get COPY data stream: %s"), progname, PQerrorMessage(conn));
-        disconnect_and_exit(1);
-    }
-    return res;
-}
-
 static bool check_input_path_relative_path(const char* input_path_value)
 {
     if (strstr(input_path_value, "..") != NULL) {
@@ -722,6 +741,79 @@ static bool IsXlogDir(const char* filename)
     return false;
 }
 
+/*
+ * Make sure the directory an incremental backup is merged into holds a
+ * previous backup, and that the requested start location is not past the
+ * start location recorded in its backup_label. Blocks changed between the
+ * label's start location and a later -i location would otherwise be missing
+ * from the merged backup without any error.
+ */
+static void check_incremental_start_location(const char *dirname)
+{
+    char path[MAXPGPATH] = {0};
+    char line[MAXPGPATH] = {0};
+    struct stat statbuf;
+    FILE *labelfile = NULL;
+    uint32 hi = 0;
+    uint32 lo = 0;
+    uint32 labelhi = 0;
+    uint32 labello = 0;
+    bool found = false;
+    int rc = snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s/global/pg_control", dirname);
+
+    securec_check_ss_c(rc, "", "");
+    if (stat(path, &statbuf) != 0) {
+        fprintf(stderr, _("%s: directory \"%s\" does not contain a previous backup to merge into\n"), progname,
+            dirname);
+        exit(1);
+    }
+
+    rc = snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s/backup_label", dirname);
+    securec_check_ss_c(rc, "", "");
+    labelfile = fopen(path, "r");
+    if (labelfile == NULL) {
+        fprintf(stderr, _("%s: could not open file \"%s\" of the previous backup: %s\n"), progname, path,
+            strerror(errno));
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), labelfile) != NULL) {
+        if (sscanf_s(line, "START WAL LOCATION: %X/%X", &labelhi, &labello) == 2) {
+            found = true;
+            break;
+        }
+    }
+    fclose(labelfile);
+    if (!found) {
+        fprintf(stderr, _("%s: invalid data in file \"%s\": missing START WAL LOCATION\n"), progname, path);
+        exit(1);
+    }
+
+    if (sscanf_s(incremental_lsn, "%X/%X", &hi, &lo) != 2) {
+        fprintf(stderr, _("%s: invalid incremental start location \"%s\"\n"), progname, incremental_lsn);
+        exit(1);
+    }
+    if ((((uint64)hi) << 32 | lo) > (((uint64)labelhi) << 32 | labello)) {
+        fprintf(stderr,
+            _("%s: incremental start location %X/%X is past the start location %X/%X of the previous backup in "
+              "\"%s\"\n"),
+            progname, hi, lo, labelhi, labello, dirname);
+        exit(1);
+    }
+}
+
+/*
+ * Give up unpacking. The streams of a parallel backup are unpacked by threads
+ * too, so the caller exits, once every stream is done with.
+ */
+#define UNPACK_FAIL()            \
+    do {                         \
+        if (file != NULL)        \
+            (void)fclose(file);  \
+        if (recvbuf != NULL)     \
+            PQfreemem(recvbuf);  \
+        return false;            \
+    } while (0)
+
 /*
  * Receive a tar format stream from the connection to the server, and unpack
  * the contents of it into a directory. Only files, directories and
@@ -731,8 +823,10 @@ static bool IsXlogDir(const char* filename)
  * specified directory. If it's for another tablespace, it will be restored
  * in the original directory, since relocation of tablespaces is not
  * supported.
+ *
+ * Returns false with the error printed if it fails.
  */
-static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
+static bool ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 {
     char current_path[MAXPGPATH] = {0};
     char filename[MAXPGPATH] = {0};
@@ -740,9 +834,14 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
     uint64 current_len_left = 0;
     uint64 current_padding = 0;
     char *copybuf = NULL;
+    char *recvbuf = NULL;
     FILE *file = NULL;
     char *get_value = NULL;
     errno_t errorno = EOK;
+    IncrementalApplyState incrstate;
+
+    errorno = memset_s(&incrstate, sizeof(incrstate), 0, sizeof(incrstate));
+    securec_check_c(errorno, "", "");
 
     if (PQgetisnull(res, rownum, 0)) {
         errorno = strncpy_s(current_path, MAXPGPATH, basedir, strlen(basedir));
@@ -752,7 +851,7 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
         get_value = PQgetvalue(res, rownum, 1);
         if (get_value == NULL) {
             pg_log(PG_WARNING, _("PQgetvalue get value failed\n"));
-            disconnect_and_exit(1);
+            UNPACK_FAIL();
         }
         char *relative = PQgetvalue(res, rownum, 3);
         if (*relative == '1') {
@@ -768,17 +867,26 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
     /*
      * Get the COPY data
      */
-    res = backup_get_result(conn);
+    res = PQgetResult(conn);
+    if (PQresultStatus(res) != PGRES_COPY_OUT) {
+        fprintf(stderr, _("%s: could not get COPY data stream: %s"), progname, PQerrorMessage(conn));
+        PQclear(res);
+        return false;
+    }
+    PQclear(res);
 
     while (1) {
         int r;
 
-        if (copybuf != NULL) {
-            PQfreemem(copybuf);
-            copybuf = NULL;
+        if (InBackupStreamThread && BackupStreamCancelled)
+            UNPACK_FAIL();
+
+        if (recvbuf != NULL) {
+            PQfreemem(recvbuf);
+            recvbuf = NULL;
         }
 
-        r = PQgetCopyData(conn, &copybuf, 0);
+        r = PQgetCopyData(conn, &recvbuf, 0);
         if (r == -1) {
             /*
              * End of chunk
@@ -791,7 +899,13 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
             break;
         } else if (r == -2) {
             fprintf(stderr, _("%s: could not read COPY data: %s"), progname, PQerrorMessage(conn));
-            disconnect_and_exit(1);
+            UNPACK_FAIL();
+        }
+
+        copybuf = recvbuf;
+        if (stream_compress && (r = DecompressBackupData(recvbuf, r, &copybuf)) < 0) {
+            fprintf(stderr, _("%s: could not decompress COPY data\n"), progname);
+            UNPACK_FAIL();
         }
 
         if (file == NULL) {
@@ -803,19 +917,19 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
              */
             if (r != 2560) {
                 fprintf(stderr, _("%s: invalid tar block header size: %d\n"), progname, r);
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
-            totaldone += 2560;
+            ADD_TOTALDONE(2560);
 
             if (sscanf_s(copybuf + 1048, "%201o", &current_len_left) != 1) {
                 fprintf(stderr, _("%s: could not parse file size\n"), progname);
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
 
             /* Set permissions on the file */
             if (sscanf_s(&copybuf[1024], "%07o ", (unsigned int *)&filemode) != 1) {
                 fprintf(stderr, _("%s: could not parse file mode\n"), progname);
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
 
             /*
@@ -831,7 +945,7 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
                         _("%s: the copybuf/current_path file path including .. is unallowed: %s\n"),
                         progname,
                         strerror(errno));
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
             errorno = snprintf_s(filename, sizeof(filename), sizeof(filename) - 1, "%s/%s", current_path, copybuf);
             securec_check_ss_c(errorno, "", "");
@@ -851,10 +965,11 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
                          * by the wal receiver process, so just ignore failure
                          * on that.
                          */
-                        if (!IsXlogDir(filename)) {
+                        if (!((incremental_lsn != NULL || backup_jobs > 1) && errno == EEXIST) &&
+                            !IsXlogDir(filename)) {
                             fprintf(stderr, _("%s: could not create directory \"%s\": %s\n"), progname, filename,
                                 strerror(errno));
-                            disconnect_and_exit(1);
+                            UNPACK_FAIL();
                         }
                     }
 #ifndef WIN32
@@ -867,14 +982,14 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
                      * Symbolic link
                      */
                     filename[strlen(filename) - 1] = '\0'; /* Remove trailing slash */
-                    if (symlink(&copybuf[1081], filename) != 0) {
+                    if (symlink(&copybuf[1081], filename) != 0 && !(incremental_lsn != NULL && errno == EEXIST)) {
                         if (IsXlogDir(filename)) {
                             fprintf(stderr, _("WARNING: could not create symbolic link for pg_xlog,"
                                 " will backup data to \"%s\" directly\n"), filename);
                         } else {
                             fprintf(stderr, _("%s: could not create symbolic link from \"%s\" to \"%s\": %s\n"),
                                 progname, filename, &copybuf[1081], strerror(errno));
-                            disconnect_and_exit(1);
+                            UNPACK_FAIL();
                         }
                     }
                 } else if (copybuf[1080] == '3') {
@@ -887,28 +1002,50 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
                         &copybuf[1080 + 1]);
                     securec_check_ss_c(errorno, "\0", "\0");
 
-                    if (symlink(absolut_path, filename) != 0) {
+                    if (symlink(absolut_path, filename) != 0 && !(incremental_lsn != NULL && errno == EEXIST)) {
                         if (!IsXlogDir(filename)) {
                             pg_log(PG_WARNING, _("could not create symbolic link from \"%s\" to \"%s\": %s\n"),
                                 filename, &copybuf[1081], strerror(errno));
-                            disconnect_and_exit(1);
+                            UNPACK_FAIL();
                         }
                     }
                 } else {
                     pg_log(PG_WARNING, _("unrecognized link indicator \"%c\"\n"), copybuf[1080]);
-                    disconnect_and_exit(1);
+                    UNPACK_FAIL();
                 }
                 continue; /* directory or link handled */
             }
 
             canonicalize_path(filename);
-            /*
-             * regular file
-             */
-            file = fopen(filename, "wb");
+            if (copybuf[1080] == INCREMENTAL_TAR_TYPE) {
+                /*
+                 * changed blocks of a file, applied onto the previous backup
+                 */
+                if (incremental_lsn == NULL) {
+                    fprintf(stderr, _("%s: unexpected incremental file \"%s\" in a full backup\n"), progname,
+                        filename);
+                    UNPACK_FAIL();
+                }
+                file = fopen(filename, "r+b");
+                if (file == NULL && errno == ENOENT)
+                    file = OpenBackupFile(filename, backup_jobs > 1, "w+b");
+                errorno = memset_s(&incrstate, sizeof(incrstate), 0, sizeof(incrstate));
+                securec_check_c(errorno, "", "");
+                incrstate.active = true;
+            } else {
+                /*
+                 * regular file
+                 */
+                file = OpenBackupFile(filename, backup_jobs > 1, "wb");
+                incrstate.active = false;
+
+                /* the relfilenode may have been reused with fewer segments */
+                if (incremental_lsn != NULL && !RemoveStaleSegments(filename, current_len_left, progname))
+                    UNPACK_FAIL();
+            }
             if (NULL == file) {
                 fprintf(stderr, _("%s: could not create file \"%s\": %s\n"), progname, filename, strerror(errno));
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
 
 #ifndef WIN32
@@ -936,18 +1073,21 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
                  */
                 fclose(file);
                 file = NULL;
-                totaldone += (uint64)r;
+                ADD_TOTALDONE(r);
                 continue;
             }
 
-            if (fwrite(copybuf, r, 1, file) != 1) {
+            if (incrstate.active) {
+                if (!ApplyIncrementalData(&incrstate, file, filename, copybuf, r, progname))
+                    UNPACK_FAIL();
+            } else if (fwrite(copybuf, r, 1, file) != 1) {
                 fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"), progname, filename, strerror(errno));
                 fclose(file);
                 file = NULL;
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
-            totaldone += r;
-            if (showprogress)
+            ADD_TOTALDONE(r);
+            if (showprogress && !InBackupStreamThread)
                 progress_report(rownum, filename);
 
             current_len_left -= r;
@@ -968,15 +1108,18 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
         fprintf(stderr, _("%s: COPY stream ended before last file was finished\n"), progname);
         fclose(file);
         file = NULL;
-        disconnect_and_exit(1);
+        UNPACK_FAIL();
     }
 
-    if (copybuf != NULL) {
-        PQfreemem(copybuf);
-        copybuf = NULL;
+    if (recvbuf != NULL) {
+        PQfreemem(recvbuf);
+        recvbuf = NULL;
     }
+    return true;
 }
 
+#undef UNPACK_FAIL
+
 static void BaseBackup(void)
 {
     PGresult *res = NULL;
@@ -990,6 +1133,8 @@ static void BaseBackup(void)
     char xlogend[64];
     errno_t rc = EOK;
     char *get_value = NULL;
+    BackupStream *backup_streams[MAX_PARALLEL_BACKUP_STREAMS] = {NULL};
+    bool streamfailed = false;
 
     /*
      * Connect in replication mode to the server, password is needed later, so don't clear it.
@@ -1026,10 +1171,19 @@ static void BaseBackup(void)
      * Start the actual backup
      */
     PQescapeStringConn(conn, escaped_label, label, sizeof(escaped_label), &i);
-    rc = snprintf_s(current_path, sizeof(current_path), sizeof(current_path) - 1, "BASE_BACKUP LABEL '%s' %s %s %s %s",
-        escaped_label, showprogress ? "PROGRESS" : "", includewal && !streamwal ? "WAL" : "",
-        fastcheckpoint ? "FAST" : "", includewal ? "NOWAIT" : "");
+    rc = snprintf_s(current_path, sizeof(current_path), sizeof(current_path) - 1,
+        "BASE_BACKUP LABEL '%s' %s %s %s %s %s %s %s", escaped_label, showprogress ? "PROGRESS" : "",
+        includewal && !streamwal ? "WAL" : "", fastcheckpoint ? "FAST" : "", includewal ? "NOWAIT" : "",
+        incremental_lsn != NULL ? "INCREMENTAL" : "", incremental_lsn != NULL ? incremental_lsn : "",
+        stream_compress ? "COMPRESS" : "");
     securec_check_ss_c(rc, "", "");
+    if (backup_jobs > 1) {
+        size_t len = strlen(current_path);
+
+        rc = snprintf_s(current_path + len, sizeof(current_path) - len, sizeof(current_path) - len - 1,
+            " PARALLEL %d", backup_jobs);
+        securec_check_ss_c(rc, "", "");
+    }
 
     if (PQsendQuery(conn, current_path) == 0) {
         fprintf(stderr, _("%s: could not send replication command \"%s\": %s"), progname, "BASE_BACKUP",
@@ -1135,8 +1289,12 @@ static void BaseBackup(void)
 
             verify_dir_is_empty_or_create(nodetablespacepath);
 
-            /* Save the tablespace directory here so we can remove it when errors happen. */
-            save_tablespace_dir(nodetablespacepath);
+            /*
+             * Save the tablespace directory here so we can remove it when errors happen,
+             * unless it holds the previous backup an incremental one is merged into.
+             */
+            if (incremental_lsn == NULL)
+                save_tablespace_dir(nodetablespacepath);
         }
     }
 
@@ -1165,16 +1323,49 @@ static void BaseBackup(void)
         StartLogStreamer((const char *)xlogstart, timeline, sysidentifier);
     }
 
+    /*
+     * The other streams of a parallel backup can be started now that the
+     * server has registered the backup.
+     */
+    for (i = 1; i < backup_jobs && !streamfailed; i++) {
+        char command[MAXPGPATH * 2] = {0};
+        PGconn *streamconn = GetConnection();
+
+        if (streamconn == NULL) {
+            streamfailed = true;
+            break;
+        }
+        rc = snprintf_s(command, sizeof(command), sizeof(command) - 1, "%s STREAM %d", current_path, i);
+        securec_check_ss_c(rc, "", "");
+        backup_streams[i] = StartBackupStream(streamconn, command, ReceiveAndUnpackTarFile);
+        if (backup_streams[i] == NULL) {
+            fprintf(stderr, _("%s: could not create thread for backup stream %d\n"), progname, i);
+            streamfailed = true;
+        }
+    }
+
     /*
      * Start receiving chunks
      */
-    for (i = 0; i < PQntuples(res); i++) {
+    for (i = 0; i < PQntuples(res) && !streamfailed; i++) {
         if (format == 't')
             ReceiveTarFile(conn, res, i);
-        else
-            ReceiveAndUnpackTarFile(conn, res, i);
+        else if (!ReceiveAndUnpackTarFile(conn, res, i))
+            streamfailed = true;
     } /* Loop over all tablespaces */
 
+    /* the threads are never left running while the process exits */
+    if (streamfailed)
+        BackupStreamCancelled = true;
+    for (i = 1; i < backup_jobs; i++) {
+        if (backup_streams[i] != NULL && !WaitBackupStream(backup_streams[i], progname))
+            streamfailed = true;
+    }
+    if (streamfailed) {
+        free(sysidentifier);
+        disconnect_and_exit(1);
+    }
+
     if (showprogress) {
         progress_report(PQntuples(res), NULL);
         fprintf(stderr, "\n"); /* Need to move to next line */
@@ -1404,6 +1595,9 @@ int main(int argc, char **argv)
                                            {"status-interval", required_argument, NULL, 's'},
                                            {"verbose", no_argument, NULL, 'v'},
                                            {"progress", no_argument, NULL, 'P'},
+                                           {"incremental", required_argument, NULL, 'i'},
+                                           {"jobs", required_argument, NULL, 'j'},
+                                           {"stream-compression", required_argument, NULL, 'C'},
                                            {NULL, 0, NULL, 0}};
     int c;
 
@@ -1422,7 +1616,7 @@ int main(int argc, char **argv)
         }
     }
 
-    while ((c = getopt_long(argc, argv, "D:l:c:h:p:U:s:wWvP", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "D:l:c:h:p:U:s:wWvPi:j:C:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'D': {
                 GS_FREE(basedir);
@@ -1513,6 +1707,37 @@ int main(int argc, char **argv)
             case 'P':
                 showprogress = true;
                 break;
+            case 'i': {
+                uint32 hi = 0;
+                uint32 lo = 0;
+
+                check_env_value_c(optarg);
+                if (sscanf_s(optarg, "%X/%X", &hi, &lo) != 2 || (hi == 0 && lo == 0)) {
+                    fprintf(stderr, _("%s: invalid incremental start location \"%s\"\n"), progname, optarg);
+                    exit(1);
+                }
+                GS_FREE(incremental_lsn);
+                incremental_lsn = xstrdup(optarg);
+                break;
+            }
+            case 'j':
+                check_env_value_c(optarg);
+                backup_jobs = atoi(optarg);
+                if (backup_jobs < 1 || backup_jobs > MAX_PARALLEL_BACKUP_STREAMS) {
+                    fprintf(stderr, _("%s: invalid number of parallel jobs \"%s\", must be between 1 and %d\n"),
+                        progname, optarg, MAX_PARALLEL_BACKUP_STREAMS);
+                    exit(1);
+                }
+                break;
+            case 'C':
+                if (pg_strcasecmp(optarg, "lz4") == 0)
+                    stream_compress = true;
+                else {
+                    fprintf(stderr, _("%s: invalid stream compression method \"%s\", must be \"lz4\"\n"),
+                        progname, optarg);
+                    exit(1);
+                }
+                break;
             default:
 
                 /*
@@ -1551,6 +1776,12 @@ int main(int argc, char **argv)
         exit(1);
     }
 
+    if (format != 'p' && backup_jobs > 1) {
+        fprintf(stderr, _("%s: parallel jobs can only be used in plain mode\n"), progname);
+        fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+        exit(1);
+    }
+
     if (format != 'p' && streamwal) {
         fprintf(stderr, _("%s: wal streaming can only be used in plain mode\n"), progname);
         fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
@@ -1572,6 +1803,9 @@ int main(int argc, char **argv)
     if (format == 'p' || strcmp(basedir, "-") != 0)
         verify_dir_is_empty_or_create(basedir);
 
+    if (incremental_lsn != NULL)
+        check_incremental_start_location(basedir);
+
     BaseBackup();
 
     free_basebackup();
@@ -1582,6 +1816,7 @@ int main(int argc, char **argv)
 static void free_basebackup()
 {
     GS_FREE(basedir);
+    GS_FREE(incremental_lsn);
     if (label != NULL && strcmp(label, "gs_basebackup base backup") != 0) {
         GS_FREE(label);
     }
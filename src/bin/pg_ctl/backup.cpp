@@ -24,6 +24,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <fcntl.h>
 #include <sys/wait.h>
 #include <sys/time.h>
 
@@ -42,6 +43,10 @@
 #include "logging.h"
 
 #include "bin/elog.h"
+#include "bin/backup_stream.h"
+#include "access/xlogreader.h"
+#include "catalog/pg_control.h"
+#include "replication/basebackup.h"
 #include "file_ops.h"
 
 /* Maximum number of digit in integer. Used to allocate memory to copy int to string */
@@ -67,7 +72,19 @@ bool fastcheckpoint = true;
 int standby_message_timeout = 10;  /* 10 sec = default */
 int standby_recv_timeout = 120;    /* 120 sec = default */
 int standby_connect_timeout = 120; /* 120 sec = default */
+int backup_jobs = 1;               /* number of parallel streams of the full build */
+bool stream_compress = false;      /* ask the server to compress the streams with LZ4 */
 
+/*
+ * A delta build updates the data directory of a lagging standby in place: the
+ * server sends only the blocks changed since the redo location of the last
+ * checkpoint of the standby, see IncrementalFileHeader.
+ */
+static bool delta_build = false;
+static XLogRecPtr delta_start_lsn = InvalidXLogRecPtr;
+static uint64 delta_sysid = 0;
+
+/* State of applying the incremental tar member being received, see IncrementalFileHeader */
 #define REPORT_TIMEOUT 30   /* report and calculate sync speed every 30s */
 #define CACULATE_MIN_TIME 2 /* calculate sync speed at least every 2s */
 #define BACKUP_LABEL_FILE "backup_label"
@@ -115,7 +132,7 @@ static void disconnect_and_exit(int code);
 static void verify_dir_is_empty_or_create(char* dirname);
 static void removeCreatedTblspace(void);
 static void progress_report(int tablespacenum, const char* filename, bool force);
-static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum);
+static bool ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum);
 static void BaseBackup(const char* dirname, uint32 term = 0);
 static bool reached_end_position(XLogRecPtr segendpos, uint32 timeline, bool segment_finished);
 void backup_incremental_xlog(char* dir);
@@ -665,7 +682,7 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
     g_state.state = BUILDING_STATE;
     g_state.sync_stat = false;
 
-    g_state.build_info.build_mode = FULL_BUILD;
+    g_state.build_info.build_mode = delta_build ? DELTA_BUILD : FULL_BUILD;
     g_state.build_info.total_done = totaldone / 1024;
     g_state.build_info.total_size = totalsize;
     g_state.build_info.process_schedule = percent;
@@ -681,6 +698,22 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
     }
 }
 
+/* the streams of a parallel build are received by several threads */
+#define ADD_TOTALDONE(n) ((void)__sync_fetch_and_add(&totaldone, (uint64)(n)))
+
+/*
+ * Give up unpacking. The streams of a parallel build are unpacked by threads
+ * too, so the caller exits, once every stream is done with.
+ */
+#define UNPACK_FAIL()                 \
+    do {                              \
+        if (file != NULL)             \
+            (void)fclose(file);       \
+        if (recvbuf != NULL)          \
+            PQfreemem(recvbuf);       \
+        return false;                 \
+    } while (0)
+
 /*
  * Receive a tar format stream from the connection to the server, and unpack
  * the contents of it into a directory. Only files, directories and
@@ -690,8 +723,10 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
  * specified directory. If it's for another tablespace, it will be restored
  * in the original directory, since relocation of tablespaces is not
  * supported.
+ *
+ * Returns false with the error printed if it fails.
  */
-static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
+static bool ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
 {
     char current_path[MAXPGPATH] = {0};
     char filename[MAXPGPATH] = {0};
@@ -699,11 +734,16 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
     uint64 current_len_left = 0;
     uint64 current_padding = 0;
     char* copybuf = NULL;
+    char* recvbuf = NULL;
     FILE* file = NULL;
     char* get_value = NULL;
     struct stat st;
     errno_t rc = EOK;
     int nRet = 0;
+    IncrementalApplyState incrstate;
+
+    rc = memset_s(&incrstate, sizeof(incrstate), 0, sizeof(incrstate));
+    securec_check_c(rc, "", "");
 
     if (PQgetisnull(res, rownum, 0)) {
         rc = strncpy_s(current_path, MAXPGPATH, basedir, strlen(basedir));
@@ -714,7 +754,7 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
         get_value = PQgetvalue(res, rownum, 1);
         if (get_value == NULL) {
             pg_log(PG_WARNING, _("PQgetvalue get value failed\n"));
-            disconnect_and_exit(1);
+            UNPACK_FAIL();
         }
         char* relative = PQgetvalue(res, rownum, 3);
         if (*relative == '1') {
@@ -733,7 +773,7 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
     res = PQgetResult(conn);
     if (PQresultStatus(res) != PGRES_COPY_OUT) {
         pg_log(PG_WARNING, _("could not get COPY data stream: %s"), PQerrorMessage(conn));
-        disconnect_and_exit(1);
+        UNPACK_FAIL();
     }
     PQclear(res);
 
@@ -742,15 +782,17 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
 
         if (build_interrupted) {
             pg_log(PG_WARNING, _("build walreceiver process terminated abnormally\n"));
-            disconnect_and_exit(1);
+            UNPACK_FAIL();
         }
+        if (InBackupStreamThread && BackupStreamCancelled)
+            UNPACK_FAIL();
 
-        if (copybuf != NULL) {
-            PQfreemem(copybuf);
-            copybuf = NULL;
+        if (recvbuf != NULL) {
+            PQfreemem(recvbuf);
+            recvbuf = NULL;
         }
 
-        r = PQgetCopyData(conn, &copybuf, 0);
+        r = PQgetCopyData(conn, &recvbuf, 0);
         if (r == -1) {
             /*
              * End of chunk
@@ -763,7 +805,13 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
         } else if (r == -2) {
             pg_log(PG_WARNING, _("could not read COPY data: %s"), PQerrorMessage(conn));
 
-            disconnect_and_exit(1);
+            UNPACK_FAIL();
+        }
+
+        copybuf = recvbuf;
+        if (stream_compress && (r = DecompressBackupData(recvbuf, r, &copybuf)) < 0) {
+            pg_log(PG_WARNING, _("could not decompress COPY data\n"));
+            UNPACK_FAIL();
         }
 
         if (file == NULL) {
@@ -775,19 +823,19 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
             if (r != BUILD_PATH_LEN) {
                 pg_log(PG_WARNING, _("invalid tar block header size: %d\n"), r);
 
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
-            totaldone += BUILD_PATH_LEN;
+            ADD_TOTALDONE(BUILD_PATH_LEN);
 
             if (sscanf_s(copybuf + 1048, "%20lo", &current_len_left) != 1) {
                 pg_log(PG_WARNING, _("could not parse file size\n"));
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
 
             /* Set permissions on the file */
             if (sscanf_s(&copybuf[1024], "%07o ", &filemode) != 1) {
                 pg_log(PG_WARNING, _("could not parse file mode\n"));
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
 
             /*
@@ -821,15 +869,17 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
                             /*
                              * When streaming WAL, pg_xlog will have been created
                              * by the wal receiver process, so just ignore failure
-                             * on that.
+                             * on that. Another stream of a parallel build may
+                             * have just created the directory too.
                              */
-                            if (!streamwal || strcmp(filename + strlen(filename) - len, "/pg_xlog") != 0) {
+                            if ((!streamwal || strcmp(filename + strlen(filename) - len, "/pg_xlog") != 0) &&
+                                !(backup_jobs > 1 && errno == EEXIST)) {
                                 pg_log(PG_WARNING,
                                     _("could not create directory \"%s\": %s\n"),
                                     filename,
                                     strerror(errno));
 
-                                disconnect_and_exit(1);
+                                UNPACK_FAIL();
                             }
                         }
 #ifndef WIN32
@@ -847,14 +897,14 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
                      * description: we need refactor the communication protocol for well maintaining code
                      */
                     filename[strlen(filename) - 1] = '\0'; /* Remove trailing slash */
-                    if (symlink(&copybuf[bufOffset + 1], filename) != 0) {
+                    if (symlink(&copybuf[bufOffset + 1], filename) != 0 && !(delta_build && errno == EEXIST)) {
                         if (!streamwal || strcmp(filename + strlen(filename) - len, "/pg_xlog") != 0) {
                             pg_log(PG_WARNING,
                                 _("could not create symbolic link from \"%s\" to \"%s\": %s\n"),
                                 filename,
                                 &copybuf[1081],
                                 strerror(errno));
-                            disconnect_and_exit(1);
+                            UNPACK_FAIL();
                         }
                     }
                 } else if (copybuf[bufOffset] == '3') {
@@ -871,31 +921,52 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
                         &copybuf[bufOffset + 1]);
                     securec_check_ss_c(nRet, "\0", "\0");
 
-                    if (symlink(absolut_path, filename) != 0) {
+                    if (symlink(absolut_path, filename) != 0 && !(delta_build && errno == EEXIST)) {
                         if (!streamwal || strcmp(filename + strlen(filename) - len, "/pg_xlog") != 0) {
                             pg_log(PG_WARNING,
                                 _("could not create symbolic link from \"%s\" to \"%s\": %s\n"),
                                 filename,
                                 &copybuf[1081],
                                 strerror(errno));
-                            disconnect_and_exit(1);
+                            UNPACK_FAIL();
                         }
                     }
                 } else {
                     pg_log(PG_WARNING, _("unrecognized link indicator \"%c\"\n"), copybuf[1080]);
-                    disconnect_and_exit(1);
+                    UNPACK_FAIL();
                 }
                 continue; /* directory or link handled */
             }
 
             canonicalize_path(filename);
-            /*
-             * regular file
-             */
-            file = fopen(filename, "wb");
+            if (copybuf[1080] == INCREMENTAL_TAR_TYPE) {
+                /*
+                 * changed blocks of a file, applied onto the file of the standby
+                 */
+                if (!delta_build) {
+                    pg_log(PG_WARNING, _("unexpected incremental file \"%s\" in a full build\n"), filename);
+                    UNPACK_FAIL();
+                }
+                file = OpenBackupFile(filename, backup_jobs > 1, "r+b");
+                if (file == NULL && errno == ENOENT)
+                    file = OpenBackupFile(filename, backup_jobs > 1, "w+b");
+                rc = memset_s(&incrstate, sizeof(incrstate), 0, sizeof(incrstate));
+                securec_check_c(rc, "", "");
+                incrstate.active = true;
+            } else {
+                /*
+                 * regular file
+                 */
+                file = OpenBackupFile(filename, backup_jobs > 1, "wb");
+                incrstate.active = false;
+
+                /* the relfilenode may have been reused with fewer segments */
+                if (delta_build && !RemoveStaleSegments(filename, current_len_left, progname))
+                    UNPACK_FAIL();
+            }
             if (NULL == file) {
                 pg_log(PG_WARNING, _("could not create file \"%s\": %s\n"), filename, strerror(errno));
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
 
 #ifndef WIN32
@@ -924,16 +995,19 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
                  */
                 fclose(file);
                 file = NULL;
-                totaldone += r;
+                ADD_TOTALDONE(r);
                 continue;
             }
 
-            if (fwrite(copybuf, r, 1, file) != 1) {
+            if (incrstate.active) {
+                if (!ApplyIncrementalData(&incrstate, file, filename, copybuf, r, progname))
+                    UNPACK_FAIL();
+            } else if (fwrite(copybuf, r, 1, file) != 1) {
                 pg_log(PG_WARNING, _("could not write to file \"%s\": %s\n"), filename, strerror(errno));
-                disconnect_and_exit(1);
+                UNPACK_FAIL();
             }
-            totaldone += r;
-            if (showprogress)
+            ADD_TOTALDONE(r);
+            if (showprogress && !InBackupStreamThread)
                 progress_report(rownum, filename, false);
 
             current_len_left -= r;
@@ -950,22 +1024,25 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
         } /* continuing data in existing file */
     }     /* loop over all data blocks */
 
-    if (showprogress)
+    if (showprogress && !InBackupStreamThread)
         progress_report(rownum, filename, true);
 
     if (file != NULL) {
         fclose(file);
         file = NULL;
         pg_log(PG_WARNING, _("COPY stream ended before last file was finished\n"));
-        disconnect_and_exit(1);
+        UNPACK_FAIL();
     }
 
-    if (copybuf != NULL) {
-        PQfreemem(copybuf);
-        copybuf = NULL;
+    if (recvbuf != NULL) {
+        PQfreemem(recvbuf);
+        recvbuf = NULL;
     }
+    return true;
 }
 
+#undef UNPACK_FAIL
+
 /*
  * Brief            : @@GaussDB@@
  * Description    :  create .done
@@ -1014,6 +1091,8 @@ static void BaseBackup(const char* dirname, uint32 term)
     char pgconfPath[1024] = {0};
     char* motIniPath = NULL;
     char* motChkptDir = NULL;
+    BackupStream* backup_streams[MAX_PARALLEL_BACKUP_STREAMS] = {NULL};
+    bool streamfailed = false;
 
     pqsignal(SIGCHLD, BuildReaper); /* handle child termination */
     /* concat file and path */
@@ -1041,10 +1120,11 @@ static void BaseBackup(const char* dirname, uint32 term)
 
     show_full_build_process("check connect to server success");
 
-    /* delete data/ and  pg_tblspc/, but keep .config */
-    delete_datadir(dirname);
-
-    show_full_build_process("clear old target dir success");
+    /* delete data/ and  pg_tblspc/, but keep .config. A delta build updates them in place. */
+    if (!delta_build) {
+        delete_datadir(dirname);
+        show_full_build_process("clear old target dir success");
+    }
 
     /* find a available conn */
     streamConn = check_and_conn(standby_connect_timeout, standby_recv_timeout, term);
@@ -1081,6 +1161,16 @@ static void BaseBackup(const char* dirname, uint32 term)
     timeline = atoi(PQgetvalue(res, 0, 1));
     PQclear(res);
 
+    if (delta_build && strtoul(sysidentifier, NULL, 10) != delta_sysid) {
+        pg_log(PG_WARNING,
+            _("database system identifier of the server %s differs from the local one " UINT64_FORMAT
+              ", delta build cannot be executed\n"),
+            sysidentifier,
+            delta_sysid);
+        (void)unlink(buildstart_file);
+        disconnect_and_exit(1);
+    }
+
     show_full_build_process("get system identifier success");
 
     create_backup_label(dirname, sysidentifier, timeline);
@@ -1102,13 +1192,31 @@ static void BaseBackup(const char* dirname, uint32 term)
     nRet = snprintf_s(current_path,
         MAXPGPATH,
         sizeof(current_path) - 1,
-        "BASE_BACKUP LABEL '%s' %s %s %s %s",
+        "BASE_BACKUP LABEL '%s' %s %s %s %s %s",
         escaped_label,
         showprogress ? "PROGRESS" : "",
         includewal && !streamwal ? "WAL" : "",
         fastcheckpoint ? "FAST" : "",
-        includewal ? "NOWAIT" : "");
+        includewal ? "NOWAIT" : "",
+        stream_compress ? "COMPRESS" : "");
     securec_check_ss_c(nRet, "", "");
+    if (backup_jobs > 1) {
+        size_t len = strlen(current_path);
+
+        nRet = snprintf_s(current_path + len, MAXPGPATH - len, MAXPGPATH - len - 1, " PARALLEL %d", backup_jobs);
+        securec_check_ss_c(nRet, "", "");
+    }
+    if (delta_build) {
+        size_t len = strlen(current_path);
+
+        nRet = snprintf_s(current_path + len,
+            MAXPGPATH - len,
+            MAXPGPATH - len - 1,
+            " INCREMENTAL %X/%X",
+            (uint32)(delta_start_lsn >> 32),
+            (uint32)delta_start_lsn);
+        securec_check_ss_c(nRet, "", "");
+    }
 
     if (PQsendQuery(streamConn, current_path) == 0) {
         pg_log(PG_WARNING, _("could not send base backup command: %s"), PQerrorMessage(streamConn));
@@ -1179,6 +1287,12 @@ static void BaseBackup(const char* dirname, uint32 term)
     res = PQgetResult(streamConn);
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         pg_log(PG_WARNING, _("could not get backup header: %s"), PQerrorMessage(streamConn));
+        /*
+         * The server refuses a delta build it has no changed-block maps for
+         * here, and nothing of the standby has been changed yet.
+         */
+        if (delta_build)
+            (void)unlink(buildstart_file);
         disconnect_and_exit(1);
     }
     if (PQntuples(res) < 1) {
@@ -1230,6 +1344,10 @@ static void BaseBackup(const char* dirname, uint32 term)
                 pgxcnodename);
             securec_check_ss_c(nRet, "\0", "\0");
 
+            /* A delta build keeps the files of the tablespaces the standby already has */
+            if (delta_build && pg_check_dir(nodetablespacepath) == 2)
+                continue;
+
             verify_dir_is_empty_or_create(nodetablespacepath);
 
             /* Save the tablespace directory here so we can remove it when errors happen. */
@@ -1265,13 +1383,47 @@ static void BaseBackup(const char* dirname, uint32 term)
     pg_free(sysidentifier);
     show_full_build_process("begin receive tar files");
 
+    /*
+     * The other streams of a parallel build can be started now that the
+     * server has registered the backup.
+     */
+    for (i = 1; i < backup_jobs && !streamfailed; i++) {
+        char command[MAXPGPATH * 2] = {0};
+        PGconn* conn = check_and_conn(standby_connect_timeout, standby_recv_timeout, term);
+
+        if (conn == NULL) {
+            pg_log(PG_WARNING, _("could not connect to server for backup stream %d\n"), i);
+            streamfailed = true;
+            break;
+        }
+        (void)PQsetRwTimeout(conn, standby_recv_timeout);
+        nRet = snprintf_s(command, sizeof(command), sizeof(command) - 1, "%s STREAM %d", current_path, i);
+        securec_check_ss_c(nRet, "", "");
+        backup_streams[i] = StartBackupStream(conn, command, ReceiveAndUnpackTarFile);
+        if (backup_streams[i] == NULL) {
+            pg_log(PG_WARNING, _("could not create thread for backup stream %d\n"), i);
+            streamfailed = true;
+        }
+    }
+
     /*
      * Start receiving chunks, Loop over all tablespaces
      */
-    for (i = 0; i < PQntuples(res); i++) {
-        ReceiveAndUnpackTarFile(streamConn, res, i);
+    for (i = 0; i < PQntuples(res) && !streamfailed; i++) {
+        if (!ReceiveAndUnpackTarFile(streamConn, res, i))
+            streamfailed = true;
     }
 
+    /* the threads are never left running while the process exits */
+    if (streamfailed)
+        BackupStreamCancelled = true;
+    for (i = 1; i < backup_jobs; i++) {
+        if (backup_streams[i] != NULL && !WaitBackupStream(backup_streams[i], progname))
+            streamfailed = true;
+    }
+    if (streamfailed)
+        disconnect_and_exit(1);
+
     if (showprogress)
         progress_report(PQntuples(res), NULL, true);
     PQclear(res);
@@ -1437,6 +1589,183 @@ void backup_main(char* dir, uint32 term)
     BaseBackup(dir, term);
 }
 
+/*
+ * Check the local WAL of a delta build target against the server before
+ * anything in it is overwritten. The walsender has no TIMELINE_HISTORY, so
+ * the timeline must match the server's, the minimum recovery point must not be
+ * past the server's flushed xlog, and the last local record must be on the
+ * server with the same crc (IDENTIFY_CONSISTENCE, as pg_rewind does).
+ * Returns false if the directory has to be rebuilt in full.
+ */
+static bool delta_build_on_server_history(char* dir, const ControlFileData* controlfile, uint32 term)
+{
+    char returnmsg[XLOG_READER_MAX_MSGLENTH] = {0};
+    char cmd[MAXPGPATH] = {0};
+    XLogRecPtr max_lsn = InvalidXLogRecPtr;
+    pg_crc32 max_lsn_crc = 0;
+    pg_crc32 server_crc = 0;
+    char* server_crc_str = NULL;
+    TimeLineID server_tli = 0;
+    XLogRecPtr server_lsn = InvalidXLogRecPtr;
+    char* server_lsn_str = NULL;
+    uint32 hi = 0;
+    uint32 lo = 0;
+    int havexlog = 0;
+    PGconn* conn = NULL;
+    PGresult* res = NULL;
+    int nRet = 0;
+
+    max_lsn = FindMaxLSN(dir, returnmsg, XLOG_READER_MAX_MSGLENTH, &max_lsn_crc);
+    if (XLogRecPtrIsInvalid(max_lsn)) {
+        pg_log(PG_WARNING, _("could not find the last local xlog record: %s\n"), returnmsg);
+        return false;
+    }
+
+    CONCAT_BUILD_CONF_FILE(dir);
+    get_conninfo(conf_file);
+    conn = check_and_conn(standby_connect_timeout, standby_recv_timeout, term);
+    if (conn == NULL) {
+        pg_log(PG_WARNING, _("could not connect to server to check the local xlog\n"));
+        return false;
+    }
+
+    res = PQexec(conn, "IDENTIFY_SYSTEM");
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) != 1 || PQnfields(res) != 4) {
+        pg_log(PG_WARNING, _("could not identify system: %s"), PQerrorMessage(conn));
+        PQclear(res);
+        PQfinish(conn);
+        return false;
+    }
+    server_tli = (TimeLineID)atoi(PQgetvalue(res, 0, 1));
+    PQclear(res);
+    if (server_tli != controlfile->checkPointCopy.ThisTimeLineID) {
+        pg_log(PG_WARNING,
+            _("server timeline %u differs from the local timeline %u\n"),
+            server_tli,
+            controlfile->checkPointCopy.ThisTimeLineID);
+        PQfinish(conn);
+        return false;
+    }
+
+    /* pages flushed up to minRecoveryPoint must not be ahead of the server */
+    res = PQexec(conn, "IDENTIFY_MAXLSN");
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) != 1 || PQnfields(res) != 1 ||
+        (server_lsn_str = strchr(PQgetvalue(res, 0, 0), '|')) == NULL ||
+        sscanf_s(server_lsn_str + 1, "%X/%X", &hi, &lo) != 2) {
+        pg_log(PG_WARNING, _("could not identify maxlsn: %s"), PQerrorMessage(conn));
+        PQclear(res);
+        PQfinish(conn);
+        return false;
+    }
+    PQclear(res);
+    server_lsn = (((uint64)hi) << 32) | lo;
+    if (XLByteLT(server_lsn, controlfile->minRecoveryPoint)) {
+        pg_log(PG_WARNING,
+            _("local minimum recovery point %X/%X is past the server's flushed xlog %X/%X\n"),
+            (uint32)(controlfile->minRecoveryPoint >> 32),
+            (uint32)controlfile->minRecoveryPoint,
+            hi,
+            lo);
+        PQfinish(conn);
+        return false;
+    }
+
+nRet = snprintf_s(
+        cmd, sizeof(cmd), sizeof(cmd) - 1, "IDENTIFY_CONSISTENCE %X/%X", (uint32)(max_lsn >> 32), (uint32)max_lsn);
+    securec_check_ss_c(nRet, "\0", "\0");
+    res = PQexec(conn, cmd);
+    /* To support grayupgrade, msg with 1 row of 2 or 3 columns are permitted. */
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || (PQnfields(res) != 3 && PQnfields(res) != 2) ||
+        PQntuples(res) != 1) {
+        pg_log(PG_WARNING, _("could not identify consistence: %s"), PQerrorMessage(conn));
+        PQclear(res);
+        PQfinish(conn);
+        return false;
+    }
+    server_crc_str = PQgetvalue(res, 0, 0);
+    havexlog = atoi(PQgetvalue(res, 0, 1));
+    if (server_crc_str == NULL || sscanf_s(server_crc_str, "%8X", &server_crc) != 1) {
+        server_crc = 0;
+    }
+    PQclear(res);
+    PQfinish(conn);
+
+    if (havexlog == 0 || server_crc != max_lsn_crc) {
+        pg_log(PG_WARNING,
+            _("local xlog record %X/%X (crc %X) is not on the server's history (crc %X)\n"),
+            (uint32)(max_lsn >> 32),
+            (uint32)max_lsn,
+            (uint32)max_lsn_crc,
+            (uint32)server_crc);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * The entry of delta build. Reads the redo location of the last checkpoint of
+ * the standby in dir, and receives only the blocks changed since then. The
+ * xlog from there on is streamed again, so replay brings the blocks changed
+ * in the meantime up to date. Returns false without touching the directory if
+ * its control file can't be used or its xlog is not on the server's history.
+ */
+bool backup_delta_main(char* dir, uint32 term)
+{
+    char controlpath[MAXPGPATH] = {0};
+    ControlFileData controlfile;
+    pg_crc32c crc;
+    int fd = -1;
+    int nRet = 0;
+
+    if (dir == NULL) {
+        pg_log(PG_PRINT, "%s: parameters dir is NULL.\n", progname);
+        exit(1);
+    }
+
+    nRet = snprintf_s(controlpath, MAXPGPATH, MAXPGPATH - 1, "%s/%s", dir, XLOG_CONTROL_FILE);
+    securec_check_ss_c(nRet, "\0", "\0");
+    fd = open(controlpath, O_RDONLY | PG_BINARY, 0);
+    if (fd < 0) {
+        pg_log(PG_WARNING, _("could not open file \"%s\" for reading: %s\n"), controlpath, strerror(errno));
+        return false;
+    }
+    if (read(fd, &controlfile, sizeof(ControlFileData)) != sizeof(ControlFileData)) {
+        pg_log(PG_WARNING, _("could not read file \"%s\": %s\n"), controlpath, strerror(errno));
+        (void)close(fd);
+        return false;
+    }
+    (void)close(fd);
+
+    INIT_CRC32C(crc);
+    COMP_CRC32C(crc, (char*)&controlfile, offsetof(ControlFileData, crc));
+    FIN_CRC32C(crc);
+    if (!EQ_CRC32C(crc, controlfile.crc) || XLogRecPtrIsInvalid(controlfile.checkPointCopy.redo)) {
+        pg_log(PG_WARNING, _("invalid control file \"%s\"\n"), controlpath);
+        return false;
+    }
+
+    if (!delta_build_on_server_history(dir, &controlfile, term)) {
+        pg_log(PG_WARNING, _("local xlog diverged from the server, delta build cannot be executed\n"));
+        return false;
+    }
+
+    delta_build = true;
+    delta_start_lsn = controlfile.checkPointCopy.redo;
+    delta_sysid = controlfile.system_identifier;
+    label = "gs_ctl delta build";
+    basedir = dir;
+    progname = "gs_ctl";
+
+    pg_log(PG_WARNING,
+        _("delta build from %X/%X\n"),
+        (uint32)(delta_start_lsn >> 32),
+        (uint32)delta_start_lsn);
+
+    BaseBackup(dir, term);
+    return true;
+}
+
 /*
  * scene for CN build DN,used after full backup
  * and cluster should be locked.
@@ -7,11 +7,14 @@
 extern int standby_recv_timeout;
 extern int standby_connect_timeout;
 extern int standby_message_timeout;
+extern int backup_jobs;
+extern bool stream_compress;
 
 extern char* conn_str;
 extern pid_t process_id;
 extern char* formatLogTime();
 void backup_main(char* dir, uint32 term);
+bool backup_delta_main(char* dir, uint32 term);
 void backup_incremental_xlog(char* dir);
 
 bool CreateBuildtagFile(const char* fulltagname);
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * backup_stream.cpp
+ *    Receives the extra streams of a parallel base backup.
+ *
+ *    The main stream of a parallel base backup is received as usual. Once
+ *    its tablespace header has arrived, each of the other streams is sent
+ *    BASE_BACKUP ... PARALLEL n STREAM k on its own connection and received
+ *    by its own thread, so that the files are written concurrently.
+ *
+ * IDENTIFICATION
+ *    src/bin/pg_ctl/backup_stream.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "postgres_fe.h"
+#include "libpq/libpq-fe.h"
+#include "common/fe_memutils.h"
+#include "lz4.h"
+#include "replication/basebackup.h"
+#include "bin/backup_stream.h"
+
+#define BACKUP_STREAM_ERRMSG_LEN 1024
+
+struct BackupStream {
+    PGconn* conn;
+    char* command;
+    BackupStreamReceiver receiver;
+    pthread_t thread;
+    bool failed;
+    char errmsg[BACKUP_STREAM_ERRMSG_LEN];
+};
+
+THR_LOCAL bool InBackupStreamThread = false;
+volatile bool BackupStreamCancelled = false;
+
+/* buffer of decompressed data, one per receiving thread */
+static THR_LOCAL char* rawbuf = NULL;
+static THR_LOCAL uint32 rawbufsize = 0;
+
+static void BackupStreamFail(BackupStream* stream, const char* fmt, const char* detail)
+{
+    int rc = snprintf_s(stream->errmsg, sizeof(stream->errmsg), sizeof(stream->errmsg) - 1, fmt, detail);
+    securec_check_ss_c(rc, "", "");
+    stream->failed = true;
+}
+
+static void* BackupStreamMain(void* arg)
+{
+    BackupStream* stream = (BackupStream*)arg;
+    PGresult* res = NULL;
+    int i;
+
+    InBackupStreamThread = true;
+
+    if (PQsendQuery(stream->conn, stream->command) == 0) {
+        BackupStreamFail(stream, "could not send base backup command: %s", PQerrorMessage(stream->conn));
+        return NULL;
+    }
+
+    /* the tablespace header */
+    res = PQgetResult(stream->conn);
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        BackupStreamFail(stream, "could not initiate base backup stream: %s", PQerrorMessage(stream->conn));
+        PQclear(res);
+        return NULL;
+    }
+
+    for (i = 0; i < PQntuples(res); i++) {
+        if (!stream->receiver(stream->conn, res, i)) {
+            /* the receiver has printed the error, nothing more to say if the main thread gave up */
+            if (!BackupStreamCancelled)
+                BackupStreamFail(stream, "%s", "could not receive base backup stream\n");
+            stream->failed = true;
+            PQclear(res);
+            return NULL;
+        }
+    }
+    PQclear(res);
+
+    res = PQgetResult(stream->conn);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        BackupStreamFail(stream, "base backup stream failed: %s", PQerrorMessage(stream->conn));
+        PQclear(res);
+        return NULL;
+    }
+    PQclear(res);
+
+    while ((res = PQgetResult(stream->conn)) != NULL)
+        PQclear(res);
+
+    return NULL;
+}
+
+BackupStream* StartBackupStream(PGconn* conn, const char* command, BackupStreamReceiver receiver)
+{
+    BackupStream* stream = (BackupStream*)pg_malloc0(sizeof(BackupStream));
+
+    stream->conn = conn;
+    stream->command = pg_strdup(command);
+    stream->receiver = receiver;
+
+    if (pthread_create(&stream->thread, NULL, BackupStreamMain, stream) != 0) {
+        PQfinish(stream->conn);
+        free(stream->command);
+        free(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+bool WaitBackupStream(BackupStream* stream, const char* progname)
+{
+    bool failed = false;
+
+    (void)pthread_join(stream->thread, NULL);
+
+    failed = stream->failed;
+    if (failed && stream->errmsg[0] != '\0')
+        fprintf(stderr, "%s: %s", progname, stream->errmsg);
+
+    PQfinish(stream->conn);
+    free(stream->command);
+    free(stream);
+    return !failed;
+}
+
+FILE* OpenBackupFile(char* filename, bool parallel, const char* mode)
+{
+    FILE* file = fopen(filename, mode);
+    char* sep = NULL;
+    const int maxretry = 3;
+    int retry = 0;
+
+    if (file != NULL || errno != ENOENT || !parallel)
+        return file;
+
+    sep = strrchr(filename, '/');
+    if (sep == NULL)
+        return NULL;
+
+    /* another thread may be creating the same directories */
+    *sep = '\0';
+    while (pg_mkdir_p(filename, S_IRWXU) != 0 && errno == EEXIST && ++retry < maxretry) {
+    }
+    *sep = '/';
+
+    return fopen(filename, mode);
+}
+
+bool RemoveStaleSegments(const char* filename, uint64 filesize, const char* progname)
+{
+    const char* name = last_dir_separator(filename);
+    const char* p = NULL;
+    char segpath[MAXPGPATH];
+    size_t baselen = 0;
+    unsigned long segno = 0;
+    int nRet = 0;
+
+    /* not the last segment, the next one is sent too */
+    if (filesize >= (uint64)RELSEG_SIZE * BLCKSZ)
+        return true;
+
+    if (name == NULL ||
+        (strstr(filename, "/base/") == NULL && strstr(filename, "/global/") == NULL &&
+            strstr(filename, "/pg_tblspc/") == NULL))
+        return true;
+
+    /* only the segments of row relations are cut by RELSEG_SIZE: <relfilenode>[_<fork>][.<segno>] */
+    p = ++name;
+    while (isdigit((unsigned char)*p))
+        p++;
+    if (p == name)
+        return true;
+    if (*p == '_') {
+        p++;
+        while (islower((unsigned char)*p))
+            p++;
+    }
+    baselen = (size_t)(p - filename);
+    if (*p == '.') {
+        char* end = NULL;
+
+        if (!isdigit((unsigned char)p[1]))
+            return true;
+        segno = strtoul(p + 1, &end, 10);
+        p = end;
+    }
+    if (*p != '\0')
+        return true;
+
+    for (segno++;; segno++) {
+        nRet = snprintf_s(segpath, sizeof(segpath), sizeof(segpath) - 1, "%.*s.%lu", (int)baselen, filename, segno);
+        securec_check_ss_c(nRet, "", "");
+        if (unlink(segpath) != 0) {
+            if (errno == ENOENT)
+                break;
+            fprintf(stderr, _("%s: could not remove file \"%s\": %s\n"), progname, segpath, strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ApplyIncrementalData(
+    IncrementalApplyState* state, FILE* file, const char* filename, const char* data, int len, const char* progname)
+{
+    errno_t rc = EOK;
+
+    while (len > 0) {
+        char* target = state->headerdone ? state->record : (char*)&state->header;
+        size_t targetlen = state->headerdone ? sizeof(state->record) : sizeof(IncrementalFileHeader);
+        size_t n = Min(targetlen - state->filled, (size_t)len);
+
+        rc = memcpy_s(target + state->filled, targetlen - state->filled, data, n);
+        securec_check_c(rc, "", "");
+        state->filled += n;
+        data += n;
+        len -= (int)n;
+        if (state->filled < targetlen)
+            break;
+        state->filled = 0;
+
+        if (!state->headerdone) {
+            if (state->header.magic != INCREMENTAL_FILE_MAGIC) {
+                fprintf(stderr, _("%s: invalid incremental header of file \"%s\"\n"), progname, filename);
+                return false;
+            }
+            /* Blocks past the end were truncated, and extended blocks are sent as changed ones */
+            if (ftruncate(fileno(file), (off_t)state->header.filesize) != 0) {
+                fprintf(stderr, _("%s: could not truncate file \"%s\": %s\n"), progname, filename, strerror(errno));
+                return false;
+            }
+            if (!RemoveStaleSegments(filename, state->header.filesize, progname))
+                return false;
+            state->headerdone = true;
+        } else {
+            BlockNumber blkno = *(BlockNumber*)state->record;
+
+            if (fseeko(file, (off_t)blkno * BLCKSZ, SEEK_SET) != 0 ||
+                fwrite(state->record + sizeof(BlockNumber), BLCKSZ, 1, file) != 1) {
+                fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"), progname, filename, strerror(errno));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int DecompressBackupData(char* data, int len, char** rawdata)
+{
+    BackupCompressHeader header;
+    char* payload = data + sizeof(BackupCompressHeader);
+    int payloadlen = len - (int)sizeof(BackupCompressHeader);
+    errno_t rc = EOK;
+
+    if (payloadlen < 0)
+        return -1;
+    rc = memcpy_s(&header, sizeof(BackupCompressHeader), data, sizeof(BackupCompressHeader));
+    securec_check_c(rc, "", "");
+
+    /* sent as is */
+    if (header.compsize == 0) {
+        if ((uint32)payloadlen != header.rawsize)
+            return -1;
+        *rawdata = payload;
+        return payloadlen;
+    }
+
+    if ((uint32)payloadlen != header.compsize || header.rawsize > (uint32)PG_INT32_MAX)
+        return -1;
+    if (rawbufsize < header.rawsize) {
+        free(rawbuf);
+        rawbuf = (char*)pg_malloc(header.rawsize);
+        rawbufsize = header.rawsize;
+    }
+    if (LZ4_decompress_safe(payload, rawbuf, payloadlen, (int)header.rawsize) != (int)header.rawsize)
+        return -1;
+
+    *rawdata = rawbuf;
+    return (int)header.rawsize;
+}
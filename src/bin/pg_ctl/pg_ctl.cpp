@@ -45,6 +45,7 @@
 #include "streamutil.h"
 #include "bin/elog.h"
 #include "common/build_query/build_query.h"
+#include "replication/basebackup.h"
 #include "replication/replicainternal.h"
 #include "libpq/libpq-fe.h"
 #include "libpq/libpq-int.h"
@@ -274,7 +275,7 @@ static PGconn* get_connectionex(void);
 static ServerMode get_runmode(void);
 static void freefile(char** lines);
 static char* get_localrole_string(ServerMode mode);
-static void do_actual_build(uint32 term = 0);
+static void do_actual_build(uint32 term = 0, bool delta = false);
 static void do_incremental_build(uint32 term = 0);
 static void do_incremental_build_xlog();
 static void do_build(uint32 term = 0);
@@ -2621,6 +2622,8 @@ static void display_build_query(const GaussState* state)
             pg_log(PG_PRINT, _("        %-30s: Full\n"), build_mode_opts);
         else if (state->build_info.build_mode == INC_BUILD)
             pg_log(PG_PRINT, _("        %-30s: Incremental\n"), build_mode_opts);
+        else if (state->build_info.build_mode == DELTA_BUILD)
+            pg_log(PG_PRINT, _("        %-30s: Delta\n"), build_mode_opts);
         char* datasize = show_datasize(state->build_info.total_done);
         pg_log(PG_PRINT, _("        %-30s: %s\n"), data_synced_opts, datasize);
         free(datasize);
@@ -3411,6 +3414,10 @@ static void do_help(void)
     printf(_("  -p PATH-TO-POSTGRES    normally not necessary\n"));
     printf(_("\nOptions for stop or restart:\n"));
     printf(_("  -m, --mode=MODE        MODE can be \"smart\", \"fast\", or \"immediate\"\n"));
+    printf(_("\nOptions for full and delta build:\n"));
+    printf(_("  --jobs=NUM             receive the data in NUM parallel streams\n"));
+    printf(_("  --stream-compression=lz4\n"
+             "                         compress the data streams on the primary\n"));
     printf(_("\nOptions for restore:\n"));
     printf(_("  --remove-backup        Remove the pg_rewind_bak dir after restore with \"restore\" command\n"));
 #ifdef ENABLE_MULTIPLE_NODES
@@ -3454,9 +3461,11 @@ static void do_help(void)
     printf(_("\nBuild connection option:\n"));
     
 #ifdef ENABLE_MULTIPLE_NODES
-    printf(_("  -b, --mode=MODE        the mode of building the datanode.MODE can be \"full\", \"incremental\"\n"));
+    printf(_("  -b, --mode=MODE        the mode of building the datanode.MODE can be \"full\", \"incremental\",\n"
+             "                         \"delta\"\n"));
 #else
-    printf(_("  -b  MODE               the mode of building the datanode.MODE can be \"full\", \"incremental\"\n"));
+    printf(_("  -b  MODE               the mode of building the datanode.MODE can be \"full\", \"incremental\",\n"
+             "                         \"delta\"\n"));
 #endif
     printf(_("  -r, --recvtimeout=INTERVAL    time that receiver waits for communication from server (in seconds)\n"));
     printf(_("  -q                     do not start automatically after build finishing, needed start by caller\n"));
@@ -3793,6 +3802,11 @@ static void do_build(uint32 term)
         pg_log(PG_WARNING, "%s: Invalid coordinator connector: %s.\n", progname, conn_str);
         exit(1);
     }
+    /* delta build needs the standby's own xlog checked against its primary, not a build from CN */
+    if (build_mode == DELTA_BUILD && conn_str != NULL) {
+        pg_log(PG_WARNING, _("%s: delta build cannot be used with -C, use full build instead.\n"), progname);
+        exit(1);
+    }
     if (pid > 0) {
         do_build_stop(pid);
     } else {
@@ -3814,6 +3828,11 @@ static void do_build(uint32 term)
         createRewindFile(pg_data);
         do_incremental_build_xlog();
     }
+    /* Standby DN delta build from Primary DN */
+    else if (build_mode == DELTA_BUILD) {
+        createRewindFile(pg_data);
+        do_actual_build(term, true);
+    }
 }
 
 static void do_restore(void)
@@ -3981,7 +4000,11 @@ static void read_ssl_confval(void)
     optlines = NULL;
 }
 
-static void do_actual_build(uint32 term)
+/*
+ * delta: update the data directory of a lagging standby in place with the
+ * blocks changed since its last checkpoint, do full build if it can't.
+ */
+static void do_actual_build(uint32 term, bool delta)
 {
     GaussState state;
     errno_t tnRet = 0;
@@ -3997,15 +4020,21 @@ static void do_actual_build(uint32 term)
     state.conn_num = replconn_num;
     state.state = BUILDING_STATE;
     state.sync_stat = false;
-    state.build_info.build_mode = FULL_BUILD;
+    state.build_info.build_mode = delta ? DELTA_BUILD : FULL_BUILD;
     UpdateDBStateFile(gaussdb_state_file, &state);
     pg_log(PG_WARNING,
-        _("set gaussdb state file when full build:"
-          "db state(BUILDING_STATE), server mode(STANDBY_MODE), build mode(FULL_BUILD).\n"));
+        _("set gaussdb state file when %s build:"
+          "db state(BUILDING_STATE), server mode(STANDBY_MODE), build mode(%s).\n"),
+        delta ? "delta" : "full",
+        delta ? "DELTA_BUILD" : "FULL_BUILD");
 
     read_ssl_confval();
 
-    backup_main(pg_data, term);
+    if (!delta || !backup_delta_main(pg_data, term)) {
+        if (delta)
+            pg_log(PG_WARNING, _("delta build cannot be executed, do full build instead.\n"));
+        backup_main(pg_data, term);
+    }
 
     pg_log(PG_WARNING, _("build completed(%s).\n"), pg_data);
 
@@ -4444,6 +4473,8 @@ int main(int argc, char** argv)
         {"recvtimeout", required_argument, NULL, 'r'},
         {"connect-string", required_argument, NULL, 'C'},
         {"remove-backup", no_argument, NULL, 1},
+        {"jobs", required_argument, NULL, 2},
+        {"stream-compression", required_argument, NULL, 3},
         {"action", required_argument, NULL, 'a'},
         {NULL, 0, NULL, 0}};
 
@@ -4534,6 +4565,8 @@ int main(int argc, char** argv)
                         build_mode = FULL_BUILD;
                     else if (strcmp(optarg, "incremental") == 0)
                         build_mode = INC_BUILD;
+                    else if (strcmp(optarg, "delta") == 0)
+                        build_mode = DELTA_BUILD;
                     break;
                 }
                 case 'D': {
@@ -4732,6 +4765,23 @@ int main(int argc, char** argv)
                 case 1:
                     clear_backup_dir = true;
                     break;
+                case 2:
+                    check_input_for_security(optarg);
+                    backup_jobs = atoi(optarg);
+                    if (backup_jobs < 1 || backup_jobs > MAX_PARALLEL_BACKUP_STREAMS) {
+                        pg_log(PG_WARNING, _("invalid number of parallel jobs: %s, must be between 1 and %d\n"),
+                            optarg, MAX_PARALLEL_BACKUP_STREAMS);
+                        exit(1);
+                    }
+                    break;
+                case 3:
+                    if (pg_strcasecmp(optarg, "lz4") == 0) {
+                        stream_compress = true;
+                    } else {
+                        pg_log(PG_WARNING, _("invalid stream compression method: %s, must be \"lz4\"\n"), optarg);
+                        exit(1);
+                    }
+                    break;
                 default:
                     /* getopt_long already issued a suitable error message */
                     do_advice();
@@ -5013,13 +5063,13 @@ int main(int argc, char** argv)
             if (conn_str != NULL)
                 pg_log(PG_PROGRESS,
                     _("gs_ctl %s build ,datadir is %s,conn_str is \'%s\'\n"),
-                    build_mode == FULL_BUILD ? "full" : "incremental",
+                    build_mode == FULL_BUILD ? "full" : (build_mode == DELTA_BUILD ? "delta" : "incremental"),
                     pgdata_opt,
                     conn_str);
             else
                 pg_log(PG_PROGRESS,
                     _("gs_ctl %s build ,datadir is %s\n"),
-                    build_mode == FULL_BUILD ? "full" : "incremental",
+                    build_mode == FULL_BUILD ? "full" : (build_mode == DELTA_BUILD ? "delta" : "incremental"),
                     pgdata_opt);
             if (-1 != pg_ctl_lock(pg_ctl_lockfile, &lockfile)) {
                 do_build(term);
@@ -4175,7 +4175,8 @@ CREATE OR REPLACE VIEW DBE_PERF.global_redo_status AS
            read_xlog_io_counter, read_xlog_io_total_dur, read_data_io_counter, read_data_io_total_dur, 
            write_data_io_counter, write_data_io_total_dur, process_pending_counter, process_pending_total_dur,
            apply_counter, apply_total_dur,
-           speed, local_max_ptr, primary_flush_ptr, worker_info
+           speed, local_max_ptr, primary_flush_ptr, worker_info,
+           prefetch_issued, prefetch_hit, prefetch_skip
     FROM pg_catalog.local_redo_stat();
   
 CREATE OR REPLACE VIEW DBE_PERF.global_rto_status AS
@@ -1393,7 +1393,12 @@ CREATE VIEW pg_stat_replication AS
             W.receiver_flush_location,
             W.receiver_replay_location,
             W.sync_priority,
-            W.sync_state
+            W.sync_state,
+            W.compression,
+            W.sent_raw_bytes,
+            W.sent_wire_bytes,
+            W.compression_ratio,
+            W.send_throughput
     FROM pg_stat_get_activity(NULL) AS S, pg_authid U,
             pg_stat_get_wal_senders() AS W
     WHERE S.usesysid = U.oid AND
@@ -1300,6 +1300,7 @@ static Agg* _copyAgg(const Agg* from)
     COPY_SCALAR_FIELD(is_sonichash);
     COPY_SCALAR_FIELD(is_dummy);
     COPY_SCALAR_FIELD(skew_optimize);
+    COPY_SCALAR_FIELD(is_partial);
     return newnode;
 }
 
@@ -1933,6 +1934,65 @@ static VecWindowAgg* _copyVecWindowAgg(const VecWindowAgg* from)
     return newnode;
 }
 
+/*
+ * _copyVecMergeAppend
+ */
+static VecMergeAppend* _copyVecMergeAppend(const VecMergeAppend* from)
+{
+    VecMergeAppend* newnode = makeNode(VecMergeAppend);
+
+    CopyPlanFields((const Plan*)from, (Plan*)newnode);
+
+    COPY_NODE_FIELD(mergeplans);
+    COPY_SCALAR_FIELD(numCols);
+    if (from->numCols > 0) {
+        COPY_POINTER_FIELD(sortColIdx, from->numCols * sizeof(AttrNumber));
+        COPY_POINTER_FIELD(sortOperators, from->numCols * sizeof(Oid));
+        COPY_POINTER_FIELD(collations, from->numCols * sizeof(Oid));
+        COPY_POINTER_FIELD(nullsFirst, from->numCols * sizeof(bool));
+    }
+
+    return newnode;
+}
+
+/*
+ * _copyVecRecursiveUnion
+ */
+static VecRecursiveUnion* _copyVecRecursiveUnion(const VecRecursiveUnion* from)
+{
+    VecRecursiveUnion* newnode = makeNode(VecRecursiveUnion);
+
+    CopyPlanFields((const Plan*)from, (Plan*)newnode);
+
+    COPY_SCALAR_FIELD(wtParam);
+    COPY_SCALAR_FIELD(numCols);
+    if (from->numCols > 0) {
+        COPY_POINTER_FIELD(dupColIdx, from->numCols * sizeof(AttrNumber));
+        COPY_POINTER_FIELD(dupOperators, from->numCols * sizeof(Oid));
+    }
+    COPY_SCALAR_FIELD(numGroups);
+    COPY_SCALAR_FIELD(has_inner_stream);
+    COPY_SCALAR_FIELD(has_outer_stream);
+    COPY_SCALAR_FIELD(is_used);
+    COPY_SCALAR_FIELD(is_correlated);
+
+    return newnode;
+}
+
+/*
+ * _copyVecWorkTableScan
+ */
+static VecWorkTableScan* _copyVecWorkTableScan(const VecWorkTableScan* from)
+{
+    VecWorkTableScan* newnode = makeNode(VecWorkTableScan);
+
+    CopyScanFields((const Scan*)from, (Scan*)newnode);
+
+    COPY_SCALAR_FIELD(wtParam);
+
+    return newnode;
+}
+
 /*
  * _copyvecRemoteQuery
  */
@@ -5956,6 +6016,15 @@ void* copyObject(const void* from)
         case T_VecWindowAgg:
             retval = _copyVecWindowAgg((VecWindowAgg*)from);
             break;
+        case T_VecMergeAppend:
+            retval = _copyVecMergeAppend((VecMergeAppend*)from);
+            break;
+        case T_VecRecursiveUnion:
+            retval = _copyVecRecursiveUnion((VecRecursiveUnion*)from);
+            break;
+        case T_VecWorkTableScan:
+            retval = _copyVecWorkTableScan((VecWorkTableScan*)from);
+            break;
 
 #ifdef PGXC
         case T_VecStream:
@@ -455,6 +455,7 @@ static const TagStr g_tagStrArr[] = {{T_Invalid, "Invalid"},
     {T_VecPartIterator, "VecPartIterator"},
     {T_VecMergeAppend, "VecMergeAppend"},
     {T_VecRecursiveUnion, "VecRecursiveUnion"},
+    {T_VecWorkTableScan, "VecWorkTableScan"},
     {T_VecScan, "VecScan"},
     {T_CStoreScan, "CStoreScan"},
     {T_DfsScan, "DfsScan"},
@@ -520,6 +521,9 @@ static const TagStr g_tagStrArr[] = {{T_Invalid, "Invalid"},
     {T_VecMaterialState, "VecMaterialState"},
     {T_VecMergeJoinState, "VecMergeJoinState"},
     {T_VecWindowAggState, "VecWindowAggState"},
+    {T_VecMergeAppendState, "VecMergeAppendState"},
+    {T_VecRecursiveUnionState, "VecRecursiveUnionState"},
+    {T_VecWorkTableScanState, "VecWorkTableScanState"},
     {T_VecEndState, "VecEndState"},
     {T_HDFSTableAnalyze, "HDFSTableAnalyze"},
     {T_ForeignTableDesc, "ForeignTableDesc"},
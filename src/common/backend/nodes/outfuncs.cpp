@@ -767,12 +767,10 @@ static void _outVecAppend(StringInfo str, Append* node)
     WRITE_NODE_FIELD(appendplans);
 }
 
-static void _outMergeAppend(StringInfo str, MergeAppend* node)
+static void _outCommonMergeAppendPart(StringInfo str, MergeAppend* node)
 {
     int i;
 
-    WRITE_NODE_TYPE("MERGEAPPEND");
-
     _outPlanInfo(str, (Plan*)node);
 
     WRITE_NODE_FIELD(mergeplans);
@@ -809,11 +807,21 @@ static void _outMergeAppend(StringInfo str, MergeAppend* node)
     }
 }
 
-static void _outRecursiveUnion(StringInfo str, RecursiveUnion* node)
+static void _outMergeAppend(StringInfo str, MergeAppend* node)
 {
-    int i;
+    WRITE_NODE_TYPE("MERGEAPPEND");
+    _outCommonMergeAppendPart(str, node);
+}
 
-    WRITE_NODE_TYPE("RECURSIVEUNION");
+static void _outVecMergeAppend(StringInfo str, VecMergeAppend* node)
+{
+    WRITE_NODE_TYPE("VECMERGEAPPEND");
+    _outCommonMergeAppendPart(str, node);
+}
+
+static void _outCommonRecursiveUnionPart(StringInfo str, RecursiveUnion* node)
+{
+    int i;
 
     _outPlanInfo(str, (Plan*)node);
 
@@ -833,6 +841,18 @@ static void _outRecursiveUnion(StringInfo str, RecursiveUnion* node)
     WRITE_BOOL_FIELD(is_correlated);
 }
 
+static void _outRecursiveUnion(StringInfo str, RecursiveUnion* node)
+{
+    WRITE_NODE_TYPE("RECURSIVEUNION");
+    _outCommonRecursiveUnionPart(str, node);
+}
+
+static void _outVecRecursiveUnion(StringInfo str, VecRecursiveUnion* node)
+{
+    WRITE_NODE_TYPE("VECRECURSIVEUNION");
+    _outCommonRecursiveUnionPart(str, node);
+}
+
 static void _outBitmapAnd(StringInfo str, BitmapAnd* node)
 {
     WRITE_NODE_TYPE("BITMAPAND");
@@ -1270,6 +1290,15 @@ static void _outWorkTableScan(StringInfo str, WorkTableScan* node)
     WRITE_INT_FIELD(wtParam);
 }
 
+static void _outVecWorkTableScan(StringInfo str, VecWorkTableScan* node)
+{
+    WRITE_NODE_TYPE("VECWORKTABLESCAN");
+
+    _outScanInfo(str, (Scan*)node);
+
+    WRITE_INT_FIELD(wtParam);
+}
+
 template <typename T>
 static void _outCommonForeignScanPart(StringInfo str, T* node)
 {
@@ -1489,6 +1518,7 @@ static void _outAgg(StringInfo str, Agg* node)
     WRITE_BOOL_FIELD(is_sonichash);
     WRITE_BOOL_FIELD(is_dummy);
     WRITE_UINT_FIELD(skew_optimize);
+    WRITE_BOOL_FIELD(is_partial);
 }
 
 static void _outWindowAgg(StringInfo str, WindowAgg* node)
@@ -5432,6 +5462,15 @@ static void _outNode(StringInfo str, const void* obj)
             case T_VecAppend:
                 _outVecAppend(str, (VecAppend*)obj);
                 break;
+            case T_VecMergeAppend:
+                _outVecMergeAppend(str, (VecMergeAppend*)obj);
+                break;
+            case T_VecRecursiveUnion:
+                _outVecRecursiveUnion(str, (VecRecursiveUnion*)obj);
+                break;
+            case T_VecWorkTableScan:
+                _outVecWorkTableScan(str, (VecWorkTableScan*)obj);
+                break;
             case T_VecLimit:
                 _outVecLimit(str, (VecLimit*)obj);
                 break;
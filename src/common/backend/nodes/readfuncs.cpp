@@ -2775,6 +2775,7 @@ static Agg* _readAgg(Agg* local_node)
     READ_BOOL_FIELD(is_sonichash);
     READ_BOOL_FIELD(is_dummy);
     READ_UINT_FIELD(skew_optimize);
+    READ_BOOL_FIELD(is_partial);
 
     READ_DONE();
 }
@@ -3833,6 +3834,28 @@ static WorkTableScan* _readWorkTableScan(WorkTableScan* local_node)
     READ_DONE();
 }
 
+/*
+ * The vectorized nodes carry no fields of their own, so they are read by
+ * the row readers on a node of the vectorized type.
+ */
+static VecMergeAppend* _readVecMergeAppend(VecMergeAppend* local_node)
+{
+    READ_LOCALS_NULL(VecMergeAppend);
+    return (VecMergeAppend*)_readMergeAppend(local_node);
+}
+
+static VecRecursiveUnion* _readVecRecursiveUnion(VecRecursiveUnion* local_node)
+{
+    READ_LOCALS_NULL(VecRecursiveUnion);
+    return (VecRecursiveUnion*)_readRecursiveUnion(local_node);
+}
+
+static VecWorkTableScan* _readVecWorkTableScan(VecWorkTableScan* local_node)
+{
+    READ_LOCALS_NULL(VecWorkTableScan);
+    return (VecWorkTableScan*)_readWorkTableScan(local_node);
+}
+
 static PlanInvalItem* _readPlanInvalItem(PlanInvalItem* local_node)
 {
     READ_LOCALS_NULL(PlanInvalItem);
@@ -5088,6 +5111,12 @@ Node* parseNodeString(void)
         return_value = _readVecPartIterator(NULL);
     } else if (MATCH("VECAPPEND", 9)) {
         return_value = _readVecAppend(NULL);
+    } else if (MATCH("VECMERGEAPPEND", 14)) {
+        return_value = _readVecMergeAppend(NULL);
+    } else if (MATCH("VECRECURSIVEUNION", 17)) {
+        return_value = _readVecRecursiveUnion(NULL);
+    } else if (MATCH("VECWORKTABLESCAN", 16)) {
+        return_value = _readVecWorkTableScan(NULL);
     } else if (MATCH("VECSETOP", 8)) {
         return_value = _readVecSetOp(NULL);
     } else if (MATCH("VECFOREIGNSCAN", 14)) {
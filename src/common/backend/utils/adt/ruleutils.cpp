@@ -3721,6 +3721,8 @@ static void set_deparse_planstate(deparse_namespace* dpns, PlanState* ps)
         dpns->outer_planstate = ((VecAppendState*)ps)->appendplans[0];
     else if (IsA(ps, MergeAppendState))
         dpns->outer_planstate = ((MergeAppendState*)ps)->mergeplans[0];
+    else if (IsA(ps, VecMergeAppendState))
+        dpns->outer_planstate = ((VecMergeAppendState*)ps)->mergeplans[0];
     else if (IsA(ps, ModifyTableState))
         dpns->outer_planstate = ((ModifyTableState*)ps)->mt_plans[0];
     else if (IsA(ps, VecModifyTableState))
@@ -105,6 +105,7 @@
 #include "replication/reorderbuffer.h"
 #include "replication/replicainternal.h"
 #include "replication/slot.h"
+#include "replication/streamcompress.h"
 #include "replication/syncrep.h"
 #include "replication/walreceiver.h"
 #include "replication/walsender.h"
@@ -322,7 +323,9 @@ const char* sync_guc_variable_namelist[] = {"work_mem",
     "enable_delta_store",
     "enable_codegen",
     "enable_codegen_print",
+    "enable_row_codegen",
     "codegen_cost_threshold",
+    "codegen_cache_size",
     "codegen_strategy",
     "max_query_retry_times",
     "convert_string_to_digit",
@@ -338,6 +341,8 @@ const char* sync_guc_variable_namelist[] = {"work_mem",
     "enable_early_free",
     "cstore_backwrite_quantity",
     "cstore_backwrite_max_threshold",
+    "cstore_compress_threads",
+    "cstore_recluster_cus",
     "prefetch_quantity",
     "backwrite_quantity",
     "cstore_prefetch_quantity",
@@ -375,6 +380,10 @@ const char* sync_guc_variable_namelist[] = {"work_mem",
     "enable_sonic_optspill",
     "enable_sonic_hashjoin",
     "enable_sonic_hashagg",
+    "enable_adaptive_hashagg",
+    "enable_vector_radix_sort",
+    "vector_sort_threads",
+    "vector_sort_rows_per_thread",
 #ifdef ENABLE_MULTIPLE_NODES
     "enable_stream_recursive",
 #endif
@@ -910,6 +919,9 @@ static const struct config_enum_entry remote_read_options[] = {{"off", REMOTE_RE
     {"authentication", REMOTE_READ_AUTH, false},
     {NULL, 0, false}};
 
+static const struct config_enum_entry replication_compression_options[] = {
+    {"none", STREAM_COMPRESS_NONE, false}, {"lz4", STREAM_COMPRESS_LZ4, false}, {NULL, 0, false}};
+
 static const struct config_enum_entry resource_track_log_options[] = {
     {"summary", SUMMARY, false}, {"detail", DETAIL, false}, {NULL, 0, false}};
 
@@ -1313,6 +1325,63 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_cstore_column_update",
+                PGC_USERSET,
+                QUERY_TUNING,
+                gettext_noop("Enables update of column table to write only the updated columns."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.enable_cstore_column_update,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "enable_cstore_fsst",
+                PGC_USERSET,
+                QUERY_TUNING,
+                gettext_noop("Enables FSST encoding of the string CUs of column table."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.enable_cstore_fsst,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "enable_cstore_simd_decode",
+                PGC_USERSET,
+                DEVELOPER_OPTIONS,
+                gettext_noop("Enables decoding delta and RLE values of CUs with vector instructions."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.enable_cstore_simd_decode,
+            true,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "enable_cu_cache_admission",
+                PGC_SIGHUP,
+                RESOURCES_MEM,
+                gettext_noop("Enables cstore buffers to keep the CUs read once for a shorter time than "
+                             "the CUs read repeatedly."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.enable_cu_cache_admission,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_incremental_catchup",
@@ -1340,6 +1409,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_row_codegen",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable llvm for row executor."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_row_codegen,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_sonic_optspill",
@@ -1382,6 +1465,34 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_adaptive_hashagg",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable flushing groups of the lower vector hash agg instead of spilling."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_adaptive_hashagg,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "enable_vector_radix_sort",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable radix sort on integer leading key for vector sort."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_vector_radix_sort,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
 #ifdef ENABLE_MULTIPLE_NODES
         {
             {
@@ -4275,7 +4386,6 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
-#ifdef ENABLE_MULTIPLE_NODES
         {
             {
                 "enable_cbm_tracking",
@@ -4290,7 +4400,6 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
-#endif
         {
             {
                 "enable_copy_server_files",
@@ -4907,6 +5016,24 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "standby_buffer_pin_delay",
+                PGC_SIGHUP,
+                REPLICATION_STANDBY,
+                gettext_noop("Sets the minimum time redo waits for hot standby queries holding a pin on a page "
+                    "before canceling them."),
+                NULL,
+                GUC_UNIT_MS
+            },
+            &u_sess->attr.attr_storage.standby_buffer_pin_delay,
+            0,
+            0,
+            INT_MAX,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "wal_receiver_status_interval",
@@ -5731,6 +5858,24 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "logical_decoding_work_mem",
+                PGC_USERSET,
+                RESOURCES_MEM,
+                gettext_noop("Sets the maximum memory to be used for logical decoding."),
+                gettext_noop("Beyond it, the largest transaction being decoded is streamed to the output plugin "
+                             "or spilled to disk."),
+                GUC_UNIT_KB
+            },
+            &u_sess->attr.attr_memory.logical_decoding_work_mem,
+            65536,
+            64,
+            MAX_KILOBYTES,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "bulk_write_ring_size",
@@ -6470,6 +6615,24 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "recovery_prefetch_distance",
+                PGC_SIGHUP,
+                RESOURCES_RECOVERY,
+                gettext_noop("Sets how far ahead of replay the blocks referenced by WAL are prefetched "
+                             "during extreme RTO redo."),
+                gettext_noop("Zero disables prefetching."),
+                GUC_UNIT_KB
+            },
+            &u_sess->attr.attr_storage.recovery_prefetch_distance,
+            0,
+            0,
+            MAX_KILOBYTES,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "wal_sender_timeout",
@@ -7003,6 +7166,56 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "autovacuum_delta_merge_threshold",
+                PGC_SIGHUP,
+                AUTOVACUUM,
+                gettext_noop("Minimum number of rows in the delta table of column table prior to merge."),
+                gettext_noop("-1 disables merging the delta table by its size.")
+            },
+            &u_sess->attr.attr_storage.autovacuum_delta_merge_thresh,
+            60000,
+            -1,
+            INT_MAX,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "autovacuum_delta_merge_age",
+                PGC_SIGHUP,
+                AUTOVACUUM,
+                gettext_noop("Time the rows can stay in the delta table of column table before merge."),
+                gettext_noop("-1 disables merging the delta table by its age."),
+                GUC_UNIT_S
+            },
+            &u_sess->attr.attr_storage.autovacuum_delta_merge_age,
+            -1,
+            -1,
+            INT_MAX / 1000,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "autovacuum_recluster_age",
+                PGC_SIGHUP,
+                AUTOVACUUM,
+                gettext_noop("Time a changed column table with partial cluster key waits before it is re-clustered."),
+                gettext_noop("-1 disables re-clustering by autovacuum."),
+                GUC_UNIT_S
+            },
+            &u_sess->attr.attr_storage.autovacuum_recluster_age,
+            -1,
+            -1,
+            INT_MAX / 1000,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "autovacuum_analyze_threshold",
@@ -8521,6 +8734,38 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "cstore_compress_threads",
+                PGC_USERSET,
+                RESOURCES_ASYNCHRONOUS,
+                gettext_noop("Sets the maximum number of threads compressing the CUs of one column table load."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.cstore_compress_threads,
+            1,
+            1,
+            64,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "cstore_recluster_cus",
+                PGC_USERSET,
+                RESOURCES_ASYNCHRONOUS,
+                gettext_noop("Sets the maximum number of CUs of a column table rewritten in cluster key order by one vacuum."),
+                gettext_noop("0 disables re-clustering by vacuum.")
+            },
+            &u_sess->attr.attr_storage.cstore_recluster_cus,
+            0,
+            0,
+            INT_MAX,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "fast_extend_file_size",
@@ -8662,6 +8907,66 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        /*
+         * max number of compiled llvm functions kept per thread for reuse
+         * across executions, 0 means compiled code is never cached.
+         */
+        {
+            {
+                "codegen_cache_size",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Sets the maximum number of cached llvm functions per thread."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.codegen_cache_size,
+            64,
+            0,
+            1024,
+            NULL,
+            NULL,
+            NULL
+        },
+        /*
+         * max number of threads used by one vector sort to radix sort and
+         * merge its in-memory rows.
+         */
+        {
+            {
+                "vector_sort_threads",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Sets the maximum number of threads used by vector radix sort."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.vector_sort_threads,
+            4,
+            1,
+            64,
+            NULL,
+            NULL,
+            NULL
+        },
+        /*
+         * min number of non-null rows each thread of a parallel vector radix
+         * sort has to get, smaller inputs are sorted by the backend alone.
+         */
+        {
+            {
+                "vector_sort_rows_per_thread",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Sets the minimum number of rows per thread of vector radix sort."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.vector_sort_rows_per_thread,
+            262144,
+            128,
+            INT_MAX,
+            NULL,
+            NULL,
+            NULL
+        },
 #ifdef ENABLE_MULTIPLE_NODES
         {
             {
@@ -11689,6 +11994,21 @@ static void init_configure_names_enum()
             NULL,
             NULL
         },
+        {
+            {
+                "replication_compression",
+                PGC_SIGHUP,
+                REPLICATION_STANDBY,
+                gettext_noop("Sets the compression method the standby asks for on the WAL and data streams."),
+                gettext_noop("Takes effect when the standby connects to its sender again.")
+            },
+            &u_sess->attr.attr_storage.replication_compression,
+            STREAM_COMPRESS_NONE,
+            replication_compression_options,
+            NULL,
+            NULL,
+            NULL
+        },
         /* End-of-list marker */
         {
             {
@@ -12127,7 +12447,6 @@ static void init_single_node_unsupport_guc()
     u_sess->attr.attr_sql.enable_agg_pushdown_for_cooperation_analysis = true;
     u_sess->attr.attr_common.enable_tsdb = false;
     u_sess->attr.attr_sql.acceleration_with_compute_pool = false;
-    u_sess->attr.attr_storage.enable_cbm_tracking = false;
     u_sess->attr.attr_sql.enable_constraint_optimization = true;
     u_sess->attr.attr_sql.enable_csqual_pushdown = true;
     u_sess->attr.attr_sql.enable_hadoop_env = false;
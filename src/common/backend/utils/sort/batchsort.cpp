@@ -17,6 +17,8 @@
 #include "knl/knl_variable.h"
 
 #include <limits.h>
+#include <pthread.h>
+#include <signal.h>
 
 #include "executor/executor.h"
 #include "miscadmin.h"
@@ -43,6 +45,8 @@
 #include "utils/numeric.h"
 #include "utils/numeric_gs.h"
 #include "access/tuptoaster.h"
+#include "catalog/pg_proc.h"
+#include "utils/fmgroids.h"
 
 typedef int (*LLVM_CMC_func)(const MultiColumns* a, const MultiColumns* b, Batchsortstate* state);
 
@@ -417,6 +421,28 @@ void batchsort_set_bound(Batchsortstate* state, int64 bound)
     state->sortKeys->abbrev_full_comparator = NULL;
 }
 
+/*
+ * batchsort_get_bound_value - fetch the leading sort key of the top of the
+ * bounded heap.
+ *
+ * Only an input row sorting before this value could enter the heap, so the
+ * caller may use it to skip input that can not make it. Returns false if the
+ * sort has not switched to a bounded heapsort yet. The value points into the
+ * heap and is only valid until the next batch is put into the sort.
+ */
+bool batchsort_get_bound_value(Batchsortstate* state, Datum* value, bool* isnull)
+{
+    if (state->m_status != BS_BOUNDED)
+        return false;
+
+    MultiColumns* top = state->m_storeColumns.m_memValues;
+    int colIdx = state->m_scanKeys->sk_attno - 1;
+
+    *isnull = IS_NULL(top->m_nulls[colIdx]);
+    *value = top->m_values[colIdx];
+    return true;
+}
+
 /*
  * batchsort_end
  *
@@ -786,8 +812,506 @@ bool Batchsortstate::ConsiderAbortCommon()
     return false;
 }
 
+/*
+ * Radix sort for the in-memory sort phase.
+ *
+ * When the leading sort key is an integer-like type ordered by its btree
+ * comparator, every row is mapped to a 64-bit normalized key whose unsigned
+ * order is the requested order (sign bit flipped, all bits inverted for
+ * DESC).  The (key, row index) pairs are sorted by an MSD radix sort, then
+ * rows sharing the same normalized key, as well as NULL rows, are ordered by
+ * the regular comparator so that the remaining sort keys are honoured.
+ *
+ * For large inputs the key array is split into slices which are radix sorted
+ * by worker threads, then merged by the same number of workers: each worker
+ * owns a key range delimited by splitters sampled from all sorted slices and
+ * merges that range of every slice into its own part of the output.  Workers
+ * only ever touch the key arrays, so they never palloc or ereport.
+ */
+#define RADIX_SORT_MIN_ROWS 1024
+#define RADIX_INSERTION_SORT_ROWS 32
+#define RADIX_MAX_WORKERS 64
+#define RADIX_SIGN_BIT (((uint64)1) << 63)
+
+typedef struct RadixSortItem {
+    uint64 key;
+    int idx;
+} RadixSortItem;
+
+typedef struct RadixSortWorker {
+    pthread_t thread;
+    bool started;
+
+    /* run generation: slice to be sorted in place */
+    RadixSortItem* items;
+    int nitems;
+
+    /* merge: [runLow[i], runHigh[i]) of every run goes to output */
+    RadixSortItem** runs;
+    int* runLow;
+    int* runHigh;
+    int nruns;
+    RadixSortItem* output;
+} RadixSortWorker;
+
+static inline uint64 RadixNormalizeKey(Datum datum, RadixSortKeyKind kind, bool desc)
+{
+    uint64 key = 0;
+
+    switch (kind) {
+        case RADIX_KEY_INT16:
+            key = ((uint64)(int64)DatumGetInt16(datum)) ^ RADIX_SIGN_BIT;
+            break;
+        case RADIX_KEY_INT32:
+            key = ((uint64)(int64)DatumGetInt32(datum)) ^ RADIX_SIGN_BIT;
+            break;
+        case RADIX_KEY_INT64:
+            key = ((uint64)DatumGetInt64(datum)) ^ RADIX_SIGN_BIT;
+            break;
+        case RADIX_KEY_UINT32:
+            key = (uint64)DatumGetObjectId(datum);
+            break;
+        default:
+            Assert(false);
+            break;
+    }
+
+    return desc ? ~key : key;
+}
+
+/*
+ * Start bit of the most significant byte in which the keys differ, or -1 if
+ * all the keys are identical.
+ */
+static int RadixFirstShift(const RadixSortItem* items, int nitems)
+{
+    uint64 diff = 0;
+
+    for (int i = 1; i < nitems; i++) {
+        diff |= items[i].key ^ items[0].key;
+    }
+
+    if (diff == 0) {
+        return -1;
+    }
+
+    int shift = 56;
+    while ((diff >> shift) == 0) {
+        shift -= 8;
+    }
+    return shift;
+}
+
+static void RadixInsertionSort(RadixSortItem* items, int nitems)
+{
+    for (int i = 1; i < nitems; i++) {
+        RadixSortItem item = items[i];
+        int j = i - 1;
+
+        while (j >= 0 && items[j].key > item.key) {
+            items[j + 1] = items[j];
+            j--;
+        }
+        items[j + 1] = item;
+    }
+}
+
+/*
+ * In-place MSD radix sort (American flag sort) on one byte of the key,
+ * recursing into every bucket for the following bytes.
+ */
+static void RadixSortItems(RadixSortItem* items, int nitems, int shift)
+{
+    int count[256];
+    int next[256];
+    int end[256];
+    errno_t rc;
+
+    for (;;) {
+        if (nitems <= RADIX_INSERTION_SORT_ROWS) {
+            RadixInsertionSort(items, nitems);
+            return;
+        }
+
+        rc = memset_s(count, sizeof(count), 0, sizeof(count));
+        securec_check(rc, "\0", "\0");
+        for (int i = 0; i < nitems; i++) {
+            count[(items[i].key >> shift) & 0xFF]++;
+        }
+
+        /* all the keys share this byte, go on with the next one */
+        if (count[(items[0].key >> shift) & 0xFF] == nitems) {
+            if (shift == 0) {
+                return;
+            }
+            shift -= 8;
+            continue;
+        }
+        break;
+    }
+
+    int pos = 0;
+    for (int b = 0; b < 256; b++) {
+        next[b] = pos;
+        pos += count[b];
+        end[b] = pos;
+    }
+
+    for (int b = 0; b < 256; b++) {
+        while (next[b] < end[b]) {
+            RadixSortItem item = items[next[b]];
+            int digit = (int)((item.key >> shift) & 0xFF);
+
+            while (digit != b) {
+                RadixSortItem tmp = items[next[digit]];
+                items[next[digit]++] = item;
+                item = tmp;
+                digit = (int)((item.key >> shift) & 0xFF);
+            }
+            items[next[b]++] = item;
+        }
+    }
+
+    if (shift == 0) {
+        return;
+    }
+
+    pos = 0;
+    for (int b = 0; b < 256; b++) {
+        if (count[b] > 1) {
+            RadixSortItems(items + pos, count[b], shift - 8);
+        }
+        pos += count[b];
+    }
+}
+
+/* first position in a sorted run whose key is not less than key */
+static int RadixLowerBound(const RadixSortItem* items, int nitems, uint64 key)
+{
+    int low = 0;
+    int high = nitems;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (items[mid].key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void* RadixSortWorkerMain(void* arg)
+{
+    RadixSortWorker* worker = (RadixSortWorker*)arg;
+    int shift = RadixFirstShift(worker->items, worker->nitems);
+
+    if (shift >= 0) {
+        RadixSortItems(worker->items, worker->nitems, shift);
+    }
+    return NULL;
+}
+
+/* k-way merge of this worker's part of every run, using a binary min-heap of run numbers */
+static void* RadixMergeWorkerMain(void* arg)
+{
+    RadixSortWorker* worker = (RadixSortWorker*)arg;
+    RadixSortItem* output = worker->output;
+    int heap[RADIX_MAX_WORKERS];
+    int heapSize = 0;
+    int* low = worker->runLow;
+    int* high = worker->runHigh;
+    RadixSortItem** runs = worker->runs;
+
+#define RADIX_HEAD(r) (runs[(r)][low[(r)]].key)
+
+    for (int r = 0; r < worker->nruns; r++) {
+        if (low[r] >= high[r]) {
+            continue;
+        }
+        /* sift up */
+        int i = heapSize++;
+        while (i > 0 && RADIX_HEAD(heap[(i - 1) / 2]) > RADIX_HEAD(r)) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = r;
+    }
+
+    while (heapSize > 0) {
+        int r = heap[0];
+        *output++ = runs[r][low[r]++];
+
+        if (low[r] >= high[r]) {
+            r = heap[--heapSize];
+            if (heapSize == 0) {
+                break;
+            }
+        }
+
+        /* sift down run r from the root */
+        int i = 0;
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= heapSize) {
+                break;
+            }
+            if (child + 1 < heapSize && RADIX_HEAD(heap[child + 1]) < RADIX_HEAD(heap[child])) {
+                child++;
+            }
+            if (RADIX_HEAD(r) <= RADIX_HEAD(heap[child])) {
+                break;
+            }
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = r;
+    }
+
+#undef RADIX_HEAD
+    return NULL;
+}
+
+/*
+ * Run routine on every worker.  Signals are blocked in the new threads so
+ * that they are always delivered to the backend thread.  If a thread could
+ * not be created its share is done by the caller instead.
+ */
+static void RadixRunWorkers(RadixSortWorker* workers, int nworkers, void* (*routine)(void*))
+{
+    sigset_t newMask;
+    sigset_t oldMask;
+    bool masked = false;
+
+    if (sigfillset(&newMask) == 0 && pthread_sigmask(SIG_BLOCK, &newMask, &oldMask) == 0) {
+        masked = true;
+    }
+
+    /* worker 0 always runs in the current thread */
+    for (int i = 1; i < nworkers; i++) {
+        workers[i].started = masked && (pthread_create(&workers[i].thread, NULL, routine, &workers[i]) == 0);
+    }
+
+    if (masked) {
+        (void)pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+    }
+
+    (void)routine(&workers[0]);
+    for (int i = 1; i < nworkers; i++) {
+        if (workers[i].started) {
+            (void)pthread_join(workers[i].thread, NULL);
+            workers[i].started = false;
+        } else {
+            (void)routine(&workers[i]);
+        }
+    }
+}
+
+/*
+ * Sort items[0, nitems) by key with nworkers threads.  Returns the array
+ * holding the result, which is either items or buffer.
+ */
+static RadixSortItem* RadixParallelSort(RadixSortItem* items, RadixSortItem* buffer, int nitems, int nworkers)
+{
+    RadixSortWorker workers[RADIX_MAX_WORKERS];
+    RadixSortItem* runs[RADIX_MAX_WORKERS];
+    int runSize[RADIX_MAX_WORKERS];
+    uint64 splitters[RADIX_MAX_WORKERS];
+    uint64* samples = (uint64*)palloc(sizeof(uint64) * nworkers * nworkers);
+    int nsamples = 0;
+    errno_t rc;
+
+    Assert(nworkers > 1 && nworkers <= RADIX_MAX_WORKERS);
+    rc = memset_s(workers, sizeof(workers), 0, sizeof(workers));
+    securec_check(rc, "\0", "\0");
+
+    /* phase 1: every worker sorts one slice of the input */
+    int sliceSize = nitems / nworkers;
+    for (int i = 0; i < nworkers; i++) {
+        workers[i].items = items + i * sliceSize;
+        workers[i].nitems = (i == nworkers - 1) ? (nitems - i * sliceSize) : sliceSize;
+        runs[i] = workers[i].items;
+        runSize[i] = workers[i].nitems;
+    }
+    RadixRunWorkers(workers, nworkers, RadixSortWorkerMain);
+
+    /* phase 2: choose splitters by regular sampling of the sorted runs */
+    for (int r = 0; r < nworkers; r++) {
+        for (int s = 0; s < nworkers; s++) {
+            samples[nsamples++] = runs[r][(int)(((int64)runSize[r] * s) / nworkers)].key;
+        }
+    }
+    for (int i = 1; i < nsamples; i++) {
+        uint64 sample = samples[i];
+        int j = i - 1;
+        while (j >= 0 && samples[j] > sample) {
+            samples[j + 1] = samples[j];
+            j--;
+        }
+        samples[j + 1] = sample;
+    }
+    for (int w = 1; w < nworkers; w++) {
+        splitters[w] = samples[w * nworkers];
+    }
+
+    /* phase 3: every worker merges one key range of all the runs */
+    int* bounds = (int*)palloc(sizeof(int) * 2 * nworkers * nworkers);
+    int outPos = 0;
+    for (int w = 0; w < nworkers; w++) {
+        workers[w].runs = runs;
+        workers[w].nruns = nworkers;
+        workers[w].runLow = bounds + 2 * w * nworkers;
+        workers[w].runHigh = workers[w].runLow + nworkers;
+        workers[w].output = buffer + outPos;
+        for (int r = 0; r < nworkers; r++) {
+            int low = (w == 0) ? 0 : RadixLowerBound(runs[r], runSize[r], splitters[w]);
+            int high = (w == nworkers - 1) ? runSize[r] : RadixLowerBound(runs[r], runSize[r], splitters[w + 1]);
+
+            workers[w].runLow[r] = low;
+            workers[w].runHigh[r] = high;
+            outPos += high - low;
+        }
+    }
+    Assert(outPos == nitems);
+    RadixRunWorkers(workers, nworkers, RadixMergeWorkerMain);
+
+    pfree(bounds);
+    pfree(samples);
+    return buffer;
+}
+
+/*
+ * Check whether the leading sort key could be sorted by RadixSortInMem.
+ */
+RadixSortKeyKind Batchsortstate::GetRadixKeyKind()
+{
+    /* abbreviated keys are compared before the real key by compareMultiColumn */
+    if (sortKeys->abbrev_converter != NULL) {
+        return RADIX_KEY_NONE;
+    }
+
+    switch (m_scanKeys[0].sk_func.fn_oid) {
+        case F_BTINT2CMP:
+            return RADIX_KEY_INT16;
+        case BTINT4CMP_OID:
+        case F_DATE_CMP:
+            return RADIX_KEY_INT32;
+        case F_BTINT8CMP:
+#ifdef HAVE_INT64_TIMESTAMP
+        case F_TIMESTAMP_CMP:
+#endif
+            return RADIX_KEY_INT64;
+        case F_BTOIDCMP:
+            return RADIX_KEY_UINT32;
+        default:
+            return RADIX_KEY_NONE;
+    }
+}
+
+/*
+ * Sort m_storeColumns by radix sort on the leading key, see comments above.
+ */
+void Batchsortstate::RadixSortInMem(RadixSortKeyKind kind)
+{
+    int nrows = m_storeColumns.m_memRowNum;
+    MultiColumns* rows = m_storeColumns.m_memValues;
+    ScanKey scanKey = m_scanKeys;
+    int colIdx = scanKey->sk_attno - 1;
+    bool desc = (scanKey->sk_flags & SK_BT_DESC) != 0;
+    bool nullsFirst = (scanKey->sk_flags & SK_BT_NULLS_FIRST) != 0;
+    int nkeys = 0;
+    int nnulls = 0;
+    int nworkers;
+    errno_t rc;
+
+    RadixSortItem* items = (RadixSortItem*)palloc_huge(CurrentMemoryContext, sizeof(RadixSortItem) * nrows);
+
+    /* non-null keys are gathered from the head, NULL rows from the tail */
+    for (int i = 0; i < nrows; i++) {
+        if (IS_NULL(rows[i].m_nulls[colIdx])) {
+            nnulls++;
+            items[nrows - nnulls].idx = i;
+        } else {
+            items[nkeys].key = RadixNormalizeKey(rows[i].m_values[colIdx], kind, desc);
+            items[nkeys].idx = i;
+            nkeys++;
+        }
+    }
+
+    CHECK_FOR_INTERRUPTS();
+
+    RadixSortItem* sorted = items;
+    nworkers =
+        Min(u_sess->attr.attr_sql.vector_sort_threads, nkeys / u_sess->attr.attr_sql.vector_sort_rows_per_thread);
+    nworkers = Min(nworkers, RADIX_MAX_WORKERS);
+    if (nworkers > 1) {
+        RadixSortItem* buffer = (RadixSortItem*)palloc_huge(CurrentMemoryContext, sizeof(RadixSortItem) * nkeys);
+        sorted = RadixParallelSort(items, buffer, nkeys, nworkers);
+    } else {
+        int shift = RadixFirstShift(items, nkeys);
+        if (shift >= 0) {
+            RadixSortItems(items, nkeys, shift);
+        }
+    }
+
+    CHECK_FOR_INTERRUPTS();
+
+    /* permute the rows into their final order */
+    MultiColumns* result = (MultiColumns*)palloc_huge(CurrentMemoryContext, sizeof(MultiColumns) * nrows);
+    int keyBase = nullsFirst ? nnulls : 0;
+    int nullBase = nullsFirst ? 0 : nkeys;
+
+    for (int i = 0; i < nkeys; i++) {
+        result[keyBase + i] = rows[sorted[i].idx];
+    }
+    for (int i = 0; i < nnulls; i++) {
+        result[nullBase + i] = rows[items[nrows - 1 - i].idx];
+    }
+    rc = memcpy_s(rows, sizeof(MultiColumns) * nrows, result, sizeof(MultiColumns) * nrows);
+    securec_check(rc, "\0", "\0");
+    pfree(result);
+
+    /* rows equal on the leading key are ordered by the remaining keys */
+    if (m_nKeys > 1) {
+        int start = 0;
+        while (start < nkeys) {
+            int end = start + 1;
+            while (end < nkeys && sorted[end].key == sorted[start].key) {
+                end++;
+            }
+            if (end - start > 1) {
+                qsort_arg(rows + keyBase + start,
+                    end - start,
+                    sizeof(MultiColumns),
+                    (qsort_arg_comparator)compareMultiColumn,
+                    (void*)this);
+            }
+            start = end;
+        }
+
+        if (nnulls > 1) {
+            qsort_arg(
+                rows + nullBase, nnulls, sizeof(MultiColumns), (qsort_arg_comparator)compareMultiColumn, (void*)this);
+        }
+    }
+
+    if (sorted != items) {
+        pfree(sorted);
+    }
+    pfree(items);
+}
+
 void Batchsortstate::SortInMem()
 {
+    if (m_storeColumns.m_memRowNum >= RADIX_SORT_MIN_ROWS && u_sess->attr.attr_sql.enable_vector_radix_sort) {
+        RadixSortKeyKind kind = GetRadixKeyKind();
+        if (kind != RADIX_KEY_NONE) {
+            RadixSortInMem(kind);
+            return;
+        }
+    }
+
     if (m_storeColumns.m_memRowNum > 1) {
         qsort_arg(m_storeColumns.m_memValues,
             m_storeColumns.m_memRowNum,
@@ -1651,6 +2175,13 @@ void Batchsortstate::MakeBoundedHeap()
     }
 
     Assert(m_storeColumns.m_memRowNum == m_bound);
+
+    /* keep one more datum for the abbreviated key, as CopyMultiColumn does */
+    if (m_boundProbe.m_values == NULL) {
+        m_boundProbe.m_values = (Datum*)palloc0((m_colNum + 1) * sizeof(Datum));
+        m_boundProbe.m_nulls = (uint8*)palloc0(m_colNum * sizeof(uint8));
+    }
+
     m_status = BS_BOUNDED;
 }
 
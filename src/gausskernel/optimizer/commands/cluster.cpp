@@ -3407,6 +3407,8 @@ static void DoCopyCUFormatData(Relation oldRel, Relation newRel, TupleDesc oldTu
     InsertArg args;
     CStoreInsert::InitInsertArg(newRel, NULL, true, args);
     args.sortType = BATCH_SORT;
+    /* rewriting is the chance to cluster all the rows by partial cluster key */
+    args.sortAllRows = true;
     memInfo.canSpreadmaxMem = mem_info->max_mem;
     memInfo.MemSort = mem_info->work_mem;
     memInfo.partitionNum = 1;
@@ -211,6 +211,7 @@ template <bool is_detail>
 static void show_datanode_hash_info(ExplainState* es, int nbatch, int nbatch_original, int nbuckets, long spacePeakKb);
 static void ShowRoughCheckInfo(ExplainState* es, Instrumentation* instrument, int nodeIdx, int smpIdx);
 static void show_hashAgg_info(AggState* hashaggstate, ExplainState* es);
+static void show_hashagg_flush_info(PlanState* planstate, ExplainState* es);
 static void ExplainPrettyList(List* data, ExplainState* es);
 static void show_pretty_time(ExplainState* es, Instrumentation* instrument, char* node_name, int nodeIdx, int smpIdx,
     int dop, bool executed = true);
@@ -1807,6 +1808,7 @@ static void ExplainNode(
         case T_ValuesScan:
         case T_CteScan:
         case T_WorkTableScan:
+        case T_VecWorkTableScan:
         case T_ForeignScan:
         case T_VecForeignScan:
             ExplainScanTarget((Scan*)plan, es);
@@ -2039,7 +2041,8 @@ static void ExplainNode(
                 appendStringInfo(tmpName, ")");
             }
         } break;
-        case T_RecursiveUnion: {
+        case T_RecursiveUnion:
+        case T_VecRecursiveUnion: {
             if (es->format == EXPLAIN_FORMAT_TEXT && is_pretty)
                 appendStringInfo(tmpName,
                     " (%d,%d)",
@@ -2350,11 +2353,14 @@ static void ExplainNode(
         case T_ValuesScan:
         case T_CteScan:
         case T_WorkTableScan:
+        case T_VecWorkTableScan:
         case T_SubqueryScan:
         case T_VecSubqueryScan:
             show_tablesample(plan, planstate, ancestors, es);
 
             show_scan_qual(plan->qual, "Filter", planstate, ancestors, es);
+            if (IsA(plan, CStoreScan))
+                show_bloomfilter<false>(plan, planstate, ancestors, es);
             if (plan->qual)
                 show_instrumentation_count("Rows Removed by Filter", 1, planstate, es);
             show_llvm_info(planstate, es);
@@ -2513,6 +2519,8 @@ static void ExplainNode(
             switch (((Agg*)plan)->aggstrategy) {
                 case AGG_HASHED: {
                     show_hashAgg_info((AggState*)planstate, es);
+                    if (es->analyze && IsA(planstate, VecAggState))
+                        show_hashagg_flush_info(planstate, es);
                     show_llvm_info(planstate, es);
                 } break;
                 case AGG_SORTED: {
@@ -2537,6 +2545,7 @@ static void ExplainNode(
             show_llvm_info(planstate, es);
             break;
         case T_MergeAppend:
+        case T_VecMergeAppend:
             show_merge_append_keys((MergeAppendState*)planstate, ancestors, es);
             break;
         case T_BaseResult:
@@ -2560,6 +2569,7 @@ static void ExplainNode(
             }
             break;
         case T_RecursiveUnion:
+        case T_VecRecursiveUnion:
             show_recursive_info((RecursiveUnionState*)planstate, es);
             break;
 
@@ -2586,6 +2596,7 @@ static void ExplainNode(
         case T_VecAppend:
         case T_VecLimit:
         case T_MergeAppend:
+        case T_VecMergeAppend:
         case T_SubqueryScan:
         case T_VecSubqueryScan:
         case T_ValuesScan:
@@ -2797,6 +2808,7 @@ runnext:
             ExplainMemberNodes(((Append*)plan)->appendplans, ((AppendState*)planstate)->appendplans, ancestors, es);
             break;
         case T_MergeAppend:
+        case T_VecMergeAppend:
             ExplainMemberNodes(
                 ((MergeAppend*)plan)->mergeplans, ((MergeAppendState*)planstate)->mergeplans, ancestors, es);
             break;
@@ -4013,6 +4025,14 @@ static void show_llvm_info(const PlanState* planstate, ExplainState* es)
             if (has_llvm)
                 ExplainCloseGroup("LLVM Detail", "LLVM Detail", false, es);
         }
+    } else if (planstate->instrument != NULL && planstate->instrument->isLlvmOpt) {
+        /* the node ran locally, e.g. row engine scans on a single node */
+        if (es->format == EXPLAIN_FORMAT_TEXT) {
+            appendStringInfoSpaces(es->str, es->indent * 2);
+            appendStringInfoString(es->str, "LLVM Optimized\n");
+        } else {
+            ExplainPropertyText("LLVM", "LLVM Optimized", es);
+        }
     }
 }
 
@@ -4328,6 +4348,44 @@ static void show_hashAgg_info(AggState* hashaggstate, ExplainState* es)
         }
     }
 }
+/*
+ * Show how many times the adaptive lower hash agg flushed its groups to the
+ * upper agg, summed over the threads it ran in.
+ */
+static void show_hashagg_flush_info(PlanState* planstate, ExplainState* es)
+{
+    Instrumentation* instr = NULL;
+    int flush_times = 0;
+
+    if (planstate->plan->plan_node_id > 0 && u_sess->instr_cxt.global_instr &&
+        u_sess->instr_cxt.global_instr->isFromDataNode(planstate->plan->plan_node_id)) {
+        int dop = planstate->plan->parallel_enabled ? u_sess->opt_cxt.query_dop : 1;
+
+        for (int i = 0; i < u_sess->instr_cxt.global_instr->getInstruNodeNum(); i++) {
+            for (int j = 0; j < dop; j++) {
+                instr = u_sess->instr_cxt.global_instr->getInstrSlot(i, planstate->plan->plan_node_id, j);
+                if (instr != NULL && instr->nloops > 0)
+                    flush_times += instr->sorthashinfo.hashagg_flush_times;
+            }
+        }
+    } else if (planstate->instrument != NULL) {
+        flush_times = planstate->instrument->sorthashinfo.hashagg_flush_times;
+    }
+
+    if (flush_times == 0)
+        return;
+
+    if (es->format != EXPLAIN_FORMAT_TEXT) {
+        ExplainPropertyLong("Flush Times", flush_times, es);
+    } else if (t_thrd.explain_cxt.explain_perf_mode == EXPLAIN_NORMAL) {
+        appendStringInfoSpaces(es->str, es->indent * 2);
+        appendStringInfo(es->str, "Flush Times: %d\n", flush_times);
+    } else if (es->planinfo != NULL && es->planinfo->m_staticInfo != NULL) {
+        es->planinfo->m_staticInfo->set_plan_name<true, true>();
+        appendStringInfo(es->planinfo->m_staticInfo->info_str, "Flush Times: %d\n", flush_times);
+    }
+}
+
 /*
  * Show information on hash buckets/batches.
  */
@@ -5304,6 +5362,7 @@ static void show_child_cpu_cycles_and_rows(PlanState* planstate, int idx, int sm
                 outterRows);
             break;
         case T_MergeAppend:
+        case T_VecMergeAppend:
             CalCPUMemberNode<datanode>(((MergeAppend*)plan)->mergeplans,
                 ((MergeAppendState*)planstate)->mergeplans,
                 idx,
@@ -5478,6 +5537,7 @@ static void show_child_time(
                 ((Append*)plan)->appendplans, ((AppendState*)planstate)->appendplans, idx, smpIdx, outer_time);
             break;
         case T_MergeAppend:
+        case T_VecMergeAppend:
             CalOperTimeMemberNode<datanode>(
                 ((MergeAppend*)plan)->mergeplans, ((MergeAppendState*)planstate)->mergeplans, idx, smpIdx, outer_time);
             break;
@@ -7832,7 +7892,8 @@ static void ExplainTargetRel(Plan* plan, Index rti, ExplainState* es)
             objectname = rte->ctename;
             objecttag = "CTE Name";
         } break;
-        case T_WorkTableScan: {
+        case T_WorkTableScan:
+        case T_VecWorkTableScan: {
             /* Assert it's on a self-reference CTE */
             Assert(rte != NULL && rte->rtekind == RTE_CTE && rte->self_reference);
             objectname = rte->ctename;
@@ -19,6 +19,7 @@
 #include "access/cstore_delete.h"
 #include "access/cstore_insert.h"
 #include "access/cstore_rewrite.h"
+#include "access/cstore_summary.h"
 #include "access/dfs/dfs_am.h"
 #include "access/genam.h"
 #include "access/heapam.h"
@@ -1720,6 +1721,15 @@ Oid DefineRelation(CreateStmt* stmt, char relkind, Oid ownerId)
         ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("must have at least one column")));
     }
 
+    /* columns of BLOOM_FILTER_COLUMNS can only be checked against the descriptor */
+    if (0 == pg_strcasecmp(storeChar, ORIENTATION_COLUMN)) {
+        StdRdOptions* col_opt = (StdRdOptions*)heap_reloptions(relkind, reloptions, false);
+        if (col_opt != NULL) {
+            CheckCStoreSummaryColumns(col_opt, descriptor);
+            pfree_ext(col_opt);
+        }
+    }
+
     if (stmt->partTableState) {
         List* pos = NIL;
         bool is_interval = false;
@@ -12288,6 +12298,7 @@ static void ATExecSetRelOptions(Relation rel, List* defList, AlterTableType oper
                 if (NULL != heapRelOpt) {
                     /* validate the values of these options */
                     CheckCStoreRelOption((StdRdOptions*)heapRelOpt);
+                    CheckCStoreSummaryColumns((StdRdOptions*)heapRelOpt, RelationGetDescr(rel));
                 }
             } else if (RelationIsTsStore(rel)) {
                 forbid_to_set_options_for_timeseries_tbl(defList);
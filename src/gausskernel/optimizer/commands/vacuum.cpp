@@ -2670,6 +2670,37 @@ static void getTuplesAndInsert(Relation source, Oid dest_oid)
         relation_close(dest, NoLock);
 }
 
+/*
+ * Rebuild the delta table to give back the space of the merged rows. It needs
+ * AccessExclusiveLock, so it is skipped rather than waiting for the writers
+ * using the delta table, and the space is reused after the next vacuum.
+ */
+static void rebuild_delta_relation(Oid deltaOid)
+{
+    if (!ConditionalLockRelationOid(deltaOid, AccessExclusiveLock)) {
+        ereport(DEBUG1, (errmsg("deltamerge: skip rebuilding delta relation %u in use", deltaOid)));
+        return;
+    }
+
+    Relation delta_rel = relation_open(deltaOid, NoLock);
+    Oid OIDNewHeap = make_new_heap(deltaOid, delta_rel->rd_rel->reltablespace, AccessExclusiveLock);
+
+    /* copy delta data to new heap */
+    getTuplesAndInsert(delta_rel, OIDNewHeap);
+
+    /* swap relfile node */
+    finish_heap_swap(deltaOid, OIDNewHeap, false, false, false, u_sess->utils_cxt.RecentGlobalXmin);
+
+    /* close relation */
+    relation_close(delta_rel, NoLock);
+}
+
+/*
+ * Move the rows of delta table into CUs. The column table is opened with
+ * ShareUpdateExclusiveLock, the same as lazy vacuum, so the writers are not
+ * blocked before the rows are moved. From then on until commit they are
+ * locked out by lazy_vacuum_rel.
+ */
 void merge_cu_relation(void* _info, VacuumStmt* stmt)
 {
     MergeInfo* info = (MergeInfo*)_info;
@@ -2688,8 +2719,8 @@ void merge_cu_relation(void* _info, VacuumStmt* stmt)
         ALLOCSET_DEFAULT_INITSIZE,
         ALLOCSET_DEFAULT_MAXSIZE);
 
-    /* open cstore relation with AccessExclusiveLock lock */
-    rel = relation_open(rel_oid, AccessExclusiveLock);
+    /* open cstore relation with ShareUpdateExclusiveLock lock */
+    rel = relation_open(rel_oid, ShareUpdateExclusiveLock);
 
     /* Silently ignore tables that are temp tables of other backends */
     if (RELATION_IS_OTHER_TEMP(rel)) {
@@ -2713,10 +2744,10 @@ void merge_cu_relation(void* _info, VacuumStmt* stmt)
             Relation main_rel = NULL;
             Partition partrel = NULL;
             Relation onerel = NULL;
-            main_rel = try_relation_open(rel_oid, AccessExclusiveLock); /* need to check */
+            main_rel = try_relation_open(rel_oid, ShareUpdateExclusiveLock); /* need to check */
             if (main_rel) {
                 /* Open the partition */
-                partrel = tryPartitionOpen(main_rel, part_oid, AccessExclusiveLock);
+                partrel = tryPartitionOpen(main_rel, part_oid, ShareUpdateExclusiveLock);
                 if (partrel) {
                     /* Get a Relation from a Partition */
                     onerel = partitionGetRelation(main_rel, partrel);
@@ -2728,21 +2759,8 @@ void merge_cu_relation(void* _info, VacuumStmt* stmt)
                 lazy_vacuum_rel(onerel, stmt, GetAccessStrategy(BAS_VACUUM));
                 CommandCounterIncrement();
 
-                /* get delta oid  */
-                Oid deltaOid = partrel->pd_part->reldeltarelid;
-                Relation delta_rel = relation_open(deltaOid, AccessExclusiveLock);
-                if (delta_rel != NULL) {
-                    Oid OIDNewHeap = make_new_heap(deltaOid, delta_rel->rd_rel->reltablespace, AccessExclusiveLock);
-
-                    /* copy delta data to new heap */
-                    getTuplesAndInsert(delta_rel, OIDNewHeap);
-
-                    /* swap relfile node */
-                    finish_heap_swap(deltaOid, OIDNewHeap, false, false, false, u_sess->utils_cxt.RecentGlobalXmin);
-
-                    /* close relation */
-                    relation_close(delta_rel, NoLock);
-                }
+                /* rebuild delta table */
+                rebuild_delta_relation(partrel->pd_part->reldeltarelid);
 
                 releaseDummyRelation(&onerel);
                 partitionClose(main_rel, partrel, NoLock);
@@ -2770,21 +2788,9 @@ void merge_cu_relation(void* _info, VacuumStmt* stmt)
         lazy_vacuum_rel(rel, stmt, GetAccessStrategy(BAS_VACUUM));
         CommandCounterIncrement();
 
-        /* open delta realtion */
-        Oid deltaOid = rel->rd_rel->reldeltarelid;
-        Relation delta_rel = relation_open(deltaOid, AccessExclusiveLock);
-
-        Oid OIDNewHeap = make_new_heap(deltaOid, delta_rel->rd_rel->reltablespace, AccessExclusiveLock);
-
-        /* copy delta data to new heap */
-        getTuplesAndInsert(delta_rel, OIDNewHeap);
-
-        /* swap relfile node */
-        finish_heap_swap(deltaOid, OIDNewHeap, false, false, false, u_sess->utils_cxt.RecentGlobalXmin);
+        /* rebuild delta table */
+        rebuild_delta_relation(rel->rd_rel->reldeltarelid);
 
-        /* close relation */
-        relation_close(delta_rel, NoLock);
-        
         relation_close(rel, NoLock);
         /*
          * Complete the transaction and free all temporary memory used.
@@ -41,6 +41,7 @@
 
 #include "access/cstore_am.h"
 #include "access/cstore_insert.h"
+#include "access/cstore_rewrite.h"
 #include "access/genam.h"
 #include "access/heapam.h"
 #include "access/transam.h"
@@ -148,6 +149,98 @@ static void lazy_space_alloc(LVRelStats* vacrelstats, BlockNumber relblocks);
 static void lazy_record_dead_tuple(LVRelStats* vacrelstats, ItemPointer itemptr);
 static bool lazy_tid_reaped(ItemPointer itemptr, void* state);
 static int vac_cmp_itemptr(const void* left, const void* right);
+static bool lazy_delete_delta_tuple(Relation deltaRel, ItemPointer tid);
+static void lazy_merge_delta_rows(Relation onerel, Relation deltaRel, HeapScanDesc deltaScanDesc, HeapTuple deltaTup);
+
+/*
+ *	lazy_delete_delta_tuple() -- delete the tuple moved from delta table into CUs
+ *
+ *		The writers of the column table are locked out, but the tuple may have
+ *		been deleted or updated by a transaction committed after our snapshot
+ *		was taken. Return false then, the new version of the tuple is left to
+ *		the next merge. The moved rows and the deletions become visible together
+ *		at commit.
+ */
+static bool lazy_delete_delta_tuple(Relation deltaRel, ItemPointer tid)
+{
+    HTSU_Result result;
+    ItemPointerData update_ctid;
+    TransactionId update_xmax;
+
+    result = heap_delete(deltaRel,
+        tid,
+        &update_ctid,
+        &update_xmax,
+        GetCurrentCommandId(true),
+        InvalidSnapshot,
+        true /* wait for commit */);
+    switch (result) {
+        case HeapTupleMayBeUpdated:
+            /* done successfully */
+            return true;
+
+        case HeapTupleUpdated:
+            /* deleted or updated by a committed transaction */
+            return false;
+
+        case HeapTupleSelfUpdated:
+            ereport(ERROR, (errcode(ERRCODE_T_R_SERIALIZATION_FAILURE), errmsg("tuple already updated by self")));
+            break;
+
+        default:
+            ereport(ERROR,
+                (errcode(ERRCODE_T_R_SERIALIZATION_FAILURE), errmsg("unrecognized heap_delete status: %u", result)));
+            break;
+    }
+
+    return false;
+}
+
+/*
+ *	lazy_merge_delta_rows() -- move the rows of delta table into CUs
+ *
+ *		deltaTup is the first tuple returned by deltaScanDesc, the rest are
+ *		fetched here.
+ */
+static void lazy_merge_delta_rows(Relation onerel, Relation deltaRel, HeapScanDesc deltaScanDesc, HeapTuple deltaTup)
+{
+    InsertArg args;
+    CStoreInsert::InitInsertArg(onerel, NULL, false, args);
+    CStoreInsert cstoreInsert(onerel, args, false, NULL, NULL);
+    TupleDesc tupDesc = onerel->rd_att;
+    Datum* val = (Datum*)palloc(sizeof(Datum) * tupDesc->natts);
+    bool* null = (bool*)palloc(sizeof(bool) * tupDesc->natts);
+    bulkload_rows batchRow(tupDesc, RelationGetMaxBatchRows(onerel), true);
+
+    for (; deltaTup != NULL; deltaTup = heap_getnext(deltaScanDesc, ForwardScanDirection)) {
+        /*
+         * delete the current tuple from delta table first, it may have been
+         * changed since our snapshot.
+         */
+        if (!lazy_delete_delta_tuple(deltaRel, &deltaTup->t_self))
+            continue;
+
+        heap_deform_tuple(deltaTup, tupDesc, val, null);
+
+        /* ignore returned value because only one tuple is appended into */
+        (void)batchRow.append_one_tuple(val, null, tupDesc);
+
+        if (batchRow.full_rownum()) {
+            /*  insert into main table */
+            cstoreInsert.BatchInsert(&batchRow, 0);
+            batchRow.reset(true);
+        }
+    }
+    cstoreInsert.SetEndFlag();
+    cstoreInsert.BatchInsert(&batchRow, 0);
+
+    /* clean cstore insert */
+    pfree(val);
+    pfree(null);
+    CStoreInsert::DeInitInsertArg(args);
+    batchRow.Destroy();
+    cstoreInsert.Destroy();
+}
 
 /*
  *	lazy_vacuum_rel() -- perform LAZY VACUUM for one heap relation
@@ -209,43 +302,51 @@ void lazy_vacuum_rel(Relation onerel, VacuumStmt* vacstmt, BufferAccessStrategy
         Relation deltaRel = heap_open(onerel->rd_rel->reldeltarelid, RowExclusiveLock);
 
         if (RelationIsCUFormat(onerel)) {
-            /* initialize the delta insert */
             HeapScanDesc deltaScanDesc = heap_beginscan(deltaRel, GetActiveSnapshot(), 0, NULL);
+            HeapTuple deltaTup = heap_getnext(deltaScanDesc, ForwardScanDirection);
 
-            InsertArg args;
-            HeapTuple deltaTup = NULL;
-            CStoreInsert::InitInsertArg(onerel, NULL, false, args);
-            CStoreInsert cstoreInsert(onerel, args, false, NULL, NULL);
-            TupleDesc tupDesc = onerel->rd_att;
-            Datum* val = (Datum*)palloc(sizeof(Datum) * tupDesc->natts);
-            bool* null = (bool*)palloc(sizeof(bool) * tupDesc->natts);
-            bulkload_rows batchRow(tupDesc, RelationGetMaxBatchRows(onerel), true);
-
-            while ((deltaTup = heap_getnext(deltaScanDesc, ForwardScanDirection)) != NULL) {
-                heap_deform_tuple(deltaTup, tupDesc, val, null);
-
-                /* ignore returned value because only one tuple is appended into */
-                (void)batchRow.append_one_tuple(val, null, tupDesc);
-
-                if (batchRow.full_rownum()) {
-                    /*  insert into main table */
-                    cstoreInsert.BatchInsert(&batchRow, 0);
-                    batchRow.reset(true);
+            /*
+             * An UPDATE or DELETE blocked by the deletion of a moved row would
+             * find the row gone once we commit, and silently change nothing.
+             * So the writers are locked out until commit by ShareLock, which
+             * they meet when they lock the table before taking their snapshot.
+             * Readers are not blocked. The lock is only taken if the delta has
+             * rows to move or CUs are to be re-clustered, and autovacuum leaves
+             * them to its next round rather than waiting for the writers.
+             */
+            Relation lockRel = RelationIsPartition(onerel) ? vacstmt->onepartrel : onerel;
+            bool recluster = u_sess->attr.attr_storage.cstore_recluster_cus > 0 && !lockRel->rd_rel->relhasindex;
+            bool locked = false;
+
+            if (deltaTup != NULL || recluster) {
+                if (!IsAutoVacuumWorkerProcess()) {
+                    LockRelationOid(RelationGetRelid(lockRel), ShareLock);
+                    locked = true;
+                } else {
+                    locked = ConditionalLockRelationOid(RelationGetRelid(lockRel), ShareLock);
+                    if (!locked) {
+                        ereport(DEBUG2,
+                            (errmsg("\"%s\": delta merge skipped, the table is being written",
+                                RelationGetRelationName(onerel))));
+                    }
                 }
-
-                /* delete the current tuple from delta table */
-                simple_heap_delete(deltaRel, &deltaTup->t_self);
             }
-            cstoreInsert.SetEndFlag();
-            cstoreInsert.BatchInsert(&batchRow, 0);
+
+            if (locked && deltaTup != NULL)
+                lazy_merge_delta_rows(onerel, deltaRel, deltaScanDesc, deltaTup);
             heap_endscan(deltaScanDesc);
 
-            /* clean cstore insert */
-            pfree(val);
-            pfree(null);
-            CStoreInsert::DeInitInsertArg(args);
-            batchRow.Destroy();
-            cstoreInsert.Destroy();
+            /*
+             * Rewrite the CUs overlapping in the partial cluster key while the writers
+             * are still locked out. The moved rows are not indexed, see CStoreReclusterCUs().
+             */
+            if (locked && recluster) {
+                int reclustered = CStoreReclusterCUs(onerel, u_sess->attr.attr_storage.cstore_recluster_cus);
+                if (reclustered > 0) {
+                    ereport((vacstmt->options & VACOPT_VERBOSE) ? VERBOSEMESSAGE : DEBUG2,
+                        (errmsg("\"%s\": re-clustered %d CUs", RelationGetRelationName(onerel), reclustered)));
+                }
+            }
         }
 
         /* clean part info before vacuum delta and desc table */
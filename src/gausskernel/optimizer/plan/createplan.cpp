@@ -4242,7 +4242,8 @@ static void search_var_and_mark_bloomfilter(PlannerInfo* root, Expr* expr, Plan*
 
     switch (nodeTag(plan)) {
         case T_ForeignScan:
-        case T_DfsScan: {
+        case T_DfsScan:
+        case T_CStoreScan: {
             if (IsA(plan, ForeignScan)) {
                 ForeignScan* splan = (VecForeignScan*)plan;
 
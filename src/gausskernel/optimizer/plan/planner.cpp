@@ -7240,6 +7240,8 @@ static Plan* mark_top_agg(
     top_node = (Plan*)copyObject(agg_plan);
     /* remove the skew opt from low layer agg, we only display the flag on top agg. */
     ((Agg*)agg_plan)->skew_optimize = SKEW_RES_NONE;
+    /* top agg regroups the output of low layer agg, so the latter could flush groups early. */
+    ((Agg*)agg_plan)->is_partial = true;
 
     // restore the lefttree pointer of original plan
     /* The having qual of second agg node is copied from first agg and has been processed to second agg expression.
@@ -8023,8 +8025,8 @@ Plan* try_vectorize_plan(Plan* top_plan, Query* parse, bool from_subplan, Planne
          * branch, we don't try vectorization plan, instead we do fallback to just
          * add vec2row on top of CStore operators
          *
-         * In the future if we support native-recursive execution e.g. says VecRecursiveUnion,
-         * then we need revisit this part to lift this restriction
+         * VecRecursiveUnion only covers the non-distributed UNION ALL case, so the
+         * restriction is kept until the stream recursive union is vectorized too
          *
          *
          * We go through fallback_plan to transfer plan to row engine.
@@ -8152,8 +8154,6 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
         case T_FunctionScan:
         case T_CteScan:
         case T_LockRows:
-        case T_MergeAppend:
-        case T_RecursiveUnion:
             return true;
 
         case T_RemoteQuery:
@@ -8319,6 +8319,32 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             }
         } break;
 
+        case T_MergeAppend: {
+            MergeAppend* ma = (MergeAppend*)result_plan;
+            ListCell* lc = NULL;
+            foreach (lc, ma->mergeplans) {
+                Plan* plan = (Plan*)lfirst(lc);
+
+                if (vector_engine_walker(plan, check_rescan))
+                    return true;
+            }
+        } break;
+
+        case T_RecursiveUnion: {
+            /*
+             * Only UNION ALL is supported, and the distributed recursive union
+             * needs the step sync-up of the row engine.
+             */
+            if (((RecursiveUnion*)result_plan)->numCols > 0 || STREAM_RECURSIVECTE_SUPPORTED)
+                return true;
+
+            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+                return true;
+            /* the recursive term is rescanned on every iteration */
+            if (vector_engine_walker(result_plan->righttree, true))
+                return true;
+        } break;
+
         case T_ModifyTable: {
             ModifyTable* mt = (ModifyTable*)result_plan;
             ListCell* lc = NULL;
@@ -8455,7 +8481,11 @@ static Plan* fallback_plan(Plan* result_plan)
             ListCell* lc = NULL;
             foreach (lc, ma->mergeplans) {
                 Plan* plan = (Plan*)lfirst(lc);
-                lfirst(lc) = (Plan*)fallback_plan(plan);
+                plan = (Plan*)fallback_plan(plan);
+                if (IsVecOutput(plan)) {
+                    plan = (Plan*)make_vectorow(plan);
+                }
+                lfirst(lc) = plan;
             }
         } break;
 
@@ -8616,6 +8646,50 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
             }
         } break;
 
+        case T_MergeAppend: {
+            MergeAppend* ma = (MergeAppend*)result_plan;
+            ListCell* lc = NULL;
+            bool isVec = true;
+            foreach (lc, ma->mergeplans) {
+                Plan* plan = (Plan*)lfirst(lc);
+                plan = vectorize_plan(plan, ignore_remotequery);
+                lfirst(lc) = plan;
+                if (!IsVecOutput(plan)) {
+                    if (u_sess->attr.attr_sql.enable_force_vector_engine)
+                        lfirst(lc) = (Plan*)make_rowtovec(plan);
+                    isVec = false;
+                }
+            }
+            if (isVec == true || u_sess->attr.attr_sql.enable_force_vector_engine) {
+                return build_vector_plan(result_plan);
+            } else {
+                foreach (lc, ma->mergeplans) {
+                    Plan* plan = (Plan*)lfirst(lc);
+                    if (IsVecOutput(plan)) {
+                        lfirst(lc) = (Plan*)make_vectorow(plan);
+                    }
+                }
+                return result_plan;
+            }
+        } break;
+
+        /*
+         * The WorkTableScan nodes below a RecursiveUnion read its working table,
+         * so once the recursive term is walked the RecursiveUnion has to go
+         * vector as well, whatever its children are.
+         */
+        case T_RecursiveUnion:
+            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery);
+            result_plan->righttree = vectorize_plan(result_plan->righttree, ignore_remotequery);
+            if (!IsVecOutput(result_plan->lefttree))
+                result_plan->lefttree = (Plan*)make_rowtovec(result_plan->lefttree);
+            if (!IsVecOutput(result_plan->righttree))
+                result_plan->righttree = (Plan*)make_rowtovec(result_plan->righttree);
+            return build_vector_plan(result_plan);
+
+        case T_WorkTableScan:
+            return build_vector_plan(result_plan);
+
         case T_ModifyTable:
             /* ModifyTable doesn't support vector right now */
             {
@@ -8730,6 +8804,15 @@ static Plan* build_vector_plan(Plan* plan)
         case T_Append:
             plan->type = T_VecAppend;
             break;
+        case T_MergeAppend:
+            plan->type = T_VecMergeAppend;
+            break;
+        case T_RecursiveUnion:
+            plan->type = T_VecRecursiveUnion;
+            break;
+        case T_WorkTableScan:
+            plan->type = T_VecWorkTableScan;
+            break;
         case T_Group:
             plan->type = T_VecGroup;
             break;
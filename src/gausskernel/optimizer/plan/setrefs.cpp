@@ -315,6 +315,8 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
             if (splan->tablesample) {
                 splan->tablesample = (TableSampleClause*)fix_scan_expr(root, (Node*)splan->tablesample, rtoffset);
             }
+            /* runtime bloom filters of hash join are pushed down to column table only */
+            splan->plan.var_list = fix_scan_list(root, splan->plan.var_list, rtoffset);
         } break;
         case T_DfsScan: {
             DfsScan* splan = (DfsScan*)plan;
@@ -487,7 +489,8 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
                 }
             }
         } break;
-        case T_WorkTableScan: {
+        case T_WorkTableScan:
+        case T_VecWorkTableScan: {
             WorkTableScan* splan = (WorkTableScan*)plan;
 
             splan->scan.scanrelid += rtoffset;
@@ -891,7 +894,8 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
                 lfirst(l) = set_plan_refs(root, (Plan*)lfirst(l), rtoffset);
             }
         } break;
-        case T_MergeAppend: {
+        case T_MergeAppend:
+        case T_VecMergeAppend: {
             MergeAppend* splan = (MergeAppend*)plan;
 
             /*
@@ -905,6 +909,7 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
             }
         } break;
         case T_RecursiveUnion:
+        case T_VecRecursiveUnion:
             /* This doesn't evaluate targetlist or check quals either */
             set_dummy_tlist_references(plan, rtoffset);
             AssertEreport(plan->qual == NIL, MOD_OPT, "qual should be null");
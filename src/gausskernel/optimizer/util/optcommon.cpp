@@ -447,6 +447,15 @@ void GetPlanNodePlainText(
         case T_VecAppend:
             *pname = *sname = *pt_operation = "Vector Append";
             break;
+        case T_VecMergeAppend:
+            *pname = *sname = *pt_operation = "Vector Merge Append";
+            break;
+        case T_VecRecursiveUnion:
+            *pname = *sname = *pt_operation = "Vector Recursive Union";
+            break;
+        case T_VecWorkTableScan:
+            *pname = *sname = *pt_operation = "Vector WorkTable Scan";
+            break;
         case T_VecModifyTable:
             *sname = "ModifyTable";
             *pt_operation = "Modify Table";
@@ -222,7 +222,8 @@ bool plan_tree_walker(Node* node, MethodWalker walker, void* context)
                 return true;
         } break;
 
-        case T_MergeAppend: {
+        case T_MergeAppend:
+        case T_VecMergeAppend: {
             MethodPlanWalkerContext* mcontext = (MethodPlanWalkerContext*)context;
 
             /* Mark the status to let children node know it's under multi group node */
@@ -261,6 +262,7 @@ bool plan_tree_walker(Node* node, MethodWalker walker, void* context)
         case T_ValuesScan:
         case T_CteScan:
         case T_WorkTableScan:
+        case T_VecWorkTableScan:
             if (walk_scan_node_fields((Scan*)node, walker, context))
                 return true;
             if (IsA(node, ValuesScan)) {
@@ -524,6 +526,7 @@ bool plan_tree_walker(Node* node, MethodWalker walker, void* context)
         case T_VecGroup:
         case T_LockRows:
         case T_RecursiveUnion:
+        case T_VecRecursiveUnion:
         case T_VecRemoteQuery:
         case T_RemoteQuery: {
             MethodPlanWalkerContext* mcontext = (MethodPlanWalkerContext*)context;
@@ -292,6 +292,8 @@ static autovac_table* table_recheck_autovac(
 static void relation_needs_vacanalyze(Oid relid, AutoVacOpts* relopts, Form_pg_class classForm, HeapTuple tuple,
     PgStat_StatTabEntry* tabentry, bool allowAnalyze, bool allowVacuum, bool is_recheck, bool* dovacuum,
     bool* doanalyze, bool* need_freeze);
+static bool relation_needs_delta_merge(Form_pg_class classForm, HeapTuple tuple, PgStat_StatTabEntry* tabentry);
+static bool relation_needs_recluster(Form_pg_class classForm, HeapTuple tuple, PgStat_StatTabEntry* tabentry);
 
 static void autovacuum_do_vac_analyze(autovac_table* tab, BufferAccessStrategy bstrategy);
 static void autovacuum_local_vac_analyze(autovac_table* tab, BufferAccessStrategy bstrategy);
@@ -3187,6 +3189,17 @@ static void relation_needs_vacanalyze(Oid relid, AutoVacOpts* relopts, Form_pg_c
             *doanalyze = ((float4)anltuples > anlthresh);
     }
 
+    /*
+     * Column table is not vacuumed for its dead tuples, but lazy vacuum moves
+     * the rows of its delta table into CUs without blocking the writers.
+     */
+    if (!*dovacuum && relation_needs_delta_merge(classForm, tuple, tabentry))
+        *dovacuum = true;
+
+    /* and rewrites the CUs overlapping in the partial cluster key */
+    if (!*dovacuum && relation_needs_recluster(classForm, tuple, tabentry))
+        *dovacuum = true;
+
     if (*dovacuum || *doanalyze) {
         AUTOVAC_LOG(DEBUG2,
             "vac \"%s\": recheck = %s need_freeze = %s "
@@ -3204,6 +3217,109 @@ static void relation_needs_vacanalyze(Oid relid, AutoVacOpts* relopts, Form_pg_c
     }
 }
 
+/*
+ * relation_needs_delta_merge
+ *
+ * Check whether the delta table of a column table is to be merged, that is it
+ * holds at least autovacuum_delta_merge_threshold rows, or it holds rows and
+ * the table has not been vacuumed for autovacuum_delta_merge_age seconds.
+ * The partitions of partitioned table are merged by manual vacuum.
+ */
+static bool relation_needs_delta_merge(Form_pg_class classForm, HeapTuple tuple, PgStat_StatTabEntry* tabentry)
+{
+    int merge_thresh = u_sess->attr.attr_storage.autovacuum_delta_merge_thresh;
+    int merge_age = u_sess->attr.attr_storage.autovacuum_delta_merge_age;
+    PgStat_StatTabKey tabkey;
+    PgStat_StatTabEntry* delta_entry = NULL;
+    bytea* relopts = NULL;
+    bool is_colstore = false;
+    bool need_merge = false;
+
+    if (!DO_VACUUM || (merge_thresh < 0 && merge_age < 0))
+        return false;
+
+    if (RELKIND_RELATION != classForm->relkind || isPartitionedRelation(classForm) ||
+        !OidIsValid(classForm->reldeltarelid))
+        return false;
+
+    relopts = extractRelOptions(tuple, GetDefaultPgClassDesc(), InvalidOid);
+    is_colstore = (relopts != NULL && StdRelOptIsColStore(relopts));
+    if (relopts != NULL)
+        pfree_ext(relopts);
+    if (!is_colstore)
+        return false;
+
+    tabkey.statFlag = InvalidOid;
+    tabkey.tableid = classForm->reldeltarelid;
+    delta_entry = pgstat_fetch_stat_tabentry(&tabkey);
+    if (delta_entry == NULL || delta_entry->n_live_tuples <= 0)
+        return false;
+
+    if (merge_thresh >= 0 && delta_entry->n_live_tuples >= merge_thresh) {
+        need_merge = true;
+    } else if (merge_age >= 0) {
+        TimestampTz last_merge = 0;
+
+        if (tabentry != NULL)
+            last_merge = Max(tabentry->vacuum_timestamp, tabentry->autovac_vacuum_timestamp);
+        need_merge = (last_merge == 0 ||
+                      TimestampDifferenceExceeds(last_merge, GetCurrentTimestamp(), merge_age * 1000));
+    }
+
+    if (need_merge) {
+        AUTOVAC_LOG(DEBUG2,
+            "vac \"%s\": delta merge (delta tuples %ld threshold %d age %d)",
+            NameStr(classForm->relname),
+            delta_entry->n_live_tuples,
+            merge_thresh,
+            merge_age);
+    }
+
+    return need_merge;
+}
+
+/*
+ * relation_needs_recluster
+ *
+ * Check whether a column table with partial cluster key is to be re-clustered,
+ * that is it has been changed since its last vacuum, which is at least
+ * autovacuum_recluster_age seconds ago. Tables with indexes and the partitions
+ * of partitioned table are re-clustered by VACUUM FULL or manual vacuum.
+ */
+static bool relation_needs_recluster(Form_pg_class classForm, HeapTuple tuple, PgStat_StatTabEntry* tabentry)
+{
+    int recluster_age = u_sess->attr.attr_storage.autovacuum_recluster_age;
+    TimestampTz last_vacuum = 0;
+    bytea* relopts = NULL;
+    bool is_colstore = false;
+    bool need_recluster = false;
+
+    if (!DO_VACUUM || recluster_age < 0 || u_sess->attr.attr_storage.cstore_recluster_cus <= 0)
+        return false;
+
+    if (RELKIND_RELATION != classForm->relkind || isPartitionedRelation(classForm) ||
+        !classForm->relhasclusterkey || classForm->relhasindex || tabentry == NULL)
+        return false;
+
+    relopts = extractRelOptions(tuple, GetDefaultPgClassDesc(), InvalidOid);
+    is_colstore = (relopts != NULL && StdRelOptIsColStore(relopts));
+    if (relopts != NULL)
+        pfree_ext(relopts);
+    if (!is_colstore)
+        return false;
+
+    last_vacuum = Max(tabentry->vacuum_timestamp, tabentry->autovac_vacuum_timestamp);
+    need_recluster = (tabentry->data_changed_timestamp > last_vacuum &&
+                      (last_vacuum == 0 ||
+                          TimestampDifferenceExceeds(last_vacuum, GetCurrentTimestamp(), recluster_age * 1000)));
+
+    if (need_recluster) {
+        AUTOVAC_LOG(DEBUG2, "vac \"%s\": recluster (age %d)", NameStr(classForm->relname), recluster_age);
+    }
+
+    return need_recluster;
+}
+
 /*
  * fill_in_vac_stmt
  *
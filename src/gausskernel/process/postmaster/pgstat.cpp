@@ -8976,7 +8976,8 @@ TableDistributionInfo* get_remote_stat_redo(TupleDesc tuple_desc)
         "write_data_io_counter, write_data_io_total_dur, "
         "process_pending_counter, process_pending_total_dur, "
         "apply_counter, apply_total_dur, "
-        "speed, local_max_ptr, primary_flush_ptr, worker_info "
+        "speed, local_max_ptr, primary_flush_ptr, worker_info, "
+        "prefetch_issued, prefetch_hit, prefetch_skip "
         "FROM local_redo_stat();");
 
     /* send sql and parallel fetch distribution info from all data nodes */
@@ -172,6 +172,9 @@ static void knl_g_parallel_redo_init(knl_g_parallel_redo_context* predo_cxt)
     predo_cxt->redoPf.recovery_done_ptr = 0;
     predo_cxt->redoPf.speed_according_seg = 0;
     predo_cxt->redoPf.local_max_lsn = 0;
+    predo_cxt->redoPf.prefetch_issued = 0;
+    predo_cxt->redoPf.prefetch_hit = 0;
+    predo_cxt->redoPf.prefetch_skip = 0;
     knl_g_set_is_local_redo_finish(false);
     predo_cxt->redoType = DEFAULT_REDO;
 }
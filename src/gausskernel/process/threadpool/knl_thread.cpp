@@ -117,6 +117,7 @@ static void knl_t_codegen_init(knl_t_codegen_context* codegen_cxt)
     codegen_cxt->thr_codegen_obj = NULL;
     codegen_cxt->g_runningInFmgr = false;
     codegen_cxt->codegen_IRload_thr_count = 0;
+    codegen_cxt->thr_codegen_cache = NULL;
 }
 
 static void knl_t_format_init(knl_t_format_context* format_cxt)
@@ -661,6 +662,13 @@ static void knl_t_basebackup_init(knl_t_basebackup_context* basebackup_cxt)
     int rc = memset_s(basebackup_cxt->g_xlog_location, MAXPGPATH, 0, MAXPGPATH);
     securec_check(rc, "\0", "\0");
     basebackup_cxt->buf_block = NULL;
+    basebackup_cxt->incremental_block_tab = NULL;
+    basebackup_cxt->stream_id = 0;
+    basebackup_cxt->nstreams = 1;
+    basebackup_cxt->parallel_backup_id = 0;
+    basebackup_cxt->compress = false;
+    basebackup_cxt->compress_buf = NULL;
+    basebackup_cxt->compress_buf_size = 0;
 }
 
 static void knl_t_datarcvwriter_init(knl_t_datarcvwriter_context* datarcvwriter_cxt)
@@ -700,6 +708,8 @@ static void knl_t_datareceiver_init(knl_t_datareceiver_context* datareceiver_cxt
     datareceiver_cxt->dataStreamingConn = NULL;
     datareceiver_cxt->AmDataReceiverForDummyStandby = false;
     datareceiver_cxt->recvBuf = NULL;
+    datareceiver_cxt->decompress_buf = NULL;
+    datareceiver_cxt->decompress_buf_size = 0;
     datareceiver_cxt->DataRcv = NULL;
     datareceiver_cxt->DataRcvImmediateInterruptOK = false;
 }
@@ -711,6 +721,8 @@ static void knl_t_datasender_init(knl_t_datasender_context* datasender_cxt)
     datasender_cxt->am_datasender = false;
     datasender_cxt->reply_message = (StringInfoData*)palloc0(sizeof(StringInfoData));
     datasender_cxt->output_message = NULL;
+    datasender_cxt->compression = 0;
+    datasender_cxt->compress_message = NULL;
     datasender_cxt->dummy_data_read_file_num = 1;
     datasender_cxt->dummy_data_read_file_fd = NULL;
     datasender_cxt->ping_sent = false;
@@ -1112,6 +1124,8 @@ static void knl_t_walreceiver_init(knl_t_walreceiver_context* walreceiver_cxt)
     walreceiver_cxt->AmWalReceiverForFailover = false;
     walreceiver_cxt->AmWalReceiverForStandby = false;
     walreceiver_cxt->control_file_writed = 0;
+    walreceiver_cxt->decompress_buf = NULL;
+    walreceiver_cxt->decompress_buf_size = 0;
 }
 
 static void knl_t_storage_init(knl_t_storage_context* storage_cxt)
@@ -1273,6 +1287,10 @@ static void knl_t_walsender_init(knl_t_walsender_context* walsender_cxt)
     walsender_cxt->sentPtr = 0;
     walsender_cxt->catchup_threshold = 0;
     walsender_cxt->output_xlog_msg_prefix_len = 0;
+    walsender_cxt->compression = 0;
+    walsender_cxt->compress_xlog_message = NULL;
+    walsender_cxt->throughput_time = 0;
+    walsender_cxt->throughput_bytes = 0;
     walsender_cxt->output_data_msg_cur_len = 0;
     walsender_cxt->output_data_msg_start_xlog = InvalidXLogRecPtr;
     walsender_cxt->output_data_msg_end_xlog = InvalidXLogRecPtr;
@@ -0,0 +1,977 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * rowcodegen.cpp
+ *     codegeneration of qual, target list and tuple deforming for the
+ *     row executor
+ *
+ * The generated functions never reference anything living in the plan or
+ * in the executor state: Vars are fetched through the slots hanging on the
+ * ExprContext, Consts are folded into the IR and the C functions are bound
+ * by symbol name. So the machine code only depends on the expressions (or
+ * the tuple descriptor) it was generated from, and is put into the
+ * thread-level module cache to be reused by the following executions.
+ *
+ * IDENTIFICATION
+ *     Code/src/gausskernel/runtime/codegen/executor/rowcodegen.cpp
+ *
+ * -----------------------------------------------------------------------
+ */
+#include "codegen/gscodegen.h"
+#include "codegen/rowcodegen.h"
+
+#include "access/htup.h"
+#include "access/tupmacs.h"
+#include "executor/tuptable.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/planmain.h"
+#include "utils/fmgroids.h"
+
+using namespace llvm;
+using namespace dorado;
+
+/* Kinds of integer arithmetic supported by row codegen */
+#define ROW_ARITH_ADD 0
+#define ROW_ARITH_SUB 1
+#define ROW_ARITH_MUL 2
+
+/*
+ * A codegened expression value. 'value' is an i64 holding the sign-extended
+ * integer for int2/int4/int8 expressions and an i1 for boolean expressions.
+ */
+typedef struct RowExprValue {
+    llvm::Value* value;
+    llvm::Value* isnull;
+} RowExprValue;
+
+static void WrapRowIntOverflow(int64 typeoid);
+static int64 WrapRowVarSizeExternal(char* ptr);
+static void WrapRowGetSomeAttrs(TupleTableSlot* slot, int64 attnum);
+
+/*
+ * Check whether the operator function is an integer comparison we could
+ * codegen, and return the corresponding llvm predicate if so.
+ */
+static bool GetIntCmpPredicate(Oid funcid, llvm::CmpInst::Predicate* pred)
+{
+    switch (funcid) {
+        case F_INT2EQ:
+        case F_INT4EQ:
+        case F_INT8EQ:
+        case F_INT24EQ:
+        case F_INT42EQ:
+        case F_INT28EQ:
+        case F_INT82EQ:
+        case F_INT48EQ:
+        case F_INT84EQ:
+            *pred = llvm::CmpInst::ICMP_EQ;
+            return true;
+        case F_INT2NE:
+        case F_INT4NE:
+        case F_INT8NE:
+        case F_INT24NE:
+        case F_INT42NE:
+        case F_INT28NE:
+        case F_INT82NE:
+        case F_INT48NE:
+        case F_INT84NE:
+            *pred = llvm::CmpInst::ICMP_NE;
+            return true;
+        case F_INT2LT:
+        case F_INT4LT:
+        case F_INT8LT:
+        case F_INT24LT:
+        case F_INT42LT:
+        case F_INT28LT:
+        case F_INT82LT:
+        case F_INT48LT:
+        case F_INT84LT:
+            *pred = llvm::CmpInst::ICMP_SLT;
+            return true;
+        case F_INT2LE:
+        case F_INT4LE:
+        case F_INT8LE:
+        case F_INT24LE:
+        case F_INT42LE:
+        case F_INT28LE:
+        case F_INT82LE:
+        case F_INT48LE:
+        case F_INT84LE:
+            *pred = llvm::CmpInst::ICMP_SLE;
+            return true;
+        case F_INT2GT:
+        case F_INT4GT:
+        case F_INT8GT:
+        case F_INT24GT:
+        case F_INT42GT:
+        case F_INT28GT:
+        case F_INT82GT:
+        case F_INT48GT:
+        case F_INT84GT:
+            *pred = llvm::CmpInst::ICMP_SGT;
+            return true;
+        case F_INT2GE:
+        case F_INT4GE:
+        case F_INT8GE:
+        case F_INT24GE:
+        case F_INT42GE:
+        case F_INT28GE:
+        case F_INT82GE:
+        case F_INT48GE:
+        case F_INT84GE:
+            *pred = llvm::CmpInst::ICMP_SGE;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Check whether the operator function is a same-type integer arithmetic we
+ * could codegen, and return the kind of arithmetic and the data type if so.
+ */
+static bool GetIntArithOp(Oid funcid, int* op, Oid* typeoid)
+{
+    switch (funcid) {
+        case F_INT2PL:
+            *op = ROW_ARITH_ADD;
+            *typeoid = INT2OID;
+            return true;
+        case F_INT4PL:
+            *op = ROW_ARITH_ADD;
+            *typeoid = INT4OID;
+            return true;
+        case F_INT8PL:
+            *op = ROW_ARITH_ADD;
+            *typeoid = INT8OID;
+            return true;
+        case F_INT2MI:
+            *op = ROW_ARITH_SUB;
+            *typeoid = INT2OID;
+            return true;
+        case F_INT4MI:
+            *op = ROW_ARITH_SUB;
+            *typeoid = INT4OID;
+            return true;
+        case F_INT8MI:
+            *op = ROW_ARITH_SUB;
+            *typeoid = INT8OID;
+            return true;
+        case F_INT2MUL:
+            *op = ROW_ARITH_MUL;
+            *typeoid = INT2OID;
+            return true;
+        case F_INT4MUL:
+            *op = ROW_ARITH_MUL;
+            *typeoid = INT4OID;
+            return true;
+        case F_INT8MUL:
+            *op = ROW_ARITH_MUL;
+            *typeoid = INT8OID;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline bool IsRowCodeGenIntType(Oid typeoid)
+{
+    return typeoid == INT2OID || typeoid == INT4OID || typeoid == INT8OID;
+}
+
+/*
+ * Get the C function 'name' declared in the current module, the symbol is
+ * bound to 'addr' so that MCJIT could resolve it.
+ */
+static llvm::Function* GetRowHelperFunction(GsCodeGen* llvmCodeGen, const char* name, llvm::Type* retType,
+    llvm::Type* arg1Type, llvm::Type* arg2Type, void* addr)
+{
+    llvm::Function* func = llvmCodeGen->module()->getFunction(name);
+    if (func == NULL) {
+        GsCodeGen::FnPrototype fn_prototype(llvmCodeGen, name, retType);
+        fn_prototype.addArgument(GsCodeGen::NamedVariable("arg1", arg1Type));
+        if (arg2Type != NULL) {
+            fn_prototype.addArgument(GsCodeGen::NamedVariable("arg2", arg2Type));
+        }
+        func = fn_prototype.generatePrototype(NULL, NULL);
+        llvm::sys::DynamicLibrary::AddSymbol(name, addr);
+    }
+    return func;
+}
+
+/*
+ * Load a member of type 'type' at byte offset 'offset' of the struct pointed
+ * by 'base' (an i8*).
+ */
+static llvm::Value* LoadMember(GsCodeGen::LlvmBuilder* builder, llvm::Value* base, size_t offset, llvm::Type* type)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::Value* ptr = builder->CreateInBoundsGEP(
+        llvmCodeGen->getType(CHAROID), base, llvmCodeGen->getIntConstant(INT8OID, offset));
+    ptr = builder->CreateBitCast(ptr, llvmCodeGen->getPtrType(type));
+    return builder->CreateLoad(type, ptr);
+}
+
+static void StoreMember(
+    GsCodeGen::LlvmBuilder* builder, llvm::Value* base, size_t offset, llvm::Type* type, llvm::Value* value)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::Value* ptr = builder->CreateInBoundsGEP(
+        llvmCodeGen->getType(CHAROID), base, llvmCodeGen->getIntConstant(INT8OID, offset));
+    ptr = builder->CreateBitCast(ptr, llvmCodeGen->getPtrType(type));
+    builder->CreateStore(value, ptr);
+}
+
+/*
+ * Truncate the sign-extended i64 to the width of 'typeoid' and zero extend it
+ * back, which gives the same Datum as Int16GetDatum/Int32GetDatum.
+ */
+static llvm::Value* IntValueToDatum(GsCodeGen::LlvmBuilder* builder, llvm::Value* value, Oid typeoid)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    DEFINE_CG_TYPE(int64Type, INT8OID);
+
+    if (typeoid == INT8OID) {
+        return value;
+    }
+    return builder->CreateZExt(builder->CreateTrunc(value, llvmCodeGen->getType(typeoid)), int64Type);
+}
+
+static llvm::Value* DatumToIntValue(GsCodeGen::LlvmBuilder* builder, llvm::Value* datum, Oid typeoid)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    DEFINE_CG_TYPE(int64Type, INT8OID);
+
+    if (typeoid == INT8OID) {
+        return datum;
+    }
+    return builder->CreateSExt(builder->CreateTrunc(datum, llvmCodeGen->getType(typeoid)), int64Type);
+}
+
+/*
+ * Generate IR to fetch the attribute of a Var from its slot, the same as
+ * ExecEvalScalarVar does. The datum is returned untouched.
+ */
+static RowExprValue VarCodeGen(GsCodeGen::LlvmBuilder* builder, llvm::Value* econtext, Var* var)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::LLVMContext& context = llvmCodeGen->context();
+    llvm::Function* jitted_func = builder->GetInsertBlock()->getParent();
+    RowExprValue result;
+    size_t slotoff;
+
+    DEFINE_CG_VOIDTYPE(voidType);
+    DEFINE_CG_TYPE(int8Type, CHAROID);
+    DEFINE_CG_TYPE(int32Type, INT4OID);
+    DEFINE_CG_TYPE(int64Type, INT8OID);
+    DEFINE_CG_PTRTYPE(int8PtrType, CHAROID);
+    DEFINE_CGVAR_INT8(int8_0, 0);
+
+    switch (var->varno) {
+        case INNER_VAR:
+            slotoff = offsetof(ExprContext, ecxt_innertuple);
+            break;
+        case OUTER_VAR:
+            slotoff = offsetof(ExprContext, ecxt_outertuple);
+            break;
+        default:
+            slotoff = offsetof(ExprContext, ecxt_scantuple);
+            break;
+    }
+
+    llvm::Value* slot = LoadMember(builder, econtext, slotoff, int8PtrType);
+    llvm::Value* nvalid = LoadMember(builder, slot, offsetof(TupleTableSlot, tts_nvalid), int32Type);
+    llvm::Value* attno = llvmCodeGen->getIntConstant(INT4OID, var->varattno);
+
+    /* Make sure the attribute has been extracted, see slot_getattr */
+    DEFINE_BLOCK(var_deform, jitted_func);
+    DEFINE_BLOCK(var_fetch, jitted_func);
+    llvm::Value* cmp = builder->CreateICmpSLT(nvalid, attno);
+    builder->CreateCondBr(cmp, var_deform, var_fetch);
+
+    builder->SetInsertPoint(var_deform);
+    llvm::Function* func_getattrs = GetRowHelperFunction(
+        llvmCodeGen, "Jitted_row_getsomeattrs", voidType, int8PtrType, int64Type, (void*)WrapRowGetSomeAttrs);
+    builder->CreateCall(func_getattrs, {slot, llvmCodeGen->getIntConstant(INT8OID, var->varattno)});
+    builder->CreateBr(var_fetch);
+
+    builder->SetInsertPoint(var_fetch);
+    llvm::Value* values = LoadMember(builder, slot, offsetof(TupleTableSlot, tts_values), int8PtrType);
+    llvm::Value* isnull = LoadMember(builder, slot, offsetof(TupleTableSlot, tts_isnull), int8PtrType);
+    result.value = LoadMember(builder, values, sizeof(Datum) * (var->varattno - 1), int64Type);
+    llvm::Value* nullflag = LoadMember(builder, isnull, sizeof(bool) * (var->varattno - 1), int8Type);
+    result.isnull = builder->CreateICmpNE(nullflag, int8_0);
+
+    return result;
+}
+
+/*
+ * Generate IR for an integer expression, the value returned is always
+ * sign-extended to i64 whatever the data type of the expression is.
+ */
+static RowExprValue IntExprCodeGen(GsCodeGen::LlvmBuilder* builder, llvm::Value* econtext, Expr* expr)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::LLVMContext& context = llvmCodeGen->context();
+    RowExprValue result;
+
+    switch (nodeTag(expr)) {
+        case T_Var: {
+            Var* var = (Var*)expr;
+            result = VarCodeGen(builder, econtext, var);
+            result.value = DatumToIntValue(builder, result.value, var->vartype);
+            break;
+        }
+        case T_Const: {
+            Const* c = (Const*)expr;
+            int64 value = 0;
+
+            if (!c->constisnull) {
+                switch (c->consttype) {
+                    case INT8OID:
+                        value = DatumGetInt64(c->constvalue);
+                        break;
+                    case INT4OID:
+                        value = DatumGetInt32(c->constvalue);
+                        break;
+                    default:
+                        value = DatumGetInt16(c->constvalue);
+                        break;
+                }
+            }
+            result.value = llvmCodeGen->getIntConstant(INT8OID, value);
+            result.isnull = llvmCodeGen->getIntConstant(BITOID, c->constisnull ? 1 : 0);
+            break;
+        }
+        case T_OpExpr: {
+            OpExpr* op = (OpExpr*)expr;
+            llvm::Function* jitted_func = builder->GetInsertBlock()->getParent();
+            llvm::Intrinsic::ID intrinsic;
+            int arith = 0;
+            Oid typeoid = InvalidOid;
+
+            (void)GetIntArithOp(op->opfuncid, &arith, &typeoid);
+            switch (arith) {
+                case ROW_ARITH_ADD:
+                    intrinsic = llvm::Intrinsic::sadd_with_overflow;
+                    break;
+                case ROW_ARITH_SUB:
+                    intrinsic = llvm::Intrinsic::ssub_with_overflow;
+                    break;
+                default:
+                    intrinsic = llvm::Intrinsic::smul_with_overflow;
+                    break;
+            }
+
+            RowExprValue lhs = IntExprCodeGen(builder, econtext, (Expr*)linitial(op->args));
+            RowExprValue rhs = IntExprCodeGen(builder, econtext, (Expr*)lsecond(op->args));
+
+            /* Operators are strict, do the arithmetic in the width of the data type */
+            llvm::Type* intType = llvmCodeGen->getType(typeoid);
+            llvm::Type* Intrinsic_Tys[] = {intType};
+            llvm::Function* func_overflow =
+                llvm::Intrinsic::getDeclaration(llvmCodeGen->module(), intrinsic, Intrinsic_Tys);
+            if (func_overflow == NULL) {
+                ereport(ERROR,
+                    (errcode(ERRCODE_LOAD_INTRINSIC_FUNCTION_FAILED),
+                        errmodule(MOD_LLVM),
+                        errmsg("Cannot get the llvm::Intrinsic arith_with_overflow function!\n")));
+            }
+
+            llvm::Value* lval = builder->CreateTrunc(lhs.value, intType);
+            llvm::Value* rval = builder->CreateTrunc(rhs.value, intType);
+            llvm::Value* res = builder->CreateCall(func_overflow, {lval, rval});
+            result.isnull = builder->CreateOr(lhs.isnull, rhs.isnull);
+
+            /* The result of null input is never computed, so ignore the overflow flag then */
+            DEFINE_BLOCK(arith_overflow, jitted_func);
+            DEFINE_BLOCK(arith_normal, jitted_func);
+            llvm::Value* overflow = builder->CreateExtractValue(res, 1);
+            overflow = builder->CreateAnd(overflow, builder->CreateNot(result.isnull));
+            builder->CreateCondBr(overflow, arith_overflow, arith_normal);
+
+            builder->SetInsertPoint(arith_overflow);
+            DEFINE_CG_VOIDTYPE(voidType);
+            DEFINE_CG_TYPE(int64Type, INT8OID);
+            llvm::Function* func_error = GetRowHelperFunction(
+                llvmCodeGen, "Jitted_row_intoverflow", voidType, int64Type, NULL, (void*)WrapRowIntOverflow);
+            builder->CreateCall(func_error, llvmCodeGen->getIntConstant(INT8OID, typeoid));
+            builder->CreateUnreachable();
+
+            builder->SetInsertPoint(arith_normal);
+            result.value = builder->CreateSExt(builder->CreateExtractValue(res, 0), int64Type);
+            break;
+        }
+        default: {
+            ereport(ERROR,
+                (errcode(ERRCODE_CODEGEN_ERROR),
+                    errmodule(MOD_LLVM),
+                    errmsg("Unsupported expression type %d in row codegen.", (int)nodeTag(expr))));
+            break;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Generate IR for a boolean clause, the value returned is an i1.
+ */
+static RowExprValue ClauseCodeGen(GsCodeGen::LlvmBuilder* builder, llvm::Value* econtext, Expr* clause)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    RowExprValue result;
+
+    if (IsA(clause, NullTest)) {
+        NullTest* ntest = (NullTest*)clause;
+        RowExprValue arg;
+
+        if (IsA(ntest->arg, Var)) {
+            arg = VarCodeGen(builder, econtext, (Var*)ntest->arg);
+        } else {
+            arg = IntExprCodeGen(builder, econtext, ntest->arg);
+        }
+
+        result.value = (ntest->nulltesttype == IS_NULL) ? arg.isnull : builder->CreateNot(arg.isnull);
+        result.isnull = llvmCodeGen->getIntConstant(BITOID, 0);
+    } else {
+        OpExpr* op = (OpExpr*)clause;
+        llvm::CmpInst::Predicate pred = llvm::CmpInst::ICMP_EQ;
+
+        (void)GetIntCmpPredicate(op->opfuncid, &pred);
+        RowExprValue lhs = IntExprCodeGen(builder, econtext, (Expr*)linitial(op->args));
+        RowExprValue rhs = IntExprCodeGen(builder, econtext, (Expr*)lsecond(op->args));
+
+        result.value = builder->CreateICmp(pred, lhs.value, rhs.value);
+        result.isnull = builder->CreateOr(lhs.isnull, rhs.isnull);
+    }
+
+    return result;
+}
+
+namespace dorado {
+bool RowExprCodeGen::IntExprJittable(Expr* expr)
+{
+    if (expr == NULL) {
+        return false;
+    }
+
+    switch (nodeTag(expr)) {
+        case T_Var: {
+            Var* var = (Var*)expr;
+
+            /* System attributes and whole-row Vars are not supported */
+            return var->varattno > 0 && IsRowCodeGenIntType(var->vartype);
+        }
+        case T_Const: {
+            Const* c = (Const*)expr;
+            return c->constbyval && IsRowCodeGenIntType(c->consttype);
+        }
+        case T_OpExpr: {
+            OpExpr* op = (OpExpr*)expr;
+            int arith = 0;
+            Oid typeoid = InvalidOid;
+
+            set_opfuncid(op);
+            if (!GetIntArithOp(op->opfuncid, &arith, &typeoid) || op->opretset || list_length(op->args) != 2) {
+                return false;
+            }
+            return IntExprJittable((Expr*)linitial(op->args)) && IntExprJittable((Expr*)lsecond(op->args));
+        }
+        default:
+            return false;
+    }
+}
+
+bool RowExprCodeGen::ClauseJittable(Expr* clause)
+{
+    if (clause == NULL) {
+        return false;
+    }
+
+    if (IsA(clause, NullTest)) {
+        NullTest* ntest = (NullTest*)clause;
+
+        if (ntest->argisrow) {
+            return false;
+        }
+        if (IsA(ntest->arg, Var)) {
+            return ((Var*)ntest->arg)->varattno > 0;
+        }
+        return IntExprJittable(ntest->arg);
+    }
+
+    if (IsA(clause, OpExpr)) {
+        OpExpr* op = (OpExpr*)clause;
+        llvm::CmpInst::Predicate pred;
+
+        set_opfuncid(op);
+        if (!GetIntCmpPredicate(op->opfuncid, &pred) || op->opretset || list_length(op->args) != 2) {
+            return false;
+        }
+        return IntExprJittable((Expr*)linitial(op->args)) && IntExprJittable((Expr*)lsecond(op->args));
+    }
+
+    return false;
+}
+
+bool RowExprCodeGen::QualJittable(List* qual)
+{
+    ListCell* lc = NULL;
+
+    if (qual == NIL) {
+        return false;
+    }
+
+    foreach (lc, qual) {
+        if (!ClauseJittable((Expr*)lfirst(lc))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+llvm::Function* RowExprCodeGen::QualCodeGen(List* qual)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::LLVMContext& context = llvmCodeGen->context();
+    GsCodeGen::LlvmBuilder builder(context);
+    llvm::Value* llvmargs[1];
+    ListCell* lc = NULL;
+
+    DEFINE_CG_TYPE(int8Type, CHAROID);
+    DEFINE_CG_PTRTYPE(int8PtrType, CHAROID);
+    DEFINE_CGVAR_INT8(int8_0, 0);
+    DEFINE_CGVAR_INT8(int8_1, 1);
+
+    GsCodeGen::FnPrototype fn_prototype(llvmCodeGen, "JittedRowQual", int8Type);
+    fn_prototype.addArgument(GsCodeGen::NamedVariable("econtext", int8PtrType));
+    llvm::Function* jitted_rowqual = fn_prototype.generatePrototype(&builder, &llvmargs[0]);
+    llvm::Value* econtext = llvmargs[0];
+
+    DEFINE_BLOCK(ret_false, jitted_rowqual);
+
+    /*
+     * Evaluate the clauses in order and stop at the first one which is not
+     * true, so that runtime errors are raised the same as ExecQual.
+     */
+    foreach (lc, qual) {
+        RowExprValue res = ClauseCodeGen(&builder, econtext, (Expr*)lfirst(lc));
+        llvm::Value* pass = builder.CreateAnd(res.value, builder.CreateNot(res.isnull));
+
+        DEFINE_BLOCK(next_clause, jitted_rowqual);
+        builder.CreateCondBr(pass, next_clause, ret_false);
+        builder.SetInsertPoint(next_clause);
+    }
+    builder.CreateRet(int8_1);
+
+    builder.SetInsertPoint(ret_false);
+    builder.CreateRet(int8_0);
+
+    llvmCodeGen->FinalizeFunction(jitted_rowqual);
+    return jitted_rowqual;
+}
+
+bool RowExprCodeGen::TargetListJittable(List* targetlist)
+{
+    ListCell* lc = NULL;
+
+    if (targetlist == NIL) {
+        return false;
+    }
+
+    foreach (lc, targetlist) {
+        GenericExprState* gstate = (GenericExprState*)lfirst(lc);
+        TargetEntry* tle = (TargetEntry*)gstate->xprstate.expr;
+
+        if (!IntExprJittable(tle->expr) && !ClauseJittable(tle->expr)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+llvm::Function* RowExprCodeGen::TargetListCodeGen(List* targetlist)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::LLVMContext& context = llvmCodeGen->context();
+    GsCodeGen::LlvmBuilder builder(context);
+    llvm::Value* llvmargs[3];
+    ListCell* lc = NULL;
+
+    DEFINE_CG_VOIDTYPE(voidType);
+    DEFINE_CG_TYPE(int8Type, CHAROID);
+    DEFINE_CG_TYPE(int64Type, INT8OID);
+    DEFINE_CG_PTRTYPE(int8PtrType, CHAROID);
+    DEFINE_CGVAR_INT64(Datum_0, 0);
+
+    GsCodeGen::FnPrototype fn_prototype(llvmCodeGen, "JittedRowTarget", voidType);
+    fn_prototype.addArgument(GsCodeGen::NamedVariable("econtext", int8PtrType));
+    fn_prototype.addArgument(GsCodeGen::NamedVariable("values", int8PtrType));
+    fn_prototype.addArgument(GsCodeGen::NamedVariable("isnull", int8PtrType));
+    llvm::Function* jitted_rowtarget = fn_prototype.generatePrototype(&builder, &llvmargs[0]);
+    llvm::Value* econtext = llvmargs[0];
+    llvm::Value* values = llvmargs[1];
+    llvm::Value* isnull = llvmargs[2];
+
+    foreach (lc, targetlist) {
+        GenericExprState* gstate = (GenericExprState*)lfirst(lc);
+        TargetEntry* tle = (TargetEntry*)gstate->xprstate.expr;
+        AttrNumber resind = tle->resno - 1;
+        RowExprValue res;
+        llvm::Value* datum = NULL;
+
+        if (IntExprJittable(tle->expr)) {
+            res = IntExprCodeGen(&builder, econtext, tle->expr);
+            datum = IntValueToDatum(&builder, res.value, exprType((Node*)tle->expr));
+        } else {
+            res = ClauseCodeGen(&builder, econtext, tle->expr);
+            datum = builder.CreateZExt(res.value, int64Type);
+        }
+
+        datum = builder.CreateSelect(res.isnull, Datum_0, datum);
+        StoreMember(&builder, values, sizeof(Datum) * resind, int64Type, datum);
+        StoreMember(&builder, isnull, sizeof(bool) * resind, int8Type, builder.CreateZExt(res.isnull, int8Type));
+    }
+    builder.CreateRetVoid();
+
+    llvmCodeGen->FinalizeFunction(jitted_rowtarget);
+    return jitted_rowtarget;
+}
+
+bool RowExprCodeGen::DeformJittable(TupleDesc desc)
+{
+#ifdef WORDS_BIGENDIAN
+    return false;
+#else
+    if (desc == NULL || desc->natts <= 0) {
+        return false;
+    }
+
+    for (int i = 0; i < desc->natts; i++) {
+        Form_pg_attribute att = desc->attrs[i];
+
+        /* cstring is rarely stored in tuple, let slot_deform_tuple deal with it */
+        if (att->attlen == -2) {
+            return false;
+        }
+        if (att->attbyval && att->attlen != 1 && att->attlen != 2 && att->attlen != 4 && att->attlen != 8) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+/*
+ * The generated function is slot_deform_tuple unrolled over the attributes
+ * of 'desc'. As long as all the preceding attributes are fixed-length and
+ * NOT NULL, the offset of an attribute is known here and folded into the
+ * IR, after that it is computed at runtime in the same way as
+ * slot_deform_tuple does, except that attcacheoff is neither used nor set.
+ */
+llvm::Function* RowExprCodeGen::DeformCodeGen(TupleDesc desc)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    llvm::LLVMContext& context = llvmCodeGen->context();
+    GsCodeGen::LlvmBuilder builder(context);
+    llvm::Value* llvmargs[2];
+    long knownOff = 0;
+
+    DEFINE_CG_VOIDTYPE(voidType);
+    DEFINE_CG_TYPE(int8Type, CHAROID);
+    DEFINE_CG_TYPE(int16Type, INT2OID);
+    DEFINE_CG_TYPE(int32Type, INT4OID);
+    DEFINE_CG_TYPE(int64Type, INT8OID);
+    DEFINE_CG_PTRTYPE(int8PtrType, CHAROID);
+    DEFINE_CGVAR_INT8(int8_0, 0);
+    DEFINE_CGVAR_INT8(int8_1, 1);
+    DEFINE_CGVAR_INT64(Datum_0, 0);
+
+    GsCodeGen::FnPrototype fn_prototype(llvmCodeGen, "JittedRowDeform", voidType);
+    fn_prototype.addArgument(GsCodeGen::NamedVariable("slot", int8PtrType));
+    fn_prototype.addArgument(GsCodeGen::NamedVariable("natts", int32Type));
+    llvm::Function* jitted_deform = fn_prototype.generatePrototype(&builder, &llvmargs[0]);
+    llvm::Value* slot = llvmargs[0];
+    llvm::Value* natts = llvmargs[1];
+
+    llvm::BasicBlock* entry = &jitted_deform->getEntryBlock();
+    DEFINE_BLOCK(deform_end, jitted_deform);
+
+    llvm::Value* offPtr = builder.CreateAlloca(int64Type);
+    builder.CreateStore(Datum_0, offPtr);
+
+    llvm::Value* tuple = LoadMember(&builder, slot, offsetof(TupleTableSlot, tts_tuple), int8PtrType);
+    llvm::Value* tup = LoadMember(&builder, tuple, offsetof(HeapTupleData, t_data), int8PtrType);
+    llvm::Value* values = LoadMember(&builder, slot, offsetof(TupleTableSlot, tts_values), int8PtrType);
+    llvm::Value* isnull = LoadMember(&builder, slot, offsetof(TupleTableSlot, tts_isnull), int8PtrType);
+    llvm::Value* infomask = LoadMember(&builder, tup, offsetof(HeapTupleHeaderData, t_infomask), int16Type);
+    llvm::Value* hasnulls = builder.CreateICmpNE(
+        builder.CreateAnd(infomask, llvmCodeGen->getIntConstant(INT2OID, HEAP_HASNULL)),
+        llvmCodeGen->getIntConstant(INT2OID, 0));
+    llvm::Value* hoff = LoadMember(&builder, tup, offsetof(HeapTupleHeaderData, t_hoff), int8Type);
+    llvm::Value* tp = builder.CreateInBoundsGEP(int8Type, tup, builder.CreateZExt(hoff, int64Type));
+    llvm::Value* bp = builder.CreateInBoundsGEP(
+        int8Type, tup, llvmCodeGen->getIntConstant(INT8OID, offsetof(HeapTupleHeaderData, t_bits)));
+
+    /* nvalid of the slot when we stop deforming */
+    builder.SetInsertPoint(deform_end);
+    llvm::PHINode* nvalid = builder.CreatePHI(int32Type, desc->natts + 1);
+    builder.SetInsertPoint(entry);
+
+    for (int attnum = 0; attnum < desc->natts; attnum++) {
+        Form_pg_attribute thisatt = desc->attrs[attnum];
+        llvm::Value* off = NULL;
+        llvm::Value* value = NULL;
+
+        DEFINE_BLOCK(att_check, jitted_deform);
+        DEFINE_BLOCK(att_notnull, jitted_deform);
+        DEFINE_BLOCK(att_next, jitted_deform);
+        builder.CreateBr(att_check);
+
+        /* Stop if the caller does not need this attribute */
+        builder.SetInsertPoint(att_check);
+        llvm::Value* need = builder.CreateICmpSLT(llvmCodeGen->getIntConstant(INT4OID, attnum), natts);
+        if (thisatt->attnotnull) {
+            builder.CreateCondBr(need, att_notnull, deform_end);
+        } else {
+            DEFINE_BLOCK(att_nullcheck, jitted_deform);
+            DEFINE_BLOCK(att_isnull, jitted_deform);
+            builder.CreateCondBr(need, att_nullcheck, deform_end);
+
+            builder.SetInsertPoint(att_nullcheck);
+            llvm::Value* bits = LoadMember(&builder, bp, attnum >> 3, int8Type);
+            bits = builder.CreateAnd(bits, llvmCodeGen->getIntConstant(CHAROID, 1 << (attnum & 0x07)));
+            llvm::Value* attisnull = builder.CreateAnd(hasnulls, builder.CreateICmpEQ(bits, int8_0));
+            builder.CreateCondBr(attisnull, att_isnull, att_notnull);
+
+            builder.SetInsertPoint(att_isnull);
+            StoreMember(&builder, values, sizeof(Datum) * attnum, int64Type, Datum_0);
+            StoreMember(&builder, isnull, sizeof(bool) * attnum, int8Type, int8_1);
+            builder.CreateBr(att_next);
+        }
+        nvalid->addIncoming(llvmCodeGen->getIntConstant(INT4OID, attnum), att_check);
+
+        builder.SetInsertPoint(att_notnull);
+        StoreMember(&builder, isnull, sizeof(bool) * attnum, int8Type, int8_0);
+
+        /*
+         * Align the offset. A varlena at a known but unaligned offset may be
+         * either packed or padded, so it still needs the runtime check.
+         */
+        if (knownOff >= 0 &&
+            (thisatt->attlen > 0 || (uintptr_t)knownOff == att_align_nominal(knownOff, thisatt->attalign))) {
+            knownOff = att_align_nominal(knownOff, thisatt->attalign);
+            off = llvmCodeGen->getIntConstant(INT8OID, knownOff);
+        } else {
+            if (knownOff >= 0) {
+                off = llvmCodeGen->getIntConstant(INT8OID, knownOff);
+            } else {
+                off = builder.CreateLoad(int64Type, offPtr);
+            }
+            if (thisatt->attalign != 'c') {
+                int64 alignment = (thisatt->attalign == 'i') ? ALIGNOF_INT
+                                  : (thisatt->attalign == 'd') ? ALIGNOF_DOUBLE : ALIGNOF_SHORT;
+                llvm::Value* aligned = builder.CreateAnd(
+                    builder.CreateAdd(off, llvmCodeGen->getIntConstant(INT8OID, alignment - 1)),
+                    llvmCodeGen->getIntConstant(INT8OID, ~(alignment - 1)));
+
+                /* A varlena is not aligned if it begins with a non-pad byte, see att_align_pointer */
+                if (thisatt->attlen == -1) {
+                    llvm::Value* firstbyte =
+                        builder.CreateLoad(int8Type, builder.CreateInBoundsGEP(int8Type, tp, off));
+                    aligned = builder.CreateSelect(builder.CreateICmpNE(firstbyte, int8_0), off, aligned);
+                }
+                off = aligned;
+            }
+        }
+
+        /* Fetch the attribute, see fetch_att */
+        llvm::Value* attptr = builder.CreateInBoundsGEP(int8Type, tp, off);
+        if (thisatt->attbyval) {
+            llvm::Type* attType = (thisatt->attlen == 8) ? int64Type
+                                  : (thisatt->attlen == 4) ? int32Type : (thisatt->attlen == 2) ? int16Type : int8Type;
+            value = builder.CreateLoad(attType, builder.CreateBitCast(attptr, llvmCodeGen->getPtrType(attType)));
+            if (thisatt->attlen != 8) {
+                value = builder.CreateZExt(value, int64Type);
+            }
+        } else {
+            value = builder.CreatePtrToInt(attptr, int64Type);
+        }
+        StoreMember(&builder, values, sizeof(Datum) * attnum, int64Type, value);
+
+        /* Advance the offset, see att_addlength_pointer */
+        if (thisatt->attlen > 0) {
+            if (knownOff >= 0) {
+                knownOff += thisatt->attlen;
+            }
+            off = builder.CreateAdd(off, llvmCodeGen->getIntConstant(INT8OID, thisatt->attlen));
+        } else {
+            DEFINE_BLOCK(varsize_1b, jitted_deform);
+            DEFINE_BLOCK(varsize_4b, jitted_deform);
+            DEFINE_BLOCK(varsize_external, jitted_deform);
+            DEFINE_BLOCK(varsize_short, jitted_deform);
+            DEFINE_BLOCK(varsize_end, jitted_deform);
+
+            llvm::Value* header = builder.CreateLoad(int8Type, attptr);
+            llvm::Value* is1b = builder.CreateICmpEQ(builder.CreateAnd(header, int8_1), int8_1);
+            builder.CreateCondBr(is1b, varsize_1b, varsize_4b);
+
+            builder.SetInsertPoint(varsize_1b);
+            builder.CreateCondBr(builder.CreateICmpEQ(header, int8_1), varsize_external, varsize_short);
+
+            builder.SetInsertPoint(varsize_external);
+            llvm::Function* func_varsize = GetRowHelperFunction(
+                llvmCodeGen, "Jitted_row_varsize", int64Type, int8PtrType, NULL, (void*)WrapRowVarSizeExternal);
+            llvm::Value* size_external = builder.CreateCall(func_varsize, attptr);
+            builder.CreateBr(varsize_end);
+
+            builder.SetInsertPoint(varsize_short);
+            llvm::Value* size_short =
+                builder.CreateZExt(builder.CreateLShr(header, llvmCodeGen->getIntConstant(CHAROID, 1)), int64Type);
+            builder.CreateBr(varsize_end);
+
+            builder.SetInsertPoint(varsize_4b);
+            llvm::Value* header4b =
+                builder.CreateLoad(int32Type, builder.CreateBitCast(attptr, llvmCodeGen->getPtrType(int32Type)));
+            header4b = builder.CreateAnd(builder.CreateLShr(header4b, llvmCodeGen->getIntConstant(INT4OID, 2)),
+                llvmCodeGen->getIntConstant(INT4OID, 0x3FFFFFFF));
+            llvm::Value* size_4b = builder.CreateZExt(header4b, int64Type);
+            builder.CreateBr(varsize_end);
+
+            builder.SetInsertPoint(varsize_end);
+            llvm::PHINode* size = builder.CreatePHI(int64Type, 3);
+            size->addIncoming(size_external, varsize_external);
+            size->addIncoming(size_short, varsize_short);
+            size->addIncoming(size_4b, varsize_4b);
+            off = builder.CreateAdd(off, size);
+            knownOff = -1;
+        }
+        builder.CreateStore(off, offPtr);
+        builder.CreateBr(att_next);
+
+        builder.SetInsertPoint(att_next);
+        if (!thisatt->attnotnull) {
+            /* A null attribute shifts the offsets of all the following ones */
+            knownOff = -1;
+        }
+    }
+    builder.CreateBr(deform_end);
+    nvalid->addIncoming(llvmCodeGen->getIntConstant(INT4OID, desc->natts), builder.GetInsertBlock());
+
+    /* Save state for next execution, see slot_deform_tuple */
+    builder.SetInsertPoint(deform_end);
+    StoreMember(&builder, slot, offsetof(TupleTableSlot, tts_nvalid), int32Type, nvalid);
+    StoreMember(&builder, slot, offsetof(TupleTableSlot, tts_off), int64Type, builder.CreateLoad(int64Type, offPtr));
+    StoreMember(&builder, slot, offsetof(TupleTableSlot, tts_slow), int8Type, int8_1);
+    builder.CreateRetVoid();
+
+    llvmCodeGen->FinalizeFunction(jitted_deform);
+    return jitted_deform;
+}
+
+bool RowExprCodeGen::ScanCodeGen(ScanState* node)
+{
+    GsCodeGen* llvmCodeGen = (GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj;
+    Plan* plan = node->ps.plan;
+    ProjectionInfo* projInfo = node->ps.ps_ProjInfo;
+    TupleTableSlot* scanslot = node->ss_ScanTupleSlot;
+    StringInfoData signature;
+    llvm::Function* jitted_func = NULL;
+    ListCell* lc = NULL;
+    bool jitted = false;
+
+    initStringInfo(&signature);
+
+    if (QualJittable(plan->qual)) {
+        appendStringInfo(&signature, "rowqual:%s", nodeToString(plan->qual));
+        node->jitted_rowqual = (rowqual_func)GsCodeGen::lookupMCJitCache(signature.data);
+        if (node->jitted_rowqual == NULL) {
+            llvmCodeGen->loadIRFile();
+            jitted_func = QualCodeGen(plan->qual);
+            if (jitted_func != NULL) {
+                llvmCodeGen->addFunctionToMCJitCache(
+                    jitted_func, signature.data, reinterpret_cast<void**>(&(node->jitted_rowqual)));
+            }
+        }
+        jitted = jitted || node->jitted_rowqual != NULL || jitted_func != NULL;
+    }
+
+    if (projInfo != NULL && TargetListJittable(projInfo->pi_targetlist)) {
+        resetStringInfo(&signature);
+        appendStringInfoString(&signature, "rowtarget:");
+        foreach (lc, projInfo->pi_targetlist) {
+            TargetEntry* tle = (TargetEntry*)((GenericExprState*)lfirst(lc))->xprstate.expr;
+            appendStringInfo(&signature, "%d:%s;", tle->resno, nodeToString(tle->expr));
+        }
+        projInfo->jitted_rowtarget = (rowtarget_func)GsCodeGen::lookupMCJitCache(signature.data);
+        if (projInfo->jitted_rowtarget == NULL) {
+            llvmCodeGen->loadIRFile();
+            jitted_func = TargetListCodeGen(projInfo->pi_targetlist);
+            if (jitted_func != NULL) {
+                llvmCodeGen->addFunctionToMCJitCache(
+                    jitted_func, signature.data, reinterpret_cast<void**>(&(projInfo->jitted_rowtarget)));
+            }
+        }
+        jitted = jitted || projInfo->jitted_rowtarget != NULL || jitted_func != NULL;
+    }
+
+    if (scanslot != NULL && DeformJittable(scanslot->tts_tupleDescriptor)) {
+        TupleDesc desc = scanslot->tts_tupleDescriptor;
+
+        resetStringInfo(&signature);
+        appendStringInfoString(&signature, "rowdeform:");
+        for (int i = 0; i < desc->natts; i++) {
+            Form_pg_attribute att = desc->attrs[i];
+            appendStringInfo(&signature, "%d/%d/%c/%d;", att->attlen, att->attbyval, att->attalign, att->attnotnull);
+        }
+        scanslot->tts_jitted_deform =
+            (void (*)(TupleTableSlot*, int))GsCodeGen::lookupMCJitCache(signature.data);
+        if (scanslot->tts_jitted_deform == NULL) {
+            llvmCodeGen->loadIRFile();
+            jitted_func = DeformCodeGen(desc);
+            if (jitted_func != NULL) {
+                llvmCodeGen->addFunctionToMCJitCache(
+                    jitted_func, signature.data, reinterpret_cast<void**>(&(scanslot->tts_jitted_deform)));
+            }
+        }
+        jitted = jitted || scanslot->tts_jitted_deform != NULL || jitted_func != NULL;
+    }
+
+    pfree_ext(signature.data);
+    return jitted;
+}
+}  // namespace dorado
+
+static void WrapRowIntOverflow(int64 typeoid)
+{
+    ereport(ERROR,
+        (errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+            errmsg("%s out of range",
+                (typeoid == INT2OID) ? "smallint" : ((typeoid == INT4OID) ? "integer" : "bigint"))));
+}
+
+static int64 WrapRowVarSizeExternal(char* ptr)
+{
+    return (int64)VARSIZE_EXTERNAL(ptr);
+}
+
+static void WrapRowGetSomeAttrs(TupleTableSlot* slot, int64 attnum)
+{
+    slot_getsomeattrs(slot, (int)attnum);
+}
@@ -50,6 +50,7 @@
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 
+#include "access/hash.h"
 #include "pgxc/pgxc.h"
 #include "utils/memutils.h"
 #include "utils/resowner.h"
@@ -83,6 +84,175 @@ void llvm_stop_multithreaded()
 extern void lock_codegen_process_sub(int count);
 extern void lock_codegen_process_add();
 
+/*
+ * Thread-level cache of compiled modules.
+ *
+ * When a query registers IR functions through addFunctionToMCJitCache, the
+ * execution engine (which owns the module) and the LLVM context are not
+ * released at the end of the query but moved into this cache, and the
+ * registered functions are indexed by their signatures. A module is released
+ * only when all of its cached functions have been evicted.
+ *
+ * A plan holds the machine code pointers until its portal goes away, which
+ * for cursors may be long after the query that created or looked them up.
+ * So every use of a cached function is pinned to the resource owner current
+ * at executor startup (the portal's), and pinned functions are never evicted.
+ * The pins are dropped when that resource owner is released.
+ */
+typedef struct CodeGenCachedModule {
+    llvm::ExecutionEngine* engine;
+    llvm::LLVMContext* context;
+    int refcount; /* number of cached functions living in this module */
+} CodeGenCachedModule;
+
+typedef struct CodeGenCachedFunction {
+    uint32 hashvalue;
+    char* signature;
+    void* function;
+    CodeGenCachedModule* module;
+    uint64 lastused; /* generation of the last query using this function */
+    int pincount;    /* number of live plans holding this function */
+} CodeGenCachedFunction;
+
+typedef struct CodeGenFunctionPin {
+    CodeGenCachedFunction* entry;
+    ResourceOwner owner;
+} CodeGenFunctionPin;
+
+typedef struct CodeGenModuleCache {
+    MemoryContext cxt;
+    List* functions;
+    List* pins;        /* list of CodeGenFunctionPin */
+    uint64 generation; /* advanced at the beginning of every query */
+} CodeGenModuleCache;
+
+static void CodeGenCacheReleaseCallback(ResourceReleasePhase phase, bool isCommit, bool isTopLevel, void* arg);
+
+static CodeGenModuleCache* GetModuleCache(bool create)
+{
+    CodeGenModuleCache* cache = (CodeGenModuleCache*)t_thrd.codegen_cxt.thr_codegen_cache;
+
+    if (cache == NULL && create) {
+        MemoryContext cxt = AllocSetContextCreate(t_thrd.top_mem_cxt,
+            "codegen module cache",
+            ALLOCSET_SMALL_MINSIZE,
+            ALLOCSET_SMALL_INITSIZE,
+            ALLOCSET_DEFAULT_MAXSIZE);
+        cache = (CodeGenModuleCache*)MemoryContextAllocZero(cxt, sizeof(CodeGenModuleCache));
+        cache->cxt = cxt;
+        t_thrd.codegen_cxt.thr_codegen_cache = cache;
+        RegisterResourceReleaseCallback(CodeGenCacheReleaseCallback, NULL);
+    }
+
+    return cache;
+}
+
+/*
+ * Pin a cached function to the current resource owner. Returns false if there
+ * is no resource owner to release the pin, the caller must not use the cache
+ * then.
+ */
+static bool PinCachedFunction(CodeGenModuleCache* cache, CodeGenCachedFunction* entry)
+{
+    ResourceOwner owner = t_thrd.utils_cxt.CurrentResourceOwner;
+
+    if (owner == NULL) {
+        return false;
+    }
+
+    MemoryContext oldContext = MemoryContextSwitchTo(cache->cxt);
+    CodeGenFunctionPin* pin = (CodeGenFunctionPin*)palloc(sizeof(CodeGenFunctionPin));
+    pin->entry = entry;
+    pin->owner = owner;
+    cache->pins = lappend(cache->pins, pin);
+    (void)MemoryContextSwitchTo(oldContext);
+
+    entry->pincount++;
+    entry->lastused = cache->generation;
+    return true;
+}
+
+/*
+ * Drop the pins held by the resource owner being released, the plans using
+ * them are gone by the time locks have been released.
+ */
+static void CodeGenCacheReleaseCallback(ResourceReleasePhase phase, bool isCommit, bool isTopLevel, void* arg)
+{
+    CodeGenModuleCache* cache = GetModuleCache(false);
+    ResourceOwner owner = t_thrd.utils_cxt.CurrentResourceOwner;
+    ListCell* cell = NULL;
+    ListCell* next = NULL;
+    ListCell* prev = NULL;
+
+    if (phase != RESOURCE_RELEASE_AFTER_LOCKS || cache == NULL) {
+        return;
+    }
+
+    for (cell = list_head(cache->pins); cell != NULL; cell = next) {
+        CodeGenFunctionPin* pin = (CodeGenFunctionPin*)lfirst(cell);
+
+        next = lnext(cell);
+        if (pin->owner != owner) {
+            prev = cell;
+            continue;
+        }
+
+        Assert(pin->entry->pincount > 0);
+        pin->entry->pincount--;
+        cache->pins = list_delete_cell(cache->pins, cell, prev);
+        pfree_ext(pin);
+    }
+}
+
+static void ReleaseCachedModule(CodeGenCachedModule* module)
+{
+    LLVM_TRY()
+    {
+        delete module->engine;
+        delete module->context;
+    }
+    LLVM_CATCH("Failed to release cached LLVM module!");
+    pfree_ext(module);
+}
+
+/*
+ * Evict the least recently used functions until 'room' new functions could be
+ * added without exceeding codegen_cache_size.
+ */
+static void EvictCachedFunctions(CodeGenModuleCache* cache, int room)
+{
+    while (list_length(cache->functions) + room > u_sess->attr.attr_sql.codegen_cache_size) {
+        ListCell* cell = NULL;
+        ListCell* prev = NULL;
+        ListCell* victim = NULL;
+        ListCell* victimPrev = NULL;
+
+        foreach (cell, cache->functions) {
+            CodeGenCachedFunction* entry = (CodeGenCachedFunction*)lfirst(cell);
+
+            if (entry->pincount == 0 &&
+                (victim == NULL || entry->lastused < ((CodeGenCachedFunction*)lfirst(victim))->lastused)) {
+                victim = cell;
+                victimPrev = prev;
+            }
+            prev = cell;
+        }
+
+        /* everything is in use by live plans */
+        if (victim == NULL) {
+            break;
+        }
+
+        CodeGenCachedFunction* entry = (CodeGenCachedFunction*)lfirst(victim);
+        cache->functions = list_delete_cell(cache->functions, victim, victimPrev);
+        if (--entry->module->refcount == 0) {
+            ReleaseCachedModule(entry->module);
+        }
+        pfree_ext(entry->signature);
+        pfree_ext(entry);
+    }
+}
+
 namespace dorado {
 void GsCodeGen::initialize()
 {
@@ -91,6 +261,12 @@ void GsCodeGen::initialize()
         ALLOCSET_DEFAULT_MINSIZE,
         ALLOCSET_DEFAULT_INITSIZE,
         ALLOCSET_DEFAULT_MAXSIZE);
+
+    /* A new query begins, advance the clock for LRU eviction */
+    CodeGenModuleCache* cache = GetModuleCache(false);
+    if (cache != NULL) {
+        cache->generation++;
+    }
 }
 
 bool GsCodeGen::InitializeLlvm(bool load_backend)
@@ -167,6 +343,7 @@ GsCodeGen::GsCodeGen() : m_llvmIRLoaded(false), m_isCorrupt(false)
     m_moduleCompiled = false;
     m_codeGenContext = NULL;
     m_cfunction_calls = NIL;
+    m_machineCodeJitCached = NIL;
 }
 
 GsCodeGen::~GsCodeGen()
@@ -184,6 +361,7 @@ GsCodeGen::~GsCodeGen()
     m_currentEngine = NULL;
     m_codeGenContext = NULL;
     m_cfunction_calls = NULL;
+    m_machineCodeJitCached = NULL;
 }
 
 void GsCodeGen::enableOptimizations(bool enable)
@@ -395,7 +573,81 @@ void GsCodeGen::compileCurrentModule(bool enable_jitcache)
     /* So we can read the IR file again when a new statement comes. */
     m_llvmIRLoaded = false;
 
+    if (m_machineCodeJitCached != NIL) {
+        cacheCompiledModule();
+    }
+
+    (void)MemoryContextSwitchTo(oldContext);
+}
+
+void GsCodeGen::cacheCompiledModule()
+{
+    ListCell* cell = NULL;
+    CodeGenModuleCache* cache = NULL;
+    CodeGenCachedModule* module = NULL;
+    int nfunctions = 0;
+
+    if (u_sess->attr.attr_sql.codegen_cache_size <= 0 || m_currentEngine == NULL ||
+        t_thrd.utils_cxt.CurrentResourceOwner == NULL) {
+        m_machineCodeJitCached = NIL;
+        return;
+    }
+
+    cache = GetModuleCache(true);
+    EvictCachedFunctions(cache, list_length(m_machineCodeJitCached));
+
+    MemoryContext oldContext = MemoryContextSwitchTo(cache->cxt);
+    module = (CodeGenCachedModule*)palloc0(sizeof(CodeGenCachedModule));
+
+    foreach (cell, m_machineCodeJitCached) {
+        Llvm_Map<char*, void**>* map = (Llvm_Map<char*, void**>*)lfirst(cell);
+
+        /* Failed to get the machine code, nothing to cache */
+        if (*map->value == NULL) {
+            continue;
+        }
+
+        CodeGenCachedFunction* entry = (CodeGenCachedFunction*)palloc0(sizeof(CodeGenCachedFunction));
+        entry->signature = pstrdup(map->key);
+        entry->hashvalue = DatumGetUInt32(hash_any((const unsigned char*)entry->signature, strlen(entry->signature)));
+        entry->function = *map->value;
+        entry->module = module;
+        cache->functions = lappend(cache->functions, entry);
+        nfunctions++;
+    }
     (void)MemoryContextSwitchTo(oldContext);
+
+    /* the plan being started holds the functions just compiled */
+    foreach (cell, cache->functions) {
+        CodeGenCachedFunction* entry = (CodeGenCachedFunction*)lfirst(cell);
+        if (entry->module == module) {
+            (void)PinCachedFunction(cache, entry);
+        }
+    }
+
+    m_machineCodeJitCached = NIL;
+
+    if (nfunctions == 0) {
+        pfree_ext(module);
+        return;
+    }
+
+    /*
+     * The engine owns the module, and both of them were created in our LLVM
+     * context, so move all of them to the cache and start over with a fresh
+     * context for the rest of this codegen object's life.
+     */
+    module->engine = m_currentEngine;
+    module->context = m_llvmContext;
+    module->refcount = nfunctions;
+
+    m_currentEngine = NULL;
+    m_currentModule = NULL;
+    LLVM_TRY()
+    {
+        m_llvmContext = new llvm::LLVMContext();
+    }
+    LLVM_CATCH("Failed to allocate LLVM context!");
 }
 
 llvm::ExecutionEngine* GsCodeGen::compileModule(llvm::Module* module, bool enable_jitcache)
@@ -443,6 +695,7 @@ void GsCodeGen::releaseResource()
 
     /* reset the m_machineCodeJitCompiled */
     m_machineCodeJitCompiled = NIL;
+    m_machineCodeJitCached = NIL;
 
     /*
      * release llvm execution engine. since module is subordinate to
@@ -710,6 +963,44 @@ void GsCodeGen::addFunctionToMCJit(llvm::Function* fn, void** machineCodeFuncPtr
     (void)MemoryContextSwitchTo(oldContext);
 }
 
+void GsCodeGen::addFunctionToMCJitCache(llvm::Function* fn, const char* signature, void** machineCodeFuncPtr)
+{
+    Assert(NULL != signature);
+
+    addFunctionToMCJit(fn, machineCodeFuncPtr);
+
+    MemoryContext oldContext = MemoryContextSwitchTo(m_codeGenContext);
+
+    Llvm_Map<char*, void**>* map = New(CurrentMemoryContext) Llvm_Map<char*, void**>;
+    map->key = pstrdup(signature);
+    map->value = machineCodeFuncPtr;
+    m_machineCodeJitCached = lappend(m_machineCodeJitCached, map);
+
+    (void)MemoryContextSwitchTo(oldContext);
+}
+
+void* GsCodeGen::lookupMCJitCache(const char* signature)
+{
+    ListCell* cell = NULL;
+    CodeGenModuleCache* cache = GetModuleCache(false);
+
+    if (cache == NULL || u_sess->attr.attr_sql.codegen_cache_size <= 0) {
+        return NULL;
+    }
+
+    uint32 hashvalue = DatumGetUInt32(hash_any((const unsigned char*)signature, strlen(signature)));
+    foreach (cell, cache->functions) {
+        CodeGenCachedFunction* entry = (CodeGenCachedFunction*)lfirst(cell);
+
+        if (entry->hashvalue == hashvalue && strcmp(entry->signature, signature) == 0) {
+            /* pin it for the lifetime of the plan being started */
+            return PinCachedFunction(cache, entry) ? entry->function : NULL;
+        }
+    }
+
+    return NULL;
+}
+
 void GsCodeGen::recordCFunctionCalls(char* name)
 {
     m_cfunction_calls = lappend(m_cfunction_calls, name);
@@ -140,6 +140,9 @@
 #include "vecexecutor/vechashagg.h"
 #include "vecexecutor/vecpartiterator.h"
 #include "vecexecutor/vecappend.h"
+#include "vecexecutor/vecmergeappend.h"
+#include "vecexecutor/vecrecursiveunion.h"
+#include "vecexecutor/vecworktablescan.h"
 #include "vecexecutor/veclimit.h"
 #include "vecexecutor/vecsetop.h"
 #include "vecexecutor/vecgroup.h"
@@ -360,6 +363,12 @@ PlanState* ExecInitNodeByType(Plan* node, EState* e_state, int e_flags)
             return (PlanState*)ExecInitVecPartIterator((VecPartIterator*)node, e_state, e_flags);
         case T_VecAppend:
             return (PlanState*)ExecInitVecAppend((VecAppend*)node, e_state, e_flags);
+        case T_VecMergeAppend:
+            return (PlanState*)ExecInitVecMergeAppend((VecMergeAppend*)node, e_state, e_flags);
+        case T_VecRecursiveUnion:
+            return (PlanState*)ExecInitVecRecursiveUnion((VecRecursiveUnion*)node, e_state, e_flags);
+        case T_VecWorkTableScan:
+            return (PlanState*)ExecInitVecWorkTableScan((VecWorkTableScan*)node, e_state, e_flags);
         case T_VecGroup:
             return (PlanState*)ExecInitVecGroup((VecGroup*)node, e_state, e_flags);
         case T_VecLimit:
@@ -518,6 +527,11 @@ PlanState* ExecInitNode(Plan* node, EState* e_state, int e_flags)
 
         result->instrument->memoryinfo.nodeContext = node_context;
 
+        /* row-engine scans decide on codegen before their instrumentation exists */
+        if (IsA(result, SeqScanState) && ((SeqScanState*)result)->is_row_jitted) {
+            result->instrument->isLlvmOpt = true;
+        }
+
         if (u_sess->attr.attr_resource.use_workload_manager &&
             u_sess->attr.attr_resource.resource_track_level == RESOURCE_TRACK_OPERATOR &&
             e_state->es_can_realtime_statistics && u_sess->exec_cxt.need_track_resource && NeedExecuteActiveSql(node)) {
@@ -1271,6 +1285,15 @@ static void ExecEndNodeByType(PlanState* node)
         case T_VecAppendState:
             ExecEndVecAppend((VecAppendState*)node);
             break;
+        case T_VecMergeAppendState:
+            ExecEndVecMergeAppend((VecMergeAppendState*)node);
+            break;
+        case T_VecRecursiveUnionState:
+            ExecEndVecRecursiveUnion((VecRecursiveUnionState*)node);
+            break;
+        case T_VecWorkTableScanState:
+            ExecEndVecWorkTableScan((VecWorkTableScanState*)node);
+            break;
         case T_VecForeignScanState:
             ExecEndVecForeignScan((VecForeignScanState*)node);
             break;
@@ -5618,7 +5618,10 @@ TupleTableSlot* ExecProject(ProjectionInfo* projInfo, ExprDoneCond* isDone)
      * we have reached the end of the set, we return the result slot, which we
      * already marked empty.
      */
-    if (projInfo->pi_targetlist) {
+    if (projInfo->jitted_rowtarget != NULL) {
+        /* LLVM optimized target list never returns sets */
+        projInfo->jitted_rowtarget(econtext, slot->tts_values, slot->tts_isnull);
+    } else if (projInfo->pi_targetlist) {
         if (!ExecTargetList(
                 projInfo->pi_targetlist, econtext, slot->tts_values, slot->tts_isnull, projInfo->pi_itemIsDone, isDone))
             return slot; /* no more result rows, return empty slot */
@@ -191,7 +191,8 @@ TupleTableSlot* ExecScan(ScanState* node, ExecScanAccessMtd access_mtd, /* funct
          * when the qual is nil ... saves only a few cycles, but they add up
          * ...
          */
-        if (qual == NULL || ExecQual(qual, e_context, false)) {
+        if (qual == NULL ||
+            (node->jitted_rowqual != NULL ? node->jitted_rowqual(e_context) : ExecQual(qual, e_context, false))) {
             /*
              * Found a satisfactory scan tuple.
              */
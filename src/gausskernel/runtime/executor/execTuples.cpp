@@ -130,6 +130,7 @@ TupleTableSlot* MakeTupleTableSlot(bool has_tuple_mcxt)
     slot->tts_values = NULL;
     slot->tts_isnull = NULL;
     slot->tts_mintuple = NULL;
+    slot->tts_jitted_deform = NULL;
     slot->tts_per_tuple_mcxt = has_tuple_mcxt ? AllocSetContextCreate(slot->tts_mcxt,
         "SlotPerTupleMcxt",
         ALLOCSET_DEFAULT_MINSIZE,
@@ -292,6 +293,9 @@ void ExecSetSlotDescriptor(TupleTableSlot* slot, /* slot to change */
     slot->tts_tupleDescriptor = tup_desc;
     PinTupleDesc(tup_desc);
 
+    /* Any deform function generated for the old descriptor is useless now */
+    slot->tts_jitted_deform = NULL;
+
     /*
      * Allocate Datum/isnull arrays of the appropriate size.  These must have
      * the same lifetime as the slot, so allocate in the slot's own context.
@@ -1275,6 +1275,18 @@ Instrumentation* ThreadInstrumentation::allocInstrSlot(int plan_node_id, int par
             pname = "Vector Append";
             plan_type = UTILITY_OP;
             break;
+        case T_VecMergeAppend:
+            pname = "Vector Merge Append";
+            plan_type = UTILITY_OP;
+            break;
+        case T_VecRecursiveUnion:
+            pname = "Vector Recursive Union";
+            plan_type = UTILITY_OP;
+            break;
+        case T_VecWorkTableScan:
+            pname = "Vector WorkTable Scan";
+            plan_type = UTILITY_OP;
+            break;
         case T_VecModifyTable:
             plan_type = IO_OP;
             switch (((ModifyTable*)plan)->operation) {
@@ -1652,7 +1664,8 @@ void StreamInstrumentation::getStreamInfo(
     info->numOfNodes++;
 
     switch (nodeTag(result_plan)) {
-        case T_MergeAppend: {
+        case T_MergeAppend:
+        case T_VecMergeAppend: {
             MergeAppend* ma = (MergeAppend*)result_plan;
             ListCell* lc = NULL;
             foreach (lc, ma->mergeplans) {
@@ -307,7 +307,7 @@ static void pass_down_bound(LimitState* node, PlanState* child_node)
             sortState->bounded = true;
             sortState->bound = tuples_needed;
         }
-    } else if (IsA(child_node, MergeAppendState)) {
+    } else if (IsA(child_node, MergeAppendState) || IsA(child_node, VecMergeAppendState)) {
         MergeAppendState* maState = (MergeAppendState*)child_node;
         int i;
 
@@ -27,6 +27,7 @@
 
 #include "access/relscan.h"
 #include "access/tableam.h"
+#include "codegen/rowcodegen.h"
 #include "executor/execdebug.h"
 #include "executor/nodeModifyTable.h"
 #include "executor/nodeSamplescan.h"
@@ -40,6 +41,8 @@
 #include "nodes/execnodes.h"
 
 extern void StrategyGetRingPrefetchQuantityAndTrigger(BufferAccessStrategy strategy, int* quantity, int* trigger);
+extern bool CodeGenThreadObjectReady();
+extern bool CodeGenPassThreshold(double rows, int dn_num, int dop);
 /* ----------------------------------------------------------------
  *		prefetch_pages
  *
@@ -518,6 +521,17 @@ SeqScanState* ExecInitSeqScan(SeqScan* node, EState* estate, int eflags)
     ExecAssignResultTypeFromTL(&scanstate->ps);
     ExecAssignScanProjectionInfo(scanstate);
 
+    /*
+     * Consider LLVM optimization for qual, target list and tuple deforming.
+     * The qual is re-initialized against new ctid ranges for relations in
+     * redistribution, so leave them alone.
+     */
+    if (u_sess->attr.attr_sql.enable_row_codegen && !(eflags & EXEC_FLAG_EXPLAIN_ONLY) &&
+        !u_sess->attr.attr_sql.enable_cluster_resize && CodeGenThreadObjectReady() &&
+        CodeGenPassThreshold(((Plan*)node)->plan_rows, estate->es_plannedstmt->num_nodes, ((Plan*)node)->dop)) {
+        scanstate->is_row_jitted = dorado::RowExprCodeGen::ScanCodeGen((ScanState*)scanstate);
+    }
+
     return scanstate;
 }
 
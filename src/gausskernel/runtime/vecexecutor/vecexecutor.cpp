@@ -65,6 +65,9 @@
 #include "vecexecutor/vecmaterial.h"
 #include "vecexecutor/vecmergejoin.h"
 #include "vecexecutor/vecwindowagg.h"
+#include "vecexecutor/vecmergeappend.h"
+#include "vecexecutor/vecrecursiveunion.h"
+#include "vecexecutor/vecworktablescan.h"
 
 extern char* nodeTagToString(NodeTag type);
 
@@ -110,6 +113,9 @@ VectorEngineFunc VectorEngineRunner[] = {
     reinterpret_cast<VectorEngineFunc>(ExecVecMaterial),
     reinterpret_cast<VectorEngineFunc>(ExecVecMergeJoin),
     reinterpret_cast<VectorEngineFunc>(ExecVecWindowAgg),
+    reinterpret_cast<VectorEngineFunc>(ExecVecMergeAppend),
+    reinterpret_cast<VectorEngineFunc>(ExecVecRecursiveUnion),
+    reinterpret_cast<VectorEngineFunc>(ExecVecWorkTableScan),
 };
 
 FORCE_INLINE
@@ -365,6 +371,7 @@ void ExecEarlyFree(PlanState* node)
             break;
 
         /* No need for early free */
+        case T_VecMergeAppendState:
         case T_MergeAppendState:
             if (!node->earlyFreed) {
                 MergeAppendState* appendState = (MergeAppendState*)node;
@@ -1671,6 +1671,22 @@ void BaseAggRunner::prepare_projection_batch()
     }
 }
 
+/*
+ * @Description: Check whether the hash agg could be adaptive. It must be the lower agg
+ * of a two-level aggregation, so the upper agg regroups whatever is flushed to it and
+ * one group may be returned more than once.
+ *
+ * @param[IN] node:  vector executor state for Agg
+ * @return: bool
+ */
+bool ExecVecAggIsAdaptive(VecAggState* node)
+{
+    VecAgg* plan = (VecAgg*)node->ss.ps.plan;
+
+    return u_sess->attr.attr_sql.enable_adaptive_hashagg && plan->aggstrategy == AGG_HASHED && plan->is_partial &&
+           plan->groupingSets == NIL;
+}
+
 /*
  * @Description: Early free the memory for VecAggregation.
  *
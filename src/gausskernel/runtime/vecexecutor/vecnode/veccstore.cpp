@@ -45,7 +45,10 @@
 #include "executor/nodeSeqscan.h"
 #include "storage/cstore_compress.h"
 #include "access/cstore_am.h"
+#include "nodes/nodeFuncs.h"
 #include "optimizer/clauses.h"
+#include "optimizer/var.h"
+#include "parser/parse_oper.h"
 #include "nodes/params.h"
 #include "utils/lsyscache.h"
 #include "utils/datum.h"
@@ -77,6 +80,8 @@ static Datum get_param_extern_const_value(Oid left_type, Expr* expr, PlanState*
 static void exec_init_next_part4cstore_scan(CStoreScanState* node);
 static void exec_cstore_build_scan_keys(CStoreScanState* scan_stat, List* quals, CStoreScanKey* scan_keys, int* num_scan_keys,
     CStoreScanRunTimeKeyInfo** runtime_key_info, int* runtime_keys_num);
+static void exec_cstore_split_qual(CStoreScanState* scan_stat, CStoreScan* node);
+static List* exec_cstore_late_qual_vars(CStoreScanState* scan_stat, CStoreScan* node);
 static void exec_cstore_scan_eval_runtime_keys(
     ExprContext* expr_ctx, CStoreScanRunTimeKeyInfo* runtime_keys, int num_runtime_keys);
 
@@ -184,6 +189,45 @@ void OptimizeProjectionAndFilter(CStoreScanState* node)
     node->m_fSimpleMap = simple_map;
 }
 
+/*
+ * Evaluate the qual on the scan batch and pack the qualified rows,
+ * return false if no row is qualified.
+ */
+static bool exec_cstore_qual_and_pack(CStoreScanState* node, List* qual, VectorBatch* p_scan_batch, bool use_jitted)
+{
+    ExprContext* econtext = node->ps.ps_ExprContext;
+    ProjectionInfo* proj = node->ps.ps_ProjInfo;
+    ScalarVector* p_vector = NULL;
+    int late_read_ctid = 0;
+
+    if (use_jitted)
+        p_vector = node->jitted_vecqual(econtext);
+    else
+        p_vector = ExecVecQual(qual, econtext, false);
+
+    if (p_vector == NULL) {
+        return false;
+    }
+
+    /*
+     * Call optimized PackT function when codegen is turned on.
+     */
+    if (econtext->ecxt_scanbatch->m_sel) {
+        if (u_sess->attr.attr_sql.enable_codegen) {
+            late_read_ctid = node->m_CStore->GetLateReadCtid();
+            if (node->ss_deltaScan || late_read_ctid == -1) {
+                p_scan_batch->OptimizePack(econtext->ecxt_scanbatch->m_sel, proj->pi_PackTCopyVars);
+            } else {
+                p_scan_batch->OptimizePackForLateRead(
+                    econtext->ecxt_scanbatch->m_sel, proj->pi_PackLateAccessVarNumbers, late_read_ctid);
+            }
+        } else
+            p_scan_batch->Pack(econtext->ecxt_scanbatch->m_sel);
+    }
+
+    return true;
+}
+
 VectorBatch* ApplyProjectionAndFilter(CStoreScanState* node, VectorBatch* p_scan_batch, ExprDoneCond* done)
 {
     List* qual = NIL;
@@ -191,8 +235,9 @@ VectorBatch* ApplyProjectionAndFilter(CStoreScanState* node, VectorBatch* p_scan
     ProjectionInfo* proj = node->ps.ps_ProjInfo;
     VectorBatch* p_out_batch = NULL;
     bool simple_map = false;
-    int late_read_ctid = 0;
     uint64 input_rows = p_scan_batch->m_rows;
+    bool full_hit = false;
+    bool late_qual = false;
 
     VECCSTORE_SCAN_TRACE_START(node, CSTORE_PROJECT);
 
@@ -201,6 +246,21 @@ VectorBatch* ApplyProjectionAndFilter(CStoreScanState* node, VectorBatch* p_scan
     p_out_batch = node->m_pCurrentBatch;
     simple_map = node->m_fSimpleMap;
 
+    /* all rows come from a CU satisfying the scan keys, skip their clauses */
+    full_hit = !node->ss_deltaScan && node->m_CStore->IsFullHitBatch();
+    if (full_hit) {
+        qual = node->m_residualQual;
+    }
+
+    /*
+     * The columns only referenced by the residual qual are not read yet,
+     * evaluate the scan keys first and then the residual qual after reading them.
+     */
+    late_qual = !node->ss_deltaScan && node->m_earlyQual != NIL;
+    if (late_qual) {
+        qual = full_hit ? NIL : node->m_earlyQual;
+    }
+
     if (node->jitted_vecqual) {
         if (HAS_INSTR(node, false)) {
             node->ps.instrument->isLlvmOpt = true;
@@ -211,37 +271,23 @@ VectorBatch* ApplyProjectionAndFilter(CStoreScanState* node, VectorBatch* p_scan
         ResetExprContext(econtext);
         initEcontextBatch(p_scan_batch, NULL, NULL, NULL);
         // Evaluate the qualification clause if any.
+        // If no matched rows, fetch again.
         //
-        if (qual != NULL) {
-            ScalarVector* p_vector = NULL;
+        if (qual != NULL &&
+            !exec_cstore_qual_and_pack(node, qual, p_scan_batch, node->jitted_vecqual && !full_hit && !late_qual)) {
+            p_out_batch->m_rows = 0;
+            goto done;
+        }
 
-            if (node->jitted_vecqual)
-                p_vector = node->jitted_vecqual(econtext);
-            else
-                p_vector = ExecVecQual(qual, econtext, false);
+        if (late_qual) {
+            VECCSTORE_SCAN_TRACE_START(node, FILL_LATER_BATCH);
+            node->m_CStore->FillScanBatchLateQualIfNeed(p_scan_batch);
+            VECCSTORE_SCAN_TRACE_END(node, FILL_LATER_BATCH);
 
-            // If no matched rows, fetch again.
-            //
-            if (p_vector == NULL) {
+            if (!exec_cstore_qual_and_pack(node, node->m_residualQual, p_scan_batch, false)) {
                 p_out_batch->m_rows = 0;
                 goto done;
             }
-
-            /*
-             * Call optimized PackT function when codegen is turned on.
-             */
-            if (econtext->ecxt_scanbatch->m_sel) {
-                if (u_sess->attr.attr_sql.enable_codegen) {
-                    late_read_ctid = node->m_CStore->GetLateReadCtid();
-                    if (node->ss_deltaScan || late_read_ctid == -1) {
-                        p_scan_batch->OptimizePack(econtext->ecxt_scanbatch->m_sel, proj->pi_PackTCopyVars);
-                    } else {
-                        p_scan_batch->OptimizePackForLateRead(
-                            econtext->ecxt_scanbatch->m_sel, proj->pi_PackLateAccessVarNumbers, late_read_ctid);
-                    }
-                } else
-                    p_scan_batch->Pack(econtext->ecxt_scanbatch->m_sel);
-            }
         }
 
         // Late read these columns for non-delta data
@@ -795,6 +841,10 @@ CStoreScanState* ExecInitCStoreScan(
         &scan_stat->m_pScanRunTimeKeys,
         &scan_stat->m_ScanRunTimeKeysNum);
 
+    /* the compiled qual can not be split, so the late qual columns are read with the others */
+    scan_stat->m_lateQualVars = (jitted_vecqual == NULL) ? exec_cstore_late_qual_vars(scan_stat, node) : NIL;
+    exec_cstore_split_qual(scan_stat, node);
+
     scan_stat->m_CStore = New(CurrentMemoryContext) CStore();
     scan_stat->m_CStore->InitScan(scan_stat, GetActiveSnapshot());
     OptimizeProjectionAndFilter(scan_stat);
@@ -880,6 +930,110 @@ void ExecEndCStoreScan(CStoreScanState* node, bool idx_flag)
     EndScanDeltaRelation(node);
 }
 
+/*
+ * Check whether the scan key built from the clause holds the exact value of
+ * its argument. convert_scan_key_int64_if_need casts date/time arguments to
+ * the column type, e.g. a timestamp constant compared with a date column is
+ * truncated to a date, so the min/max of a CU can not tell whether all of its
+ * rows satisfy such a clause.
+ */
+static bool exec_cstore_scan_key_is_exact(Expr* clause)
+{
+    Expr* leftop = (Expr*)get_leftop(clause);
+    Expr* rightop = (Expr*)get_rightop(clause);
+
+    if (leftop == NULL || rightop == NULL) {
+        return false;
+    }
+    if (IsA(leftop, RelabelType)) {
+        leftop = ((RelabelType*)leftop)->arg;
+    }
+    if (IsA(rightop, RelabelType)) {
+        rightop = ((RelabelType*)rightop)->arg;
+    }
+
+    Oid left_type = exprType((Node*)leftop);
+    Oid right_type = exprType((Node*)rightop);
+
+    return left_type == right_type || (IsIntType(left_type) && IsIntType(right_type));
+}
+
+/*
+ * Split the qual into the clauses pushed down as scan keys and the others.
+ * The residual qual is evaluated alone on the batches whose rows all satisfy
+ * the scan keys, so it also keeps the clauses whose scan keys are not exact.
+ * If some columns are only referenced by the residual qual, the scan keys are
+ * evaluated first as the early qual, and these columns are read just for the
+ * rows left.
+ */
+static void exec_cstore_split_qual(CStoreScanState* scan_stat, CStoreScan* node)
+{
+    ListCell* lc_clause = NULL;
+    ListCell* lc_state = NULL;
+
+    scan_stat->m_residualQual = NIL;
+    scan_stat->m_earlyQual = NIL;
+    if (scan_stat->csss_NumScanKeys == 0) {
+        return;
+    }
+
+    /* the qual states are initialized from the plan qual one by one */
+    Assert(list_length(scan_stat->ps.qual) == list_length(node->plan.qual));
+    forboth(lc_clause, node->plan.qual, lc_state, scan_stat->ps.qual)
+    {
+        Expr* clause = (Expr*)lfirst(lc_clause);
+
+        if (!list_member(node->cstorequal, clause) || !exec_cstore_scan_key_is_exact(clause)) {
+            scan_stat->m_residualQual = lappend(scan_stat->m_residualQual, lfirst(lc_state));
+        } else if (scan_stat->m_lateQualVars != NIL) {
+            scan_stat->m_earlyQual = lappend(scan_stat->m_earlyQual, lfirst(lc_state));
+        }
+    }
+}
+
+/*
+ * Get the columns referenced by the qual but not by the clauses pushed down
+ * as scan keys, they can be read after the scan keys filter the batch.
+ */
+static List* exec_cstore_late_qual_vars(CStoreScanState* scan_stat, CStoreScan* node)
+{
+    List* early_vars = NIL;
+    List* late_vars = NIL;
+    List* result = NIL;
+    ListCell* lc = NULL;
+
+    if (scan_stat->csss_NumScanKeys == 0) {
+        return NIL;
+    }
+
+    foreach (lc, node->plan.qual) {
+        Node* clause = (Node*)lfirst(lc);
+        bool is_scan_key = list_member(node->cstorequal, clause);
+        List* vars = pull_var_clause(clause, PVC_RECURSE_AGGREGATES, PVC_RECURSE_PLACEHOLDERS);
+        ListCell* lc_var = NULL;
+
+        foreach (lc_var, vars) {
+            Var* var = (Var*)lfirst(lc_var);
+
+            if (var->varattno <= 0) {
+                continue;
+            }
+            if (is_scan_key) {
+                early_vars = list_append_unique_int(early_vars, var->varattno);
+            } else {
+                late_vars = list_append_unique_int(late_vars, var->varattno);
+            }
+        }
+        list_free_ext(vars);
+    }
+
+    result = list_difference_int(late_vars, early_vars);
+    list_free_ext(early_vars);
+    list_free_ext(late_vars);
+
+    return result;
+}
+
 /* Build the cstore scan keys from the qual. */
 static void exec_cstore_build_scan_keys(CStoreScanState* scan_stat, List* quals, CStoreScanKey* scan_keys, int* num_scan_keys,
     CStoreScanRunTimeKeyInfo** runtime_key_info, int* runtime_keys_num)
@@ -1202,6 +1356,7 @@ static void exec_init_next_part4cstore_scan(CStoreScanState* node)
 
         new_qual = eval_ctid_funcs(curr_part_rel, node->ps.plan->qual, &node->isRangeScanInRedis);
         node->ps.qual = (List*)ExecInitVecExpr((Expr*)new_qual, (PlanState*)&node->ps);
+        exec_cstore_split_qual(node, (CStoreScan*)node->ps.plan);
     }
 
     if (!node->isSampleScan) {
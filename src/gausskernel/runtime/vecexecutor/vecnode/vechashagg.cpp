@@ -134,7 +134,17 @@ HashAggRunner::HashAggRunner(VecAggState* runtime) : BaseAggRunner(runtime, true
 
     if (m_runtime->ss.ps.instrument) {
         m_runtime->ss.ps.instrument->sorthashinfo.hashtable_expand_times = 0;
+        m_runtime->ss.ps.instrument->sorthashinfo.hashagg_flush_times = 0;
     }
+
+    m_adaptive = ExecVecAggIsAdaptive(runtime);
+    m_streaming = false;
+    m_sampled = false;
+    m_flushPending = false;
+    m_inputRows = 0;
+    m_flushTimes = 0;
+    /* streaming hash table keeps its cells and buckets in L2 cache */
+    m_flushRows = Max(ADAPTIVE_AGG_CACHE_SIZE / (m_cellSize + 2 * sizeof(hashCell*)), BatchMaxSize);
 }
 
 void HashAggRunner::BindingFp()
@@ -162,9 +172,11 @@ bool HashAggRunner::ResetNecessary(VecAggState* node)
      * parameter changes, and none of our own parameter changes affect
      * input expressions of the aggregated functions, then we can just
      * rescan the existing hash table, and have not spill to disk;
-     * no need to build it again.
+     * no need to build it again. The hash table of adaptive hash agg
+     * only has the groups after the last flush, so build it again.
      */
-    if (m_spillToDisk == false && node->ss.ps.lefttree->chgParam == NULL && aggnode->aggParams == NULL) {
+    if (m_spillToDisk == false && m_flushTimes == 0 && node->ss.ps.lefttree->chgParam == NULL &&
+        aggnode->aggParams == NULL) {
         m_runState = AGG_FETCH;
         return false;
     }
@@ -204,6 +216,12 @@ bool HashAggRunner::ResetNecessary(VecAggState* node)
     m_finish = false;
     m_strategy = HASH_IN_MEMORY;
 
+    m_streaming = false;
+    m_sampled = false;
+    m_flushPending = false;
+    m_inputRows = 0;
+    m_flushTimes = 0;
+
     return true;
 }
 
@@ -242,10 +260,13 @@ void HashAggRunner::AllocHashSlot(VectorBatch* batch, int i)
             }
 
             cell->flag.m_next = head_cell;
-            JudgeMemoryOverflow("VecHashAgg",
-                m_runtime->ss.ps.plan->plan_node_id,
-                SET_DOP(m_runtime->ss.ps.plan->dop),
-                m_runtime->ss.ps.instrument);
+            if (m_adaptive)
+                JudgeTableFull();
+            else
+                JudgeMemoryOverflow("VecHashAgg",
+                    m_runtime->ss.ps.plan->plan_node_id,
+                    SET_DOP(m_runtime->ss.ps.plan->dop),
+                    m_runtime->ss.ps.instrument);
         } break;
         case HASH_IN_DISK: {
             /* spill to disk first time */
@@ -374,6 +395,12 @@ void HashAggRunner::BuildHashTable(int64 old_size)
 
 /*
  * @Description: get batch from lefttree or temp file and insert into hash table.
+ *
+ * For adaptive hash agg, the build stops when the hash table is full. Its groups
+ * are returned to the upper agg and the build goes on with an empty hash table,
+ * so nothing is spilled to disk. If the groups are not much fewer than the input
+ * rows, grouping in a big hash table only thrashes memory, so the input streams
+ * through a cache-sized hash table which is flushed every time it fills up.
  */
 void HashAggRunner::Build()
 {
@@ -385,6 +412,14 @@ void HashAggRunner::Build()
         if (unlikely(BatchIsNull(outer_batch)))
             break;
         (this->*m_buildFun)(outer_batch);
+
+        if (m_adaptive) {
+            m_inputRows += outer_batch->m_rows;
+            if (!m_streaming && (m_flushPending || (!m_sampled && m_inputRows >= ADAPTIVE_AGG_SAMPLE_ROWS)))
+                AdaptiveCheck();
+            if (m_flushPending)
+                break;
+        }
     }
     (void)pgstat_report_waitstatus(old_status);
 
@@ -399,7 +434,83 @@ void HashAggRunner::Build()
         m_runtime->ss.ps.instrument->sorthashinfo.hashbuild_time = m_hashbuild_time;
     }
 
-    m_finish = true;
+    if (!m_flushPending)
+        m_finish = true;
+}
+
+/*
+ * @Description: adaptive hash agg, count the new group and mark the hash table full
+ * when it reaches the streaming size or the operator memory.
+ */
+void HashAggRunner::JudgeTableFull()
+{
+    m_rows++;
+    if (m_flushPending)
+        return;
+
+    if (m_streaming)
+        m_flushPending = m_rows >= m_flushRows;
+    else
+        m_flushPending = JudgeMemoryFull(SET_DOP(m_runtime->ss.ps.plan->dop));
+}
+
+/*
+ * @Description: adaptive hash agg, check the reduction ratio of the input rows since
+ * the hash table is reset, switch to streaming if grouping barely reduces them.
+ */
+void HashAggRunner::AdaptiveCheck()
+{
+    m_sampled = true;
+    if (m_rows <= m_inputRows * ADAPTIVE_AGG_STREAM_RATIO)
+        return;
+
+    ereport(LOG,
+        (errmodule(MOD_VEC_EXECUTOR),
+            errmsg("[VecHashAgg(%d)]: %ld groups in %ld rows, switch to streaming with %ld groups.",
+                m_runtime->ss.ps.plan->plan_node_id,
+                m_rows,
+                m_inputRows,
+                m_flushRows)));
+
+    m_streaming = true;
+    m_flushPending = true;
+}
+
+/*
+ * @Description: adaptive hash agg, drop the groups that are flushed and build an
+ * empty hash table for the rest of input.
+ * @in hash_size - initial hash size.
+ */
+void HashAggRunner::ResetHashTable(int64 hash_size)
+{
+    MemoryContextResetAndDeleteChildren(m_hashContext);
+
+    /*
+     * MemoryContextResetAndDeleteChildren(m_hashContext)
+     * freed the m_hashcell_context, so here should be created once more.
+     */
+    m_hashcell_context = AllocSetContextCreate(m_hashContext,
+        "HashCellContext",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE,
+        STACK_CONTEXT,
+        m_totalMem);
+
+    BuildHashTable<false, false>(hash_size);
+
+    m_rows = 0;
+    m_inputRows = 0;
+    m_flushPending = false;
+    m_flushTimes++;
+    if (m_runtime->ss.ps.instrument) {
+        m_runtime->ss.ps.instrument->sorthashinfo.hashagg_flush_times++;
+    }
+
+    m_statusLog.restore = false;
+    m_statusLog.lastIdx = 0;
+    m_statusLog.lastCell = NULL;
+    m_statusLog.lastSeg = 0;
 }
 
 /*
@@ -531,7 +642,7 @@ VectorBatch* HashAggRunner::Run()
                     }
                 }
 
-                if (!m_spillToDisk) {
+                if (!m_spillToDisk && !m_flushPending) {
                     /* Early free left tree after hash table built */
                     ExecEarlyFree(outerPlanState(m_runtime));
 
@@ -548,7 +659,11 @@ VectorBatch* HashAggRunner::Run()
             case AGG_FETCH:
                 p_res = Probe();
                 if (BatchIsNull(p_res)) {
-                    if (m_spillToDisk == true) {
+                    if (m_flushPending) {
+                        /* all the groups are flushed, go on building with the rest of input */
+                        ResetHashTable(m_streaming ? 2 * m_flushRows : m_hashSize);
+                        m_runState = AGG_BUILD;
+                    } else if (m_spillToDisk == true) {
                         m_strategy = HASH_IN_DISK;
                         m_runState = AGG_PREPARE;
                     } else {
@@ -415,6 +415,21 @@ void hashBasedOperator::JudgeMemoryOverflow(char* op_name, int plan_id, int dop,
     }
 }
 
+/*
+ * @Description: judge whether the hash context exceeds the operator memory, no memory
+ * spread or spill is tried, for the operator which empties its hash table instead.
+ * @in dop - query dop of current operator.
+ * @return - bool
+ */
+bool hashBasedOperator::JudgeMemoryFull(int dop)
+{
+    int64 used_size = 0;
+    int64 free_size = 0;
+    CalculateHashContextSize(m_hashContext, &used_size, &free_size);
+
+    return used_size > m_totalMem || gs_sysmemory_busy(used_size * dop, false);
+}
+
 /*
  * @Description: judge memory allowed for expanding
  * @return - bool
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ * vecmergeappend.cpp
+ *    routines to handle vectorized MergeAppend nodes.
+ *
+ * IDENTIFICATION
+ *        Code/src/gausskernel/runtime/vecexecutor/vecnode/vecmergeappend.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+/* INTERFACE ROUTINES
+ *		ExecInitVecMergeAppend	- initialize the MergeAppend node
+ *		ExecVecMergeAppend		- retrieve the next batch from the node
+ *		ExecEndVecMergeAppend	- shut down the MergeAppend node
+ *		ExecReScanVecMergeAppend - rescan the MergeAppend node
+ *
+ *	 NOTES
+ *		Every subplan returns batches already sorted on the merge keys. The
+ *		subplans compete in a loser tree: the winner sits in ms_tree[0] and
+ *		each internal node keeps the loser of the match played there. Instead
+ *		of emitting one row per tree adjustment, we compare the winner against
+ *		the best of the losers on its path (the runner-up) and copy the whole
+ *		run of rows that still sort before the runner-up into the result
+ *		batch at once. On nearly disjoint inputs, such as range partitions,
+ *		this moves entire batches with a single tree adjustment.
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "executor/execdebug.h"
+#include "executor/nodeMergeAppend.h"
+#include "utils/sortsupport.h"
+#include "vecexecutor/vecmergeappend.h"
+#include "vecexecutor/vecexecutor.h"
+
+static int32 vec_merge_compare_rows(VecMergeAppendState* node, int plan1, int row1, int plan2, int row2);
+static bool vec_merge_beats(VecMergeAppendState* node, int plan1, int plan2);
+static void vec_merge_adjust(VecMergeAppendState* node, int plan);
+static void vec_merge_fetch(VecMergeAppendState* node, int plan);
+
+/* ----------------------------------------------------------------
+ *		ExecInitVecMergeAppend
+ *
+ *		Begin all of the subscans of the MergeAppend node.
+ * ----------------------------------------------------------------
+ */
+VecMergeAppendState* ExecInitVecMergeAppend(VecMergeAppend* node, EState* estate, int eflags)
+{
+    VecMergeAppendState* merge_state = makeNode(VecMergeAppendState);
+    PlanState** merge_plan_states;
+    int nplans;
+    int i;
+    ListCell* lc = NULL;
+
+    /* check for unsupported flags */
+    Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
+
+    /*
+     * Set up empty vector of subplan states
+     */
+    nplans = list_length(node->mergeplans);
+
+    merge_plan_states = (PlanState**)palloc0(nplans * sizeof(PlanState*));
+
+    /*
+     * create new MergeAppendState for our node
+     */
+    merge_state->ps.plan = (Plan*)node;
+    merge_state->ps.state = estate;
+    merge_state->mergeplans = merge_plan_states;
+    merge_state->ms_nplans = nplans;
+    merge_state->ps.vectorized = true;
+
+    merge_state->ms_batches = (VectorBatch**)palloc0(sizeof(VectorBatch*) * nplans);
+    merge_state->ms_cursors = (int*)palloc0(sizeof(int) * nplans);
+    merge_state->ms_tree = (int*)palloc0(sizeof(int) * nplans);
+
+    /*
+     * Miscellaneous initialization
+     *
+     * MergeAppend plans don't have expression contexts because they never
+     * call ExecQual or ExecProject.
+     */
+    ExecInitResultTupleSlot(estate, &merge_state->ps);
+
+    /*
+     * call ExecInitNode on each of the plans to be executed and save the
+     * results into the array "merge_plans".
+     */
+    i = 0;
+    foreach (lc, node->mergeplans) {
+        Plan* initNode = (Plan*)lfirst(lc);
+
+        merge_plan_states[i] = ExecInitNode(initNode, estate, eflags);
+        i++;
+    }
+
+    /*
+     * initialize output tuple type and the batch we merge rows into
+     */
+    ExecAssignResultTypeFromTL(&merge_state->ps);
+    merge_state->ps.ps_ProjInfo = NULL;
+    merge_state->m_pCurrentBatch =
+        New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, ExecGetResultType(&merge_state->ps));
+
+    /*
+     * initialize sort-key information, abbreviated keys are not used for the
+     * same reason as in the row engine.
+     */
+    merge_state->ms_nkeys = node->numCols;
+    merge_state->ms_sortkeys = (SortSupportData*)palloc0(sizeof(SortSupportData) * node->numCols);
+
+    for (i = 0; i < node->numCols; i++) {
+        SortSupport sortKey = merge_state->ms_sortkeys + i;
+
+        sortKey->ssup_cxt = CurrentMemoryContext;
+        sortKey->ssup_collation = node->collations[i];
+        sortKey->ssup_nulls_first = node->nullsFirst[i];
+        sortKey->ssup_attno = node->sortColIdx[i];
+        sortKey->abbreviate = false;
+
+        PrepareSortSupportFromOrderingOp(node->sortOperators[i], sortKey);
+    }
+
+    /*
+     * initialize to show we have not run the subplans yet
+     */
+    merge_state->ms_initialized = false;
+
+    return merge_state;
+}
+
+/* ----------------------------------------------------------------
+ *	   ExecVecMergeAppend
+ *
+ *		Merge the sorted batches of all subplans into one batch.
+ * ----------------------------------------------------------------
+ */
+VectorBatch* ExecVecMergeAppend(VecMergeAppendState* node)
+{
+    VectorBatch* result = node->m_pCurrentBatch;
+    int nplans = node->ms_nplans;
+    int i;
+
+    result->Reset();
+
+    if (!node->ms_initialized) {
+        /*
+         * First time through: pull the first batch from each subplan, and
+         * build the loser tree. Every internal node starts with the virtual
+         * player nplans which beats everybody, so each real player pushes it
+         * one level up until it has left the tree.
+         */
+        for (i = 0; i < nplans; i++) {
+            node->ms_cursors[i] = 0;
+            node->ms_batches[i] = NULL;
+            vec_merge_fetch(node, i);
+            node->ms_tree[i] = nplans;
+        }
+        for (i = nplans - 1; i >= 0; i--)
+            vec_merge_adjust(node, i);
+        node->ms_initialized = true;
+    }
+
+    while (nplans > 0 && result->m_rows < BatchMaxSize) {
+        int winner = node->ms_tree[0];
+        int runner = -1;
+        VectorBatch* batch = node->ms_batches[winner];
+        int start;
+        int end;
+        int limit;
+
+        /* All the subplans are exhausted */
+        if (batch == NULL)
+            break;
+
+        /* The runner-up is the best of the losers met on the winner's path */
+        for (int t = (winner + nplans) / 2; t > 0; t /= 2) {
+            int loser = node->ms_tree[t];
+            if (node->ms_batches[loser] == NULL)
+                continue;
+            if (runner == -1 || vec_merge_beats(node, loser, runner))
+                runner = loser;
+        }
+
+        /*
+         * Copy out the run of winner rows that still sort before the
+         * runner-up's current row.
+         */
+        start = node->ms_cursors[winner];
+        limit = Min(batch->m_rows, start + BatchMaxSize - result->m_rows);
+        end = start + 1;
+        if (runner == -1) {
+            end = limit;
+        } else {
+            int runner_row = node->ms_cursors[runner];
+            while (end < limit) {
+                int32 compare = vec_merge_compare_rows(node, winner, end, runner, runner_row);
+                if (compare > 0 || (compare == 0 && winner > runner))
+                    break;
+                end++;
+            }
+        }
+
+        result->Copy<true, true>(batch, start, end);
+        node->ms_cursors[winner] = end;
+
+        if (end == batch->m_rows)
+            vec_merge_fetch(node, winner);
+
+        vec_merge_adjust(node, winner);
+    }
+
+    if (BatchIsNull(result))
+        return NULL;
+
+    return result;
+}
+
+/*
+ * Pull the next non-empty batch of a subplan, NULL marks it as exhausted.
+ */
+static void vec_merge_fetch(VecMergeAppendState* node, int plan)
+{
+    VectorBatch* batch = VectorEngine(node->mergeplans[plan]);
+
+    node->ms_batches[plan] = BatchIsNull(batch) ? NULL : batch;
+    node->ms_cursors[plan] = 0;
+}
+
+/*
+ * Replay the matches of a player from its leaf up to the root, after its
+ * current row has changed. The loser of each match stays in the tree.
+ */
+static void vec_merge_adjust(VecMergeAppendState* node, int plan)
+{
+    int* tree = node->ms_tree;
+    int winner = plan;
+
+    for (int t = (plan + node->ms_nplans) / 2; t > 0; t /= 2) {
+        if (vec_merge_beats(node, tree[t], winner)) {
+            int tmp = tree[t];
+            tree[t] = winner;
+            winner = tmp;
+        }
+    }
+    tree[0] = winner;
+}
+
+/*
+ * Does player plan1 sort before player plan2? The virtual player ms_nplans
+ * beats everybody, an exhausted subplan loses against everybody, and ties
+ * go to the lower subplan number to keep the merge stable.
+ */
+static bool vec_merge_beats(VecMergeAppendState* node, int plan1, int plan2)
+{
+    int nplans = node->ms_nplans;
+    bool empty1 = false;
+    bool empty2 = false;
+    int32 compare;
+
+    if (plan1 == nplans)
+        return true;
+    if (plan2 == nplans)
+        return false;
+
+    empty1 = (node->ms_batches[plan1] == NULL);
+    empty2 = (node->ms_batches[plan2] == NULL);
+    if (empty1 || empty2) {
+        if (empty1 && empty2)
+            return plan1 < plan2;
+        return empty2;
+    }
+
+    compare = vec_merge_compare_rows(node, plan1, node->ms_cursors[plan1], plan2, node->ms_cursors[plan2]);
+    if (compare != 0)
+        return compare < 0;
+
+    return plan1 < plan2;
+}
+
+/*
+ * Compare row1 of the current batch of plan1 with row2 of the current batch
+ * of plan2 on the merge keys.
+ */
+static int32 vec_merge_compare_rows(VecMergeAppendState* node, int plan1, int row1, int plan2, int row2)
+{
+    VectorBatch* batch1 = node->ms_batches[plan1];
+    VectorBatch* batch2 = node->ms_batches[plan2];
+
+    for (int nkey = 0; nkey < node->ms_nkeys; nkey++) {
+        SortSupport sortKey = node->ms_sortkeys + nkey;
+        int col = sortKey->ssup_attno - 1;
+        ScalarVector* vec1 = &batch1->m_arr[col];
+        ScalarVector* vec2 = &batch2->m_arr[col];
+        ScalarValue val1 = vec1->m_vals[row1];
+        ScalarValue val2 = vec2->m_vals[row2];
+        bool isNull1 = IS_NULL(vec1->m_flag[row1]);
+        bool isNull2 = IS_NULL(vec2->m_flag[row2]);
+        Datum datum1 = val1;
+        Datum datum2 = val2;
+        int32 compare;
+
+        /* convert vector datum to row datum, the same way as batchsort does */
+        switch (vec1->m_desc.typeId) {
+            case TIMETZOID:
+            case INTERVALOID:
+            case TINTERVALOID:
+            case NAMEOID:
+            case MACADDROID:
+                datum1 = isNull1 ? 0 : PointerGetDatum((char*)val1 + VARHDRSZ_SHORT);
+                datum2 = isNull2 ? 0 : PointerGetDatum((char*)val2 + VARHDRSZ_SHORT);
+                break;
+            case TIDOID:
+                datum1 = isNull1 ? 0 : PointerGetDatum(&val1);
+                datum2 = isNull2 ? 0 : PointerGetDatum(&val2);
+                break;
+            default:
+                break;
+        }
+
+        compare = ApplySortComparator(datum1, isNull1, datum2, isNull2, sortKey);
+        if (compare != 0)
+            return compare;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecEndVecMergeAppend
+ *
+ *		Shuts down the subscans of the MergeAppend node.
+ * ----------------------------------------------------------------
+ */
+void ExecEndVecMergeAppend(VecMergeAppendState* node)
+{
+    ExecEndMergeAppend(node);
+}
+
+/* ----------------------------------------------------------------
+ *		ExecReScanVecMergeAppend
+ *
+ *		Rescan the MergeAppend node.
+ * ----------------------------------------------------------------
+ */
+void ExecReScanVecMergeAppend(VecMergeAppendState* node)
+{
+    int i;
+
+    for (i = 0; i < node->ms_nplans; i++) {
+        PlanState* subnode = node->mergeplans[i];
+
+        /*
+         * ExecReScan doesn't know about my subplans, so I have to do
+         * changed-parameter signaling myself.
+         */
+        if (node->ps.chgParam != NULL)
+            UpdateChangedParamSet(subnode, node->ps.chgParam);
+
+        /*
+         * If chgParam of subnode is not null then plan will be re-scanned by
+         * first ExecProcNode.
+         */
+        if (subnode->chgParam == NULL)
+            VecExecReScan(subnode);
+    }
+    node->ms_initialized = false;
+}
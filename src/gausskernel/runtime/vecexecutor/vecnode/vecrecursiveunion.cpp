@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ * vecrecursiveunion.cpp
+ *    routines to handle vectorized RecursiveUnion nodes.
+ *
+ * IDENTIFICATION
+ *        Code/src/gausskernel/runtime/vecexecutor/vecnode/vecrecursiveunion.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+/* INTERFACE ROUTINES
+ *		ExecInitVecRecursiveUnion	- initialize the RecursiveUnion node
+ *		ExecVecRecursiveUnion		- retrieve the next batch from the node
+ *		ExecEndVecRecursiveUnion	- shut down the RecursiveUnion node
+ *		ExecReScanVecRecursiveUnion - rescan the RecursiveUnion node
+ *
+ *	 NOTES
+ *		This implementation follows the same logic as row based recursive
+ *		union, see notes in nodeRecursiveunion.cpp. The working table and
+ *		the intermediate table are batch stores, so the recursive term scans
+ *		the previous iteration batch by batch through VecWorkTableScan.
+ *
+ *		Only UNION ALL is handled here, the planner keeps UNION and the
+ *		distributed (stream) recursive union on the row engine.
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "executor/execdebug.h"
+#include "utils/batchstore.h"
+#include "vecexecutor/vecrecursiveunion.h"
+#include "vecexecutor/vecexecutor.h"
+
+/*
+ * Create an empty batch store holding batches of the node's result type.
+ */
+static BatchStore* vec_recursive_union_begin_store(VecRecursiveUnionState* node)
+{
+    Plan* plan = node->ps.plan;
+    BatchStore* store = batchstore_begin_heap(ExecGetResultType(&node->ps),
+        false,
+        false,
+        u_sess->attr.attr_memory.work_mem,
+        0,
+        plan->plan_node_id,
+        SET_DOP(plan->dop));
+
+    /* column info lives as long as the store, which is recreated on every iteration */
+    MemoryContext old_context = MemoryContextSwitchTo(store->m_storecontext);
+    VectorBatch* template_batch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, ExecGetResultType(&node->ps));
+    store->InitColInfo(template_batch);
+    (void)MemoryContextSwitchTo(old_context);
+
+    return store;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecVecRecursiveUnion
+ *
+ *		Scans the recursive query sequentially and returns the next
+ *		batch.
+ * ----------------------------------------------------------------
+ */
+VectorBatch* ExecVecRecursiveUnion(VecRecursiveUnionState* node)
+{
+    PlanState* outer_plan = outerPlanState(node);
+    PlanState* inner_plan = innerPlanState(node);
+    RecursiveUnion* plan = (RecursiveUnion*)node->ps.plan;
+    VectorBatch* batch = NULL;
+
+    /* 1. Evaluate non-recursive term */
+    if (!node->recursing) {
+        batch = VectorEngine(outer_plan);
+        if (!BatchIsNull(batch)) {
+            /* Each batch goes to the working table ... */
+            batchstore_putbatch(node->working_batchstore, batch);
+
+            /* ... and to the caller */
+            return batch;
+        }
+
+        node->recursing = true;
+    }
+
+    /* 2. Execute recursive term */
+    /* Inner plan of RecursiveUnion need rescan, skip early free. */
+    bool orig_early_free = inner_plan->state->es_skip_early_free;
+    inner_plan->state->es_skip_early_free = true;
+
+    for (;;) {
+        batch = VectorEngine(inner_plan);
+        if (BatchIsNull(batch)) {
+            /* Done if there's nothing in the intermediate table */
+            if (node->intermediate_empty)
+                break;
+
+            /* done with old working table ... */
+            batchstore_end(node->working_batchstore);
+
+            /* intermediate table becomes working table */
+            node->working_batchstore = node->intermediate_batchstore;
+
+            /* create new empty intermediate table */
+            node->intermediate_batchstore = vec_recursive_union_begin_store(node);
+            node->intermediate_empty = true;
+            node->iteration++;
+
+            /* reset the recursive term */
+            inner_plan->chgParam = bms_add_member(inner_plan->chgParam, plan->wtParam);
+
+            /* and continue fetching from recursive term */
+            continue;
+        }
+
+        /* Else, batch is good; stash it in intermediate table ... */
+        node->intermediate_empty = false;
+        batchstore_putbatch(node->intermediate_batchstore, batch);
+
+        /* ... and return it */
+        inner_plan->state->es_skip_early_free = orig_early_free;
+        return batch;
+    }
+
+    inner_plan->state->es_skip_early_free = orig_early_free;
+
+    return NULL;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecInitVecRecursiveUnion
+ * ----------------------------------------------------------------
+ */
+VecRecursiveUnionState* ExecInitVecRecursiveUnion(VecRecursiveUnion* node, EState* estate, int eflags)
+{
+    /* check for unsupported flags */
+    Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
+
+    /* UNION needs the hash table of the row engine */
+    Assert(node->numCols == 0);
+
+    /*
+     * create state structure
+     */
+    VecRecursiveUnionState* rustate = makeNode(VecRecursiveUnionState);
+    rustate->ps.plan = (Plan*)node;
+    rustate->ps.state = estate;
+    rustate->ps.vectorized = true;
+
+    /* initialize processing state */
+    rustate->recursing = false;
+    rustate->intermediate_empty = true;
+    rustate->iteration = 0;
+
+    /*
+     * Make the state structure available to descendant WorkTableScan nodes
+     * via the Param slot reserved for it.
+     */
+    ParamExecData* prmdata = &(estate->es_param_exec_vals[node->wtParam]);
+    Assert(prmdata->execPlan == NULL);
+    prmdata->value = PointerGetDatum(rustate);
+    prmdata->isnull = false;
+
+    /*
+     * Miscellaneous initialization
+     *
+     * RecursiveUnion plans don't have expression contexts because they never
+     * call ExecQual or ExecProject.
+     */
+    Assert(node->plan.qual == NIL);
+
+    ExecInitResultTupleSlot(estate, &rustate->ps);
+
+    /*
+     * Initialize result tuple type. (Note: we have to set up the result type
+     * before initializing child nodes, because vecworktablescan.cpp expects
+     * it to be valid.)
+     */
+    ExecAssignResultTypeFromTL(&rustate->ps);
+    rustate->ps.ps_ProjInfo = NULL;
+
+    rustate->working_batchstore = vec_recursive_union_begin_store(rustate);
+    rustate->intermediate_batchstore = vec_recursive_union_begin_store(rustate);
+
+    /*
+     * initialize child nodes
+     */
+    outerPlanState(rustate) = ExecInitNode(outerPlan(node), estate, eflags);
+    innerPlanState(rustate) = ExecInitNode(innerPlan(node), estate, eflags);
+
+    if (HAS_INSTR(rustate, true)) {
+        errno_t rc =
+            memset_s(&((rustate->ps.instrument)->recursiveInfo), sizeof(RecursiveInfo), 0, sizeof(RecursiveInfo));
+        securec_check(rc, "\0", "\0");
+    }
+
+    return rustate;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecEndVecRecursiveUnion
+ *
+ *		frees any storage allocated through C routines.
+ * ----------------------------------------------------------------
+ */
+void ExecEndVecRecursiveUnion(VecRecursiveUnionState* node)
+{
+    /* Release batch stores */
+    batchstore_end(node->working_batchstore);
+    batchstore_end(node->intermediate_batchstore);
+
+    /*
+     * close down subplans
+     */
+    ExecEndNode(outerPlanState(node));
+    ExecEndNode(innerPlanState(node));
+}
+
+/* ----------------------------------------------------------------
+ *		ExecReScanVecRecursiveUnion
+ *
+ *		Rescans the relation.
+ * ----------------------------------------------------------------
+ */
+void ExecReScanVecRecursiveUnion(VecRecursiveUnionState* node)
+{
+    PlanState* outer_plan = outerPlanState(node);
+    PlanState* inner_plan = innerPlanState(node);
+    RecursiveUnion* plan = (RecursiveUnion*)node->ps.plan;
+
+    /*
+     * Set recursive term's chgParam to tell it that we'll modify the working
+     * table and therefore it has to rescan.
+     */
+    inner_plan->chgParam = bms_add_member(inner_plan->chgParam, plan->wtParam);
+
+    /*
+     * if chgParam of subnode is not null then plan will be re-scanned by
+     * first ExecProcNode. Because of above, we only have to do this to the
+     * non-recursive term.
+     */
+    if (outer_plan->chgParam == NULL)
+        VecExecReScan(outer_plan);
+
+    /* reset processing state, batch stores have no way to be cleared */
+    node->recursing = false;
+    node->intermediate_empty = true;
+    node->iteration = 0;
+    batchstore_end(node->working_batchstore);
+    batchstore_end(node->intermediate_batchstore);
+    node->working_batchstore = vec_recursive_union_begin_store(node);
+    node->intermediate_batchstore = vec_recursive_union_begin_store(node);
+}
@@ -56,6 +56,9 @@
 #include "vecexecutor/vecnodevectorow.h"
 #include "vecexecutor/vecnodedfsindexscan.h"
 #include "vecexecutor/vecwindowagg.h"
+#include "vecexecutor/vecmergeappend.h"
+#include "vecexecutor/vecrecursiveunion.h"
+#include "vecexecutor/vecworktablescan.h"
 
 /*
  * VecExecReScan
@@ -213,6 +216,15 @@ void VecExecReScan(PlanState* node)
         case T_VecWindowAggState:
             ExecReScanVecWindowAgg((VecWindowAggState*)node);
             break;
+        case T_VecMergeAppendState:
+            ExecReScanVecMergeAppend((VecMergeAppendState*)node);
+            break;
+        case T_VecRecursiveUnionState:
+            ExecReScanVecRecursiveUnion((VecRecursiveUnionState*)node);
+            break;
+        case T_VecWorkTableScanState:
+            ExecReScanVecWorkTableScan((VecWorkTableScanState*)node);
+            break;
         default:
             ereport(ERROR,
                 (errcode(ERRCODE_UNRECOGNIZED_NODE_TYPE),
@@ -28,10 +28,16 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
+#include "access/cstoreskey.h"
+#include "access/nbtree.h"
+#include "catalog/pg_am.h"
+#include "commands/defrem.h"
 #include "executor/execdebug.h"
 #include "executor/executor.h"
 #include "nodes/execnodes.h"
+#include "nodes/nodeFuncs.h"
 #include "utils/batchsort.h"
+#include "utils/lsyscache.h"
 #include "vecexecutor/vecnodes.h"
 #include "vecexecutor/vecnodesort.h"
 #include "vecexecutor/vecexecutor.h"
@@ -51,6 +57,70 @@ typedef int (*LLVM_CMC_func)(const MultiColumns* a, const MultiColumns* b, Batch
  */
 bool MatchLimitNode(Sort* node, Plan* plan_tree);
 
+/*
+ * @Description	: Publish the boundary of the bounded heap to the CStoreScan
+ *				  right below the sort, so that it skips the CUs whose min/max
+ *				  of the leading sort key can not beat the boundary.
+ * @in node		: Current sort node information.
+ * @return		: The boundary to refresh while feeding the sort, or NULL.
+ */
+static CStoreScanTopNBound* PushDownTopNBound(VecSortState* node)
+{
+    Sort* plan_node = (Sort*)node->ss.ps.plan;
+    PlanState* outer_node = outerPlanState(node);
+    Oid opfamily;
+    Oid opcintype;
+    int16 strategy;
+
+    if (!IsA(outer_node, CStoreScanState)) {
+        return NULL;
+    }
+
+    /* the leading sort key must be a plain user column of the scanned relation */
+    CStoreScanState* scan_state = (CStoreScanState*)outer_node;
+    TargetEntry* tle = (TargetEntry*)list_nth(outer_node->plan->targetlist, plan_node->sortColIdx[0] - 1);
+    if (tle == NULL || !IsA(tle->expr, Var) || ((Var*)tle->expr)->varattno <= 0) {
+        return NULL;
+    }
+
+    AttrNumber attno = ((Var*)tle->expr)->varattno;
+    Form_pg_attribute attr = scan_state->ss_currentRelation->rd_att->attrs[attno - 1];
+
+    /* min/max of CU is kept by the default btree ordering of the column type */
+    if (!get_ordering_op_properties(plan_node->sortOperators[0], &opfamily, &opcintype, &strategy)) {
+        return NULL;
+    }
+    Oid opclass = GetDefaultOpClass(attr->atttypid, BTREE_AM_OID);
+    if (!OidIsValid(opclass) || get_opclass_family(opclass) != opfamily) {
+        return NULL;
+    }
+
+    CStoreScanTopNBound* bound = scan_state->m_topnBound;
+    if (bound == NULL) {
+        bound = (CStoreScanTopNBound*)palloc0(sizeof(CStoreScanTopNBound));
+        scan_state->m_topnBound = bound;
+    }
+
+    /*
+     * With a single sort key a value could enter the heap only if it sorts
+     * before the boundary. With more keys a row tied with the boundary on the
+     * leading key may still win on the others, so only the CUs strictly behind
+     * the boundary could be skipped.
+     */
+    bound->attno = attno;
+    if (plan_node->numCols > 1) {
+        bound->strategy =
+            (strategy == BTLessStrategyNumber) ? CStoreLessEqualStrategyNumber : CStoreGreaterEqualStrategyNumber;
+    } else {
+        bound->strategy = (strategy == BTLessStrategyNumber) ? CStoreLessStrategyNumber : CStoreGreaterStrategyNumber;
+    }
+    bound->collation = plan_node->collations[0];
+    bound->nullsFirst = plan_node->nullsFirst[0];
+    bound->valid = false;
+
+    return bound;
+}
+
 /* ----------------------------------------------------------------
  *
  *              ExecVecSort
@@ -142,6 +212,8 @@ VectorBatch* ExecVecSort(VecSortState* node)
             batch_sort_stat->InitColInfo(node->m_pCurrentBatch);
         }
 
+        CStoreScanTopNBound* topn_bound = node->bounded ? PushDownTopNBound(node) : NULL;
+
         /*
          * Scan the subplan and feed all the tuples to tuplesort.
          *
@@ -161,6 +233,11 @@ VectorBatch* ExecVecSort(VecSortState* node)
 
             batch_sort_stat->sort_putbatch(batch_sort_stat, batch, 0, batch->m_rows);
 
+            /* refresh the boundary for the scan below, the heap may have changed */
+            if (topn_bound != NULL) {
+                topn_bound->valid = batchsort_get_bound_value(batch_sort_stat, &topn_bound->value, &topn_bound->isnull);
+            }
+
             /* sql active feature */
             if (batch_sort_stat->m_tapeset) {
                 long currentFileBlocks = LogicalTapeSetBlocks(batch_sort_stat->m_tapeset);
@@ -174,6 +251,11 @@ VectorBatch* ExecVecSort(VecSortState* node)
             }
         }
 
+        /* the boundary points into the heap, which is going to be sorted */
+        if (topn_bound != NULL) {
+            topn_bound->valid = false;
+        }
+
         /*
          * Cache peak memory info into SortState for display of explain analyze here
          * to ensure correct peak memory log for external sort cases.
@@ -557,44 +639,61 @@ void ExecEarlyFreeVecSort(VecSortState* node)
 }
 
 /*
- * @Description	: Check if there is a limit node on the up level of current sort node.
- * @in node		: Current sort node.
- * @in plantree	: The whole plan tree pushed down into the datanode.
- * @retun		: Return true if the parent node of current sort node is limit.
+ * @Description	: Find the plan node with the given plan_node_id.
+ * @in plan_tree	: The plan tree to search.
+ * @in plan_node_id: The plan_node_id to find.
+ * @return		: The plan node found, or NULL.
  */
-bool MatchLimitNode(Sort* node, Plan* plan_tree)
+static Plan* FindPlanNode(Plan* plan_tree, int plan_node_id)
 {
-    bool be_matched = false;
+    Plan* result = NULL;
 
-    /* return back if current node is NULL */
-    if (plan_tree == NULL) {
-        return false;
+    /* plan_node_id of a child is always bigger than the one of its parent */
+    if (plan_tree == NULL || plan_tree->plan_node_id > plan_node_id) {
+        return NULL;
     }
 
-    /* no need to match if current node's plan_node_id is bigger than the sort's
-     * plan_node_id.
-     */
-    if (plan_tree->plan_node_id > node->plan.plan_node_id) {
-        return false;
+    if (plan_tree->plan_node_id == plan_node_id) {
+        return plan_tree;
     }
 
-    /* If current node's plan_node_id equals to the sort's parent node id and
-     * current node is VecLimit, return true, else traversal left-substree and
-     * right-subtree until match the limit node.
-     */
-    if (plan_tree->plan_node_id == node->plan.parent_node_id && nodeTag(plan_tree) == T_VecLimit) {
-        return true;
+    if (IsA(plan_tree, VecMergeAppend)) {
+        ListCell* lc = NULL;
+        foreach (lc, ((MergeAppend*)plan_tree)->mergeplans) {
+            result = FindPlanNode((Plan*)lfirst(lc), plan_node_id);
+            if (result != NULL) {
+                return result;
+            }
+        }
+        return NULL;
     }
 
-    /* visit left-subtree only when it is not null. */
-    if (plan_tree->lefttree) {
-        be_matched = MatchLimitNode(node, plan_tree->lefttree);
+    result = FindPlanNode(plan_tree->lefttree, plan_node_id);
+    if (result == NULL) {
+        result = FindPlanNode(plan_tree->righttree, plan_node_id);
     }
 
-    /* try to visit right-subtree when no match node is found. */
-    if (!be_matched) {
-        be_matched = MatchLimitNode(node, plan_tree->righttree);
+    return result;
+}
+
+/*
+ * @Description	: Check if there is a limit node on the up level of current sort node.
+ *				  As pass_down_bound does, we look through a MergeAppend and a
+ *				  Result without set returning functions in between, the bound
+ *				  of the limit is passed down to the sort in those cases.
+ * @in node		: Current sort node.
+ * @in plantree	: The whole plan tree pushed down into the datanode.
+ * @retun		: Return true if the sort node is bounded by a limit node.
+ */
+bool MatchLimitNode(Sort* node, Plan* plan_tree)
+{
+    Plan* parent = FindPlanNode(plan_tree, node->plan.parent_node_id);
+
+    while (parent != NULL && parent->plan_node_id != parent->parent_node_id &&
+           (IsA(parent, VecMergeAppend) ||
+               (IsA(parent, VecResult) && !expression_returns_set((Node*)parent->targetlist)))) {
+        parent = FindPlanNode(plan_tree, parent->parent_node_id);
     }
 
-    return be_matched;
+    return parent != NULL && IsA(parent, VecLimit);
 }
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ * vecworktablescan.cpp
+ *    routines to handle vectorized WorkTableScan nodes.
+ *
+ * IDENTIFICATION
+ *        Code/src/gausskernel/runtime/vecexecutor/vecnode/vecworktablescan.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+/* INTERFACE ROUTINES
+ *		ExecInitVecWorkTableScan	- initialize the WorkTableScan node
+ *		ExecVecWorkTableScan		- retrieve the next batch from the worktable
+ *		ExecEndVecWorkTableScan		- shut down the WorkTableScan node
+ *		ExecReScanVecWorkTableScan	- rescan the WorkTableScan node
+ *
+ *	 NOTES
+ *		The worktable is the working batch store of the ancestor
+ *		VecRecursiveUnion, see notes in nodeWorktablescan.cpp.
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "executor/execdebug.h"
+#include "executor/nodeWorktablescan.h"
+#include "utils/batchstore.h"
+#include "vecexecutor/vecworktablescan.h"
+#include "vecexecutor/vecexecutor.h"
+
+/* ----------------------------------------------------------------
+ *		vec_work_table_scan_next
+ *
+ *		This is a workhorse for ExecVecWorkTableScan
+ * ----------------------------------------------------------------
+ */
+static VectorBatch* vec_work_table_scan_next(VecWorkTableScanState* node)
+{
+    /*
+     * As in the row engine, backward scan is not supported and this node is
+     * the only reader of the worktable, so the default read pointer is used.
+     * The batch is private to this node since ExecVecScan may pack it.
+     */
+    Assert(ScanDirectionIsForward(node->ss.ps.state->es_direction));
+
+    BatchStore* batch_store = ((VecRecursiveUnionState*)node->rustate)->working_batchstore;
+
+    if (!batchstore_getbatch(batch_store, true, node->m_pScanBatch))
+        return NULL;
+
+    return node->m_pScanBatch;
+}
+
+/*
+ * vec_work_table_scan_recheck -- access method routine to recheck a tuple in EvalPlanQual
+ */
+static bool vec_work_table_scan_recheck(VecWorkTableScanState* node, VectorBatch* batch)
+{
+    /* nothing to check */
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecVecWorkTableScan(node)
+ *
+ *		Scans the worktable sequentially and returns the next qualifying
+ *		batch.
+ * ----------------------------------------------------------------
+ */
+VectorBatch* ExecVecWorkTableScan(VecWorkTableScanState* node)
+{
+    /*
+     * On the first call, find the ancestor RecursiveUnion's state via the
+     * Param slot reserved for it. (We can't do this during node init because
+     * there are corner cases where we'll get the init call before the
+     * RecursiveUnion does.)
+     */
+    if (node->rustate == NULL) {
+        WorkTableScan* plan = (WorkTableScan*)node->ss.ps.plan;
+        EState* estate = node->ss.ps.state;
+        ParamExecData* param = &(estate->es_param_exec_vals[plan->wtParam]);
+
+        Assert(param->execPlan == NULL);
+        Assert(!param->isnull);
+        node->rustate = (RecursiveUnionState*)DatumGetPointer(param->value);
+        Assert(node->rustate && IsA(node->rustate, VecRecursiveUnionState));
+
+        /*
+         * The scan tuple type is the same as the result rowtype of the
+         * ancestor RecursiveUnion node, and so is the layout of the batches
+         * in its working table.
+         */
+        TupleDesc tuple_desc = ExecGetResultType(&node->rustate->ps);
+        ExecAssignScanType(&node->ss, tuple_desc);
+        node->m_pScanBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, tuple_desc);
+
+        /*
+         * Now we can initialize the projection info.  This must be completed
+         * before we can call ExecVecScan().
+         */
+        ExecAssignVecScanProjectionInfo(&node->ss);
+    }
+
+    return ExecVecScan(&node->ss,
+        (ExecVecScanAccessMtd)vec_work_table_scan_next,
+        (ExecVecScanRecheckMtd)vec_work_table_scan_recheck);
+}
+
+/* ----------------------------------------------------------------
+ *		ExecInitVecWorkTableScan
+ * ----------------------------------------------------------------
+ */
+VecWorkTableScanState* ExecInitVecWorkTableScan(VecWorkTableScan* node, EState* estate, int eflags)
+{
+    /* check for unsupported flags */
+    Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
+
+    /*
+     * WorkTableScan should not have any children.
+     */
+    Assert(outerPlan(node) == NULL);
+    Assert(innerPlan(node) == NULL);
+
+    /*
+     * create new WorkTableScanState for node
+     */
+    VecWorkTableScanState* scan_state = makeNode(VecWorkTableScanState);
+
+    scan_state->ss.ps.plan = (Plan*)node;
+    scan_state->ss.ps.state = estate;
+    scan_state->ss.ps.vectorized = true;
+    scan_state->rustate = NULL; /* we'll set this later */
+    scan_state->m_pScanBatch = NULL;
+
+    /*
+     * Miscellaneous initialization
+     *
+     * create expression context for node
+     */
+    ExecAssignExprContext(estate, &scan_state->ss.ps);
+
+    /*
+     * initialize child expressions
+     */
+    scan_state->ss.ps.targetlist =
+        (List*)ExecInitVecExpr((Expr*)node->scan.plan.targetlist, (PlanState*)scan_state);
+    scan_state->ss.ps.qual = (List*)ExecInitVecExpr((Expr*)node->scan.plan.qual, (PlanState*)scan_state);
+
+    /*
+     * tuple table initialization
+     */
+    ExecInitResultTupleSlot(estate, &scan_state->ss.ps);
+    ExecInitScanTupleSlot(estate, &scan_state->ss);
+
+    /*
+     * Initialize result tuple type, but not yet projection info.
+     */
+    ExecAssignResultTypeFromTL(&scan_state->ss.ps);
+
+    scan_state->ss.ps.ps_TupFromTlist = false;
+
+    // Allocate vector for qualification results
+    //
+    ExecAssignVectorForExprEval(scan_state->ss.ps.ps_ExprContext);
+
+    return scan_state;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecEndVecWorkTableScan
+ *
+ *		frees any storage allocated through C routines.
+ * ----------------------------------------------------------------
+ */
+void ExecEndVecWorkTableScan(VecWorkTableScanState* node)
+{
+    ExecEndWorkTableScan(node);
+}
+
+/* ----------------------------------------------------------------
+ *		ExecReScanVecWorkTableScan
+ *
+ *		Rescans the relation.
+ * ----------------------------------------------------------------
+ */
+void ExecReScanVecWorkTableScan(VecWorkTableScanState* node)
+{
+    ExecScanReScan(&node->ss);
+
+    /* No need (or way) to rescan if ExecVecWorkTableScan not called yet */
+    if (node->rustate)
+        batchstore_rescan(((VecRecursiveUnionState*)node->rustate)->working_batchstore);
+}
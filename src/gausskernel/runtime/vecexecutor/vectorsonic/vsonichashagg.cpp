@@ -443,6 +443,15 @@ SonicHashAgg::SonicHashAgg(VecAggState* runtime, int arrSize) : SonicHash(arrSiz
     } else {
         m_buildScanBatch = &SonicHashAgg::BuildScanBatchSimple;
     }
+
+    m_adaptive = ExecVecAggIsAdaptive(runtime);
+    m_streaming = false;
+    m_sampled = false;
+    m_flushPending = false;
+    m_inputRows = 0;
+    m_flushTimes = 0;
+    /* streaming hash table keeps its elements and buckets in L2 cache */
+    m_flushRows = Max(ADAPTIVE_AGG_CACHE_SIZE / (m_arrayElementSize + 2 * sizeof(uint32)), BatchMaxSize);
 }
 
 /*
@@ -822,9 +831,11 @@ bool SonicHashAgg::ResetNecessary(VecAggState* node)
      * parameter changes, and none of our own parameter changes affect
      * input expressions of the aggregated functions, then we can just
      * rescan the existing hash table, and have not spill to disk;
-     * no need to build it again.
+     * no need to build it again. The hash table of adaptive hash agg
+     * only has the groups after the last flush, so build it again.
      */
-    if (m_memControl.spillToDisk == false && node->ss.ps.lefttree->chgParam == NULL && agg_node->aggParams == NULL) {
+    if (m_memControl.spillToDisk == false && m_flushTimes == 0 && node->ss.ps.lefttree->chgParam == NULL &&
+        agg_node->aggParams == NULL) {
         m_runState = AGG_FETCH;
         return false;
     }
@@ -873,6 +884,12 @@ bool SonicHashAgg::ResetNecessary(VecAggState* node)
     m_memControl.spillToDisk = false;
     m_strategy = HASH_IN_MEMORY;
 
+    m_streaming = false;
+    m_sampled = false;
+    m_flushPending = false;
+    m_inputRows = 0;
+    m_flushTimes = 0;
+
     return true;
 }
 
@@ -933,7 +950,7 @@ VectorBatch* SonicHashAgg::Run()
                     }
                 }
 
-                if (!m_memControl.spillToDisk) {
+                if (!m_memControl.spillToDisk && !m_flushPending) {
                     /* Early free left tree after hash table built */
                     ExecEarlyFree(outerPlanState(m_runtime));
 
@@ -953,8 +970,12 @@ VectorBatch* SonicHashAgg::Run()
                 res = Probe();
 
                 if (BatchIsNull(res)) {
-                    /* If not matched, turn to next partition */
-                    if (true == m_memControl.spillToDisk) {
+                    if (m_flushPending) {
+                        /* all the groups are flushed, go on building with the rest of input */
+                        resetHashTable(m_streaming ? 2 * m_flushRows : m_hashSize);
+                        m_runState = AGG_BUILD;
+                    } else if (true == m_memControl.spillToDisk) {
+                        /* If not matched, turn to next partition */
                         m_strategy = HASH_IN_DISK;
                         m_runState = AGG_PREPARE;
                     } else {
@@ -979,6 +1000,9 @@ VectorBatch* SonicHashAgg::Run()
 
 /*
  * @Description: get batch from lefttree or temp file and insert into hash table.
+ *
+ * For adaptive hash agg, the build stops when the hash table is full and its
+ * groups are returned to the upper agg instead of spilling, see HashAggRunner::Build.
  */
 void SonicHashAgg::Build()
 {
@@ -996,6 +1020,16 @@ void SonicHashAgg::Build()
         tryExpandHashTable();
 
         (this->*m_buildFun)(outer_batch);
+
+        if (m_adaptive) {
+            m_inputRows += outer_batch->m_rows;
+            if (!m_streaming && (m_flushPending || (!m_sampled && m_inputRows >= ADAPTIVE_AGG_SAMPLE_ROWS))) {
+                adaptiveCheck();
+            }
+            if (m_flushPending) {
+                break;
+            }
+        }
     }
     (void)pgstat_report_waitstatus(oldStatus);
 
@@ -1659,6 +1693,95 @@ void SonicHashAgg::judgeMemoryOverflow(
     }
 }
 
+/*
+ * @Description	: Adaptive hash agg, mark the hash table full when it reaches the
+ *				  streaming size or the operator memory.
+ * @in dop		: query dop of current operator.
+ * @in size_needed	: extra size needed by the last inserted element.
+ */
+void SonicHashAgg::judgeTableFull(int dop, int64 size_needed)
+{
+    int64 used_size = 0;
+    int64 free_size = 0;
+    bool need_flush = false;
+
+    if (m_flushPending) {
+        return;
+    }
+
+    if (m_streaming) {
+        m_flushPending = m_rows >= m_flushRows;
+        return;
+    }
+
+    /* same as judgeMemoryOverflow, a new atom is needed once one is consumed */
+    calcHashContextSize(m_memControl.hashContext, &used_size, &free_size);
+    if (m_rows % (INIT_DATUM_ARRAY_SIZE - 1) != 0) {
+        need_flush = (uint64)used_size > m_memControl.totalMem && free_size < size_needed;
+    } else {
+        need_flush = (uint64)(used_size + m_arrayExpandSize) > m_memControl.totalMem;
+    }
+
+    m_flushPending = need_flush || gs_sysmemory_busy(used_size * dop, false);
+}
+
+/*
+ * @Description	: Adaptive hash agg, check the reduction ratio of the input rows since
+ *				  the hash table is reset, switch to streaming if grouping barely reduces them.
+ */
+void SonicHashAgg::adaptiveCheck()
+{
+    m_sampled = true;
+    if (m_rows <= m_inputRows * ADAPTIVE_AGG_STREAM_RATIO) {
+        return;
+    }
+
+    ereport(LOG,
+        (errmodule(MOD_VEC_EXECUTOR),
+            errmsg("[VecSonicHashAgg(%d)]: %ld groups in %ld rows, switch to streaming with %ld groups.",
+                m_runtime->ss.ps.plan->plan_node_id,
+                m_rows,
+                m_inputRows,
+                m_flushRows)));
+
+    m_streaming = true;
+    m_flushPending = true;
+}
+
+/*
+ * @Description	: Adaptive hash agg, drop the groups that are flushed and build an
+ *				  empty hash table for the rest of input.
+ * @in hashSize	: initial hash size.
+ */
+void SonicHashAgg::resetHashTable(int64 hashSize)
+{
+    MemoryContextResetAndDeleteChildren(m_memControl.hashContext);
+    {
+        AutoContextSwitch memSwitch(m_memControl.hashContext);
+
+        /* reinitialize sonic datum arry */
+        m_arrayElementSize = 0;
+        m_arrayExpandSize = 0;
+        initDataArray();
+
+        m_hashSize = calcHashTableSize<false, false>(hashSize);
+
+        /* reinitialize sonic hash table */
+        initHashTable();
+
+        /* reset runtime build function */
+        BindingFp();
+    }
+
+    m_rows = 0;
+    m_inputRows = 0;
+    m_flushPending = false;
+    m_flushTimes++;
+
+    m_stateLog.restore = false;
+    m_stateLog.lastProcessIdx = 0;
+}
+
 /*
  * @Description	: Judge current memory status is allowed for expand hash table or not.
  * @return		: Return true if expand hash table is allowed by memory.
@@ -1805,11 +1928,15 @@ void SonicHashAgg::AllocHashTbl(VectorBatch* batch, int idx, uint32 hashval, int
             int64 size_needed = insertHashTbl(batch, idx, hashval, hashLoc);
 
             /* judge memory status after inserting */
-            judgeMemoryOverflow("VecSonicHashAgg",
-                m_runtime->ss.ps.plan->plan_node_id,
-                SET_DOP(m_runtime->ss.ps.plan->dop),
-                m_runtime->ss.ps.instrument,
-                size_needed);
+            if (m_adaptive) {
+                judgeTableFull(SET_DOP(m_runtime->ss.ps.plan->dop), size_needed);
+            } else {
+                judgeMemoryOverflow("VecSonicHashAgg",
+                    m_runtime->ss.ps.plan->plan_node_id,
+                    SET_DOP(m_runtime->ss.ps.plan->dop),
+                    m_runtime->ss.ps.instrument,
+                    size_needed);
+            }
         } break;
 
         case HASH_IN_DISK: {
@@ -2778,6 +2778,11 @@ void SonicHashJoin::pushDownFilterIfNeed()
     ScalarValue val;
     SonicHashMemPartition* mem_partition = NULL;
 
+    /* The filters of former build are stale, the column scans below read them for each CU. */
+    for (int i = 0; i < list_length(bf_var_list); i++) {
+        bf_array[list_nth_int(m_runtime->bf_runtime.bf_filter_index, i)] = NULL;
+    }
+
     if (u_sess->attr.attr_sql.enable_bloom_filter && MEMORY_HASH == m_strategy && !m_complicatekey &&
         m_rows <= DEFAULT_ORC_BLOOM_FILTER_ENTRIES * 5) {
         Assert(m_probeIdx == 0);
@@ -1078,6 +1078,12 @@ static void slot_deform_tuple(TupleTableSlot* slot, uint32 natts)
      */
     attnum = slot->tts_nvalid;
     if (attnum == 0) {
+        /* Use the LLVM deform function specialized for this descriptor if we have one */
+        if (slot->tts_jitted_deform != NULL) {
+            slot->tts_jitted_deform(slot, (int)natts);
+            return;
+        }
+
         /* Start from the first attribute */
         off = 0;
         slow = false;
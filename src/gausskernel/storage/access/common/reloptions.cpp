@@ -63,6 +63,8 @@ static void ValidateStrOptSpcFileSystem(const char* val);
 static void ValidateStrOptSpcAddress(const char* val);
 static void ValidateStrOptSpcCfgPath(const char* val);
 static void ValidateStrOptSpcStorePath(const char* val);
+static void ValidateStrOptBloomFilterColumns(const char* val);
+static void ValidateStrOptClusterOrder(const char* val);
 static void check_append_mode(const char* val);
 
 static relopt_bool boolRelOpts[] = {
@@ -355,6 +357,20 @@ static relopt_string string_rel_opts[] = {
         NULL,
         "",
     },
+    {
+        {"bloom_filter_columns", "columns to form bloom filter for each CU of column table", RELOPT_KIND_HEAP},
+        0,
+        true,
+        ValidateStrOptBloomFilterColumns,
+        "",
+    },
+    {
+        {"cluster_order", "order of rows sorted by partial cluster key of column table", RELOPT_KIND_HEAP},
+        0,
+        false,
+        ValidateStrOptClusterOrder,
+        CLUSTER_ORDER_LEXICAL,
+    },
     /* list terminator */
     {{NULL}}};
 
@@ -1349,7 +1365,9 @@ static void tsstore_tbl_check_compression_option(List* options)
 void ForbidToSetOptionsForRowTbl(List* options)
 {
     /* row relation's unsupported options */
-    static const char* unsupported[] = {"max_batchrow", "deltarow_threshold", "partial_cluster_rows", "compresslevel"};
+    static const char* unsupported[] = {
+        "max_batchrow", "deltarow_threshold", "partial_cluster_rows", "compresslevel", "bloom_filter_columns",
+        "cluster_order"};
 
     /* check relation's options for row table */
     ForbidUserToSetUnsupportedOptions(options, unsupported, lengthof(unsupported), "row relation");
@@ -1398,7 +1416,9 @@ void forbid_to_set_options_for_timeseries_tbl(List* options)
 		"max_batchrow",
 		"deltarow_threshold",
 		"partial_cluster_rows",
-		"compresslevel"
+		"compresslevel",
+		"bloom_filter_columns",
+		"cluster_order"
 	};
 
 	ForbidUserToSetUnsupportedOptions(options, unsupported, lengthof(unsupported), "timeseries relation");
@@ -1426,7 +1446,9 @@ void ForbidToSetOptionsForPSort(List* options)
         "autovacuum_vacuum_scale_factor",
         "autovacuum_analyze_scale_factor",
         "security_barrier",
-        "compression"};
+        "compression",
+        "bloom_filter_columns",
+        "cluster_order"};
 
     ForbidUserToSetUnsupportedOptions(options, unsupported, lengthof(unsupported), "psort index");
 }
@@ -1485,6 +1507,8 @@ bytea* default_reloptions(Datum reloptions, bool validate, relopt_kind kind)
         {"ignore_enable_hadoop_env", RELOPT_TYPE_BOOL, offsetof(StdRdOptions, ignore_enable_hadoop_env)},
         {"append_mode", RELOPT_TYPE_STRING, offsetof(StdRdOptions, append_mode)},
         {"merge_list", RELOPT_TYPE_STRING, offsetof(StdRdOptions, merge_list) },
+        {"bloom_filter_columns", RELOPT_TYPE_STRING, offsetof(StdRdOptions, bloom_filter_columns)},
+        {"cluster_order", RELOPT_TYPE_STRING, offsetof(StdRdOptions, cluster_order)},
         {"rel_cn_oid", RELOPT_TYPE_INT, offsetof(StdRdOptions, rel_cn_oid)},
         {"append_mode_internal", RELOPT_TYPE_INT, offsetof(StdRdOptions, append_mode_internal)},
         {"start_ctid_internal", RELOPT_TYPE_STRING, offsetof(StdRdOptions, start_ctid_internal)},
@@ -1772,6 +1796,47 @@ static void ValidateStrOptCompression(const char* val)
                           "\"lz4\" for dfs table.")));
 }
 
+/*
+ * Brief        : Check the syntax of bloom_filter_columns option. Whether the
+ *                columns exist is checked against the relation, see
+ *                CheckCStoreSummaryColumns().
+ * Input        : val, the list of column names separated by comma.
+ * Output       : None.
+ * Return Value : None.
+ * Notes        : None.
+ */
+static void ValidateStrOptBloomFilterColumns(const char* val)
+{
+    List* nameList = NIL;
+    char* rawString = pstrdup(val);
+
+    if (!SplitIdentifierString(rawString, ',', &nameList)) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("invalid list syntax for \"bloom_filter_columns\" option"),
+                errdetail("Valid string is a list of column names separated by comma.")));
+    }
+
+    list_free(nameList);
+    pfree(rawString);
+}
+
+/*
+ * Brief        : Check the cluster_order option.
+ * Input        : val, the option value.
+ * Output       : None.
+ * Return Value : None.
+ * Notes        : None.
+ */
+static void ValidateStrOptClusterOrder(const char* val)
+{
+    if (pg_strcasecmp(val, CLUSTER_ORDER_LEXICAL) != 0 && pg_strcasecmp(val, CLUSTER_ORDER_ZORDER) != 0)
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("invalid string for \"cluster_order\" option"),
+                errdetail("Valid string are \"lexical\" and \"zorder\".")));
+}
+
 /*
  * Brief        : Check the filesystem option for tablespace.
  * Input        : val, the filesystem option value.
@@ -49,6 +49,7 @@
 #include "utils/palloc.h"
 #include "utils/guc.h"
 #include "utils/relmapper.h"
+#include "utils/timestamp.h"
 
 #include "portability/instr_time.h"
 
@@ -92,11 +93,34 @@ static const int32 ITEM_QUQUE_SIZE_RATIO = 10;
 static const uint32 EXIT_WAIT_DELAY = 100; /* 100 us */
 uint32 g_triggeredstate = TRIGGER_NORMAL;
 
+/*
+ * Balancing of the page lines, see BalancePageLines(). It is checked every
+ * BALANCE_CHECK_MASK + 1 records and done once a BALANCE_INTERVAL_MS.
+ */
+static const uint64 BALANCE_CHECK_MASK = 0x3FF;
+static const int BALANCE_INTERVAL_MS = 1000;
+static const uint64 BALANCE_MIN_BACKLOG = 256; /* items waiting on a page line before it is unloaded */
+
+static const uint32 REL_OWNER_MOVED = 0x01; /* the relation has been replayed by another page line */
+
+/* entry of LogDispatcher.relOwners */
+typedef struct RedoRelOwner {
+    RelFileNode rnode;     /* hash key */
+    uint32 slotId;         /* the page line replaying the relation */
+    uint32 flags;
+    XLogRecPtr lastEndPtr; /* end of the last record dispatched for the relation */
+    uint64 recCount;       /* records dispatched for the relation in this balance interval */
+} RedoRelOwner;
+
 typedef void* (*GetStateFunc)(PageRedoWorker* worker);
 
 static void AddSlotToPLSet(uint32);
 static void** CollectStatesFromWorkers(GetStateFunc);
 static void GetSlotIds(XLogReaderState* record, uint32 designatedSlot, bool rnodedispatch);
+static uint32 GetRelSlotId(XLogReaderState* record, const RelFileNode& node);
+static RedoRelOwner* FindRelOwner(XLogReaderState* record, const RelFileNode& node);
+static void AddRelSlotsToPLSet(XLogReaderState* record, const RelFileNode& node);
+static void BalancePageLines();
 static LogDispatcher* CreateDispatcher();
 static void DestroyRecoveryWorkers();
 
@@ -389,6 +413,17 @@ static LogDispatcher* CreateDispatcher()
     newDispatcher->syncExitCount = 0;
 
     pg_atomic_init_u32(&(newDispatcher->standbyState), STANDBY_INITIALIZED);
+
+    HASHCTL ctl;
+    errno_t rc = memset_s(&ctl, sizeof(ctl), 0, sizeof(ctl));
+    securec_check(rc, "\0", "\0");
+    ctl.keysize = sizeof(RelFileNode);
+    ctl.entrysize = sizeof(RedoRelOwner);
+    ctl.hash = tag_hash;
+    ctl.hcxt = ctx;
+    newDispatcher->relOwners =
+        hash_create("Extreme RTO relation owners", 1024, &ctl, HASH_ELEM | HASH_FUNCTION | HASH_SHRCTX);
+    newDispatcher->lastBalanceTime = GetCurrentTimestamp();
     return newDispatcher;
 }
 
@@ -608,6 +643,101 @@ static bool RmgrGistRecordInfoValid(XLogReaderState* record, uint8 minInfo, uint
     return false;
 }
 
+/* Run from the dispatcher thread. */
+static void IssueRedoPrefetch(RedoPrefetchQueue* queue)
+{
+    RedoPrefetchBlock* block = &queue->blocks[queue->head];
+    RedoPerf* redo = &(g_instance.comm_cxt.predo_cxt.redoPf);
+
+    if (PrefetchBufferForRedo(block->rnode, MAIN_FORKNUM, block->blkno)) {
+        redo->prefetch_issued++;
+    } else {
+        redo->prefetch_hit++;
+    }
+    queue->head = (queue->head + 1) % REDO_PREFETCH_QUEUE_SIZE;
+    queue->count--;
+}
+
+/* Run from the dispatcher thread. */
+static bool RecordWillRemoveFiles(XLogReaderState* record)
+{
+    uint32 rmid = XLogRecGetRmid(record);
+
+    return (rmid == RM_SMGR_ID || rmid == RM_DBASE_ID || rmid == RM_TBLSPC_ID || XactWillRemoveRelFiles(record));
+}
+
+/*
+ * Queue the blocks the record will read for prefetching, and prefetch the
+ * queued blocks of the records that are at most recovery_prefetch_distance
+ * ahead of the page workers. Blocks restored from a full-page image or
+ * re-initialized by redo are never read, so they are skipped.
+ *
+ * Run from the dispatcher thread.
+ */
+static void PrefetchRecordBlocks(XLogReaderState* record)
+{
+    RedoPrefetchQueue* queue = &g_dispatcher->prefetch;
+    uint64 distance = (uint64)u_sess->attr.attr_storage.recovery_prefetch_distance * 1024;
+
+    if (distance == 0 || RecordWillRemoveFiles(record)) {
+        /* don't keep unlinked files open, the prefetches were only hints anyway */
+        if (distance != 0) {
+            smgrcloseall();
+        }
+        queue->head = 0;
+        queue->count = 0;
+        return;
+    }
+
+    for (int i = 0; i <= record->max_block_id; i++) {
+        DecodedBkpBlock* block = &record->blocks[i];
+        RedoPrefetchBlock* last = NULL;
+        RedoPrefetchBlock* tail = NULL;
+
+        if (!block->in_use || block->forknum != MAIN_FORKNUM) {
+            continue;
+        }
+        if (block->has_image || (block->flags & BKPBLOCK_WILL_INIT)) {
+            g_instance.comm_cxt.predo_cxt.redoPf.prefetch_skip++;
+            continue;
+        }
+        if (queue->count > 0) {
+            last = &queue->blocks[(queue->head + queue->count - 1) % REDO_PREFETCH_QUEUE_SIZE];
+            if (RelFileNodeEquals(last->rnode, block->rnode) && last->blkno == block->blkno) {
+                continue;
+            }
+        }
+        if (queue->count == REDO_PREFETCH_QUEUE_SIZE) {
+            IssueRedoPrefetch(queue);
+        }
+
+        tail = &queue->blocks[(queue->head + queue->count) % REDO_PREFETCH_QUEUE_SIZE];
+        tail->rnode = block->rnode;
+        tail->blkno = block->blkno;
+        tail->lsn = record->ReadRecPtr;
+        queue->count++;
+    }
+
+    while (queue->count > 0) {
+        if (XLByteLT(queue->limitPtr, queue->blocks[queue->head].lsn)) {
+            XLogRecPtr replayedStart;
+            XLogRecPtr replayedEnd;
+
+            /* asking the workers where they are isn't free, do it at most once per WAL page */
+            if (record->ReadRecPtr - queue->refreshPtr < XLOG_BLCKSZ) {
+                break;
+            }
+            GetReplayedRecPtr(&replayedStart, &replayedEnd);
+            queue->refreshPtr = record->ReadRecPtr;
+            queue->limitPtr = (replayedEnd > MAX_XLOG_REC_PTR - distance) ? MAX_XLOG_REC_PTR : replayedEnd + distance;
+            if (XLByteLT(queue->limitPtr, queue->blocks[queue->head].lsn)) {
+                break;
+            }
+        }
+        IssueRedoPrefetch(queue);
+    }
+}
+
 /* Run from the dispatcher thread. */
 void DispatchRedoRecordToFile(XLogReaderState* record, List* expectedTLIs, TimestampTz recordXTime)
 {
@@ -635,12 +765,16 @@ void DispatchRedoRecordToFile(XLogReaderState* record, List* expectedTLIs, Times
 
         ResetChosedPageLineList();
         pg_atomic_write_u64(&(g_instance.comm_cxt.predo_cxt.endRecPtr), record->EndRecPtr);
+        PrefetchRecordBlocks(record);
         /* RTO_DEMO */
         if (fatalerror != true) {
             g_dispatchTable[rmid].rm_dispatch(record, expectedTLIs, recordXTime);
         } else {
             DispatchDefaultRecord(record, expectedTLIs, recordXTime);
         }
+
+        if ((++g_dispatcher->dispatchedCount & BALANCE_CHECK_MASK) == 0)
+            BalancePageLines();
     } else {
         ereport(PANIC,
             (errmodule(MOD_REDO),
@@ -691,7 +825,8 @@ static void DispatchSyncTxnRecord(
 static void DispatchToOnePageWorker(XLogReaderState* record, const RelFileNode rnode, List* expectedTLIs)
 {
     /* for bcm different attr need to dispath to the same page redo thread */
-    uint32 slotId = GetSlotId(rnode, 0, 0, GetBatchCount());
+    RedoRelOwner* owner = FindRelOwner(record, rnode);
+    uint32 slotId = (owner != NULL) ? owner->slotId : GetSlotId(rnode, 0, 0, GetBatchCount());
     RedoItem* item = GetRedoItemPtr(record);
     ReferenceRedoItem(item);
     AddPageRedoItem(g_dispatcher->pageLines[slotId].batchThd, item);
@@ -813,8 +948,7 @@ static bool DispatchXactRecord(XLogReaderState* record, List* expectedTLIs, Time
                 ColFileNode node;
                 ColFileNodeRel* nodeRel = xnodes + i;
                 ColFileNodeCopy(&node, nodeRel);
-                uint32 id = GetSlotId(node.filenode, 0, 0, GetBatchCount());
-                AddSlotToPLSet(id);
+                AddRelSlotsToPLSet(record, node.filenode);
             }
         } else {
             for (uint32 i = 0; i < g_dispatcher->pageLineNum; i++) {
@@ -956,12 +1090,10 @@ static bool DispatchSmgrRecord(XLogReaderState* record, List* expectedTLIs, Time
         }
     } else if (IsSmgrTruncate(record)) {
         if (SUPPORT_FPAGE_DISPATCH) {
-            uint32 id;
             xl_smgr_truncate* xlrec = (xl_smgr_truncate*)XLogRecGetData(record);
             RelFileNode rnode;
             RelFileNodeCopy(rnode, xlrec->rnode, XLogRecGetBucketId(record));
-            id = GetSlotId(rnode, 0, 0, GetBatchCount());
-            AddSlotToPLSet(id);
+            AddRelSlotsToPLSet(record, rnode);
         } else {
             for (uint32 i = 0; i < g_dispatcher->pageLineNum; i++) {
                 AddSlotToPLSet(i);
@@ -1216,12 +1348,11 @@ static bool DispatchHeap2VacuumHotStandby(XLogReaderState* record, List* expecte
         if (InHotStandby) {
             /* for parallel redo performance */
             if (SUPPORT_FPAGE_DISPATCH) {
-                uint32 id;
                 xl_heap_cleanup_info* xlrec = (xl_heap_cleanup_info*)XLogRecGetData(record);
                 RelFileNode tmp_node;
                 RelFileNodeCopy(tmp_node, xlrec->node, XLogRecGetBucketId(record));
-                id = GetSlotId(tmp_node, 0, 0, GetBatchCount());
-                AddSlotToPLSet(id);
+                RedoRelOwner* owner = FindRelOwner(record, tmp_node);
+                AddSlotToPLSet((owner != NULL) ? owner->slotId : GetSlotId(tmp_node, 0, 0, GetBatchCount()));
             } else {
                 for (uint32 i = 0; i < g_dispatcher->pageLineNum; i++)
                     AddSlotToPLSet(i);
@@ -1317,11 +1448,8 @@ static void GetSlotIds(XLogReaderState* record, uint32 designatedWorker, bool rn
             /* blk number is not continue */
             continue;
         }
-        if (rnodedispatch)
-            id = GetSlotId(block->rnode, 0, 0, GetBatchCount());
-        else
-            id = GetSlotId(block->rnode, block->blkno, 0, GetBatchCount());
-
+        /* a relation is replayed by one page line whether it's dispatched by rnode or by page */
+        id = GetRelSlotId(record, block->rnode);
         AddSlotToPLSet(id);
     }
 
@@ -1336,13 +1464,178 @@ static void GetSlotIds(XLogReaderState* record, uint32 designatedWorker, bool rn
 
 /**
  * count slot id  by hash
+ * the whole relfilenode is hashed, the low bits of relNode alone give no more
+ * than 16 slots and put every relation of the same low bits in one of them
  */
 uint32 GetSlotId(const RelFileNode node, BlockNumber block, ForkNumber forkNum, uint32 workerCount)
 {
     if (workerCount == 0)
         return ANY_WORKER;
 
-    return (node.relNode & 0xF) % workerCount;
+    return tag_hash(&node, sizeof(RelFileNode)) % workerCount;
+}
+
+/*
+ * The page line of a relation. A heap relation starts on the page line of
+ * GetSlotId() and may be moved to another one by BalancePageLines(). Index
+ * relations keep their page line, because the incomplete actions of them are
+ * remembered by the page workers.
+ */
+static uint32 GetRelSlotId(XLogReaderState* record, const RelFileNode& node)
+{
+    RmgrId rmid = XLogRecGetRmid(record);
+    bool isHeap = (rmid == RM_HEAP_ID || rmid == RM_HEAP2_ID || rmid == RM_HEAP3_ID);
+    bool found = false;
+    RedoRelOwner* owner =
+        (RedoRelOwner*)hash_search(g_dispatcher->relOwners, &node, isHeap ? HASH_ENTER : HASH_FIND, &found);
+
+    if (owner == NULL)
+        return GetSlotId(node, 0, 0, GetBatchCount());
+
+    if (!found) {
+        owner->slotId = GetSlotId(node, 0, 0, GetBatchCount());
+        owner->flags = 0;
+        owner->recCount = 0;
+    }
+    owner->lastEndPtr = record->EndRecPtr;
+    owner->recCount++;
+    return owner->slotId;
+}
+
+/* The owner entry of a relation for a record on the whole relation, NULL if it has none. */
+static RedoRelOwner* FindRelOwner(XLogReaderState* record, const RelFileNode& node)
+{
+    RedoRelOwner* owner = (RedoRelOwner*)hash_search(g_dispatcher->relOwners, &node, HASH_FIND, NULL);
+
+    if (owner != NULL)
+        owner->lastEndPtr = record->EndRecPtr;
+    return owner;
+}
+
+/*
+ * Choose the page lines of a record dropping or truncating a relation. Every
+ * page line that has replayed the relation may remember invalid pages of it,
+ * so a relation that has been moved goes to all page lines.
+ */
+static void AddRelSlotsToPLSet(XLogReaderState* record, const RelFileNode& node)
+{
+    RedoRelOwner* owner = FindRelOwner(record, node);
+
+    if (owner == NULL) {
+        AddSlotToPLSet(GetSlotId(node, 0, 0, GetBatchCount()));
+    } else if (owner->flags != 0) {
+        for (uint32 i = 0; i < g_dispatcher->pageLineNum; i++)
+            AddSlotToPLSet(i);
+    } else {
+        AddSlotToPLSet(owner->slotId);
+    }
+}
+
+/* Items queued on the threads of a page line and not replayed yet. */
+static uint64 GetPageLineBacklog(const PageRedoPipeline* pl)
+{
+    uint64 backlog = SPSCGetQueueCount(pl->batchThd->queue) + SPSCGetQueueCount(pl->managerThd->queue);
+
+    for (uint32 i = 0; i < pl->redoThdNum; i++)
+        backlog += SPSCGetQueueCount(pl->redoThd[i]->queue);
+    return backlog;
+}
+
+/*
+ * The end of the records a page line has replayed. It moves when the LSN
+ * forwarder has passed every page worker of the line.
+ */
+static XLogRecPtr GetPageLineCompletedRecPtr(const PageRedoPipeline* pl)
+{
+    XLogRecPtr completedPtr = MAX_XLOG_REC_PTR;
+
+    for (uint32 i = 0; i < pl->redoThdNum; i++) {
+        XLogRecPtr ptr = GetCompletedRecPtr(pl->redoThd[i]);
+        if (XLByteLT(ptr, completedPtr))
+            completedPtr = ptr;
+    }
+    return completedPtr;
+}
+
+/*
+ * Balance the page lines once a BALANCE_INTERVAL_MS. If the page line with
+ * the longest backlog has much more to do than the others, the busiest heap
+ * relation it has replayed every dispatched record of is moved to the page
+ * line with the shortest backlog, so the records of a relation are never
+ * replayed by two page lines at the same time.
+ *
+ * Unlike parallel recovery, a relation can't be moved before its records are
+ * replayed, nor split over the page lines. This thread forwards the LSN
+ * markers that tell how far a page line has replayed, so it can't wait for
+ * them. Only one relation is moved in an interval.
+ */
+static void BalancePageLines()
+{
+    TimestampTz now = GetCurrentTimestamp();
+    uint32 lineCount = g_dispatcher->pageLineNum;
+
+    if (lineCount < 2 || !TimestampDifferenceExceeds(g_dispatcher->lastBalanceTime, now, BALANCE_INTERVAL_MS))
+        return;
+    g_dispatcher->lastBalanceTime = now;
+
+    uint32 busiest = 0;
+    uint32 idlest = 0;
+    uint64 minBacklog = PG_UINT64_MAX;
+    uint64 maxBacklog = 0;
+    for (uint32 i = 0; i < lineCount; i++) {
+        uint64 backlog = GetPageLineBacklog(&g_dispatcher->pageLines[i]);
+
+        if (backlog > maxBacklog) {
+            maxBacklog = backlog;
+            busiest = i;
+        }
+        if (backlog < minBacklog) {
+            minBacklog = backlog;
+            idlest = i;
+        }
+    }
+
+    bool unbalanced = (maxBacklog >= BALANCE_MIN_BACKLOG && maxBacklog > 2 * minBacklog);
+    RedoRelOwner* movable = NULL;
+    HASH_SEQ_STATUS status;
+    RedoRelOwner* owner = NULL;
+
+    hash_seq_init(&status, g_dispatcher->relOwners);
+    while ((owner = (RedoRelOwner*)hash_seq_search(&status)) != NULL) {
+        bool quiescent =
+            XLByteLE(owner->lastEndPtr, GetPageLineCompletedRecPtr(&g_dispatcher->pageLines[owner->slotId]));
+
+        if (owner->recCount == 0 && owner->flags == 0 && quiescent) {
+            /* idle relations go back to GetSlotId(), so forget them */
+            (void)hash_search(g_dispatcher->relOwners, &owner->rnode, HASH_REMOVE, NULL);
+            continue;
+        }
+        if (unbalanced && owner->slotId == busiest && quiescent &&
+            (movable == NULL || owner->recCount > movable->recCount))
+            movable = owner;
+    }
+
+    if (movable != NULL && movable->recCount > 0) {
+        movable->slotId = idlest;
+        movable->flags |= REL_OWNER_MOVED;
+        g_dispatcher->movedRelCount++;
+        ereport(DEBUG1,
+            (errmodule(MOD_REDO),
+                errcode(ERRCODE_LOG),
+                errmsg("[REDO_LOG_TRACE]BalancePageLines: move relation %u/%u/%u from page line %u to %u, "
+                       "backlog:%lu/%lu",
+                    movable->rnode.spcNode,
+                    movable->rnode.dbNode,
+                    movable->rnode.relNode,
+                    busiest,
+                    idlest,
+                    maxBacklog,
+                    minBacklog)));
+    }
+
+    hash_seq_init(&status, g_dispatcher->relOwners);
+    while ((owner = (RedoRelOwner*)hash_seq_search(&status)) != NULL)
+        owner->recCount = 0;
 }
 
 static void AddSlotToPLSet(uint32 id)
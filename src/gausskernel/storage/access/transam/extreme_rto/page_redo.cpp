@@ -708,6 +708,8 @@ bool PageManagerRedoDistributeItems(void** eleArry, uint32 eleNum)
             RedoPageManagerDistributeBlockRecord(hashMap, NULL);
             return true;
         } else if (eleArry[i] == (void*)&g_GlobalLsnForwarder) {
+            /* blocks before the forwarder must reach the workers first, see BalancePageLines() */
+            RedoPageManagerDistributeBlockRecord(hashMap, NULL);
             PageManagerProcLsnForwarder((RedoItem*)eleArry[i]);
             continue;
         }
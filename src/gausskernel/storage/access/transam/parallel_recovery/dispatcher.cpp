@@ -48,6 +48,7 @@
 #include "utils/palloc.h"
 #include "utils/guc.h"
 #include "utils/relmapper.h"
+#include "utils/timestamp.h"
 
 #include "portability/instr_time.h"
 
@@ -94,15 +95,43 @@ static const int XLOG_INFO_SHIFT_SIZE = 4; /* xlog info flag shift size */
 
 static const int32 MAX_PENDING = 1;
 static const int32 MAX_PENDING_STANDBY = 1;
+static const int32 MAX_PENDING_BUSY = 16; /* the batch while every worker has a backlog */
 static const int32 ITEM_QUQUE_SIZE_RATIO = 10;
 
 static const uint32 EXIT_WAIT_DELAY = 100; /* 100 us */
 
+/*
+ * Balancing of the page workers, see BalancePageWorkers(). It is checked
+ * every BALANCE_CHECK_MASK + 1 records and done once a BALANCE_INTERVAL_MS.
+ */
+static const uint64 BALANCE_CHECK_MASK = 0x3FF;
+static const int BALANCE_INTERVAL_MS = 1000;
+static const uint64 BALANCE_MIN_BACKLOG = 256;      /* items waiting on a worker before it is unloaded */
+static const uint64 SPLIT_MIN_RECORDS = 1024;       /* records of a relation in an interval before it is split */
+static const BlockNumber SPLIT_RANGE_BLOCKS = 64;   /* blocks of a split relation given to the same worker */
+static const uint32 BALANCE_WAIT_DELAY = 100;       /* 100 us */
+
+static const uint32 REL_OWNER_MOVED = 0x01; /* the relation has been replayed by another worker */
+static const uint32 REL_OWNER_SPLIT = 0x02; /* the blocks of the relation are spread over all workers */
+
+/* entry of LogDispatcher.relOwners */
+typedef struct RedoRelOwner {
+    RelFileNode rnode;      /* hash key */
+    uint32 workerId;        /* the worker replaying the relation if it isn't split */
+    uint32 flags;
+    XLogRecPtr lastEndPtr;  /* end of the last record dispatched for the relation */
+    uint64 recCount;        /* records dispatched for the relation in this balance interval */
+} RedoRelOwner;
+
 typedef void* (*GetStateFunc)(PageRedoWorker* worker);
 
 static void AddWorkerToSet(uint32);
 static void** CollectStatesFromWorkers(GetStateFunc);
 static void GetWorkerIds(XLogReaderState* record, uint32 designatedWorker, bool rnodedispatch);
+static uint32 GetRelWorkerId(XLogReaderState* record, const RelFileNode& node, BlockNumber blkno);
+static RedoRelOwner* FindRelOwner(XLogReaderState* record, const RelFileNode& node);
+static void AddRelWorkersToSet(XLogReaderState* record, const RelFileNode& node);
+static void BalancePageWorkers(bool dispatching);
 static LogDispatcher* CreateDispatcher();
 static void DestroyRecoveryWorkers();
 
@@ -386,6 +415,17 @@ static LogDispatcher* CreateDispatcher()
     newDispatcher->totalCostTime = 0;
     newDispatcher->txnCostTime = 0;
     newDispatcher->pprCostTime = 0;
+
+    HASHCTL ctl;
+    errno_t rc = memset_s(&ctl, sizeof(ctl), 0, sizeof(ctl));
+    securec_check(rc, "\0", "\0");
+    ctl.keysize = sizeof(RelFileNode);
+    ctl.entrysize = sizeof(RedoRelOwner);
+    ctl.hash = tag_hash;
+    ctl.hcxt = ctx;
+    newDispatcher->relOwners =
+        hash_create("Parallel redo relation owners", 1024, &ctl, HASH_ELEM | HASH_FUNCTION | HASH_SHRCTX);
+    newDispatcher->lastBalanceTime = GetCurrentTimestamp();
     return newDispatcher;
 }
 
@@ -588,6 +628,9 @@ void DispatchRedoRecordToFile(XLogReaderState* record, List* expectedTLIs, Times
         else if (++g_dispatcher->pendingCount >= g_dispatcher->pendingMax)
             ProcessPendingRecords();
 
+        if ((++g_dispatcher->dispatchedCount & BALANCE_CHECK_MASK) == 0)
+            BalancePageWorkers(true);
+
         if (fatalerror == true) {
             /* output panic error info */
             DumpDispatcher();
@@ -652,7 +695,13 @@ static void DispatchSyncTxnRecord(
 static void DispatchToOnePageWorker(XLogReaderState* record, const RelFileNode& rnode, List* expectedTLIs)
 {
     /* for bcm different attr need to dispath to the same page redo thread */
-    uint32 workerId = GetWorkerId(rnode, 0, 0);
+    RedoRelOwner* owner = FindRelOwner(record, rnode);
+    if (owner != NULL && (owner->flags & REL_OWNER_SPLIT)) {
+        DispatchRecordWithoutPage(record, expectedTLIs);
+        return;
+    }
+
+    uint32 workerId = (owner != NULL) ? owner->workerId : GetWorkerId(rnode, 0, 0);
     AddPageRedoItem(g_dispatcher->pageWorkers[workerId], CreateRedoItem(record, 1, ANY_WORKER, expectedTLIs, 0, true));
 }
 
@@ -766,8 +815,7 @@ static bool DispatchXactRecord(XLogReaderState* record, List* expectedTLIs, Time
                 ColFileNode node;
                 ColFileNodeRel* nodeRel = xnodes + i;
                 ColFileNodeCopy(&node, nodeRel);
-                uint32 id = GetWorkerId(node.filenode, 0, 0);
-                AddWorkerToSet(id);
+                AddRelWorkersToSet(record, node.filenode);
             }
         } else {
             for (uint32 i = 0; i < g_dispatcher->pageWorkerCount; i++) {
@@ -926,12 +974,10 @@ static bool DispatchSmgrRecord(XLogReaderState* record, List* expectedTLIs, Time
          */
         /* for parallel performance */
         if (SUPPORT_FPAGE_DISPATCH) {
-            uint32 id;
             xl_smgr_truncate* xlrec = (xl_smgr_truncate*)XLogRecGetData(record);
             RelFileNode rnode;
             RelFileNodeCopy(rnode, xlrec->rnode, XLogRecGetBucketId(record));
-            id = GetWorkerId(rnode, 0, 0);
-            AddWorkerToSet(id);
+            AddRelWorkersToSet(record, rnode);
         } else {
             for (uint32 i = 0; i < g_dispatcher->pageWorkerCount; i++) {
                 AddWorkerToSet(i);
@@ -1186,7 +1232,7 @@ static void GetWorkerIds(XLogReaderState* record, uint32 designatedWorker, bool
             continue;
         }
         if (rnodedispatch)
-            id = GetWorkerId(block->rnode, 0, 0);
+            id = GetRelWorkerId(record, block->rnode, block->blkno);
         else
             id = GetWorkerId(block->rnode, block->blkno, 0);
 
@@ -1216,6 +1262,206 @@ uint32 GetWorkerId(const RelFileNode& node, BlockNumber block, ForkNumber forkNu
     return tag_hash(&tag, sizeof(tag)) % workerCount;
 }
 
+/*
+ * The worker of block blkno of a relation dispatched by relation. A heap
+ * relation starts on the worker of GetWorkerId() and may be moved to another
+ * worker or split by BalancePageWorkers(). The blocks of a split relation are
+ * given out by ranges of SPLIT_RANGE_BLOCKS. Index relations keep their
+ * worker, because the incomplete actions of them are remembered by the worker.
+ */
+static uint32 GetRelWorkerId(XLogReaderState* record, const RelFileNode& node, BlockNumber blkno)
+{
+    RmgrId rmid = XLogRecGetRmid(record);
+    bool isHeap = (rmid == RM_HEAP_ID || rmid == RM_HEAP2_ID);
+    bool found = false;
+    RedoRelOwner* owner =
+        (RedoRelOwner*)hash_search(g_dispatcher->relOwners, &node, isHeap ? HASH_ENTER : HASH_FIND, &found);
+
+    if (owner == NULL)
+        return GetWorkerId(node, 0, 0);
+
+    if (!found) {
+        owner->workerId = GetWorkerId(node, 0, 0);
+        owner->flags = 0;
+        owner->recCount = 0;
+    }
+    owner->lastEndPtr = record->EndRecPtr;
+    owner->recCount++;
+
+    if (owner->flags & REL_OWNER_SPLIT)
+        return GetWorkerId(node, blkno / SPLIT_RANGE_BLOCKS, 0);
+    return owner->workerId;
+}
+
+/* The owner entry of a relation for a record on the whole relation, NULL if it has none. */
+static RedoRelOwner* FindRelOwner(XLogReaderState* record, const RelFileNode& node)
+{
+    RedoRelOwner* owner = (RedoRelOwner*)hash_search(g_dispatcher->relOwners, &node, HASH_FIND, NULL);
+
+    if (owner != NULL)
+        owner->lastEndPtr = record->EndRecPtr;
+    return owner;
+}
+
+/*
+ * Choose the workers of a record dropping or truncating a relation. Every
+ * worker that has replayed the relation may remember invalid pages of it, so
+ * a relation that has been moved or split goes to all workers.
+ */
+static void AddRelWorkersToSet(XLogReaderState* record, const RelFileNode& node)
+{
+    RedoRelOwner* owner = FindRelOwner(record, node);
+
+    if (owner == NULL) {
+        AddWorkerToSet(GetWorkerId(node, 0, 0));
+    } else if (owner->flags != 0) {
+        for (uint32 i = 0; i < g_dispatcher->pageWorkerCount; i++)
+            AddWorkerToSet(i);
+    } else {
+        AddWorkerToSet(owner->workerId);
+    }
+}
+
+/* Items added to a worker and not replayed yet. */
+static uint64 GetWorkerBacklog(PageRedoWorker* worker)
+{
+    uint64 redoCount = worker->statRedoCount;
+    return (worker->statDispatchCount > redoCount) ? (worker->statDispatchCount - redoCount) : 0;
+}
+
+/* Wait until a worker has replayed up to endPtr. */
+static void WaitWorkerReplayed(PageRedoWorker* worker, XLogRecPtr endPtr)
+{
+    ProcessPendingRecords();
+    while (GetCompletedRecPtr(worker) < endPtr) {
+        ApplyReadyTxnLogRecords(g_dispatcher->txnWorker, false);
+        HandleStartupProcInterrupts();
+        pg_usleep(BALANCE_WAIT_DELAY);
+    }
+}
+
+/*
+ * Balance the page workers once a BALANCE_INTERVAL_MS. The redo rate of each
+ * worker is refreshed. When dispatching, the pending items are handed to the
+ * workers in batches while every worker has a backlog, and relations are taken
+ * off the worker with the longest backlog if the others have much less to do:
+ *
+ * If one relation makes at least half of the records of that worker, the
+ * blocks of it are spread over all workers. The records of the relation
+ * already dispatched must be replayed before, so we wait for the worker.
+ *
+ * Otherwise the busiest relation the worker has no record of in its queue is
+ * moved to the worker with the shortest backlog. No waiting is needed.
+ *
+ * Only one relation is taken off in an interval.
+ */
+static void BalancePageWorkers(bool dispatching)
+{
+    TimestampTz now = GetCurrentTimestamp();
+    long secs;
+    int usecs;
+    uint32 workerCount = g_dispatcher->pageWorkerCount;
+
+    if (!TimestampDifferenceExceeds(g_dispatcher->lastBalanceTime, now, BALANCE_INTERVAL_MS))
+        return;
+    TimestampDifference(g_dispatcher->lastBalanceTime, now, &secs, &usecs);
+    g_dispatcher->lastBalanceTime = now;
+
+    uint64 elapsed = (uint64)secs * US_TRANSFER_TO_S + (uint64)usecs;
+    uint32 busiest = 0;
+    uint32 idlest = 0;
+    uint64 minBacklog = PG_UINT64_MAX;
+    uint64 maxBacklog = 0;
+    for (uint32 i = 0; i < workerCount; i++) {
+        PageRedoWorker* worker = g_dispatcher->pageWorkers[i];
+        uint64 redoCount = worker->statRedoCount;
+        uint64 backlog = GetWorkerBacklog(worker);
+
+        if (elapsed > 0)
+            worker->statRedoRate = (redoCount - worker->statRateBaseCount) * US_TRANSFER_TO_S / elapsed;
+        worker->statRateBaseCount = redoCount;
+
+        if (backlog > maxBacklog) {
+            maxBacklog = backlog;
+            busiest = i;
+        }
+        if (backlog < minBacklog) {
+            minBacklog = backlog;
+            idlest = i;
+        }
+    }
+
+    if (!dispatching || workerCount < 2)
+        return;
+
+    int32 basePending = OnHotStandBy() ? MAX_PENDING_STANDBY : MAX_PENDING;
+    g_dispatcher->pendingMax = (minBacklog >= BALANCE_MIN_BACKLOG) ? MAX_PENDING_BUSY : basePending;
+
+    bool unbalanced = (maxBacklog >= BALANCE_MIN_BACKLOG && maxBacklog > 2 * minBacklog);
+    XLogRecPtr completedPtr = GetCompletedRecPtr(g_dispatcher->pageWorkers[busiest]);
+    RedoRelOwner* hottest = NULL;
+    RedoRelOwner* movable = NULL;
+    uint64 busiestCount = 0;
+    HASH_SEQ_STATUS status;
+    RedoRelOwner* owner = NULL;
+
+    hash_seq_init(&status, g_dispatcher->relOwners);
+    while ((owner = (RedoRelOwner*)hash_seq_search(&status)) != NULL) {
+        bool quiescent = (owner->lastEndPtr <= GetCompletedRecPtr(g_dispatcher->pageWorkers[owner->workerId]));
+
+        if (owner->recCount == 0 && owner->flags == 0 && quiescent) {
+            /* idle relations go back to GetWorkerId(), so forget them */
+            (void)hash_search(g_dispatcher->relOwners, &owner->rnode, HASH_REMOVE, NULL);
+            continue;
+        }
+        if (unbalanced && owner->workerId == busiest && !(owner->flags & REL_OWNER_SPLIT)) {
+            busiestCount += owner->recCount;
+            if (hottest == NULL || owner->recCount > hottest->recCount)
+                hottest = owner;
+            if (owner->lastEndPtr <= completedPtr && (movable == NULL || owner->recCount > movable->recCount))
+                movable = owner;
+        }
+    }
+
+    if (hottest != NULL && hottest->recCount >= SPLIT_MIN_RECORDS && hottest->recCount * 2 >= busiestCount) {
+        WaitWorkerReplayed(g_dispatcher->pageWorkers[busiest], hottest->lastEndPtr);
+        hottest->flags |= REL_OWNER_SPLIT;
+        g_dispatcher->splitRelCount++;
+        ereport(LOG,
+            (errmodule(MOD_REDO),
+                errcode(ERRCODE_LOG),
+                errmsg("[REDO_LOG_TRACE]BalancePageWorkers: split relation %u/%u/%u of worker %u, "
+                       "records:%lu of %lu, backlog:%lu",
+                    hottest->rnode.spcNode,
+                    hottest->rnode.dbNode,
+                    hottest->rnode.relNode,
+                    busiest,
+                    hottest->recCount,
+                    busiestCount,
+                    maxBacklog)));
+    } else if (movable != NULL && movable->recCount > 0) {
+        movable->workerId = idlest;
+        movable->flags |= REL_OWNER_MOVED;
+        g_dispatcher->movedRelCount++;
+        ereport(DEBUG1,
+            (errmodule(MOD_REDO),
+                errcode(ERRCODE_LOG),
+                errmsg("[REDO_LOG_TRACE]BalancePageWorkers: move relation %u/%u/%u from worker %u to %u, "
+                       "backlog:%lu/%lu",
+                    movable->rnode.spcNode,
+                    movable->rnode.dbNode,
+                    movable->rnode.relNode,
+                    busiest,
+                    idlest,
+                    maxBacklog,
+                    minBacklog)));
+    }
+
+    hash_seq_init(&status, g_dispatcher->relOwners);
+    while ((owner = (RedoRelOwner*)hash_seq_search(&status)) != NULL)
+        owner->recCount = 0;
+}
+
 static void AddWorkerToSet(uint32 id)
 {
     if (id >= g_dispatcher->pageWorkerCount) {
@@ -1332,6 +1578,10 @@ void ProcessPendingRecords(bool fullSync)
 void ProcessTrxnRecords(bool fullSync)
 {
     if ((get_real_recovery_parallelism() > 1) && (GetPageWorkerCount() > 0)) {
+        /* don't let a batch wait for the records that are not coming */
+        if (g_dispatcher->pendingCount > 0)
+            ProcessPendingRecords();
+        BalancePageWorkers(false);
         ApplyReadyTxnLogRecords(g_dispatcher->txnWorker, fullSync);
 
         if (fullSync && (IsTxnWorkerIdle(g_dispatcher->txnWorker))) {
@@ -1531,6 +1781,8 @@ void SendRecoveryEndMarkToWorkersAndWaitForFinish(int code)
                 code)));
     if ((get_real_recovery_parallelism() > 1) && (GetPageWorkerCount() > 0)) {
         pg_atomic_write_u32((uint32*)&g_dispatcher->exitCode, (uint32)code);
+        if (g_dispatcher->pendingCount > 0)
+            ProcessPendingRecords();
         ApplyReadyTxnLogRecords(g_dispatcher->txnWorker, true);
         for (uint32 i = 0; i < g_dispatcher->pageWorkerCount; i++) {
             uint64 blockcnt = 0;
@@ -1790,6 +2042,7 @@ void redo_get_wroker_statistic(uint32* realNum, RedoWorkerStatsData* worker, uin
         worker[i].queue_usage = SPSCGetQueueCount(redoWorker->queue);
         worker[i].queue_max_usage = (uint32)(pg_atomic_read_u32(&((redoWorker->queue)->maxUsage)));
         worker[i].redo_rec_count = (uint32)(pg_atomic_read_u64(&((redoWorker->queue)->totalCnt)));
+        worker[i].redo_rate = redoWorker->statRedoRate;
     }
 }
 
@@ -155,6 +155,10 @@ static PageRedoWorker* CreateWorker(uint32 id)
     worker->statMulpageCnt = 0;
     worker->statWaitReach = 0;
     worker->statWaitReplay = 0;
+    worker->statDispatchCount = 0;
+    worker->statRedoCount = 0;
+    worker->statRedoRate = 0;
+    worker->statRateBaseCount = 0;
     worker->oldCtx = NULL;
     worker->bufferPinWaitBufId = -1;
     pg_atomic_write_u32(&(worker->readyStatus), PAGE_REDO_WORKER_INVALID);
@@ -354,6 +358,7 @@ static int ApplyRedoLoop()
             RedoItem* cur = head;
             head = head->nextByWorker[g_redoWorker->id + 1];
             ApplyAndFreeRedoItem(cur);
+            g_redoWorker->statRedoCount++;
         }
         SPSCBlockingQueuePop(g_redoWorker->queue);
         HandlePageRedoInterrupts();
@@ -746,6 +751,7 @@ void AddPageRedoItem(PageRedoWorker* worker, RedoItem* item)
     }
     item->nextByWorker[worker->id + 1] = NULL;
     worker->pendingTail = item;
+    worker->statDispatchCount++;
 }
 
 /* Run from the dispatcher thread. */
@@ -145,6 +145,21 @@ Datum redo_get_primary_flush_ptr()
     return UInt64GetDatum(g_instance.comm_cxt.predo_cxt.redoPf.primary_flush_ptr);
 }
 
+Datum redo_get_prefetch_issued()
+{
+    return UInt64GetDatum(g_instance.comm_cxt.predo_cxt.redoPf.prefetch_issued);
+}
+
+Datum redo_get_prefetch_hit()
+{
+    return UInt64GetDatum(g_instance.comm_cxt.predo_cxt.redoPf.prefetch_hit);
+}
+
+Datum redo_get_prefetch_skip()
+{
+    return UInt64GetDatum(g_instance.comm_cxt.predo_cxt.redoPf.prefetch_skip);
+}
+
 WaitEventIO redo_get_event_type_by_wait_type(uint32 type)
 {
     switch (type) {
@@ -201,18 +216,26 @@ void redo_get_worker_info_text(char* info, uint32 max_info_len)
         securec_check_ss(errorno, "\0", "\0");
         return;
     }
-    errorno =
-        snprintf_s(info, max_info_len, max_info_len - 1, "%-4s%-8s%-11s%-21s", "id", "q_use", "q_max_use", "rec_cnt");
+    errorno = snprintf_s(info,
+        max_info_len,
+        max_info_len - 1,
+        "%-4s%-8s%-11s%-21s%-12s",
+        "id",
+        "q_use",
+        "q_max_use",
+        "rec_cnt",
+        "rec_rate");
     securec_check_ss(errorno, "\0", "\0");
     for (uint32 i = 0; i < worker_num; ++i) {
         errorno = snprintf_s(info + strlen(info),
             max_info_len - strlen(info),
             max_info_len - strlen(info) - 1,
-            "\n%-4u%-8u%-11u%-21lu",
+            "\n%-4u%-8u%-11u%-21lu%-12lu",
             worker[i].id,
             worker[i].queue_usage,
             worker[i].queue_max_usage,
-            worker[i].redo_rec_count);
+            worker[i].redo_rec_count,
+            worker[i].redo_rate);
         securec_check_ss(errorno, "\0", "\0");
     }
 }
@@ -255,7 +278,11 @@ const RedoStatsViewObj g_redoViewArr[REDO_VIEW_COL_SIZE] = {
 
     {"local_max_ptr", INT8OID, redo_get_local_max_lsn},
     {"primary_flush_ptr", INT8OID, redo_get_primary_flush_ptr},
-    {"worker_info", TEXTOID, redo_get_worker_info}
+    {"worker_info", TEXTOID, redo_get_worker_info},
+    {"prefetch_issued", INT8OID, redo_get_prefetch_issued},
+
+    {"prefetch_hit", INT8OID, redo_get_prefetch_hit},
+    {"prefetch_skip", INT8OID, redo_get_prefetch_skip}
 };
 
 void print_stats_file(RedoStatsData* stats)
@@ -688,6 +688,25 @@ void MarkCurrentTransactionIdLoggedIfAny(void)
         CurrentTransactionState->didLogXid = true;
 }
 
+/*
+ * IsSubTransactionAssignmentPending
+ *
+ * Should the WAL record being built carry the toplevel xid? That's the case
+ * for the first record of a subtransaction with an xid under
+ * wal_level=logical, so that logical decoding, which streams the changes of
+ * large transactions before they commit, never takes those of the
+ * subtransaction for a toplevel transaction of their own.
+ */
+bool IsSubTransactionAssignmentPending(void)
+{
+    TransactionState s = CurrentTransactionState;
+
+    if (!XLogLogicalInfoActive())
+        return false;
+
+    return s->parent != NULL && TransactionIdIsValid(s->transactionId) && !s->didLogXid;
+}
+
 /*
  * @Description: set the didLogXid of the current transaction state to true.
  * @out state: the current transaction state.
@@ -752,6 +771,9 @@ static void AssignTransactionId(TransactionState s)
      * superfluously log something. That can happen when an xid is included
      * somewhere inside a wal record, but not in XLogRecord->xl_xid, like in
      * xl_standby_locks.
+     *
+     * Otherwise the first record of the subtransaction carries its toplevel
+     * xid, see IsSubTransactionAssignmentPending().
      */
     if (isSubXact && XLogLogicalInfoActive() && !TopTransactionStateData.didLogXid)
         log_unknown_top = true;
@@ -6576,6 +6598,7 @@ static void xact_redo_commit_internal(TransactionId xid, XLogRecPtr lsn, Transac
         if (TransactionIdPrecedes(t_thrd.xact_cxt.ShmemVariableCache->latestCompletedXid, max_xid)) {
             t_thrd.xact_cxt.ShmemVariableCache->latestCompletedXid = max_xid;
         }
+        ProcArrayPublishStandbySnapshot();
 
         /*
          * Send any cache invalidations attached to the commit. We must
@@ -6780,6 +6803,7 @@ static void xact_redo_abort(xl_xact_abort* xlrec, TransactionId xid, XLogRecPtr
         /* As in ProcArrayEndTransaction, advance latestCompletedXid */
         if (TransactionIdPrecedes(t_thrd.xact_cxt.ShmemVariableCache->latestCompletedXid, max_xid))
             t_thrd.xact_cxt.ShmemVariableCache->latestCompletedXid = max_xid;
+        ProcArrayPublishStandbySnapshot();
 
         /* Release locks, if any. There are no invalidations to send. */
         StandbyReleaseLockTree(xid, xlrec->nsubxacts, sub_xids);
@@ -8792,6 +8792,10 @@ void StartupXLOG(void)
             SendRecoveryEndMarkToWorkersAndWaitForFinish(0);
             RecoveryXlogReader(oldXlogReader, xlogreader);
 
+            if (t_thrd.mot_cxt.mot_startup == true) {
+                MOTRedoDone();
+            }
+
             if (t_thrd.xlog_cxt.recoveryPauseAtTarget && reachedStopPoint) {
                 SetRecoveryPause(true);
                 recoveryPausesHere();
@@ -56,8 +56,9 @@ typedef struct registered_buffer {
     char compressed_page[BLCKSZ]; /* buffer to store a compressed version of backup block image */
 } registered_buffer;
 
-#define HEADER_SCRATCH_SIZE \
-    (SizeOfXLogRecord + MaxSizeOfXLogRecordBlockHeader * (XLR_MAX_BLOCK_ID + 1) + SizeOfXLogRecordDataHeaderLong)
+#define HEADER_SCRATCH_SIZE                                                                                 \
+    (SizeOfXLogRecord + MaxSizeOfXLogRecordBlockHeader * (XLR_MAX_BLOCK_ID + 1) + SizeOfXLogRecordDataHeaderLong + \
+        sizeof(uint8) + sizeof(TransactionId))
 
 static XLogRecData* XLogRecordAssemble(
     RmgrId rmid, uint8 info, XLogFPWInfo fpw_info, XLogRecPtr* fpw_lsn, bool isupgrade = false, int bucket_id = -1);
@@ -762,6 +763,20 @@ static XLogRecData* XLogRecordAssemble(
         scratch += sizeof(u_sess->attr.attr_storage.replorigin_sesssion_origin);
     }
 
+    /*
+     * followed by the toplevel xid, in the first record of a subtransaction
+     * under wal_level=logical, so that decoding knows which transaction its
+     * changes belong to without an assignment record
+     */
+    if (!isupgrade && IsSubTransactionAssignmentPending()) {
+        TransactionId topxid = GetTopTransactionIdIfAny();
+
+        *(scratch++) = XLR_BLOCK_ID_TOPLEVEL_XID;
+        rc = memcpy_s(scratch, sizeof(TransactionId), &topxid, sizeof(TransactionId));
+        securec_check(rc, "", "");
+        scratch += sizeof(TransactionId);
+    }
+
     /* followed by main data, if any */
     if (t_thrd.xlog_cxt.mainrdata_len > 0) {
         if (t_thrd.xlog_cxt.mainrdata_len > 255) {
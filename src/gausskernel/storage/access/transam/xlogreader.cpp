@@ -1256,6 +1256,7 @@ bool DecodeXLogRecord(XLogReaderState* state, XLogRecord* record, char** errorms
 
     state->decoded_record = record;
     state->record_origin = InvalidRepOriginId;
+    state->toplevel_xid = InvalidTransactionId;
 
     ptr = (char*)record;
     ptr += readoldversion ? SizeOfXLogRecordOld : SizeOfXLogRecord;
@@ -1300,6 +1301,13 @@ bool DecodeXLogRecord(XLogReaderState* state, XLogRecord* record, char** errorms
             ptr += sizeof(RepOriginId);
             remaining -= sizeof(RepOriginId);
 
+        } else if (block_id == XLR_BLOCK_ID_TOPLEVEL_XID) {
+            if (remaining < sizeof(TransactionId))
+                goto shortdata_err;
+            errno_t rc = memcpy_s(&state->toplevel_xid, sizeof(TransactionId), ptr, sizeof(TransactionId));
+            securec_check(rc, "", "");
+            ptr += sizeof(TransactionId);
+            remaining -= sizeof(TransactionId);
         } else if (BKID_GET_BKID(block_id) <= XLR_MAX_BLOCK_ID) {
             /* XLogRecordBlockHeader */
             DecodedBkpBlock* blk = NULL;
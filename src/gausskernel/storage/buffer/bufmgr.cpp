@@ -421,6 +421,42 @@ void PrefetchBuffer(Relation reln, ForkNumber forkNum, BlockNumber blockNum)
 #endif /* USE_PREFETCH && USE_POSIX_FADVISE */
 }
 
+/*
+ * PrefetchBufferForRedo -- initiate asynchronous read of a block referenced
+ * by a WAL record that is yet to be replayed
+ *
+ * Like PrefetchBuffer, but works without a relcache entry, so that the redo
+ * dispatcher can look ahead of the workers. The relation may not exist yet or
+ * any more, in which case nothing is done. Returns false if the block is in
+ * the buffer pool already.
+ */
+bool PrefetchBufferForRedo(const RelFileNode& rnode, ForkNumber forkNum, BlockNumber blockNum)
+{
+#if defined(USE_PREFETCH) && defined(USE_POSIX_FADVISE)
+    BufferTag new_tag;
+    uint32 new_hash;
+    LWLock* new_partition_lock = NULL;
+    int buf_id;
+
+    Assert(BlockNumberIsValid(blockNum));
+
+    INIT_BUFFERTAG(new_tag, rnode, forkNum, blockNum);
+    new_hash = BufTableHashCode(&new_tag);
+    new_partition_lock = BufMappingPartitionLock(new_hash);
+
+    (void)LWLockAcquire(new_partition_lock, LW_SHARED);
+    buf_id = BufTableLookup(&new_tag, new_hash);
+    LWLockRelease(new_partition_lock);
+
+    if (buf_id >= 0) {
+        return false;
+    }
+
+    smgrprefetch(smgropen(rnode, InvalidBackendId), forkNum, blockNum);
+#endif /* USE_PREFETCH && USE_POSIX_FADVISE */
+    return true;
+}
+
 /*
  * @Description: ConditionalStartBufferIO: conditionally begin and Asynchronous Prefetch or
  * WriteBack I/O on this buffer.
@@ -5005,6 +5041,7 @@ bool ConditionalLockBuffer(Buffer buffer)
 void LockBufferForCleanup(Buffer buffer)
 {
     BufferDesc* buf_desc = NULL;
+    TimestampTz waitStart = 0;
 
     Assert(BufferIsValid(buffer));
     Assert(t_thrd.storage_cxt.PinCountWaitBuf == NULL);
@@ -5058,7 +5095,9 @@ void LockBufferForCleanup(Buffer buffer)
             /* Publish the bufid that Startup process waits on */
             MultiRedoSetBufferPinWaitBufId(buffer - 1);
             /* Set alarm and then wait to be signaled by UnpinBuffer() */
-            ResolveRecoveryConflictWithBufferPin();
+            if (waitStart == 0)
+                waitStart = GetCurrentTimestamp();
+            ResolveRecoveryConflictWithBufferPin(waitStart);
             /* Reset the published bufid */
             MultiRedoSetBufferPinWaitBufId(-1);
         } else {
@@ -31,6 +31,8 @@
 #include "utils/resowner.h"
 #include "storage/ipc.h"
 #include "miscadmin.h"
+#include "access/hash.h"
+#include "utils/atomic.h"
 
 const int MAX_LOOPS = 16;
 
@@ -183,6 +185,16 @@ void CacheMgr::Init(int64 cache_size, uint32 each_block_size, MgrCacheType type,
     info.num_partitions = NUM_CACHE_BUFFER_PARTITIONS / 2;
 
     m_hash = HeapMemInitHash(hash_name, total_slots, total_slots, &info, HASH_ELEM | HASH_FUNCTION | HASH_PARTITION);
+
+    /* Frequency sketch, each row has at least as many counters as slots */
+    uint32 sketch_width = 1024;
+    while (sketch_width < (uint32)total_slots) {
+        sketch_width <<= 1;
+    }
+    m_sketch = (uint8 *)palloc0(CACHE_SKETCH_DEPTH * sketch_width);
+    m_sketch_mask = sketch_width - 1;
+    m_sketch_sample = (uint32)Max(total_slots, 1024) * CACHE_SKETCH_SAMPLE_FACTOR;
+    m_sketch_requests = 0;
 }
 
 /*
@@ -207,6 +219,7 @@ void CacheMgr::Destroy(void)
 
     pfree_ext(m_CacheSlots);
     pfree_ext(m_CacheDesc);
+    pfree_ext(m_sketch);
 }
 
 /*
@@ -262,6 +275,10 @@ CacheSlotId_t CacheMgr::FindCacheBlock(CacheTag *cacheTag, bool first_enter_bloc
                                                           m_CacheDesc[slotId].m_cache_tag.type == CACHE_OBS_DATA)) ||
                ((m_cache_type == MGR_CACHE_TYPE_INDEX) && (m_CacheDesc[slotId].m_cache_tag.type == CACHE_ORC_INDEX)));
 
+        if (first_enter_block && u_sess->attr.attr_storage.enable_cu_cache_admission) {
+            (void)RecordCacheBlockRequest(hashCode);
+        }
+
         LockCacheDescHeader(slotId);
         if (first_enter_block && (m_CacheDesc[slotId].m_usage_count < CACHE_BLOCK_MAX_USAGE)) {
             m_CacheDesc[slotId].m_usage_count += 1;
@@ -359,6 +376,68 @@ void CacheMgr::DeleteCacheBlock(CacheTag *cacheTag)
     return;
 }
 
+/*
+ * @Description: count one request of a cache block in the frequency sketch
+ * @IN hashCode: hash code of the block tag
+ * @Return: estimated requests of the block in the recent CACHE_SKETCH_SAMPLE_FACTOR * slots requests
+ * @See also:
+ */
+uint8 CacheMgr::RecordCacheBlockRequest(uint32 hashCode)
+{
+    uint8 freq = CACHE_SKETCH_MAX_FREQ;
+
+    for (int i = 0; i < CACHE_SKETCH_DEPTH; ++i) {
+        /* each row hashes with its own seed, taken from the golden ratio */
+        uint32 index = DatumGetUInt32(hash_uint32(hashCode + (uint32)i * 0x9E3779B9U)) & m_sketch_mask;
+        uint8 *counter = m_sketch + i * (m_sketch_mask + 1) + index;
+        if (*counter < CACHE_SKETCH_MAX_FREQ) {
+            *counter += 1;
+        }
+        freq = Min(freq, *counter);
+    }
+
+    /* the one who reaches the sample size ages the sketch */
+    if (pg_atomic_fetch_add_u32(&m_sketch_requests, 1) + 1 == m_sketch_sample) {
+        AgeCacheSketch();
+    }
+
+    return freq;
+}
+
+/*
+ * @Description: halve all counters of the frequency sketch, so that blocks
+ *     which are not requested any more lose their frequency by and by.
+ * @See also:
+ */
+void CacheMgr::AgeCacheSketch()
+{
+    uint32 total = CACHE_SKETCH_DEPTH * (m_sketch_mask + 1);
+
+    for (uint32 i = 0; i < total; ++i) {
+        m_sketch[i] >>= 1;
+    }
+    pg_atomic_write_u32(&m_sketch_requests, 0);
+}
+
+/*
+ * @Description: usage count of a block newly put into cache. A block requested
+ *     the first time within the sketch window starts with 0, so that it is the
+ *     first to be evicted once unpinned unless it is requested again, and one
+ *     scan of a big table can not push out the blocks requested repeatedly.
+ *     Blocks evicted but requested again start with the count they would have
+ *     kept in cache.
+ * @IN freq: estimated requests of the block
+ * @Return: usage count
+ * @See also:
+ */
+uint16 CacheMgr::GetAdmittedUsageCount(uint8 freq) const
+{
+    if (freq <= 1) {
+        return 0;
+    }
+    return Min((uint16)(freq - 1), CACHE_BLOCK_MAX_USAGE);
+}
+
 /*
  * @Description: use clock-swap algorithm to evict a block
  * @Return: slot id
@@ -1181,6 +1260,11 @@ CacheSlotId_t CacheMgr::ReserveCacheBlock(CacheTag *cacheTag, int size, bool &ha
 {
     int slot;
     uint32 hashCode = GetHashCode(cacheTag);
+    uint16 usage_count = 1;
+
+    if (u_sess->attr.attr_storage.enable_cu_cache_admission) {
+        usage_count = GetAdmittedUsageCount(RecordCacheBlockRequest(hashCode));
+    }
 
     slot = AllocateBlockFromCache(cacheTag, hashCode, size, hasFound);
     Assert(slot >= 0 && slot <= m_CaccheSlotMax && slot < m_CacheSlotsNum);
@@ -1202,7 +1286,7 @@ CacheSlotId_t CacheMgr::ReserveCacheBlock(CacheTag *cacheTag, int size, bool &ha
     LockCacheDescHeader(slot);
 
     InitCacheBlockTag(&(m_CacheDesc[slot].m_cache_tag), cacheTag->type, cacheTag->key, MAX_CACHE_TAG_LEN);
-    m_CacheDesc[slot].m_usage_count = 1;
+    m_CacheDesc[slot].m_usage_count = usage_count;
     m_CacheDesc[slot].m_flag = CACHE_BLOCK_VALID | CACHE_BLOCK_IOBUSY;
     m_CacheDesc[slot].m_datablock_size = size;
     UnLockCacheDescHeader(slot);
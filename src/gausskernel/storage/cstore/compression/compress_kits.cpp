@@ -23,12 +23,16 @@
  */
 #include "access/hash.h"
 #include "storage/compress_kits.h"
+#include "storage/compress_simd.h"
 #include "utils/memutils.h"
 #include "utils/memprot.h"
 #include "nodes/memnodes.h"
 #include "lz4.h"
 #include "lz4hc.h"
 
+/* the scalar decoding is kept as the reference of the vector kernels */
+#define USE_SIMD_DECODE() (u_sess->attr.attr_storage.enable_cstore_simd_decode)
+
 /* The macro to validate if the return value is available */
 #define MEMPROT_ALLOC_VALID(buf, size)                                                                               \
     {                                                                                                                \
@@ -615,9 +619,15 @@ int RleCoder::InnerDecompress(char* inbuf, char* outbuf, const int insize, const
                 Assert(symbolCount >= this->m_minRepeats && symbolCount <= RleCoder::RleMaxRepeats);
 
                 symbol = readData<eachValSize>(inptr, &inpos);
-                for (uint16 i = 0; i < symbolCount; ++i) {
-                    writeData<eachValSize>(outbuf, &outpos, symbol);
-                    Assert(outpos <= (unsigned int)outsize);
+                if (SimdValueSizeSupported(eachValSize) && USE_SIMD_DECODE()) {
+                    Assert(outpos + symbolCount * eachValSize <= (unsigned int)outsize);
+                    SimdFillValues(outbuf + outpos, symbolCount, eachValSize, symbol);
+                    outpos += symbolCount * eachValSize;
+                } else {
+                    for (uint16 i = 0; i < symbolCount; ++i) {
+                        writeData<eachValSize>(outbuf, &outpos, symbol);
+                        Assert(outpos <= (unsigned int)outsize);
+                    }
                 }
                 outcnt += symbolCount;
             } else {
@@ -631,6 +641,18 @@ int RleCoder::InnerDecompress(char* inbuf, char* outbuf, const int insize, const
                 }
                 outcnt += markerCount;
             }
+        } else if (SimdValueSizeSupported(eachValSize) && USE_SIMD_DECODE()) {
+            // No marker, copy all the plain data before the next marker
+            char* plain = inptr + inpos - eachValSize;
+            int nvals = (insize - (inpos - eachValSize)) / eachValSize;
+            int nplain = SimdFindMarker(plain, nvals, eachValSize, (uint8)RleCoder::RleMarker[eachValSize]);
+            Assert(nplain >= 1);
+
+            errno_t rc = memcpy_s(outbuf + outpos, outsize - outpos, plain, nplain * eachValSize);
+            securec_check(rc, "\0", "\0");
+            inpos += (nplain - 1) * eachValSize;
+            outpos += nplain * eachValSize;
+            outcnt += nplain;
         } else {
             // No marker, copy the plain data
             writeData<eachValSize>(outbuf, &outpos, symbol);
@@ -885,6 +907,14 @@ int64 DeltaCoder::Decompress(
     Assert(insize > 0);
     Assert(insize == ((insize / inDataSize) * inDataSize));
 
+    // widen and add min value with vector instructions for the common value sizes
+    if (SimdUnpackAddSupported(inDataSize, m_outValSize) && USE_SIMD_DECODE()) {
+        int nvals = insize / inDataSize;
+        Assert((int64)nvals * m_outValSize <= (int64)outsize);
+        SimdUnpackAdd(inbuf, outbuf, nvals, inDataSize, m_outValSize, m_mindata);
+        return (int64)nvals * m_outValSize;
+    }
+
     switch (inDataSize) {
         case sizeof(char):
             ret = DoDeltaOperation<true, sizeof(char)>(inbuf, outbuf, insize, m_outValSize);
@@ -1148,6 +1178,365 @@ void DicCoder::DecodeOneValue(_in_ DicCodeType itemIndx, _out_ Datum* result) co
     *result = PointerGetDatum(pItem);
 }
 
+/*************************************************************************
+ *                                 FSST                                  *
+ *************************************************************************/
+
+/* the symbol table is learned from this many bytes of the input, taken in pieces */
+#define FSST_SAMPLE_SIZE (16 * 1024)
+#define FSST_SAMPLE_PIECE 512
+
+/* rounds of learning the symbol table */
+#define FSST_GENERATIONS 5
+
+/* while learning, codes 0~254 are symbols and 256~511 are single bytes */
+#define FSST_BYTE_CODE(_b) (256 + (_b))
+#define FSST_CODES 512
+
+/* hash slots counting pairs of adjacent codes, twice the sample size */
+#define FSST_PAIR_SLOTS (2 * FSST_SAMPLE_SIZE)
+
+typedef struct FSSTPair {
+    uint32 key; /* first code * FSST_CODES + second code + 1, 0 if unused */
+    uint32 count;
+} FSSTPair;
+
+typedef struct FSSTCandidate {
+    uint64 symbol;
+    uint64 gain;
+    int len;
+} FSSTCandidate;
+
+/* keep symbol bytes in the low bytes whatever the endian is */
+static inline uint64 FSSTLoad(const char* buf, int len)
+{
+    uint64 word = 0;
+    for (int i = 0; i < len; ++i) {
+        word |= ((uint64)(uint8)buf[i]) << (i * 8);
+    }
+    return word;
+}
+
+static inline void FSSTStore(char* buf, uint64 word, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        buf[i] = (char)(uint8)(word >> (i * 8));
+    }
+}
+
+static inline uint64 FSSTMask(int len)
+{
+    return (len >= FSSTCoder::fsst_max_symbol_len) ? ~((uint64)0) : ((((uint64)1) << (len * 8)) - 1);
+}
+
+static int FSSTCandidateCmpSymbol(const void* a, const void* b)
+{
+    const FSSTCandidate* ca = (const FSSTCandidate*)a;
+    const FSSTCandidate* cb = (const FSSTCandidate*)b;
+
+    if (ca->len != cb->len)
+        return (ca->len < cb->len) ? -1 : 1;
+    if (ca->symbol != cb->symbol)
+        return (ca->symbol < cb->symbol) ? -1 : 1;
+    return 0;
+}
+
+/* higher gain first, ties are broken by the symbol so that the table is stable */
+static int FSSTCandidateCmpGain(const void* a, const void* b)
+{
+    const FSSTCandidate* ca = (const FSSTCandidate*)a;
+    const FSSTCandidate* cb = (const FSSTCandidate*)b;
+
+    if (ca->gain != cb->gain)
+        return (ca->gain > cb->gain) ? -1 : 1;
+    return FSSTCandidateCmpSymbol(a, b);
+}
+
+/*
+ * @Description: find the longest symbol at the head of input.
+ * @IN inBuf: input data
+ * @IN remain: bytes left in input, at least 1
+ * @Return: code of the symbol, or -1 if no symbol matches.
+ */
+inline int FSSTCoder::FindSymbol(const char* inBuf, int remain) const
+{
+    uint8 first = (uint8)inBuf[0];
+    int start = m_firstByte[first];
+    int end = m_firstByte[first + 1];
+
+    if (start == end)
+        return -1;
+
+    uint64 word = FSSTLoad(inBuf, Min(remain, fsst_max_symbol_len));
+    for (int i = start; i < end; ++i) {
+        int code = m_sorted[i];
+        int len = m_lens[code];
+        if (len <= remain && (word & FSSTMask(len)) == m_symbols[code])
+            return code;
+    }
+    return -1;
+}
+
+void FSSTCoder::SetSymbols(const uint64* symbols, const uint8* lens, int count)
+{
+    int groupSize[256] = {0};
+
+    Assert(count >= 0 && count <= fsst_max_symbols);
+    m_symbolsCount = count;
+    for (int code = 0; code < count; ++code) {
+        m_symbols[code] = symbols[code];
+        m_lens[code] = lens[code];
+        groupSize[symbols[code] & 0xFF]++;
+    }
+
+    m_firstByte[0] = 0;
+    for (int b = 0; b < 256; ++b) {
+        m_firstByte[b + 1] = m_firstByte[b] + groupSize[b];
+    }
+
+    /* insert each code into the group of its first byte, the longer the earlier */
+    int filled[256] = {0};
+    for (int code = 0; code < count; ++code) {
+        int b = (int)(m_symbols[code] & 0xFF);
+        int i = m_firstByte[b] + filled[b];
+        while (i > m_firstByte[b] && m_lens[m_sorted[i - 1]] < m_lens[code]) {
+            m_sorted[i] = m_sorted[i - 1];
+            --i;
+        }
+        m_sorted[i] = (uint8)code;
+        filled[b]++;
+    }
+}
+
+/*
+ * @Description: learn the symbol table from input. Each round compresses a
+ *     sample with the current table, counts the codes and the pairs of adjacent
+ *     codes, and keeps the 255 symbols or concatenated pairs which would cover
+ *     the most bytes of the sample.
+ * @IN inBuf: input data
+ * @IN inSize: input size
+ */
+void FSSTCoder::BuildSymbolTable(const char* inBuf, int inSize)
+{
+    const char* sample = inBuf;
+    int sampleSize = inSize;
+    char* sampleBuf = NULL;
+    errno_t rc;
+
+    if (inSize > FSST_SAMPLE_SIZE) {
+        /* pieces spread evenly over the input */
+        int pieces = FSST_SAMPLE_SIZE / FSST_SAMPLE_PIECE;
+        int step = inSize / pieces;
+
+        sampleBuf = (char*)palloc(FSST_SAMPLE_SIZE);
+        for (int i = 0; i < pieces; ++i) {
+            rc = memcpy_s(sampleBuf + i * FSST_SAMPLE_PIECE, FSST_SAMPLE_PIECE, inBuf + i * step, FSST_SAMPLE_PIECE);
+            securec_check(rc, "", "");
+        }
+        sample = sampleBuf;
+        sampleSize = FSST_SAMPLE_SIZE;
+    }
+
+    uint32* counts = (uint32*)palloc(sizeof(uint32) * FSST_CODES);
+    FSSTPair* pairs = (FSSTPair*)palloc(sizeof(FSSTPair) * FSST_PAIR_SLOTS);
+    FSSTCandidate* cands = (FSSTCandidate*)palloc(sizeof(FSSTCandidate) * (FSST_CODES + FSST_PAIR_SLOTS));
+    uint64 symbols[fsst_max_symbols];
+    uint8 lens[fsst_max_symbols];
+
+    SetSymbols(symbols, lens, 0);
+    for (int gen = 0; gen < FSST_GENERATIONS; ++gen) {
+        rc = memset_s(counts, sizeof(uint32) * FSST_CODES, 0, sizeof(uint32) * FSST_CODES);
+        securec_check(rc, "", "");
+        rc = memset_s(pairs, sizeof(FSSTPair) * FSST_PAIR_SLOTS, 0, sizeof(FSSTPair) * FSST_PAIR_SLOTS);
+        securec_check(rc, "", "");
+
+        /* step 1: compress the sample and count codes and pairs */
+        int prev = -1;
+        for (int pos = 0; pos < sampleSize;) {
+            int code = FindSymbol(sample + pos, sampleSize - pos);
+            if (code >= 0) {
+                pos += m_lens[code];
+            } else {
+                code = FSST_BYTE_CODE((uint8)sample[pos]);
+                pos += 1;
+            }
+            counts[code]++;
+
+            if (prev >= 0) {
+                uint32 key = (uint32)(prev * FSST_CODES + code + 1);
+                uint32 slot = (key * 2654435761U) & (FSST_PAIR_SLOTS - 1);
+                while (pairs[slot].key != 0 && pairs[slot].key != key) {
+                    slot = (slot + 1) & (FSST_PAIR_SLOTS - 1);
+                }
+                pairs[slot].key = key;
+                pairs[slot].count++;
+            }
+            prev = code;
+        }
+
+        /* step 2: every code and every concatenated pair is a candidate */
+        int ncands = 0;
+        for (int code = 0; code < FSST_CODES; ++code) {
+            if (counts[code] == 0)
+                continue;
+            FSSTCandidate* cand = cands + ncands++;
+            cand->symbol = (code < fsst_max_symbols) ? m_symbols[code] : (uint64)(code - FSST_BYTE_CODE(0));
+            cand->len = (code < fsst_max_symbols) ? m_lens[code] : 1;
+            cand->gain = (uint64)counts[code] * cand->len;
+        }
+        for (int slot = 0; slot < FSST_PAIR_SLOTS; ++slot) {
+            if (pairs[slot].key == 0)
+                continue;
+            int first = (int)((pairs[slot].key - 1) / FSST_CODES);
+            int second = (int)((pairs[slot].key - 1) % FSST_CODES);
+            int firstLen = (first < fsst_max_symbols) ? m_lens[first] : 1;
+            int secondLen = (second < fsst_max_symbols) ? m_lens[second] : 1;
+            if (firstLen >= fsst_max_symbol_len)
+                continue;
+            uint64 firstSym = (first < fsst_max_symbols) ? m_symbols[first] : (uint64)(first - FSST_BYTE_CODE(0));
+            uint64 secondSym = (second < fsst_max_symbols) ? m_symbols[second] : (uint64)(second - FSST_BYTE_CODE(0));
+
+            FSSTCandidate* cand = cands + ncands++;
+            cand->len = Min(firstLen + secondLen, fsst_max_symbol_len);
+            cand->symbol = (firstSym | (secondSym << (firstLen * 8))) & FSSTMask(cand->len);
+            cand->gain = (uint64)pairs[slot].count * cand->len;
+        }
+
+        /* step 3: merge the same candidates and keep the best ones */
+        qsort(cands, ncands, sizeof(FSSTCandidate), FSSTCandidateCmpSymbol);
+        int nmerged = 0;
+        for (int i = 0; i < ncands; ++i) {
+            if (nmerged > 0 && FSSTCandidateCmpSymbol(cands + nmerged - 1, cands + i) == 0) {
+                cands[nmerged - 1].gain += cands[i].gain;
+            } else {
+                cands[nmerged++] = cands[i];
+            }
+        }
+        qsort(cands, nmerged, sizeof(FSSTCandidate), FSSTCandidateCmpGain);
+
+        int count = Min(nmerged, fsst_max_symbols);
+        for (int code = 0; code < count; ++code) {
+            symbols[code] = cands[code].symbol;
+            lens[code] = (uint8)cands[code].len;
+        }
+        SetSymbols(symbols, lens, count);
+    }
+
+    pfree(cands);
+    pfree(pairs);
+    pfree(counts);
+    if (sampleBuf != NULL)
+        pfree(sampleBuf);
+}
+
+/*
+ * @Description: compress input with the symbol table built by BuildSymbolTable().
+ * @IN inBuf: input data
+ * @IN inSize: input size
+ * @OUT outBuf: output buffer
+ * @IN outSize: output buffer size
+ * @Return: return 0 if output buffer is not big enough; otherwise return compressed data size.
+ */
+int FSSTCoder::Compress(const char* inBuf, int inSize, char* outBuf, int outSize)
+{
+    FSSTHeader* header = (FSSTHeader*)outBuf;
+    int headerSize = SizeOfFSSTHeader + m_symbolsCount;
+
+    for (int code = 0; code < m_symbolsCount; ++code) {
+        headerSize += m_lens[code];
+    }
+    if (headerSize >= outSize)
+        return 0;
+
+    header->rawLen = (uint32)inSize;
+    header->symbolsCount = (uint8)m_symbolsCount;
+    char* symbolData = outBuf + SizeOfFSSTHeader + m_symbolsCount;
+    for (int code = 0; code < m_symbolsCount; ++code) {
+        header->lens[code] = m_lens[code];
+        FSSTStore(symbolData, m_symbols[code], m_lens[code]);
+        symbolData += m_lens[code];
+    }
+
+    char* out = outBuf + headerSize;
+    char* outEnd = outBuf + outSize;
+    for (int pos = 0; pos < inSize;) {
+        int code = FindSymbol(inBuf + pos, inSize - pos);
+        if (code >= 0) {
+            if (out >= outEnd)
+                return 0;
+            *out++ = (char)code;
+            pos += m_lens[code];
+        } else {
+            if (out + 1 >= outEnd)
+                return 0;
+            *out++ = (char)fsst_escape_code;
+            *out++ = inBuf[pos++];
+        }
+    }
+
+    return (int)(out - outBuf);
+}
+
+int FSSTCoder::DecompressGetBound(const char* inBuf) const
+{
+    return (int)((const FSSTHeader*)inBuf)->rawLen;
+}
+
+/*
+ * @Description: decompress data compressed by Compress(). The symbol table is
+ *     read from the compressed data.
+ * @IN inBuf: compressed data
+ * @IN inSize: compressed data size
+ * @OUT outBuf: output buffer
+ * @IN outSize: output buffer size
+ * @Return: raw data size; -2 if output buffer is too small; -1 if data corrupts.
+ */
+int FSSTCoder::Decompress(const char* inBuf, int inSize, char* outBuf, int outSize)
+{
+    const FSSTHeader* header = (const FSSTHeader*)inBuf;
+    char symbolBytes[fsst_max_symbols][fsst_max_symbol_len];
+
+    if (inSize < (int)SizeOfFSSTHeader || (int)header->symbolsCount > fsst_max_symbols)
+        return -1;
+    if ((int)header->rawLen > outSize)
+        return -2;
+
+    int count = header->symbolsCount;
+    const char* in = inBuf + SizeOfFSSTHeader + count;
+    const char* inEnd = inBuf + inSize;
+    for (int code = 0; code < count; ++code) {
+        int len = header->lens[code];
+        if (len < 1 || len > fsst_max_symbol_len || in + len > inEnd)
+            return -1;
+        m_lens[code] = (uint8)len;
+        for (int i = 0; i < len; ++i) {
+            symbolBytes[code][i] = *in++;
+        }
+    }
+    m_symbolsCount = count;
+
+    char* out = outBuf;
+    char* outEnd = outBuf + header->rawLen;
+    while (in < inEnd) {
+        uint8 code = (uint8)*in++;
+        if (code == fsst_escape_code) {
+            if (in >= inEnd || out >= outEnd)
+                return -1;
+            *out++ = *in++;
+        } else {
+            int len = (code < count) ? m_lens[code] : 0;
+            if (len == 0 || out + len > outEnd)
+                return -1;
+            for (int i = 0; i < len; ++i) {
+                out[i] = symbolBytes[code][i];
+            }
+            out += len;
+        }
+    }
+
+    return (out == outEnd) ? (int)header->rawLen : -1;
+}
+
 /*************************************************************************
  *                             LZ4Wrapper                                *
  *************************************************************************/
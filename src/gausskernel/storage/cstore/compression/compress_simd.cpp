@@ -0,0 +1,556 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * compress_simd.cpp
+ *      vectorized kernels for decoding CU values
+ *
+ * Delta (frame of reference) values are byte bound, so decoding them is
+ * widening each value to the size of the column and adding the min value,
+ * which maps to the zero-extending moves of SSE4.1/AVX2 and NEON. RLE
+ * decoding copies the plain values before the next RLE marker in one go,
+ * and fills the repeated values with vector stores.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/cstore/compression/compress_simd.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/compress_simd.h"
+
+#if defined(__x86_64__) && defined(__SSE4_1__)
+#define USE_SIMD_DECODE_SSE41
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#define USE_SIMD_DECODE_AVX2
+#endif
+#elif defined(__aarch64__)
+#define USE_SIMD_DECODE_NEON
+#include <arm_neon.h>
+#endif
+
+typedef void (*UnpackAddFunc)(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base);
+typedef int (*FindMarkerFunc)(const char* inbuf, int nvals, short valSize, uint8 markerByte);
+
+/*************************************************************************
+ *                         scalar implementations                         *
+ *************************************************************************/
+template <typename InType, typename OutType>
+static void ScalarUnpackAddT(const char* inbuf, char* outbuf, int nvals, int64 base)
+{
+    const InType* in = (const InType*)inbuf;
+    OutType* out = (OutType*)outbuf;
+    for (int i = 0; i < nvals; ++i) {
+        out[i] = (OutType)((uint64)in[i] + (uint64)base);
+    }
+}
+
+template <typename InType>
+static void ScalarUnpackAddIn(const char* inbuf, char* outbuf, int nvals, short outSize, int64 base)
+{
+    switch (outSize) {
+        case sizeof(uint8):
+            ScalarUnpackAddT<InType, uint8>(inbuf, outbuf, nvals, base);
+            break;
+        case sizeof(uint16):
+            ScalarUnpackAddT<InType, uint16>(inbuf, outbuf, nvals, base);
+            break;
+        case sizeof(uint32):
+            ScalarUnpackAddT<InType, uint32>(inbuf, outbuf, nvals, base);
+            break;
+        case sizeof(uint64):
+            ScalarUnpackAddT<InType, uint64>(inbuf, outbuf, nvals, base);
+            break;
+        default:
+            Assert(false);
+            break;
+    }
+}
+
+void ScalarUnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base)
+{
+    Assert(SimdUnpackAddSupported(inSize, outSize));
+    switch (inSize) {
+        case sizeof(uint8):
+            ScalarUnpackAddIn<uint8>(inbuf, outbuf, nvals, outSize, base);
+            break;
+        case sizeof(uint16):
+            ScalarUnpackAddIn<uint16>(inbuf, outbuf, nvals, outSize, base);
+            break;
+        case sizeof(uint32):
+            ScalarUnpackAddIn<uint32>(inbuf, outbuf, nvals, outSize, base);
+            break;
+        default:
+            Assert(false);
+            break;
+    }
+}
+
+int ScalarFindMarker(const char* inbuf, int nvals, short valSize, uint8 markerByte)
+{
+    for (int i = 0; i < nvals; ++i) {
+        const uint8* val = (const uint8*)inbuf + (size_t)i * valSize;
+        int j = 0;
+        while (j < valSize && val[j] == markerByte) {
+            ++j;
+        }
+        if (j == valSize) {
+            return i;
+        }
+    }
+    return nvals;
+}
+
+/*
+ * given a mask with one bit per byte set where the byte equals to the marker,
+ * keep the bit of the first byte of each value whose bytes are all set.
+ */
+static FORCE_INLINE uint64 MarkerValueMask(uint64 byteMask, short valSize, int bitsPerByte)
+{
+    /* the bit of the first byte of each value, for 64 bits mask */
+    static const uint64 firstByteBits[] = {0,
+        0xFFFFFFFFFFFFFFFF, 0x5555555555555555, 0, 0x1111111111111111, 0, 0, 0, 0x0101010101010101};
+    /* 4 bits per byte, used on aarch64 */
+    static const uint64 firstNibbleBits[] = {0,
+        0xFFFFFFFFFFFFFFFF, 0x0F0F0F0F0F0F0F0F, 0, 0x000F000F000F000F, 0, 0, 0, 0x0000000F0000000F};
+
+    uint64 mask = byteMask;
+    for (int i = 1; i < valSize; ++i) {
+        mask &= byteMask >> (i * bitsPerByte);
+    }
+    return mask & ((bitsPerByte == 1) ? firstByteBits[valSize] : firstNibbleBits[valSize]);
+}
+
+/*************************************************************************
+ *                         SSE4.1 and AVX2                                *
+ *************************************************************************/
+#ifdef USE_SIMD_DECODE_SSE41
+
+/* load nbytes (2, 4, 8 or 16) into the low bytes of a vector */
+static FORCE_INLINE __m128i SseLoadLow(const char* ptr, int nbytes)
+{
+    if (nbytes == 16) {
+        return _mm_loadu_si128((const __m128i*)ptr);
+    } else if (nbytes == 8) {
+        return _mm_loadl_epi64((const __m128i*)ptr);
+    }
+
+    return _mm_cvtsi32_si128((nbytes == 4) ? *(const int32*)ptr : (int32)*(const uint16*)ptr);
+}
+
+template <short inSize, short outSize>
+static void SseUnpackAddT(const char* inbuf, char* outbuf, int nvals, int64 base)
+{
+    const int lanes = 16 / outSize;
+    __m128i vbase;
+    if (outSize == 1) {
+        vbase = _mm_set1_epi8((char)base);
+    } else if (outSize == 2) {
+        vbase = _mm_set1_epi16((int16)base);
+    } else if (outSize == 4) {
+        vbase = _mm_set1_epi32((int32)base);
+    } else {
+        vbase = _mm_set1_epi64x(base);
+    }
+
+    int i = 0;
+    for (; i + lanes <= nvals; i += lanes) {
+        __m128i val = SseLoadLow(inbuf + i * inSize, lanes * inSize);
+
+        if (inSize == 1 && outSize == 2) {
+            val = _mm_cvtepu8_epi16(val);
+        } else if (inSize == 1 && outSize == 4) {
+            val = _mm_cvtepu8_epi32(val);
+        } else if (inSize == 1 && outSize == 8) {
+            val = _mm_cvtepu8_epi64(val);
+        } else if (inSize == 2 && outSize == 4) {
+            val = _mm_cvtepu16_epi32(val);
+        } else if (inSize == 2 && outSize == 8) {
+            val = _mm_cvtepu16_epi64(val);
+        } else if (inSize == 4 && outSize == 8) {
+            val = _mm_cvtepu32_epi64(val);
+        }
+
+        if (outSize == 1) {
+            val = _mm_add_epi8(val, vbase);
+        } else if (outSize == 2) {
+            val = _mm_add_epi16(val, vbase);
+        } else if (outSize == 4) {
+            val = _mm_add_epi32(val, vbase);
+        } else {
+            val = _mm_add_epi64(val, vbase);
+        }
+        _mm_storeu_si128((__m128i*)(outbuf + i * outSize), val);
+    }
+
+    if (i < nvals) {
+        ScalarUnpackAdd(inbuf + i * inSize, outbuf + i * outSize, nvals - i, inSize, outSize, base);
+    }
+}
+
+static int SseFindMarker(const char* inbuf, int nvals, short valSize, uint8 markerByte)
+{
+    const int lanes = 16 / valSize;
+    const __m128i marker = _mm_set1_epi8((char)markerByte);
+
+    int i = 0;
+    for (; i + lanes <= nvals; i += lanes) {
+        __m128i val = _mm_loadu_si128((const __m128i*)(inbuf + i * valSize));
+        uint64 byteMask = (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(val, marker));
+        if (byteMask != 0) {
+            uint64 mask = MarkerValueMask(byteMask, valSize, 1);
+            if (mask != 0) {
+                return i + __builtin_ctzll(mask) / valSize;
+            }
+        }
+    }
+    return i + ScalarFindMarker(inbuf + i * valSize, nvals - i, valSize, markerByte);
+}
+
+#ifdef USE_SIMD_DECODE_AVX2
+
+template <short inSize, short outSize>
+__attribute__((target("avx2"))) static void Avx2UnpackAddT(const char* inbuf, char* outbuf, int nvals, int64 base)
+{
+    const int lanes = 32 / outSize;
+    const int inBytes = lanes * inSize;
+    __m256i vbase;
+    if (outSize == 1) {
+        vbase = _mm256_set1_epi8((char)base);
+    } else if (outSize == 2) {
+        vbase = _mm256_set1_epi16((int16)base);
+    } else if (outSize == 4) {
+        vbase = _mm256_set1_epi32((int32)base);
+    } else {
+        vbase = _mm256_set1_epi64x(base);
+    }
+
+    int i = 0;
+    for (; i + lanes <= nvals; i += lanes) {
+        const char* ptr = inbuf + i * inSize;
+        __m256i val;
+
+        if (inSize == outSize) {
+            val = _mm256_loadu_si256((const __m256i*)ptr);
+        } else {
+            __m128i low;
+            if (inBytes == 16) {
+                low = _mm_loadu_si128((const __m128i*)ptr);
+            } else if (inBytes == 8) {
+                low = _mm_loadl_epi64((const __m128i*)ptr);
+            } else {
+                low = _mm_cvtsi32_si128(*(const int32*)ptr);
+            }
+
+            if (inSize == 1 && outSize == 2) {
+                val = _mm256_cvtepu8_epi16(low);
+            } else if (inSize == 1 && outSize == 4) {
+                val = _mm256_cvtepu8_epi32(low);
+            } else if (inSize == 1 && outSize == 8) {
+                val = _mm256_cvtepu8_epi64(low);
+            } else if (inSize == 2 && outSize == 4) {
+                val = _mm256_cvtepu16_epi32(low);
+            } else if (inSize == 2 && outSize == 8) {
+                val = _mm256_cvtepu16_epi64(low);
+            } else {
+                val = _mm256_cvtepu32_epi64(low);
+            }
+        }
+
+        if (outSize == 1) {
+            val = _mm256_add_epi8(val, vbase);
+        } else if (outSize == 2) {
+            val = _mm256_add_epi16(val, vbase);
+        } else if (outSize == 4) {
+            val = _mm256_add_epi32(val, vbase);
+        } else {
+            val = _mm256_add_epi64(val, vbase);
+        }
+        _mm256_storeu_si256((__m256i*)(outbuf + i * outSize), val);
+    }
+
+    if (i < nvals) {
+        ScalarUnpackAdd(inbuf + i * inSize, outbuf + i * outSize, nvals - i, inSize, outSize, base);
+    }
+}
+
+__attribute__((target("avx2"))) static int Avx2FindMarker(
+    const char* inbuf, int nvals, short valSize, uint8 markerByte)
+{
+    const int lanes = 32 / valSize;
+    const __m256i marker = _mm256_set1_epi8((char)markerByte);
+
+    int i = 0;
+    for (; i + lanes <= nvals; i += lanes) {
+        __m256i val = _mm256_loadu_si256((const __m256i*)(inbuf + i * valSize));
+        uint64 byteMask = (uint32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(val, marker));
+        if (byteMask != 0) {
+            uint64 mask = MarkerValueMask(byteMask, valSize, 1);
+            if (mask != 0) {
+                return i + __builtin_ctzll(mask) / valSize;
+            }
+        }
+    }
+    return i + SseFindMarker(inbuf + i * valSize, nvals - i, valSize, markerByte);
+}
+
+#endif /* USE_SIMD_DECODE_AVX2 */
+#endif /* USE_SIMD_DECODE_SSE41 */
+
+/*************************************************************************
+ *                         NEON                                           *
+ *************************************************************************/
+#ifdef USE_SIMD_DECODE_NEON
+
+template <short inSize, short outSize>
+static void NeonUnpackAddT(const char* inbuf, char* outbuf, int nvals, int64 base)
+{
+    const int lanes = 16 / outSize;
+    const int inBytes = lanes * inSize;
+
+    int i = 0;
+    for (; i + lanes <= nvals; i += lanes) {
+        const char* ptr = inbuf + i * inSize;
+        uint8x16_t val;
+
+        if (inSize == outSize) {
+            val = vld1q_u8((const uint8*)ptr);
+        } else {
+            uint64 raw;
+            if (inBytes == 8) {
+                raw = *(const uint64*)ptr;
+            } else if (inBytes == 4) {
+                raw = *(const uint32*)ptr;
+            } else {
+                raw = *(const uint16*)ptr;
+            }
+            uint8x8_t low = vcreate_u8(raw);
+
+            if (inSize == 1) {
+                uint16x8_t wide16 = vmovl_u8(low);
+                if (outSize == 2) {
+                    val = vreinterpretq_u8_u16(wide16);
+                } else {
+                    uint32x4_t wide32 = vmovl_u16(vget_low_u16(wide16));
+                    val = (outSize == 4) ? vreinterpretq_u8_u32(wide32)
+                                         : vreinterpretq_u8_u64(vmovl_u32(vget_low_u32(wide32)));
+                }
+            } else if (inSize == 2) {
+                uint32x4_t wide32 = vmovl_u16(vreinterpret_u16_u8(low));
+                val = (outSize == 4) ? vreinterpretq_u8_u32(wide32)
+                                     : vreinterpretq_u8_u64(vmovl_u32(vget_low_u32(wide32)));
+            } else {
+                val = vreinterpretq_u8_u64(vmovl_u32(vreinterpret_u32_u8(low)));
+            }
+        }
+
+        if (outSize == 1) {
+            val = vaddq_u8(val, vdupq_n_u8((uint8)base));
+        } else if (outSize == 2) {
+            val = vreinterpretq_u8_u16(vaddq_u16(vreinterpretq_u16_u8(val), vdupq_n_u16((uint16)base)));
+        } else if (outSize == 4) {
+            val = vreinterpretq_u8_u32(vaddq_u32(vreinterpretq_u32_u8(val), vdupq_n_u32((uint32)base)));
+        } else {
+            val = vreinterpretq_u8_u64(vaddq_u64(vreinterpretq_u64_u8(val), vdupq_n_u64((uint64)base)));
+        }
+        vst1q_u8((uint8*)(outbuf + i * outSize), val);
+    }
+
+    if (i < nvals) {
+        ScalarUnpackAdd(inbuf + i * inSize, outbuf + i * outSize, nvals - i, inSize, outSize, base);
+    }
+}
+
+static int NeonFindMarker(const char* inbuf, int nvals, short valSize, uint8 markerByte)
+{
+    const int lanes = 16 / valSize;
+    const uint8x16_t marker = vdupq_n_u8(markerByte);
+
+    int i = 0;
+    for (; i + lanes <= nvals; i += lanes) {
+        uint8x16_t cmp = vceqq_u8(vld1q_u8((const uint8*)(inbuf + i * valSize)), marker);
+        /* narrow each byte to 4 bits, as there is no movemask */
+        uint64 byteMask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+        if (byteMask != 0) {
+            uint64 mask = MarkerValueMask(byteMask, valSize, 4);
+            if (mask != 0) {
+                return i + __builtin_ctzll(mask) / 4 / valSize;
+            }
+        }
+    }
+    return i + ScalarFindMarker(inbuf + i * valSize, nvals - i, valSize, markerByte);
+}
+
+#endif /* USE_SIMD_DECODE_NEON */
+
+/*************************************************************************
+ *                         runtime dispatch                               *
+ *************************************************************************/
+#define UNPACK_ADD_DISPATCH(_func, inbuf, outbuf, nvals, inSize, outSize, base)  \
+    do {                                                                         \
+        switch ((inSize) * 16 + (outSize)) {                                     \
+            case 0x11:                                                           \
+                _func<1, 1>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x12:                                                           \
+                _func<1, 2>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x14:                                                           \
+                _func<1, 4>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x18:                                                           \
+                _func<1, 8>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x22:                                                           \
+                _func<2, 2>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x24:                                                           \
+                _func<2, 4>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x28:                                                           \
+                _func<2, 8>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x44:                                                           \
+                _func<4, 4>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            case 0x48:                                                           \
+                _func<4, 8>(inbuf, outbuf, nvals, base);                         \
+                break;                                                           \
+            default:                                                             \
+                ScalarUnpackAdd(inbuf, outbuf, nvals, inSize, outSize, base);    \
+                break;                                                           \
+        }                                                                        \
+    } while (0)
+
+#ifdef USE_SIMD_DECODE_SSE41
+static void SseUnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base)
+{
+    UNPACK_ADD_DISPATCH(SseUnpackAddT, inbuf, outbuf, nvals, inSize, outSize, base);
+}
+#endif
+
+#ifdef USE_SIMD_DECODE_AVX2
+static void Avx2UnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base)
+{
+    UNPACK_ADD_DISPATCH(Avx2UnpackAddT, inbuf, outbuf, nvals, inSize, outSize, base);
+}
+#endif
+
+#ifdef USE_SIMD_DECODE_NEON
+static void NeonUnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base)
+{
+    UNPACK_ADD_DISPATCH(NeonUnpackAddT, inbuf, outbuf, nvals, inSize, outSize, base);
+}
+#endif
+
+static void UnpackAddChoose(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base);
+static int FindMarkerChoose(const char* inbuf, int nvals, short valSize, uint8 markerByte);
+
+static UnpackAddFunc g_unpackAddFunc = UnpackAddChoose;
+static FindMarkerFunc g_findMarkerFunc = FindMarkerChoose;
+
+/* the instruction set used by both kernels */
+static const char* SimdDecodeChoose(UnpackAddFunc* unpackAdd, FindMarkerFunc* findMarker)
+{
+#if defined(USE_SIMD_DECODE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        *unpackAdd = Avx2UnpackAdd;
+        *findMarker = Avx2FindMarker;
+        return "avx2";
+    }
+#endif
+#if defined(USE_SIMD_DECODE_SSE41)
+    *unpackAdd = SseUnpackAdd;
+    *findMarker = SseFindMarker;
+    return "sse4.1";
+#elif defined(USE_SIMD_DECODE_NEON)
+    *unpackAdd = NeonUnpackAdd;
+    *findMarker = NeonFindMarker;
+    return "neon";
+#else
+    *unpackAdd = ScalarUnpackAdd;
+    *findMarker = ScalarFindMarker;
+    return "scalar";
+#endif
+}
+
+/*
+ * These get called on the first call. They replace the function pointers
+ * so that subsequent calls are routed directly to the chosen kernels. All
+ * the threads choose the same ones, so it's fine that they race.
+ */
+static void UnpackAddChoose(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base)
+{
+    FindMarkerFunc findMarker;
+    (void)SimdDecodeChoose(&g_unpackAddFunc, &findMarker);
+    g_unpackAddFunc(inbuf, outbuf, nvals, inSize, outSize, base);
+}
+
+static int FindMarkerChoose(const char* inbuf, int nvals, short valSize, uint8 markerByte)
+{
+    UnpackAddFunc unpackAdd;
+    (void)SimdDecodeChoose(&unpackAdd, &g_findMarkerFunc);
+    return g_findMarkerFunc(inbuf, nvals, valSize, markerByte);
+}
+
+void SimdUnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base)
+{
+    Assert(SimdUnpackAddSupported(inSize, outSize));
+    g_unpackAddFunc(inbuf, outbuf, nvals, inSize, outSize, base);
+}
+
+int SimdFindMarker(const char* inbuf, int nvals, short valSize, uint8 markerByte)
+{
+    Assert(SimdValueSizeSupported(valSize));
+    return g_findMarkerFunc(inbuf, nvals, valSize, markerByte);
+}
+
+template <typename ValType>
+static void FillValuesT(char* outbuf, int nvals, ValType value)
+{
+    /* plain typed stores, which compiler turns into vector stores */
+    ValType* out = (ValType*)outbuf;
+    for (int i = 0; i < nvals; ++i) {
+        out[i] = value;
+    }
+}
+
+void SimdFillValues(char* outbuf, int nvals, short valSize, int64 value)
+{
+    switch (valSize) {
+        case sizeof(uint8):
+            FillValuesT<uint8>(outbuf, nvals, (uint8)value);
+            break;
+        case sizeof(uint16):
+            FillValuesT<uint16>(outbuf, nvals, (uint16)value);
+            break;
+        case sizeof(uint32):
+            FillValuesT<uint32>(outbuf, nvals, (uint32)value);
+            break;
+        case sizeof(uint64):
+            FillValuesT<uint64>(outbuf, nvals, (uint64)value);
+            break;
+        default:
+            Assert(false);
+            break;
+    }
+}
+
+const char* SimdDecodeInstructionSet(void)
+{
+    UnpackAddFunc unpackAdd;
+    FindMarkerFunc findMarker;
+    return SimdDecodeChoose(&unpackAdd, &findMarker);
+}
@@ -30,6 +30,8 @@
 #include "utils/gs_bitmap.h"
 #include "utils/rel.h"
 #include "utils/rel_gs.h"
+#include "lz4.h"
+#include "lz4hc.h"
 
 extern int8 heaprel_get_compresslevel_from_modes(int16 modes);
 extern int8 heaprel_get_compression_from_modes(int16 modes);
@@ -296,6 +298,127 @@ static FORCE_INLINE void swapBuf(char *&buf1, char *&buf2, int &sz1, int &sz2)
     sz2 = tmpsz;
 }
 
+/*
+ * @Description: leave LZ4 or zlib of src to the task, see GeneralCompressTask.
+ *    The result buffer is allocated here, in the backend.
+ * @IN useZlib: zlib if true, otherwise LZ4
+ * @IN level: compression level of LZ4 or zlib
+ * @IN src: data to compress, valid until FinishGeneralCompress()
+ * @IN out: output of the codec, it is src itself if modes is not 0
+ * @IN modes: modes of the codec output before LZ4/zlib
+ */
+void DeferGeneralCompress(
+    GeneralCompressTask* task, bool useZlib, int level, char* src, int srcSize, char* out, uint16 modes)
+{
+    Size boundSize = useZlib ? compressBound((uLong)srcSize) : (SizeOfLz4Header + LZ4_compressBound(srcSize));
+
+    task->pending = true;
+    task->useZlib = useZlib;
+    task->level = level;
+    task->src = src;
+    task->srcSize = srcSize;
+    task->dst.buf = NULL;
+    task->dst.bufSize = 0;
+    task->dst.bufType = Unknown;
+    BufferHelperMalloc(&task->dst, boundSize);
+    task->out = out;
+    task->modes = modes;
+    task->generalMode = useZlib ? CU_ZlibCompressed : CU_LzCompressed;
+    task->prefixSize = 0;
+    task->cmprSize = 0;
+    task->errCode = Z_OK;
+}
+
+/*
+ * @Description: run LZ4 or zlib of a task into its result buffer, the same as
+ *    LZ4Wrapper::Compress() and ZlibEncoder::Compress() do. Nothing here
+ *    allocates from memory contexts or reports errors, so any thread may run it.
+ */
+void RunGeneralCompress(GeneralCompressTask* task)
+{
+    task->cmprSize = 0;
+    task->errCode = Z_OK;
+
+    if (task->useZlib) {
+        z_stream strm;
+
+        (void)memset_s(&strm, sizeof(strm), 0, sizeof(strm));
+        task->errCode = deflateInit(&strm, task->level);
+        if (task->errCode != Z_OK)
+            return;
+
+        strm.next_in = (Bytef*)task->src;
+        strm.avail_in = (uInt)task->srcSize;
+        strm.next_out = (Bytef*)task->dst.buf;
+        strm.avail_out = (uInt)task->dst.bufSize;
+        if (deflate(&strm, Z_FINISH) == Z_STREAM_END)
+            task->cmprSize = (int)(task->dst.bufSize - strm.avail_out);
+        (void)deflateEnd(&strm);
+    } else {
+        LZ4Wrapper::Lz4Header* header = (LZ4Wrapper::Lz4Header*)task->dst.buf;
+        int outsize = 0;
+
+        if (task->level == LZ4Wrapper::lz4_min_level) {
+            outsize = LZ4_compress_default(task->src, header->data, task->srcSize, LZ4_compressBound(task->srcSize));
+        } else {
+            outsize = LZ4_compress_HC(
+                task->src, header->data, task->srcSize, LZ4_compressBound(task->srcSize), task->level);
+        }
+        if (outsize > 0 && ((int)SizeOfLz4Header + outsize) < task->srcSize) {
+            header->compressLen = outsize;
+            header->rawLen = task->srcSize;
+            task->cmprSize = (int)SizeOfLz4Header + outsize;
+        }
+    }
+}
+
+/*
+ * @Description: complete the codec output after RunGeneralCompress(), in the backend.
+ * @OUT modes: the compression modes of the output are added
+ * @Return: size of the codec output, 0 if nothing is compressed
+ */
+int FinishGeneralCompress(GeneralCompressTask* task, uint16* modes)
+{
+    int size = 0;
+    errno_t rc = EOK;
+
+    Assert(task->pending);
+    task->pending = false;
+
+    if (task->errCode == Z_MEM_ERROR) {
+        BufferHelperFree(&task->dst);
+        ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("out of memory when preparing zlib encoder.")));
+    } else if (task->errCode != Z_OK) {
+        int errCode = task->errCode;
+        BufferHelperFree(&task->dst);
+        ereport(ERROR,
+            (errcode(ERRCODE_WRONG_OBJECT_TYPE), errmsg("error %d occurs when preparing zlib encoder.", errCode)));
+    }
+
+    if (task->cmprSize > 0 && task->cmprSize < task->srcSize) {
+        rc = memcpy_s(task->out, task->cmprSize, task->dst.buf, task->cmprSize);
+        securec_check(rc, "", "");
+        size = task->cmprSize;
+        task->modes |= task->generalMode;
+    } else if (task->modes != 0) {
+        /* the output of delta or RLE is left in place */
+        Assert(task->src == task->out);
+        size = task->srcSize;
+    }
+    BufferHelperFree(&task->dst);
+
+    if (size > 0 && task->prefixSize > 0) {
+        rc = memmove_s(task->out + task->prefixSize, size, task->out, size);
+        securec_check(rc, "", "");
+        rc = memcpy_s(task->out, task->prefixSize, task->prefix, task->prefixSize);
+        securec_check(rc, "", "");
+        size += task->prefixSize;
+    }
+
+    *modes |= task->modes;
+    return size;
+}
+
 IntegerCoder::IntegerCoder(short valSize)
     : m_adopt_rle(true), m_minVal(0), m_maxVal(0), m_isValid(false), m_eachValSize(valSize)
 {}
@@ -423,6 +546,19 @@ int IntegerCoder::CompressInner(const CompressionArg1& in, CompressionArg2& out)
         return ((out.modes != 0) ? out.sz : 0);
     }
 
+    // leave LZ4/Zlib to a helper thread, the min/max is inserted when it is finished
+    if (in.task != NULL) {
+        BufferHelperFree(&tempOutBuf);
+        DeferGeneralCompress(in.task, (compression == COMPRESS_HIGH), compresslevel_tables[compression][compresslevel],
+            currInBuf, currInBufSize, out.buf, out.modes);
+        if (out.modes & CU_DeltaCompressed) {
+            Int64DataConvertTo(this->m_minVal, this->m_eachValSize, in.task->prefix);
+            Int64DataConvertTo(this->m_maxVal, this->m_eachValSize, in.task->prefix + this->m_eachValSize);
+            in.task->prefixSize = this->m_eachValSize * 2;
+        }
+        return 0;
+    }
+
     if (compression == COMPRESS_MIDDLE) {
         LZ4Wrapper lz4;
         lz4.SetCompressionLevel(compresslevel_tables[compression][compresslevel]);
@@ -735,15 +871,47 @@ int StringCoder::CompressInner(CompressionArg1& in, CompressionArg2& out)
     }
 
     /* one of the followings,
-     * 1. dictionary compress fails, degrade to lz4/zlib compression method
+     * 1. dictionary compress fails, degrade to FSST or lz4/zlib compression method
      * 2. caller give the hint which don't adopt dictionary compression.
      */
-    cmprSize = this->CompressWithoutDict(in.buf, in.sz, in.mode, out.buf, out.sz, mode);
-    if (cmprSize > 0 && cmprSize < in.sz) {
+    char* fsstBuf = NULL;
+    int fsstSize = 0;
+    if (in.useFSST && m_adopt_fsst) {
+        fsstBuf = (char*)palloc(in.sz);
+        fsstSize = this->CompressWithFSST(in.buf, in.sz, fsstBuf, Min(in.sz, out.sz));
+    }
+
+    /* without FSST to compare with, lz4/zlib may be left to a helper thread */
+    if (fsstSize == 0 && in.task != NULL) {
+        int8 compression = heaprel_get_compression_from_modes(in.mode);
+        int8 compresslevel = heaprel_get_compresslevel_from_modes(in.mode);
+        DeferGeneralCompress(in.task, (compression == COMPRESS_HIGH), compresslevel_tables[compression][compresslevel],
+            in.buf, in.sz, out.buf, 0);
+        if (fsstBuf != NULL)
+            pfree(fsstBuf);
+        return 0;
+    }
+
+    /* FSST has won the sampling CU, trust it for the rest */
+    if (fsstSize == 0 || !m_fsst_only) {
+        cmprSize = this->CompressWithoutDict(in.buf, in.sz, in.mode, out.buf, out.sz, mode);
+        if (!(cmprSize > 0 && cmprSize < in.sz))
+            cmprSize = 0;
+    }
+
+    /* FSST is preferred unless lz4/zlib compresses better */
+    if (fsstSize > 0 && (cmprSize == 0 || fsstSize <= cmprSize)) {
+        errno_t rc = memcpy_s(out.buf, out.sz, fsstBuf, fsstSize);
+        securec_check(rc, "", "");
+        out.modes |= CU_FSSTCompressed;
+        cmprSize = fsstSize;
+    } else if (cmprSize > 0) {
         out.modes |= mode;
-        return cmprSize;
     }
-    return 0;
+
+    if (fsstBuf != NULL)
+        pfree(fsstBuf);
+    return cmprSize;
 }
 
 /* enumerate possible instances */
@@ -813,6 +981,22 @@ int StringCoder::CompressWithoutDict(_in_ char* inBuf, _in_ int inBufSize, _in_
     return outSize;
 }
 
+/*
+ * @Description: compress var-length strings by FSST. Symbols up to 8 bytes are
+ *     learned from the data and each is replaced by one byte code, so short
+ *     strings which repeat pieces but not whole values compress well while
+ *     decoding is simply copying symbols.
+ * @Return: compressed size, or 0 if FSST does not make data smaller.
+ */
+int StringCoder::CompressWithFSST(_in_ char* inBuf, _in_ int inBufSize, _out_ char* outBuf, _in_ int outBufSize)
+{
+    FSSTCoder fsst;
+    fsst.BuildSymbolTable(inBuf, inBufSize);
+
+    int outSize = fsst.Compress(inBuf, inBufSize, outBuf, outBufSize);
+    return (outSize > 0 && outSize < inBufSize) ? outSize : 0;
+}
+
 int StringCoder::DecompressWithoutDict(
     _in_ char* inBuf, _in_ int inBufSize, _in_ uint16 mode, _out_ char* outBuf, _out_ int outBufSize)
 {
@@ -844,6 +1028,12 @@ int StringCoder::DecompressWithoutDict(
 
 int StringCoder::Decompress(_in_ const CompressionArg2& in, _out_ CompressionArg1& out)
 {
+    // case 0: FSST method, whose mode shares the bits of other methods
+    if (CU_MODE_IS_FSST(in.modes)) {
+        FSSTCoder fsst;
+        return fsst.Decompress(in.buf, in.sz, out.buf, out.sz);
+    }
+
     // case 1: dictionary method is not applied to, so use lz4/zlib directly to decompress
     if ((in.modes & CU_DicEncode) == 0) {
         return DecompressWithoutDict(in.buf, in.sz, in.modes, out.buf, out.sz);
@@ -2870,6 +3060,7 @@ void compression_options::reset(void)
     m_adopt_numeric2int_int64_rle = true;
     m_adopt_dict = true;
     m_adopt_rle = true;
+    m_adopt_fsst = u_sess->attr.attr_storage.enable_cstore_fsst;
 }
 
 /*
@@ -2891,8 +3082,15 @@ void compression_options::set_numeric_flags(uint16 modes)
  */
 void compression_options::set_common_flags(uint32 modes)
 {
+    if (CU_MODE_IS_FSST(modes)) {
+        m_adopt_dict = false;
+        m_adopt_rle = false;
+        m_adopt_fsst = true;
+        return;
+    }
     m_adopt_dict = ((modes & CU_DicEncode) != 0);
     m_adopt_rle = ((modes & CU_RLECompressed) != 0);
+    m_adopt_fsst = false;
 }
 
 #ifdef ENABLE_UT
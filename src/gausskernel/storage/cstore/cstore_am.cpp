@@ -55,6 +55,7 @@
 #include "vecexecutor/vecnodes.h"
 #include "vecexecutor/vecnoderowtovector.h"
 #include "access/cstore_roughcheck_func.h"
+#include "access/cstore_summary.h"
 #include "utils/snapmgr.h"
 #include "catalog/storage.h"
 #include "miscadmin.h"
@@ -103,6 +104,7 @@ CStore::CStore()
       m_colId(NULL),
       m_sysColId(NULL),
       m_lateRead(NULL),
+      m_lateQual(NULL),
       m_cuStorage(NULL),
       m_CUDescInfo(NULL),
       m_virtualCUDescInfo(NULL),
@@ -113,6 +115,13 @@ CStore::CStore()
       m_load_finish(false),
       m_scanPosInCU(NULL),
       m_RCFuncs(NULL),
+      m_FCFuncs(NULL),
+      m_fullHitBatch(false),
+      m_topnRCFunc(NULL),
+      m_topnSeq(-1),
+      m_needCUSummary(NULL),
+      m_runtimeFilters(NULL),
+      m_runtimeFilterNum(0),
       m_fillVectorByTids(NULL),
       m_fillVectorLateRead(NULL),
       m_colFillFunArrary(NULL),
@@ -136,7 +145,8 @@ CStore::CStore()
       m_useBtreeIndex(false),
       m_firstColIdx(0),
       m_cuDescIdx(-1),
-      m_laterReadCtidColIdx(-1)
+      m_laterReadCtidColIdx(-1),
+      m_lateReadCtidSeq(-1)
 {
     // if you intend to allocate any space in cstore constructor/init scan function
     // please remind that you must put the space deallocate in the deconstructor function
@@ -234,6 +244,7 @@ void CStore::InitFillVecEnv(CStoreScanState* state)
         m_colNum = list_length(pColList);
         m_colId = (int*)palloc(sizeof(int) * m_colNum);
         m_lateRead = (bool*)palloc0(sizeof(bool) * m_colNum);
+        m_lateQual = (bool*)palloc0(sizeof(bool) * m_colNum);
 
         int i = 0;
         ListCell* cell = NULL;
@@ -258,6 +269,27 @@ void CStore::InitFillVecEnv(CStoreScanState* state)
             }
         }
 
+        // The columns referenced only by the clauses other than the scan keys
+        // are late read too, they are filled after the scan keys filter the batch
+        foreach (cell, state->m_lateQualVars) {
+            int colId = lfirst_int(cell) - 1;
+            for (i = 0; i < m_colNum; ++i) {
+                if (colId == m_colId[i]) {
+                    m_lateRead[i] = true;
+                    m_lateQual[i] = true;
+                    break;
+                }
+            }
+        }
+
+        // ctid is kept in a column filled by the last late read if there is one
+        m_lateReadCtidSeq = -1;
+        for (i = 0; i < m_colNum; ++i) {
+            if (m_lateRead[i] && (m_lateReadCtidSeq < 0 || (m_lateQual[m_lateReadCtidSeq] && !m_lateQual[i]))) {
+                m_lateReadCtidSeq = i;
+            }
+        }
+
         m_scanPosInCU = (int*)palloc0(sizeof(int) * m_colNum);
         m_CUDescInfo = (LoadCUDescCtl**)palloc(sizeof(LoadCUDescCtl*) * m_colNum);
         m_colFillFunArrary = (colFillArray*)palloc(sizeof(colFillArray) * m_colNum);
@@ -299,6 +331,13 @@ void CStore::InitRoughCheckEnv(CStoreScanState* state)
     // so use m_scanMemContext which is not freed at all until the end.
     AutoContextSwitch newMemCnxt(m_scanMemContext);
 
+    // Bloom filters of CU are only loaded without ADIO, because ADIO keeps
+    // the CUDesc of former loads while m_perScanMemCnxt is reset.
+    bool* summaryCols = NULL;
+    if (!g_instance.attr.attr_storage.enable_adio_function) {
+        summaryCols = CStoreGetSummaryColumns(state->ss_currentRelation);
+    }
+
     // Initialize rough check function
     int nkeys = state->csss_NumScanKeys;
     if (nkeys > 0) {
@@ -307,10 +346,84 @@ void CStore::InitRoughCheckEnv(CStoreScanState* state)
         Relation rel = state->ss_currentRelation;
         Form_pg_attribute* attrs = rel->rd_att->attrs;
 
+        bool allFullCheck = true;
         m_RCFuncs = (RoughCheckFunc*)palloc(sizeof(RoughCheckFunc) * nkeys);
+        m_FCFuncs = (FullCheckFunc*)palloc(sizeof(FullCheckFunc) * nkeys);
         for (int i = 0; i < nkeys; i++) {
             int colIdx = m_colId[scanKey[i].cs_attno];
             m_RCFuncs[i] = GetRoughCheckFunc(attrs[colIdx]->atttypid, scanKey[i].cs_strategy, scanKey[i].cs_collation);
+            m_FCFuncs[i] = GetFullCheckFunc(attrs[colIdx]->atttypid, scanKey[i].cs_strategy);
+            if (m_FCFuncs[i] == NULL) {
+                allFullCheck = false;
+            }
+        }
+        // full hit is only known when every key has a full check, but every key keeps its rough check
+        if (!allFullCheck) {
+            pfree_ext(m_FCFuncs);
+        }
+
+        // bloom filter only helps the equality keys
+        for (int i = 0; summaryCols != NULL && i < nkeys; i++) {
+            int colIdx = m_colId[scanKey[i].cs_attno];
+            if (summaryCols[colIdx] && scanKey[i].cs_strategy == CStoreEqualStrategyNumber) {
+                if (m_needCUSummary == NULL) {
+                    m_needCUSummary = (bool*)palloc0(sizeof(bool) * rel->rd_att->natts);
+                }
+                m_needCUSummary[colIdx] = true;
+            }
+        }
+    }
+
+    InitRuntimeFilterEnv(state, summaryCols);
+
+    if (summaryCols != NULL) {
+        pfree(summaryCols);
+    }
+}
+
+/*
+ * @Description: resolve the runtime bloom filters which the hash join above
+ *               will build for the columns of this scan, see set_bloomfilter().
+ * @Param[IN] state: cstore scan state
+ * @Param[IN] summaryCols: columns having CU bloom filter, may be NULL
+ * @See also: RuntimeFilterCheckIfNeed
+ */
+void CStore::InitRuntimeFilterEnv(CStoreScanState* state, const bool* summaryCols)
+{
+    Plan* plan = state->ps.plan;
+    int nfilters = list_length(plan->var_list);
+
+    if (nfilters == 0 || m_colNum == 0) {
+        return;
+    }
+    Assert(nfilters == list_length(plan->filterIndexList));
+
+    m_runtimeFilters = (CStoreRuntimeFilter*)palloc0(sizeof(CStoreRuntimeFilter) * nfilters);
+    for (int i = 0; i < nfilters; i++) {
+        Var* var = (Var*)list_nth(plan->var_list, i);
+        int colIdx = var->varattno - 1;
+        int seq = -1;
+
+        for (int j = 0; j < m_colNum; ++j) {
+            if (m_colId[j] == colIdx) {
+                seq = j;
+                break;
+            }
+        }
+        if (seq < 0) {
+            continue;
+        }
+
+        CStoreRuntimeFilter* rf = &m_runtimeFilters[m_runtimeFilterNum++];
+        rf->seq = seq;
+        rf->bfIndex = list_nth_int(plan->filterIndexList, i);
+        rf->bf = NULL;
+
+        if (summaryCols != NULL && summaryCols[colIdx]) {
+            if (m_needCUSummary == NULL) {
+                m_needCUSummary = (bool*)palloc0(sizeof(bool) * m_relation->rd_att->natts);
+            }
+            m_needCUSummary[colIdx] = true;
         }
     }
 }
@@ -384,6 +497,7 @@ CStore::~CStore()
     m_scanPosInCU = NULL;
     m_colId = NULL;
     m_lateRead = NULL;
+    m_lateQual = NULL;
     m_scanMemContext = NULL;
     m_snapshot = NULL;
     m_fillVectorByTids = NULL;
@@ -391,6 +505,10 @@ CStore::~CStore()
     m_CUDescInfo = NULL;
     m_perScanMemCnxt = NULL;
     m_RCFuncs = NULL;
+    m_FCFuncs = NULL;
+    m_topnRCFunc = NULL;
+    m_needCUSummary = NULL;
+    m_runtimeFilters = NULL;
     m_CUDescIdx = NULL;
     m_colFillFunArrary = NULL;
     m_cuStorage = NULL;
@@ -848,6 +966,8 @@ void CStore::CStoreScanWithCU(_in_ CStoreScanState* state, __inout BatchCUData*
 // Scan ColStore table and fill vecBatchOut
 void CStore::CStoreScan(_in_ CStoreScanState* state, _out_ VectorBatch* vecBatchOut)
 {
+    m_fullHitBatch = false;
+
     // step1: The number of holding CUDesc is  max_loaded_cudesc
     // if we load all CUDesc once, the memory will not enough.
     // So we load CUdesc once for max_loaded_cudesc
@@ -877,15 +997,38 @@ void CStore::CStoreScan(_in_ CStoreScanState* state, _out_ VectorBatch* vecBatch
     }
     ADIO_END();
 
-    // step4: Fill VecBatch
+    // step4: Skip CUs by the boundary of top-N sort and the runtime
+    // bloom filters of hash join if need
+    // the remaining CUs of this load may all be skipped.
+    TopNBoundCheckIfNeed(state);
+    RuntimeFilterCheckIfNeed(state);
+    ADIO_RUN()
+    {
+        if (unlikely(m_cursor == m_NumCUDescIdx)) {
+            return;
+        }
+    }
+    ADIO_ELSE()
+    {
+        if (unlikely(m_cursor >= m_NumLoadCUDesc)) {
+            return;
+        }
+    }
+    ADIO_END();
+
+    // step5: Check whether the whole CU satisfy the scan keys
+    // then quals of the scan keys needn't be evaluated on its rows.
+    FullCheckIfNeed(state);
+
+    // step6: Fill VecBatch
     CSTORESCAN_TRACE_START(FILL_BATCH);
     int deadRows = FillVecBatch(vecBatchOut);
     CSTORESCAN_TRACE_END(FILL_BATCH);
 
-    // step5: refresh cursor
+    // step7: refresh cursor
     RefreshCursor(vecBatchOut->m_rows, deadRows);
 
-    // step6: prefetch if need
+    // step8: prefetch if need
     ADIO_RUN()
     {
         CSTORESCAN_TRACE_START(PREFETCH_CU_LIST);
@@ -1163,17 +1306,71 @@ bool CStore::RoughCheck(CStoreScanKey scanKey, int nkeys, int cuDescIdx)
         CUDesc* cudesc = &(m_CUDescInfo[seq]->cuDescArray[cuDescIdx]);
         bool isNullKey = scanKey[j].cs_flags & SK_ISNULL;
         if ((cudesc->IsNullCU() && !isNullKey) || cudesc->IsNoMinMaxCU())
-            continue;
-        if (isNullKey)
+            hitCU = true;
+        else if (isNullKey)
             hitCU = cudesc->CUHasNull() || cudesc->IsNullCU();
         else
             hitCU = m_RCFuncs[j](cudesc, scanKey[j].cs_argument);
+
+        // the value within min/max may still be absent from the bloom filter of CU
+        if (hitCU && cudesc->cu_summary != NULL && !isNullKey && scanKey[j].cs_strategy == CStoreEqualStrategyNumber) {
+            Oid typeOid = m_relation->rd_att->attrs[m_colId[seq]]->atttypid;
+            hitCU = CUSummaryMayContain(cudesc->cu_summary, CUSummaryHashScanKey(typeOid, scanKey[j].cs_argument));
+        }
         if (!hitCU)
             break;
     }
     return hitCU;
 }
 
+/*
+ * @Description: check whether all the rows of CU satisfy the scan keys
+ * @Param[IN] cuDescIdx:index of load cudesc info
+ * @Param[IN] nkeys: keys of scanKey
+ * @Param[IN] scanKey: cstore scan key
+ * @Return: true--all the rows satisfy, false--unknown
+ * @See also: RoughCheck. A key whose argument was cast to the column type
+ *            lossily is still evaluated on the rows of a full hit batch,
+ *            see exec_cstore_split_qual.
+ */
+bool CStore::FullCheck(CStoreScanKey scanKey, int nkeys, int cuDescIdx)
+{
+    for (int j = 0; j < nkeys; j++) {
+        int seq = scanKey[j].cs_attno;
+        CUDesc* cudesc = &(m_CUDescInfo[seq]->cuDescArray[cuDescIdx]);
+
+        // NULL never satisfies a comparison
+        if ((scanKey[j].cs_flags & SK_ISNULL) || cudesc->IsNullCU() || cudesc->CUHasNull() || cudesc->IsNoMinMaxCU())
+            return false;
+        if (!m_FCFuncs[j](cudesc, scanKey[j].cs_argument))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * @Description: check whether the CU at cursor fully satisfies the scan keys
+ *               by its min/max. If so, the batches filled from it are marked
+ *               and the scan keys are not evaluated on each row again.
+ * @Param[IN] state: cstore scan state
+ * @See also:
+ */
+void CStore::FullCheckIfNeed(_in_ CStoreScanState* state)
+{
+    int nkeys = state->csss_NumScanKeys;
+    PlanState* planstate = (PlanState*)state;
+
+    if (likely(m_FCFuncs == NULL || nkeys == 0 || m_colNum == 0)) {
+        return;
+    }
+
+    m_fullHitBatch = FullCheck(state->csss_ScanKeys, nkeys, m_CUDescIdx[m_cursor]);
+
+    if (m_fullHitBatch && m_rowCursorInCU == 0 && planstate->instrument) {
+        planstate->instrument->rcInfo.IncFullCUNum();
+    }
+}
+
 void CStore::RoughCheckIfNeed(_in_ CStoreScanState* state)
 {
     int nkeys = state->csss_NumScanKeys;
@@ -1261,6 +1458,259 @@ void CStore::RoughCheckIfNeed(_in_ CStoreScanState* state)
     m_needRCheck = false;
 }
 
+/*
+ * @Description: check whether the CU could be skipped by the top-N boundary
+ * @Param[IN] bound: boundary of the top-N sort above, not null
+ * @Param[IN] cudesc: cudesc of the leading sort key
+ * @Return: true--no value of this CU could enter the top-N heap
+ * @See also:
+ */
+bool CStore::TopNBoundSkipCU(CStoreScanTopNBound* bound, CUDesc* cudesc) const
+{
+    if (cudesc->IsNoMinMaxCU())
+        return false;
+
+    // NULLs sort after the boundary only for NULLS LAST, a non-null boundary is strictly better
+    if (cudesc->IsNullCU())
+        return !bound->nullsFirst;
+    if (bound->nullsFirst && cudesc->CUHasNull())
+        return false;
+
+    return !m_topnRCFunc(cudesc, bound->value);
+}
+
+/*
+ * @Description: skip the CUs at cursor which can not beat the boundary of
+ *               the top-N sort above. It is done before a CU is read, so a
+ *               bounded sort over a large table only reads the CUs that
+ *               still matter once its heap is full.
+ * @Param[IN] state: cstore scan state
+ * @See also:
+ */
+void CStore::TopNBoundCheckIfNeed(_in_ CStoreScanState* state)
+{
+    CStoreScanTopNBound* bound = state->m_topnBound;
+    PlanState* planstate = (PlanState*)state;
+
+    // only at the beginning of a CU, and the boundary must be known
+    if (likely(bound == NULL) || !bound->valid || bound->isnull || m_rowCursorInCU != 0 || m_colNum == 0) {
+        return;
+    }
+
+    if (unlikely(m_topnSeq < 0)) {
+        for (int i = 0; i < m_colNum; ++i) {
+            if (m_colId[i] == bound->attno - 1) {
+                m_topnSeq = i;
+                break;
+            }
+        }
+
+        // the leading sort key is not read by this scan, never try again
+        if (m_topnSeq < 0) {
+            state->m_topnBound = NULL;
+            return;
+        }
+        m_topnRCFunc = GetRoughCheckFunc(m_relation->rd_att->attrs[m_colId[m_topnSeq]]->atttypid,
+            bound->strategy, bound->collation);
+    }
+
+    for (;;) {
+        ADIO_RUN()
+        {
+            if (m_cursor == m_NumCUDescIdx) {
+                break;
+            }
+        }
+        ADIO_ELSE()
+        {
+            if (m_cursor >= m_NumLoadCUDesc) {
+                break;
+            }
+        }
+        ADIO_END();
+
+        CUDesc* cudesc = &(m_CUDescInfo[m_topnSeq]->cuDescArray[m_CUDescIdx[m_cursor]]);
+        if (!TopNBoundSkipCU(bound, cudesc)) {
+            break;
+        }
+
+        IncLoadCuDescIdx(m_cursor);
+
+        if (planstate->instrument) {
+            RCInfo* rcPtr = &(planstate->instrument->rcInfo);
+
+            // it has been counted as hit if the scan keys are rough checked
+            if (state->csss_NumScanKeys > 0 && rcPtr->m_CUSome > 0)
+                --rcPtr->m_CUSome;
+            rcPtr->IncNoneCUNum();
+            planstate->instrument->needRCInfo = true;
+        }
+    }
+}
+
+static inline bool IsRuntimeFilterIntType(Oid typeOid)
+{
+    return (typeOid == INT2OID || typeOid == INT4OID || typeOid == INT8OID);
+}
+
+static inline bool IsRuntimeFilterStringType(Oid typeOid)
+{
+    return (typeOid == TEXTOID || typeOid == VARCHAROID || typeOid == BPCHAROID);
+}
+
+static int64 RuntimeFilterDatumGetInt64(Oid typeOid, Datum value)
+{
+    switch (typeOid) {
+        case INT2OID:
+            return (int64)DatumGetInt16(value);
+        case INT4OID:
+            return (int64)DatumGetInt32(value);
+        default:
+            return DatumGetInt64(value);
+    }
+}
+
+/*
+ * @Description: take out the values used to skip CUs from a new runtime
+ *               bloom filter. Min/max is used for integer columns, and the
+ *               bloom filter of CU is probed if the filter holds one value.
+ * @Param[IN] rf: runtime filter of this scan
+ * @Param[IN] bf: bloom filter built by hash join, may be NULL
+ * @See also: RuntimeFilterSkipCU
+ */
+void CStore::RefreshRuntimeFilter(CStoreRuntimeFilter* rf, filter::BloomFilter* bf)
+{
+    rf->bf = bf;
+    rf->useMinMax = false;
+    rf->useSummary = false;
+
+    if (bf == NULL || !bf->hasMinMax()) {
+        return;
+    }
+
+    int colIdx = m_colId[rf->seq];
+    Oid colType = m_relation->rd_att->attrs[colIdx]->atttypid;
+    Oid bfType = bf->getDataType();
+    bool singleValue = false;
+
+    if (IsRuntimeFilterIntType(colType) && IsRuntimeFilterIntType(bfType)) {
+        rf->min = Int64GetDatum(RuntimeFilterDatumGetInt64(bfType, bf->getMin()));
+        rf->max = Int64GetDatum(RuntimeFilterDatumGetInt64(bfType, bf->getMax()));
+        rf->useMinMax = true;
+        singleValue = (DatumGetInt64(rf->min) == DatumGetInt64(rf->max));
+        if (singleValue) {
+            rf->hash = CUSummaryHashDatum(INT8OID, rf->min);
+        }
+    } else if (IsRuntimeFilterStringType(colType) && IsRuntimeFilterStringType(bfType) &&
+               ((colType == BPCHAROID) == (bfType == BPCHAROID))) {
+        /* blank-padded and other strings are not equal in the same way */
+        text* minText = DatumGetTextPP(bf->getMin());
+        text* maxText = DatumGetTextPP(bf->getMax());
+        singleValue = VARSIZE_ANY_EXHDR(minText) == VARSIZE_ANY_EXHDR(maxText) &&
+                      memcmp(VARDATA_ANY(minText), VARDATA_ANY(maxText), VARSIZE_ANY_EXHDR(minText)) == 0;
+        if (singleValue) {
+            rf->hash = CUSummaryHashDatum(bfType, PointerGetDatum(minText));
+        }
+    }
+
+    rf->useSummary = singleValue && m_needCUSummary != NULL && m_needCUSummary[colIdx];
+}
+
+/*
+ * @Description: check whether no row of the CU could join the runtime
+ *               bloom filters built by the hash join above.
+ * @Param[IN] state: cstore scan state
+ * @Param[IN] cuDescIdx: index of load cudesc info
+ * @Return: true--the CU can be skipped
+ * @See also: RuntimeFilterCheckIfNeed
+ */
+bool CStore::RuntimeFilterSkipCU(CStoreScanState* state, int cuDescIdx)
+{
+    filter::BloomFilter** bfarray = state->ps.state->es_bloom_filter.bfarray;
+
+    for (int i = 0; i < m_runtimeFilterNum; i++) {
+        CStoreRuntimeFilter* rf = &m_runtimeFilters[i];
+        filter::BloomFilter* bf = bfarray[rf->bfIndex];
+
+        if (bf != rf->bf) {
+            RefreshRuntimeFilter(rf, bf);
+        }
+        if (bf == NULL) {
+            continue;
+        }
+
+        // NULL never joins
+        CUDesc* cudesc = &(m_CUDescInfo[rf->seq]->cuDescArray[cuDescIdx]);
+        if (cudesc->IsNullCU()) {
+            return true;
+        }
+
+        if (rf->useMinMax && !cudesc->IsNoMinMaxCU()) {
+            Oid colType = m_relation->rd_att->attrs[m_colId[rf->seq]]->atttypid;
+            if (!GetRoughCheckFunc(colType, CStoreGreaterEqualStrategyNumber, InvalidOid)(cudesc, rf->min) ||
+                !GetRoughCheckFunc(colType, CStoreLessEqualStrategyNumber, InvalidOid)(cudesc, rf->max)) {
+                return true;
+            }
+        }
+
+        if (rf->useSummary && cudesc->cu_summary != NULL && !CUSummaryMayContain(cudesc->cu_summary, rf->hash)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * @Description: skip the CUs at cursor which can not join the runtime bloom
+ *               filters of the hash join above. The filters are looked up
+ *               each time, since they only exist after the hash table is
+ *               built and may be rebuilt on rescan.
+ * @Param[IN] state: cstore scan state
+ * @See also: TopNBoundCheckIfNeed
+ */
+void CStore::RuntimeFilterCheckIfNeed(_in_ CStoreScanState* state)
+{
+    PlanState* planstate = (PlanState*)state;
+
+    // only at the beginning of a CU
+    if (likely(m_runtimeFilterNum == 0) || m_rowCursorInCU != 0 ||
+        planstate->state->es_bloom_filter.bfarray == NULL) {
+        return;
+    }
+
+    for (;;) {
+        ADIO_RUN()
+        {
+            if (m_cursor == m_NumCUDescIdx) {
+                break;
+            }
+        }
+        ADIO_ELSE()
+        {
+            if (m_cursor >= m_NumLoadCUDesc) {
+                break;
+            }
+        }
+        ADIO_END();
+
+        if (!RuntimeFilterSkipCU(state, m_CUDescIdx[m_cursor])) {
+            break;
+        }
+
+        IncLoadCuDescIdx(m_cursor);
+
+        if (planstate->instrument) {
+            RCInfo* rcPtr = &(planstate->instrument->rcInfo);
+
+            // it has been counted as hit if the scan keys are rough checked
+            if (state->csss_NumScanKeys > 0 && rcPtr->m_CUSome > 0)
+                --rcPtr->m_CUSome;
+            rcPtr->IncNoneCUNum();
+            planstate->instrument->needRCInfo = true;
+        }
+    }
+}
+
 void CStore::InitReScan()
 {
     /* Set scan cu range */
@@ -1360,8 +1810,11 @@ bool CStore::IsLateRead(int id) const
 
 void CStore::ResetLateRead()
 {
-    for (int i = 0; i < m_colNum; ++i)
+    for (int i = 0; i < m_colNum; ++i) {
         m_lateRead[i] = false;
+        m_lateQual[i] = false;
+    }
+    m_lateReadCtidSeq = -1;
 }
 
 /*
@@ -1589,8 +2042,13 @@ HeapTuple CStore::FormCudescTuple(_in_ CUDesc* pCudesc, _in_ TupleDesc pCudescTu
     pTupVals[CUDescCUMagicAttr - 1] = UInt32GetDatum(pCudesc->magic);
     Assert(pTupVals[CUDescCUMagicAttr - 1] > 0);
 
-    // add attribute extra and set null flag.
-    pTupNulls[CUDescCUExtraAttr - 1] = true;
+    // attribute extra keeps the bloom filter and value counts of CU if any.
+    if (pCudesc->cu_summary != NULL) {
+        pTupVals[CUDescCUExtraAttr - 1] = PointerGetDatum(cstring_to_text_with_len(
+            (const char*)pCudesc->cu_summary, CUSummarySize(pCudesc->cu_summary->bloom_bits)));
+    } else {
+        pTupNulls[CUDescCUExtraAttr - 1] = true;
+    }
 
     return heap_form_tuple(pCudescTupDesc, pTupVals, pTupNulls);
 }
@@ -2101,6 +2559,9 @@ void CStore::SaveCUDesc(_in_ Relation rel, _in_ CUDesc* cuDescPtr, _in_ int col,
     pfree(DatumGetPointer(values[CUDescMinAttr - 1]));
     pfree(DatumGetPointer(values[CUDescMaxAttr - 1]));
     pfree(DatumGetPointer(values[CUDescCUPointerAttr - 1]));
+    if (!nulls[CUDescCUExtraAttr - 1]) {
+        pfree(DatumGetPointer(values[CUDescCUExtraAttr - 1]));
+    }
 
     index_close(idx_rel, RowExclusiveLock);
     heap_close(cudesc_rel, RowExclusiveLock);
@@ -2276,6 +2737,12 @@ bool CStore::LoadCUDesc(
         cuDescArray[loadCUDescInfoPtr->curLoadNum].magic = DatumGetUInt32(values[CUDescCUMagicAttr - 1]);
         Assert(!isnull[CUDescCUMagicAttr - 1]);
 
+        /* Put bloom filter and value counts into cudesc->cu_summary if rough check needs it */
+        cuDescArray[loadCUDescInfoPtr->curLoadNum].cu_summary = NULL;
+        if (m_needCUSummary != NULL && m_needCUSummary[col] && !isnull[CUDescCUExtraAttr - 1]) {
+            cuDescArray[loadCUDescInfoPtr->curLoadNum].cu_summary = DeformCUSummary(values[CUDescCUExtraAttr - 1]);
+        }
+
         found = true;
 
         IncLoadCuDescIdx(*(int*)&loadCUDescInfoPtr->curLoadNum);
@@ -2313,7 +2780,6 @@ int CStore::FillVecBatch(_out_ VectorBatch* vecBatchOut)
     int idx = m_CUDescIdx[m_cursor];
     int deadRows = 0, i;
     this->m_cuDescIdx = idx;
-    bool hasCtidForLateRead = false;
 
     /* Step 1: fill normal columns if need */
     for (i = 0; i < m_colNum; ++i) {
@@ -2337,21 +2803,28 @@ int CStore::FillVecBatch(_out_ VectorBatch* vecBatchOut)
                 int funIdx = m_hasDeadRow ? 1 : 0;
                 deadRows = (this->*m_colFillFunArrary[i].colFillFun[funIdx])(i, cuDescPtr, vec);
             } else {
-                // We haven't fill ctid for late read columns
-                if (!hasCtidForLateRead) {
+                // Fill ctid for late read columns
+                if (i == m_lateReadCtidSeq) {
                     if (!m_hasDeadRow)
                         deadRows = FillTidForLateRead<false>(cuDescPtr, vec);
                     else
                         deadRows = FillTidForLateRead<true>(cuDescPtr, vec);
 
-                    hasCtidForLateRead = true;
                     this->m_laterReadCtidColIdx = colIdx;
+                } else if (i < m_lateReadCtidSeq) {
+                    // The number of rows is not known until ctid is filled
+                    continue;
                 } else
                     vec->m_rows = vecBatchOut->m_rows;
             }
             vecBatchOut->m_rows = vec->m_rows;
         }
     }
+    for (i = 0; i < m_lateReadCtidSeq; ++i) {
+        if (IsLateRead(i) && m_colId[i] >= 0) {
+            vecBatchOut->m_arr[m_colId[i]].m_rows = vecBatchOut->m_rows;
+        }
+    }
 
     // Step 2: fill sys columns if need
     for (i = 0; i < m_sysColNum; ++i) {
@@ -2978,36 +3451,51 @@ void CStore::FillVectorByTids(_in_ int colIdx, _in_ ScalarVector* tids, _out_ Sc
 }
 
 void CStore::FillScanBatchLateIfNeed(__inout VectorBatch* vecBatch)
+{
+    FillLateReadColumns(vecBatch, false);
+}
+
+/*
+ * @Description: fill the late read columns which the qual needs after the scan keys
+ *	have filtered the batch, so that their CUs are not loaded for the CUs and rows
+ *	rejected by the scan keys.
+ * @in/out vecBatch: the scan batch packed by the scan keys.
+ */
+void CStore::FillScanBatchLateQualIfNeed(__inout VectorBatch* vecBatch)
+{
+    FillLateReadColumns(vecBatch, true);
+}
+
+void CStore::FillLateReadColumns(VectorBatch* vecBatch, bool lateQual)
 {
     ScalarVector* tidVec = NULL;
-    int ctidId = -1, colIdx;
+    int colIdx;
 
-    // Step 1: fill the late read columns except the first late read column
+    if (m_lateReadCtidSeq < 0) {
+        return;
+    }
+    tidVec = vecBatch->m_arr + m_colId[m_lateReadCtidSeq];
+
+    // Step 1: fill the late read columns except the one filled with ctid
     for (int i = 0; i < m_colNum; ++i) {
         colIdx = m_colId[i];
-        if (IsLateRead(i) && colIdx >= 0) {
+        if (IsLateRead(i) && m_lateQual[i] == lateQual && i != m_lateReadCtidSeq && colIdx >= 0) {
             Assert(colIdx < vecBatch->m_cols);
 
-            if (tidVec != NULL) {
-                CUDesc* cuDescPtr = this->m_CUDescInfo[i]->cuDescArray + this->m_cuDescIdx;
-                this->GetCUDeleteMaskIfNeed(cuDescPtr->cu_id, this->m_snapshot);
-                (this->*m_fillVectorLateRead[i])(colIdx, tidVec, cuDescPtr, vecBatch->m_arr + colIdx);
-            } else {
-                // The first late read column should be filled with ctid
-                tidVec = vecBatch->m_arr + colIdx;
-                ctidId = i;
-            }
+            CUDesc* cuDescPtr = this->m_CUDescInfo[i]->cuDescArray + this->m_cuDescIdx;
+            this->GetCUDeleteMaskIfNeed(cuDescPtr->cu_id, this->m_snapshot);
+            (this->*m_fillVectorLateRead[i])(colIdx, tidVec, cuDescPtr, vecBatch->m_arr + colIdx);
         }
     }
 
-    // Step 2: fill the first late read column
-    if (ctidId >= 0) {
-        colIdx = m_colId[ctidId];
-        Assert(IsLateRead(ctidId) && colIdx >= 0);
+    // Step 2: fill the column filled with ctid
+    if (m_lateQual[m_lateReadCtidSeq] == lateQual) {
+        colIdx = m_colId[m_lateReadCtidSeq];
+        Assert(IsLateRead(m_lateReadCtidSeq) && colIdx >= 0);
 
-        CUDesc* cuDescPtr = this->m_CUDescInfo[ctidId]->cuDescArray + this->m_cuDescIdx;
+        CUDesc* cuDescPtr = this->m_CUDescInfo[m_lateReadCtidSeq]->cuDescArray + this->m_cuDescIdx;
         this->GetCUDeleteMaskIfNeed(cuDescPtr->cu_id, this->m_snapshot);
-        (this->*m_fillVectorLateRead[ctidId])(colIdx, tidVec, cuDescPtr, vecBatch->m_arr + colIdx);
+        (this->*m_fillVectorLateRead[m_lateReadCtidSeq])(colIdx, tidVec, cuDescPtr, vecBatch->m_arr + colIdx);
     }
 }
 
@@ -26,11 +26,17 @@
 #include "knl/knl_variable.h"
 
 #include "access/cstore_delete.h"
+#include "access/cstore_minmax_func.h"
+#include "access/cstore_rewrite.h"
+#include "access/reloptions.h"
 #include "access/xact.h"
 #include "catalog/catalog.h"
 #include "catalog/indexing.h"
 #include "catalog/pg_type.h"
+#include "commands/tablespace.h"
+#include "commands/vacuum.h"
 #include "executor/executor.h"
+#include "replication/dataqueue.h"
 #include "storage/cucache_mgr.h"
 #include "storage/custorage.h"
 #include "utils/builtins.h"
@@ -42,6 +48,7 @@
 #include "utils/snapmgr.h"
 #include "utils/tqual.h"
 #include "utils/typcache.h"
+#include "workload/workload.h"
 
 // tupledesc id
 #define SORT_COL_PARTID 1
@@ -63,7 +70,12 @@ CStoreDelete::CStoreDelete(
       m_rowOffset(NULL),
       m_curSortedNum(0),
       m_totalDeleteNum(0),
-      m_isRptRepeatTupErrForUpdate(false)
+      m_isRptRepeatTupErrForUpdate(false),
+      m_patchCols(NULL),
+      m_patchStorage(NULL),
+      m_patchValues(NULL),
+      m_patchNulls(NULL),
+      m_patchMemCnxt(NULL)
 {
     m_relation = rel;
     m_DelMemInfo = NULL;
@@ -107,6 +119,11 @@ CStoreDelete::~CStoreDelete()
     m_rowOffset = NULL;
     m_deltaRealtion = NULL;
     m_relation = NULL;
+    m_patchCols = NULL;
+    m_patchStorage = NULL;
+    m_patchValues = NULL;
+    m_patchNulls = NULL;
+    m_patchMemCnxt = NULL;
 }
 
 void CStoreDelete::Destroy()
@@ -144,6 +161,22 @@ void CStoreDelete::Destroy()
         list_free(m_partDeltaOids);
         m_partDeltaOids = NIL;
     }
+
+    if (m_patchCols) {
+        for (int col = 0; col < m_relation->rd_att->natts; ++col) {
+            if (m_patchStorage[col]) {
+                DELETE_EX(m_patchStorage[col]);
+            }
+            pfree_ext(m_patchValues[col]);
+            pfree_ext(m_patchNulls[col]);
+        }
+        pfree_ext(m_patchStorage);
+        pfree_ext(m_patchValues);
+        pfree_ext(m_patchNulls);
+        pfree_ext(m_patchCols);
+        MemoryContextDelete(m_patchMemCnxt);
+        m_patchMemCnxt = NULL;
+    }
 }
 
 void CStoreDelete::CollectPartDeltaOids()
@@ -452,8 +485,11 @@ uint64 CStoreDelete::ExecDeleteForTable()
                 // first CU
                 lastCUID = curCUID;
             } else if (lastCUID != curCUID) {
-                // modify delete bitmap in same CU
-                UpdateVCBitmap(m_relation, lastCUID, m_rowOffset, delRowNum, m_estate->es_snapshot);
+                // modify delete bitmap in same CU, or write the new values of the updated columns
+                if (m_patchCols != NULL)
+                    PatchCU(lastCUID, delRowNum);
+                else
+                    UpdateVCBitmap(m_relation, lastCUID, m_rowOffset, delRowNum, m_estate->es_snapshot);
 
                 // switch CU
                 lastCUID = curCUID;
@@ -473,6 +509,8 @@ uint64 CStoreDelete::ExecDeleteForTable()
             }
 
             // record offset
+            if (m_patchCols != NULL)
+                CopyPatchValues(i, delRowNum);
             m_rowOffset[delRowNum++] = curOffset;
             lastOffset = curOffset;
             Assert(delRowNum <= DefaultFullCUSize);
@@ -483,10 +521,16 @@ uint64 CStoreDelete::ExecDeleteForTable()
     }
 
     if (delRowNum > 0) {
-        UpdateVCBitmap(m_relation, lastCUID, m_rowOffset, delRowNum, m_estate->es_snapshot);
+        if (m_patchCols != NULL)
+            PatchCU(lastCUID, delRowNum);
+        else
+            UpdateVCBitmap(m_relation, lastCUID, m_rowOffset, delRowNum, m_estate->es_snapshot);
         delTotalRowNum += delRowNum;
     }
 
+    if (m_patchCols != NULL)
+        FlushPatchColumns();
+
     return delTotalRowNum;
 }
 
@@ -702,14 +746,43 @@ void CStoreDelete::ExecDelete(_in_ Relation rel, _in_ ScalarVector* vecRowId, _i
     }
 }
 
+/*
+ * @Description: check whether the cudesc tuple returned by an index scan was written by the
+ *    current transaction or is visible to the given MVCC snapshot.
+ */
+static bool CUDescVisibleToSnapshot(SysScanDesc scan, HeapTuple tup, Snapshot snapshot)
+{
+    if (!IsMVCCSnapshot(snapshot) || TransactionIdIsCurrentTransactionId(HeapTupleGetRawXmin(tup)))
+        return true;
+
+    Buffer buf = scan->iscan->xs_cbuf;
+    Assert(BufferIsValid(buf));
+    /* must hold a buffer lock to call HeapTupleSatisfiesVisibility */
+    LockBuffer(buf, BUFFER_LOCK_SHARE);
+    bool visible = HeapTupleSatisfiesVisibility(tup, snapshot, buf);
+    LockBuffer(buf, BUFFER_LOCK_UNLOCK);
+
+    return visible;
+}
+
 /*
  * Bitmask of virtual column represent which row are deleted
  * This function change the bitmap of corresponding CUs.
  * And update the bitmap of CUs of VC.
  */
-void CStoreDelete::UpdateVCBitmap(
-    _in_ Relation rel, _in_ uint32 cuid, _in_ const int* rowoffset, _in_ int delRowNum, _in_ Snapshot snapshot)
+/*
+ * @Description: mark the rows of one CU deleted in its delete bitmap. If markDeleted is false,
+ *    the bitmap is written back unchanged, which only locks the CU against concurrent delete
+ *    and update and checks that none of the rows has been deleted meanwhile. Because the
+ *    caller then writes values computed under *snapshot*, any change of the CU that this
+ *    snapshot can not see is reported as a conflict too.
+ */
+void CStoreDelete::UpdateVCBitmap(_in_ Relation rel, _in_ uint32 cuid, _in_ const int* rowoffset, _in_ int delRowNum,
+    _in_ Snapshot snapshot, _in_ bool markDeleted)
 {
+    Snapshot callerSnapshot = snapshot;
+    bool retried = false;
+
 Retry:
     ScanKeyData key[2];
     HeapTuple tmpTup = NULL, oldTup = NULL, newTup = NULL;
@@ -743,6 +816,16 @@ Retry:
     if ((tmpTup = systable_getnext_ordered(cudesc_scan, ForwardScanDirection)) != NULL) {
         Assert(newTup == NULL);
         oldTup = tmpTup;
+
+        /*
+         * Patched rows are not marked in the bitmap, so a concurrent update of this CU that
+         * committed after our snapshot only shows up as a newer bitmap tuple. Writing our
+         * values on top of it would lose that update.
+         */
+        if (!markDeleted && (retried || !CUDescVisibleToSnapshot(cudesc_scan, oldTup, callerSnapshot))) {
+            ereport(ERROR, (errcode(ERRCODE_CARDINALITY_VIOLATION), errmsg("These rows have been deleted or updated")));
+        }
+
         uint32 rowCount = DatumGetUInt32(fastgetattr(oldTup, CUDescRowCountAttr, cudesc_tupdesc, &isnull));
         Assert(isnull == false);
 
@@ -781,7 +864,8 @@ Retry:
                     ERROR, (errcode(ERRCODE_CARDINALITY_VIOLATION), errmsg("These rows have been deleted or updated")));
             }
 
-            delMask[row >> 3] |= (1 << (row % 8));
+            if (markDeleted)
+                delMask[row >> 3] |= (1 << (row % 8));
         }
 
         pfree(oldDelMask);
@@ -827,6 +911,7 @@ Retry:
                 heap_freetuple(newTup);
                 newTup = NULL;
                 heap_close(cudesc_rel, NoLock);
+                retried = true;
                 goto Retry;
             }
 
@@ -861,6 +946,270 @@ Retry:
         pgstat_count_cu_delete(rel, delRowNum);
 }
 
+/*
+ * @Description: write the new values of the given columns into new CUs under the same CU ids
+ *    instead of deleting the updated rows, so the columns not updated are not written again.
+ *    The updated rows keep their ctids. Rows in the delta table are still deleted here and
+ *    inserted again by the caller.
+ * @IN patchCols: patchCols[i] is true if the i-th column is updated
+ * @See also: CStoreUpdate::InitPatchColumns
+ */
+void CStoreDelete::InitPatchColumns(_in_ const bool* patchCols)
+{
+    Assert(m_isUpdate && !RELATION_IS_PARTITIONED(m_relation));
+
+    int attNo = m_relation->rd_att->natts;
+    Form_pg_attribute* attrs = m_relation->rd_att->attrs;
+
+    m_patchCols = (bool*)palloc0(sizeof(bool) * attNo);
+    m_patchStorage = (CUStorage**)palloc0(sizeof(CUStorage*) * attNo);
+    m_patchValues = (Datum**)palloc0(sizeof(Datum*) * attNo);
+    m_patchNulls = (bool**)palloc0(sizeof(bool*) * attNo);
+
+    /*
+     * the column space cache has been built by the CStoreInsert of the same update,
+     * so the new CUs are appended to the column files as inserted ones.
+     */
+    for (int col = 0; col < attNo; ++col) {
+        if (!patchCols[col] || attrs[col]->attisdropped)
+            continue;
+
+        CFileNode cFileNode(m_relation->rd_node, attrs[col]->attnum, MAIN_FORKNUM);
+        m_patchCols[col] = true;
+        m_patchStorage[col] = New(CurrentMemoryContext) CUStorage(cFileNode);
+        m_patchStorage[col]->SetAllocateStrategy(APPEND_ONLY);
+        m_patchValues[col] = (Datum*)palloc(sizeof(Datum) * RelMaxFullCuSize);
+        m_patchNulls[col] = (bool*)palloc(sizeof(bool) * RelMaxFullCuSize);
+    }
+
+    m_patchMemCnxt = AllocSetContextCreate(CurrentMemoryContext,
+        "UPDATE PATCH CU MEM CNXT",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE);
+}
+
+/*
+ * @Description: keep the new values of one sorted row until its CU is patched.
+ *    The values are copied since the sorted batch is reused by the next fetch.
+ * @IN batchRow: row index in m_sortBatch
+ * @IN patchRow: index of this row among the patched rows of its CU
+ */
+void CStoreDelete::CopyPatchValues(_in_ int batchRow, _in_ int patchRow)
+{
+    Form_pg_attribute* attrs = m_relation->rd_att->attrs;
+    AutoContextSwitch newMemCnxt(m_patchMemCnxt);
+
+    for (int col = 0; col < m_relation->rd_att->natts; ++col) {
+        if (!m_patchCols[col])
+            continue;
+
+        ScalarVector* vec = m_sortBatch->m_arr + col;
+        if (vec->IsNull(batchRow)) {
+            m_patchNulls[col][patchRow] = true;
+            m_patchValues[col][patchRow] = (Datum)0;
+            continue;
+        }
+
+        /* decode the vector value the same way as bulkload_vector does */
+        Datum value = 0;
+        int attlen = attrs[col]->attlen;
+        if (attlen > 0 && attlen <= (int)sizeof(Datum)) {
+            value = vec->m_vals[batchRow];
+        } else if (attlen > (int)sizeof(Datum)) {
+            value = PointerGetDatum((char*)ScalarVector::Decode(vec->m_vals[batchRow]) + VARHDRSZ_SHORT);
+        } else {
+            value = ScalarVector::Decode(vec->m_vals[batchRow]);
+        }
+
+        m_patchNulls[col][patchRow] = false;
+        m_patchValues[col][patchRow] = datumCopy(value, attrs[col]->attbyval, attlen);
+    }
+}
+
+/*
+ * @Description: write the new values of the updated rows in one CU. The delete bitmap is
+ *    updated first without marking any row, so that the CU is locked against concurrent
+ *    delete and update and the rows deleted meanwhile are reported.
+ * @IN cuid: CU id
+ * @IN patchRowNum: number of rows in m_rowOffset, ordered by offset
+ */
+void CStoreDelete::PatchCU(_in_ uint32 cuid, _in_ int patchRowNum)
+{
+    UpdateVCBitmap(m_relation, cuid, m_rowOffset, patchRowNum, m_estate->es_snapshot, false);
+
+    for (int col = 0; col < m_relation->rd_att->natts; ++col) {
+        if (m_patchCols[col])
+            PatchColumnCU(col, cuid, patchRowNum);
+    }
+
+    MemoryContextReset(m_patchMemCnxt);
+}
+
+/*
+ * @Description: replace the CU of one column by a new one holding the old values with
+ *    the updated rows overwritten. The cudesc tuple is updated in place, so snapshots
+ *    taken before the update still read the old CU. The per-CU bloom filter of this
+ *    column is dropped and min/max alone is used by rough check.
+ * @IN col: column index
+ * @IN cuid: CU id
+ * @IN patchRowNum: number of updated rows of this CU
+ */
+void CStoreDelete::PatchColumnCU(_in_ int col, _in_ uint32 cuid, _in_ int patchRowNum)
+{
+    Form_pg_attribute attr = m_relation->rd_att->attrs[col];
+    CUStorage* cuStorage = m_patchStorage[col];
+    ScanKeyData key[ARRAY_2_LEN];
+    CUDesc oldCUDesc;
+    CUDesc newCUDesc;
+    errno_t rc = EOK;
+
+    AutoContextSwitch newMemCnxt(m_patchMemCnxt);
+
+    Relation cudesc_rel = heap_open(m_relation->rd_rel->relcudescrelid, RowExclusiveLock);
+    Relation idx_rel = index_open(cudesc_rel->rd_rel->relcudescidx, RowExclusiveLock);
+    TupleDesc cudesc_tupdesc = cudesc_rel->rd_att;
+
+    ScanKeyInit(&key[0], (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(attr->attnum));
+    ScanKeyInit(&key[1], (AttrNumber)CUDescCUIDAttr, BTEqualStrategyNumber, F_OIDEQ, UInt32GetDatum(cuid));
+
+    /* the delete bitmap locked by PatchCU() keeps the other writers away from this CU */
+    SysScanDesc cudesc_scan = systable_beginscan_ordered(cudesc_rel, idx_rel, SnapshotNow, ARRAY_2_LEN, key);
+    HeapTuple oldTup = systable_getnext_ordered(cudesc_scan, ForwardScanDirection);
+    if (oldTup == NULL) {
+        ereport(ERROR, (errcode(ERRCODE_CARDINALITY_VIOLATION), errmsg("delete or update row conflict")));
+    }
+    CStore::DeformCudescTuple(oldTup, cudesc_tupdesc, attr, &oldCUDesc);
+    ItemPointerData oldTupCtid = oldTup->t_self;
+    systable_endscan_ordered(cudesc_scan);
+    index_close(idx_rel, RowExclusiveLock);
+
+    /* Step 1: get the old values of the whole CU */
+    int rowCount = oldCUDesc.row_count;
+    Datum* values = (Datum*)palloc0(sizeof(Datum) * rowCount);
+    bool* nulls = (bool*)palloc(sizeof(bool) * rowCount);
+    CU* oldCU = NULL;
+
+    if (oldCUDesc.IsNullCU()) {
+        rc = memset_s(nulls, rowCount, true, rowCount);
+        securec_check(rc, "\0", "\0");
+    } else if (oldCUDesc.IsSameValCU()) {
+        bool shouldFree = false;
+        Datum sameValue = CStore::CudescTupGetMinMaxDatum(&oldCUDesc, attr, true, &shouldFree);
+        for (int row = 0; row < rowCount; ++row) {
+            values[row] = sameValue;
+            nulls[row] = false;
+        }
+    } else {
+        oldCU = LoadSingleCu::LoadSingleCuData(
+            &oldCUDesc, col, attr->attlen, attr->atttypmod, attr->atttypid, m_relation, cuStorage);
+
+        GetValFunc getValFuncPtr[1];
+        InitGetValFunc(attr->attlen, getValFuncPtr, 0);
+        int getValFuncId = oldCU->HasNullValue() ? 1 : 0;
+
+        for (int row = 0; row < rowCount; ++row) {
+            nulls[row] = oldCU->IsNull(row);
+            if (!nulls[row])
+                values[row] = getValFuncPtr[0][getValFuncId](oldCU, row);
+        }
+    }
+
+    /* Step 2: overwrite the updated rows */
+    for (int i = 0; i < patchRowNum; ++i) {
+        int row = m_rowOffset[i];
+        Assert(row < rowCount);
+        values[row] = m_patchValues[col][i];
+        nulls[row] = m_patchNulls[col][i];
+    }
+
+    /* Step 3: compute min/max and cudesc mode of the new CU */
+    FuncSetMinMax minMaxFunc = GetMinMaxFunc(attr->atttypid);
+    bool firstFlag = true;
+    bool fullNull = true;
+    bool hasNull = false;
+    int maxVarStrLen = 0;
+
+    newCUDesc.cu_id = cuid;
+    newCUDesc.row_count = rowCount;
+    newCUDesc.magic = GetCurrentTransactionIdIfAny();
+
+    for (int row = 0; row < rowCount; ++row) {
+        if (nulls[row]) {
+            hasNull = true;
+            continue;
+        }
+
+        fullNull = false;
+        if (minMaxFunc != NULL) {
+            minMaxFunc(values[row], &newCUDesc, &firstFlag);
+            if (attr->attlen < 0)
+                maxVarStrLen = Max(maxVarStrLen, (int)datumGetSize(values[row], attr->attbyval, attr->attlen));
+        }
+    }
+
+    /* Step 4: form and compress the new CU, a NULL CU or the same value CU has no data */
+    CU* newCU = NULL;
+    bool needWriteCU =
+        CStore::SetCudescModeForMinMaxVal(fullNull, minMaxFunc != NULL, hasNull, maxVarStrLen, attr->attlen, &newCUDesc);
+    if (needWriteCU) {
+        newCU = New(CurrentMemoryContext) CU(attr->attlen, attr->atttypmod, attr->atttypid);
+        newCU->InitMem(sizeof(Datum) * rowCount, rowCount, hasNull);
+        for (int row = 0; row < rowCount; ++row) {
+            if (nulls[row])
+                newCU->AppendNullValue(row);
+            else
+                CU::AppendCuData(values[row], 1, attr, newCU);
+        }
+
+        int16 compressing_modes = 0;
+        heaprel_set_compressing_modes(m_relation, &compressing_modes);
+        CStoreRewriter::CompressCuData(newCU, &newCUDesc, attr, compressing_modes);
+    }
+
+    /* Step 5: allocate space and replace the cudesc tuple, see also CStoreInsert::SaveAll() */
+    LockRelationForExtension(m_relation, ExclusiveLock);
+
+    if (needWriteCU)
+        newCUDesc.cu_pointer = cuStorage->AllocSpace(newCUDesc.cu_size);
+
+    Datum descValues[CUDescMaxAttrNum];
+    bool descNulls[CUDescMaxAttrNum];
+    HeapTuple newTup = CStore::FormCudescTuple(&newCUDesc, cudesc_tupdesc, descValues, descNulls, attr);
+    simple_heap_update(cudesc_rel, &oldTupCtid, newTup);
+    CatalogUpdateIndexes(cudesc_rel, newTup);
+
+    UnlockRelationForExtension(m_relation, ExclusiveLock);
+
+    /* Step 6: write the new CU */
+    if (needWriteCU) {
+        perm_space_increase(m_relation->rd_rel->relowner,
+            (uint64)newCUDesc.cu_size,
+            RelationUsesSpaceType(m_relation->rd_rel->relpersistence));
+
+        cuStorage->SaveCU(newCU->m_compressedBuf, newCUDesc.cu_pointer, newCUDesc.cu_size, false);
+        CStoreCUReplication(
+            m_relation, attr->attnum, newCU->m_compressedBuf, newCUDesc.cu_size, newCUDesc.cu_pointer);
+        DELETE_EX(newCU);
+    }
+
+    if (oldCU != NULL)
+        DELETE_EX(oldCU);
+
+    heap_close(cudesc_rel, NoLock);
+}
+
+/*
+ * @Description: flush the patched CUs to disk before the update commits.
+ */
+void CStoreDelete::FlushPatchColumns()
+{
+    for (int col = 0; col < m_relation->rd_att->natts; ++col) {
+        if (m_patchCols[col])
+            m_patchStorage[col]->FlushDataFile();
+    }
+}
+
 bool CStoreDelete::IsFull() const
 {
     // m_maxSortNum <= 0 means  full sort
@@ -24,6 +24,10 @@
 
 #include "postgres.h"
 #include "knl/knl_variable.h"
+
+#include <pthread.h>
+#include <signal.h>
+
 #include "access/xact.h"
 #include "access/genam.h"
 #include "access/cstore_rewrite.h"
@@ -44,6 +48,7 @@
 #include "storage/lmgr.h"
 #include "storage/cucache_mgr.h"
 #include "access/cstore_insert.h"
+#include "access/cstore_summary.h"
 #include "pgxc/pgxc.h"
 #include "utils/tqual.h"
 #include "utils/memutils.h"
@@ -107,6 +112,53 @@ static inline int str_to_uint64(const char* str, uint64* val)
 #define FORMCU_IDX_NONE_NULL 0
 #define FORMCU_IDX_HAVE_NULL 1
 
+/*
+ * Threads compressing the CUs of one row group, see CompressCUsInParallel().
+ *
+ * The backend encodes the CUs itself and leaves only their LZ4/zlib step to
+ * the threads. That step writes into buffers allocated beforehand and gives
+ * back an error code, so a thread never touches the session, memory contexts
+ * or error state of the backend.
+ */
+struct CUCompressWorker {
+    struct CUCompressPool* pool;
+    pthread_t thread;
+    bool started;
+};
+
+struct CUCompressPool {
+    CUCompressWorker* workers;
+    int nworkers;
+    int* cols;                  /* columns whose CUs are to compress */
+    GeneralCompressTask* tasks; /* LZ4/zlib step of the CU, one per cols[] */
+    int ncols;
+    volatile uint32 nextTask;   /* index of tasks[] claimed next */
+};
+
+/*
+ * Run the pending tasks until none is left. Every thread claims the next task
+ * in turn, so the threads stay busy whatever the widths of the columns are.
+ */
+static void CUCompressTasks(CUCompressPool* pool)
+{
+    for (;;) {
+        uint32 next = pg_atomic_fetch_add_u32(&pool->nextTask, 1);
+        if (next >= (uint32)pool->ncols)
+            break;
+
+        if (pool->tasks[next].pending)
+            RunGeneralCompress(pool->tasks + next);
+    }
+}
+
+static void* CUCompressWorkerMain(void* arg)
+{
+    CUCompressWorker* worker = (CUCompressWorker*)arg;
+
+    CUCompressTasks(worker->pool);
+    return NULL;
+}
+
 /*
  * @Description: compute the max number of keys within all index relation.
  * @IN rel: result relation info
@@ -193,6 +245,8 @@ CStoreInsert::CStoreInsert(_in_ Relation relation, _in_ const InsertArg& args, _
 
     m_cuStorage = (CUStorage**)palloc(sizeof(CUStorage*) * attNo);
     m_cuCmprsOptions = (compression_options*)palloc(sizeof(compression_options) * attNo);
+    m_cuTempInfo = (cu_tmp_compress_info*)palloc0(sizeof(cu_tmp_compress_info) * attNo);
+    m_compressPool = NULL;
 
     for (int i = 0; i < attNo; ++i) {
         if (m_relation->rd_att->attrs[i]->attisdropped) {
@@ -222,12 +276,15 @@ CStoreInsert::~CStoreInsert()
     m_idxBatchRow = NULL;
     m_idxRelation = NULL;
     m_setMinMaxFuncs = NULL;
+    m_summaryCols = NULL;
     m_fake_isnull = NULL;
     m_idxInsertArgs = NULL;
     m_aio_memcnxt = NULL;
     m_fake_values = NULL;
     m_delta_relation = NULL;
     m_cuCmprsOptions = NULL;
+    m_cuTempInfo = NULL;
+    m_compressPool = NULL;
     m_estate = NULL;
     m_cuDescPPtr = NULL;
     m_delta_desc = NULL;
@@ -404,6 +461,7 @@ void CStoreInsert::Destroy()
     /* Step 4: Reset all the pointers */
     m_formCUFuncArray = NULL;
     m_setMinMaxFuncs = NULL;
+    m_summaryCols = NULL;
     m_cuStorage = NULL;
     m_cuDescPPtr = NULL;
     m_cuPPtr = NULL;
@@ -411,6 +469,8 @@ void CStoreInsert::Destroy()
     m_idxKeyNum = NULL;
     m_idxRelation = NULL;
     m_cuCmprsOptions = NULL;
+    m_cuTempInfo = NULL;
+    m_compressPool = NULL;
     m_fake_values = NULL;
     m_fake_isnull = NULL;
 
@@ -489,6 +549,7 @@ void CStoreInsert::InitFuncPtr()
     m_setMinMaxFuncs = (FuncSetMinMax*)palloc(attNo * sizeof(FuncSetMinMax));
     m_formCUFuncArray = (FormCUFuncArray*)palloc(sizeof(FormCUFuncArray) * attNo);
     m_cuDescPPtr = (CUDesc**)palloc(attNo * sizeof(CUDesc*));
+    m_summaryCols = CStoreGetSummaryColumns(m_relation);
 
     /*
      * Initilize Min/Max set function for all columns
@@ -556,8 +617,8 @@ void CStoreInsert::BeginBatchInsert(const InsertArg& args)
     if (tupledesc_have_pck(constr)) {
         int sortKeyNum = constr->clusterKeyNum;
         AttrNumber* sortKeys = constr->clusterKeys;
-        m_sorter =
-            New(CurrentMemoryContext) CStorePSort(m_relation, sortKeys, sortKeyNum, args.sortType, m_cstorInsertMem);
+        m_sorter = New(CurrentMemoryContext)
+            CStorePSort(m_relation, sortKeys, sortKeyNum, args.sortType, m_cstorInsertMem, args.sortAllRows);
         Assert(NeedPartialSort());
     } else if (args.using_vectorbatch) {
         m_bufferedBatchRows =
@@ -575,6 +636,7 @@ void CStoreInsert::BeginBatchInsert(const InsertArg& args)
 
     /* Step 6: Initilize CU objects. */
     m_cuPPtr = (CU**)palloc0(sizeof(CU*) * m_relation->rd_att->natts);
+    InitCompressPool();
 
     /*
      * Step 7: Lock relfilenode.
@@ -821,12 +883,18 @@ void CStoreInsert::BatchInsertCommon(bulkload_rows* batchRowPtr, int options)
 
     CHECK_FOR_INTERRUPTS();
     /* step 1: form CU and CUDesc; */
+    if (m_compressPool != NULL)
+        m_compressPool->ncols = 0;
     for (col = 0; col < attno; ++col) {
         if (!m_relation->rd_att->attrs[col]->attisdropped) {
             m_cuPPtr[col] = FormCU(col, batchRowPtr, m_cuDescPPtr[col]);
-            m_cuCmprsOptions[col].m_sampling_fihished = true;
         }
     }
+    if (m_compressPool != NULL)
+        CompressCUsInParallel(batchRowPtr->m_rows_curnum);
+    for (col = 0; col < attno; ++col) {
+        m_cuCmprsOptions[col].m_sampling_fihished = true;
+    }
     if (m_isUpdate)
         pgstat_count_cu_update(m_relation, batchRowPtr->m_rows_curnum);
     else
@@ -846,6 +914,94 @@ void CStoreInsert::BatchInsertCommon(bulkload_rows* batchRowPtr, int options)
         InsertIdxTableIfNeed(batchRowPtr, m_cuDescPPtr[0]->cu_id);
 }
 
+/*
+ * @Description: set up the threads compressing CUs if cstore_compress_threads
+ *    allows more than one and the relation has more than one column. CUs of an
+ *    encrypted cluster are always compressed by the backend.
+ * @See also: CompressCUsInParallel
+ */
+void CStoreInsert::InitCompressPool()
+{
+    int attNo = m_relation->rd_att->natts;
+    int nworkers = u_sess->attr.attr_storage.cstore_compress_threads;
+    int ncols = 0;
+
+    for (int col = 0; col < attNo; ++col) {
+        if (!m_relation->rd_att->attrs[col]->attisdropped)
+            ++ncols;
+    }
+    nworkers = Min(nworkers, ncols);
+    if (nworkers <= 1 || isEncryptedCluster())
+        return;
+
+    m_compressPool = (CUCompressPool*)palloc0(sizeof(CUCompressPool));
+    m_compressPool->cols = (int*)palloc(sizeof(int) * attNo);
+    m_compressPool->tasks = (GeneralCompressTask*)palloc0(sizeof(GeneralCompressTask) * attNo);
+
+    /* the backend itself works as one of them, so the first has no thread */
+    m_compressPool->nworkers = nworkers - 1;
+    m_compressPool->workers = (CUCompressWorker*)palloc0(sizeof(CUCompressWorker) * m_compressPool->nworkers);
+    for (int i = 0; i < m_compressPool->nworkers; ++i)
+        m_compressPool->workers[i].pool = m_compressPool;
+}
+
+/*
+ * @Description: compress the CUs formed by FormCU() for one row group. The
+ *    backend encodes every CU and runs the LZ4/zlib steps left over together
+ *    with the threads, or all of them if no thread can be created. CUs using
+ *    a dictionary or FSST are compressed by the backend alone. With ADIO the
+ *    writes of the previous row group are still in flight meanwhile.
+ * @IN rowCount: number of rows of the row group
+ * @See also: InitCompressPool
+ */
+void CStoreInsert::CompressCUsInParallel(int rowCount)
+{
+    CUCompressPool* pool = m_compressPool;
+    sigset_t newMask;
+    sigset_t oldMask;
+    bool masked = false;
+    int npending = 0;
+
+    if (pool->ncols == 0)
+        return;
+
+    for (int i = 0; i < pool->ncols; ++i) {
+        m_cuPPtr[pool->cols[i]]->BeginCompressToBuf(rowCount, m_compress_modes, pool->tasks + i);
+        if (pool->tasks[i].pending)
+            ++npending;
+    }
+    pool->nextTask = 0;
+
+    /* signals are always delivered to the backend thread */
+    if (npending > 1 && sigfillset(&newMask) == 0 && pthread_sigmask(SIG_BLOCK, &newMask, &oldMask) == 0)
+        masked = true;
+    for (int i = 0; masked && i < pool->nworkers && i + 1 < npending; ++i) {
+        CUCompressWorker* worker = pool->workers + i;
+
+        worker->started = (pthread_create(&worker->thread, NULL, CUCompressWorkerMain, worker) == 0);
+    }
+    if (masked)
+        (void)pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+
+    CUCompressTasks(pool);
+    for (int i = 0; i < pool->nworkers; ++i) {
+        if (pool->workers[i].started) {
+            (void)pthread_join(pool->workers[i].thread, NULL);
+            pool->workers[i].started = false;
+        }
+    }
+
+    /* errors of the tasks are reported here, by the backend */
+    for (int i = 0; i < pool->ncols; ++i) {
+        int col = pool->cols[i];
+
+        m_cuPPtr[col]->EndCompressToBuf(pool->tasks + i);
+        m_cuDescPPtr[col]->cu_size = m_cuPPtr[col]->GetCUSize();
+        m_cuPPtr[col]->FreeSrcBuf();
+    }
+    pool->ncols = 0;
+}
+
 void CStoreInsert::InsertDeltaTable(bulkload_rows* batchRowPtr, int options)
 {
     HeapTuple tuple = NULL;
@@ -1448,6 +1604,16 @@ CU* CStoreInsert::FormCU(int col, bulkload_rows* batchRowPtr, CUDesc* cuDescPtr)
     int funIdx = batchRowPtr->m_vectors[col].m_values_nulls.m_has_null ? FORMCU_IDX_HAVE_NULL : FORMCU_IDX_NONE_NULL;
     (this->*(m_formCUFuncArray[col].colFormCU[funIdx]))(col, batchRowPtr, cuDescPtr, cuPtr);
 
+    /*
+     * Form bloom filter and value counts for the listed columns. Min/max is
+     * enough for the CU of NULLs or the same value. The summary lives until
+     * the cudesc tuple is saved, see FormCudescTuple().
+     */
+    if (m_summaryCols != NULL && m_summaryCols[col] && !(cuDescPtr->IsNullCU()) && !(cuDescPtr->IsSameValCU())) {
+        cuDescPtr->cu_summary =
+            FormCUSummary(attrs[col]->atttypid, &batchRowPtr->m_vectors[col], batchRowPtr->m_rows_curnum);
+    }
+
     // We should not compress in two case.
     // case1) IsNullCU
     // case2) Min is the same to max in CU. In this case, we don't
@@ -1457,18 +1623,25 @@ CU* CStoreInsert::FormCU(int col, bulkload_rows* batchRowPtr, CUDesc* cuDescPtr)
         // a little tricky to reduce the recomputation of min/max value.
         // some data type is equal to int8/int16/int32/int32. for them it
         // is not necessary to recompute the min/max value.
-        m_cuTempInfo.m_valid_minmax = !NeedToRecomputeMinMax(attrs[col]->atttypid);
-        if (m_cuTempInfo.m_valid_minmax) {
-            m_cuTempInfo.m_min_value = ConvertToInt64Data(cuDescPtr->cu_min, attlen);
-            m_cuTempInfo.m_max_value = ConvertToInt64Data(cuDescPtr->cu_max, attlen);
+        cu_tmp_compress_info* tmpInfo = m_cuTempInfo + col;
+        tmpInfo->m_valid_minmax = !NeedToRecomputeMinMax(attrs[col]->atttypid);
+        if (tmpInfo->m_valid_minmax) {
+            tmpInfo->m_min_value = ConvertToInt64Data(cuDescPtr->cu_min, attlen);
+            tmpInfo->m_max_value = ConvertToInt64Data(cuDescPtr->cu_max, attlen);
         }
-        m_cuTempInfo.m_options = (m_cuCmprsOptions + col);
-        cuPtr->m_tmpinfo = &m_cuTempInfo;
+        tmpInfo->m_options = (m_cuCmprsOptions + col);
+        cuPtr->m_tmpinfo = tmpInfo;
 
         // Magic number is for checking CU data
         cuPtr->SetMagic(cuDescPtr->magic);
-        cuPtr->Compress(batchRowPtr->m_rows_curnum, m_compress_modes);
-        cuDescPtr->cu_size = cuPtr->GetCUSize();
+        if (m_compressPool != NULL) {
+            /* compressed together with the other columns, see CompressCUsInParallel() */
+            cuPtr->AllocCompressBuf();
+            m_compressPool->cols[m_compressPool->ncols++] = col;
+        } else {
+            cuPtr->Compress(batchRowPtr->m_rows_curnum, m_compress_modes);
+            cuDescPtr->cu_size = cuPtr->GetCUSize();
+        }
     }
     cuDescPtr->row_count = batchRowPtr->m_rows_curnum;
 
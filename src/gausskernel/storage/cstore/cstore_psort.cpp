@@ -22,14 +22,102 @@
  * ---------------------------------------------------------------------------------------
  */
 #include "access/cstore_psort.h"
+#include "catalog/pg_type.h"
 #include "storage/cu.h"
+#include "utils/builtins.h"
 #include "utils/datum.h"
 #include "utils/memutils.h"
+#include "utils/numeric.h"
+#include "utils/numeric_gs.h"
 #include "utils/rel.h"
 #include "utils/rel_gs.h"
 #include "utils/typcache.h"
 
-CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int type, MemInfoArg* m_memInfo)
+#define ZORDER_KEY_BITS 64
+#define ZORDER_SIGN_BIT (UINT64CONST(1) << (ZORDER_KEY_BITS - 1))
+
+static uint64 ZOrderNormalizeFloat(double value)
+{
+    uint64 bits = 0;
+
+    /* -0 and +0 must be the same point */
+    if (value == 0) {
+        value = 0;
+    }
+    errno_t rc = memcpy_s(&bits, sizeof(bits), &value, sizeof(value));
+    securec_check(rc, "", "");
+    return (bits & ZORDER_SIGN_BIT) ? ~bits : (bits | ZORDER_SIGN_BIT);
+}
+
+static uint64 ZOrderNormalizeString(Datum value)
+{
+    struct varlena* str = (struct varlena*)DatumGetPointer(value);
+    struct varlena* detoasted = pg_detoast_datum_packed(str);
+    const unsigned char* data = (const unsigned char*)VARDATA_ANY(detoasted);
+    int len = Min((int)VARSIZE_ANY_EXHDR(detoasted), (int)sizeof(uint64));
+    uint64 result = 0;
+
+    /* leading bytes in big-endian, so that a shorter prefix sorts first */
+    for (int i = 0; i < (int)sizeof(uint64); ++i) {
+        result = (result << 8) | (i < len ? data[i] : 0);
+    }
+    if (detoasted != str) {
+        pfree(detoasted);
+    }
+    return result;
+}
+
+/*
+ * @Description: map a not-null value to an unsigned 64 bits integer, whose
+ *    unsigned order is the same as the order of the values. Only the leading 8
+ *    bytes of strings are used, and numeric is approximated by float8. Values
+ *    of the other types are all mapped to 0, so they don't affect the Z-order.
+ * @IN value: the datum of value
+ * @IN typeOid: the type of value
+ * @Return: the order-preserving integer
+ */
+static uint64 ZOrderNormalizeDatum(Datum value, Oid typeOid)
+{
+    switch (typeOid) {
+        case BOOLOID:
+            return DatumGetBool(value) ? 1 : 0;
+        case INT1OID:
+            return DatumGetUInt8(value);
+        case OIDOID:
+            return DatumGetObjectId(value);
+        case INT2OID:
+            return (uint64)(int64)DatumGetInt16(value) ^ ZORDER_SIGN_BIT;
+        case INT4OID:
+        case DATEOID:
+            return (uint64)(int64)DatumGetInt32(value) ^ ZORDER_SIGN_BIT;
+        case INT8OID:
+        case TIMEOID:
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+            return (uint64)DatumGetInt64(value) ^ ZORDER_SIGN_BIT;
+        case FLOAT4OID:
+            return ZOrderNormalizeFloat(DatumGetFloat4(value));
+        case FLOAT8OID:
+            return ZOrderNormalizeFloat(DatumGetFloat8(value));
+        case NUMERICOID: {
+            Numeric num = DatumGetNumeric(value);
+            if (NUMERIC_IS_BI(num)) {
+                num = makeNumericNormal(num);
+            }
+            return ZOrderNormalizeFloat(DatumGetFloat8(DirectFunctionCall1(numeric_float8, NumericGetDatum(num))));
+        }
+        case TEXTOID:
+        case VARCHAROID:
+        case BPCHAROID:
+        case NVARCHAR2OID:
+            return ZOrderNormalizeString(value);
+        default:
+            return 0;
+    }
+}
+
+CStorePSort::CStorePSort(
+    Relation rel, AttrNumber* sortKeys, int keyNum, int type, MemInfoArg* m_memInfo, bool sortAllRows)
     : m_tupleSortState(NULL),
       m_batchSortState(NULL),
       m_vecBatch(NULL),
@@ -38,11 +126,20 @@ CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int typ
       m_rel(rel),
       m_sortKeys(sortKeys),
       m_keyNum(keyNum),
+      m_zorder(false),
+      m_sortDesc(NULL),
+      m_clusterKeys(sortKeys),
+      m_clusterKeyNum(keyNum),
+      m_zorderKeyAttno(InvalidAttrNumber),
+      m_zorderKey(NULL),
+      m_zorderValues(NULL),
+      m_zorderBatch(NULL),
+      m_zorderMemContext(NULL),
       m_curSortedRowNum(0),
       m_vecBatchCursor(InvalidBathCursor)
 {
     m_tupDesc = m_rel->rd_att;
-    Form_pg_attribute* attr = m_tupDesc->attrs;
+    m_sortDesc = m_tupDesc;
     m_psortMemInfo = NULL;
 
     m_fullCUSize = RelationGetMaxBatchRows(m_rel);
@@ -51,12 +148,54 @@ CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int typ
     AssertCheck();
 #endif
 
+    /*
+     * Rewriting the whole relation, such as VACUUM FULL, sorts all the rows
+     * once instead of each partial cluster, so that the relation is globally
+     * clustered. the sort will spill to disk if it's out of psort_work_mem.
+     */
+    if (sortAllRows) {
+        m_partialClusterRowNum = INT_MAX;
+    }
+
+    /*
+     * In Z-order clustering, the bits of all cluster keys are interleaved into
+     * one bytea key, which is appended to each row as an extra column and sorted
+     * on. Rows near in any of the cluster keys are near in storage then, and
+     * min/max of each cluster key column in a CU is tight.
+     */
+    m_zorder = RelationIsCUFormat(m_rel) && RelationClusterInZOrder(m_rel);
+    if (m_zorder) {
+        int natts = m_tupDesc->natts;
+        m_sortDesc = CreateTemplateTupleDesc(natts + 1, false);
+        for (int i = 0; i < natts; ++i) {
+            errno_t rc = memcpy_s(
+                m_sortDesc->attrs[i], ATTRIBUTE_FIXED_PART_SIZE, m_tupDesc->attrs[i], ATTRIBUTE_FIXED_PART_SIZE);
+            securec_check(rc, "", "");
+        }
+        m_zorderKeyAttno = (AttrNumber)(natts + 1);
+        TupleDescInitEntry(m_sortDesc, m_zorderKeyAttno, "zorder_key", BYTEAOID, -1, 0);
+
+        Size keyLen = VARHDRSZ + (Size)m_clusterKeyNum * sizeof(uint64);
+        m_zorderKey = (bytea*)palloc0(keyLen);
+        SET_VARSIZE(m_zorderKey, keyLen);
+        m_zorderValues = (uint64*)palloc0(sizeof(uint64) * m_clusterKeyNum);
+        m_zorderMemContext = AllocSetContextCreate(CurrentMemoryContext,
+            "ZOrderKey",
+            ALLOCSET_SMALL_MINSIZE,
+            ALLOCSET_SMALL_INITSIZE,
+            ALLOCSET_SMALL_MAXSIZE);
+
+        m_sortKeys = &m_zorderKeyAttno;
+        m_keyNum = 1;
+    }
+    Form_pg_attribute* attr = m_sortDesc->attrs;
+
     // Note that these variables should be in parent memoryContex.
     // please free them in deconstructor method.
     //
-    m_sortOperators = (Oid*)palloc(sizeof(Oid) * keyNum);
-    m_sortCollations = (Oid*)palloc(sizeof(Oid) * keyNum);
-    for (int i = 0; i < keyNum; ++i) {
+    m_sortOperators = (Oid*)palloc(sizeof(Oid) * m_keyNum);
+    m_sortCollations = (Oid*)palloc(sizeof(Oid) * m_keyNum);
+    for (int i = 0; i < m_keyNum; ++i) {
         int colIdx = m_sortKeys[i] - 1;
         m_sortCollations[i] = attr[colIdx]->attcollation;
 
@@ -68,8 +207,8 @@ CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int typ
     errno_t rc = memset_s(m_nullsFirst, m_keyNum * sizeof(bool), false, m_keyNum * sizeof(bool));
     securec_check(rc, "", "");
 
-    m_val = (Datum*)palloc(sizeof(Datum) * m_tupDesc->natts);
-    m_null = (bool*)palloc(sizeof(bool) * m_tupDesc->natts);
+    m_val = (Datum*)palloc(sizeof(Datum) * m_sortDesc->natts);
+    m_null = (bool*)palloc(sizeof(bool) * m_sortDesc->natts);
 
     InitPsortMemArg(m_memInfo);
     int sortMem = m_psortMemInfo->MemSort > 0 ? m_psortMemInfo->MemSort : u_sess->attr.attr_storage.psort_work_mem;
@@ -97,7 +236,7 @@ CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int typ
     AutoContextSwitch memContextGuard(m_psortMemContext);
 
     if (m_type == TUPLE_SORT) {
-        m_tupleSortState = tuplesort_begin_heap(m_tupDesc,
+        m_tupleSortState = tuplesort_begin_heap(m_sortDesc,
             m_keyNum,
             m_sortKeys,
             m_sortOperators,
@@ -111,9 +250,9 @@ CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int typ
 
         m_funcReset = &CStorePSort::ResetTupleSortState;
 
-        m_tupleSlot = MakeSingleTupleTableSlot(m_tupDesc);
+        m_tupleSlot = MakeSingleTupleTableSlot(m_sortDesc);
     } else {
-        m_batchSortState = batchsort_begin_heap(m_tupDesc,
+        m_batchSortState = batchsort_begin_heap(m_sortDesc,
             m_keyNum,
             m_sortKeys,
             m_sortOperators,
@@ -127,7 +266,10 @@ CStorePSort::CStorePSort(Relation rel, AttrNumber* sortKeys, int keyNum, int typ
 
         m_funcReset = &CStorePSort::ResetBatchSortState;
 
-        m_vecBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, m_tupDesc);
+        m_vecBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, m_sortDesc);
+        if (m_zorder) {
+            m_zorderBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, m_sortDesc);
+        }
     }
 }
 
@@ -145,6 +287,12 @@ CStorePSort::~CStorePSort()
     m_rel = NULL;
     m_psortMemInfo = NULL;
     m_tupDesc = NULL;
+    m_sortDesc = NULL;
+    m_clusterKeys = NULL;
+    m_zorderKey = NULL;
+    m_zorderValues = NULL;
+    m_zorderBatch = NULL;
+    m_zorderMemContext = NULL;
     m_sortCollations = NULL;
     m_psortMemContext = NULL;
 }
@@ -165,6 +313,14 @@ void CStorePSort::Destroy()
     if (m_psortMemInfo) {
         pfree_ext(m_psortMemInfo);
     }
+    if (m_zorder) {
+        FreeTupleDesc(m_sortDesc);
+        m_sortDesc = NULL;
+        pfree_ext(m_zorderKey);
+        pfree_ext(m_zorderValues);
+        MemoryContextDelete(m_zorderMemContext);
+        m_zorderMemContext = NULL;
+    }
 
     // free memory alloc in m_psortMemContext
     MemoryContextDelete(m_psortMemContext);
@@ -216,6 +372,24 @@ void CStorePSort::Reset(bool endFlag)
 void CStorePSort::PutVecBatch(Relation rel, VectorBatch* pVecBatch)
 {
     Assert(m_batchSortState && m_type == BATCH_SORT);
+    if (m_zorder) {
+        /* share the values of all columns, and append the Z-order key column */
+        int natts = m_tupDesc->natts;
+        ScalarVector* keyVector = &m_zorderBatch->m_arr[natts];
+
+        m_zorderBatch->Reset(true);
+        for (int i = 0; i < natts; ++i) {
+            m_zorderBatch->m_arr[i].copy(&pVecBatch->m_arr[i]);
+        }
+        for (int row = 0; row < pVecBatch->m_rows; ++row) {
+            (void)keyVector->AddVar(FormZOrderKey(pVecBatch->m_arr, row), row);
+        }
+        keyVector->m_rows = pVecBatch->m_rows;
+        m_zorderBatch->m_rows = pVecBatch->m_rows;
+        m_batchSortState->sort_putbatch(m_batchSortState, m_zorderBatch, 0, m_zorderBatch->m_rows);
+        m_curSortedRowNum += pVecBatch->m_rows;
+        return;
+    }
     m_batchSortState->sort_putbatch(m_batchSortState, pVecBatch, 0, pVecBatch->m_rows);
     m_curSortedRowNum += pVecBatch->m_rows;
 }
@@ -226,9 +400,24 @@ void CStorePSort::PutTuple(Datum* values, bool* nulls)
 
     AutoContextSwitch memContextGuard(m_psortMemContext);
 
-    HeapTuple tuple = heap_form_tuple(m_tupDesc, values, nulls);
+    if (m_zorder) {
+        /* values may be m_val itself, whose last slot is left for the Z-order key */
+        int natts = m_tupDesc->natts;
+        if (values != m_val) {
+            errno_t rc = memcpy_s(m_val, sizeof(Datum) * natts, values, sizeof(Datum) * natts);
+            securec_check(rc, "", "");
+            rc = memcpy_s(m_null, sizeof(bool) * natts, nulls, sizeof(bool) * natts);
+            securec_check(rc, "", "");
+        }
+        m_val[natts] = FormZOrderKey(m_val, m_null);
+        m_null[natts] = false;
+        values = m_val;
+        nulls = m_null;
+    }
+
+    HeapTuple tuple = heap_form_tuple(m_sortDesc, values, nulls);
 
-    TupleTableSlot* slot = MakeSingleTupleTableSlot(m_tupDesc);
+    TupleTableSlot* slot = MakeSingleTupleTableSlot(m_sortDesc);
 
     (void)ExecStoreTuple(tuple, slot, InvalidBuffer, false);
 
@@ -312,7 +501,7 @@ bool CStorePSort::IsFull() const
     return m_curSortedRowNum >= m_partialClusterRowNum;
 }
 
-int CStorePSort::GetRowNum() const
+int64 CStorePSort::GetRowNum() const
 {
     return m_curSortedRowNum;
 }
@@ -352,7 +541,7 @@ void CStorePSort::ResetTupleSortState(bool endFlag)
     MemoryContextReset(m_psortMemContext);
 
     if (!endFlag) {
-        m_tupleSortState = tuplesort_begin_heap(m_tupDesc,
+        m_tupleSortState = tuplesort_begin_heap(m_sortDesc,
             m_keyNum,
             m_sortKeys,
             m_sortOperators,
@@ -362,7 +551,7 @@ void CStorePSort::ResetTupleSortState(bool endFlag)
             false,
             canSpreadMaxMem);
 
-        m_tupleSlot = MakeSingleTupleTableSlot(m_tupDesc);
+        m_tupleSlot = MakeSingleTupleTableSlot(m_sortDesc);
     }
     m_curSortedRowNum = 0;
 }
@@ -388,7 +577,7 @@ void CStorePSort::ResetBatchSortState(bool endFlag)
     MemoryContextReset(m_psortMemContext);
 
     if (!endFlag) {
-        m_batchSortState = batchsort_begin_heap(m_tupDesc,
+        m_batchSortState = batchsort_begin_heap(m_sortDesc,
             m_keyNum,
             m_sortKeys,
             m_sortOperators,
@@ -398,7 +587,10 @@ void CStorePSort::ResetBatchSortState(bool endFlag)
             false,
             canSpreadMaxMem);
 
-        m_vecBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, m_tupDesc);
+        m_vecBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, m_sortDesc);
+        if (m_zorder) {
+            m_zorderBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, m_sortDesc);
+        }
     }
     m_curSortedRowNum = 0;
     m_vecBatchCursor = InvalidBathCursor;
@@ -407,7 +599,7 @@ void CStorePSort::ResetBatchSortState(bool endFlag)
 void CStorePSort::GetBatchValueFromTupleSort(bulkload_rows* batchRowsPtr)
 {
     AutoContextSwitch memContextGuard(m_psortMemContext);
-    TupleTableSlot* slot = MakeSingleTupleTableSlot(m_tupDesc);
+    TupleTableSlot* slot = MakeSingleTupleTableSlot(m_sortDesc);
 
     // here it isn't a dead loop.
     // when batchRowsPtr is full, break down the loops.
@@ -416,7 +608,8 @@ void CStorePSort::GetBatchValueFromTupleSort(bulkload_rows* batchRowsPtr)
             break;
         }
 
-        heap_deform_tuple(slot->tts_tuple, m_tupDesc, m_val, m_null);
+        /* the Z-order key is the trailing column, and it's not appended */
+        heap_deform_tuple(slot->tts_tuple, m_sortDesc, m_val, m_null);
         if (batchRowsPtr->append_one_tuple(m_val, m_null, m_tupDesc))
             break;
     }
@@ -479,3 +672,50 @@ void CStorePSort::GetBatchValueFromBatchSort(bulkload_rows* batchRowsPtr)
         m_vecBatchCursor = InvalidBathCursor;
     }
 }
+
+/*
+ * @Description: interleave the bits of the normalized cluster keys in
+ *    m_zorderValues into m_zorderKey, from the most significant bit.
+ * @Return: m_zorderKey
+ */
+Datum CStorePSort::FormZOrderKey(const Datum* values, const bool* nulls)
+{
+    {
+        AutoContextSwitch memContextGuard(m_zorderMemContext);
+        for (int i = 0; i < m_clusterKeyNum; ++i) {
+            int colIdx = m_clusterKeys[i] - 1;
+            /* NULL is placed last, the same as the lexical order */
+            m_zorderValues[i] =
+                nulls[colIdx] ? PG_UINT64_MAX : ZOrderNormalizeDatum(values[colIdx], m_tupDesc->attrs[colIdx]->atttypid);
+        }
+    }
+    MemoryContextReset(m_zorderMemContext);
+
+    unsigned char* key = (unsigned char*)VARDATA(m_zorderKey);
+    errno_t rc = memset_s(key, m_clusterKeyNum * sizeof(uint64), 0, m_clusterKeyNum * sizeof(uint64));
+    securec_check(rc, "", "");
+
+    int outBit = 0;
+    for (int bit = ZORDER_KEY_BITS - 1; bit >= 0; --bit) {
+        for (int i = 0; i < m_clusterKeyNum; ++i, ++outBit) {
+            if ((m_zorderValues[i] >> bit) & 1) {
+                key[outBit >> 3] |= (unsigned char)(0x80 >> (outBit & 7));
+            }
+        }
+    }
+    return PointerGetDatum(m_zorderKey);
+}
+
+Datum CStorePSort::FormZOrderKey(ScalarVector* columns, int row)
+{
+    Datum* values = m_val;
+    bool* nulls = m_null;
+
+    for (int i = 0; i < m_clusterKeyNum; ++i) {
+        int colIdx = m_clusterKeys[i] - 1;
+        Assert(colIdx < m_tupDesc->natts);
+        nulls[colIdx] = columns[colIdx].IsNull(row);
+        values[colIdx] = nulls[colIdx] ? (Datum)0 : ScalarVector::Decode(columns[colIdx].m_vals[row]);
+    }
+    return FormZOrderKey(values, nulls);
+}
@@ -36,6 +36,10 @@
 #include "utils/lsyscache.h"
 #include "catalog/index.h"
 #include "storage/remote_read.h"
+#include "catalog/indexing.h"
+#include "utils/datum.h"
+#include "utils/sortsupport.h"
+#include "utils/typcache.h"
 
 extern void fastDropPartition(Relation rel, Oid partOid, const char* stmt);
 
@@ -2149,3 +2153,328 @@ void ATExecCStoreMergePartition(Relation partTableRel, AlterTableCmd* cmd)
 
     partitionClose(partTableRel, destPart, NoLock);
 }
+
+/* one CU of the first partial cluster key column, see CStoreReclusterCUs() */
+typedef struct ReclusterCU {
+    uint32 cuid;
+    int rowCount;
+    Datum min;
+    Datum max;
+} ReclusterCU;
+
+static int ReclusterCUCmp(const void* a, const void* b, void* arg)
+{
+    const ReclusterCU* cu1 = (const ReclusterCU*)a;
+    const ReclusterCU* cu2 = (const ReclusterCU*)b;
+
+    return ApplySortComparator(cu1->min, false, cu2->min, false, (SortSupport)arg);
+}
+
+/*
+ * @Description: read the delete bitmap of one CU, all zero if no row is deleted.
+ * @OUT delMask: delete bitmap of (rowCount + 7) / 8 bytes
+ * @Return: ctid of the bitmap tuple
+ */
+static ItemPointerData ReclusterGetDelMask(
+    Relation cudescRel, Relation cudescIdx, uint32 cuid, int rowCount, unsigned char* delMask)
+{
+    ScanKeyData key[ARRAY_2_LEN];
+    int delMaskBytes = (rowCount + 7) / 8;
+    bool isnull = false;
+    errno_t rc = memset_s(delMask, delMaskBytes, 0, delMaskBytes);
+    securec_check(rc, "\0", "\0");
+
+    ScanKeyInit(&key[0], (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(VitrualDelColID));
+    ScanKeyInit(&key[1], (AttrNumber)CUDescCUIDAttr, BTEqualStrategyNumber, F_OIDEQ, UInt32GetDatum(cuid));
+
+    SysScanDesc scan = systable_beginscan_ordered(cudescRel, cudescIdx, SnapshotNow, ARRAY_2_LEN, key);
+    HeapTuple tup = systable_getnext_ordered(scan, ForwardScanDirection);
+    if (tup == NULL) {
+        ereport(ERROR,
+            (errcode(ERRCODE_DATA_CORRUPTED),
+                errmsg("delete bitmap of CU %u is missing in \"%s\"", cuid, RelationGetRelationName(cudescRel))));
+    }
+
+    char* bitmap = DatumGetPointer(fastgetattr(tup, CUDescCUPointerAttr, cudescRel->rd_att, &isnull));
+    if (!isnull) {
+        char* detoastPtr = (char*)PG_DETOAST_DATUM(bitmap);
+        Assert((int)VARSIZE_ANY_EXHDR(detoastPtr) == delMaskBytes);
+        rc = memcpy_s(delMask, delMaskBytes, VARDATA_ANY(detoastPtr), VARSIZE_ANY_EXHDR(detoastPtr));
+        securec_check(rc, "\0", "\0");
+        if (detoastPtr != bitmap)
+            pfree(detoastPtr);
+    }
+
+    ItemPointerData ctid = tup->t_self;
+    systable_endscan_ordered(scan);
+    return ctid;
+}
+
+/*
+ * @Description: load all the values of one column in one CU, see also CStoreDelete::PatchColumnCU().
+ *    The values may point into the CU returned, which the caller frees after copying them.
+ */
+static CU* ReclusterLoadColumn(Relation rel, Relation cudescRel, Relation cudescIdx, int col, uint32 cuid,
+    CUStorage* cuStorage, Datum* values, bool* nulls)
+{
+    Form_pg_attribute attr = rel->rd_att->attrs[col];
+    ScanKeyData key[ARRAY_2_LEN];
+    CUDesc cudesc;
+    CU* cu = NULL;
+
+    ScanKeyInit(&key[0], (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(attr->attnum));
+    ScanKeyInit(&key[1], (AttrNumber)CUDescCUIDAttr, BTEqualStrategyNumber, F_OIDEQ, UInt32GetDatum(cuid));
+
+    SysScanDesc scan = systable_beginscan_ordered(cudescRel, cudescIdx, SnapshotNow, ARRAY_2_LEN, key);
+    HeapTuple tup = systable_getnext_ordered(scan, ForwardScanDirection);
+    if (tup == NULL) {
+        ereport(ERROR,
+            (errcode(ERRCODE_DATA_CORRUPTED),
+                errmsg("CU %u of column %d is missing in \"%s\"", cuid, attr->attnum, RelationGetRelationName(rel))));
+    }
+    CStore::DeformCudescTuple(tup, cudescRel->rd_att, attr, &cudesc);
+    systable_endscan_ordered(scan);
+
+    int rowCount = cudesc.row_count;
+    if (cudesc.IsNullCU()) {
+        errno_t rc = memset_s(nulls, rowCount, true, rowCount);
+        securec_check(rc, "\0", "\0");
+    } else if (cudesc.IsSameValCU()) {
+        bool shouldFree = false;
+        Datum sameValue = CStore::CudescTupGetMinMaxDatum(&cudesc, attr, true, &shouldFree);
+        for (int row = 0; row < rowCount; ++row) {
+            values[row] = sameValue;
+            nulls[row] = false;
+        }
+    } else {
+        cu = LoadSingleCu::LoadSingleCuData(
+            &cudesc, col, attr->attlen, attr->atttypmod, attr->atttypid, rel, cuStorage);
+
+        GetValFunc getValFuncPtr[1];
+        InitGetValFunc(attr->attlen, getValFuncPtr, 0);
+        int getValFuncId = cu->HasNullValue() ? 1 : 0;
+
+        for (int row = 0; row < rowCount; ++row) {
+            nulls[row] = cu->IsNull(row);
+            if (!nulls[row])
+                values[row] = getValFuncPtr[0][getValFuncId](cu, row);
+        }
+    }
+
+    return cu;
+}
+
+/*
+ * @Description: decode the min or max of a fixed-length column from its CUDesc, the way the
+ *    rough checks read them. The value is copied, nothing else is allocated.
+ */
+static Datum ReclusterMinMaxDatum(CUDesc* cudesc, Form_pg_attribute attr, bool min)
+{
+    char* dataPtr = min ? cudesc->cu_min : cudesc->cu_max;
+
+    Assert(attr->attlen > 0 && attr->attlen <= MIN_MAX_LEN);
+    return datumCopy(fetch_att(dataPtr, attr->attbyval, attr->attlen), attr->attbyval, attr->attlen);
+}
+
+/*
+ * @Description: re-cluster the CUs of a column table or of one partition online. The CUs whose
+ *    ranges of the first partial cluster key overlap others are picked, at most maxCUs of them.
+ *    Their live rows are inserted again into new CUs, all sorted together by the partial cluster
+ *    key, and the old CUs are marked deleted. Readers keep seeing the old CUs until commit, and
+ *    the caller must keep the writers out of the relation until then.
+ *    The new rows are not inserted into the indexes, so relations with indexes are left to
+ *    VACUUM FULL. So are the relations clustered in Z-order, whose CUs overlap in each single
+ *    key column by design, and the relations whose first key is of variable length.
+ * @IN rel: column relation or partition
+ * @IN maxCUs: the most CUs to rewrite
+ * @Return: the number of CUs rewritten
+ */
+int CStoreReclusterCUs(Relation rel, int maxCUs)
+{
+    TupleDesc tupDesc = rel->rd_att;
+    TupleConstr* constr = tupDesc->constr;
+
+    if (maxCUs < 2 || !tupledesc_have_pck(constr) || RelationClusterInZOrder(rel))
+        return 0;
+
+    /* min/max of a variable-length key is a truncated prefix, so its max is no upper bound */
+    Form_pg_attribute keyAttr = tupDesc->attrs[constr->clusterKeys[0] - 1];
+    if (keyAttr->attlen <= 0)
+        return 0;
+
+    TypeCacheEntry* typentry = lookup_type_cache(keyAttr->atttypid, TYPECACHE_LT_OPR);
+    if (GetMinMaxFunc(keyAttr->atttypid) == NULL || !OidIsValid(typentry->lt_opr))
+        return 0;
+
+    MemoryContext reclusterCxt = AllocSetContextCreate(CurrentMemoryContext,
+        "cstore recluster",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE);
+    MemoryContext oldCxt = MemoryContextSwitchTo(reclusterCxt);
+
+    /* the CUs written before in this transaction, such as the merged delta rows, are seen too */
+    CommandCounterIncrement();
+
+    Relation cudescRel = heap_open(rel->rd_rel->relcudescrelid, RowExclusiveLock);
+    Relation cudescIdx = index_open(cudescRel->rd_rel->relcudescidx, RowExclusiveLock);
+    unsigned char* delMask = (unsigned char*)palloc((RelMaxFullCuSize + 7) / 8);
+
+    /* Step 1: collect min/max of the first cluster key of the CUs having live rows */
+    int cuNum = 0;
+    int cuMaxNum = 64;
+    ReclusterCU* cus = (ReclusterCU*)palloc(sizeof(ReclusterCU) * cuMaxNum);
+    ScanKeyData key[1];
+    HeapTuple tup = NULL;
+
+    ScanKeyInit(&key[0], (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(keyAttr->attnum));
+    SysScanDesc scan = systable_beginscan_ordered(cudescRel, cudescIdx, SnapshotNow, 1, key);
+    while ((tup = systable_getnext_ordered(scan, ForwardScanDirection)) != NULL) {
+        CUDesc cudesc;
+
+        CStore::DeformCudescTuple(tup, cudescRel->rd_att, keyAttr, &cudesc);
+        if (cudesc.IsNullCU() || cudesc.IsNoMinMaxCU())
+            continue;
+
+        (void)ReclusterGetDelMask(cudescRel, cudescIdx, cudesc.cu_id, cudesc.row_count, delMask);
+        if (CStore::IsTheWholeCuDeleted((char*)delMask, cudesc.row_count))
+            continue;
+
+        if (cuNum == cuMaxNum) {
+            cuMaxNum *= 2;
+            cus = (ReclusterCU*)repalloc(cus, sizeof(ReclusterCU) * cuMaxNum);
+        }
+        cus[cuNum].cuid = cudesc.cu_id;
+        cus[cuNum].rowCount = cudesc.row_count;
+        cus[cuNum].min = ReclusterMinMaxDatum(&cudesc, keyAttr, true);
+        cus[cuNum].max = ReclusterMinMaxDatum(&cudesc, keyAttr, false);
+        ++cuNum;
+    }
+    systable_endscan_ordered(scan);
+
+    /*
+     * Step 2: sort the CUs by min and split them into groups whose ranges overlap. A group
+     * is disjoint with the others, so its rows sorted together make CUs disjoint with all
+     * the others.
+     */
+    SortSupportData ssup;
+    errno_t rc = memset_s(&ssup, sizeof(SortSupportData), 0, sizeof(SortSupportData));
+    securec_check(rc, "\0", "\0");
+    ssup.ssup_cxt = reclusterCxt;
+    ssup.ssup_collation = keyAttr->attcollation;
+    PrepareSortSupportFromOrderingOp(typentry->lt_opr, &ssup);
+
+    qsort_arg(cus, cuNum, sizeof(ReclusterCU), ReclusterCUCmp, &ssup);
+
+    ReclusterCU** selected = (ReclusterCU**)palloc(sizeof(ReclusterCU*) * (Min(cuNum, maxCUs) + 1));
+    int selectedNum = 0;
+    int groupStart = 0;
+    Datum groupMax = (cuNum > 0) ? cus[0].max : (Datum)0;
+    for (int i = 1; i <= cuNum; ++i) {
+        if (i < cuNum && ApplySortComparator(cus[i].min, false, groupMax, false, &ssup) < 0) {
+            if (ApplySortComparator(cus[i].max, false, groupMax, false, &ssup) > 0)
+                groupMax = cus[i].max;
+            continue;
+        }
+
+        int groupSize = Min(i - groupStart, maxCUs - selectedNum);
+        if (groupSize > 1) {
+            for (int j = 0; j < groupSize; ++j)
+                selected[selectedNum++] = &cus[groupStart + j];
+        }
+        if (i == cuNum || maxCUs - selectedNum < 2)
+            break;
+        groupStart = i;
+        groupMax = cus[i].max;
+    }
+
+    /* Step 3: insert the live rows of the selected CUs again and delete them in the old CUs */
+    if (selectedNum > 0) {
+        int natts = tupDesc->natts;
+        CUStorage** cuStorage = (CUStorage**)palloc0(sizeof(CUStorage*) * natts);
+        Datum** values = (Datum**)palloc(sizeof(Datum*) * natts);
+        bool** nulls = (bool**)palloc(sizeof(bool*) * natts);
+        CU** loadedCUs = (CU**)palloc0(sizeof(CU*) * natts);
+        Datum* rowValues = (Datum*)palloc(sizeof(Datum) * natts);
+        bool* rowNulls = (bool*)palloc(sizeof(bool) * natts);
+
+        for (int col = 0; col < natts; ++col) {
+            values[col] = (Datum*)palloc(sizeof(Datum) * RelMaxFullCuSize);
+            nulls[col] = (bool*)palloc(sizeof(bool) * RelMaxFullCuSize);
+            if (!tupDesc->attrs[col]->attisdropped) {
+                CFileNode cFileNode(rel->rd_node, tupDesc->attrs[col]->attnum, MAIN_FORKNUM);
+                cuStorage[col] = New(CurrentMemoryContext) CUStorage(cFileNode);
+            }
+        }
+
+        InsertArg args;
+        CStoreInsert::InitInsertArg(rel, NULL, false, args);
+        args.sortAllRows = true;
+        CStoreInsert cstoreInsert(rel, args, false, NULL, NULL);
+        bulkload_rows batchRow(tupDesc, RelationGetMaxBatchRows(rel), true);
+
+        for (int i = 0; i < selectedNum; ++i) {
+            uint32 cuid = selected[i]->cuid;
+            int rowCount = selected[i]->rowCount;
+
+            CHECK_FOR_INTERRUPTS();
+
+            ItemPointerData delCtid = ReclusterGetDelMask(cudescRel, cudescIdx, cuid, rowCount, delMask);
+            for (int col = 0; col < natts; ++col) {
+                if (tupDesc->attrs[col]->attisdropped) {
+                    rc = memset_s(nulls[col], rowCount, true, rowCount);
+                    securec_check(rc, "\0", "\0");
+                    continue;
+                }
+                loadedCUs[col] = ReclusterLoadColumn(
+                    rel, cudescRel, cudescIdx, col, cuid, cuStorage[col], values[col], nulls[col]);
+            }
+
+            for (int row = 0; row < rowCount; ++row) {
+                if (delMask[row >> 3] & (1 << (row % 8)))
+                    continue;
+
+                for (int col = 0; col < natts; ++col) {
+                    rowValues[col] = values[col][row];
+                    rowNulls[col] = nulls[col][row];
+                }
+                (void)batchRow.append_one_tuple(rowValues, rowNulls, tupDesc);
+                if (batchRow.full_rownum()) {
+                    cstoreInsert.BatchInsert(&batchRow, 0);
+                    batchRow.reset(true);
+                }
+                delMask[row >> 3] |= (1 << (row % 8));
+            }
+
+            for (int col = 0; col < natts; ++col) {
+                if (loadedCUs[col] != NULL)
+                    DELETE_EX(loadedCUs[col]);
+            }
+
+            /* all the rows of the old CU are deleted now */
+            HeapTuple newTup = CStore::FormVCCUDescTup(
+                cudescRel->rd_att, (char*)delMask, cuid, rowCount, GetCurrentTransactionIdIfAny());
+            simple_heap_update(cudescRel, &delCtid, newTup);
+            CatalogUpdateIndexes(cudescRel, newTup);
+            heap_freetuple(newTup);
+        }
+        cstoreInsert.SetEndFlag();
+        cstoreInsert.BatchInsert(&batchRow, 0);
+
+        CStoreInsert::DeInitInsertArg(args);
+        batchRow.Destroy();
+        cstoreInsert.Destroy();
+        for (int col = 0; col < natts; ++col) {
+            if (cuStorage[col] != NULL)
+                DELETE_EX(cuStorage[col]);
+        }
+    }
+
+    index_close(cudescIdx, RowExclusiveLock);
+    heap_close(cudescRel, NoLock);
+
+    (void)MemoryContextSwitchTo(oldCxt);
+    MemoryContextDelete(reclusterCxt);
+
+    return selectedNum;
+}
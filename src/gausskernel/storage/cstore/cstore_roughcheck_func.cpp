@@ -414,3 +414,80 @@ bool RoughCheckAllThrough(CUDesc* cudesc, Datum arg)
 {
     return true;
 }
+
+/*
+ * All the values of CU are in [min, max], check the bounds against the
+ * argument. A CU with the same value is a single run, so it is compared once.
+ */
+template <class T, class ArgT, int strategy>
+bool FullCheckIntCU(CUDesc* cudesc, Datum arg)
+{
+    int64 min = *(T*)cudesc->cu_min;
+    int64 max = *(T*)cudesc->cu_max;
+    int64 val = (sizeof(ArgT) == sizeof(int64)) ? DatumGetInt64(arg) : DatumGetInt32(arg);
+
+    switch (strategy) {
+        case CStoreLessStrategyNumber:
+            return max < val;
+        case CStoreLessEqualStrategyNumber:
+            return max <= val;
+        case CStoreEqualStrategyNumber:
+            return min == val && max == val;
+        case CStoreGreaterEqualStrategyNumber:
+            return min >= val;
+        case CStoreGreaterStrategyNumber:
+            return min > val;
+        default:
+            return false;
+    }
+}
+
+template <class T, class ArgT>
+static FullCheckFunc GetFullCheckIntFunc(int strategy)
+{
+    switch (strategy) {
+        case CStoreLessStrategyNumber:
+            return FullCheckIntCU<T, ArgT, CStoreLessStrategyNumber>;
+        case CStoreLessEqualStrategyNumber:
+            return FullCheckIntCU<T, ArgT, CStoreLessEqualStrategyNumber>;
+        case CStoreEqualStrategyNumber:
+            return FullCheckIntCU<T, ArgT, CStoreEqualStrategyNumber>;
+        case CStoreGreaterEqualStrategyNumber:
+            return FullCheckIntCU<T, ArgT, CStoreGreaterEqualStrategyNumber>;
+        case CStoreGreaterStrategyNumber:
+            return FullCheckIntCU<T, ArgT, CStoreGreaterStrategyNumber>;
+        default:
+            return NULL;
+    }
+}
+
+/*
+ * Only the integer like types are supported, whose min/max are exact and whose
+ * scan key argument is read as rough check does. The min/max of strings are
+ * truncated prefixes, which can not tell that all the values match.
+ */
+FullCheckFunc GetFullCheckFunc(Oid typeOid, int strategy)
+{
+    switch (typeOid) {
+        case INT2OID:
+            return GetFullCheckIntFunc<int16, int64>(strategy);
+        case INT4OID:
+            return GetFullCheckIntFunc<int32, int64>(strategy);
+        case INT8OID:
+            return GetFullCheckIntFunc<int64, int64>(strategy);
+        case OIDOID:
+            return GetFullCheckIntFunc<uint32, int64>(strategy);
+        case DATEOID:
+            return GetFullCheckIntFunc<DateADT, DateADT>(strategy);
+#ifdef HAVE_INT64_TIMESTAMP
+        case TIMEOID:
+            return GetFullCheckIntFunc<TimeADT, TimeADT>(strategy);
+        case TIMESTAMPOID:
+            return GetFullCheckIntFunc<Timestamp, Timestamp>(strategy);
+        case TIMESTAMPTZOID:
+            return GetFullCheckIntFunc<TimestampTz, TimestampTz>(strategy);
+#endif
+        default:
+            return NULL;
+    }
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * cstore_summary.cpp
+ *      per-CU bloom filter and value counts of ColStore
+ *
+ *  Min/max of a CU can not skip anything for an equality filter on an unsorted
+ *  column with many distinct values, because nearly every CU covers the whole
+ *  value range. For the columns listed in the reloption BLOOM_FILTER_COLUMNS a
+ *  small bloom filter together with the NULL and distinct counts is formed when
+ *  a CU is written and stored in the extra attribute of its cudesc tuple. Scan
+ *  keys and runtime join filters probe it to skip CUs which can not contain the
+ *  wanted value.
+ *
+ *  Integer family values are hashed as int64, the same as the arguments of the
+ *  scan keys (see convert_scan_key_int64_if_need()), so that the probe does not
+ *  depend on the width of the constant. Blank-padded strings are hashed without
+ *  the trailing spaces as bpchareq() ignores them.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/cstore/cstore_summary.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "access/cstore_summary.h"
+#include "access/hash.h"
+#include "catalog/pg_type.h"
+#include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/lsyscache.h"
+#include "utils/timestamp.h"
+
+#include <math.h>
+
+/* bits of bloom filter for each non-null value, which gives about 1% false positive with 4 probes */
+#define CU_SUMMARY_BITS_PER_VALUE 10
+#define CU_SUMMARY_PROBE_NUM 4
+#define CU_SUMMARY_MIN_BITS 512
+#define CU_SUMMARY_MAX_BITS (1 << 19)
+
+static uint32 CUSummaryBloomBits(uint32 values)
+{
+    uint64 want = (uint64)values * CU_SUMMARY_BITS_PER_VALUE;
+    uint32 bits = CU_SUMMARY_MIN_BITS;
+
+    while (bits < want && bits < CU_SUMMARY_MAX_BITS) {
+        bits <<= 1;
+    }
+    return bits;
+}
+
+static inline uint32 CUSummaryHashInt64(int64 value)
+{
+    return DatumGetUInt32(hash_any((const unsigned char*)&value, sizeof(int64)));
+}
+
+static uint32 CUSummaryHashString(Oid typeOid, Datum value)
+{
+    text* txt = DatumGetTextPP(value);
+    int len = VARSIZE_ANY_EXHDR(txt);
+    char* data = VARDATA_ANY(txt);
+
+    if (typeOid == BPCHAROID) {
+        len = bpchartruelen(data, len);
+    }
+    return DatumGetUInt32(hash_any((const unsigned char*)data, len));
+}
+
+/*
+ * @Description: whether a summary can be formed for the column of this data type
+ */
+bool CUSummarySupportType(Oid typeOid)
+{
+    switch (typeOid) {
+        case INT2OID:
+        case INT4OID:
+        case INT8OID:
+        case DATEOID:
+#ifdef HAVE_INT64_TIMESTAMP
+        case TIMEOID:
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+#endif
+        case TEXTOID:
+        case VARCHAROID:
+        case BPCHAROID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * @Description: get the columns listed in reloption BLOOM_FILTER_COLUMNS
+ * @IN rel: column relation
+ * @Return: array indexed by attribute number - 1, or NULL if no column is listed
+ */
+bool* CStoreGetSummaryColumns(Relation rel)
+{
+    char* columns = StdRdOptionsGetStringData(rel->rd_options, bloom_filter_columns, NULL);
+    if (columns == NULL || columns[0] == '\0') {
+        return NULL;
+    }
+
+    TupleDesc tupDesc = RelationGetDescr(rel);
+    bool* summaryCols = (bool*)palloc0(sizeof(bool) * tupDesc->natts);
+    bool found = false;
+    List* nameList = NIL;
+    ListCell* cell = NULL;
+    char* rawString = pstrdup(columns);
+
+    (void)SplitIdentifierString(rawString, ',', &nameList);
+    foreach (cell, nameList) {
+        char* name = (char*)lfirst(cell);
+        for (int i = 0; i < tupDesc->natts; i++) {
+            Form_pg_attribute attr = tupDesc->attrs[i];
+            if (!attr->attisdropped && CUSummarySupportType(attr->atttypid) &&
+                strcmp(NameStr(attr->attname), name) == 0) {
+                summaryCols[i] = true;
+                found = true;
+                break;
+            }
+        }
+    }
+
+    list_free(nameList);
+    pfree(rawString);
+    if (!found) {
+        pfree(summaryCols);
+        summaryCols = NULL;
+    }
+    return summaryCols;
+}
+
+/*
+ * @Description: check that every column of reloption BLOOM_FILTER_COLUMNS
+ *     exists in the relation and has a supported data type.
+ * @IN stdOpt: options of the relation
+ * @IN tupDesc: tuple descriptor of the relation
+ */
+void CheckCStoreSummaryColumns(StdRdOptions* stdOpt, TupleDesc tupDesc)
+{
+    char* columns = StdRdOptionsGetStringData(stdOpt, bloom_filter_columns, NULL);
+    if (columns == NULL || columns[0] == '\0') {
+        return;
+    }
+
+    List* nameList = NIL;
+    ListCell* cell = NULL;
+    char* rawString = pstrdup(columns);
+
+    if (!SplitIdentifierString(rawString, ',', &nameList)) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("invalid list syntax for \"bloom_filter_columns\" option")));
+    }
+
+    foreach (cell, nameList) {
+        char* name = (char*)lfirst(cell);
+        Form_pg_attribute found = NULL;
+        for (int i = 0; i < tupDesc->natts; i++) {
+            Form_pg_attribute attr = tupDesc->attrs[i];
+            if (!attr->attisdropped && strcmp(NameStr(attr->attname), name) == 0) {
+                found = attr;
+                break;
+            }
+        }
+
+        if (found == NULL) {
+            ereport(ERROR,
+                (errcode(ERRCODE_UNDEFINED_COLUMN),
+                    errmsg("column \"%s\" in \"bloom_filter_columns\" option does not exist", name)));
+        }
+        if (!CUSummarySupportType(found->atttypid)) {
+            ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                    errmsg("column \"%s\" of type %s does not support bloom filter",
+                        name, format_type_be(found->atttypid))));
+        }
+    }
+
+    list_free(nameList);
+    pfree(rawString);
+}
+
+/*
+ * @Description: hash a column value for the bloom filter
+ * @IN typeOid: data type of the value
+ * @IN value: not NULL value
+ */
+uint32 CUSummaryHashDatum(Oid typeOid, Datum value)
+{
+    switch (typeOid) {
+        case INT2OID:
+            return CUSummaryHashInt64((int64)DatumGetInt16(value));
+        case INT4OID:
+            return CUSummaryHashInt64((int64)DatumGetInt32(value));
+        case INT8OID:
+            return CUSummaryHashInt64(DatumGetInt64(value));
+        case DATEOID:
+            return CUSummaryHashInt64((int64)DatumGetDateADT(value));
+#ifdef HAVE_INT64_TIMESTAMP
+        case TIMEOID:
+            return CUSummaryHashInt64((int64)DatumGetTimeADT(value));
+        case TIMESTAMPOID:
+            return CUSummaryHashInt64((int64)DatumGetTimestamp(value));
+        case TIMESTAMPTZOID:
+            return CUSummaryHashInt64((int64)DatumGetTimestampTz(value));
+#endif
+        case TEXTOID:
+        case VARCHAROID:
+        case BPCHAROID:
+            return CUSummaryHashString(typeOid, value);
+        default:
+            Assert(false);
+            return 0;
+    }
+}
+
+/*
+ * @Description: hash the argument of a scan key on a column of this data type.
+ *     Arguments for integer columns have been converted to int64.
+ */
+uint32 CUSummaryHashScanKey(Oid typeOid, Datum arg)
+{
+    switch (typeOid) {
+        case INT2OID:
+        case INT4OID:
+        case INT8OID:
+            return CUSummaryHashInt64(DatumGetInt64(arg));
+        default:
+            return CUSummaryHashDatum(typeOid, arg);
+    }
+}
+
+static inline void CUSummaryAddHash(CUSummary* summary, uint32 hash)
+{
+    uint32 mask = summary->bloom_bits - 1;
+    uint32 h2 = DatumGetUInt32(hash_uint32(hash)) | 1;
+
+    for (int i = 0; i < CU_SUMMARY_PROBE_NUM; i++) {
+        uint32 pos = (hash + (uint32)i * h2) & mask;
+        summary->bloom[pos >> 6] |= ((uint64)1 << (pos & 63));
+    }
+}
+
+/*
+ * @Description: probe the bloom filter of a CU
+ * @Return: false if the value is surely not in the CU
+ */
+bool CUSummaryMayContain(const CUSummary* summary, uint32 hash)
+{
+    uint32 mask = summary->bloom_bits - 1;
+    uint32 h2 = DatumGetUInt32(hash_uint32(hash)) | 1;
+
+    for (int i = 0; i < CU_SUMMARY_PROBE_NUM; i++) {
+        uint32 pos = (hash + (uint32)i * h2) & mask;
+        if ((summary->bloom[pos >> 6] & ((uint64)1 << (pos & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * @Description: form the summary of one column of a CU
+ * @IN typeOid: data type of the column
+ * @IN vector: values of the column
+ * @IN rows: number of values including NULLs
+ * @Return: summary allocated in the current memory context
+ */
+CUSummary* FormCUSummary(Oid typeOid, bulkload_vector* vector, int rows)
+{
+    uint32 bits = CUSummaryBloomBits((uint32)rows);
+    CUSummary* summary = (CUSummary*)palloc0(CUSummarySize(bits));
+    bulkload_vector_iter iter;
+    uint32 nonNulls = 0;
+    Datum value = (Datum)0;
+    bool isNull = false;
+
+    summary->bloom_bits = bits;
+    iter.begin(vector, rows);
+    while (iter.not_end()) {
+        iter.next(&value, &isNull);
+        if (isNull) {
+            summary->null_count++;
+            continue;
+        }
+        CUSummaryAddHash(summary, CUSummaryHashDatum(typeOid, value));
+        nonNulls++;
+    }
+
+    /*
+     * Estimate the distinct values from the fraction of set bits,
+     *     n = -(m / k) * ln(1 - X / m)
+     * which is good enough to size the filter and for the optimizer.
+     */
+    uint32 setBits = 0;
+    for (uint32 i = 0; i < bits / 64; i++) {
+        setBits += (uint32)__builtin_popcountll(summary->bloom[i]);
+    }
+    double distinct = nonNulls;
+    if (setBits < bits) {
+        distinct = -((double)bits / CU_SUMMARY_PROBE_NUM) * log(1.0 - (double)setBits / bits);
+    }
+    summary->distinct_count = (uint32)Min(Max(rint(distinct), (nonNulls > 0) ? 1.0 : 0.0), (double)nonNulls);
+
+    /*
+     * Few distinct values need far less bits than the rows, fold the filter to
+     * the size for them. Folding keeps every bit position modulo the new size,
+     * so the probes still work.
+     */
+    uint32 target = CUSummaryBloomBits(summary->distinct_count);
+    while (summary->bloom_bits > target) {
+        uint32 halfWords = summary->bloom_bits / 128;
+        for (uint32 i = 0; i < halfWords; i++) {
+            summary->bloom[i] |= summary->bloom[i + halfWords];
+        }
+        summary->bloom_bits >>= 1;
+    }
+
+    return summary;
+}
+
+/*
+ * @Description: decode the summary kept in the extra attribute of cudesc tuple
+ * @IN extra: not NULL value of the extra attribute
+ * @Return: summary allocated in the current memory context, or NULL if it is not a summary
+ */
+CUSummary* DeformCUSummary(Datum extra)
+{
+    text* txt = DatumGetTextPP(extra);
+    uint32 len = VARSIZE_ANY_EXHDR(txt);
+
+    if (len < CUSummaryHeaderSize) {
+        return NULL;
+    }
+
+    /* copy out for the alignment of bloom words */
+    CUSummary* summary = (CUSummary*)palloc(len);
+    errno_t rc = memcpy_s(summary, len, VARDATA_ANY(txt), len);
+    securec_check(rc, "\0", "\0");
+
+    uint32 bits = summary->bloom_bits;
+    if (bits < CU_SUMMARY_MIN_BITS || (bits & (bits - 1)) != 0 || len != CUSummarySize(bits)) {
+        pfree(summary);
+        return NULL;
+    }
+    return summary;
+}
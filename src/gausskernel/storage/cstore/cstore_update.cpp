@@ -25,6 +25,9 @@
 #include "knl/knl_variable.h"
 
 #include "access/cstore_update.h"
+#include "access/sysattr.h"
+#include "parser/parsetree.h"
+#include "utils/relcache.h"
 
 int CStoreUpdate::BATCHROW_TIMES = 3;
 
@@ -38,6 +41,9 @@ CStoreUpdate::CStoreUpdate(_in_ Relation rel, _in_ EState* estate, _in_ Plan* pl
     m_isPartition = RELATION_IS_PARTITIONED(rel);
     m_delMemInfo = NULL;
     m_insMemInfo = NULL;
+    m_patchCols = NULL;
+    m_deltaBatch = NULL;
+    m_deltaSel = NULL;
 
     /* init memory, memory info will be used to init delete and insert. */
     InitUpdateMemArg(plan);
@@ -61,6 +67,9 @@ CStoreUpdate::CStoreUpdate(_in_ Relation rel, _in_ EState* estate, _in_ Plan* pl
         m_partionInsert->SetPartitionCacheStrategy(FLASH_WHEN_SWICH_PARTITION);
         m_insert = NULL;
     }
+
+    /* init column level update after insert, which builds the column space cache */
+    InitPatchColumns();
 }
 
 CStoreUpdate::~CStoreUpdate()
@@ -73,6 +82,9 @@ CStoreUpdate::~CStoreUpdate()
     m_insMemInfo = NULL;
     m_delete = NULL;
     m_delMemInfo = NULL;
+    m_patchCols = NULL;
+    m_deltaBatch = NULL;
+    m_deltaSel = NULL;
 }
 
 void CStoreUpdate::Destroy()
@@ -97,6 +109,16 @@ void CStoreUpdate::Destroy()
     if (m_insMemInfo) {
         pfree_ext(m_insMemInfo);
     }
+
+    if (m_patchCols) {
+        pfree_ext(m_patchCols);
+        pfree_ext(m_deltaSel);
+    }
+
+    if (m_deltaBatch) {
+        pfree(m_deltaBatch);
+        m_deltaBatch = NULL;
+    }
 }
 
 /*
@@ -194,6 +216,55 @@ void CStoreUpdate::InitUpdateMemArg(Plan* plan)
     }
 }
 
+/*
+ * @Description: decide whether the updated columns are written as patch CUs. Then only the
+ *    CUs of the updated columns are written again for the rows not in delta table, instead
+ *    of deleting the rows and inserting all their columns. It's used if
+ *    1) enable_cstore_column_update is on and the table is not partitioned;
+ *    2) no updated column is used by any index, since the rows keep their ctids;
+ *    3) some column is not updated.
+ * @See also: CStoreDelete::InitPatchColumns
+ */
+void CStoreUpdate::InitPatchColumns()
+{
+    if (!u_sess->attr.attr_storage.enable_cstore_column_update || m_isPartition)
+        return;
+
+    RangeTblEntry* rte = rt_fetch(m_resultRelInfo->ri_RangeTableIndex, m_estate->es_range_table);
+    Bitmapset* indexedCols = RelationGetIndexAttrBitmap(m_relation, INDEX_ATTR_BITMAP_ALL);
+    bool usable = !bms_is_empty(rte->updatedCols) && !bms_overlap(rte->updatedCols, indexedCols);
+    bms_free(indexedCols);
+
+    if (!usable)
+        return;
+
+    int attNo = m_relation->rd_att->natts;
+    int patchNum = 0;
+    int liveNum = 0;
+    bool* patchCols = (bool*)palloc0(sizeof(bool) * attNo);
+
+    for (int col = 0; col < attNo; ++col) {
+        Form_pg_attribute attr = m_relation->rd_att->attrs[col];
+        if (attr->attisdropped)
+            continue;
+
+        liveNum++;
+        if (bms_is_member(attr->attnum - FirstLowInvalidHeapAttributeNumber, rte->updatedCols)) {
+            patchCols[col] = true;
+            patchNum++;
+        }
+    }
+
+    if (patchNum == 0 || patchNum == liveNum) {
+        pfree(patchCols);
+        return;
+    }
+
+    m_patchCols = patchCols;
+    m_deltaSel = (bool*)palloc(sizeof(bool) * BatchMaxSize);
+    m_delete->InitPatchColumns(m_patchCols);
+}
+
 void CStoreUpdate::InitSortState(TupleDesc sortTupDesc)
 {
     Assert(sortTupDesc && m_resultRelInfo && m_delete);
@@ -202,6 +273,41 @@ void CStoreUpdate::InitSortState(TupleDesc sortTupDesc)
 
     // init delete sort state
     m_delete->InitSortState(sortTupDesc, junkfilter->jf_xc_part_id, junkfilter->jf_junkAttNo);
+
+    // the rows of delta table are picked out of each batch to be inserted again
+    if (m_patchCols != NULL)
+        m_deltaBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, sortTupDesc);
+}
+
+/*
+ * @Description: pick out the rows of delta table when the updated columns are patched.
+ * @IN batch: batch to update
+ * @IN junkfilter: junk filter to find the table oid of each row
+ * @Return: rows of delta table, or NULL if there is none.
+ */
+VectorBatch* CStoreUpdate::GetDeltaBatch(_in_ VectorBatch* batch, _in_ JunkFilter* junkfilter)
+{
+    Assert(m_deltaBatch && m_deltaSel);
+
+    ScalarValue* tableOids = batch->m_arr[junkfilter->jf_xc_part_id - 1].m_vals;
+    Oid deltaOid = m_relation->rd_rel->reldeltarelid;
+    int deltaRows = 0;
+
+    for (int i = 0; i < batch->m_rows; ++i) {
+        m_deltaSel[i] = (DatumGetObjectId(tableOids[i]) == deltaOid);
+        if (m_deltaSel[i])
+            deltaRows++;
+    }
+
+    if (deltaRows == 0)
+        return NULL;
+
+    m_deltaBatch->m_cols = batch->m_cols;
+    m_deltaBatch->Copy<false, false>(batch);
+    if (deltaRows < batch->m_rows)
+        m_deltaBatch->Pack(m_deltaSel);
+
+    return m_deltaBatch;
 }
 
 uint64 CStoreUpdate::ExecUpdate(_in_ VectorBatch* batch, _in_ int options)
@@ -211,9 +317,12 @@ uint64 CStoreUpdate::ExecUpdate(_in_ VectorBatch* batch, _in_ int options)
 
     JunkFilter* junkfilter = m_resultRelInfo->ri_junkFilter;
 
-    // delete
+    // delete, or patch the updated columns of the rows not in delta table
     m_delete->PutDeleteBatch(batch, junkfilter);
 
+    // only the rows of delta table are inserted again if the updated columns are patched
+    VectorBatch* insertBatch = (m_patchCols == NULL) ? batch : GetDeltaBatch(batch, junkfilter);
+
     int oriCols = batch->m_cols;
     batch->m_cols = junkfilter->jf_cleanTupType->natts;
 
@@ -222,10 +331,13 @@ uint64 CStoreUpdate::ExecUpdate(_in_ VectorBatch* batch, _in_ int options)
         ExecVecConstraints(m_resultRelInfo, batch, m_estate);
 
     // insert then batch
-    if (m_isPartition)
-        m_partionInsert->BatchInsert(batch, options);
-    else
-        m_insert->BatchInsert(batch, options);
+    if (insertBatch != NULL) {
+        insertBatch->m_cols = batch->m_cols;
+        if (m_isPartition)
+            m_partionInsert->BatchInsert(insertBatch, options);
+        else
+            m_insert->BatchInsert(insertBatch, options);
+    }
 
     batch->m_cols = oriCols;
 
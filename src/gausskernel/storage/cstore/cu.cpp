@@ -77,6 +77,7 @@ void CUDesc::Reset()
     cu_pointer = 0;
     magic = 0;
     xmin = 0;
+    cu_summary = NULL;
 }
 
 FORCE_INLINE
@@ -469,30 +470,119 @@ uint32 CU::GenerateCrc(uint16 info_mode) const
  */
 void CU::Compress(int valCount, int16 compress_modes)
 {
-    errno_t rc;
+    AllocCompressBuf();
+    CompressToBuf(valCount, compress_modes);
+
+    // Step 5; free source buffer
+    FreeSrcBuf();
+}
 
+/*
+ * @Description: allocate the buffer of compressed data
+ * @See also: CU::CompressToBuf
+ */
+void CU::AllocCompressBuf(void)
+{
     // Step 1: initialize allocate the size of compress_buffer
     // source data size + nulls bitmap size + header size
     // We guarantee that compress data size will not exceed it
     m_compressedBufSize = ALLIGN_CUSIZE(m_srcDataSize + m_bpNullRawSize + sizeof(CU));
     m_compressedBuf = (char*)CStoreMemAlloc::Palloc(m_compressedBufSize, !m_inCUCache);
+}
 
+/*
+ * @Description: compress the source data into the buffer allocated by AllocCompressBuf().
+ *    Neither the source buffer nor the compressed buffer is allocated or freed here.
+ * @IN compress_modes: compressing modes
+ * @IN valCount: values count
+ * @See also: CU::BeginCompressToBuf
+ */
+void CU::CompressToBuf(int valCount, int16 compress_modes)
+{
+    Assert(m_compressedBuf != NULL);
     int16 headerLen = GetCUHeaderSize();
     char* buf = m_compressedBuf + headerLen;
+    uint16 modes = 0;
+    int compressOutSize = 0;
 
     // Step 2: fill Compress NULL bitmap
     buf = CompressNullBitmapIfNeed(buf);
 
     // Step 3: Compress data
-    bool compressed = false;
     if (COMPRESS_NO != heaprel_get_compression_from_modes(compress_modes))
-        compressed = CompressData(buf, valCount, compress_modes);
+        compressOutSize = CompressData(buf, valCount, compress_modes, NULL, &modes);
+
+    FinishCompressToBuf(buf, compressOutSize, modes);
+}
 
-    // case 1: user defines that input data shouldn't be compressed.
-    // case 2: even though user has defined to compress data, but the compressed data' size
-    //        is bigger than the uncompressed data's.
-    //   so use the raw data other than the compressed data.
-    if (compressed == false) {
+/*
+ * @Description: like CompressToBuf(), but the codec may leave its LZ4/zlib step to
+ *    the task, which helper threads run, see CStoreInsert::CompressCUsInParallel().
+ *    If so, EndCompressToBuf() completes the CU after the task is run.
+ * @IN compress_modes: compressing modes
+ * @IN valCount: values count
+ * @OUT task: LZ4/zlib left over, pending is false if the CU is compressed already
+ */
+void CU::BeginCompressToBuf(int valCount, int16 compress_modes, GeneralCompressTask* task)
+{
+    Assert(m_compressedBuf != NULL);
+    char* buf = CompressNullBitmapIfNeed(m_compressedBuf + GetCUHeaderSize());
+    uint16 modes = 0;
+    int compressOutSize = 0;
+
+    task->pending = false;
+    if (COMPRESS_NO != heaprel_get_compression_from_modes(compress_modes))
+        compressOutSize = CompressData(buf, valCount, compress_modes, task, &modes);
+
+    if (!task->pending)
+        FinishCompressToBuf(buf, compressOutSize, modes);
+}
+
+void CU::EndCompressToBuf(GeneralCompressTask* task)
+{
+    if (task->pending) {
+        char* buf = m_compressedBuf + GetCUHeaderSize() + m_bpNullCompressedSize;
+        uint16 modes = 0;
+        int compressOutSize = FinishGeneralCompress(task, &modes);
+
+        FinishCompressToBuf(buf, compressOutSize, modes);
+    }
+}
+
+/*
+ * @Description: fill the CU after its data is compressed into buf, or copy the raw
+ *    data if it isn't compressed.
+ * @IN buf: compressed data following the null bitmap
+ * @IN compressOutSize: compressed data size, 0 if not compressed
+ * @IN modes: compression modes of the data
+ */
+void CU::FinishCompressToBuf(char* buf, int compressOutSize, uint16 modes)
+{
+    errno_t rc;
+    int16 headerLen = GetCUHeaderSize();
+
+    if (compressOutSize > 0) {
+        // compress successfully, compute CU size and set the compression info.
+        Assert((uint32)compressOutSize < m_srcDataSize);
+        Assert((0 == (modes & CU_INFOMASK2)) && (0 != (modes & CU_INFOMASK1)));
+        m_infoMode |= (modes & CU_INFOMASK1);
+
+        m_cuSizeExcludePadding = (buf - m_compressedBuf) + compressOutSize;
+        m_cuSize = ALLIGN_CUSIZE(m_cuSizeExcludePadding);
+        Assert(m_cuSize <= m_compressedBufSize);
+        PADDING_CU(m_compressedBuf + m_cuSizeExcludePadding, m_cuSize - m_cuSizeExcludePadding);
+
+        /* set compression filter for this CU data */
+        compression_options* ref_filter = (compression_options*)m_tmpinfo->m_options;
+        if (!ref_filter->m_sampling_fihished) {
+            /* sample and set adopted compression methods */
+            ref_filter->set_common_flags(modes);
+        }
+    } else {
+        // case 1: user defines that input data shouldn't be compressed.
+        // case 2: even though user has defined to compress data, but the compressed data' size
+        //        is bigger than the uncompressed data's.
+        //   so use the raw data other than the compressed data.
         rc = memcpy_s(buf, m_srcDataSize, m_srcData, m_srcDataSize);
         securec_check(rc, "\0", "\0");
         m_cuSizeExcludePadding = headerLen + m_bpNullCompressedSize + m_srcDataSize;
@@ -507,9 +597,6 @@ void CU::Compress(int valCount, int16 compress_modes)
     FillCompressBufHeader();
 
     m_cache_compressed = true;
-
-    // Step 5; free source buffer
-    FreeSrcBuf();
 }
 
 // 	  CompressBufHeader
@@ -585,11 +672,14 @@ char* CU::CompressNullBitmapIfNeed(_in_ char* buf)
  * @Description: compress one CU data.
  * @IN compress_modes: compressing modes
  * @IN nVals: values' number
+ * @IN task: if not NULL, the codec may leave its LZ4/zlib step to it
  * @OUT outBuf: output buffer
- * @Return:
- * @See also:
+ * @OUT modes: compression modes of the output
+ * @Return: compressed data size, 0 if not compressed or left to the task
+ * @See also: CU::FinishCompressToBuf
  */
-bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_modes)
+int CU::CompressData(
+    _out_ char* outBuf, _in_ int nVals, _in_ int16 compress_modes, GeneralCompressTask* task, _out_ uint16* modes)
 {
     int compressOutSize = 0;
     bool beDelta2Compressed = false;
@@ -606,6 +696,7 @@ bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_mo
     input.sz = m_srcDataSize;
     input.buf = m_srcData;
     input.mode = compress_modes;
+    input.task = NULL;
 
     /* set compression filter for this CU data */
     compression_options* ref_filter = (compression_options*)m_tmpinfo->m_options;
@@ -623,6 +714,7 @@ bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_mo
         output = {0};
         output.buf = outBuf;
         output.sz = (m_compressedBuf + m_compressedBufSize) - outBuf;
+        input.task = task;
 
         if (m_infoMode & CU_IntLikeCompressed) {
             if (ATT_IS_CHAR_TYPE(m_atttypid)) {
@@ -672,6 +764,7 @@ bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_mo
             // for var-length datatype whose size is -1, dictionary method can be applied
             // to. so try it first.
             input.useDict = (m_eachValSize > 8) ? false : (COMPRESS_LOW != compression);
+            input.useFSST = (m_eachValSize == -1);
 
             // the number of values is excluding the number of NULL values.
             input.numVals = HasNullValue() ? (nVals - CountNullValuesBefore(nVals)) : nVals;
@@ -681,30 +774,14 @@ bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_mo
             /* input hints about both RLE and DICTIONARY encoding */
             strCoder.m_adopt_rle = ref_filter->m_adopt_rle;
             strCoder.m_adopt_dict = ref_filter->m_adopt_dict;
+            strCoder.m_adopt_fsst = ref_filter->m_adopt_fsst;
+            strCoder.m_fsst_only = ref_filter->m_sampling_fihished;
             compressOutSize = strCoder.Compress(input, output);
         }
     }
 
-    if (compressOutSize > 0) {
-        // compress successfully, compute CU size and set the compression info.
-        Assert((uint32)compressOutSize < m_srcDataSize);
-        Assert((0 == (output.modes & CU_INFOMASK2)) && (0 != (output.modes & CU_INFOMASK1)));
-        m_infoMode |= (output.modes & CU_INFOMASK1);
-
-        m_cuSizeExcludePadding = (outBuf - m_compressedBuf) + compressOutSize;
-        m_cuSize = ALLIGN_CUSIZE(m_cuSizeExcludePadding);
-        Assert(m_cuSize <= m_compressedBufSize);
-        PADDING_CU(m_compressedBuf + m_cuSizeExcludePadding, m_cuSize - m_cuSizeExcludePadding);
-
-        if (!ref_filter->m_sampling_fihished) {
-            /* sample and set adopted compression methods */
-            ref_filter->set_common_flags(output.modes);
-        }
-
-        return true;
-    }
-
-    return false;
+    *modes = output.modes;
+    return (compressOutSize > 0) ? compressOutSize : 0;
 }
 
 void CU::UnCompress(_in_ int rowCount, _in_ uint32 magic)
@@ -130,6 +130,17 @@ typedef struct ProcArrayStruct {
     TransactionId replication_slot_xmin;
     /* oldest catalog xmin of any replication slot */
     TransactionId replication_slot_catalog_xmin;
+
+    /*
+     * Snapshot point of a standby, published by replay once a transaction
+     * completion is redone, see ProcArrayPublishStandbySnapshot(). The version
+     * is odd while the point is being written, and 0 until it is published.
+     */
+    volatile uint64 standbySnapVersion;
+    TransactionId standbySnapXmax;
+    TransactionId standbySnapGlobalXmin;
+    CommitSeqNo standbySnapCsn;
+
     /*
      * We declare pgprocnos[] as 1 entry because C wants a fixed-size array,
      * but actually it is maxProcs entries long.
@@ -247,6 +258,8 @@ void CreateSharedProcArray(void)
         g_instance.proc_array_idx->numProcs = 0;
         g_instance.proc_array_idx->maxProcs = PROCARRAY_MAXPROCS;
         g_instance.proc_array_idx->replication_slot_xmin = InvalidTransactionId;
+        pg_atomic_init_u64(&g_instance.proc_array_idx->standbySnapVersion, 0);
+        g_instance.proc_array_idx->standbySnapXmax = InvalidTransactionId;
     }
 
     g_instance.proc_base_all_procs = g_instance.proc_base->allProcs;
@@ -1546,6 +1559,72 @@ int GetMaxSnapshotSubxidCount(void)
     return TOTAL_MAX_CACHED_SUBXIDS;
 }
 
+/*
+ * ProcArrayPublishStandbySnapshot -- publish the snapshot point of a standby
+ *
+ * Called by replay once it has advanced latestCompletedXid, nextCommitSeqNo or
+ * recentGlobalXmin, after the clog and csnlog of the transactions are set.
+ * Backends of a hot standby then build their snapshots from this point instead
+ * of taking ProcArrayLock, see GetStandbySnapshotPoint(). The version works as
+ * a sequence lock, which also keeps the redo threads of parallel recovery from
+ * publishing at the same time.
+ */
+void ProcArrayPublishStandbySnapshot(void)
+{
+    ProcArrayStruct* arrayP = g_instance.proc_array_idx;
+    uint64 version;
+
+    for (;;) {
+        version = pg_atomic_read_u64(&arrayP->standbySnapVersion);
+        if ((version & 1) == 0 &&
+            pg_atomic_compare_exchange_u64(&arrayP->standbySnapVersion, &version, version + 1))
+            break;
+        SPIN_DELAY();
+    }
+
+    arrayP->standbySnapXmax = t_thrd.xact_cxt.ShmemVariableCache->latestCompletedXid;
+    TransactionIdAdvance(arrayP->standbySnapXmax);
+    arrayP->standbySnapGlobalXmin = t_thrd.xact_cxt.ShmemVariableCache->recentGlobalXmin;
+    arrayP->standbySnapCsn = t_thrd.xact_cxt.ShmemVariableCache->nextCommitSeqNo;
+
+    pg_write_barrier();
+    pg_atomic_write_u64(&arrayP->standbySnapVersion, version + 2);
+}
+
+#ifndef ENABLE_MULTIPLE_NODES
+/*
+ * GetStandbySnapshotPoint -- read the snapshot point published by replay
+ *
+ * Returns false if nothing is published yet, if replay is publishing right now,
+ * or if replay has moved on without publishing the point yet, so that a
+ * standby snapshot never goes back from what ProcArrayLock would give. The
+ * caller then takes the lock as usual.
+ */
+static bool GetStandbySnapshotPoint(TransactionId* xmax, TransactionId* globalXmin, CommitSeqNo* csn)
+{
+    ProcArrayStruct* arrayP = g_instance.proc_array_idx;
+    uint64 version = pg_atomic_read_u64(&arrayP->standbySnapVersion);
+
+    if (version == 0 || (version & 1) != 0)
+        return false;
+
+    pg_read_barrier();
+    *xmax = arrayP->standbySnapXmax;
+    *globalXmin = arrayP->standbySnapGlobalXmin;
+    *csn = arrayP->standbySnapCsn;
+    pg_read_barrier();
+
+    if (pg_atomic_read_u64(&arrayP->standbySnapVersion) != version)
+        return false;
+
+    if (TransactionIdPrecedes(*xmax, t_thrd.xact_cxt.ShmemVariableCache->latestCompletedXid + 1) ||
+        *csn < t_thrd.xact_cxt.ShmemVariableCache->nextCommitSeqNo)
+        return false;
+
+    return true;
+}
+#endif
+
 /*
  * GetSnapshotData -- returns information about running transactions.
  *
@@ -1647,6 +1726,31 @@ Snapshot GetSnapshotData(Snapshot snapshot, bool force_local_snapshot)
 
 #endif
 
+#ifndef ENABLE_MULTIPLE_NODES
+    /*
+     * A hot standby takes the snapshot point published by replay. It is the
+     * same snapshot the code below builds during recovery, but readers don't
+     * queue up on ProcArrayLock behind each other and behind the redo threads.
+     */
+    if (!forHSFeedBack && RecoveryInProgress() &&
+        GetStandbySnapshotPoint(&xmax, &globalxmin, &snapshot->snapshotcsn)) {
+        snapshot->takenDuringRecovery = true;
+
+        xmin = xmax;
+        if (TransactionIdIsValid(globalxmin) && TransactionIdPrecedes(globalxmin, xmin))
+            xmin = globalxmin;
+        globalxmin = xmin;
+
+        if (!TransactionIdIsValid(t_thrd.pgxact->xmin))
+            t_thrd.pgxact->handle = GetCurrentTransactionHandleIfAny();
+        t_thrd.pgxact->xmin = u_sess->utils_cxt.TransactionXmin = xmin;
+
+        replication_slot_xmin = arrayP->replication_slot_xmin;
+        replication_slot_catalog_xmin = arrayP->replication_slot_catalog_xmin;
+        goto standby_snapshot_done;
+    }
+#endif
+
     /* By here no available version for local snapshot
      *
      * It is sufficient to get shared lock on ProcArrayLock, even if we are
@@ -1763,6 +1867,9 @@ Snapshot GetSnapshotData(Snapshot snapshot, bool force_local_snapshot)
 
     LWLockRelease(ProcArrayLock);
 
+#ifndef ENABLE_MULTIPLE_NODES
+standby_snapshot_done:
+#endif
     /*
      * Update globalxmin to include actual process xids.  This is a slightly
      * different way of computing it than GetOldestXmin uses, but should give
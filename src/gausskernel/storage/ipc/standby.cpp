@@ -365,7 +365,7 @@ static void ResolveRecoveryConflictWithLock(Oid dbOid, Oid relOid)
  * so we don't do a deadlock check right away ... only if we have had to wait
  * at least deadlock_timeout.  Most of the logic about that is in proc.c.
  */
-void ResolveRecoveryConflictWithBufferPin(void)
+void ResolveRecoveryConflictWithBufferPin(TimestampTz waitStart)
 {
     bool sig_alarm_enabled = false;
     TimestampTz ltime;
@@ -376,6 +376,18 @@ void ResolveRecoveryConflictWithBufferPin(void)
     ltime = GetStandbyLimitTime();
     now = GetCurrentTimestamp();
 
+    /*
+     * When replay is already behind, the limit time has passed long ago and a
+     * query just reading the page would be canceled at once. Leave it at least
+     * standby_buffer_pin_delay since we began to wait to move off the page.
+     */
+    if (ltime && u_sess->attr.attr_storage.standby_buffer_pin_delay > 0) {
+        TimestampTz deferTime =
+            TimestampTzPlusMilliseconds(waitStart, u_sess->attr.attr_storage.standby_buffer_pin_delay);
+        if (deferTime > ltime)
+            ltime = deferTime;
+    }
+
     if (!ltime) {
         /*
          * We're willing to wait forever for conflicts, so set timeout for
@@ -756,11 +768,13 @@ void standby_redo(XLogReaderState* record)
             running.latestCompletedXid = xlrec->latestCompletedXid;
         }
         ProcArrayApplyRecoveryInfo(&running);
+        ProcArrayPublishStandbySnapshot();
     } else if (info == XLOG_STANDBY_CSN) {
         TransactionId new_global_xmin = *((TransactionId*)XLogRecGetData(record));
         if (TransactionIdPrecedes(t_thrd.xact_cxt.ShmemVariableCache->recentGlobalXmin, new_global_xmin)) {
             t_thrd.xact_cxt.ShmemVariableCache->recentGlobalXmin = new_global_xmin;
         }
+        ProcArrayPublishStandbySnapshot();
     } else if (info == XLOG_STANDBY_UNLOCK) {
         xl_standby_locks* xlrec = (xl_standby_locks*)XLogRecGetData(record);
         int i;
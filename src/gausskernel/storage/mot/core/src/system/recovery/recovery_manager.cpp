@@ -38,6 +38,7 @@ DECLARE_LOGGER(RecoveryManager, Recovery);
 
 constexpr uint32_t NUM_DELETE_THRESHOLD = 5000;
 constexpr uint32_t NUM_DELETE_MAX_INC = 500;
+constexpr size_t MAX_REDO_BATCH_SIZE = 64 * MEGA_BYTE;
 
 bool RecoveryManager::Initialize()
 {
@@ -527,6 +528,8 @@ bool RecoveryManager::RecoverDbStart()
 
 bool RecoveryManager::RecoverDbEnd()
 {
+    StopRedoWorkers();
+
     if (ApplyInProcessTransactions() != RC_OK) {
         MOT_LOG_ERROR("applyInProcessTransactions failed!");
         return false;
@@ -708,13 +711,23 @@ bool RecoveryManager::OperateOnRecoveredTransaction(
             uint64_t csn = segment->m_controlBlock.m_csn;
             for (uint32_t i = 0; i < segments->GetCount(); i++) {
                 segment = segments->GetSegment(i);
-                status = RedoSegment(segment, csn, internalTransactionId, rState);
+                if (m_redoQueues != nullptr) {
+                    status = DispatchRedoSegment(segment, csn, internalTransactionId);
+                } else {
+                    status = RedoSegment(segment, csn, internalTransactionId, rState);
+                }
                 if (status != RC_OK) {
                     OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
                         "RecoveryManager::commitRecoveredTransaction: wal recovery failed");
                     return false;
                 }
             }
+            if (m_redoQueues != nullptr) {
+                // the redo workers may still use the segments until they are waited for
+                m_redoBatch.push_back(segments);
+                m_redoBatchSize += segments->GetSize();
+                return (m_redoBatchSize < MAX_REDO_BATCH_SIZE || WaitRedoWorkers());
+            }
         }
         delete segments;
     }
@@ -773,6 +786,203 @@ RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t tran
     return status;
 }
 
+RC RecoveryManager::DispatchRedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId)
+{
+    RC status = RC_OK;
+    uint8_t* endPosition = (uint8_t*)(segment->m_data + segment->m_len);
+    uint8_t* operationData = (uint8_t*)(segment->m_data);
+
+    if (IsRecoveryMemoryLimitReached(m_numRedoWorkers)) {
+        MOT_LOG_ERROR("Memory hard limit reached. Cannot recover datanode");
+        return RC_ERROR;
+    }
+
+    while (operationData < endPosition) {
+        uint64_t hashValue = 0;
+        uint32_t length = 0;
+
+        // a worker replays all the operations of a key (or table) in commit order
+        if (GetRowOperationHash(operationData, hashValue, length)) {
+            RedoWorkerQueue& queue = m_redoQueues[hashValue % m_numRedoWorkers];
+            {
+                std::lock_guard<std::mutex> lock(queue.m_lock);
+                queue.m_tasks.push_back({operationData, csn, transactionId});
+            }
+            queue.m_cond.notify_all();
+            operationData += length;
+            continue;
+        }
+
+        // anything else but the end of the transaction waits for the operations before it
+        OperationCode opCode = *static_cast<OperationCode*>((void*)operationData);
+        if (!IsCommitOp(opCode) && opCode != PARTIAL_REDO_TX && opCode != PREPARE_TX && !WaitRedoWorkers()) {
+            status = RC_ERROR;
+            break;
+        }
+        length = RecoverLogOperation(operationData, csn, transactionId, MOTCurrThreadId, m_sState, status);
+        if (status == RC_OK && length == 0) {
+            MOT_LOG_ERROR("RecoveryManager::dispatchRedoSegment: unsupported operation %u", (unsigned)opCode);
+            status = RC_ERROR;
+        }
+        if (status != RC_OK) {
+            break;
+        }
+        operationData += length;
+    }
+
+    if (status == RC_OK) {
+        SetCsnIfGreater(csn);
+    } else {
+        MOT_LOG_ERROR("RecoveryManager::dispatchRedoSegment: got error %d on tid %lu", status, transactionId);
+    }
+    return status;
+}
+
+bool RecoveryManager::StartRedoWorkers()
+{
+    uint32_t numWorkers = GetGlobalConfiguration().m_redoRecoveryWorkers;
+    if (numWorkers <= 1 || m_redoQueues != nullptr) {
+        return true;
+    }
+
+    m_redoQueues = new (std::nothrow) RedoWorkerQueue[numWorkers];
+    if (m_redoQueues == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Recovery Manager Redo", "Failed to allocate redo worker queues");
+        return false;
+    }
+
+    m_numRedoWorkers = numWorkers;
+    m_redoWorkerStop = false;
+    for (uint32_t i = 0; i < m_numRedoWorkers; ++i) {
+        m_redoWorkers.push_back(std::thread(&RecoveryManager::RedoWorkerFunc, this, i));
+    }
+    MOT_LOG_INFO("RecoveryManager:: replaying redo with %u workers", m_numRedoWorkers);
+    return true;
+}
+
+bool RecoveryManager::WaitRedoWorkers()
+{
+    if (m_redoQueues == nullptr) {
+        return !m_errorSet;
+    }
+
+    for (uint32_t i = 0; i < m_numRedoWorkers; ++i) {
+        RedoWorkerQueue& queue = m_redoQueues[i];
+        std::unique_lock<std::mutex> lock(queue.m_lock);
+        queue.m_cond.wait(lock, [&queue] { return queue.m_tasks.empty() && !queue.m_busy; });
+    }
+
+    for (RedoTransactionSegments* segments : m_redoBatch) {
+        delete segments;
+    }
+    m_redoBatch.clear();
+    m_redoBatchSize = 0;
+    ClearTableCache();
+    return !m_errorSet;
+}
+
+void RecoveryManager::StopRedoWorkers()
+{
+    if (m_redoQueues == nullptr) {
+        return;
+    }
+
+    (void)WaitRedoWorkers();
+    for (uint32_t i = 0; i < m_numRedoWorkers; ++i) {
+        std::lock_guard<std::mutex> lock(m_redoQueues[i].m_lock);
+        m_redoWorkerStop = true;
+        m_redoQueues[i].m_cond.notify_all();
+    }
+    for (auto& worker : m_redoWorkers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    m_redoWorkers.clear();
+    delete[] m_redoQueues;
+    m_redoQueues = nullptr;
+    m_numRedoWorkers = 0;
+}
+
+void RecoveryManager::RedoWorkerFunc(uint32_t workerId)
+{
+    // since this is a non-kernel thread we must set-up our own u_sess struct for the current thread
+    MOT_DECLARE_NON_KERNEL_THREAD();
+
+    MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
+    SessionContext* sessionContext = GetSessionManager()->CreateSessionContext();
+    RedoWorkerQueue& queue = m_redoQueues[workerId];
+    uint64_t maxCsn = 0;
+    uint32_t numRedoOps = 0;
+
+    // in a thread-pooled envelope the affinity could be disabled, so we use task affinity here
+    if (!GetTaskAffinity().SetAffinity(MOTCurrThreadId)) {
+        MOT_LOG_WARN("Failed to set affinity of redo recovery worker, redo recovery performance may be affected");
+    }
+
+    SurrogateState sState;
+    if (sState.IsValid() == false) {
+        OnError(MOT::RecoveryManager::ErrCodes::SURROGATE,
+            "RecoveryManager::redoWorkerFunc failed to allocate surrogate state");
+    }
+
+    GcManager* gc = MOT_GET_CURRENT_SESSION_CONTEXT()->GetTxnManager()->GetGcSession();
+    while (true) {
+        RedoTask task;
+        {
+            std::unique_lock<std::mutex> lock(queue.m_lock);
+            queue.m_busy = false;
+            if (queue.m_tasks.empty()) {
+                // wake up WaitRedoWorkers()
+                queue.m_cond.notify_all();
+            }
+            queue.m_cond.wait(lock, [this, &queue] { return !queue.m_tasks.empty() || m_redoWorkerStop; });
+            if (queue.m_tasks.empty()) {
+                break;
+            }
+            task = queue.m_tasks.front();
+            queue.m_tasks.pop_front();
+            queue.m_busy = true;
+        }
+
+        // after an error the queue is only drained, the recovery fails anyway
+        if (m_errorSet) {
+            continue;
+        }
+
+        RC status = RC_OK;
+        if (numRedoOps == 0 && gc != nullptr) {
+            gc->GcStartTxn();
+        }
+        (void)RecoverLogOperation(task.m_data, task.m_csn, task.m_transactionId, MOTCurrThreadId, sState, status);
+        if (++numRedoOps > NUM_DELETE_THRESHOLD) {
+            if (gc != nullptr) {
+                gc->GcEndTxn();
+            }
+            numRedoOps = 0;
+        }
+        if (status != RC_OK) {
+            MOT_LOG_ERROR("RecoveryManager::redoWorkerFunc: got error %d on tid %lu", status, task.m_transactionId);
+            OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY, "RecoveryManager::redoWorkerFunc: wal recovery failed");
+        }
+        if (task.m_csn > maxCsn) {
+            maxCsn = task.m_csn;
+        }
+    }
+
+    if (numRedoOps != 0 && gc != nullptr) {
+        gc->GcEndTxn();
+    }
+    SetCsnIfGreater(maxCsn);
+    if (sState.IsEmpty() == false) {
+        AddSurrogateArrayToList(sState);
+    }
+
+    GetSessionManager()->DestroySessionContext(sessionContext);
+    engine->OnCurrentThreadEnding();
+}
+
 bool RecoveryManager::LogStats::FindIdx(uint64_t tableId, uint64_t& id)
 {
     id = m_numEntries;
@@ -1332,6 +1542,7 @@ bool RecoveryManager::IsRecoveryMemoryLimitReached(uint32_t numThreads)
 
 void RecoveryManager::ClearTableCache()
 {
+    std::lock_guard<std::mutex> lock(m_tableDeletesStatLock);
     auto it = m_tableDeletesStat.begin();
     while (it != m_tableDeletesStat.end()) {
         auto table = *it;
@@ -27,6 +27,9 @@
 
 #include <set>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <condition_variable>
 #include "checkpoint_ctrlfile.h"
 #include "redo_log_global.h"
 #include "transaction_buffer_iterator.h"
@@ -167,6 +170,32 @@ private:
         uint32_t m_maxSegments;
     };
 
+    /**
+     * @struct RedoTask
+     * @brief A row operation of a committed transaction, replayed by a redo worker.
+     */
+    struct RedoTask {
+        uint8_t* m_data;
+
+        uint64_t m_csn;
+
+        uint64_t m_transactionId;
+    };
+
+    /**
+     * @struct RedoWorkerQueue
+     * @brief The row operations waiting for a redo worker, in commit order.
+     */
+    struct RedoWorkerQueue {
+        std::mutex m_lock;
+
+        std::condition_variable m_cond;
+
+        std::deque<RedoTask> m_tasks;
+
+        bool m_busy = false;
+    };
+
 public:
     RecoveryManager()
         : m_logStats(nullptr),
@@ -183,7 +212,11 @@ public:
           m_clogCallback(nullptr),
           m_threadId(AllocThreadId()),
           m_maxConnections(GetGlobalConfiguration().m_maxConnections),
-          m_numRedoOps(0)
+          m_numRedoOps(0),
+          m_numRedoWorkers(0),
+          m_redoQueues(nullptr),
+          m_redoWorkerStop(false),
+          m_redoBatchSize(0)
     {}
 
     ~RecoveryManager()
@@ -482,6 +515,22 @@ public:
      */
     bool RecoverDbEnd();
 
+    /**
+     * @brief Starts the redo recovery workers, which replay the row operations of
+     * the committed transactions in parallel, partitioned by table and key. A
+     * transaction is visible before all its operations are replayed, so this must
+     * only be used in crash recovery.
+     * @return Boolean value denoting success or failure.
+     */
+    bool StartRedoWorkers();
+
+    /**
+     * @brief Waits for the redo recovery workers to replay all the transactions
+     * committed so far. Must not be called while transactions are committed.
+     * @return Boolean value denoting success or failure.
+     */
+    bool WaitRedoWorkers();
+
     /**
      * @brief attempts to insert a data chunk into the in-process
      * transactions map and operate on it
@@ -604,6 +653,7 @@ public:
 
     inline void IncreaseTableDeletesStat(Table* t)
     {
+        std::lock_guard<std::mutex> lock(m_tableDeletesStatLock);
         m_tableDeletesStat[t]++;
     }
 
@@ -629,6 +679,39 @@ private:
      */
     RC RedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState);
 
+    /**
+     * @brief hands the row operations of a segment of a committed transaction
+     * to the redo workers, and replays the other operations once the workers
+     * are done with the operations before them.
+     * @param segment the segment to redo.
+     * @param csn the segment's csn
+     * @param transactionId the transaction id of the segment
+     * @return RC value denoting the operation's status
+     */
+    RC DispatchRedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId);
+
+    /**
+     * @brief Implements a redo recovery worker
+     * @param workerId the index of the worker's queue.
+     */
+    void RedoWorkerFunc(uint32_t workerId);
+
+    /**
+     * @brief Waits for the redo recovery workers to finish and stops them.
+     */
+    void StopRedoWorkers();
+
+    /**
+     * @brief parses a row operation without replaying it.
+     * @param data the buffer of the operation.
+     * @param hashValue the returned hash of the table, and of the key if the table
+     * has no secondary unique index.
+     * @param length the returned length of the operation.
+     * @return Boolean value that is false if this isn't a row operation of an
+     * existing table.
+     */
+    bool GetRowOperationHash(uint8_t* data, uint64_t& hashValue, uint32_t& length);
+
     /**
      * @brief inserts a segment in to the in-process transactions map
      * @param segment the segment to redo.
@@ -1061,6 +1144,21 @@ private:
     uint16_t m_maxConnections;
 
     uint32_t m_numRedoOps;
+
+    std::mutex m_tableDeletesStatLock;
+
+    uint32_t m_numRedoWorkers;
+
+    RedoWorkerQueue* m_redoQueues;
+
+    std::vector<std::thread> m_redoWorkers;
+
+    bool m_redoWorkerStop;
+
+    /** @var the transactions replayed by the redo workers since they were last waited for */
+    std::list<RedoTransactionSegments*> m_redoBatch;
+
+    size_t m_redoBatchSize;
 };
 }  // namespace MOT
 
@@ -441,6 +441,77 @@ uint32_t RecoveryManager::RecoverLogOperationCommit(uint8_t* data, uint64_t csn,
     return sizeof(EndSegmentBlock);
 }
 
+static inline uint64_t HashRedoBytes(uint64_t hashValue, const uint8_t* data, uint32_t size)
+{
+    // FNV-1a
+    for (uint32_t i = 0; i < size; i++) {
+        hashValue = (hashValue ^ data[i]) * 1099511628211ULL;
+    }
+    return hashValue;
+}
+
+bool RecoveryManager::GetRowOperationHash(uint8_t* data, uint64_t& hashValue, uint32_t& length)
+{
+    uint64_t tableId, exId, rowId, rowLength;
+    uint16_t keyLength;
+    uint8_t* keyData = nullptr;
+    uint8_t* start = data;
+    Table* table = nullptr;
+    bool partitionByKey = true;
+
+    OperationCode opCode = *(OperationCode*)data;
+    if (opCode != CREATE_ROW && opCode != UPDATE_ROW && opCode != OVERWRITE_ROW && opCode != REMOVE_ROW) {
+        return false;
+    }
+    data += sizeof(OperationCode);
+
+    Extract(data, tableId);
+    Extract(data, exId);
+    if (opCode == CREATE_ROW) {
+        Extract(data, rowId);
+    }
+    Extract(data, keyLength);
+    keyData = ExtractPtr(data, keyLength);
+
+    // errors are reported when the operation is replayed
+    if (!FetchTable(tableId, table)) {
+        return false;
+    }
+
+    if (opCode == UPDATE_ROW) {
+        uint16_t numColumns = table->GetFieldCount() - 1;
+        BitmapSet updatedColumns(ExtractPtr(data, BitmapSet::GetLength(numColumns)), numColumns);
+        BitmapSet validColumns(ExtractPtr(data, BitmapSet::GetLength(numColumns)), numColumns);
+        BitmapSet::BitmapSetIterator updatedColumnsIt(updatedColumns);
+        BitmapSet::BitmapSetIterator validColumnsIt(validColumns);
+        while (!updatedColumnsIt.End()) {
+            if (updatedColumnsIt.IsSet() && validColumnsIt.IsSet()) {
+                data += table->GetField(updatedColumnsIt.GetPosition() + 1)->m_size;
+            }
+            validColumnsIt.Next();
+            updatedColumnsIt.Next();
+        }
+    } else if (opCode != REMOVE_ROW) {
+        Extract(data, rowLength);
+        data += rowLength;
+    }
+    length = (uint32_t)(data - start);
+
+    // rows of different keys could still conflict in a secondary unique index
+    for (uint16_t i = 1; i < table->GetNumIndexes(); i++) {
+        if (table->GetSecondaryIndex(i)->GetUnique()) {
+            partitionByKey = false;
+            break;
+        }
+    }
+
+    hashValue = HashRedoBytes(14695981039346656037ULL, (uint8_t*)&tableId, sizeof(tableId));
+    if (partitionByKey) {
+        hashValue = HashRedoBytes(hashValue, keyData, keyLength);
+    }
+    return true;
+}
+
 void RecoveryManager::InsertRow(uint64_t tableId, uint64_t exId, char* keyData, uint16_t keyLen, char* rowData,
     uint64_t rowLen, uint64_t csn, uint32_t tid, SurrogateState& sState, RC& status, uint64_t rowId, bool insertLocked)
 {
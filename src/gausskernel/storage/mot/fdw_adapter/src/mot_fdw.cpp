@@ -238,6 +238,11 @@ void MOTRecover()
                 errmsg("%s", MOT::GetRecoveryManager()->GetErrorString())));
     }
 
+    // a standby must see whole transactions, so only crash recovery replays in parallel
+    if (!t_thrd.xlog_cxt.ArchiveRecoveryRequested && !MOT::GetRecoveryManager()->StartRedoWorkers()) {
+        ereport(FATAL, (errmsg("MOTRecover: failed to start the redo recovery workers.")));
+    }
+
     if (!g_instance.attr.attr_common.enable_thread_pool) {
         MOT::SessionContext* ctx = MOT_GET_CURRENT_SESSION_CONTEXT();
         on_proc_exit(MOTAdaptor::DestroyTxn, PointerGetDatum(ctx));
@@ -245,6 +250,17 @@ void MOTRecover()
     }
 }
 
+void MOTRedoDone()
+{
+    EnsureSafeThreadAccess();
+    if (!MOT::GetRecoveryManager()->WaitRedoWorkers()) {
+        // we treat errors fatally.
+        ereport(FATAL,
+            (MOTXlateRecoveryErr(MOT::GetRecoveryManager()->GetErrorCode()),
+                errmsg("%s", MOT::GetRecoveryManager()->GetErrorString())));
+    }
+}
+
 void MOTRecoveryDone()
 {
     EnsureSafeThreadAccess();
@@ -20,6 +20,8 @@
 #include <time.h>
 
 #include "access/xlog_internal.h" /* for pg_start/stop_backup */
+#include "access/cbmparsexlog.h"
+#include "access/hash.h"
 #include "catalog/catalog.h"
 #include "catalog/pg_type.h"
 #include "lib/stringinfo.h"
@@ -41,11 +43,13 @@
 #include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/timestamp.h"
+#include "postmaster/postmaster.h"
 #include "postmaster/syslogger.h"
 #include "pgxc/pgxc.h"
 
 /* t_thrd.proc_cxt.DataDir */
 #include "miscadmin.h"
+#include "lz4.h"
 
 typedef struct {
     const char* label;
@@ -53,8 +57,32 @@ typedef struct {
     bool fastcheckpoint;
     bool nowait;
     bool includewal;
+    XLogRecPtr incrementalLsn; /* send only blocks changed since it, invalid for a full backup */
+    int nstreams;              /* number of streams of a parallel backup, 1 if not parallel */
+    int streamId;              /* stream of a parallel backup, 0 for the main stream */
+    bool compress;
 } basebackup_options;
 
+/*
+ * Changed blocks of a relation since the start location of an incremental
+ * backup. Files of a tablespace are sent relative to its location, so the
+ * tablespace isn't part of the key; relations of the same relfilenode in
+ * different tablespaces just share the union of their changed blocks.
+ */
+typedef struct IncrementalRelKey {
+    Oid dbNode;
+    Oid relNode;
+    int4 bucketNode;
+} IncrementalRelKey;
+
+typedef struct IncrementalRelEntry {
+    IncrementalRelKey key;
+    bool sendfull; /* created or dropped since the start location, send the whole file */
+    uint32 nblocks;
+    uint32 maxblocks;
+    BlockNumber* blocks; /* sorted and unique */
+} IncrementalRelEntry;
+
 #define BUILD_PATH_LEN 2560 /* (MAXPGPATH*2 + 512) */
 const int FILE_NAME_MAX_LEN = 1024;
 const int MATCH_ONE = 1;
@@ -63,6 +91,11 @@ const int MATCH_THREE = 3;
 const int MATCH_FOUR = 4;
 const int MATCH_FIVE = 5;
 const int MATCH_SIX = 6;
+const int MAX_RETRY_LIMIT = 60;
+/* how long to wait for the CBM writer to track xlog up to the backup start location, in ms */
+const int INCREMENTAL_CBM_TRACK_TIMEOUT = 600000;
+/* how often the main stream of a parallel backup checks the other streams, in us */
+const long PARALLEL_BACKUP_POLL_INTERVAL = 100000L;
 /*
  * Size of each block sent into the tar stream for larger files.
  */
@@ -74,7 +107,7 @@ static int64 sendDir(const char* path, int basepathlen, bool sizeonly, List* tab
 static int64 sendTablespace(const char* path, bool sizeonly);
 static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf, bool missing_ok);
 static void sendFileWithContent(const char* filename, const char* content);
-static void _tarWriteHeader(const char* filename, const char* linktarget, struct stat* statbuf);
+static void _tarWriteHeader(const char* filename, const char* linktarget, struct stat* statbuf, char filetype = '0');
 static void send_int8_string(StringInfoData* buf, int64 intval);
 static void SendBackupHeader(List* tablespaces);
 static void SendMotCheckpointHeader(const char* path);
@@ -82,9 +115,17 @@ static void base_backup_cleanup(int code, Datum arg);
 static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir);
 static void parse_basebackup_options(List* options, basebackup_options* opt);
 static void SendXlogRecPtrResult(XLogRecPtr ptr);
-static void send_xlog_location();
+static void send_xlog_location(bool sendheader = true);
 static void send_xlog_header(const char* linkpath);
 static void save_xlogloc(const char* xloglocation);
+static void build_incremental_block_tab(XLogRecPtr incrementalLsn, XLogRecPtr startptr);
+static bool get_incremental_rel(const char* tarfilename, IncrementalRelEntry** relentry);
+static void sendIncrementalFile(FILE* fp, const char* readfilename, const char* tarfilename, struct stat* statbuf,
+    int segNo, IncrementalRelEntry* relentry);
+static List* CollectTablespaces(DIR* tblspcdir, bool progress);
+static void perform_backup_stream(basebackup_options* opt, DIR* tblspcdir);
+static int SendBackupData(const char* data, size_t len);
+static bool parallel_backup_aborted(void);
 
 /*
  * save xlog location
@@ -145,7 +186,7 @@ static void send_xlog_header(const char* linkpath)
 /*
  *  if xlog location is a link ,send it to standby
  */
-static void send_xlog_location()
+static void send_xlog_location(bool sendheader)
 {
     char fullpath[MAXPGPATH] = {0};
     struct stat statbuf;
@@ -178,7 +219,8 @@ static void send_xlog_location()
         /* save xlog location to varible */
         save_xlogloc(linkpath);
 
-        send_xlog_header(linkpath);
+        if (sendheader)
+            send_xlog_header(linkpath);
 
 #else
 
@@ -193,16 +235,202 @@ static void send_xlog_location()
 #endif /* HAVE_READLINK */
     } else if (S_ISDIR(statbuf.st_mode)) {
         statbuf.st_mode = S_IFDIR | S_IRWXU;
-        send_xlog_header(NULL);
+        if (sendheader)
+            send_xlog_header(NULL);
+    }
+}
+
+/*
+ * Register the main stream of a parallel base backup, so that the other
+ * streams can attach to it.
+ */
+static void register_parallel_backup(int nstreams, XLogRecPtr startptr)
+{
+    volatile WalSndCtlData* walsndctl = t_thrd.walsender_cxt.WalSndCtl;
+    volatile ParallelBackupState* state = &walsndctl->parallelBackup;
+    bool busy = false;
+
+    SpinLockAcquire(&walsndctl->mutex);
+    if (state->nstreams > 0) {
+        busy = true;
+    } else {
+        state->backupId++;
+        state->nstreams = nstreams;
+        state->startptr = startptr;
+        state->attached = 1;
+        state->finished = 0;
+        state->failed = false;
+        t_thrd.basebackup_cxt.parallel_backup_id = state->backupId;
+    }
+    SpinLockRelease(&walsndctl->mutex);
+
+    if (busy)
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("another parallel base backup is already running")));
+}
+
+/*
+ * Called by the main stream when the backup is done or has failed, the
+ * other streams still sending files abort then.
+ */
+static void release_parallel_backup(void)
+{
+    volatile WalSndCtlData* walsndctl = t_thrd.walsender_cxt.WalSndCtl;
+
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0)
+        return;
+
+    SpinLockAcquire(&walsndctl->mutex);
+    if (walsndctl->parallelBackup.backupId == t_thrd.basebackup_cxt.parallel_backup_id)
+        walsndctl->parallelBackup.nstreams = 0;
+    SpinLockRelease(&walsndctl->mutex);
+    t_thrd.basebackup_cxt.parallel_backup_id = 0;
+}
+
+/*
+ * Attach a stream other than the main one to the running parallel backup,
+ * and return the start location of the backup.
+ */
+static XLogRecPtr attach_parallel_backup(int streamId, int nstreams)
+{
+    volatile WalSndCtlData* walsndctl = t_thrd.walsender_cxt.WalSndCtl;
+    volatile ParallelBackupState* state = &walsndctl->parallelBackup;
+    XLogRecPtr startptr = InvalidXLogRecPtr;
+    bool running = false;
+    bool attached = false;
+
+    SpinLockAcquire(&walsndctl->mutex);
+    if (state->nstreams == nstreams && !state->failed) {
+        running = true;
+        attached = (state->attached & (1U << (uint32)streamId)) != 0;
+        if (!attached) {
+            state->attached |= (1U << (uint32)streamId);
+            startptr = state->startptr;
+            t_thrd.basebackup_cxt.parallel_backup_id = state->backupId;
+        }
+    }
+    SpinLockRelease(&walsndctl->mutex);
+
+    if (!running)
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("no parallel base backup of %d streams is running", nstreams)));
+    if (attached)
+        ereport(ERROR,
+            (errcode(ERRCODE_DUPLICATE_OBJECT),
+                errmsg("stream %d of the parallel base backup is already attached", streamId)));
+    return startptr;
+}
+
+/*
+ * Mark the stream of this walsender as finished, or the parallel backup as
+ * failed if the stream hasn't sent all of its files.
+ */
+static void detach_parallel_backup(bool failed)
+{
+    volatile WalSndCtlData* walsndctl = t_thrd.walsender_cxt.WalSndCtl;
+    volatile ParallelBackupState* state = &walsndctl->parallelBackup;
+
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0)
+        return;
+
+    SpinLockAcquire(&walsndctl->mutex);
+    if (state->backupId == t_thrd.basebackup_cxt.parallel_backup_id) {
+        if (failed)
+            state->failed = true;
+        else
+            state->finished |= (1U << (uint32)t_thrd.basebackup_cxt.stream_id);
+    }
+    SpinLockRelease(&walsndctl->mutex);
+    t_thrd.basebackup_cxt.parallel_backup_id = 0;
+}
+
+/*
+ * Whether the parallel backup this walsender sends a stream of has been
+ * released by the main stream or another stream has failed.
+ */
+static bool parallel_backup_aborted(void)
+{
+    volatile WalSndCtlData* walsndctl = t_thrd.walsender_cxt.WalSndCtl;
+    volatile ParallelBackupState* state = &walsndctl->parallelBackup;
+    bool aborted = false;
+
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0)
+        return false;
+
+    SpinLockAcquire(&walsndctl->mutex);
+    aborted = state->backupId != t_thrd.basebackup_cxt.parallel_backup_id || state->nstreams == 0 || state->failed;
+    SpinLockRelease(&walsndctl->mutex);
+    return aborted;
+}
+
+/*
+ * The main stream of a parallel backup waits for the other streams to send
+ * their files before stopping the backup. The client connects them after
+ * receiving the tablespace header, so give up if they don't show up within
+ * wal_sender_timeout.
+ */
+static void wait_for_backup_streams(int nstreams)
+{
+    volatile WalSndCtlData* walsndctl = t_thrd.walsender_cxt.WalSndCtl;
+    volatile ParallelBackupState* state = &walsndctl->parallelBackup;
+    uint32 allstreams = (nstreams >= 32) ? PG_UINT32_MAX : ((1U << (uint32)nstreams) - 1);
+    TimestampTz waitstart = GetCurrentTimestamp();
+
+    for (;;) {
+        uint32 attached;
+        uint32 finished;
+        bool failed = false;
+
+        CHECK_FOR_INTERRUPTS();
+
+        if (!PostmasterIsAlive())
+            ereport(ERROR, (errcode_for_file_access(), errmsg("Postmaster exited, aborting active base backup")));
+        if (t_thrd.walsender_cxt.walsender_shutdown_requested || t_thrd.walsender_cxt.walsender_ready_to_stop)
+            ereport(ERROR, (errcode_for_file_access(), errmsg("shutdown requested, aborting active base backup")));
+
+        SpinLockAcquire(&walsndctl->mutex);
+        attached = state->attached;
+        finished = state->finished | 1;
+        failed = state->failed;
+        SpinLockRelease(&walsndctl->mutex);
+
+        if (failed)
+            ereport(ERROR,
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                    errmsg("a stream of the parallel base backup failed, aborting backup")));
+        if (finished == allstreams)
+            break;
+        if (attached != allstreams && u_sess->attr.attr_storage.wal_sender_timeout > 0 &&
+            TimestampDifferenceExceeds(waitstart, GetCurrentTimestamp(),
+                u_sess->attr.attr_storage.wal_sender_timeout))
+            ereport(ERROR,
+                (errcode(ERRCODE_CONNECTION_FAILURE),
+                    errmsg("streams of the parallel base backup were not connected in time, aborting backup")));
+
+        pg_usleep(PARALLEL_BACKUP_POLL_INTERVAL);
     }
 }
 
+/*
+ * Called when ERROR or FATAL happens in perform_backup_stream(), so that the
+ * main stream doesn't end the backup without the files of this stream.
+ */
+static void backup_stream_cleanup(int code, Datum arg)
+{
+    t_thrd.basebackup_cxt.incremental_block_tab = NULL;
+    detach_parallel_backup(true);
+}
+
 /*
  * Called when ERROR or FATAL happens in perform_base_backup() after
  * we have started the backup - make sure we end it!
  */
 static void base_backup_cleanup(int code, Datum arg)
 {
+    t_thrd.basebackup_cxt.incremental_block_tab = NULL;
+    release_parallel_backup();
     do_pg_abort_backup();
 }
 
@@ -215,14 +443,13 @@ static void base_backup_cleanup(int code, Datum arg)
 static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
 {
     XLogRecPtr startptr;
+    XLogRecPtr backupstartptr;
     XLogRecPtr endptr;
     XLogRecPtr minlsn;
     char* labelfile = NULL;
-    int datadirpathlen;
-
-    datadirpathlen = strlen(t_thrd.proc_cxt.DataDir);
 
     startptr = do_pg_start_backup(opt->label, opt->fastcheckpoint, &labelfile);
+    backupstartptr = startptr;
     /* Get the slot minimum LSN */
     ReplicationSlotsComputeRequiredXmin(false);
     ReplicationSlotsComputeRequiredLSN(NULL);
@@ -249,73 +476,18 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
     {
         List* tablespaces = NIL;
         ListCell* lc = NULL;
-        struct dirent* de;
-        tablespaceinfo* ti = NULL;
-
-        /* Collect information about all tablespaces */
-        while ((de = ReadDir(tblspcdir, "pg_tblspc")) != NULL) {
-            char fullpath[MAXPGPATH];
-            char linkpath[MAXPGPATH];
-            char* relpath = NULL;
-            int rllen;
-            errno_t errorno = EOK;
-            int nRet = 0;
-
-            errorno = memset_s(fullpath, MAXPGPATH, '\0', MAXPGPATH);
-            securec_check(errorno, "", "");
-
-            errorno = memset_s(linkpath, MAXPGPATH, '\0', MAXPGPATH);
-            securec_check(errorno, "", "");
-
-            /* Skip special stuff */
-            if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
-                continue;
 
-            nRet = snprintf_s(fullpath, MAXPGPATH, MAXPGPATH - 1, "pg_tblspc/%s", de->d_name);
-            securec_check_ss(nRet, "", "");
-
-#if defined(HAVE_READLINK) || defined(WIN32)
-            rllen = readlink(fullpath, linkpath, sizeof(linkpath));
-            if (rllen < 0) {
-                ereport(WARNING, (errmsg("could not read symbolic link \"%s\": %m", fullpath)));
-                continue;
-            } else if (rllen >= (int)sizeof(linkpath)) {
-                ereport(WARNING, (errmsg("symbolic link \"%s\" target is too long", fullpath)));
-                continue;
-            }
-            linkpath[rllen] = '\0';
-
-            /*
-             * Relpath holds the relative path of the tablespace directory
-             * when it's located within PGDATA, or NULL if it's located
-             * elsewhere.
-             */
-            if (rllen > datadirpathlen && strncmp(linkpath, t_thrd.proc_cxt.DataDir, datadirpathlen) == 0 &&
-                IS_DIR_SEP(linkpath[datadirpathlen]))
-                relpath = linkpath + datadirpathlen + 1;
-
-            ti = (tablespaceinfo*)palloc(sizeof(tablespaceinfo));
-            ti->oid = pstrdup(de->d_name);
-            ti->path = pstrdup(linkpath);
-            ti->relativePath = relpath ? pstrdup(relpath) : NULL;
-            ti->size = opt->progress ? sendTablespace(fullpath, true) : -1;
-            tablespaces = lappend(tablespaces, ti);
-#else
+        /*
+         * Blocks changed after the backup start location are restored from
+         * xlog anyway, so the changed-block maps up to there are enough.
+         */
+        if (!XLogRecPtrIsInvalid(opt->incrementalLsn))
+            build_incremental_block_tab(opt->incrementalLsn, backupstartptr);
 
-            /*
-             * If the platform does not have symbolic links, it should not be
-             * possible to have tablespaces - clearly somebody else created
-             * them. Warn about it and ignore.
-             */
-            ereport(WARNING,
-                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("tablespaces are not supported on this platform")));
-#endif
-        }
+        if (opt->nstreams > 1)
+            register_parallel_backup(opt->nstreams, backupstartptr);
 
-        /* Add a node for the base directory at the end */
-        ti = (tablespaceinfo*)palloc0(sizeof(tablespaceinfo));
-        ti->size = opt->progress ? sendDir(".", 1, true, tablespaces) : -1;
-        tablespaces = (List*)lappend(tablespaces, ti);
+        tablespaces = CollectTablespaces(tblspcdir, opt->progress);
 
         /* Send tablespace header */
         SendBackupHeader(tablespaces);
@@ -386,9 +558,17 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
             } else
                 pq_putemptymessage_noblock('c'); /* CopyDone */
         }
+
+        /* The backup can be stopped only after all streams have sent their files */
+        if (opt->nstreams > 1)
+            wait_for_backup_streams(opt->nstreams);
     }
     PG_END_ENSURE_ERROR_CLEANUP(base_backup_cleanup, (Datum)0);
 
+    /* the table lives in the backup memory context */
+    t_thrd.basebackup_cxt.incremental_block_tab = NULL;
+    release_parallel_backup();
+
     endptr = do_pg_stop_backup(labelfile, !opt->nowait);
 
     SendXlogRecPtrResult(endptr);
@@ -398,6 +578,128 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
     LWLockRelease(FullBuildXlogCopyStartPtrLock);
 }
 
+/*
+ * Collect information about all tablespaces, with the base directory at the
+ * end. The sizes are calculated only if 'progress' is true.
+ */
+static List* CollectTablespaces(DIR* tblspcdir, bool progress)
+{
+    List* tablespaces = NIL;
+    struct dirent* de = NULL;
+    tablespaceinfo* ti = NULL;
+    int datadirpathlen = strlen(t_thrd.proc_cxt.DataDir);
+
+    while ((de = ReadDir(tblspcdir, "pg_tblspc")) != NULL) {
+        char fullpath[MAXPGPATH];
+        char linkpath[MAXPGPATH];
+        char* relpath = NULL;
+        int rllen;
+        errno_t errorno = EOK;
+        int nRet = 0;
+
+        errorno = memset_s(fullpath, MAXPGPATH, '\0', MAXPGPATH);
+        securec_check(errorno, "", "");
+
+        errorno = memset_s(linkpath, MAXPGPATH, '\0', MAXPGPATH);
+        securec_check(errorno, "", "");
+
+        /* Skip special stuff */
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+            continue;
+
+        nRet = snprintf_s(fullpath, MAXPGPATH, MAXPGPATH - 1, "pg_tblspc/%s", de->d_name);
+        securec_check_ss(nRet, "", "");
+
+#if defined(HAVE_READLINK) || defined(WIN32)
+        rllen = readlink(fullpath, linkpath, sizeof(linkpath));
+        if (rllen < 0) {
+            ereport(WARNING, (errmsg("could not read symbolic link \"%s\": %m", fullpath)));
+            continue;
+        } else if (rllen >= (int)sizeof(linkpath)) {
+            ereport(WARNING, (errmsg("symbolic link \"%s\" target is too long", fullpath)));
+            continue;
+        }
+        linkpath[rllen] = '\0';
+
+        /*
+         * Relpath holds the relative path of the tablespace directory
+         * when it's located within PGDATA, or NULL if it's located
+         * elsewhere.
+         */
+        if (rllen > datadirpathlen && strncmp(linkpath, t_thrd.proc_cxt.DataDir, datadirpathlen) == 0 &&
+            IS_DIR_SEP(linkpath[datadirpathlen]))
+            relpath = linkpath + datadirpathlen + 1;
+
+        ti = (tablespaceinfo*)palloc(sizeof(tablespaceinfo));
+        ti->oid = pstrdup(de->d_name);
+        ti->path = pstrdup(linkpath);
+        ti->relativePath = relpath ? pstrdup(relpath) : NULL;
+        ti->size = progress ? sendTablespace(fullpath, true) : -1;
+        tablespaces = lappend(tablespaces, ti);
+#else
+
+        /*
+         * If the platform does not have symbolic links, it should not be
+         * possible to have tablespaces - clearly somebody else created
+         * them. Warn about it and ignore.
+         */
+        ereport(WARNING,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("tablespaces are not supported on this platform")));
+#endif
+    }
+
+    /* Add a node for the base directory at the end */
+    ti = (tablespaceinfo*)palloc0(sizeof(tablespaceinfo));
+    ti->size = progress ? sendDir(".", 1, true, tablespaces) : -1;
+    tablespaces = (List*)lappend(tablespaces, ti);
+    return tablespaces;
+}
+
+/*
+ * Send the share of a stream other than the main one of a parallel base
+ * backup: the regular files falling into this stream, in one tar stream per
+ * tablespace like the main stream does. The main stream runs the backup and
+ * waits for this one before stopping it.
+ */
+static void perform_backup_stream(basebackup_options* opt, DIR* tblspcdir)
+{
+    XLogRecPtr startptr = attach_parallel_backup(opt->streamId, opt->nstreams);
+
+    PG_ENSURE_ERROR_CLEANUP(backup_stream_cleanup, (Datum)0);
+    {
+        List* tablespaces = NIL;
+        ListCell* lc = NULL;
+
+        if (!XLogRecPtrIsInvalid(opt->incrementalLsn))
+            build_incremental_block_tab(opt->incrementalLsn, startptr);
+
+        tablespaces = CollectTablespaces(tblspcdir, false);
+        SendBackupHeader(tablespaces);
+
+        foreach (lc, tablespaces) {
+            tablespaceinfo* iterti = (tablespaceinfo*)lfirst(lc);
+            StringInfoData buf;
+
+            /* Send CopyOutResponse message */
+            pq_beginmessage(&buf, 'H');
+            pq_sendbyte(&buf, 0);  /* overall format */
+            pq_sendint16(&buf, 0); /* natts */
+            pq_endmessage_noblock(&buf);
+
+            if (iterti->path != NULL)
+                sendTablespace(iterti->path, false);
+            else
+                sendDir(".", 1, false, tablespaces);
+
+            pq_putemptymessage_noblock('c'); /* CopyDone */
+        }
+    }
+    PG_END_ENSURE_ERROR_CLEANUP(backup_stream_cleanup, (Datum)0);
+
+    t_thrd.basebackup_cxt.incremental_block_tab = NULL;
+    detach_parallel_backup(false);
+}
+
 /*
  * Called when ERROR or FATAL happens in PerformMotCheckpointFetch() after
  * we have started the operation - make sure we end it!
@@ -510,6 +812,10 @@ static void parse_basebackup_options(List* options, basebackup_options* opt)
     bool o_fast = false;
     bool o_nowait = false;
     bool o_wal = false;
+    bool o_incremental = false;
+    bool o_parallel = false;
+    bool o_stream = false;
+    bool o_compress = false;
     errno_t rc = 0;
 
     rc = memset_s(opt, sizeof(*opt), 0, sizeof(*opt));
@@ -542,11 +848,49 @@ static void parse_basebackup_options(List* options, basebackup_options* opt)
                 ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
             opt->includewal = true;
             o_wal = true;
+        } else if (strcmp(defel->defname, "incremental") == 0) {
+            uint32 hi = 0;
+            uint32 lo = 0;
+
+            if (o_incremental)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            if (sscanf_s(strVal(defel->arg), "%X/%X", &hi, &lo) != 2 || (hi == 0 && lo == 0))
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("invalid incremental start location \"%s\"", strVal(defel->arg))));
+            opt->incrementalLsn = (((uint64)hi) << 32) | lo;
+            o_incremental = true;
+        } else if (strcmp(defel->defname, "parallel") == 0) {
+            if (o_parallel)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            opt->nstreams = intVal(defel->arg);
+            if (opt->nstreams < 1 || opt->nstreams > MAX_PARALLEL_BACKUP_STREAMS)
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("number of parallel backup streams must be between 1 and %d",
+                            MAX_PARALLEL_BACKUP_STREAMS)));
+            o_parallel = true;
+        } else if (strcmp(defel->defname, "stream") == 0) {
+            if (o_stream)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            opt->streamId = intVal(defel->arg);
+            o_stream = true;
+        } else if (strcmp(defel->defname, "compress") == 0) {
+            if (o_compress)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            opt->compress = true;
+            o_compress = true;
         } else
             ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("option \"%s\" not recognized", defel->defname)));
     }
     if (opt->label == NULL)
         opt->label = "base backup";
+    if (!o_parallel)
+        opt->nstreams = 1;
+    if (o_stream && (opt->streamId < 1 || opt->streamId >= opt->nstreams))
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("backup stream %d is out of the range of %d parallel streams", opt->streamId, opt->nstreams)));
 }
 
 /*
@@ -565,6 +909,11 @@ void SendBaseBackup(BaseBackupCmd* cmd)
 
     parse_basebackup_options(cmd->options, &opt);
 
+    t_thrd.basebackup_cxt.stream_id = opt.streamId;
+    t_thrd.basebackup_cxt.nstreams = opt.nstreams;
+    t_thrd.basebackup_cxt.compress = opt.compress;
+    t_thrd.basebackup_cxt.parallel_backup_id = 0;
+
     backup_context = AllocSetContextCreate(CurrentMemoryContext,
         "Streaming base backup context",
         ALLOCSET_DEFAULT_MINSIZE,
@@ -591,13 +940,25 @@ void SendBaseBackup(BaseBackupCmd* cmd)
         return;
     }
 
-    /* read xlog location ,if xlog is a link ,send the link to client */
-    send_xlog_location();
-
-    perform_base_backup(&opt, dir);
+    /*
+     * read xlog location ,if xlog is a link ,send the link to client. The other
+     * streams of a parallel backup just need it to skip the xlog directory.
+     */
+    if (opt.streamId > 0) {
+        send_xlog_location(false);
+        perform_backup_stream(&opt, dir);
+    } else {
+        send_xlog_location();
+        perform_base_backup(&opt, dir);
+    }
 
     FreeDir(dir);
 
+    /* the MOT checkpoint fetch shares the tar routines, and is never split or compressed */
+    t_thrd.basebackup_cxt.stream_id = 0;
+    t_thrd.basebackup_cxt.nstreams = 1;
+    t_thrd.basebackup_cxt.compress = false;
+
     MemoryContextSwitchTo(old_context);
     MemoryContextDelete(backup_context);
 }
@@ -797,7 +1158,7 @@ static void sendFileWithContent(const char* filename, const char* content)
 
     _tarWriteHeader(filename, NULL, &statbuf);
     /* Send the contents as a CopyData message */
-    (void)pq_putmessage_noblock('d', content, len);
+    (void)SendBackupData(content, len);
 
     /* Pad to 512 byte boundary, per tar format requirements */
     pad = ((len + 511) & ~511) - len;
@@ -807,7 +1168,7 @@ static void sendFileWithContent(const char* filename, const char* content)
 
         rc = memset_s(buf, sizeof(buf), 0, pad);
         securec_check(rc, "", "");
-        (void)pq_putmessage_noblock('d', buf, pad);
+        (void)SendBackupData(buf, pad);
     }
 }
 
@@ -914,6 +1275,11 @@ static int64 sendDir(const char* path, int basepathlen, bool sizeonly, List* tab
         if (t_thrd.walsender_cxt.walsender_shutdown_requested || t_thrd.walsender_cxt.walsender_ready_to_stop)
             ereport(ERROR, (errcode_for_file_access(), errmsg("shutdown requested, aborting active base backup")));
 
+        if (parallel_backup_aborted())
+            ereport(ERROR,
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                    errmsg("parallel base backup was aborted by another stream, aborting backup")));
+
         if (t_thrd.postmaster_cxt.HaShmData &&
             (t_thrd.walsender_cxt.server_run_mode != t_thrd.postmaster_cxt.HaShmData->current_mode))
             ereport(ERROR, (errcode_for_file_access(), errmsg("server run mode changed, aborting active base backup")));
@@ -1141,6 +1507,13 @@ static int64 sendDir(const char* path, int basepathlen, bool sizeonly, List* tab
                 size += sendDir(pathbuf, basepathlen, sizeonly, tablespaces);
         } else if (S_ISREG(statbuf.st_mode)) {
             bool sent = false;
+            const char* tarfilename = pathbuf + basepathlen + 1;
+
+            /* Each regular file is sent by one of the streams of a parallel backup */
+            if (!sizeonly && t_thrd.basebackup_cxt.nstreams > 1 &&
+                BACKUP_STREAM_OF_FILE(hash_any((const unsigned char*)tarfilename, strlen(tarfilename)),
+                    t_thrd.basebackup_cxt.nstreams) != t_thrd.basebackup_cxt.stream_id)
+                continue;
 
             if (!sizeonly)
                 sent = sendFile(pathbuf, pathbuf + basepathlen + 1, &statbuf, true);
@@ -1389,6 +1762,300 @@ bool is_row_data_file(const char* path, int* segNo)
     }
     return false;
 }
+static int block_number_cmp(const void* a, const void* b)
+{
+    BlockNumber blkno1 = *(const BlockNumber*)a;
+    BlockNumber blkno2 = *(const BlockNumber*)b;
+
+    if (blkno1 < blkno2)
+        return -1;
+    if (blkno1 > blkno2)
+        return 1;
+    return 0;
+}
+
+/*
+ * Collect the blocks changed between the start location of an incremental
+ * backup and the start location of this backup from the changed-block maps.
+ *
+ * Only the main fork is sent incrementally. FSM isn't xlogged and the other
+ * forks are small, so they are always sent in full, as are relations created,
+ * dropped or truncated in between. A truncated relation may have been extended
+ * again past the truncation point, and blocks the changed-block maps don't
+ * list would be kept from the previous backup.
+ */
+static void build_incremental_block_tab(XLogRecPtr incrementalLsn, XLogRecPtr startptr)
+{
+    HASHCTL ctl;
+    HTAB* blocktab = NULL;
+    HASH_SEQ_STATUS status;
+    IncrementalRelEntry* relentry = NULL;
+    CBMArray* cbmArray = NULL;
+    long i;
+    errno_t rc = EOK;
+
+    /* At present, changed-block maps can only be merged on master */
+    if (RecoveryInProgress())
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("recovery is in progress"),
+                errhint("incremental base backup cannot be executed during recovery.")));
+
+    if (!u_sess->attr.attr_storage.enable_cbm_tracking || !IsCBMWriterRunning())
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("incremental base backup requires the CBM writer thread to be running"),
+                errhint("Turn on enable_cbm_tracking.")));
+
+    if (XLByteLE(startptr, incrementalLsn))
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("incremental start location %X/%X should be smaller than backup start location %X/%X",
+                    (uint32)(incrementalLsn >> 32),
+                    (uint32)incrementalLsn,
+                    (uint32)(startptr >> 32),
+                    (uint32)startptr)));
+
+    if (XLogRecPtrIsInvalid(ForceTrackCBMOnce(startptr, INCREMENTAL_CBM_TRACK_TIMEOUT, true, false)))
+        ereport(ERROR,
+            (errcode(ERRCODE_CONNECTION_TIMED_OUT),
+                errmsg("timeout while tracking changed blocks up to %X/%X",
+                    (uint32)(startptr >> 32),
+                    (uint32)startptr)));
+
+    (void)LWLockAcquire(CBMParseXlogLock, LW_SHARED);
+    cbmArray = CBMGetMergedArray(incrementalLsn, startptr);
+    LWLockRelease(CBMParseXlogLock);
+
+    rc = memset_s(&ctl, sizeof(ctl), 0, sizeof(ctl));
+    securec_check(rc, "", "");
+    ctl.keysize = sizeof(IncrementalRelKey);
+    ctl.entrysize = sizeof(IncrementalRelEntry);
+    ctl.hash = tag_hash;
+    ctl.hcxt = CurrentMemoryContext;
+    blocktab = hash_create("Incremental backup changed blocks",
+        Max(cbmArray->arrayLength, 256),
+        &ctl,
+        HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+    for (i = 0; i < cbmArray->arrayLength; i++) {
+        CBMArrayEntry* cbmEntry = &cbmArray->arrayEntry[i];
+        IncrementalRelKey key;
+        bool found = false;
+
+        if (cbmEntry->cbmTag.forkNum != MAIN_FORKNUM)
+            continue;
+
+        rc = memset_s(&key, sizeof(key), 0, sizeof(key));
+        securec_check(rc, "", "");
+        key.dbNode = cbmEntry->cbmTag.rNode.dbNode;
+        key.relNode = cbmEntry->cbmTag.rNode.relNode;
+        key.bucketNode = cbmEntry->cbmTag.rNode.bucketNode;
+
+        relentry = (IncrementalRelEntry*)hash_search(blocktab, &key, HASH_ENTER, &found);
+        if (!found) {
+            relentry->sendfull = false;
+            relentry->nblocks = 0;
+            relentry->maxblocks = 0;
+            relentry->blocks = NULL;
+        }
+
+        if (cbmEntry->changeType & (PAGETYPE_CREATE | PAGETYPE_DROP | PAGETYPE_TRUNCATE))
+            relentry->sendfull = true;
+        if (relentry->sendfull || cbmEntry->totalBlockNum == 0)
+            continue;
+
+        if (relentry->nblocks + cbmEntry->totalBlockNum > relentry->maxblocks) {
+            relentry->maxblocks = relentry->nblocks + cbmEntry->totalBlockNum;
+            if (relentry->blocks == NULL)
+                relentry->blocks = (BlockNumber*)palloc(relentry->maxblocks * sizeof(BlockNumber));
+            else
+                relentry->blocks =
+                    (BlockNumber*)repalloc(relentry->blocks, relentry->maxblocks * sizeof(BlockNumber));
+        }
+        rc = memcpy_s(relentry->blocks + relentry->nblocks,
+            (relentry->maxblocks - relentry->nblocks) * sizeof(BlockNumber),
+            cbmEntry->changedBlock,
+            cbmEntry->totalBlockNum * sizeof(BlockNumber));
+        securec_check(rc, "", "");
+        relentry->nblocks += cbmEntry->totalBlockNum;
+    }
+
+    FreeCBMArray(cbmArray);
+
+    /* sort the blocks of each relation and remove the duplicated ones */
+    hash_seq_init(&status, blocktab);
+    while ((relentry = (IncrementalRelEntry*)hash_seq_search(&status)) != NULL) {
+        uint32 nunique = 0;
+
+        if (relentry->nblocks == 0)
+            continue;
+
+        qsort(relentry->blocks, relentry->nblocks, sizeof(BlockNumber), block_number_cmp);
+        for (uint32 j = 1; j < relentry->nblocks; j++) {
+            if (relentry->blocks[j] != relentry->blocks[nunique])
+                relentry->blocks[++nunique] = relentry->blocks[j];
+        }
+        relentry->nblocks = nunique + 1;
+    }
+
+    ereport(LOG,
+        (errmsg("incremental base backup from %X/%X to %X/%X: %ld relations changed",
+            (uint32)(incrementalLsn >> 32),
+            (uint32)incrementalLsn,
+            (uint32)(startptr >> 32),
+            (uint32)startptr,
+            hash_get_num_entries(blocktab))));
+
+    t_thrd.basebackup_cxt.incremental_block_tab = blocktab;
+}
+
+/*
+ * Find the changed blocks of the relation data file named tarfilename in an
+ * incremental backup. Returns false if the file has to be sent in full,
+ * otherwise *relentry is set to the changed blocks, or NULL if the relation
+ * isn't changed at all.
+ */
+static bool get_incremental_rel(const char* tarfilename, IncrementalRelEntry** relentry)
+{
+    char relpath[MAXPGPATH] = {0};
+    RelFileNodeForkNum filenode;
+    IncrementalRelKey key;
+    IncrementalRelEntry* entry = NULL;
+    errno_t rc = EOK;
+
+    /* Files of tablespaces are named from the tablespace version directory, see sendTablespace() */
+    if (strncmp(tarfilename, "global/", strlen("global/")) == 0 || strncmp(tarfilename, "base/", strlen("base/")) == 0)
+        rc = snprintf_s(relpath, sizeof(relpath), sizeof(relpath) - 1, "%s", tarfilename);
+    else
+        rc = snprintf_s(relpath, sizeof(relpath), sizeof(relpath) - 1, "pg_tblspc/%u/%s", InvalidOid, tarfilename);
+    securec_check_ss(rc, "", "");
+
+    filenode = relpath_to_filenode(relpath);
+    if (filenode.rnode.node.relNode == InvalidOid || filenode.rnode.backend != InvalidBackendId ||
+        filenode.forknumber != MAIN_FORKNUM)
+        return false;
+
+    rc = memset_s(&key, sizeof(key), 0, sizeof(key));
+    securec_check(rc, "", "");
+    key.dbNode = filenode.rnode.node.dbNode;
+    key.relNode = filenode.rnode.node.relNode;
+    key.bucketNode = filenode.rnode.node.bucketNode;
+
+    entry = (IncrementalRelEntry*)hash_search(t_thrd.basebackup_cxt.incremental_block_tab, &key, HASH_FIND, NULL);
+    if (entry != NULL && entry->sendfull)
+        return false;
+
+    *relentry = entry;
+    return true;
+}
+
+/*
+ * Read the block segblkno of the segment file into page, and verify its
+ * checksum the same way as sendFile() does.
+ */
+static void readIncrementalBlock(
+    FILE* fp, const char* readfilename, BlockNumber segblkno, BlockNumber blkno, char* page)
+{
+    int retryCnt = 0;
+
+    for (;;) {
+        size_t cnt;
+        uint16 checksum;
+
+        if (fseeko(fp, (off_t)segblkno * BLCKSZ, SEEK_SET) != 0)
+            ereport(ERROR, (errcode_for_file_access(), errmsg("could not seek in file \"%s\": %m", readfilename)));
+
+        cnt = fread(page, 1, BLCKSZ, fp);
+        if (cnt != BLCKSZ) {
+            if (ferror(fp))
+                ereport(ERROR, (errcode_for_file_access(), errmsg("could not read file \"%s\": %m", readfilename)));
+
+            /* The file was truncated while we were sending it, the block will be restored from WAL. */
+            errno_t rc = memset_s(page + cnt, BLCKSZ - cnt, 0, BLCKSZ - cnt);
+            securec_check(rc, "", "");
+            return;
+        }
+
+        if (!g_instance.attr.attr_storage.enableIncrementalCheckpoint || PageIsNew((PageHeader)page))
+            return;
+
+        checksum = pg_checksum_page(page, blkno);
+        if (((PageHeader)page)->pd_checksum == checksum)
+            return;
+
+        /* the page may be being written out, read it again */
+        if (++retryCnt > MAX_RETRY_LIMIT)
+            ereport(ERROR,
+                (errcode_for_file_access(),
+                    errmsg("base backup cheksum failed in file \"%s\"(computed: %d, recorded: %d), aborting backup",
+                        readfilename,
+                        checksum,
+                        ((PageHeader)page)->pd_checksum)));
+        pg_usleep(100000);
+    }
+}
+
+/*
+ * Send the changed blocks of a relation segment file as a tar member of type
+ * INCREMENTAL_TAR_TYPE, see IncrementalFileHeader for its content.
+ */
+static void sendIncrementalFile(FILE* fp, const char* readfilename, const char* tarfilename, struct stat* statbuf,
+    int segNo, IncrementalRelEntry* relentry)
+{
+    IncrementalFileHeader header;
+    struct stat deltastat = *statbuf;
+    BlockNumber segstart = (BlockNumber)segNo * ((BlockNumber)RELSEG_SIZE);
+    BlockNumber segend = segstart + (BlockNumber)(statbuf->st_size / BLCKSZ);
+    uint32 first = 0;
+    uint32 last = 0;
+    pgoff_t len;
+    size_t pad;
+    errno_t rc = EOK;
+
+    /* the changed blocks falling into this segment */
+    if (relentry != NULL) {
+        while (first < relentry->nblocks && relentry->blocks[first] < segstart)
+            first++;
+        last = first;
+        while (last < relentry->nblocks && relentry->blocks[last] < segend)
+            last++;
+    }
+
+    header.magic = INCREMENTAL_FILE_MAGIC;
+    header.nblocks = last - first;
+    header.filesize = (uint64)statbuf->st_size;
+
+    len = (pgoff_t)(sizeof(IncrementalFileHeader) + (uint64)header.nblocks * INCREMENTAL_BLOCK_RECORD_SIZE);
+    deltastat.st_size = len;
+    _tarWriteHeader(tarfilename, NULL, &deltastat, INCREMENTAL_TAR_TYPE);
+
+    if (SendBackupData((char*)&header, sizeof(IncrementalFileHeader)))
+        ereport(ERROR, (errcode_for_file_access(), errmsg("base backup could not send data, aborting backup")));
+
+    for (uint32 i = first; i < last; i++) {
+        char* record = t_thrd.basebackup_cxt.buf_block;
+        BlockNumber segblkno = relentry->blocks[i] - segstart;
+
+        if (t_thrd.walsender_cxt.walsender_ready_to_stop)
+            ereport(ERROR, (errcode_for_file_access(), errmsg("base backup receive stop message, aborting backup")));
+
+        *(BlockNumber*)record = segblkno;
+        readIncrementalBlock(fp, readfilename, segblkno, relentry->blocks[i], record + sizeof(BlockNumber));
+
+        if (SendBackupData(record, INCREMENTAL_BLOCK_RECORD_SIZE))
+            ereport(ERROR, (errcode_for_file_access(), errmsg("base backup could not send data, aborting backup")));
+    }
+
+    /* Pad to 512 byte boundary, per tar format requirements */
+    pad = ((len + 511) & ~511) - len;
+    if (pad > 0) {
+        rc = memset_s(t_thrd.basebackup_cxt.buf_block, pad, 0, pad);
+        securec_check(rc, "", "");
+        (void)SendBackupData(t_thrd.basebackup_cxt.buf_block, pad);
+    }
+}
+
 /*
  * Given the member, write the TAR header & send the file.
  *
@@ -1409,7 +2076,6 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
     uint16 checksum = 0;
     bool isNeedCheck = false;
     int segNo = 0;
-    const int MAX_RETRY_LIMIT = 60;
     int retryCnt = 0;
 
     if (t_thrd.basebackup_cxt.buf_block == NULL) {
@@ -1454,6 +2120,17 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
         statbuf->st_size = statbuf->st_size - (statbuf->st_size % BLCKSZ);
     }
 
+    /* send only the changed blocks of data files for an incremental backup */
+    if (isNeedCheck && t_thrd.basebackup_cxt.incremental_block_tab != NULL) {
+        IncrementalRelEntry* relentry = NULL;
+
+        if (get_incremental_rel(tarfilename, &relentry)) {
+            sendIncrementalFile(fp, readfilename, tarfilename, statbuf, segNo, relentry);
+            (void)FreeFile(fp);
+            return true;
+        }
+    }
+
     /* send the pkg header containing msg like file size */
     _tarWriteHeader(tarfilename, NULL, statbuf);
 
@@ -1509,7 +2186,7 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
         }
 
         /* Send the chunk as a CopyData message */
-        if (pq_putmessage_noblock('d', t_thrd.basebackup_cxt.buf_block, cnt))
+        if (SendBackupData(t_thrd.basebackup_cxt.buf_block, cnt))
             ereport(ERROR, (errcode_for_file_access(), errmsg("base backup could not send data, aborting backup")));
 
         len += cnt;
@@ -1530,7 +2207,7 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
         securec_check(rc, "", "");
         while (len < statbuf->st_size) {
             cnt = Min(TAR_SEND_SIZE, statbuf->st_size - len);
-            (void)pq_putmessage_noblock('d', t_thrd.basebackup_cxt.buf_block, cnt);
+            (void)SendBackupData(t_thrd.basebackup_cxt.buf_block, cnt);
             len += cnt;
         }
     }
@@ -1540,18 +2217,23 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
     if (pad > 0) {
         rc = memset_s(t_thrd.basebackup_cxt.buf_block, pad, 0, pad);
         securec_check(rc, "", "");
-        (void)pq_putmessage_noblock('d', t_thrd.basebackup_cxt.buf_block, pad);
+        (void)SendBackupData(t_thrd.basebackup_cxt.buf_block, pad);
     }
 
     (void)FreeFile(fp);
     return true;
 }
 
-static void _tarWriteHeader(const char* filename, const char* linktarget, struct stat* statbuf)
+static void _tarWriteHeader(const char* filename, const char* linktarget, struct stat* statbuf, char filetype)
 {
     char h[BUILD_PATH_LEN];
     errno_t rc = EOK;
     int nRet = 0;
+
+    /* Directories and links are sent by the main stream of a parallel backup only */
+    if (t_thrd.basebackup_cxt.stream_id > 0 && (linktarget != NULL || S_ISDIR(statbuf->st_mode)))
+        return;
+
     /*
      * Note: most of the fields in a tar header are not supposed to be
      * null-terminated.  We use sprintf, which will write a null after the
@@ -1608,14 +2290,59 @@ static void _tarWriteHeader(const char* filename, const char* linktarget, struct
         nRet = sprintf_s(&h[1080], BUILD_PATH_LEN - 1080, "5");
         securec_check_ss(nRet, "", "");
     } else {
-        /* Type - regular file */
-        nRet = sprintf_s(&h[1080], BUILD_PATH_LEN - 1080, "0");
+        /* Type - regular file, or the changed blocks of an incremental backup */
+        nRet = sprintf_s(&h[1080], BUILD_PATH_LEN - 1080, "%c", filetype);
         securec_check_ss(nRet, "", "");
     }
 
     /* Link tag 100 (NULL) */
     /* Now send the completed header. */
-    (void)pq_putmessage_noblock('d', h, BUILD_PATH_LEN);
+    (void)SendBackupData(h, BUILD_PATH_LEN);
+}
+
+/*
+ * Send data of the tar stream as a CopyData message, compressed if the client
+ * asked so. Returns what pq_putmessage_noblock() returns.
+ */
+static int SendBackupData(const char* data, size_t len)
+{
+    BackupCompressHeader* header = NULL;
+    int bound;
+    int compsize;
+    errno_t rc = EOK;
+
+    if (!t_thrd.basebackup_cxt.compress)
+        return pq_putmessage_noblock('d', data, len);
+
+    bound = LZ4_compressBound((int)len);
+    if (t_thrd.basebackup_cxt.compress_buf_size < (int)sizeof(BackupCompressHeader) + bound) {
+        MemoryContext oldcxt = MemoryContextSwitchTo(t_thrd.top_mem_cxt);
+        int size = (int)sizeof(BackupCompressHeader) + Max(bound, LZ4_compressBound(TAR_SEND_SIZE));
+
+        if (t_thrd.basebackup_cxt.compress_buf != NULL)
+            pfree(t_thrd.basebackup_cxt.compress_buf);
+        t_thrd.basebackup_cxt.compress_buf = (char*)palloc(size);
+        t_thrd.basebackup_cxt.compress_buf_size = size;
+        MemoryContextSwitchTo(oldcxt);
+    }
+
+    header = (BackupCompressHeader*)t_thrd.basebackup_cxt.compress_buf;
+    compsize = LZ4_compress_default(
+        data, t_thrd.basebackup_cxt.compress_buf + sizeof(BackupCompressHeader), (int)len, bound);
+    header->rawsize = (uint32)len;
+    if (compsize <= 0 || (size_t)compsize >= len) {
+        /* incompressible, send it as is */
+        header->compsize = 0;
+        if (len > 0) {
+            rc = memcpy_s(t_thrd.basebackup_cxt.compress_buf + sizeof(BackupCompressHeader), bound, data, len);
+            securec_check(rc, "", "");
+        }
+        compsize = (int)len;
+    } else {
+        header->compsize = (uint32)compsize;
+    }
+
+    return pq_putmessage_noblock('d', t_thrd.basebackup_cxt.compress_buf, sizeof(BackupCompressHeader) + compsize);
 }
 
 void ut_save_xlogloc(const char* xloglocation)
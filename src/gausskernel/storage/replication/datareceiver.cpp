@@ -69,6 +69,7 @@
 #include "replication/dataqueue.h"
 #include "replication/datareceiver.h"
 #include "replication/datasender.h"
+#include "replication/streamcompress.h"
 #include "replication/walreceiver.h"
 #include "storage/ipc.h"
 #include "storage/latch.h"
@@ -1015,6 +1016,7 @@ static void DataRcvProcessMsg(unsigned char type, char* buf, Size len)
         }
         // lint -fallthrough
         case 'd': /* Data page */
+        case 'z': /* compressed data page */
         {
             DataPageMessageHeader msghdr;
 
@@ -1030,6 +1032,15 @@ static void DataRcvProcessMsg(unsigned char type, char* buf, Size len)
             buf += sizeof(DataPageMessageHeader);
             len -= sizeof(DataPageMessageHeader);
 
+            /* see replication_compression */
+            if (type == 'z') {
+                len = StreamDecompress(buf,
+                    len,
+                    &t_thrd.datareceiver_cxt.decompress_buf,
+                    &t_thrd.datareceiver_cxt.decompress_buf_size);
+                buf = t_thrd.datareceiver_cxt.decompress_buf;
+            }
+
             volatile DataRcvData* datarcv = t_thrd.datareceiver_cxt.DataRcv;
 
             if (datarcv->conn_target != REPCONNTARGET_DUMMYSTANDBY) {
@@ -1425,6 +1436,7 @@ void DataRcvSendReply(bool force, bool requestReply)
 static void DataRcvStreamConnect(char* conninfo)
 {
     char conninfo_repl[MAXCONNINFO + 75] = {0};
+    char cmd[64];
 
     char* primary_sysid = NULL;
     char standby_sysid[32];
@@ -1568,9 +1580,19 @@ static void DataRcvStreamConnect(char* conninfo)
         t_thrd.xlog_cxt.ThisTimeLineID = primary_tli;
     }
     /*
-     * Start data replication.
+     * Start data replication, the data pages are decompressed in DataRcvProcessMsg.
      */
-    res = PQexec(t_thrd.datareceiver_cxt.dataStreamingConn, "START_REPLICATION DATA");
+    if (u_sess->attr.attr_storage.replication_compression != STREAM_COMPRESS_NONE)
+        rc = snprintf_s(cmd,
+            sizeof(cmd),
+            sizeof(cmd) - 1,
+            "START_REPLICATION DATA COMPRESS %s",
+            StreamCompressName(u_sess->attr.attr_storage.replication_compression));
+    else
+        rc = snprintf_s(cmd, sizeof(cmd), sizeof(cmd) - 1, "START_REPLICATION DATA");
+    securec_check_ss(rc, "", "");
+
+    res = PQexec(t_thrd.datareceiver_cxt.dataStreamingConn, cmd);
     if (PQresultStatus(res) != PGRES_COPY_BOTH) {
         PQclear(res);
         ereport(ERROR,
@@ -68,6 +68,7 @@
 #include "replication/datasender_private.h"
 #include "replication/datasyncrep.h"
 #include "replication/catchup.h"
+#include "replication/streamcompress.h"
 #include "replication/walsender.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
@@ -384,6 +385,10 @@ static void StartDataReplication(StartDataReplicationCmd* cmd)
 {
     StringInfoData buf;
 
+    /* Compress the data pages if the standby asks for it, see DataSend */
+    if (cmd->compression != NULL)
+        t_thrd.datasender_cxt.compression = StreamCompressLookup(cmd->compression);
+
     /*
      * When we first start replication the standby will be behind the primary.
      * For some applications, for example, synchronous replication, it is
@@ -731,6 +736,9 @@ static int DataSndLoop(void)
      */
     t_thrd.datasender_cxt.output_message =
         (char*)palloc(1 + sizeof(DataPageMessageHeader) + g_instance.attr.attr_storage.MaxSendSize * 1024);
+    if (t_thrd.datasender_cxt.compression != STREAM_COMPRESS_NONE)
+        t_thrd.datasender_cxt.compress_message = (char*)palloc(
+            1 + sizeof(DataPageMessageHeader) + StreamCompressBound(g_instance.attr.attr_storage.MaxSendSize * 1024));
 
     /*
      * Allocate buffer that will be used for processing reply messages.  As
@@ -1172,6 +1180,7 @@ static void DataSend(bool* caughtup)
     DataQueuePtr startptr;
     DataQueuePtr endptr;
     uint32 sendsize;
+    Size compsize = 0;
     errno_t rc = 0;
 
     /* Need interface to check if we need to send some data this time  */
@@ -1229,7 +1238,25 @@ static void DataSend(bool* caughtup)
         sizeof(DataPageMessageHeader));
     securec_check(rc, "", "");
 
-    pq_putmessage_noblock('d', t_thrd.datasender_cxt.output_message, 1 + sizeof(DataPageMessageHeader) + sendsize);
+    /* send the pages as a 'z' message instead if they get smaller compressed */
+    if (t_thrd.datasender_cxt.compression != STREAM_COMPRESS_NONE)
+        compsize = StreamCompress((StreamCompressType)t_thrd.datasender_cxt.compression,
+            datasndbuf,
+            sendsize,
+            t_thrd.datasender_cxt.compress_message + 1 + sizeof(DataPageMessageHeader));
+
+    if (compsize > 0) {
+        t_thrd.datasender_cxt.compress_message[0] = 'z';
+        rc = memcpy_s(t_thrd.datasender_cxt.compress_message + 1,
+            sizeof(DataPageMessageHeader),
+            &msghdr,
+            sizeof(DataPageMessageHeader));
+        securec_check(rc, "", "");
+        pq_putmessage_noblock(
+            'd', t_thrd.datasender_cxt.compress_message, 1 + sizeof(DataPageMessageHeader) + compsize);
+    } else
+        pq_putmessage_noblock(
+            'd', t_thrd.datasender_cxt.output_message, 1 + sizeof(DataPageMessageHeader) + sendsize);
 
     SpinLockAcquire(&datasnd->mutex);
     datasnd->sendPosition.queueid = endptr.queueid;
@@ -26,6 +26,7 @@
 #include "miscadmin.h"
 #include "replication/walreceiver.h"
 #include "replication/libpqwalreceiver.h"
+#include "replication/streamcompress.h"
 #include "storage/pmsignal.h"
 #include "storage/proc.h"
 #include "utils/guc.h"
@@ -820,6 +821,14 @@ retry:
             (uint32)(*startpoint));
     securec_check_ss(nRet, "", "");
 
+    /* ask the sender to compress the WAL, it's decompressed in XLogWalRcvProcessMsg */
+    if (u_sess->attr.attr_storage.replication_compression != STREAM_COMPRESS_NONE) {
+        nRet = strcat_s(cmd, sizeof(cmd), " COMPRESS ");
+        securec_check(nRet, "", "");
+        nRet = strcat_s(cmd, sizeof(cmd), StreamCompressName(u_sess->attr.attr_storage.replication_compression));
+        securec_check(nRet, "", "");
+    }
+
     res = libpqrcv_PQexec(cmd);
     if (PQresultStatus(res) != PGRES_COPY_BOTH) {
         PQclear(res);
@@ -97,12 +97,21 @@ Pointer GetXlrec(XLogReaderState* record)
 void LogicalDecodingProcessRecord(LogicalDecodingContext* ctx, XLogReaderState* record)
 {
     XLogRecordBuffer buf = {0, 0, NULL, NULL};
+    TransactionId txid;
 
     buf.origptr = ctx->reader->ReadRecPtr;
     buf.endptr = ctx->reader->EndRecPtr;
     buf.record = record;
     buf.record_data = GetXlrec(record);
 
+    /*
+     * The first record of a subtransaction carries its toplevel xid, assign
+     * the subtransaction before any of its changes are queued.
+     */
+    txid = XLogRecGetTopXid(record);
+    if (TransactionIdIsValid(txid))
+        ReorderBufferAssignChild(ctx->reorder, txid, XLogRecGetXid(record), buf.origptr);
+
     /* cast so we get a warning when new rmgrs are added */
     switch ((RmgrIds)XLogRecGetRmid(record)) {
         /*
@@ -39,6 +39,8 @@
 #include "access/transam.h"
 #include "access/xlog_internal.h"
 
+#include "nodes/parsenodes.h"
+
 #include "replication/decode.h"
 #include "replication/logical.h"
 #include "replication/reorderbuffer.h"
@@ -47,6 +49,7 @@
 #include "storage/proc.h"
 #include "storage/procarray.h"
 
+#include "utils/builtins.h"
 #include "utils/memutils.h"
 /* data for errcontext callback */
 typedef struct LogicalErrorCallbackState {
@@ -63,7 +66,12 @@ static void begin_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
 static void commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 static void change_cb_wrapper(
     ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+static void stream_start_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
+static void stream_stop_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
+static void stream_abort_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void stream_commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 static void LoadOutputPlugin(OutputPluginCallbacks* callbacks, const char* plugin);
+static List* ParseParallelDecodeOptions(ReorderBuffer* rb, List* options);
 
 /*
  * Make sure the current settings & environment are capable of doing logical
@@ -155,12 +163,16 @@ static LogicalDecodingContext* StartupDecodingContext(List* output_plugin_option
     ctx->reorder->begin = begin_cb_wrapper;
     ctx->reorder->apply_change = change_cb_wrapper;
     ctx->reorder->commit = commit_cb_wrapper;
+    ctx->reorder->stream_start = stream_start_cb_wrapper;
+    ctx->reorder->stream_stop = stream_stop_cb_wrapper;
+    ctx->reorder->stream_abort = stream_abort_cb_wrapper;
+    ctx->reorder->stream_commit = stream_commit_cb_wrapper;
 
     ctx->out = makeStringInfo();
     ctx->prepare_write = prepare_write;
     ctx->write = do_write;
 
-    ctx->output_plugin_options = output_plugin_options;
+    ctx->output_plugin_options = ParseParallelDecodeOptions(ctx->reorder, output_plugin_options);
     ctx->fast_forward = fast_forward;
 
     (void)MemoryContextSwitchTo(old_context);
@@ -168,6 +180,53 @@ static LogicalDecodingContext* StartupDecodingContext(List* output_plugin_option
     return ctx;
 }
 
+/*
+ * Take the options that split decoding by relation over several sessions,
+ * parallel-decode-num and parallel-decode-id, out of the output plugin
+ * options, as they are handled by the reorder buffer for any plugin.
+ */
+static List* ParseParallelDecodeOptions(ReorderBuffer* rb, List* options)
+{
+    List* plugin_options = NIL;
+    ListCell* option = NULL;
+    int num = 1;
+    int id = 0;
+
+    foreach (option, options) {
+        DefElem* elem = (DefElem*)lfirst(option);
+        int* value = NULL;
+
+        if (strcmp(elem->defname, "parallel-decode-num") == 0)
+            value = &num;
+        else if (strcmp(elem->defname, "parallel-decode-id") == 0)
+            value = &id;
+        else {
+            plugin_options = lappend(plugin_options, elem);
+            continue;
+        }
+
+        if (elem->arg == NULL)
+            ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("parameter \"%s\" requires a value", elem->defname)));
+        Assert(IsA(elem->arg, String));
+        *value = pg_strtoint32(strVal(elem->arg));
+    }
+
+    if (num < 1 || num > MAX_PARALLEL_DECODE_NUM)
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("parallel-decode-num must be between 1 and %d", MAX_PARALLEL_DECODE_NUM)));
+    if (id < 0 || id >= num)
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("parallel-decode-id must be between 0 and %d", num - 1)));
+
+    rb->parallel_decode_num = (uint32)num;
+    rb->parallel_decode_id = (uint32)id;
+
+    return plugin_options;
+}
+
 /*
  * Create a new decoding context, for a new logical slot.
  *
@@ -585,10 +644,19 @@ static void startup_cb_wrapper(LogicalDecodingContext* ctx, OutputPluginOptions*
     ctx->accept_writes = false;
 
     /* do the actual work: call callback */
+    opt->streaming = false;
     ctx->callbacks.startup_cb(ctx, opt, is_init);
 
     /* Pop the error context stack */
     t_thrd.log_cxt.error_context_stack = errcallback.previous;
+
+    if (opt->streaming && (ctx->callbacks.stream_start_cb == NULL || ctx->callbacks.stream_stop_cb == NULL ||
+                              ctx->callbacks.stream_abort_cb == NULL || ctx->callbacks.stream_commit_cb == NULL))
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("output plugin \"%s\" asks for streaming without the stream callbacks",
+                    NameStr(ctx->slot->data.plugin))));
+    ctx->reorder->streaming = opt->streaming;
 }
 
 static void shutdown_cb_wrapper(LogicalDecodingContext* ctx)
@@ -712,6 +780,122 @@ static void change_cb_wrapper(
     t_thrd.log_cxt.error_context_stack = errcallback.previous;
 }
 
+static void stream_start_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_start";
+    state.report_location = txn->first_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->first_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_start_cb(ctx, txn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_stop_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_stop";
+    state.report_location = txn->first_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state, the transaction isn't done so its end is unknown */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->first_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_stop_cb(ctx, txn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_abort_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_abort";
+    state.report_location = XLogRecPtrIsInvalid(abort_lsn) ? txn->first_lsn : abort_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = state.report_location;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_abort_cb(ctx, txn, abort_lsn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_commit";
+    state.report_location = txn->final_lsn; /* beginning of commit record */
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->end_lsn; /* points to the end of the record */
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_commit_cb(ctx, txn, commit_lsn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
 bool filter_by_origin_cb_wrapper(LogicalDecodingContext* ctx, RepOriginId origin_id)
 {
     LogicalErrorCallbackState state;
@@ -35,7 +35,11 @@
  *	big as the available memory - this module supports spooling the contents
  *	of a large transactions to disk. When the transaction is replayed the
  *	contents of individual (sub-)transactions will be read from disk in
- *	chunks.
+ *	chunks. The memory of all the transactions is bounded together by
+ *	logical_decoding_work_mem, and the largest transaction is the one that
+ *	goes to disk. If the output plugin supports streaming, the changes of
+ *	such a transaction are instead sent to it before the transaction ends,
+ *	see ReorderBufferStreamTXN().
  *
  *	This module also has to deal with reassembling toast records from the
  *	individual chunks stored in WAL. When a new (or initial) version of a
@@ -54,6 +58,7 @@
 
 #include "miscadmin.h"
 
+#include "access/hash.h"
 #include "access/rewriteheap.h"
 #include "access/transam.h"
 #include "access/tuptoaster.h"
@@ -66,7 +71,7 @@
 #include "replication/logical.h"
 #include "replication/reorderbuffer.h"
 #include "replication/slot.h"
-#include "replication/snapbuild.h" /* just for SnapBuildSnapDecRefcount */
+#include "replication/snapbuild.h"
 #include "access/xlog_internal.h"
 
 #include "storage/bufmgr.h"
@@ -168,13 +173,28 @@ static ReorderBufferIterTXNState* ReorderBufferIterTXNInit(ReorderBuffer* rb, Re
 static ReorderBufferChange* ReorderBufferIterTXNNext(ReorderBuffer* rb, ReorderBufferIterTXNState* state);
 static void ReorderBufferIterTXNFinish(ReorderBuffer* rb, ReorderBufferIterTXNState* state);
 static void ReorderBufferExecuteInvalidations(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static bool ReorderBufferApplyChange(ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change,
+    Snapshot* snapshot_now, CommandId* command_id);
+static bool ReorderBufferOwnsRelnode(ReorderBuffer* rb, const RelFileNode* relnode);
+static bool ReorderBufferSkipChange(ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change);
+static void ReorderBufferRememberRelnode(ReorderBuffer* rb, const RelFileNode* relnode, bool istoast);
+
+/*
+ * ---------------------------------------
+ * Memory accounting and streaming of large transactions
+ * ---------------------------------------
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange* change);
+static void ReorderBufferChangeMemoryUpdate(ReorderBuffer* rb, ReorderBufferTXN* txn, Size sz, bool addition);
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer* rb);
+static bool ReorderBufferCanStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static Size ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 
 /*
  * ---------------------------------------
  * Disk serialization support functions
  * ---------------------------------------
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 static void ReorderBufferSerializeChange(ReorderBuffer* rb, ReorderBufferTXN* txn, int fd, ReorderBufferChange* change);
 static Size ReorderBufferRestoreChanges(ReorderBuffer* rb, ReorderBufferTXN* txn, int* fd, XLogSegNo* segno);
@@ -236,6 +256,11 @@ ReorderBuffer* ReorderBufferAllocate(void)
     buffer->outbufsize = 0;
 
     buffer->current_restart_decoding_lsn = InvalidXLogRecPtr;
+    buffer->size = 0;
+    buffer->streaming = false;
+    buffer->parallel_decode_num = 1;
+    buffer->parallel_decode_id = 0;
+    buffer->decode_relnodes = NULL;
 
     dlist_init(&buffer->toplevel_by_lsn);
     dlist_init(&buffer->txns_by_base_snapshot_lsn);
@@ -533,8 +558,16 @@ void ReorderBufferQueueChange(ReorderBuffer* rb, TransactionId xid, XLogRecPtr l
     dlist_push_tail(&txn->changes, &change->node);
     txn->nentries++;
     txn->nentries_mem++;
+    ReorderBufferChangeMemoryUpdate(rb, txn, ReorderBufferChangeSize(change), true);
 
-    ReorderBufferCheckSerializeTXN(rb, txn);
+    /*
+     * Only make room on data changes. Snapshots are queued while the commit
+     * of a catalog changing transaction is decoded, before its invalidations
+     * are executed, so a transaction must not be streamed in between.
+     */
+    if (change->action == REORDER_BUFFER_CHANGE_INSERT || change->action == REORDER_BUFFER_CHANGE_UPDATE ||
+        change->action == REORDER_BUFFER_CHANGE_DELETE)
+        ReorderBufferCheckMemoryLimit(rb);
 }
 
 /*
@@ -1056,6 +1089,15 @@ static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
         Assert(change->action == REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID);
         ReorderBufferReturnChange(rb, change);
     }
+
+    /* changes taken off the list to be freed later are accounted for until now */
+    ReorderBufferChangeMemoryUpdate(rb, txn, txn->size, false);
+
+    /* the snapshot the streaming stopped at */
+    if (txn->snapshot_now != NULL && txn->snapshot_now->copied)
+        ReorderBufferFreeSnap(rb, txn->snapshot_now);
+    txn->snapshot_now = NULL;
+
     /*
      * Cleanup the base snapshot, if set.
      */
@@ -1225,6 +1267,222 @@ static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap)
         SnapBuildSnapDecRefcount(snap);
 }
 
+/* entry of ReorderBuffer.decode_relnodes */
+typedef struct ReorderBufferRelnodeEnt {
+    RelFileNode relnode; /* hash key */
+    bool istoast;
+} ReorderBufferRelnodeEnt;
+
+/* Does this parallel decoding session pass on the changes of relnode? */
+static bool ReorderBufferOwnsRelnode(ReorderBuffer* rb, const RelFileNode* relnode)
+{
+    return rb->parallel_decode_num <= 1 ||
+           DatumGetUInt32(hash_uint32(relnode->relNode)) % rb->parallel_decode_num == rb->parallel_decode_id;
+}
+
+/*
+ * Skip a change of a relation of another parallel decoding session before
+ * looking it up in the catalog. Toast chunks are needed by the session of
+ * the toasted relation, which we can't know, so toast relations and the
+ * relfilenodes not looked up yet aren't skipped.
+ */
+static bool ReorderBufferSkipChange(ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change)
+{
+    ReorderBufferRelnodeEnt* ent = NULL;
+
+    if (rb->decode_relnodes == NULL || ReorderBufferOwnsRelnode(rb, &change->data.tp.relnode))
+        return false;
+
+    ent = (ReorderBufferRelnodeEnt*)hash_search(rb->decode_relnodes, &change->data.tp.relnode, HASH_FIND, NULL);
+    if (ent == NULL || ent->istoast)
+        return false;
+
+    /* the toast chunks of the skipped tuple aren't needed anymore */
+    if (change->data.tp.clear_toast_afterwards)
+        ReorderBufferToastReset(rb, txn);
+    return true;
+}
+
+/* Remember a relfilenode of another parallel decoding session, see ReorderBufferSkipChange. */
+static void ReorderBufferRememberRelnode(ReorderBuffer* rb, const RelFileNode* relnode, bool istoast)
+{
+    ReorderBufferRelnodeEnt* ent = NULL;
+
+    if (ReorderBufferOwnsRelnode(rb, relnode))
+        return;
+
+    if (rb->decode_relnodes == NULL) {
+        HASHCTL hash_ctl;
+        int rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+        securec_check(rc, "", "");
+        hash_ctl.keysize = sizeof(RelFileNode);
+        hash_ctl.entrysize = sizeof(ReorderBufferRelnodeEnt);
+        hash_ctl.hash = tag_hash;
+        hash_ctl.hcxt = rb->context;
+        rb->decode_relnodes =
+            hash_create("ReorderBufferDecodeRelnodes", 256, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+    }
+
+    ent = (ReorderBufferRelnodeEnt*)hash_search(rb->decode_relnodes, relnode, HASH_ENTER, NULL);
+    ent->istoast = istoast;
+}
+
+/*
+ * Apply a single change of txn, passing user visible changes to the output
+ * plugin and following the snapshot and command id changes the decoding has
+ * to go with. Returns true if the change was taken off txn's list of changes
+ * to reassemble a toasted datum, false if it is still on the list.
+ */
+static bool ReorderBufferApplyChange(ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change,
+    Snapshot* snapshot_now, CommandId* command_id)
+{
+    Relation relation = NULL;
+    Oid reloid;
+    Oid partitionReltoastrelid = InvalidOid;
+    bool kept = false;
+
+    switch (change->action) {
+        case REORDER_BUFFER_CHANGE_INSERT:
+        case REORDER_BUFFER_CHANGE_UPDATE:
+        case REORDER_BUFFER_CHANGE_DELETE:
+            Assert(*snapshot_now);
+
+            if (ReorderBufferSkipChange(rb, txn, change))
+                return false;
+
+            reloid = RelidByRelfilenode(change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode);
+            if (reloid == InvalidOid) {
+                reloid = PartitionRelidByRelfilenode(
+                    change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode, partitionReltoastrelid);
+            }
+            /*
+             * Catalog tuple without data, emitted while catalog was
+             * in the process of being rewritten.
+             */
+            if (reloid == InvalidOid && change->data.tp.newtuple == NULL && change->data.tp.oldtuple == NULL)
+                return false;
+            else if (reloid == InvalidOid) {
+                /*
+                 * description:
+                 * When we try to decode a table who is already dropped.
+                 * Maybe we could not find it relnode.In this time, we will undecode this log.
+                 * It will be solve when we use MVCC.
+                 */
+                ereport(DEBUG1,
+                    (errmsg(
+                        "could not lookup relation %s", relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
+                return false;
+            }
+
+            relation = RelationIdGetRelation(reloid);
+            if (relation == NULL) {
+                ereport(DEBUG1,
+                    (errmsg("could open relation descriptor %s",
+                        relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
+                return false;
+            }
+
+            if (rb->parallel_decode_num > 1)
+                ReorderBufferRememberRelnode(rb, &change->data.tp.relnode, IsToastRelation(relation));
+
+            if (CSTORE_NAMESPACE == get_rel_namespace(RelationGetRelid(relation))) {
+                return false;
+            }
+
+            if (RelationIsLogicallyLogged(relation)) {
+                /*
+                 * For now ignore sequence changes entirely. Most of
+                 * the time they don't log changes using records we
+                 * understand, so it doesn't make sense to handle the
+                 * few cases we do.
+                 */
+                if (relation->rd_rel->relkind == RELKIND_SEQUENCE) {
+                } else if (!IsToastRelation(relation)) { /* user-triggered change */
+                    /* relations of the other parallel decoding sessions are skipped */
+                    if (ReorderBufferOwnsRelnode(rb, &change->data.tp.relnode)) {
+                        ReorderBufferToastReplace(rb, txn, relation, change, partitionReltoastrelid);
+                        rb->apply_change(rb, txn, relation, change);
+                    }
+                    /*
+                     * Only clear reassembled toast chunks if we're
+                     * sure they're not required anymore. The creator
+                     * of the tuple tells us.
+                     */
+                    if (change->data.tp.clear_toast_afterwards)
+                        ReorderBufferToastReset(rb, txn);
+                } else if (change->action == REORDER_BUFFER_CHANGE_INSERT) {
+                    /* we're not interested in toast deletions
+                     *
+                     * Need to reassemble the full toasted Datum in
+                     * memory, to ensure the chunks don't get reused
+                     * till we're done remove it from the list of this
+                     * transaction's changes. Otherwise it will get
+                     * freed/reused while restoring spooled data from
+                     * disk.
+                     */
+                    dlist_delete(&change->node);
+                    ReorderBufferToastAppendChunk(rb, txn, relation, change);
+                    kept = true;
+                }
+            }
+            RelationClose(relation);
+            break;
+        case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT:
+            /* get rid of the old */
+            TeardownHistoricSnapshot(false);
+
+            if ((*snapshot_now)->copied) {
+                ReorderBufferFreeSnap(rb, *snapshot_now);
+                *snapshot_now = ReorderBufferCopySnap(rb, change->data.snapshot, txn, *command_id);
+            } else if (change->data.snapshot->copied) {
+                /*
+                 * Restored from disk, need to be careful not to double
+                 * free. We could introduce refcounting for that, but for
+                 * now this seems infrequent enough not to care.
+                 */
+                *snapshot_now = ReorderBufferCopySnap(rb, change->data.snapshot, txn, *command_id);
+            } else {
+                *snapshot_now = change->data.snapshot;
+            }
+
+            /* and continue with the new one */
+            SetupHistoricSnapshot(*snapshot_now, txn->tuplecid_hash);
+            break;
+
+        case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+            Assert(change->data.command_id != InvalidCommandId);
+
+            if (*command_id < change->data.command_id) {
+                *command_id = change->data.command_id;
+
+                if (!(*snapshot_now)->copied) {
+                    /* we don't use the global one anymore */
+                    *snapshot_now = ReorderBufferCopySnap(rb, *snapshot_now, txn, *command_id);
+                }
+
+                (*snapshot_now)->curcid = *command_id;
+
+                TeardownHistoricSnapshot(false);
+                SetupHistoricSnapshot(*snapshot_now, txn->tuplecid_hash);
+
+                /*
+                 * Every time the CommandId is incremented, we could
+                 * see new catalog contents, so execute all
+                 * invalidations.
+                 */
+                ReorderBufferExecuteInvalidations(rb, txn);
+            }
+
+            break;
+
+        case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+            ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("tuplecid value in changequeue")));
+            break;
+    }
+
+    return kept;
+}
+
 /*
  * Perform the replay of a transaction and its non-aborted subtransactions.
  *
@@ -1236,7 +1494,8 @@ static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap)
  * record is read because that's the only place where we know about cache
  * invalidations. Thus, once a toplevel commit is read, we iterate over the top
  * and subtransactions (using a k-way merge) and replay the changes in lsn
- * order.
+ * order. Of a transaction that was streamed, only the changes that weren't
+ * sent yet are left.
  */
 void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
     RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time)
@@ -1273,7 +1532,23 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         return;
     }
 
-    snapshot_now = txn->base_snapshot;
+    /*
+     * A streamed transaction continues with the snapshot and command id its
+     * last stream ended with. The copy is made anew, as subtransactions that
+     * committed since then have to be seen as well.
+     */
+    if (txn->snapshot_now != NULL) {
+        command_id = txn->command_id;
+        if (txn->snapshot_now->copied) {
+            snapshot_now = ReorderBufferCopySnap(rb, txn->snapshot_now, txn, command_id);
+            ReorderBufferFreeSnap(rb, txn->snapshot_now);
+        } else {
+            snapshot_now = txn->snapshot_now;
+        }
+        txn->snapshot_now = NULL;
+    } else {
+        snapshot_now = txn->base_snapshot;
+    }
 
     /* build data to be able to lookup the CommandIds of catalog tuples */
     ReorderBufferBuildTupleCidHash(rb, txn);
@@ -1303,149 +1578,25 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
             txn_started = true;
         }
 
-        rb->begin(rb, txn);
+        if (txn->streamed)
+            rb->stream_start(rb, txn);
+        else
+            rb->begin(rb, txn);
 
         iterstate = ReorderBufferIterTXNInit(rb, txn);
-        while ((change = ReorderBufferIterTXNNext(rb, iterstate))) {
-            Relation relation = NULL;
-            Oid reloid;
-            Oid partitionReltoastrelid = InvalidOid;
-
-            switch (change->action) {
-                case REORDER_BUFFER_CHANGE_INSERT:
-                case REORDER_BUFFER_CHANGE_UPDATE:
-                case REORDER_BUFFER_CHANGE_DELETE:
-                    Assert(snapshot_now);
-
-                    reloid = RelidByRelfilenode(change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode);
-                    if (reloid == InvalidOid) {
-                        reloid = PartitionRelidByRelfilenode(
-                            change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode, partitionReltoastrelid);
-                    }
-                    /*
-                     * Catalog tuple without data, emitted while catalog was
-                     * in the process of being rewritten.
-                     */
-                    if (reloid == InvalidOid && change->data.tp.newtuple == NULL && change->data.tp.oldtuple == NULL)
-                        continue;
-                    else if (reloid == InvalidOid) {
-                        /*
-                         * description:
-                         * When we try to decode a table who is already dropped.
-                         * Maybe we could not find it relnode.In this time, we will undecode this log.
-                         * It will be solve when we use MVCC.
-                         */
-                        ereport(DEBUG1,
-                            (errmsg(
-                                "could not lookup relation %s", relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
-                        continue;
-                    }
-
-                    relation = RelationIdGetRelation(reloid);
-                    if (relation == NULL) {
-                        ereport(DEBUG1,
-                            (errmsg("could open relation descriptor %s",
-                                relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
-                        continue;
-                    }
-
-                    if (CSTORE_NAMESPACE == get_rel_namespace(RelationGetRelid(relation))) {
-                        continue;
-                    }
-
-                    if (RelationIsLogicallyLogged(relation)) {
-                        /*
-                         * For now ignore sequence changes entirely. Most of
-                         * the time they don't log changes using records we
-                         * understand, so it doesn't make sense to handle the
-                         * few cases we do.
-                         */
-                        if (relation->rd_rel->relkind == RELKIND_SEQUENCE) {
-                        } else if (!IsToastRelation(relation)) { /* user-triggered change */
-                            ReorderBufferToastReplace(rb, txn, relation, change, partitionReltoastrelid);
-                            rb->apply_change(rb, txn, relation, change);
-                            /*
-                             * Only clear reassembled toast chunks if we're
-                             * sure they're not required anymore. The creator
-                             * of the tuple tells us.
-                             */
-                            if (change->data.tp.clear_toast_afterwards)
-                                ReorderBufferToastReset(rb, txn);
-                        } else if (change->action == REORDER_BUFFER_CHANGE_INSERT) {
-                            /* we're not interested in toast deletions
-                             *
-                             * Need to reassemble the full toasted Datum in
-                             * memory, to ensure the chunks don't get reused
-                             * till we're done remove it from the list of this
-                             * transaction's changes. Otherwise it will get
-                             * freed/reused while restoring spooled data from
-                             * disk.
-                             */
-                            dlist_delete(&change->node);
-                            ReorderBufferToastAppendChunk(rb, txn, relation, change);
-                        }
-                    }
-                    RelationClose(relation);
-                    break;
-                case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT:
-                    /* get rid of the old */
-                    TeardownHistoricSnapshot(false);
-
-                    if (snapshot_now->copied) {
-                        ReorderBufferFreeSnap(rb, snapshot_now);
-                        snapshot_now = ReorderBufferCopySnap(rb, change->data.snapshot, txn, command_id);
-                    } else if (change->data.snapshot->copied) {
-                        /*
-                         * Restored from disk, need to be careful not to double
-                         * free. We could introduce refcounting for that, but for
-                         * now this seems infrequent enough not to care.
-                         */
-                        snapshot_now = ReorderBufferCopySnap(rb, change->data.snapshot, txn, command_id);
-                    } else {
-                        snapshot_now = change->data.snapshot;
-                    }
-
-                    /* and continue with the new one */
-                    SetupHistoricSnapshot(snapshot_now, txn->tuplecid_hash);
-                    break;
-
-                case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
-                    Assert(change->data.command_id != InvalidCommandId);
-
-                    if (command_id < change->data.command_id) {
-                        command_id = change->data.command_id;
-
-                        if (!snapshot_now->copied) {
-                            /* we don't use the global one anymore */
-                            snapshot_now = ReorderBufferCopySnap(rb, snapshot_now, txn, command_id);
-                        }
-
-                        snapshot_now->curcid = command_id;
-
-                        TeardownHistoricSnapshot(false);
-                        SetupHistoricSnapshot(snapshot_now, txn->tuplecid_hash);
-
-                        /*
-                         * Every time the CommandId is incremented, we could
-                         * see new catalog contents, so execute all
-                         * invalidations.
-                         */
-                        ReorderBufferExecuteInvalidations(rb, txn);
-                    }
-
-                    break;
-
-                case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
-                    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("tuplecid value in changequeue")));
-                    break;
-            }
-        }
+        while ((change = ReorderBufferIterTXNNext(rb, iterstate)))
+            (void)ReorderBufferApplyChange(rb, txn, change, (Snapshot*)&snapshot_now, (CommandId*)&command_id);
 
         ReorderBufferIterTXNFinish(rb, iterstate);
         iterstate = NULL;
 
-        /* call commit callback */
-        rb->commit(rb, txn, commit_lsn);
+        /* call commit callback, a streamed transaction only needs to be told it committed */
+        if (txn->streamed) {
+            rb->stream_stop(rb, txn);
+            rb->stream_commit(rb, txn, commit_lsn);
+        } else {
+            rb->commit(rb, txn, commit_lsn);
+        }
 
         /* this is just a sanity check against bad output plugin behaviour */
         if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
@@ -1506,6 +1657,148 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
     PG_END_TRY();
 }
 
+/*
+ * Whether the changes of txn can be passed to the output plugin before it
+ * commits. Only toplevel transactions that don't touch the catalog are
+ * streamed, as decoding them needs no invalidations from later records, and
+ * once spilled a transaction stays on disk until its commit.
+ */
+static bool ReorderBufferCanStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)rb->private_data;
+
+    if (!rb->streaming)
+        return false;
+
+    /* nothing may be sent before the point decoding is consistent at */
+    if (SnapBuildCurrentState(ctx->snapshot_builder) != SNAPBUILD_CONSISTENT ||
+        SnapBuildXactNeedsSkip(ctx->snapshot_builder, txn->first_lsn))
+        return false;
+
+    return !txn->is_known_as_subxact && txn->base_snapshot != NULL && !txn->has_catalog_changes &&
+           !txn->serialized;
+}
+
+/*
+ * Pass the changes txn made before its first subtransaction to the output
+ * plugin as one stream block, and free them. The changes of subtransactions
+ * wait for the commit, as they may still be rolled back. Returns the amount
+ * of memory freed, which is 0 if there was nothing to stream.
+ */
+static Size ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    XLogRecPtr cutoff = InvalidXLogRecPtr;
+    dlist_iter iter;
+    dlist_mutable_iter change_i;
+    ReorderBufferChange* first = NULL;
+    Size oldsize = txn->size;
+
+    volatile CommandId command_id = txn->command_id;
+    volatile Snapshot snapshot_now = NULL;
+    volatile bool txn_started = false;
+    volatile bool subtxn_started = false;
+
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (XLByteEQ(cutoff, InvalidXLogRecPtr) || XLByteLT(subtxn->first_lsn, cutoff))
+            cutoff = subtxn->first_lsn;
+    }
+
+    if (dlist_is_empty(&txn->changes))
+        return 0;
+    first = dlist_head_element(ReorderBufferChange, node, &txn->changes);
+    if (!XLByteEQ(cutoff, InvalidXLogRecPtr) && !XLByteLT(first->lsn, cutoff))
+        return 0;
+
+    /* continue with the snapshot the last block ended with */
+    if (txn->snapshot_now != NULL)
+        snapshot_now = txn->snapshot_now;
+    else
+        snapshot_now = txn->base_snapshot;
+    txn->snapshot_now = NULL;
+
+    SetupHistoricSnapshot(snapshot_now, txn->tuplecid_hash);
+
+    PG_TRY();
+    {
+        /* see ReorderBufferCommit() */
+        if (IsTransactionOrTransactionBlock()) {
+            BeginInternalSubTransaction("stream");
+            subtxn_started = true;
+        } else {
+            StartTransactionCommand();
+            txn_started = true;
+        }
+
+        rb->stream_start(rb, txn);
+        txn->streamed = true;
+
+        dlist_foreach_modify(change_i, &txn->changes)
+        {
+            ReorderBufferChange* change = dlist_container(ReorderBufferChange, node, change_i.cur);
+
+            if (!XLByteEQ(cutoff, InvalidXLogRecPtr) && !XLByteLT(change->lsn, cutoff))
+                break;
+
+            ReorderBufferChangeMemoryUpdate(rb, txn, ReorderBufferChangeSize(change), false);
+            txn->nentries--;
+            txn->nentries_mem--;
+
+            /* a toast chunk is kept until the tuple it belongs to is applied */
+            if (ReorderBufferApplyChange(rb, txn, change, (Snapshot*)&snapshot_now, (CommandId*)&command_id))
+                continue;
+
+            /* the change owns the snapshot we're using, keep a copy of it */
+            if (change->action == REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT && snapshot_now == change->data.snapshot) {
+                snapshot_now = ReorderBufferCopySnap(rb, change->data.snapshot, txn, command_id);
+                TeardownHistoricSnapshot(false);
+                SetupHistoricSnapshot(snapshot_now, txn->tuplecid_hash);
+            }
+
+            dlist_delete(&change->node);
+            ReorderBufferReturnChange(rb, change);
+        }
+
+        rb->stream_stop(rb, txn);
+
+        /* this is just a sanity check against bad output plugin behaviour */
+        if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
+            ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                    errmsg("output plugin used xid %lu", GetCurrentTransactionId())));
+
+        TeardownHistoricSnapshot(false);
+
+        if (subtxn_started)
+            RollbackAndReleaseCurrentSubTransaction();
+        else if (txn_started)
+            AbortCurrentTransaction();
+
+        /* the next block, or the commit, continues from here */
+        txn->snapshot_now = snapshot_now;
+        txn->command_id = command_id;
+    }
+    PG_CATCH();
+    {
+        TeardownHistoricSnapshot(true);
+
+        if (snapshot_now->copied)
+            ReorderBufferFreeSnap(rb, snapshot_now);
+
+        if (subtxn_started)
+            RollbackAndReleaseCurrentSubTransaction();
+        else if (txn_started)
+            AbortCurrentTransaction();
+
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+
+    return oldsize - txn->size;
+}
+
 /*
  * Abort a transaction that possibly has previous changes. Needs to be first
  * called for subtransactions and then for the toplevel xid.
@@ -1530,6 +1823,10 @@ void ReorderBufferAbort(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     /* cosmetic... */
     txn->final_lsn = lsn;
 
+    /* the output plugin has seen part of it already */
+    if (txn->streamed)
+        rb->stream_abort(rb, txn, lsn);
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1561,6 +1858,9 @@ void ReorderBufferAbortOld(ReorderBuffer* rb, TransactionId oldestRunningXid)
             if (!RecoveryInProgress())
                 ereport(DEBUG2, (errmsg("aborting old transaction %lu", txn->xid)));
 
+            if (txn->streamed)
+                rb->stream_abort(rb, txn, InvalidXLogRecPtr);
+
             /* remove potential on-disk data, and deallocate this tx */
             ReorderBufferCleanupTXN(rb, txn);
         } else
@@ -1616,6 +1916,10 @@ void ReorderBufferForget(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     } else
         Assert(txn->ninvalidations == 0);
 
+    /* what was streamed of it is of no interest either */
+    if (txn->streamed)
+        rb->stream_abort(rb, txn, lsn);
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1760,6 +2064,12 @@ static void ReorderBufferExecuteInvalidations(ReorderBuffer* rb, ReorderBufferTX
 
     for (i = 0; i < txn->ninvalidations; i++)
         LocalExecuteInvalidationMessage(&txn->invalidations[i]);
+
+    /* a relfilenode may have been dropped and reused by another kind of relation */
+    if (txn->ninvalidations > 0 && rb->decode_relnodes != NULL) {
+        hash_destroy(rb->decode_relnodes);
+        rb->decode_relnodes = NULL;
+    }
 }
 
 /*
@@ -1830,17 +2140,78 @@ static void ReorderBufferSerializeReserve(ReorderBuffer* rb, Size sz)
 }
 
 /*
- * Check whether the transaction tx should spill its data to disk.
+ * Amount of memory a change takes up while it is queued.
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+static Size ReorderBufferChangeSize(ReorderBufferChange* change)
 {
-    /*
-     * description: improve accounting so we cheaply can take subtransactions into
-     * account here.
-     */
-    if (txn->nentries_mem >= (unsigned)g_instance.attr.attr_common.max_changes_in_memory) {
-        ReorderBufferSerializeTXN(rb, txn);
-        Assert(txn->nentries_mem == 0);
+    Size sz = sizeof(ReorderBufferChange);
+
+    switch (change->action) {
+        case REORDER_BUFFER_CHANGE_INSERT:
+        case REORDER_BUFFER_CHANGE_UPDATE:
+        case REORDER_BUFFER_CHANGE_DELETE:
+            if (change->data.tp.oldtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.oldtuple->alloc_tuple_size;
+            if (change->data.tp.newtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.newtuple->alloc_tuple_size;
+            break;
+        case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT: {
+            Snapshot snap = change->data.snapshot;
+
+            sz += sizeof(SnapshotData) + sizeof(TransactionId) * (snap->xcnt + snap->subxcnt);
+            break;
+        }
+        case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+        case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+            break;
+    }
+
+    return sz;
+}
+
+/*
+ * Account for a change queued into or taken off txn.
+ */
+static void ReorderBufferChangeMemoryUpdate(ReorderBuffer* rb, ReorderBufferTXN* txn, Size sz, bool addition)
+{
+    if (addition) {
+        txn->size += sz;
+        rb->size += sz;
+    } else {
+        Assert(txn->size >= sz && rb->size >= sz);
+        txn->size -= sz;
+        rb->size -= sz;
+    }
+}
+
+/*
+ * Make room once the queued changes exceed logical_decoding_work_mem. The
+ * largest transaction goes first, it is streamed to the output plugin if it
+ * can be and spilled to disk otherwise, until we're below the limit again.
+ */
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer* rb)
+{
+    Size limit = (Size)u_sess->attr.attr_memory.logical_decoding_work_mem * 1024L;
+
+    while (rb->size >= limit) {
+        HASH_SEQ_STATUS hash_seq;
+        ReorderBufferTXNByIdEnt* ent = NULL;
+        ReorderBufferTXN* largest = NULL;
+
+        hash_seq_init(&hash_seq, rb->by_txn);
+        while ((ent = (ReorderBufferTXNByIdEnt*)hash_seq_search(&hash_seq)) != NULL) {
+            if (largest == NULL || ent->txn->size > largest->size)
+                largest = ent->txn;
+        }
+
+        if (largest == NULL || largest->size == 0)
+            break;
+
+        if (ReorderBufferCanStreamTXN(rb, largest) && ReorderBufferStreamTXN(rb, largest) > 0)
+            continue;
+
+        ReorderBufferSerializeTXN(rb, largest);
+        Assert(largest->nentries_mem == 0);
     }
 }
 
@@ -1915,6 +2286,11 @@ static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
 
         ReorderBufferSerializeChange(rb, txn, fd, change);
         dlist_delete(&change->node);
+        ReorderBufferChangeMemoryUpdate(rb, txn, ReorderBufferChangeSize(change), false);
+
+        /* spill files are found by the lsn range, which may not be closed yet */
+        if (XLByteLT(txn->final_lsn, change->lsn))
+            txn->final_lsn = change->lsn;
         ReorderBufferReturnChange(rb, change);
 
         spilled++;
@@ -2067,6 +2443,7 @@ static Size ReorderBufferRestoreChanges(ReorderBuffer* rb, ReorderBufferTXN* txn
         ReorderBufferChange* cleanup = dlist_container(ReorderBufferChange, node, cleanup_iter.cur);
 
         dlist_delete(&cleanup->node);
+        ReorderBufferChangeMemoryUpdate(rb, txn, ReorderBufferChangeSize(cleanup), false);
         ReorderBufferReturnChange(rb, cleanup);
     }
     txn->nentries_mem = 0;
@@ -2254,6 +2631,7 @@ static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn,
 
     dlist_push_tail(&txn->changes, &change->node);
     txn->nentries_mem++;
+    ReorderBufferChangeMemoryUpdate(rb, txn, ReorderBufferChangeSize(change), true);
 }
 
 /*
@@ -86,6 +86,10 @@
 %token K_FAST
 %token K_NOWAIT
 %token K_WAL
+%token K_INCREMENTAL
+%token K_PARALLEL
+%token K_STREAM
+%token K_COMPRESS
 %token K_DATA
 %token K_START_REPLICATION
 %token K_FETCH_MOT_CHECKPOINT
@@ -102,7 +106,7 @@
 %type <list>    plugin_options plugin_opt_list
 %type <defelt>  plugin_opt_elem
 %type <node>    plugin_opt_arg
-%type <str>		opt_slot
+%type <str>		opt_slot opt_compress
 %%
 
 firstcmd: command opt_semicolon
@@ -202,7 +206,8 @@ identify_channel:
 			;
 
 /*
- * BASE_BACKUP [LABEL '<label>'] [PROGRESS] [FAST] [WAL] [NOWAIT]
+ * BASE_BACKUP [LABEL '<label>'] [PROGRESS] [FAST] [WAL] [NOWAIT] [INCREMENTAL %X/%X]
+ *             [PARALLEL n] [STREAM k] [COMPRESS]
  */
 base_backup:
 			K_BASE_BACKUP base_backup_opt_list
@@ -242,14 +247,38 @@ base_backup_opt:
 				  $$ = makeDefElem("nowait",
 						   (Node *)makeInteger(TRUE));
 				}
+			| K_INCREMENTAL RECPTR
+				{
+				  char lsn[MAXFNAMELEN];
+				  int rc = snprintf_s(lsn, sizeof(lsn), sizeof(lsn) - 1, "%X/%X",
+						   (uint32) ($2 >> 32), (uint32) $2);
+				  securec_check_ss(rc, "", "");
+				  $$ = makeDefElem("incremental",
+						   (Node *)makeString(pstrdup(lsn)));
+				}
+			| K_PARALLEL ICONST
+				{
+				  $$ = makeDefElem("parallel",
+						   (Node *)makeInteger($2));
+				}
+			| K_STREAM ICONST
+				{
+				  $$ = makeDefElem("stream",
+						   (Node *)makeInteger($2));
+				}
+			| K_COMPRESS
+				{
+				  $$ = makeDefElem("compress",
+						   (Node *)makeInteger(TRUE));
+				}
 			;
 
 /*
  * START_REPLICATION %X/%X
- * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X
+ * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X [COMPRESS method]
  */
 start_replication:
-			K_START_REPLICATION opt_slot opt_physical RECPTR
+			K_START_REPLICATION opt_slot opt_physical RECPTR opt_compress
 				{
 					StartReplicationCmd *cmd;
 
@@ -257,18 +286,24 @@ start_replication:
 					cmd->kind = REPLICATION_KIND_PHYSICAL;
  					cmd->slotname = $2;
  					cmd->startpoint = $4;
+					cmd->compression = $5;
 
 					$$ = (Node *) cmd;
 				}
 			;
 			
 /*
- * START_REPLICATION DATA
+ * START_REPLICATION DATA [COMPRESS method]
  */
 start_data_replication:
-			K_START_REPLICATION K_DATA
+			K_START_REPLICATION K_DATA opt_compress
 				{
-					$$ = (Node *) makeNode(StartDataReplicationCmd);
+					StartDataReplicationCmd *cmd;
+
+					cmd = makeNode(StartDataReplicationCmd);
+					cmd->compression = $3;
+
+					$$ = (Node *) cmd;
 				}
 			;
 
@@ -333,6 +368,10 @@ start_logical_replication:
 
 
 opt_physical :	K_PHYSICAL | /* EMPTY */;
+
+opt_compress :	K_COMPRESS IDENT			{ $$ = $2; }
+				| /* EMPTY */				{ $$ = NULL; }
+				;
  
  
 opt_slot :	K_SLOT IDENT
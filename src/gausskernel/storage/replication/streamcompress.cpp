@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * streamcompress.cpp
+ *        compression of the messages of the WAL and data replication streams
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/replication/streamcompress.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "lz4.h"
+#include "replication/streamcompress.h"
+#include "utils/memutils.h"
+
+const char* StreamCompressName(int type)
+{
+    switch (type) {
+        case STREAM_COMPRESS_NONE:
+            return "none";
+        case STREAM_COMPRESS_LZ4:
+            return "lz4";
+        default:
+            return "unknown";
+    }
+}
+
+StreamCompressType StreamCompressLookup(const char* name)
+{
+    if (pg_strcasecmp(name, "lz4") == 0)
+        return STREAM_COMPRESS_LZ4;
+    if (pg_strcasecmp(name, "none") == 0)
+        return STREAM_COMPRESS_NONE;
+
+    ereport(ERROR,
+        (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("unsupported stream compression method \"%s\"", name)));
+    return STREAM_COMPRESS_NONE; /* keep compiler quiet */
+}
+
+Size StreamCompressBound(Size srclen)
+{
+    return sizeof(StreamCompressHeader) + (Size)LZ4_compressBound((int)srclen);
+}
+
+Size StreamCompress(StreamCompressType type, const char* src, Size srclen, char* dst)
+{
+    StreamCompressHeader header;
+    int complen;
+    errno_t rc = EOK;
+
+    if (type != STREAM_COMPRESS_LZ4 || srclen < STREAM_COMPRESS_MIN_SIZE)
+        return 0;
+
+    /* accept nothing that doesn't save at least the header */
+    complen = LZ4_compress_default(src,
+        dst + sizeof(StreamCompressHeader),
+        (int)srclen,
+        (int)(srclen - sizeof(StreamCompressHeader) - 1));
+    if (complen <= 0)
+        return 0;
+
+    header.rawSize = (uint32)srclen;
+    rc = memcpy_s(dst, sizeof(StreamCompressHeader), &header, sizeof(StreamCompressHeader));
+    securec_check(rc, "\0", "\0");
+
+    return sizeof(StreamCompressHeader) + (Size)complen;
+}
+
+Size StreamDecompress(const char* src, Size srclen, char** buf, Size* bufsize)
+{
+    StreamCompressHeader header;
+    int rawlen;
+    errno_t rc = EOK;
+
+    if (srclen <= sizeof(StreamCompressHeader))
+        ereport(ERROR,
+            (errcode(ERRCODE_PROTOCOL_VIOLATION), errmsg_internal("invalid compressed message received from primary")));
+
+    /* memcpy is required here for alignment reasons */
+    rc = memcpy_s(&header, sizeof(StreamCompressHeader), src, sizeof(StreamCompressHeader));
+    securec_check(rc, "\0", "\0");
+
+    if (header.rawSize == 0 || !AllocSizeIsValid(header.rawSize))
+        ereport(ERROR,
+            (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                errmsg_internal("invalid raw size %u of compressed message received from primary", header.rawSize)));
+
+    /* the buffer lives as long as the receiver thread */
+    if (*bufsize < header.rawSize) {
+        if (*buf != NULL)
+            pfree(*buf);
+        *buf = (char*)MemoryContextAlloc(t_thrd.top_mem_cxt, header.rawSize);
+        *bufsize = header.rawSize;
+    }
+
+    rawlen = LZ4_decompress_safe(src + sizeof(StreamCompressHeader),
+        *buf,
+        (int)(srclen - sizeof(StreamCompressHeader)),
+        (int)header.rawSize);
+    if (rawlen < 0 || (uint32)rawlen != header.rawSize)
+        ereport(ERROR,
+            (errcode(ERRCODE_DATA_CORRUPTED),
+                errmsg_internal("could not decompress message received from primary")));
+
+    return (Size)rawlen;
+}
@@ -58,6 +58,7 @@
 #include "replication/walsender.h"
 #include "replication/walsender_private.h"
 #include "replication/libpqwalreceiver.h"
+#include "replication/streamcompress.h"
 #include "storage/copydir.h"
 #include "storage/ipc.h"
 #include "storage/latch.h"
@@ -834,6 +835,7 @@ static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len)
             break;
         }
         case 'w': /* WAL records */
+        case 'z': /* compressed WAL records */
         {
             WalDataMessageHeader msghdr;
 
@@ -849,6 +851,16 @@ static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len)
 
             buf += sizeof(WalDataMessageHeader);
             len -= sizeof(WalDataMessageHeader);
+
+            /* hand the raw WAL to the writer, see replication_compression */
+            if (type == 'z') {
+                len = StreamDecompress(buf,
+                    len,
+                    &t_thrd.walreceiver_cxt.decompress_buf,
+                    &t_thrd.walreceiver_cxt.decompress_buf_size);
+                buf = t_thrd.walreceiver_cxt.decompress_buf;
+            }
+
             if (IsExtremeRedo()) {
                 XLogWalRcvReceiveInBuf(buf, len, msghdr.dataStart);
             } else {
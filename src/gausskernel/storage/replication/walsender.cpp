@@ -69,6 +69,7 @@
 #include "replication/decode.h"
 #include "replication/logical.h"
 #include "replication/slot.h"
+#include "replication/streamcompress.h"
 #include "replication/snapbuild.h"
 #include "replication/syncrep.h"
 #include "replication/walprotocol.h"
@@ -149,6 +150,8 @@ static void InitWalSnd(void);
 static void WalSndHandshake(void);
 static void WalSndKill(int code, Datum arg);
 static void XLogSendPhysical(void);
+static Size WalSndPutXLogMessage(Size nbytes);
+static void WalSndRefreshThroughput(void);
 static void XLogSendLogical(void);
 static void IdentifySystem(void);
 static void IdentifyVersion(void);
@@ -989,6 +992,17 @@ static void StartReplication(StartReplicationCmd* cmd)
                     (errmsg("cannot use a logical replication slot for physical replication"))));
     }
 
+    /* Compress the WAL if the standby asks for it, see XLogSendPhysical */
+    if (cmd->compression != NULL) {
+        volatile WalSnd* walsnd = t_thrd.walsender_cxt.MyWalSnd;
+
+        t_thrd.walsender_cxt.compression = StreamCompressLookup(cmd->compression);
+
+        SpinLockAcquire(&walsnd->mutex);
+        walsnd->compression = t_thrd.walsender_cxt.compression;
+        SpinLockRelease(&walsnd->mutex);
+    }
+
     /*
      * When we first start replication the standby will be behind the primary.
      * For some applications, for example, synchronous replication, it is
@@ -2515,6 +2529,10 @@ static void WSDataSendInit()
         t_thrd.walsender_cxt.wsXLogJustSendRegion->end_ptr = InvalidXLogRecPtr;
     }
 
+    if (t_thrd.walsender_cxt.compression != STREAM_COMPRESS_NONE)
+        t_thrd.walsender_cxt.compress_xlog_message =
+            (char*)palloc(1 + sizeof(WalDataMessageHeader) + StreamCompressBound(WS_MAX_SEND_SIZE));
+
     return;
 }
 
@@ -3118,6 +3136,10 @@ static void InitWalSnd(void)
             securec_check(rc, "\0", "\0");
             walsnd->sync_standby_priority = 0;
             walsnd->index = i;
+            walsnd->compression = STREAM_COMPRESS_NONE;
+            walsnd->sentRawBytes = 0;
+            walsnd->sentWireBytes = 0;
+            walsnd->sendThroughput = 0;
             walsnd->log_ctrl.sleep_time = 0;
             walsnd->log_ctrl.balance_sleep_time = 0;
             walsnd->log_ctrl.prev_RTO = -1;
@@ -3444,6 +3466,69 @@ static void XLogSendLogical(void)
     }
 }
 
+/*
+ * Send the 'w' message of nbytes of WAL built in output_xlog_message. If the
+ * standby asked for compression, it's sent as a 'z' message with the WAL
+ * compressed, unless the WAL doesn't get smaller. Returns the length of the
+ * WAL as it went out.
+ */
+static Size WalSndPutXLogMessage(Size nbytes)
+{
+    char* rawmsg = t_thrd.walsender_cxt.output_xlog_message;
+    char* compmsg = t_thrd.walsender_cxt.compress_xlog_message;
+    Size complen = 0;
+    errno_t errorno = EOK;
+
+    if (t_thrd.walsender_cxt.compression != STREAM_COMPRESS_NONE)
+        complen = StreamCompress((StreamCompressType)t_thrd.walsender_cxt.compression,
+            rawmsg + 1 + sizeof(WalDataMessageHeader),
+            nbytes,
+            compmsg + 1 + sizeof(WalDataMessageHeader));
+
+    if (complen == 0) {
+        (void)pq_putmessage_noblock('d', rawmsg, 1 + sizeof(WalDataMessageHeader) + nbytes);
+        return nbytes;
+    }
+
+    compmsg[0] = 'z';
+    errorno = memcpy_s(compmsg + 1, sizeof(WalDataMessageHeader), rawmsg + 1, sizeof(WalDataMessageHeader));
+    securec_check(errorno, "\0", "\0");
+    (void)pq_putmessage_noblock('d', compmsg, 1 + sizeof(WalDataMessageHeader) + complen);
+
+    return complen;
+}
+
+/*
+ * Refresh the throughput of MyWalSnd about once a second, from the raw WAL
+ * sent since the last refresh.
+ */
+static void WalSndRefreshThroughput(void)
+{
+    /* use volatile pointer to prevent code rearrangement */
+    volatile WalSnd* walsnd = t_thrd.walsender_cxt.MyWalSnd;
+    TimestampTz now = GetCurrentTimestamp();
+    long secs = 0;
+    int usecs = 0;
+    uint64 elapsed;
+
+    if (t_thrd.walsender_cxt.throughput_time == 0) {
+        t_thrd.walsender_cxt.throughput_time = now;
+        return;
+    }
+    if (!TimestampDifferenceExceeds(t_thrd.walsender_cxt.throughput_time, now, MSECS_PER_SEC))
+        return;
+
+    TimestampDifference(t_thrd.walsender_cxt.throughput_time, now, &secs, &usecs);
+    elapsed = (uint64)secs * USECS_PER_SEC + (uint64)usecs;
+
+    SpinLockAcquire(&walsnd->mutex);
+    walsnd->sendThroughput = (walsnd->sentRawBytes - t_thrd.walsender_cxt.throughput_bytes) * USECS_PER_SEC / elapsed;
+    t_thrd.walsender_cxt.throughput_bytes = walsnd->sentRawBytes;
+    SpinLockRelease(&walsnd->mutex);
+
+    t_thrd.walsender_cxt.throughput_time = now;
+}
+
 /*
  * Read up to MAX_SEND_SIZE bytes of WAL that's been flushed to disk,
  * but not yet sent to the client, and buffer it in the libpq output buffer.
@@ -3460,9 +3545,11 @@ static void XLogSendPhysical(void)
     WalDataMessageHeader msghdr;
     ServerMode local_role;
     volatile HaShmemData* hashmdata = t_thrd.postmaster_cxt.HaShmData;
+    Size wirebytes = 0;
     errno_t errorno = EOK;
 
     t_thrd.walsender_cxt.catchup_threshold = 0;
+    WalSndRefreshThroughput();
 
     /*
      * Attempt to send all data that's already been written out and fsync'd to
@@ -3590,8 +3677,7 @@ static void XLogSendPhysical(void)
         &msghdr,
         sizeof(WalDataMessageHeader));
     securec_check(errorno, "\0", "\0");
-    (void)pq_putmessage_noblock(
-        'd', t_thrd.walsender_cxt.output_xlog_message, 1 + sizeof(WalDataMessageHeader) + nbytes);
+    wirebytes = WalSndPutXLogMessage(nbytes);
 
     t_thrd.walsender_cxt.sentPtr = endptr;
 
@@ -3602,6 +3688,8 @@ static void XLogSendPhysical(void)
 
         SpinLockAcquire(&walsnd->mutex);
         walsnd->sentPtr = t_thrd.walsender_cxt.sentPtr;
+        walsnd->sentRawBytes += nbytes;
+        walsnd->sentWireBytes += wirebytes;
         SpinLockRelease(&walsnd->mutex);
     }
 
@@ -4039,7 +4127,7 @@ Tuplestorestate* BuildTupleResult(FunctionCallInfo fcinfo, TupleDesc* tupdesc)
  */
 Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 {
-#define PG_STAT_GET_WAL_SENDERS_COLS 21
+#define PG_STAT_GET_WAL_SENDERS_COLS 26
 
     TupleDesc tupdesc;
     Tuplestorestate* tupstore = NULL;
@@ -4093,6 +4181,10 @@ Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
         XLogRecPtr sndReplay;
         XLogRecPtr RcvReceived;
         XLogRecPtr syncStart;
+        int compression;
+        uint64 sentRawBytes;
+        uint64 sentWireBytes;
+        uint64 sendThroughput;
 
         int sync_percent = 0;
         ServerMode peer_role;
@@ -4141,6 +4233,10 @@ Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
         syncStart = walsnd->syncPercentCountStart;
         catchup_time[0] = walsnd->catchupTime[0];
         catchup_time[1] = walsnd->catchupTime[1];
+        compression = walsnd->compression;
+        sentRawBytes = walsnd->sentRawBytes;
+        sentWireBytes = walsnd->sentWireBytes;
+        sendThroughput = walsnd->sendThroughput;
         if (IS_DN_MULTI_STANDYS_MODE())
             priority = walsnd->sync_standby_priority;
         SpinLockRelease(&walsnd->mutex);
@@ -4331,6 +4427,20 @@ Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
                 remoteport);
             securec_check_ss(ret, "\0", "\0");
             values[j++] = CStringGetTextDatum(location);
+
+            /* compression of the stream, and the WAL sent before and after it */
+            values[j++] = CStringGetTextDatum(StreamCompressName(compression));
+            values[j++] = Int64GetDatum((int64)sentRawBytes);
+            values[j++] = Int64GetDatum((int64)sentWireBytes);
+
+            /* compression_ratio */
+            if (sentWireBytes != 0)
+                values[j++] = Float8GetDatum((double)sentRawBytes / (double)sentWireBytes);
+            else
+                nulls[j++] = true;
+
+            /* send_throughput, bytes of raw WAL per second */
+            values[j++] = Int64GetDatum((int64)sendThroughput);
         }
 
         tuplestore_putvalues(tupstore, tupdesc, values, nulls);
@@ -621,8 +621,22 @@ void mdprefetch(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum)
 #ifdef USE_PREFETCH
     off_t seekpos;
     MdfdVec* v = NULL;
+    BlockNumber targetseg = blocknum / ((BlockNumber)RELSEG_SIZE);
 
-    v = _mdfd_getseg(reln, forknum, blocknum, false, EXTENSION_FAIL);
+    /*
+     * Prefetching is only a hint: don't complain about a missing file, and
+     * unlike _mdfd_getseg() never create a segment, even in recovery.
+     */
+    v = mdopen(reln, forknum, EXTENSION_RETURN_NULL);
+    while (v != NULL && v->mdfd_segno < targetseg) {
+        if (v->mdfd_chain == NULL) {
+            v->mdfd_chain = _mdfd_openseg(reln, forknum, v->mdfd_segno + 1, 0);
+        }
+        v = v->mdfd_chain;
+    }
+    if (v == NULL) {
+        return;
+    }
 
     seekpos = (off_t)BLCKSZ * (blocknum % ((BlockNumber)RELSEG_SIZE));
 
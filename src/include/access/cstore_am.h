@@ -32,6 +32,7 @@
 #include "storage/cu.h"
 #include "storage/custorage.h"
 #include "storage/cucache_mgr.h"
+#include "utils/bloom_filter.h"
 #include "utils/snapshot.h"
 
 #define MAX_CU_PREFETCH_REQSIZ (64)
@@ -82,6 +83,27 @@ struct LoadCUDescCtl : public BaseObject {
 
 struct CStoreScanState;
 typedef CStoreScanState *CStoreScanDesc;
+struct CStoreScanTopNBound;
+
+/*
+ * Runtime bloom filter built by the hash join above and pushed down to the
+ * join key of this scan. The values used to skip CUs are taken out once for
+ * each filter, since the filter may be rebuilt when the hash join rescans.
+ */
+struct CStoreRuntimeFilter {
+    int seq;                 /* which accessed column */
+    int bfIndex;             /* index in es_bloom_filter.bfarray */
+    filter::BloomFilter *bf; /* the filter the following are taken from */
+
+    /* min/max of the filter in int64, only for integer columns */
+    bool useMinMax;
+    Datum min;
+    Datum max;
+
+    /* hash of the only value of the filter to probe CU summary */
+    bool useSummary;
+    uint32 hash;
+};
 
 struct CStoreIndexScanState;
 
@@ -216,6 +238,7 @@ public:
     int FillTidForLateRead(_in_ CUDesc *cuDescPtr, _out_ ScalarVector *vec);
 
     void FillScanBatchLateIfNeed(__inout VectorBatch *vecBatch);
+    void FillScanBatchLateQualIfNeed(__inout VectorBatch *vecBatch);
 
     /* Set CU range for scan in redistribute. */
     void SetScanRange();
@@ -231,6 +254,12 @@ public:
     void RunScan(_in_ CStoreScanState *state, _out_ VectorBatch *vecBatchOut);
 
     int GetLateReadCtid() const;
+
+    // whether all rows of the last scanned batch satisfy the scan keys
+    inline bool IsFullHitBatch() const
+    {
+        return m_fullHitBatch;
+    }
     void IncLoadCuDescCursor();
 
 public:  // public vars
@@ -273,9 +302,24 @@ private:  // private methods.
     bool NeedLoadCUDesc(int32 &cudesc_idx);
     void IncLoadCuDescIdx(int &idx) const;
     bool RoughCheck(CStoreScanKey scanKey, int nkeys, int cuDescIdx);
+    bool FullCheck(CStoreScanKey scanKey, int nkeys, int cuDescIdx);
+    void FullCheckIfNeed(_in_ CStoreScanState *state);
+
+    // Skip the CUs which can not beat the top-N boundary of VecSort above
+    void TopNBoundCheckIfNeed(_in_ CStoreScanState *state);
+    bool TopNBoundSkipCU(CStoreScanTopNBound *bound, CUDesc *cudesc) const;
+
+    // Skip the CUs which can not join the runtime bloom filters of hash join above
+    void InitRuntimeFilterEnv(CStoreScanState *state, const bool *summaryCols);
+    void RuntimeFilterCheckIfNeed(_in_ CStoreScanState *state);
+    bool RuntimeFilterSkipCU(CStoreScanState *state, int cuDescIdx);
+    void RefreshRuntimeFilter(CStoreRuntimeFilter *rf, filter::BloomFilter *bf);
 
     void FillColMinMax(CUDesc *cuDescPtr, ScalarVector *vec, int pos);
 
+    // Fill the late read columns in or out of m_lateQual
+    void FillLateReadColumns(VectorBatch *vecBatch, bool lateQual);
+
     inline TransactionId GetCUXmin(uint32 cuid);
 
     // only called by GetCUData()
@@ -300,10 +344,12 @@ private:
     // 1. Accessed user column id
     // 2. Accessed system column id
     // 3. flags for late read
-    // 4. each CU storage fro each user column.
+    // 4. flags for late read columns needed by the qual after the scan keys
+    // 5. each CU storage fro each user column.
     int *m_colId;
     int *m_sysColId;
     bool *m_lateRead;
+    bool *m_lateQual;
     CUStorage **m_cuStorage;
 
     // 1. The CUDesc info of accessed columns
@@ -330,6 +376,27 @@ private:
     // 
     RoughCheckFunc *m_RCFuncs;
 
+    // Full Check Functions, NULL if any scan key is not supported
+    //
+    FullCheckFunc *m_FCFuncs;
+
+    // all the rows of the last filled batch satisfy the scan keys
+    bool m_fullHitBatch;
+
+    // Rough check of the top-N boundary pushed down by VecSort.
+    // m_topnSeq is the accessed column of the leading sort key, -1 if
+    // it is not resolved yet.
+    RoughCheckFunc m_topnRCFunc;
+    int m_topnSeq;
+
+    // Columns whose bloom filter and value counts are loaded with CUDesc
+    // for rough check, indexed by column id. NULL if none.
+    bool *m_needCUSummary;
+
+    // Runtime bloom filters pushed down by hash join
+    CStoreRuntimeFilter *m_runtimeFilters;
+    int m_runtimeFilterNum;
+
     typedef int (CStore::*m_colFillFun)(int seq, CUDesc *cuDescPtr, ScalarVector *vec);
 
     typedef struct {
@@ -399,6 +466,11 @@ private:
     // for late read
     // the first late read column idx which is filled with ctid.
     int m_laterReadCtidColIdx;
+
+    // for late read
+    // the seq of the late read column filled with ctid, a column not in m_lateQual
+    // is preferred so that ctid is kept until all the late read columns are filled.
+    int m_lateReadCtidSeq;
 };
 
 // CStore Scan interface for sequential scan
@@ -45,13 +45,18 @@ public:
     {
         m_isRptRepeatTupErrForUpdate = isEnable;
     };
+    void InitPatchColumns(_in_ const bool *patchCols);
     /* record memory auto spread info for delete sort. */
     MemInfoArg *m_DelMemInfo;
 
 protected:
     void CollectPartDeltaOids();
     void UpdateVCBitmap(_in_ Relation rel, _in_ uint32 cuid, _in_ const int *rowoffset, _in_ int updateRowNum,
-                        _in_ Snapshot snapshot);
+                        _in_ Snapshot snapshot, _in_ bool markDeleted = true);
+    void CopyPatchValues(_in_ int batchRow, _in_ int patchRow);
+    void PatchCU(_in_ uint32 cuid, _in_ int patchRowNum);
+    void PatchColumnCU(_in_ int col, _in_ uint32 cuid, _in_ int patchRowNum);
+    void FlushPatchColumns();
     void InitDeleteSortStateForTable(_in_ TupleDesc sortTupDesc, _in_ int partidAttNo, _in_ int ctidAttNo);
     void InitDeleteSortStateForPartition(_in_ TupleDesc sortTupDesc, _in_ int partidAttNo, _in_ int ctidAttNo);
     void PutDeleteBatchForTable(_in_ VectorBatch *batch, _in_ JunkFilter *junkfilter);
@@ -86,6 +91,13 @@ protected:
     // report repeat delete tuple error for update
     bool m_isRptRepeatTupErrForUpdate;
 
+    // columns of update written as patch CUs, NULL if rows are deleted and inserted again
+    bool *m_patchCols;
+    CUStorage **m_patchStorage;
+    Datum **m_patchValues;
+    bool **m_patchNulls;
+    MemoryContext m_patchMemCnxt;
+
     void (CStoreDelete::*m_InitDeleteSortStatePtr)(_in_ TupleDesc sortTupDesc, _in_ int partidAttNo,
                                                    _in_ int ctidAttNo);
     void (CStoreDelete::*m_PutDeleteBatchPtr)(_in_ VectorBatch *batch, _in_ JunkFilter *junkfilter);
@@ -33,6 +33,8 @@
 #include "storage/cstore_compress.h"
 #include "storage/spin.h"
 
+struct CUCompressPool;
+
 struct InsertArg {
     /* map to CStoreInsert::m_tmpBatchRows.
      *
@@ -63,6 +65,11 @@ struct InsertArg {
      */
     bool using_vectorbatch;
 
+    /* sort all the rows at once by partial cluster key, but not
+     * each partial_cluster_rows rows. it's for rewriting the whole relation.
+     */
+    bool sortAllRows;
+
     InsertArg()
     {
         tmpBatchRows = NULL;
@@ -70,6 +77,7 @@ struct InsertArg {
         es_result_relations = NULL;
         sortType = TUPLE_SORT;    /* default psort type */
         using_vectorbatch = true; /* caller should specify the right way */
+        sortAllRows = false;
     }
 };
 
@@ -174,6 +182,9 @@ private:
 
     void InitColSpaceAlloc();
 
+    void InitCompressPool();
+    void CompressCUsInParallel(int rowCount);
+
     bool TryEncodeNumeric(int col, bulkload_rows *batchRowPtr, CUDesc *cuDescPtr, CU *cuPtr, bool hasNull);
     void DoBatchInsert(int options);
     typedef void (CStoreInsert::*m_formCUFunc)(int, bulkload_rows *, CUDesc *, CU *);
@@ -186,6 +197,7 @@ private:
     /* Function Pointer Array Area */
     FuncSetMinMax *m_setMinMaxFuncs;    /* min/max value function */
     FormCUFuncArray *m_formCUFuncArray; /* Form CU function pointer */
+    bool *m_summaryCols;                /* columns to form CU summary, NULL if none */
 
     /* If relation has cluster key, it will work for partial sort */
     CStorePSort *m_sorter;
@@ -194,7 +206,8 @@ private:
     CU **m_cuPPtr;                         /* The CU of all columns of m_relation; */
     CUStorage **m_cuStorage;               /* CU storage */
     compression_options *m_cuCmprsOptions; /* compression filter */
-    cu_tmp_compress_info m_cuTempInfo;     /* temp info for CU compression */
+    cu_tmp_compress_info *m_cuTempInfo;    /* temp info for CU compression, one per column */
+    CUCompressPool *m_compressPool;        /* threads compressing CUs, NULL if done serially */
 
     /* buffered batchrows for many VectorBatch values */
     bulkload_rows *m_bufferedBatchRows;
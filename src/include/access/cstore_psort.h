@@ -45,7 +45,8 @@ extern THR_LOCAL int psort_work_mem;
 
 class CStorePSort : public BaseObject {
 public:
-    CStorePSort(Relation rel, AttrNumber *sortKeys, int keyNum, int type, MemInfoArg *m_memInfo = NULL);
+    CStorePSort(Relation rel, AttrNumber *sortKeys, int keyNum, int type, MemInfoArg *m_memInfo = NULL,
+        bool sortAllRows = false);
 
     virtual ~CStorePSort();
 
@@ -72,7 +73,7 @@ public:
 
     bool IsFull() const;
 
-    int GetRowNum() const;
+    int64 GetRowNum() const;
 
     void ResetTupleSortState(bool endFlag);
 
@@ -103,7 +104,25 @@ private:
 
     TupleDesc m_tupDesc;
 
-    int m_curSortedRowNum;
+    /*
+     * Z-order clustering. Rows are sorted by one extra bytea column appended
+     * to m_tupDesc, which interleaves the bits of all partial cluster keys.
+     * m_sortDesc is m_tupDesc itself when rows are sorted in lexical order.
+     */
+    bool m_zorder;
+    TupleDesc m_sortDesc;
+    AttrNumber *m_clusterKeys;
+    int m_clusterKeyNum;
+    AttrNumber m_zorderKeyAttno;
+    bytea *m_zorderKey;
+    uint64 *m_zorderValues;
+    VectorBatch *m_zorderBatch;
+    MemoryContext m_zorderMemContext;
+
+    Datum FormZOrderKey(ScalarVector *columns, int row);
+    Datum FormZOrderKey(const Datum *values, const bool *nulls);
+
+    int64 m_curSortedRowNum;
     int m_partialClusterRowNum;
     int m_fullCUSize;
     // current index of tuple to fetch.
@@ -35,4 +35,13 @@ typedef bool (*RoughCheckFunc)(CUDesc *cudesc, Datum arg);
 
 RoughCheckFunc GetRoughCheckFunc(Oid typeOid, int strategy, Oid collation);
 
+/*
+ * Full check tells whether all the values of a CU satisfy the predicate by
+ * its min/max, so the predicate needs not to be evaluated on each value.
+ * NULL is returned for the types whose min/max are not exact.
+ */
+typedef bool (*FullCheckFunc)(CUDesc *cudesc, Datum arg);
+
+FullCheckFunc GetFullCheckFunc(Oid typeOid, int strategy);
+
 #endif /* CSTORE_ROUGHCHECK_FUNC_H */
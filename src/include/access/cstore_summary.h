@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * cstore_summary.h
+ *        per-CU bloom filter and value counts of ColStore
+ *
+ *
+ * IDENTIFICATION
+ *        src/include/access/cstore_summary.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#ifndef CSTORE_SUMMARY_H
+#define CSTORE_SUMMARY_H
+
+#include "postgres.h"
+#include "knl/knl_variable.h"
+#include "access/cstore_vector.h"
+#include "utils/rel.h"
+
+/*
+ * Summary of the values of one column in a CU besides its min/max. It is only
+ * formed for the columns listed in the reloption BLOOM_FILTER_COLUMNS and kept
+ * in the extra attribute of the cudesc tuple.
+ *
+ * The bloom filter has a power of 2 bits, so it can be folded to half by
+ * OR-ing its two halves and every added value still hits the same bits.
+ */
+struct CUSummary {
+    uint32 null_count;     /* number of NULLs */
+    uint32 distinct_count; /* estimated number of distinct values */
+    uint32 bloom_bits;     /* number of bits of the bloom filter, a power of 2 */
+    uint32 reserved;
+    uint64 bloom[FLEXIBLE_ARRAY_MEMBER];
+};
+
+#define CUSummaryHeaderSize offsetof(CUSummary, bloom)
+#define CUSummarySize(_bits) (CUSummaryHeaderSize + (_bits) / 8)
+
+extern bool CUSummarySupportType(Oid typeOid);
+extern bool* CStoreGetSummaryColumns(Relation rel);
+extern void CheckCStoreSummaryColumns(StdRdOptions* stdOpt, TupleDesc tupDesc);
+
+extern CUSummary* FormCUSummary(Oid typeOid, bulkload_vector* vector, int rows);
+extern CUSummary* DeformCUSummary(Datum extra);
+
+extern uint32 CUSummaryHashDatum(Oid typeOid, Datum value);
+extern uint32 CUSummaryHashScanKey(Oid typeOid, Datum arg);
+extern bool CUSummaryMayContain(const CUSummary* summary, uint32 hash);
+
+#endif /* CSTORE_SUMMARY_H */
@@ -43,6 +43,9 @@ public:
     MemInfoArg *m_insMemInfo;
 
 private:
+    void InitPatchColumns();
+    VectorBatch *GetDeltaBatch(_in_ VectorBatch *batch, _in_ JunkFilter *junkfilter);
+
     Relation m_relation;
 
     CStoreDelete *m_delete;
@@ -55,6 +58,12 @@ private:
     static int BATCHROW_TIMES;
 
     InsertArg m_insert_args;
+
+    /* updated columns written as patch CUs, NULL if the updated rows are inserted again */
+    bool *m_patchCols;
+    /* rows of delta table in the current batch, which are still inserted again */
+    VectorBatch *m_deltaBatch;
+    bool *m_deltaSel;
 };
 
 #endif
@@ -108,6 +108,23 @@ typedef struct RecordBufferState {
 } RecordBufferState;
 
 
+/* a block referenced by a record the dispatcher is yet to prefetch */
+typedef struct {
+    RelFileNode rnode;
+    BlockNumber blkno;
+    XLogRecPtr lsn; /* start of the record */
+} RedoPrefetchBlock;
+
+#define REDO_PREFETCH_QUEUE_SIZE 1024
+
+typedef struct {
+    RedoPrefetchBlock blocks[REDO_PREFETCH_QUEUE_SIZE];
+    uint32 head;
+    uint32 count;
+    XLogRecPtr limitPtr;   /* blocks of records up to here may be prefetched */
+    XLogRecPtr refreshPtr; /* record at which limitPtr was last computed */
+} RedoPrefetchQueue;
+
 typedef struct {
     MemoryContext oldCtx;
     PageRedoPipeline* pageLines;
@@ -136,6 +153,12 @@ typedef struct {
     uint32 syncExitCount;
 
     pg_atomic_uint32 standbyState; /* sync standbyState from trxn worker to startup */
+    RedoPrefetchQueue prefetch;
+
+    HTAB* relOwners;             /* page line of heap relations, see BalancePageLines() */
+    TimestampTz lastBalanceTime; /* last time the page lines were balanced */
+    uint64 dispatchedCount;      /* records dispatched */
+    uint64 movedRelCount;        /* relations moved to another page line */
 } LogDispatcher;
 
 typedef struct {
@@ -32,6 +32,7 @@
 #include "access/xlogreader.h"
 #include "nodes/pg_list.h"
 #include "storage/proc.h"
+#include "utils/hsearch.h"
 
 #include "access/parallel_recovery/redo_item.h"
 #include "access/parallel_recovery/page_redo.h"
@@ -63,6 +64,12 @@ typedef struct LogDispatcher {
     uint32* chosedWorkerIds;
     uint32 chosedWorkerCount;
     uint32 readyWorkerCnt;
+
+    HTAB* relOwners;              /* The page worker of each heap relation, see GetRelWorkerId(). */
+    uint64 dispatchedCount;       /* Number of records dispatched. */
+    TimestampTz lastBalanceTime;  /* The last time the workers were balanced. */
+    uint64 movedRelCount;         /* Number of relations moved to another worker. */
+    uint64 splitRelCount;         /* Number of relations split by block range. */
 } LogDispatcher;
 
 extern LogDispatcher* g_dispatcher;
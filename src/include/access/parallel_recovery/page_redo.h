@@ -158,6 +158,13 @@ struct PageRedoWorker {
     uint32 statMulpageCnt;
     uint64 statWaitReach;
     uint64 statWaitReplay;
+    /* Number of items added by the dispatcher. */
+    uint64 statDispatchCount;
+    /* Number of items replayed by the worker. */
+    uint64 statRedoCount;
+    /* Items replayed per second, and statRedoCount when it was computed, kept by the dispatcher. */
+    uint64 statRedoRate;
+    uint64 statRateBaseCount;
     pg_atomic_uint32 readyStatus;
     MemoryContext oldCtx;
 
@@ -57,6 +57,7 @@ typedef struct RedoWorkerStatsData {
     /* XLogRecPtr head_ptr; do not try to get head_ptr and tail_ptr, */
     /* XLogRecPtr tail_ptr; because the memory of redoItem maybe be freed already */
     uint64 redo_rec_count;
+    uint64 redo_rate; /* records replayed per second */
 } RedoWorkerStatsData;
 
 extern const RedoStatsViewObj g_redoViewArr[REDO_VIEW_COL_SIZE];
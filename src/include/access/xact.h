@@ -306,6 +306,7 @@ extern void CleanstmtSysGTMDeltaTimeStamp();
 #endif
 extern int GetCurrentTransactionNestLevel(void);
 extern void MarkCurrentTransactionIdLoggedIfAny(void);
+extern bool IsSubTransactionAssignmentPending(void);
 extern void CopyTransactionIdLoggedIfAny(TransactionState state);
 extern bool TransactionIdIsCurrentTransactionId(TransactionId xid);
 extern void CommandCounterIncrement(void);
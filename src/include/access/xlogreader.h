@@ -73,6 +73,7 @@ extern bool DecodeXLogRecord(XLogReaderState* state, XLogRecord* record, char**
 #define XLogRecGetBucketId(decoder) ((decoder)->decoded_record->xl_bucket_id - 1)
 #define XLogRecGetCrc(decoder) ((decoder)->decoded_record->xl_crc)
 #define XLogRecGetOrigin(decoder) ((decoder)->record_origin)
+#define XLogRecGetTopXid(decoder) ((decoder)->toplevel_xid)
 #define XLogRecGetData(decoder) ((decoder)->main_data)
 #define XLogRecGetDataLen(decoder) ((decoder)->main_data_len)
 #define XLogRecHasAnyBlockRefs(decoder) ((decoder)->max_block_id >= 0)
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * backup_stream.h
+ *        receiving the extra streams of a parallel base backup, shared by
+ *        gs_basebackup and gs_ctl build
+ *
+ * IDENTIFICATION
+ *        src/include/bin/backup_stream.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef BACKUP_STREAM_H
+#define BACKUP_STREAM_H
+
+#include "libpq/libpq-fe.h"
+#include "storage/block.h"
+#include "replication/basebackup.h"
+
+/*
+ * unpacks the tar stream of tablespace 'rownum' of the backup header 'res',
+ * returns false with the error printed if it fails
+ */
+typedef bool (*BackupStreamReceiver)(PGconn* conn, PGresult* res, int rownum);
+
+typedef struct BackupStream BackupStream;
+
+/* true in the threads receiving the extra streams, which leave progress reports to the main thread */
+extern THR_LOCAL bool InBackupStreamThread;
+
+/*
+ * Set by the main thread once it has failed, the receivers running in the
+ * threads give up on seeing it.
+ */
+extern volatile bool BackupStreamCancelled;
+
+/*
+ * Send 'command' on 'conn' in a new thread, and hand each tablespace of the
+ * backup header to 'receiver'. The receiver may be run by several threads at
+ * once, each with its own connection. The stream owns the connection from
+ * now on, NULL is returned if the thread can't be started.
+ */
+extern BackupStream* StartBackupStream(PGconn* conn, const char* command, BackupStreamReceiver receiver);
+
+/*
+ * Wait for the stream to finish and close its connection. Returns false with
+ * the error printed if the stream failed. The threads never exit the process
+ * themselves, the caller does so if needed once every stream is waited for.
+ */
+extern bool WaitBackupStream(BackupStream* stream, const char* progname);
+
+/*
+ * Open a file to unpack with fopen(). The streams of a parallel backup other
+ * than the main one don't carry directory entries, so if 'parallel' the file
+ * may arrive before the main stream has created its directory; create it then,
+ * and the main stream sets its permissions later.
+ */
+extern FILE* OpenBackupFile(char* filename, bool parallel, const char* mode);
+
+/* progress of applying an incremental tar member, see ApplyIncrementalData() */
+typedef struct IncrementalApplyState {
+    bool active;
+    bool headerdone;
+    size_t filled;
+    IncrementalFileHeader header;
+    char record[INCREMENTAL_BLOCK_RECORD_SIZE];
+} IncrementalApplyState;
+
+/*
+ * Apply the content of an incremental tar member onto the file it changes.
+ * The data may be split into CopyData messages at any boundary, so the header
+ * and each block record are gathered in state first. Returns false with the
+ * error printed if it fails.
+ */
+extern bool ApplyIncrementalData(
+    IncrementalApplyState* state, FILE* file, const char* filename, const char* data, int len, const char* progname);
+
+/*
+ * A relation file of an incremental backup or delta build may be sent with
+ * fewer segments than the local relation has, after the relation is truncated
+ * or its relfilenode is reused. Once 'filename' is known to be 'filesize'
+ * bytes on the server, remove the local segments past it if it is the last
+ * one. Returns false with the error printed if it fails.
+ */
+extern bool RemoveStaleSegments(const char* filename, uint64 filesize, const char* progname);
+
+/*
+ * Decompress a CopyData message of a base backup taken with COMPRESS. Returns
+ * the length of the raw data pointed to by *rawdata, or -1 if the message is
+ * corrupted. *rawdata is valid until the next call in the same thread.
+ */
+extern int DecompressBackupData(char* data, int len, char** rawdata);
+
+#endif /* BACKUP_STREAM_H */
@@ -384,6 +384,29 @@ public:
      */
     void addFunctionToMCJit(llvm::Function* F, void** result_fn_ptr);
 
+    /*
+     * @Description : The same as addFunctionToMCJit, except that the machine
+     *				  code is also kept in the thread-level module cache after
+     *				  the query, so that later queries generating a function
+     *				  with the same signature can skip codegen by calling
+     *				  lookupMCJitCache.
+     * @in F		: A IR function which will be as a key of map.
+     * @in signature: A string which identifies the IR function uniquely,
+     *				  everything the IR depends on must be encoded in it.
+     * @in result_fn_ptr : A machine code function pointer which will be as
+     *				  a value of map.
+     * @return		: void
+     */
+    void addFunctionToMCJitCache(llvm::Function* F, const char* signature, void** result_fn_ptr);
+
+    /*
+     * @Description : Search the thread-level module cache for the machine code
+     *				  compiled by an earlier query with the same signature.
+     * @in signature: The signature used in addFunctionToMCJitCache.
+     * @return		: The machine code function pointer, or NULL if not found.
+     */
+    static void* lookupMCJitCache(const char* signature);
+
     /*
      * @Description : Adds the c-function calls to m_cfunctions_calls List in case of
      *				codegen_strategy is 'full'.
@@ -523,6 +546,7 @@ public:
     void resetMCJittedFunc()
     {
         m_machineCodeJitCompiled = NIL;
+        m_machineCodeJitCached = NIL;
     }
 
 public:
@@ -574,6 +598,12 @@ private:
 
     /* Records the c-function calls in codegen IR fucntion of expression tree */
     List* m_cfunction_calls;
+
+    /* The map of signature to MCJIT compiled object which should be cached */
+    List* m_machineCodeJitCached;
+
+    /* Hand over the compiled module to the thread-level module cache */
+    void cacheCompiledModule();
 };
 
 /*
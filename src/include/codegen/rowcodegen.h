@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * rowcodegen.h
+ *        Declarations of code generation for the row executor.
+ *
+ * Three kinds of IR functions are generated for row-engine scan nodes:
+ * the qual list, the generic expressions of the target list and a tuple
+ * deform function specialized for the scanned tuple descriptor. Every
+ * generated function is registered in the thread-level module cache with
+ * a signature describing its input, so later executions of the same plan
+ * reuse the machine code without running LLVM again.
+ *
+ * IDENTIFICATION
+ *        src/include/codegen/rowcodegen.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef LLVM_ROW_EXPRESSION_H
+#define LLVM_ROW_EXPRESSION_H
+
+#include "codegen/gscodegen.h"
+#include "optimizer/clauses.h"
+#include "nodes/execnodes.h"
+
+namespace dorado {
+
+/*
+ * RowExprCodeGen class implements LLVM optimization for the row executor.
+ * Only int2/int4/int8 comparison and arithmetic operators, simple Vars,
+ * pass-by-value Consts and NullTests are supported right now.
+ */
+class RowExprCodeGen : public BaseObject {
+public:
+    /*
+     * @Description : Try to codegen qual, target list and tuple deforming
+     *                of a row scan node. Each part is handled separately,
+     *                so a non-jittable qual does not prevent the deform
+     *                function from being generated.
+     * @in node     : The scan state, must have been fully initialized.
+     * @return      : true if any of the parts is going to run jitted code.
+     */
+    static bool ScanCodeGen(ScanState* node);
+
+    /*
+     * @Description : Check whether every clause of the qual list could be
+     *                codegened.
+     * @in qual     : Implicit-AND list of clauses (plan representation).
+     * @return      : Return true if the whole qual list is jittable.
+     */
+    static bool QualJittable(List* qual);
+
+    /*
+     * @Description : Generate IR function 'bool (*)(ExprContext*)' which
+     *                has the same result as ExecQual(qual, econtext, false).
+     * @in qual     : Implicit-AND list of clauses (plan representation).
+     * @return      : The IR function, or NULL if failed.
+     */
+    static llvm::Function* QualCodeGen(List* qual);
+
+    /*
+     * @Description : Check whether all the generic expressions of the
+     *                projection could be codegened.
+     * @in targetlist : List of GenericExprState over TargetEntry.
+     * @return      : Return true if the target list is jittable.
+     */
+    static bool TargetListJittable(List* targetlist);
+
+    /*
+     * @Description : Generate IR function 'void (*)(ExprContext*, Datum*, bool*)'
+     *                which fills the values/isnull array in the same way
+     *                as ExecTargetList does for a single-result target list.
+     * @in targetlist : List of GenericExprState over TargetEntry.
+     * @return      : The IR function, or NULL if failed.
+     */
+    static llvm::Function* TargetListCodeGen(List* targetlist);
+
+    /*
+     * @Description : Check whether the tuple descriptor could be deformed
+     *                by a generated function.
+     * @in desc     : Tuple descriptor of the scan slot.
+     * @return      : Return true if the descriptor is jittable.
+     */
+    static bool DeformJittable(TupleDesc desc);
+
+    /*
+     * @Description : Generate IR function 'void (*)(TupleTableSlot*, int)'
+     *                which has the same result as slot_deform_tuple for
+     *                a slot with no attribute extracted yet.
+     * @in desc     : Tuple descriptor of the scan slot.
+     * @return      : The IR function, or NULL if failed.
+     */
+    static llvm::Function* DeformCodeGen(TupleDesc desc);
+
+private:
+    static bool IntExprJittable(Expr* expr);
+    static bool ClauseJittable(Expr* clause);
+};
+}  // namespace dorado
+
+#endif
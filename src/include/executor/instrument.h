@@ -111,6 +111,7 @@ typedef struct SortHashInfo {
     bool hash_writefile;
     int hash_spillNum;
     int hashtable_expand_times;
+    int hashagg_flush_times; /* times adaptive hash agg flushed its groups */
     double hashbuild_time;
     double hashagg_time;
     long spill_size;      /* Totoal disk IO */
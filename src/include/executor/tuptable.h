@@ -107,6 +107,10 @@
  *
  * tts_slow/tts_off are saved state for slot_deform_tuple, and should not
  * be touched by any other code.
+ *
+ * tts_jitted_deform, if set, is machine code generated by LLVM for the
+ * current descriptor; slot_deform_tuple uses it to extract the attributes
+ * of a fresh physical tuple.  It is reset whenever the descriptor changes.
  * ----------
  */
 typedef struct TupleTableSlot {
@@ -137,6 +141,8 @@ typedef struct TupleTableSlot {
     HeapTupleData tts_minhdr;      /* workspace for minimal-tuple-only case */
     long tts_off;                  /* saved state for slot_deform_tuple */
     long tts_meta_off;             /* saved state for slot_deform_cmpr_tuple */
+    /* LLVM deform function specialized for tts_tupleDescriptor, or NULL */
+    void (*tts_jitted_deform)(struct TupleTableSlot* slot, int natts);
 } TupleTableSlot;
 
 #define TTS_HAS_PHYSICAL_TUPLE(slot) ((slot)->tts_tuple != NULL && (slot)->tts_tuple != &((slot)->tts_minhdr))
@@ -50,9 +50,12 @@ typedef struct knl_session_attr_sql {
     bool enable_bloom_filter;
     bool enable_codegen;
     bool enable_codegen_print;
+    bool enable_row_codegen;
     bool enable_sonic_optspill;
     bool enable_sonic_hashjoin;
     bool enable_sonic_hashagg;
+    bool enable_vector_radix_sort;
+    bool enable_adaptive_hashagg;
     bool enable_csqual_pushdown;
     bool enable_change_hjcost;
     bool enable_seqscan;
@@ -150,6 +153,9 @@ typedef struct knl_session_attr_sql {
     int query_dop_tmp;
     int plan_mode_seed;
     int codegen_cost_threshold;
+    int codegen_cache_size;
+    int vector_sort_threads;
+    int vector_sort_rows_per_thread;
     int acce_min_datasize_per_thread;
     int max_cn_temp_file_size;
     int default_statistics_target;
@@ -68,6 +68,10 @@ typedef struct knl_session_attr_storage {
     bool enable_stream_replication;
     bool EnforceTwoPhaseCommit;
     bool enable_show_any_tuples;
+    bool enable_cstore_column_update;
+    bool enable_cstore_fsst;
+    bool enable_cstore_simd_decode;
+    bool enable_cu_cache_admission;
     bool enable_debug_vacuum;
     bool enable_adio_debug;
     bool gds_debug_mod;
@@ -79,10 +83,12 @@ typedef struct knl_session_attr_storage {
     int LockWaitUpdateTimeout;
     int max_standby_archive_delay;
     int max_standby_streaming_delay;
+    int standby_buffer_pin_delay;
     int wal_receiver_status_interval;
     int wal_receiver_timeout;
     int wal_receiver_connect_timeout;
     int wal_receiver_connect_retries;
+    int replication_compression;
     int max_loaded_cudesc;
     int num_temp_buffers;
     int psort_work_mem;
@@ -132,11 +138,16 @@ typedef struct knl_session_attr_storage {
     int autoanalyze_timeout;
     int autovacuum_vac_thresh;
     int autovacuum_anl_thresh;
+    int autovacuum_delta_merge_thresh;
+    int autovacuum_delta_merge_age;
+    int autovacuum_recluster_age;
     int prefetch_quantity;
     int backwrite_quantity;
     int cstore_prefetch_quantity;
     int cstore_backwrite_max_threshold;
     int cstore_backwrite_quantity;
+    int cstore_compress_threads;
+    int cstore_recluster_cus;
     int fast_extend_file_size;
     int gin_pending_list_limit;
     int gtm_connect_retries;
@@ -170,6 +181,7 @@ typedef struct knl_session_attr_storage {
     bool enable_cbm_tracking;
     bool enable_copy_server_files;
     int target_rto;
+    int recovery_prefetch_distance;
     bool enable_twophase_commit;
     /*
      * xlog keep for all standbys even through they are not connect and donnot created replslot.
@@ -376,6 +376,9 @@ typedef struct {
     RedoWaitInfo wait_info[WAIT_REDO_NUM];
     uint32 speed_according_seg;
     XLogRecPtr local_max_lsn;
+    uint64 prefetch_issued; /* blocks prefetched by the dispatcher of extreme RTO */
+    uint64 prefetch_hit;    /* blocks found in shared buffers already */
+    uint64 prefetch_skip;   /* blocks restored from a full-page image or re-initialized */
 } RedoPerf;
 
 
@@ -80,6 +80,9 @@ typedef struct knl_t_codegen_context {
     bool g_runningInFmgr;
 
     long codegen_IRload_thr_count;
+
+    /* modules compiled by earlier queries and kept for reuse, see gscodegen.cpp */
+    void* thr_codegen_cache;
 } knl_t_codegen_context;
 
 typedef struct knl_t_relopt_context {
@@ -1889,6 +1892,19 @@ typedef struct knl_t_basebackup_context {
     char g_xlog_location[MAXPGPATH];
 
     char* buf_block;
+
+    /* blocks changed since the start location of an incremental backup, NULL for a full backup */
+    HTAB* incremental_block_tab;
+
+    /* stream of a parallel base backup this walsender serves, 0 for the main stream */
+    int stream_id;
+    int nstreams;
+    uint64 parallel_backup_id;
+
+    /* compress CopyData messages with LZ4 */
+    bool compress;
+    char* compress_buf;
+    int compress_buf_size;
 } knl_t_basebackup_context;
 
 typedef struct knl_t_datarcvwriter_context {
@@ -1951,6 +1967,10 @@ typedef struct knl_t_datareceiver_context {
     /* Buffer for currently read data */
     char* recvBuf;
 
+    /* Buffer for the data pages of compressed messages */
+    char* decompress_buf;
+    Size decompress_buf_size;
+
     struct DataRcvData* DataRcv;
 
     /*
@@ -1993,6 +2013,10 @@ typedef struct knl_t_datasender_context {
      */
     char* output_message;
 
+    /* compression the standby asked for, and the buffer of compressed messages */
+    int compression;
+    char* compress_message;
+
     /*
      * dummy standby read data file num and offset.
      */
@@ -2039,6 +2063,9 @@ typedef struct knl_t_walreceiver_context {
     bool AmWalReceiverForFailover;
     bool AmWalReceiverForStandby;
     int control_file_writed;
+    /* Buffer for the WAL of compressed messages */
+    char* decompress_buf;
+    Size decompress_buf_size;
 } knl_t_walreceiver_context;
 
 typedef struct knl_t_walsender_context {
@@ -2092,6 +2119,15 @@ typedef struct knl_t_walsender_context {
      */
     char* output_xlog_message;
     Size output_xlog_msg_prefix_len;
+    /*
+     * Compression the standby asked for, and the buffer of compressed messages
+     * (1 + sizeof(WalDataMessageHeader) + StreamCompressBound(MAX_SEND_SIZE) bytes)
+     */
+    int compression;
+    char* compress_xlog_message;
+    /* raw WAL sent before throughput_time, for the throughput in MyWalSnd */
+    TimestampTz throughput_time;
+    uint64 throughput_bytes;
     /*
      * Buffer for constructing outgoing messages
      * (sizeof(DataElementHeaderData) + MAX_SEND_SIZE bytes)
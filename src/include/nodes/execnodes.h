@@ -282,6 +282,7 @@ typedef struct ReturnSetInfo {
  * ----------------
  */
 typedef bool (*vectarget_func)(ExprContext* econtext, VectorBatch* pBatch);
+typedef void (*rowtarget_func)(ExprContext* econtext, Datum* values, bool* isnull);
 typedef struct ProjectionInfo {
     NodeTag type;
     List* pi_targetlist;
@@ -306,6 +307,7 @@ typedef struct ProjectionInfo {
     bool pi_const;
     VectorBatch* pi_batch;
     vectarget_func jitted_vectarget; /* LLVM function pointer to point to the codegened targetlist expr function */
+    rowtarget_func jitted_rowtarget; /* LLVM function pointer to the codegened row-engine targetlist function */
     VectorBatch* pi_setFuncBatch;
 } ProjectionInfo;
 
@@ -314,6 +316,7 @@ typedef struct ProjectionInfo {
  * will be added to the actual machine code.
  */
 typedef ScalarVector* (*vecqual_func)(ExprContext* econtext);
+typedef bool (*rowqual_func)(ExprContext* econtext);
 
 /* ----------------
  *	  JunkFilter
@@ -1520,6 +1523,8 @@ typedef struct ScanState {
     bool isSampleScan;               /* identify is it table sample scan or not. */
     SampleScanParams sampleScanInfo; /* TABLESAMPLE params include type/seed/repeatable. */
     ExecScanAccessMtd ScanNextMtd;
+    rowqual_func jitted_rowqual;     /* LLVM function pointer to the codegened row-engine qual */
+    bool is_row_jitted;              /* row-engine codegen functions are attached to this scan */
 } ScanState;
 
 /*
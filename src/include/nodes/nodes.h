@@ -545,6 +545,7 @@ typedef enum NodeTag {
     T_VecPartIterator,
     T_VecMergeAppend,
     T_VecRecursiveUnion,
+    T_VecWorkTableScan,
     T_VecScan,
     T_CStoreScan,
     T_TsStoreScan,
@@ -619,6 +620,9 @@ typedef enum NodeTag {
     T_VecMaterialState,
     T_VecMergeJoinState,
     T_VecWindowAggState,
+    T_VecMergeAppendState,
+    T_VecRecursiveUnionState,
+    T_VecWorkTableScanState,
 
     // this must put last for vector engine runtime state
     T_VecEndState,
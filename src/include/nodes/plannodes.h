@@ -443,6 +443,9 @@ typedef struct MergeAppend {
     bool* nullsFirst;       /* NULLS FIRST/LAST directions */
 } MergeAppend;
 
+typedef struct VecMergeAppend : public MergeAppend {
+} VecMergeAppend;
+
 /* ----------------
  *	RecursiveUnion node -
  *		Generate a recursive union of two subplans.
@@ -468,6 +471,9 @@ typedef struct RecursiveUnion {
                             * to one datanode to execute the recursive CTE in one-DN mode */
 } RecursiveUnion;
 
+typedef struct VecRecursiveUnion : public RecursiveUnion {
+} VecRecursiveUnion;
+
 /* ----------------
  *	 BitmapAnd node -
  *		Generate the intersection of the results of sub-plans.
@@ -818,6 +824,9 @@ typedef struct WorkTableScan {
     int wtParam; /* ID of Param representing work table */
 } WorkTableScan;
 
+typedef struct VecWorkTableScan : public WorkTableScan {
+} VecWorkTableScan;
+
 /* ----------------
  *		ForeignScan node
  *
@@ -1104,6 +1113,7 @@ typedef struct Agg {
     bool is_sonichash;    /* allowed to use sonic hash routine or not */
     bool is_dummy;        /* just for coop analysis, if true, agg node does nothing */
     uint32 skew_optimize; /* skew optimize method for agg */
+    bool is_partial;      /* lower agg of two-level agg, the upper agg regroups its output */
 } Agg;
 
 /* ----------------
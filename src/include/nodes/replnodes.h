@@ -89,6 +89,7 @@ typedef struct StartReplicationCmd {
     char* slotname;
     XLogRecPtr startpoint;
     List* options;
+    char* compression; /* compression method of the WAL stream, or NULL */
 } StartReplicationCmd;
 
 /* ----------------------
@@ -97,6 +98,7 @@ typedef struct StartReplicationCmd {
  */
 typedef struct StartDataReplicationCmd {
     NodeTag type;
+    char* compression; /* compression method of the data stream, or NULL */
 } StartDataReplicationCmd;
 
 /* ----------------------
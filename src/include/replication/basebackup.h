@@ -23,6 +23,56 @@
 
 #define MAX_FILE_SIZE_LIMIT  ((0x80000000))
 
+/*
+ * An incremental base backup sends the relation files changed since its start
+ * location as tar members of type INCREMENTAL_TAR_TYPE instead of sending them
+ * in full. The content of such a member is an IncrementalFileHeader followed by
+ * nblocks records, each of which is the block number within the segment file
+ * and the page image. The client applies them onto the file of the previous
+ * backup, after resizing the file to filesize.
+ */
+#define INCREMENTAL_TAR_TYPE 'I'
+#define INCREMENTAL_FILE_MAGIC 0x494E4352 /* "INCR" */
+#define INCREMENTAL_BLOCK_RECORD_SIZE (sizeof(BlockNumber) + BLCKSZ)
+
+typedef struct IncrementalFileHeader {
+    uint32 magic;
+    uint32 nblocks;  /* number of block records following */
+    uint64 filesize; /* size of the file on the server */
+} IncrementalFileHeader;
+
+/*
+ * A base backup can be split into several streams, each of which is served by
+ * its own walsender. Stream 0 is started with PARALLEL n and runs the backup
+ * as usual, streams 1..n-1 are started with PARALLEL n STREAM k once stream 0
+ * has sent the tablespace list. Each regular file is sent by exactly one of
+ * the streams, chosen by the hash of its name; directories, links and the
+ * backup label are sent by stream 0 only.
+ */
+#define MAX_PARALLEL_BACKUP_STREAMS 32
+#define BACKUP_STREAM_OF_FILE(filehash, nstreams) ((int)((uint32)(filehash) % (uint32)(nstreams)))
+
+/*
+ * With COMPRESS every CopyData message of the backup is compressed with LZ4 on
+ * its own and prefixed by a BackupCompressHeader, so that the messages keep
+ * their boundaries after decompression. compsize is 0 if the data doesn't
+ * compress, and then the raw data follows.
+ */
+typedef struct BackupCompressHeader {
+    uint32 rawsize;
+    uint32 compsize;
+} BackupCompressHeader;
+
+/* state of a parallel base backup, kept in WalSndCtlData */
+typedef struct ParallelBackupState {
+    uint64 backupId;        /* bumped by every parallel base backup */
+    int nstreams;           /* 0 if no parallel base backup is running */
+    XLogRecPtr startptr;    /* start location of the running backup */
+    uint32 attached;        /* bitmap of the streams that have attached */
+    uint32 finished;        /* bitmap of the streams that have sent all files */
+    bool failed;            /* some stream has failed */
+} ParallelBackupState;
+
 typedef struct {
     char* oid;
     char* path;
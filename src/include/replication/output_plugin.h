@@ -29,6 +29,8 @@ typedef enum OutputPluginOutputType {
  */
 typedef struct OutputPluginOptions {
     OutputPluginOutputType output_type;
+    /* stream large transactions before they end, needs the stream callbacks */
+    bool streaming;
 } OutputPluginOptions;
 
 /*
@@ -63,6 +65,30 @@ typedef void (*LogicalDecodeChangeCB)(
  */
 typedef void (*LogicalDecodeCommitCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
+/*
+ * Called before and after each block of changes of a large transaction that
+ * are streamed before the transaction ends. The changes in between are passed
+ * to the change callback. A transaction may be streamed in several blocks,
+ * interleaved with other transactions.
+ */
+typedef void (*LogicalDecodeStreamStartCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+typedef void (*LogicalDecodeStreamStopCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+
+/*
+ * Called when a streamed transaction aborts, so the changes streamed so far
+ * have to be thrown away. abort_lsn is invalid if the transaction was found to
+ * have aborted implicitly, e.g. by a crash of the server.
+ */
+typedef void (*LogicalDecodeStreamAbortCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+
+/*
+ * Called when a streamed transaction commits, after its remaining changes are
+ * streamed as the last block.
+ */
+typedef void (*LogicalDecodeStreamCommitCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
 /*
  * Called to shutdown an output plugin.
  */
@@ -83,6 +109,10 @@ typedef struct OutputPluginCallbacks {
     LogicalDecodeCommitCB commit_cb;
     LogicalDecodeShutdownCB shutdown_cb;
     LogicalDecodeFilterByOriginCB filter_by_origin_cb;
+    LogicalDecodeStreamStartCB stream_start_cb;
+    LogicalDecodeStreamStopCB stream_stop_cb;
+    LogicalDecodeStreamAbortCB stream_abort_cb;
+    LogicalDecodeStreamCommitCB stream_commit_cb;
 } OutputPluginCallbacks;
 
 extern void OutputPluginPrepareWrite(struct LogicalDecodingContext* ctx, bool last_write);
@@ -37,6 +37,9 @@ typedef struct ReorderBufferTupleBuf {
 /* pointer to the data stored in a TupleBuf */
 #define ReorderBufferTupleBufData(p) ((HeapTupleHeader)MAXALIGN(((char*)p) + sizeof(ReorderBufferTupleBuf)))
 
+/* the most sessions decoding can be split over, see parallel_decode_num */
+#define MAX_PARALLEL_DECODE_NUM 64
+
 /*
  * Types of the change passed to a 'change' callback.
  *
@@ -205,6 +208,21 @@ typedef struct ReorderBufferTXN {
      */
     bool serialized;
 
+    /*
+     * Memory used by the changes of this transaction kept in memory, not
+     * counting its subtransactions.
+     */
+    Size size;
+
+    /*
+     * Have some of the changes been streamed to the output plugin before the
+     * transaction ended? If so, the snapshot and command id the decoding
+     * stopped at are kept to continue from there.
+     */
+    bool streamed;
+    Snapshot snapshot_now;
+    CommandId command_id;
+
     /*
      * List of ReorderBufferChange structs, including new Snapshots and new
      * CommandIds
@@ -267,6 +285,14 @@ typedef void (*ReorderBufferBeginCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
 /* commit callback signature */
 typedef void (*ReorderBufferCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
+/* start and stop callback signature of a block of streamed changes */
+typedef void (*ReorderBufferStreamStartCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
+typedef void (*ReorderBufferStreamStopCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
+/* abort and commit callback signature of a streamed transaction */
+typedef void (*ReorderBufferStreamAbortCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+typedef void (*ReorderBufferStreamCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
 struct ReorderBuffer {
     /*
      * xid => ReorderBufferTXN lookup table
@@ -302,6 +328,32 @@ struct ReorderBuffer {
     ReorderBufferApplyChangeCB apply_change;
     ReorderBufferCommitCB commit;
 
+    /*
+     * Callbacks to be called when a large transaction is streamed before it
+     * ends, only used if streaming is set.
+     */
+    bool streaming;
+    ReorderBufferStreamStartCB stream_start;
+    ReorderBufferStreamStopCB stream_stop;
+    ReorderBufferStreamAbortCB stream_abort;
+    ReorderBufferStreamCommitCB stream_commit;
+
+    /*
+     * Decoding can be split by relation over parallel_decode_num sessions,
+     * each on its own slot. Only the changes of relations whose relfilenode
+     * hash modulo parallel_decode_num is parallel_decode_id are passed to the
+     * output plugin, while transaction boundaries are passed by all of them.
+     * A rewrite gives the relation a new relfilenode, and so may move it to
+     * another session.
+     *
+     * decode_relnodes remembers the relfilenodes of the other sessions
+     * already looked up, and whether they are toast relations, so their
+     * changes are skipped without catalog access. See ReorderBufferSkipChange.
+     */
+    uint32 parallel_decode_num;
+    uint32 parallel_decode_id;
+    HTAB* decode_relnodes;
+
     /*
      * Pointer that will be passed untouched to the callbacks.
      */
@@ -336,6 +388,9 @@ struct ReorderBuffer {
 
     XLogRecPtr current_restart_decoding_lsn;
 
+    /* memory used by the changes kept in memory, see logical_decoding_work_mem */
+    Size size;
+
     /* buffer for disk<->memory conversions */
     char* outbuf;
     Size outbufsize;
@@ -61,7 +61,7 @@ typedef enum {
     MODE_REBUILD
 } HaRebuildReason;
 
-typedef enum { NONE_BUILD = 0, AUTO_BUILD, FULL_BUILD, INC_BUILD } BuildMode;
+typedef enum { NONE_BUILD = 0, AUTO_BUILD, FULL_BUILD, INC_BUILD, DELTA_BUILD } BuildMode;
 
 typedef struct buildstate {
     BuildMode build_mode;
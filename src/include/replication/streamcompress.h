@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * streamcompress.h
+ *        compression of the messages of the WAL and data replication streams
+ *
+ * A standby asks for a compressed stream with START_REPLICATION ... COMPRESS
+ * method. The sender then sends the payload of each 'w' (WAL) or 'd' (data
+ * page) message as a 'z' message, made of the header of the original message,
+ * a StreamCompressHeader and the compressed payload. Messages that don't get
+ * smaller are sent as is.
+ *
+ * IDENTIFICATION
+ *        src/include/replication/streamcompress.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef _STREAMCOMPRESS_H
+#define _STREAMCOMPRESS_H
+
+#include "c.h"
+
+typedef enum {
+    STREAM_COMPRESS_NONE = 0,
+    STREAM_COMPRESS_LZ4
+} StreamCompressType;
+
+typedef struct StreamCompressHeader {
+    uint32 rawSize; /* length of the payload before compression */
+} StreamCompressHeader;
+
+/* payloads shorter than this are never compressed */
+#define STREAM_COMPRESS_MIN_SIZE 512
+
+/* name of a compression method for START_REPLICATION and the statistics views */
+extern const char* StreamCompressName(int type);
+/* the method of a name, ereport ERROR if it isn't supported */
+extern StreamCompressType StreamCompressLookup(const char* name);
+
+/* size of the buffer StreamCompress() needs for srclen bytes */
+extern Size StreamCompressBound(Size srclen);
+
+/*
+ * Compress srclen bytes of src into dst, header included. Returns the length
+ * of the result, or 0 if it isn't smaller than src.
+ */
+extern Size StreamCompress(StreamCompressType type, const char* src, Size srclen, char* dst);
+
+/*
+ * Decompress a payload made by StreamCompress() into *buf, which is enlarged
+ * as needed. Returns the length of the raw payload, ereport ERROR if it is
+ * corrupted.
+ */
+extern Size StreamDecompress(const char* src, Size srclen, char** buf, Size* bufsize);
+
+#endif /* _STREAMCOMPRESS_H */
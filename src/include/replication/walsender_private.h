@@ -14,6 +14,7 @@
 
 #include "access/xlog.h"
 #include "nodes/nodes.h"
+#include "replication/basebackup.h"
 #include "replication/replicainternal.h"
 #include "replication/syncrep.h"
 #include "replication/repl_gramparse.h"
@@ -95,6 +96,16 @@ typedef struct WalSnd {
     ReplConnInfo wal_sender_channel;
     int channel_get_replc;
 
+    /*
+     * Compression of the WAL stream, and the WAL sent before and after
+     * compression. sendThroughput is the raw WAL sent per second, refreshed
+     * about once a second.
+     */
+    int compression;
+    uint64 sentRawBytes;
+    uint64 sentWireBytes;
+    uint64 sendThroughput;
+
     /* Protects shared variables shown above. */
     slock_t mutex;
 
@@ -157,6 +168,9 @@ typedef struct WalSndCtlData {
      */
     DemoteMode demotion;
 
+    /* Streams of the running parallel base backup. Protected by mutex. */
+    ParallelBackupState parallelBackup;
+
     /* Protects shared variables of all walsnds. */
     slock_t mutex;
 
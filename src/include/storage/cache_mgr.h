@@ -55,6 +55,16 @@ const int CACHE_BLOCK_NO_LIST = -2;      // Invalid index -not in any list
 // Max usage count for CLOCK cache strategy
 const uint16 CACHE_BLOCK_MAX_USAGE = 5;
 
+/*
+ * Frequency sketch of the requested cache blocks, used to admit blocks into the
+ * CLOCK with a usage count by how often they are requested. It is a count-min
+ * sketch whose counters are halved after every CACHE_SKETCH_SAMPLE_FACTOR times
+ * slots requests, so it remembers blocks for a while after they are evicted.
+ */
+const int CACHE_SKETCH_DEPTH = 4;
+const uint8 CACHE_SKETCH_MAX_FREQ = 15;
+const int CACHE_SKETCH_SAMPLE_FACTOR = 10;
+
 /* common buffer cache function for cu cache and orc cache */
 #define MAX_CACHE_TAG_LEN (32)
 
@@ -232,6 +242,11 @@ private:
     void AllocateBlockFromCacheWithSlotId(CacheSlotId_t slotId);
     void WaitEvictSlot(CacheSlotId_t slotId);
 
+    /* frequency sketch */
+    uint8 RecordCacheBlockRequest(uint32 hashCode);
+    uint16 GetAdmittedUsageCount(uint8 freq) const;
+    void AgeCacheSketch();
+
     MgrCacheType m_cache_type;
     HTAB *m_hash;
     uint32 m_slot_length;
@@ -254,6 +269,12 @@ private:
 
     /* protect memory size counter */
     slock_t m_memsize_lock;
+
+    /* CACHE_SKETCH_DEPTH rows of counters, not locked since the counts are estimated anyway */
+    uint8 *m_sketch;
+    uint32 m_sketch_mask;
+    uint32 m_sketch_sample;
+    pg_atomic_uint32 m_sketch_requests;
 };
 
 #endif  // define
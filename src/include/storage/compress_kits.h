@@ -356,6 +356,62 @@ private:
     DicData m_dictData;
 };
 
+// FSST (Fast Static Symbol Table) compress && decompress
+//
+// A table of at most 255 symbols of 1~8 bytes is learned from a sample of the
+// input, and every symbol found in the input is replaced by its 1 byte code.
+// Bytes not covered by any symbol are written after the escape code. Unlike
+// lz4/zlib the output is decoded by one table lookup per code, which makes it
+// fast to decompress strings with too many distinct values for a dictionary.
+//
+class FSSTCoder : public BaseObject {
+public:
+    static const int fsst_max_symbols = 255;
+    static const int fsst_max_symbol_len = 8;
+    static const uint8 fsst_escape_code = 255;
+
+    /*
+     * Compressed data: this header, the length of each symbol, the bytes of
+     * all symbols and then the codes.
+     */
+    typedef struct FSSTHeader {
+        uint32 rawLen;
+        uint8 symbolsCount;
+        uint8 lens[FLEXIBLE_ARRAY_MEMBER];
+    } FSSTHeader;
+
+public:
+    FSSTCoder() : m_symbolsCount(0)
+    {}
+    virtual ~FSSTCoder()
+    {}
+
+    void BuildSymbolTable(const char* inBuf, int inSize);
+    int Compress(const char* inBuf, int inSize, char* outBuf, int outSize);
+
+    int DecompressGetBound(const char* inBuf) const;
+    int Decompress(const char* inBuf, int inSize, char* outBuf, int outSize);
+
+private:
+#define SizeOfFSSTHeader offsetof(FSSTCoder::FSSTHeader, lens)
+
+    inline int FindSymbol(const char* inBuf, int remain) const;
+    void SetSymbols(const uint64* symbols, const uint8* lens, int count);
+
+private:
+    /* symbol bytes are kept in the low bytes of uint64 as in memory */
+    uint64 m_symbols[fsst_max_symbols];
+    uint8 m_lens[fsst_max_symbols];
+    int m_symbolsCount;
+
+    /*
+     * codes sorted by their first byte and then by length descending, the
+     * codes beginning with byte b are m_sorted[m_firstByte[b], m_firstByte[b + 1])
+     */
+    uint8 m_sorted[fsst_max_symbols];
+    uint16 m_firstByte[257];
+};
+
 // LZ4 && LZ4 HC compress and decompress
 //
 class LZ4Wrapper : public BaseObject {
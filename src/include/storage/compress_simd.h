@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * compress_simd.h
+ *        vectorized kernels for decoding CU values
+ *
+ * These kernels never call into the backend, so that they can be linked into
+ * a standalone micro-benchmark. SSE4.1 is the baseline of x86 build, and AVX2
+ * is chosen at runtime if the cpu supports it. NEON is used on aarch64.
+ *
+ * IDENTIFICATION
+ *        src/include/storage/compress_simd.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#ifndef COMPRESS_SIMD_H
+#define COMPRESS_SIMD_H
+
+#include "c.h"
+
+/*
+ * SimdUnpackAddSupported
+ *    whether values of inSize bytes can be widened to outSize bytes by SimdUnpackAdd.
+ *    inSize and outSize are 1, 2, 4 or 8 bytes, and inSize isn't bigger than outSize.
+ */
+#define SimdUnpackAddSupported(inSize, outSize)                                                        \
+    (((inSize) == 1 || (inSize) == 2 || (inSize) == 4) &&                                              \
+        ((outSize) == 1 || (outSize) == 2 || (outSize) == 4 || (outSize) == 8) && (inSize) <= (outSize))
+
+/* whether SimdFindMarker() and SimdFillValues() support values of this size */
+#define SimdValueSizeSupported(valSize) ((valSize) == 1 || (valSize) == 2 || (valSize) == 4 || (valSize) == 8)
+
+/*
+ * widen nvals unsigned values of inSize bytes in inbuf to outSize bytes and add
+ * base to each of them, which is the frame of reference decoding. the result
+ * wraps around within outSize bytes.
+ */
+extern void SimdUnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base);
+
+/* write value nvals times into outbuf, each of valSize bytes */
+extern void SimdFillValues(char* outbuf, int nvals, short valSize, int64 value);
+
+/*
+ * return the index of the first value in inbuf whose bytes all equal to
+ * markerByte, or nvals if there is not such a value.
+ */
+extern int SimdFindMarker(const char* inbuf, int nvals, short valSize, uint8 markerByte);
+
+/* name of the instruction set the kernels are running with */
+extern const char* SimdDecodeInstructionSet(void);
+
+/* scalar implementations, used for odd value sizes and as the reference of micro-benchmark */
+extern void ScalarUnpackAdd(const char* inbuf, char* outbuf, int nvals, short inSize, short outSize, int64 base);
+extern int ScalarFindMarker(const char* inbuf, int nvals, short valSize, uint8 markerByte);
+
+#endif /* COMPRESS_SIMD_H */
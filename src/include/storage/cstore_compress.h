@@ -36,6 +36,7 @@
 #define CU_CompressExtend 0x0004    // Used for extended compression
 #define CU_Delta2Compressed 0x0005  // CU_Delta2Compressed equals CU_CompressExtend plus 0x0001
 #define CU_XORCompressed 0x0006     // CU_XORCompressed equals CU_CompressExtend plus 0x0002
+#define CU_FSSTCompressed 0x0007    // CU_FSSTCompressed equals CU_CompressExtend plus 0x0003
 #define CU_RLECompressed 0x0008
 #define CU_LzCompressed 0x0010
 #define CU_ZlibCompressed 0x0020
@@ -48,6 +49,9 @@ extern void Int64DataConvertTo(_in_ int64 inVal, _in_ short eachValSize, _out_ c
 
 #define GLOBAL_DICT_SIZE 4096
 
+/* extended compression methods share the low bits, so they must be compared as a whole */
+#define CU_MODE_IS_FSST(_modes) (CU_FSSTCompressed == ((_modes) & 0x000F))
+
 /* compression filter.
  * step 1: sample. use the first CU data to sample, and detect
  *         what compression methods to adopt;
@@ -66,12 +70,41 @@ struct compression_options {
     /* common flags */
     bool m_adopt_dict; /* Dictionary encoding */
     bool m_adopt_rle;  /* RLE encoding */
+    bool m_adopt_fsst; /* FSST encoding for strings */
 
     void reset(void);
     void set_numeric_flags(uint16 modes);
     void set_common_flags(uint32 modes);
 };
 
+/*
+ * The LZ4/zlib step a codec leaves over when the CUs of a load are compressed
+ * by several threads, see CStoreInsert::CompressCUsInParallel(). The codec
+ * fills it in the backend. RunGeneralCompress() neither allocates from memory
+ * contexts nor reports errors, so it may run in any thread, and
+ * FinishGeneralCompress() completes the output of the codec in the backend.
+ */
+typedef struct GeneralCompressTask {
+    bool pending;       /* set by the codec, LZ4/zlib is still to run */
+    bool useZlib;
+    int level;
+    char* src;          /* data to compress, valid until finished */
+    int srcSize;
+    BufferHelper dst;   /* buffer of the compress bound for the result */
+    char* out;          /* output of the codec */
+    uint16 modes;       /* modes of the codec output before LZ4/zlib */
+    uint16 generalMode; /* CU_LzCompressed or CU_ZlibCompressed */
+    int prefixSize;     /* bytes put in front of the output when finished */
+    char prefix[16];    /* min/max of the delta compression */
+    int cmprSize;       /* result size, 0 if not compressed */
+    int errCode;        /* zlib error, Z_OK if none */
+} GeneralCompressTask;
+
+extern void DeferGeneralCompress(
+    GeneralCompressTask* task, bool useZlib, int level, char* src, int srcSize, char* out, uint16 modes);
+extern void RunGeneralCompress(GeneralCompressTask* task);
+extern int FinishGeneralCompress(GeneralCompressTask* task, uint16* modes);
+
 // input arguments for compression &&
 // output arguments for decompression
 //
@@ -91,6 +124,10 @@ typedef struct {
     bool useDict;
     bool useGlobalDict;
     bool buildGlobalDict;
+    /* whether to try FSST, which is only for var-length strings */
+    bool useFSST;
+    /* if not NULL, LZ4/zlib may be left to it, see GeneralCompressTask */
+    GeneralCompressTask* task;
 } CompressionArg1;
 
 // output arguments for compression &&
@@ -137,7 +174,9 @@ public:
     virtual ~StringCoder()
     {}
 
-    StringCoder() : m_adopt_rle(true), m_adopt_dict(true), m_dicCodes(NULL), m_dicCodesNum(0)
+    StringCoder()
+        : m_adopt_rle(true), m_adopt_dict(true), m_adopt_fsst(true), m_fsst_only(false), m_dicCodes(NULL),
+          m_dicCodesNum(0)
     {}
 
     int Compress(_in_ CompressionArg1& in, _in_ CompressionArg2& out);
@@ -146,6 +185,9 @@ public:
     /* optimizing flags */
     bool m_adopt_rle;
     bool m_adopt_dict;
+    bool m_adopt_fsst;
+    /* FSST has won the sampling, so skip comparing it with lz4/zlib */
+    bool m_fsst_only;
 
 private:
     /* inner implement for compress api */
@@ -159,6 +201,8 @@ private:
     int DecompressWithoutDict(
         _in_ char* inBuf, _in_ int inBufSize, _in_ uint16 mode, _out_ char* outBuf, _out_ int outBufSize);
 
+    int CompressWithFSST(_in_ char* inBuf, _in_ int inBufSize, _out_ char* outBuf, _in_ int outBufSize);
+
     int CompressNumbers(
         _in_ int max, _in_ int compressing_modes, __inout char* outBuf, _in_ int outBufSize, _out_ uint16& mode);
     void DecompressNumbers(
@@ -102,6 +102,9 @@ const uint8 NumberOfBit1Set[256] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3,
     4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5,
     5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8};
 
+struct CUSummary;
+struct GeneralCompressTask;
+
 struct CUDesc : public BaseObject {
     TransactionId xmin;
     /*
@@ -148,6 +151,12 @@ struct CUDesc : public BaseObject {
      */
     uint32 magic;
 
+    /*
+     * Bloom filter and value counts of CU, only loaded for rough check.
+     * NULL if the column has no summary or it is not needed.
+     */
+    CUSummary* cu_summary;
+
 public:
     CUDesc();
     ~CUDesc();
@@ -325,9 +334,15 @@ public:
     //
     int16 GetCUHeaderSize(void) const;
     void Compress(int valCount, int16 compress_modes);
+    void AllocCompressBuf(void);
+    void CompressToBuf(int valCount, int16 compress_modes);
+    void BeginCompressToBuf(int valCount, int16 compress_modes, GeneralCompressTask* task);
+    void EndCompressToBuf(GeneralCompressTask* task);
+    void FinishCompressToBuf(char* buf, int compressOutSize, uint16 modes);
     void FillCompressBufHeader(void);
     char* CompressNullBitmapIfNeed(_in_ char* buf);
-    bool CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compressOption);
+    int CompressData(
+        _out_ char* outBuf, _in_ int nVals, _in_ int16 compressOption, GeneralCompressTask* task, _out_ uint16* modes);
 
     // Uncompress data
     //
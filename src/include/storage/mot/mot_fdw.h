@@ -38,6 +38,12 @@ extern void TermMOT();
  */
 extern void MOTRecover();
 
+/**
+ * @brief Waits until the redo recovery workers have replayed all the MOT log received so far.
+ * Should be called once the envelope has replayed all of the XLOG, before the end of recovery checkpoint.
+ */
+extern void MOTRedoDone();
+
 /**
  * @brief Cleans up the resources and finishes the recovery.
  * Should be called at the end of recovery in the envelop.
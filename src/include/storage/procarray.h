@@ -42,6 +42,7 @@ extern char dump_memory_context_name[MEMORY_CONTEXT_NAME_LEN];
 extern void DumpMemoryCtxOnBackend(ThreadId tid, const char* mem_ctx);
 extern void ProcArrayInitRecovery(TransactionId initializedUptoXID);
 extern void ProcArrayApplyRecoveryInfo(RunningTransactions running);
+extern void ProcArrayPublishStandbySnapshot(void);
 
 extern int GetMaxSnapshotXidCount(void);
 extern int GetMaxSnapshotSubxidCount(void);
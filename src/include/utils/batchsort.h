@@ -49,6 +49,17 @@ typedef enum {
     BS_FINALMERGE
 } BatchSortStatus;
 
+/*
+ * Kinds of leading sort key that could be sorted by radix sort.
+ */
+typedef enum {
+    RADIX_KEY_NONE = 0,
+    RADIX_KEY_INT16,
+    RADIX_KEY_INT32,
+    RADIX_KEY_INT64,
+    RADIX_KEY_UINT32
+} RadixSortKeyKind;
+
 /*
  * Private state of a batchsort operation.
  */
@@ -205,6 +216,12 @@ public:
     char* jitted_CompareMultiColumn;      /* jitted function for CompareMultiColumn  */
     char* jitted_CompareMultiColumn_TOPN; /* jitted function for CompareMultiColumn used by Top N sort */
 
+    /*
+     * Input row referred in place to be checked against the top of the
+     * bounded heap before it is copied, only the sort key columns are set.
+     */
+    MultiColumns m_boundProbe;
+
     /*
      * Initialize variables.
      */
@@ -219,6 +236,14 @@ public:
 
     void SortInMem();
 
+    /*
+     * Radix sort on normalized keys of the leading sort key, used by
+     * SortInMem when enable_vector_radix_sort is on.
+     */
+    RadixSortKeyKind GetRadixKeyKind();
+
+    void RadixSortInMem(RadixSortKeyKind kind);
+
     int GetSortMergeOrder();
 
     void InitTapes();
@@ -267,6 +292,32 @@ public:
 
     void SortBoundedHeap();
 
+    /*
+     * Check whether the row of batch could replace the top of the bounded
+     * heap. The sort keys of the row are compared in place, so the rows that
+     * can not enter the heap are never copied.
+     */
+    bool BoundedHeapAccept(VectorBatch* batch, int row)
+    {
+        ScanKey scanKey = m_scanKeys;
+
+        for (int nkey = 0; nkey < m_nKeys; ++nkey, ++scanKey) {
+            int colIdx = scanKey->sk_attno - 1;
+            uint8 flag = batch->m_arr[colIdx].m_flag[row];
+            ScalarValue val = batch->m_arr[colIdx].m_vals[row];
+
+            m_boundProbe.m_nulls[colIdx] = flag;
+            if (IS_NULL(flag))
+                m_boundProbe.m_values[colIdx] = (Datum)0;
+            else if (NeedDecode(colIdx))
+                m_boundProbe.m_values[colIdx] = ScalarVector::Decode(val);
+            else
+                m_boundProbe.m_values[colIdx] = PointerGetDatum(val);
+        }
+
+        return compareMultiColumn(&m_boundProbe, m_storeColumns.m_memValues, this) > 0;
+    }
+
     void DumpUnsortColumns(bool all);
 
     /*
@@ -341,6 +392,8 @@ extern Batchsortstate* batchsort_begin_merge(TupleDesc tupDesc, int nkeys, AttrN
 
 extern void batchsort_set_bound(Batchsortstate* state, int64 bound);
 
+extern bool batchsort_get_bound_value(Batchsortstate* state, Datum* value, bool* isnull);
+
 /*
  * abbreSortOptimize used to mark whether allocate one more Datum for
  * fast compare of two data(text or numeric type)
@@ -350,6 +403,13 @@ void putbatch(Batchsortstate* state, VectorBatch* batch, int start, int end)
 {
     int64 memorySize = 0;
     for (int row = start; row < end; ++row) {
+        /*
+         * Once a top-N sort has built its heap, most of the input rows can not
+         * beat the top of it, throw them away before they are copied.
+         */
+        if (!abbrevSortOptimize && state->m_status == BS_BOUNDED && !state->BoundedHeapAccept(batch, row))
+            continue;
+
         MultiColumns multiColumn = state->CopyMultiColumn<abbrevSortOptimize>(batch, row);
 
         if (abbrevSortOptimize) {
@@ -492,7 +552,9 @@ void putbatch(Batchsortstate* state, VectorBatch* batch, int start, int end)
 
             case BS_BOUNDED:
 
-                if (state->compareMultiColumn(&multiColumn, state->m_storeColumns.m_memValues, state) <= 0) {
+                /* without abbreviation the row has been checked by BoundedHeapAccept */
+                if (abbrevSortOptimize &&
+                    state->compareMultiColumn(&multiColumn, state->m_storeColumns.m_memValues, state) <= 0) {
                     state->FreeMultiColumn(&multiColumn);
                 } else {
                     state->FreeMultiColumn(state->m_storeColumns.m_memValues);
@@ -306,6 +306,8 @@ typedef struct StdRdOptions {
     char* start_ctid_internal;
     char* end_ctid_internal;
     char        *merge_list;
+    char* bloom_filter_columns; /* column table only, columns to form CU bloom filter */
+    char* cluster_order;        /* column table only, order of rows sorted by partial cluster key */
 } StdRdOptions;
 
 #define HEAP_MIN_FILLFACTOR 10
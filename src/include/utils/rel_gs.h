@@ -166,6 +166,9 @@ typedef struct RelationMetaData {
 #define COMPRESSION_SNAPPY "snappy"
 #define COMPRESSION_LZ4 "lz4"
 
+#define CLUSTER_ORDER_LEXICAL "lexical"
+#define CLUSTER_ORDER_ZORDER "zorder"
+
 #define FILESYSTEM_GENERAL "general"
 #define FILESYSTEM_HDFS "hdfs"
 
@@ -289,6 +292,13 @@ static inline RedisHtlAction RelationGetAppendMode(Relation rel)
 //
 #define RelationGetCompression(relation) StdRdOptionsGetStringData((relation)->rd_options, compression, COMPRESSION_LOW)
 
+// RelationClusterInZOrder
+//    Return whether the partial cluster key sorts rows in Z-order of its columns
+//
+#define RelationClusterInZOrder(relation) \
+    (0 == pg_strcasecmp(CLUSTER_ORDER_ZORDER,  \
+              StdRdOptionsGetStringData((relation)->rd_options, cluster_order, CLUSTER_ORDER_LEXICAL)))
+
 // make sure that:
 // 1. RelDefaultFullCuSize = N * BatchMaxSize
 // 2. RelDefaultPartialClusterRows = M * RelDefaultFullCuSize
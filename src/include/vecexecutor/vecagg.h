@@ -42,6 +42,17 @@ extern void ExecEarlyFreeVecAggregation(VecAggState* node);
 #define AGG_RETURN_LAST 4
 #define AGG_RETURN_NULL 5
 
+/*
+ * Adaptive hash agg: the reduction ratio is checked after the sample rows,
+ * and streaming is used when the groups exceed the ratio of the input rows.
+ * The streaming hash table is limited to about the size of L2 cache.
+ */
+#define ADAPTIVE_AGG_SAMPLE_ROWS (64 * BatchMaxSize)
+#define ADAPTIVE_AGG_STREAM_RATIO 0.5
+#define ADAPTIVE_AGG_CACHE_SIZE (1024 * 1024L)
+
+extern bool ExecVecAggIsAdaptive(VecAggState* node);
+
 struct finalAggInfo {
     int idx;
     VecAggInfo* info;
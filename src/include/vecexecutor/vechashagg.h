@@ -82,6 +82,11 @@ private:
 
     void Profile(char* stats, bool* can_wlm_warning_statistics);
 
+    /* adaptive hash agg, see notes in Build() */
+    void JudgeTableFull();
+    void AdaptiveCheck();
+    void ResetHashTable(int64 hash_size);
+
 private:
     /* Some status log.*/
     AggStateLog m_statusLog;
@@ -104,6 +109,18 @@ private:
     int64 m_hashSize;                 /* total hash size */
     void (HashAggRunner::*m_buildFun)(VectorBatch* batch);
     int m_spill_times; /* spill time */
+
+    /*
+     * Adaptive hash agg. Only for the lower agg of a two-level aggregation,
+     * the groups are flushed to the upper agg instead of spilled to disk.
+     */
+    bool m_adaptive;      /* adaptive hash agg is used */
+    bool m_streaming;     /* low reduction found, use cache-sized hash table */
+    bool m_sampled;       /* reduction ratio has been checked on the sample */
+    bool m_flushPending;  /* hash table is full, flush it before building more */
+    int64 m_flushRows;    /* max groups in streaming mode */
+    int64 m_inputRows;    /* input rows since the hash table was reset */
+    int m_flushTimes;     /* times of flushing the hash table */
 };
 
 #endif
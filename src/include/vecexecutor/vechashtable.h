@@ -424,6 +424,9 @@ public:
     /* judge memory allow table expnd */
     bool JudgeMemoryAllowExpand();
 
+    /* judge memory full without spilling */
+    bool JudgeMemoryFull(int dop);
+
     // free memory context.
     void freeMemoryContext();
 
@@ -206,6 +206,21 @@ typedef struct CStoreScanRunTimeKeyInfo {
     ExprState* key_expr;
 } CStoreScanRunTimeKeyInfo;
 
+/*
+ * Boundary of a top-N VecSort published to the CStoreScan right below it.
+ * Once the bounded heap of the sort is full, a CU whose min/max of the
+ * leading sort key can not beat the boundary is skipped before it is loaded.
+ */
+typedef struct CStoreScanTopNBound {
+    AttrNumber attno; /* relation attribute of the leading sort key */
+    int strategy;     /* CStoreLess(Equal)StrategyNumber for ASC, CStoreGreater(Equal)StrategyNumber for DESC */
+    Oid collation;
+    bool nullsFirst;
+    bool valid; /* heap of the sort is full, value is its current boundary */
+    bool isnull;
+    Datum value;
+} CStoreScanTopNBound;
+
 typedef struct CStoreScanState : ScanState {
     Relation ss_currentDeltaRelation;
     Relation ss_partition_parent;
@@ -232,6 +247,12 @@ typedef struct CStoreScanState : ScanState {
     vecqual_func jitted_vecqual;
 
     bool m_isReplicaTable; /* If it is a replication table? */
+
+    CStoreScanTopNBound* m_topnBound; /* set by the top-N VecSort above, if any */
+
+    List* m_residualQual; /* qual except the clauses of csss_ScanKeys */
+    List* m_earlyQual;    /* clauses of csss_ScanKeys, evaluated before reading m_lateQualVars */
+    List* m_lateQualVars; /* attnos only referenced by m_residualQual, read after m_earlyQual */
 } CStoreScanState;
 
 typedef struct DfsScanState : ScanState {
@@ -387,4 +408,20 @@ typedef struct VecMaterialState : public MaterialState {
     bool from_memory;
 } VecMaterialState;
 
+typedef struct VecMergeAppendState : public MergeAppendState {
+    VectorBatch** ms_batches; /* current input batch of each subplan, NULL once exhausted */
+    int* ms_cursors;          /* next unread row of each input batch */
+    int* ms_tree;             /* loser tree over the subplans, ms_tree[0] is the winner */
+    VectorBatch* m_pCurrentBatch;
+} VecMergeAppendState;
+
+typedef struct VecRecursiveUnionState : public RecursiveUnionState {
+    BatchStore* working_batchstore;      /* working table, scanned by the recursive term */
+    BatchStore* intermediate_batchstore; /* output of the current iteration */
+} VecRecursiveUnionState;
+
+typedef struct VecWorkTableScanState : public WorkTableScanState {
+    VectorBatch* m_pScanBatch;
+} VecWorkTableScanState;
+
 #endif /* VECNODES_H_ */
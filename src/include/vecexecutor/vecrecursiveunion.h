@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ * 
+ * vecrecursiveunion.h
+ * 
+ * 
+ * IDENTIFICATION
+ *        src/include/vecexecutor/vecrecursiveunion.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#ifndef NODEVECRECURSIVEUNION_H
+#define NODEVECRECURSIVEUNION_H
+
+#include "vecexecutor/vecnodes.h"
+
+extern VecRecursiveUnionState* ExecInitVecRecursiveUnion(VecRecursiveUnion* node, EState* estate, int eflags);
+extern VectorBatch* ExecVecRecursiveUnion(VecRecursiveUnionState* node);
+extern void ExecEndVecRecursiveUnion(VecRecursiveUnionState* node);
+extern void ExecReScanVecRecursiveUnion(VecRecursiveUnionState* node);
+
+#endif /* NODEVECRECURSIVEUNION_H */
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ * 
+ * vecworktablescan.h
+ * 
+ * 
+ * IDENTIFICATION
+ *        src/include/vecexecutor/vecworktablescan.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#ifndef NODEVECWORKTABLESCAN_H
+#define NODEVECWORKTABLESCAN_H
+
+#include "vecexecutor/vecnodes.h"
+
+extern VecWorkTableScanState* ExecInitVecWorkTableScan(VecWorkTableScan* node, EState* estate, int eflags);
+extern VectorBatch* ExecVecWorkTableScan(VecWorkTableScanState* node);
+extern void ExecEndVecWorkTableScan(VecWorkTableScanState* node);
+extern void ExecReScanVecWorkTableScan(VecWorkTableScanState* node);
+
+#endif /* NODEVECWORKTABLESCAN_H */
@@ -100,6 +100,13 @@ private:
 
     bool judgeMemoryAllowExpand();
 
+    /* adaptive hash agg, see notes in Build() */
+    void judgeTableFull(int dop, int64 size_needed);
+
+    void adaptiveCheck();
+
+    void resetHashTable(int64 hashSize);
+
     /* calculate hash table size */
     template <bool expand, bool logit>
     int64 calcHashTableSize(int64 oldSize);
@@ -280,6 +287,30 @@ private:
 
     /* handle duplicate, record the orginial the location. */
     uint32 m_orgLoc[BatchMaxSize];
+
+    /*
+     * Adaptive hash agg. Only for the lower agg of a two-level aggregation,
+     * the groups are flushed to the upper agg instead of spilled to disk.
+     */
+    bool m_adaptive;
+
+    /* low reduction found, use cache-sized hash table */
+    bool m_streaming;
+
+    /* reduction ratio has been checked on the sample */
+    bool m_sampled;
+
+    /* hash table is full, flush it before building more */
+    bool m_flushPending;
+
+    /* max groups in streaming mode */
+    int64 m_flushRows;
+
+    /* input rows since the hash table was reset */
+    int64 m_inputRows;
+
+    /* times of flushing the hash table */
+    int m_flushTimes;
 };
 
 extern bool isExprSonicEnable(Expr* node);
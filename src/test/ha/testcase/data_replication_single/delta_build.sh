@@ -0,0 +1,79 @@
+#!/bin/sh
+# stop the standby, change the primary while it lags behind, then delta build
+# the standby and check it replays and streams the primary's data again
+
+source ./standby_env.sh
+
+function check_standby_data()
+{
+if [ $(gsql -d $db -p $dn1_standby_port -m -c "select count(*), count(nullif(c2, 'before')) from delta_build_t1;" | grep -E "20000 \| +11000" | wc -l) -eq 1 ] && \
+	[ $(gsql -d $db -p $dn1_standby_port -m -c "select count(*) from delta_build_t2;" | grep -w 5000 | wc -l) -eq 1 ] && \
+	[ $(gsql -d $db -p $dn1_standby_port -m -c "select count(*) from delta_build_t3;" | grep -w 100 | wc -l) -eq 1 ]; then
+	echo "$1 on dn1_standby"
+else
+	echo "$1 $failed_keyword on dn1_standby"
+	exit 1
+fi
+}
+
+function test_1()
+{
+check_instance
+
+gs_guc reload -D $primary_data_dir -c "enable_cbm_tracking=on"
+sleep 5
+
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists delta_build_t1; DROP TABLE if exists delta_build_t2; DROP TABLE if exists delta_build_t3;
+create table delta_build_t1(c1 int, c2 text);
+insert into delta_build_t1 select generate_series(1, 10000), 'before';
+create table delta_build_t3(c1 int, c2 text);
+insert into delta_build_t3 select generate_series(1, 100000), repeat('x', 100);"
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+wait_catchup_finish
+
+# the standby lags behind while old blocks are updated, the table is extended,
+# a relation is added and another one is truncated by vacuum
+stop_standby
+gsql -d $db -p $dn1_primary_port -c "update delta_build_t1 set c2 = 'after' where c1 % 10 = 0;
+insert into delta_build_t1 select generate_series(10001, 20000), 'after';
+create table delta_build_t2 as select generate_series(1, 5000) as c1;
+delete from delta_build_t3 where c1 > 100;"
+gsql -d $db -p $dn1_primary_port -c "vacuum delta_build_t3;"
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+
+gs_ctl build -D $standby_data_dir -b delta > ./results/delta_build.log 2>&1
+if [ $? -ne 0 ]; then
+	echo "delta build $failed_keyword"
+	exit 1
+fi
+if [ $(grep "do full build instead" ./results/delta_build.log | wc -l) -ne 0 ]; then
+	echo "delta build fell back to full build $failed_keyword"
+	exit 1
+fi
+
+# replays up to the backup end and streams again
+check_replication_setup
+wait_catchup_finish
+sleep 5
+check_standby_data "delta build"
+
+gsql -d $db -p $dn1_primary_port -c "insert into delta_build_t2 select generate_series(5001, 6000);"
+wait_catchup_finish
+sleep 5
+if [ $(gsql -d $db -p $dn1_standby_port -m -c "select count(*) from delta_build_t2;" | grep -w 6000 | wc -l) -eq 1 ]; then
+	echo "streaming after delta build on dn1_standby"
+else
+	echo "streaming after delta build $failed_keyword on dn1_standby"
+	exit 1
+fi
+}
+
+function tear_down()
+{
+sleep 1
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists delta_build_t1; DROP TABLE if exists delta_build_t2; DROP TABLE if exists delta_build_t3;"
+gs_guc reload -D $primary_data_dir -c "enable_cbm_tracking=off"
+}
+
+test_1
+tear_down
@@ -0,0 +1,84 @@
+#!/bin/sh
+# full gs_basebackup, then merge an incremental one (-i) into it and
+# check the merged directory starts with the primary's data
+
+source ./standby_env.sh
+
+backup_dir=$data_dir/incremental_backup
+
+function label_start_lsn()
+{
+grep "START WAL LOCATION" $backup_dir/backup_label | awk '{print $4}'
+}
+
+function test_1()
+{
+check_instance
+
+gs_guc reload -D $primary_data_dir -c "enable_cbm_tracking=on"
+gs_guc reload -D $primary_data_dir -h "host replication $username 127.0.0.1/32 trust"
+sleep 5
+
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists incr_bb_t1; DROP TABLE if exists incr_bb_t2;
+create table incr_bb_t1(c1 int, c2 text);
+insert into incr_bb_t1 select generate_series(1, 10000), 'before';"
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+
+rm -rf $backup_dir
+gs_basebackup -D $backup_dir -h 127.0.0.1 -p $dn1_primary_port -Fp -Xs > ./results/incremental_basebackup.log 2>&1
+if [ $? -ne 0 ]; then
+	echo "full backup $failed_keyword"
+	exit 1
+fi
+start_lsn=$(label_start_lsn)
+
+# update old blocks, extend the table and add a new relation
+gsql -d $db -p $dn1_primary_port -c "update incr_bb_t1 set c2 = 'after' where c1 % 10 = 0;
+insert into incr_bb_t1 select generate_series(10001, 20000), 'after';
+create table incr_bb_t2 as select generate_series(1, 5000) as c1;"
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+
+# a start location past the previous backup's must be refused
+gs_basebackup -D $backup_dir -h 127.0.0.1 -p $dn1_primary_port -Fp -Xs -i FFFFFFFF/0 >> ./results/incremental_basebackup.log 2>&1
+if [ $? -eq 0 ]; then
+	echo "incremental backup past previous start location $failed_keyword"
+	exit 1
+fi
+
+gs_basebackup -D $backup_dir -h 127.0.0.1 -p $dn1_primary_port -Fp -Xs -i $start_lsn >> ./results/incremental_basebackup.log 2>&1
+if [ $? -ne 0 ]; then
+	echo "incremental backup $failed_keyword"
+	exit 1
+fi
+
+# start the merged backup alone, away from the replication ports
+sed -i "/^replconninfo/d" $backup_dir/postgresql.conf
+$bin_dir/gaussdb --single_node -M normal -p $dn_temp_port -D $backup_dir > ./results/gaussdb.log 2>&1 &
+sleep 10
+
+if [ $(gsql -d $db -p $dn_temp_port -m -c "select count(*), count(nullif(c2, 'before')) from incr_bb_t1;" | grep -E "20000 \| +11000" | wc -l) -eq 1 ]; then
+	echo "incremental backup merged incr_bb_t1"
+else
+	echo "incremental backup merge $failed_keyword on incr_bb_t1"
+	exit 1
+fi
+
+if [ $(gsql -d $db -p $dn_temp_port -m -c "select count(*) from incr_bb_t2;" | grep 5000 | wc -l) -eq 1 ]; then
+	echo "incremental backup merged incr_bb_t2"
+else
+	echo "incremental backup merge $failed_keyword on incr_bb_t2"
+	exit 1
+fi
+}
+
+function tear_down()
+{
+sleep 1
+$bin_dir/gs_ctl stop -D $backup_dir -m fast > ./results/gs_ctl.log 2>&1
+rm -rf $backup_dir
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists incr_bb_t1; DROP TABLE if exists incr_bb_t2;"
+gs_guc reload -D $primary_data_dir -c "enable_cbm_tracking=off"
+}
+
+test_1
+tear_down
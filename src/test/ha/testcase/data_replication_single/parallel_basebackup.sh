@@ -0,0 +1,73 @@
+#!/bin/sh
+# full build of the standby and gs_basebackup, both received in parallel
+# LZ4-compressed streams, then check the results start with the primary's data
+
+source ./standby_env.sh
+
+backup_dir=$data_dir/parallel_backup
+
+function check_counts()
+{
+port=$1
+what=$2
+if [ $(gsql -d $db -p $port -m -c "select count(*) from par_bb_t1;" | grep 30000 | wc -l) -eq 1 ] && \
+	[ $(gsql -d $db -p $port -m -c "select count(*), sum(c1) from par_bb_t2;" | grep -E "20000 \| +200010000" | wc -l) -eq 1 ]; then
+	echo "$what restored par_bb_t1 and par_bb_t2"
+else
+	echo "$what $failed_keyword on par_bb_t1 or par_bb_t2"
+	exit 1
+fi
+}
+
+function test_1()
+{
+check_instance
+
+gs_guc reload -D $primary_data_dir -h "host replication $username 127.0.0.1/32 trust"
+sleep 5
+
+# enough relations and segments for the files to be spread over the streams
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists par_bb_t1; DROP TABLE if exists par_bb_t2;
+create table par_bb_t1(c1 int, c2 text);
+insert into par_bb_t1 select generate_series(1, 30000), repeat('parallel', 20);
+create table par_bb_t2(c1 int, c2 int) with (orientation = column);
+insert into par_bb_t2 select generate_series(1, 20000), 1;"
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+
+# full build of the standby in 4 streams
+kill_standby
+gs_ctl build -D $standby_data_dir -b full --jobs=4 --stream-compression=lz4 > ./results/parallel_basebackup.log 2>&1
+if [ $? -ne 0 ]; then
+	echo "parallel build $failed_keyword"
+	exit 1
+fi
+check_replication_setup
+wait_catchup_finish
+sleep 5
+check_counts $dn1_standby_port "parallel build"
+
+# gs_basebackup in 4 streams
+rm -rf $backup_dir
+gs_basebackup -D $backup_dir -h 127.0.0.1 -p $dn1_primary_port -Fp -Xs -j 4 -C lz4 >> ./results/parallel_basebackup.log 2>&1
+if [ $? -ne 0 ]; then
+	echo "parallel backup $failed_keyword"
+	exit 1
+fi
+
+# start the backup alone, away from the replication ports
+sed -i "/^replconninfo/d" $backup_dir/postgresql.conf
+$bin_dir/gaussdb --single_node -M normal -p $dn_temp_port -D $backup_dir > ./results/gaussdb.log 2>&1 &
+sleep 10
+check_counts $dn_temp_port "parallel backup"
+}
+
+function tear_down()
+{
+sleep 1
+$bin_dir/gs_ctl stop -D $backup_dir -m fast > ./results/gs_ctl.log 2>&1
+rm -rf $backup_dir
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists par_bb_t1; DROP TABLE if exists par_bb_t2;"
+}
+
+test_1
+tear_down
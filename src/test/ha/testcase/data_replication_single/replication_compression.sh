@@ -0,0 +1,56 @@
+#!/bin/sh
+# the standby asks for LZ4-compressed WAL and data streams, check it replays
+# the primary's row and column data and the sender reports the compression
+
+source ./standby_env.sh
+
+function check_sender_compression()
+{
+if [ $(gsql -d $db -p $dn1_primary_port -m -c "select count(*) from pg_stat_replication where compression = 'lz4' and compression_ratio is not null and compression_ratio > 1;" | grep -w 1 | wc -l) -eq 1 ]; then
+	echo "$1 compressed on dn1_primary"
+else
+	echo "$1 $failed_keyword on dn1_primary"
+	exit 1
+fi
+}
+
+function test_1()
+{
+check_instance
+
+gs_guc set -D $standby_data_dir -c "replication_compression=lz4"
+stop_standby
+start_standby
+check_replication_setup
+
+# compressible WAL for the WAL stream, CUs of a column table for the data stream
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists repl_lz4_t1; DROP TABLE if exists repl_lz4_t2;
+create table repl_lz4_t1(c1 int, c2 text);
+insert into repl_lz4_t1 select generate_series(1, 50000), repeat('compressed', 20);
+create table repl_lz4_t2(c1 int, c2 int) with (orientation = column);
+insert into repl_lz4_t2 select generate_series(1, 50000), 1;"
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+wait_catchup_finish
+sleep 5
+
+if [ $(gsql -d $db -p $dn1_standby_port -m -c "select count(*) from repl_lz4_t1;" | grep -w 50000 | wc -l) -eq 1 ] && \
+	[ $(gsql -d $db -p $dn1_standby_port -m -c "select count(*), sum(c1) from repl_lz4_t2;" | grep -E "50000 \| +1250025000" | wc -l) -eq 1 ]; then
+	echo "lz4 replication replayed on dn1_standby"
+else
+	echo "lz4 replication $failed_keyword on dn1_standby"
+	exit 1
+fi
+check_sender_compression "lz4 replication"
+}
+
+function tear_down()
+{
+sleep 1
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists repl_lz4_t1; DROP TABLE if exists repl_lz4_t2;"
+gs_guc set -D $standby_data_dir -c "replication_compression=none"
+stop_standby
+start_standby
+}
+
+test_1
+tear_down
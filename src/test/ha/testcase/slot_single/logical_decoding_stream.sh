@@ -0,0 +1,105 @@
+#!/bin/sh
+# decode transactions larger than logical_decoding_work_mem with test_decoding
+# streaming them, check the subtransactions are decoded as part of their
+# toplevel transaction and the streamed ones are committed or aborted
+
+source ./standby_env.sh
+
+slot_log=./results/logical_decoding_stream.log
+
+function decode_changes()
+{
+gsql -d $db -p $dn1_primary_port -t -A -c "set logical_decoding_work_mem = 64;
+select data from pg_logical_slot_get_changes('stream_slot', NULL, NULL, 'stream-changes', 'on', 'skip-empty-xacts', 'on', 'include-xids', 'off');" > $slot_log 2>&1
+}
+
+# check_count pattern expected what
+function check_count()
+{
+count=$(grep -c -- "$1" $slot_log)
+if [ $count -eq $2 ]; then
+	echo "$3: $count"
+else
+	echo "$3 $failed_keyword: $count, expected $2"
+	exit 1
+fi
+}
+
+function test_1()
+{
+check_instance
+
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists stream_t1; create table stream_t1(c1 int, c2 text);"
+gsql -d $db -p $dn1_primary_port -c "select * from pg_create_logical_replication_slot('stream_slot', 'test_decoding');"
+
+# a large subtransaction of a small transaction that logged its xid before is
+# no toplevel transaction of its own, it is neither streamed nor decoded once
+# rolled back
+gsql -d $db -p $dn1_primary_port -c "begin;
+insert into stream_t1 values(1, 'top');
+savepoint s1;
+insert into stream_t1 select generate_series(1, 20000), repeat('rolled back', 10);
+rollback to savepoint s1;
+insert into stream_t1 values(2, 'top');
+commit;"
+decode_changes
+check_count "INSERT:" 2 "rolled back subtransaction, inserts"
+check_count "streamed" 0 "rolled back subtransaction, streamed blocks"
+
+# the same when the subtransaction assigned the xid of its toplevel transaction
+gsql -d $db -p $dn1_primary_port -c "begin;
+savepoint s1;
+insert into stream_t1 select generate_series(1, 20000), repeat('rolled back', 10);
+rollback to savepoint s1;
+insert into stream_t1 values(3, 'top');
+commit;"
+decode_changes
+check_count "INSERT:" 1 "rolled back first subtransaction, inserts"
+check_count "streamed" 0 "rolled back first subtransaction, streamed blocks"
+
+# a large transaction is streamed, its subtransaction waits for the commit
+gsql -d $db -p $dn1_primary_port -c "begin;
+insert into stream_t1 select generate_series(1, 20000), repeat('streamed', 10);
+savepoint s1;
+insert into stream_t1 select generate_series(1, 100), 'released';
+release savepoint s1;
+commit;"
+decode_changes
+if [ $(grep -c "opening a streamed block" $slot_log) -ge 1 ]; then
+	echo "committed transaction streamed"
+else
+	echo "committed transaction $failed_keyword: not streamed"
+	exit 1
+fi
+check_count "INSERT:" 20100 "committed streamed transaction, inserts"
+check_count "'released'" 100 "committed streamed transaction, subtransaction inserts"
+check_count "committing streamed transaction" 1 "committed streamed transaction, commits"
+check_count "^BEGIN" 0 "committed streamed transaction, toplevel transactions"
+
+# a large transaction is streamed and aborted
+gsql -d $db -p $dn1_primary_port -c "begin;
+insert into stream_t1 select generate_series(1, 20000), repeat('aborted', 10);
+savepoint s1;
+insert into stream_t1 select generate_series(1, 100), 'aborted';
+release savepoint s1;
+rollback;"
+decode_changes
+if [ $(grep -c "opening a streamed block" $slot_log) -ge 1 ]; then
+	echo "aborted transaction streamed"
+else
+	echo "aborted transaction $failed_keyword: not streamed"
+	exit 1
+fi
+check_count "aborting streamed transaction" 1 "aborted streamed transaction, aborts"
+check_count "COMMIT\|committing" 0 "aborted streamed transaction, commits"
+}
+
+function tear_down()
+{
+sleep 1
+gsql -d $db -p $dn1_primary_port -c "select * from pg_drop_replication_slot('stream_slot');"
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists stream_t1;"
+}
+
+test_1
+tear_down
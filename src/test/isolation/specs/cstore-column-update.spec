@@ -0,0 +1,27 @@
+# Tests for concurrent UPDATE of column tables writing only the updated columns
+#
+# The updated values are computed under the snapshot of the UPDATE but are
+# written into a copy of the newest CU. An UPDATE of a CU changed by a
+# transaction its snapshot can not see must fail instead of overwriting the
+# newer values.
+
+setup { CREATE TABLE ccu (a int, b int) WITH (orientation = column); }
+setup { INSERT INTO ccu VALUES (1, 10), (2, 20); }
+
+teardown { DROP TABLE ccu; }
+
+session "s1"
+setup		{ START TRANSACTION; }
+step "s1u"	{ UPDATE ccu SET b = b + 1 WHERE a = 1; }
+step "s1c"	{ COMMIT; }
+
+session "s2"
+setup		{ START TRANSACTION ISOLATION LEVEL REPEATABLE READ; }
+step "s2s"	{ SELECT a, b FROM ccu ORDER BY a; }
+step "s2u"	{ UPDATE ccu SET b = b + 100 WHERE a = 1; }
+step "s2c"	{ COMMIT; }
+step "s2r"	{ SELECT a, b FROM ccu ORDER BY a; }
+
+permutation "s1u" "s2u" "s1c" "s2c" "s2r"
+permutation "s2s" "s1u" "s1c" "s2u" "s2c" "s2r"
+permutation "s1u" "s1c" "s2u" "s2c" "s2r"
@@ -0,0 +1,26 @@
+# Tests for moving the delta rows of a column table into CUs
+#
+# The merge deletes the moved rows from the delta table. An UPDATE blocked
+# by such a deletion would find its row gone and update nothing, so the
+# merge waits for the writers and keeps them out until it commits.
+#
+# Rows only go to the delta table with enable_delta_store on, which can
+# not be set per session, see the delta-store targets of the Makefile.
+
+setup { CREATE TABLE cdm (a int, b int) WITH (orientation = column, deltarow_threshold = 100); }
+setup { INSERT INTO cdm VALUES (1, 10), (2, 20); }
+
+teardown { DROP TABLE cdm; }
+
+session "s1"
+setup		{ START TRANSACTION; }
+step "s1u"	{ UPDATE cdm SET b = b + 1 WHERE a = 1; }
+step "s1c"	{ COMMIT; }
+
+session "s2"
+step "s2m"	{ VACUUM DELTAMERGE cdm; }
+step "s2u"	{ UPDATE cdm SET b = b + 100 WHERE a = 2; }
+step "s2r"	{ SELECT a, b FROM cdm ORDER BY a; }
+
+permutation "s1u" "s2m" "s1c" "s2u" "s2r"
+permutation "s2m" "s1u" "s1c" "s2u" "s2r"
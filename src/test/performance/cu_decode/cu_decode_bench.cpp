@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * cu_decode_bench.cpp
+ *      micro-benchmark of the vectorized kernels decoding CU values
+ *
+ * It decodes CU sized buffers with both the scalar and the vectorized
+ * kernels, checks that the results are the same, and reports the decoded
+ * bytes per second of each one on a single core.
+ *
+ *     cu_decode_bench [rows of CU] [rounds]
+ *
+ * IDENTIFICATION
+ *        src/test/performance/cu_decode/cu_decode_bench.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/compress_simd.h"
+
+#include <time.h>
+
+#define DEFAULT_CU_ROWS 60000
+#define DEFAULT_ROUNDS 2000
+#define RLE_MARKER_BYTE 0xFE
+
+#ifdef USE_ASSERT_CHECKING
+THR_LOCAL bool assert_enabled = true;
+
+void ExceptionalCondition(const char* conditionName, const char* errorType, const char* fileName, int lineNumber)
+{
+    fprintf(stderr, "TRAP: %s(\"%s\", File: \"%s\", Line: %d)\n", errorType, conditionName, fileName, lineNumber);
+    abort();
+}
+#endif
+
+static double NowSeconds(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double Throughput(double bytes, double seconds)
+{
+    return bytes / seconds / (1024.0 * 1024.0 * 1024.0);
+}
+
+/* returns false if the results of scalar and vectorized kernels differ */
+static bool BenchUnpackAdd(char* inbuf, char* scalarOut, char* simdOut, int rows, int rounds, short inSize,
+    short outSize)
+{
+    const int64 base = 1234567;
+    double start = NowSeconds();
+    for (int i = 0; i < rounds; ++i) {
+        ScalarUnpackAdd(inbuf, scalarOut, rows, inSize, outSize, base);
+    }
+    double scalarTime = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int i = 0; i < rounds; ++i) {
+        SimdUnpackAdd(inbuf, simdOut, rows, inSize, outSize, base);
+    }
+    double simdTime = NowSeconds() - start;
+
+    double bytes = (double)rows * outSize * rounds;
+    printf("delta  %d -> %d bytes   scalar %6.2f GB/s   simd %6.2f GB/s\n",
+        inSize, outSize, Throughput(bytes, scalarTime), Throughput(bytes, simdTime));
+    return memcmp(scalarOut, simdOut, (size_t)rows * outSize) == 0;
+}
+
+/* plain values with a RLE marker every `distance` values, which is the RLE literal copying */
+static bool BenchFindMarker(char* inbuf, int rows, int rounds, short valSize, int distance)
+{
+    for (int i = 0; i < rows * valSize; ++i) {
+        inbuf[i] = (char)(random() % RLE_MARKER_BYTE);
+    }
+    for (int i = distance - 1; i < rows; i += distance) {
+        memset(inbuf + (size_t)i * valSize, RLE_MARKER_BYTE, valSize);
+    }
+
+    int64 scalarFound = 0;
+    int64 simdFound = 0;
+    double start = NowSeconds();
+    for (int i = 0; i < rounds; ++i) {
+        for (int pos = 0; pos < rows; ++pos) {
+            pos += ScalarFindMarker(inbuf + (size_t)pos * valSize, rows - pos, valSize, RLE_MARKER_BYTE);
+            ++scalarFound;
+        }
+    }
+    double scalarTime = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int i = 0; i < rounds; ++i) {
+        for (int pos = 0; pos < rows; ++pos) {
+            pos += SimdFindMarker(inbuf + (size_t)pos * valSize, rows - pos, valSize, RLE_MARKER_BYTE);
+            ++simdFound;
+        }
+    }
+    double simdTime = NowSeconds() - start;
+
+    double bytes = (double)rows * valSize * rounds;
+    printf("rle    %d bytes, marker per %4d   scalar %6.2f GB/s   simd %6.2f GB/s\n",
+        valSize, distance, Throughput(bytes, scalarTime), Throughput(bytes, simdTime));
+    return scalarFound == simdFound;
+}
+
+int main(int argc, char** argv)
+{
+    static const short sizes[][2] = {{1, 2}, {1, 4}, {1, 8}, {2, 4}, {2, 8}, {4, 8}, {4, 4}};
+    static const short rleSizes[] = {1, 2, 4, 8};
+    int rows = (argc > 1) ? atoi(argv[1]) : DEFAULT_CU_ROWS;
+    int rounds = (argc > 2) ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    bool ok = true;
+
+    if (rows <= 0 || rounds <= 0) {
+        fprintf(stderr, "usage: %s [rows of CU] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    char* inbuf = (char*)malloc((size_t)rows * sizeof(int64));
+    char* scalarOut = (char*)malloc((size_t)rows * sizeof(int64));
+    char* simdOut = (char*)malloc((size_t)rows * sizeof(int64));
+    if (inbuf == NULL || scalarOut == NULL || simdOut == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < rows * (int)sizeof(int64); ++i) {
+        inbuf[i] = (char)random();
+    }
+
+    printf("instruction set: %s, %d rows, %d rounds\n", SimdDecodeInstructionSet(), rows, rounds);
+    for (size_t i = 0; i < lengthof(sizes); ++i) {
+        if (!BenchUnpackAdd(inbuf, scalarOut, simdOut, rows, rounds, sizes[i][0], sizes[i][1])) {
+            printf("FAILED: results differ\n");
+            ok = false;
+        }
+    }
+    for (size_t i = 0; i < lengthof(rleSizes); ++i) {
+        if (!BenchFindMarker(inbuf, rows, rounds / 10 + 1, rleSizes[i], 64) ||
+            !BenchFindMarker(inbuf, rows, rounds / 10 + 1, rleSizes[i], 1024)) {
+            printf("FAILED: results differ\n");
+            ok = false;
+        }
+    }
+
+    free(inbuf);
+    free(scalarOut);
+    free(simdOut);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is used to test the LLVM Optimization in row engine scan.
+ * It covers qual, target list and tuple deforming of row tables.
+ */
+----
+--- Create Table and Insert Data
+----
+drop schema if exists llvm_rowexpr_engine cascade;
+create schema llvm_rowexpr_engine;
+set current_schema = llvm_rowexpr_engine;
+set codegen_cost_threshold = 0;
+set enable_row_codegen = on;
+
+create table llvm_rowexpr_engine.llvm_rowexpr_table_01(
+    col_int2    int2,
+    col_int4    int4 not null,
+    col_int8    int8,
+    col_text    text,
+    col_int4_2  int4
+);
+
+insert into llvm_rowexpr_table_01 values (1, 10, 100, 'a', 5);
+insert into llvm_rowexpr_table_01 values (2, 20, NULL, NULL, 6);
+insert into llvm_rowexpr_table_01 values (NULL, 30, 300, 'ccc', NULL);
+insert into llvm_rowexpr_table_01 values (4, 2147483647, 400, 'dddd', 1);
+insert into llvm_rowexpr_table_01 values (-5, -50, -500, 'e', -7);
+
+----
+--- case 1 : qual
+----
+select col_int4, col_int8 from llvm_rowexpr_table_01 where col_int4 > 5 and col_int8 < 350 order by 1;
+select col_int2, col_int4 from llvm_rowexpr_table_01 where col_int2 is null or col_int2 = 1 order by 1;
+select col_int4 from llvm_rowexpr_table_01 where col_int4_2 + 1 >= 2 and col_int8 is not null order by 1;
+select count(*) from llvm_rowexpr_table_01 where col_int2 < 3 and col_int4 + 1 > 0;
+select count(*) from llvm_rowexpr_table_01 where col_int4 + 1 > 0;
+
+----
+--- case 2 : target list
+----
+select col_int2 + col_int2 as a, col_int4 - col_int4_2 as b, col_int2 is null as c from llvm_rowexpr_table_01 order by col_int4;
+select col_int8 * 2 from llvm_rowexpr_table_01 where col_int4 < 100 and col_int8 is not null order by 1;
+select col_int4 * 2 from llvm_rowexpr_table_01 order by 1;
+
+----
+--- case 3 : tuple deforming with nulls and varlena
+----
+select col_text, col_int4_2 from llvm_rowexpr_table_01 where col_int4_2 is not null order by col_int4_2;
+select col_int4_2, col_text, col_int2, col_int4 from llvm_rowexpr_table_01 order by col_int4;
+
+----
+--- case 4 : the same query again, reuse the cached machine code
+----
+select col_int4, col_int8 from llvm_rowexpr_table_01 where col_int4 > 5 and col_int8 < 350 order by 1;
+set codegen_cache_size = 0;
+select col_int4, col_int8 from llvm_rowexpr_table_01 where col_int4 > 5 and col_int8 < 350 order by 1;
+reset codegen_cache_size;
+
+----
+--- case 5 : a cursor keeps its machine code while later queries evict it
+----
+set codegen_cache_size = 1;
+start transaction;
+declare llvm_rowexpr_cur cursor for select col_int4, col_int8 from llvm_rowexpr_table_01 where col_int4 > 5;
+fetch 2 from llvm_rowexpr_cur;
+select count(*) from llvm_rowexpr_table_01 where col_int2 < 3;
+select count(*) from llvm_rowexpr_table_01 where col_int8 > 0;
+fetch all from llvm_rowexpr_cur;
+close llvm_rowexpr_cur;
+commit;
+reset codegen_cache_size;
+
+----
+--- case 6 : explain shows which scans run the generated code
+----
+explain (analyze on, detail on, costs off, timing off) select col_int4 from llvm_rowexpr_table_01 where col_int4 > 5 and col_int8 < 350;
+set enable_row_codegen = off;
+explain (analyze on, detail on, costs off, timing off) select col_int4 from llvm_rowexpr_table_01 where col_int4 > 5 and col_int8 < 350;
+set enable_row_codegen = on;
+
+----
+--- clean up
+----
+reset enable_row_codegen;
+reset codegen_cost_threshold;
+drop schema llvm_rowexpr_engine cascade;
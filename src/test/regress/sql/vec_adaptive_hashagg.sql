@@ -0,0 +1,56 @@
+/*
+ * This file is used to test adaptive hash agg of the lower agg in two-level aggregation
+ */
+drop schema if exists vec_adaptive_hashagg_engine cascade;
+create schema vec_adaptive_hashagg_engine;
+set current_schema = vec_adaptive_hashagg_engine;
+
+create table vec_adaptive_hashagg_table_01(
+    col_int     int,
+    col_grp     int,
+    col_num     numeric
+) with (orientation = column);
+
+insert into vec_adaptive_hashagg_table_01
+    select i, i % 100, i from generate_series(1, 20000) as i;
+analyze vec_adaptive_hashagg_table_01;
+
+-- the lines of EXPLAIN ANALYZE telling the lower agg flushed its groups
+create function vec_adaptive_hashagg_flushes(query text) returns setof text language plpgsql as $$
+declare
+    ln text;
+begin
+    for ln in execute 'explain (analyze on, costs off, timing off) ' || query loop
+        if ln like '%Flush Times:%' then
+            return next regexp_replace(trim(ln), '[0-9]+', 'N');
+        end if;
+    end loop;
+end;
+$$;
+
+-- small work_mem makes the lower agg flush its groups to the upper agg
+set query_dop = 2;
+set work_mem = '64kB';
+set enable_sonic_hashagg = off;
+set enable_adaptive_hashagg = on;
+
+-- high cardinality, the lower agg streams through a small hash table
+select count(*), sum(sum_num), sum(cnt) from
+    (select col_int, sum(col_num) as sum_num, count(*) as cnt from vec_adaptive_hashagg_table_01 group by col_int) as t;
+-- low cardinality, flushed groups are regrouped by the upper agg
+select col_grp, count(*), sum(col_num) from vec_adaptive_hashagg_table_01 group by col_grp order by col_grp limit 5;
+
+select * from vec_adaptive_hashagg_flushes('select col_int, sum(col_num) from vec_adaptive_hashagg_table_01 group by col_int');
+
+set enable_adaptive_hashagg = off;
+select count(*), sum(sum_num), sum(cnt) from
+    (select col_int, sum(col_num) as sum_num, count(*) as cnt from vec_adaptive_hashagg_table_01 group by col_int) as t;
+select col_grp, count(*), sum(col_num) from vec_adaptive_hashagg_table_01 group by col_grp order by col_grp limit 5;
+-- no flush without adaptive hash agg
+select * from vec_adaptive_hashagg_flushes('select col_int, sum(col_num) from vec_adaptive_hashagg_table_01 group by col_int');
+
+reset enable_adaptive_hashagg;
+reset enable_sonic_hashagg;
+reset work_mem;
+reset query_dop;
+drop schema vec_adaptive_hashagg_engine cascade;
@@ -0,0 +1,50 @@
+/*
+ * This file is used to test the bloom filter and value counts of CUs of column table,
+ * which skip CUs for equality on unsorted columns whose min/max cover nearly all values
+ */
+drop schema if exists vec_cstore_bloom_filter_engine cascade;
+create schema vec_cstore_bloom_filter_engine;
+set current_schema = vec_cstore_bloom_filter_engine;
+create table vec_cstore_bloom_filter_table_01(
+    col_id      int,
+    col_int     int,
+    col_text    text,
+    col_char    char(10),
+    col_null    bigint
+) with (orientation = column, max_batchrow = 10000, bloom_filter_columns = 'col_int, col_text, col_char, col_null');
+insert into vec_cstore_bloom_filter_table_01
+    select i, (i * 7919 % 50000) * 2, 'v' || ((i * 7919 % 50000) * 2), ((i * 7919 % 50000) * 2)::text,
+        case when i % 3 = 0 then null else (i * 7919 % 50000) * 2 end
+    from generate_series(1, 50000) as i;
+analyze vec_cstore_bloom_filter_table_01;
+-- values within min/max of every CU
+select count(*) from vec_cstore_bloom_filter_table_01 where col_int = 4242;
+select count(*) from vec_cstore_bloom_filter_table_01 where col_int = 4243;
+select count(*) from vec_cstore_bloom_filter_table_01 where col_int = 200000;
+select count(*) from vec_cstore_bloom_filter_table_01 where col_text = 'v4242';
+select count(*) from vec_cstore_bloom_filter_table_01 where col_text = 'v4243';
+select count(*) from vec_cstore_bloom_filter_table_01 where col_char = '4242';
+select count(*) from vec_cstore_bloom_filter_table_01 where col_char = '4243';
+select col_id from vec_cstore_bloom_filter_table_01 where col_int = 99998 and col_text = 'v99998';
+select col_id, col_char from vec_cstore_bloom_filter_table_01 where col_int = 0;
+-- NULLs are not added to the bloom filter
+select count(*) from vec_cstore_bloom_filter_table_01 where col_null = 4242;
+select count(*) from vec_cstore_bloom_filter_table_01 where col_null is null;
+-- join keys
+create table vec_cstore_bloom_filter_table_02(col_int int, col_text text) with (orientation = column);
+insert into vec_cstore_bloom_filter_table_02 values (4242, 'v4242'), (4243, 'v4243');
+select t1.col_id from vec_cstore_bloom_filter_table_01 t1 join vec_cstore_bloom_filter_table_02 t2
+    on t1.col_int = t2.col_int order by 1;
+select t1.col_id from vec_cstore_bloom_filter_table_01 t1 join vec_cstore_bloom_filter_table_02 t2
+    on t1.col_text = t2.col_text order by 1;
+-- only the CUs written later have the bloom filter of new columns
+alter table vec_cstore_bloom_filter_table_01 set (bloom_filter_columns = 'col_id, col_int');
+insert into vec_cstore_bloom_filter_table_01 values (50001, 4243, 'v4243', '4243', 4243);
+select col_id from vec_cstore_bloom_filter_table_01 where col_int = 4243;
+select col_id from vec_cstore_bloom_filter_table_01 where col_id = 50001;
+-- invalid settings
+alter table vec_cstore_bloom_filter_table_01 set (bloom_filter_columns = 'col_none');
+alter table vec_cstore_bloom_filter_table_01 set (bloom_filter_columns = 'col_int,,col_text');
+create table vec_cstore_bloom_filter_table_03(col_num numeric) with (orientation = column, bloom_filter_columns = 'col_num');
+create table vec_cstore_bloom_filter_table_03(col_int int) with (bloom_filter_columns = 'col_int');
+drop schema vec_cstore_bloom_filter_engine cascade;
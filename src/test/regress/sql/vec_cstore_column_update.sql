@@ -0,0 +1,61 @@
+/*
+ * This file is used to test the update of column table which writes
+ * only the CUs of the updated columns and keeps the ctids of the rows
+ */
+drop schema if exists vec_cstore_column_update_engine cascade;
+create schema vec_cstore_column_update_engine;
+set current_schema = vec_cstore_column_update_engine;
+set enable_cstore_column_update = on;
+create table vec_cstore_column_update_table_01(
+    col_id      int,
+    col_int     int,
+    col_text    text,
+    col_char    char(10),
+    col_same    bigint
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_cstore_column_update_table_01
+    select i, i % 100, 'v' || i, (i % 10)::text, 7 from generate_series(1, 20000) as i;
+create table vec_cstore_column_update_ctid_01 as
+    select col_id, ctid as old_ctid from vec_cstore_column_update_table_01;
+-- the updated rows keep their ctids
+update vec_cstore_column_update_table_01 set col_int = col_int + 1000, col_text = col_text || 'u' where col_id % 3 = 0;
+select count(*) from vec_cstore_column_update_table_01 t, vec_cstore_column_update_ctid_01 c
+    where t.col_id = c.col_id and t.ctid = c.old_ctid;
+select count(*), sum(col_int), sum(length(col_text)) from vec_cstore_column_update_table_01 where col_id % 3 = 0;
+select count(*) from vec_cstore_column_update_table_01 where col_int >= 1000;
+select * from vec_cstore_column_update_table_01 where col_id in (1, 2, 3, 9999, 10002, 20000) order by col_id;
+-- NULL values, CUs of the same value and CUs of NULLs
+update vec_cstore_column_update_table_01 set col_char = null where col_id <= 5;
+select col_id, col_char from vec_cstore_column_update_table_01 where col_id <= 6 order by col_id;
+update vec_cstore_column_update_table_01 set col_same = 8 where col_id = 10;
+select col_same, count(*) from vec_cstore_column_update_table_01 group by col_same order by col_same;
+update vec_cstore_column_update_table_01 set col_same = null where col_id <= 10000;
+select col_same, count(*) from vec_cstore_column_update_table_01 group by col_same order by col_same;
+update vec_cstore_column_update_table_01 set col_same = 9 where col_same is null;
+select col_same, count(*) from vec_cstore_column_update_table_01 group by col_same order by col_same;
+-- deleted rows and rollback
+delete from vec_cstore_column_update_table_01 where col_id = 4;
+update vec_cstore_column_update_table_01 set col_int = -1 where col_id <= 5;
+select col_id, col_int from vec_cstore_column_update_table_01 where col_id <= 5 order by col_id;
+start transaction;
+update vec_cstore_column_update_table_01 set col_int = -2 where col_id = 1;
+update vec_cstore_column_update_table_01 set col_int = col_int - 1 where col_id = 1;
+select col_id, col_int from vec_cstore_column_update_table_01 where col_id = 1;
+rollback;
+select col_id, col_int from vec_cstore_column_update_table_01 where col_id = 1;
+select count(*) from vec_cstore_column_update_table_01 t, vec_cstore_column_update_ctid_01 c
+    where t.col_id = c.col_id and t.ctid = c.old_ctid;
+-- the rows are inserted again if all columns are updated, an indexed column is updated or it's disabled
+update vec_cstore_column_update_table_01 set col_id = col_id, col_int = col_int, col_text = col_text,
+    col_char = col_char, col_same = col_same where col_id = 20000;
+set enable_cstore_column_update = off;
+update vec_cstore_column_update_table_01 set col_int = 1 where col_id = 19999;
+set enable_cstore_column_update = on;
+create index vec_cstore_column_update_index_01 on vec_cstore_column_update_table_01(col_char);
+update vec_cstore_column_update_table_01 set col_char = 'x' where col_id = 19998;
+select count(*) from vec_cstore_column_update_table_01 t, vec_cstore_column_update_ctid_01 c
+    where t.col_id = c.col_id and t.ctid = c.old_ctid;
+select * from vec_cstore_column_update_table_01 where col_id >= 19998 order by col_id;
+select col_id from vec_cstore_column_update_table_01 where col_char = 'x';
+reset enable_cstore_column_update;
+drop schema vec_cstore_column_update_engine cascade;
@@ -0,0 +1,47 @@
+/*
+ * This file is used to test the compression of the CUs of column table
+ * by several threads while loading
+ */
+drop schema if exists vec_cstore_compress_threads_engine cascade;
+create schema vec_cstore_compress_threads_engine;
+set current_schema = vec_cstore_compress_threads_engine;
+set cstore_compress_threads = 4;
+create table vec_cstore_compress_threads_table_01(
+    col_id      int,
+    col_int     bigint,
+    col_num     numeric(10,2),
+    col_text    text,
+    col_char    char(10),
+    col_null    int
+) with (orientation = column, max_batchrow = 10000, compression = high);
+insert into vec_cstore_compress_threads_table_01
+    select i, i * 3, (i % 1000) / 4.0, 'v' || (i % 777), (i % 10)::text, case when i % 5 = 0 then null else i end
+    from generate_series(1, 30000) as i;
+select count(*), sum(col_int), sum(col_num), count(distinct col_text), count(col_null)
+    from vec_cstore_compress_threads_table_01;
+select * from vec_cstore_compress_threads_table_01 where col_id in (1, 9999, 10000, 30000) order by col_id;
+-- the same values as compressed by the backend alone
+set cstore_compress_threads = 1;
+create table vec_cstore_compress_threads_table_02(
+    col_id      int,
+    col_int     bigint,
+    col_num     numeric(10,2),
+    col_text    text,
+    col_char    char(10),
+    col_null    int
+) with (orientation = column, max_batchrow = 10000, compression = high);
+insert into vec_cstore_compress_threads_table_02 select * from vec_cstore_compress_threads_table_01;
+select count(*) from (select * from vec_cstore_compress_threads_table_01
+    except all select * from vec_cstore_compress_threads_table_02) as t;
+-- dropped columns are skipped
+set cstore_compress_threads = 4;
+alter table vec_cstore_compress_threads_table_01 drop column col_text;
+insert into vec_cstore_compress_threads_table_01
+    select i, i * 3, (i % 1000) / 4.0, (i % 10)::text, i from generate_series(30001, 30010) as i;
+select count(*), sum(col_int), sum(col_num) from vec_cstore_compress_threads_table_01 where col_id > 30000;
+-- a table of one column is compressed by the backend
+create table vec_cstore_compress_threads_table_03(col_id int) with (orientation = column);
+insert into vec_cstore_compress_threads_table_03 select i from generate_series(1, 1000) as i;
+select count(*), sum(col_id) from vec_cstore_compress_threads_table_03;
+reset cstore_compress_threads;
+drop schema vec_cstore_compress_threads_engine cascade;
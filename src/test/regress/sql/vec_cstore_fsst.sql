@@ -0,0 +1,40 @@
+/*
+ * This file is used to test FSST compression of the string CUs of column table
+ */
+drop schema if exists vec_cstore_fsst_engine cascade;
+create schema vec_cstore_fsst_engine;
+set current_schema = vec_cstore_fsst_engine;
+set enable_cstore_fsst = on;
+-- distinct strings sharing pieces do not fit the dictionary
+create table vec_cstore_fsst_table_01(
+    col_id      int,
+    col_mail    text,
+    col_city    varchar(40)
+) with (orientation = column, max_batchrow = 10000, compression = low);
+insert into vec_cstore_fsst_table_01
+    select i, 'user_' || (i * 7919 % 100003) || '@example.com',
+        case when i % 11 = 0 then null else 'city-' || (i % 37) || '-district' end
+    from generate_series(1, 30000) as i;
+select count(*), count(distinct col_mail), sum(length(col_mail)), count(col_city), sum(length(col_city))
+    from vec_cstore_fsst_table_01;
+select * from vec_cstore_fsst_table_01 where col_id in (1, 11, 10000, 29999) order by col_id;
+select col_id from vec_cstore_fsst_table_01 where col_mail = 'user_7919@example.com';
+-- the same values at other compression levels
+create table vec_cstore_fsst_table_02(
+    col_id      int,
+    col_mail    text,
+    col_city    varchar(40)
+) with (orientation = column, max_batchrow = 10000, compression = middle);
+insert into vec_cstore_fsst_table_02 select * from vec_cstore_fsst_table_01;
+select count(*) from (select * from vec_cstore_fsst_table_01
+    except all select * from vec_cstore_fsst_table_02) as t;
+create table vec_cstore_fsst_table_03(
+    col_id      int,
+    col_mail    text,
+    col_city    varchar(40)
+) with (orientation = column, max_batchrow = 10000, compression = high);
+insert into vec_cstore_fsst_table_03 select * from vec_cstore_fsst_table_01;
+select count(*) from (select * from vec_cstore_fsst_table_01
+    except all select * from vec_cstore_fsst_table_03) as t;
+reset enable_cstore_fsst;
+drop schema vec_cstore_fsst_engine cascade;
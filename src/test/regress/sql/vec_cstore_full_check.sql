@@ -0,0 +1,41 @@
+/*
+ * This file is used to test the CUs of column table whose min/max show all the rows
+ * satisfy the scan keys, the clauses of scan keys are not evaluated on such rows
+ */
+drop schema if exists vec_cstore_full_check_engine cascade;
+create schema vec_cstore_full_check_engine;
+set current_schema = vec_cstore_full_check_engine;
+create table vec_cstore_full_check_table_01(
+    col_int     int,
+    col_same    int,
+    col_bigint  bigint,
+    col_date    date
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_cstore_full_check_table_01
+    select i, 5, i * 10, date '2020-01-01' + i from generate_series(1, 50000) as i;
+insert into vec_cstore_full_check_table_01 values (null, 5, null, null);
+analyze vec_cstore_full_check_table_01;
+-- part of CUs fully satisfy the range
+select count(*) from vec_cstore_full_check_table_01 where col_int > 15000;
+select count(*) from vec_cstore_full_check_table_01 where col_int >= 10001 and col_int <= 30000;
+select count(*) from vec_cstore_full_check_table_01 where col_bigint < 100000;
+select count(*) from vec_cstore_full_check_table_01 where col_date > date '2020-01-01' + 40000;
+-- the timestamp is truncated to a date for the scan key, its clause is kept on full hit CUs
+select count(*) from vec_cstore_full_check_table_01 where col_date >= timestamp '2020-01-02 12:00:00';
+-- other clauses are still evaluated
+select count(*), sum(col_int) from vec_cstore_full_check_table_01 where col_int > 15000 and col_int % 2 = 0;
+-- CU with the same value is compared once
+select count(*) from vec_cstore_full_check_table_01 where col_same = 5;
+select count(*) from vec_cstore_full_check_table_01 where col_same <> 5;
+select col_int from vec_cstore_full_check_table_01 where col_same = 5 and col_int <= 3 order by col_int;
+select col_int from vec_cstore_full_check_table_01 where col_same = 5 and col_int is null;
+-- a key without full check keeps the rough checks of the keys after it
+create table vec_cstore_full_check_table_02(
+    col_text    text,
+    col_int     int
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_cstore_full_check_table_02
+    select 'row' || (i % 10), i from generate_series(1, 30000) as i;
+select count(*) from vec_cstore_full_check_table_02 where col_text = 'row1' and col_int > 15000;
+select count(*) from vec_cstore_full_check_table_02 where col_text >= 'row0' and col_int > 25000;
+drop schema vec_cstore_full_check_engine cascade;
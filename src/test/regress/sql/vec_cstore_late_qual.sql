@@ -0,0 +1,28 @@
+/*
+ * This file is used to test the columns of column table only referenced by
+ * the clauses other than the scan keys, they are read after the scan keys
+ */
+drop schema if exists vec_cstore_late_qual_engine cascade;
+create schema vec_cstore_late_qual_engine;
+set current_schema = vec_cstore_late_qual_engine;
+create table vec_cstore_late_qual_table_01(
+    col_int     int,
+    col_text    text,
+    col_pay     int
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_cstore_late_qual_table_01
+    select i, 'v' || i, i * 2 from generate_series(1, 50000) as i;
+analyze vec_cstore_late_qual_table_01;
+-- the text column is read for the rows satisfying the scan keys
+select count(*) from vec_cstore_late_qual_table_01 where col_int > 40000 and col_text like '%7';
+select * from vec_cstore_late_qual_table_01 where col_int <= 10 and col_text like 'v1%' order by col_int;
+select count(*) from vec_cstore_late_qual_table_01 where col_int > 100000 and col_text like 'x%';
+-- CUs fully satisfying the scan keys
+select count(*), sum(col_pay) from vec_cstore_late_qual_table_01 where col_int > 10000 and col_text like '%5';
+-- the clause referencing both the scan key column and the late read column
+select col_int, col_text from vec_cstore_late_qual_table_01 where col_int < 100 and length(col_text) + col_int = 102;
+-- deleted rows
+delete from vec_cstore_late_qual_table_01 where col_int % 10 = 7;
+select count(*) from vec_cstore_late_qual_table_01 where col_int > 40000 and col_text like '%7';
+select count(*), sum(col_pay) from vec_cstore_late_qual_table_01 where col_int > 40000 and col_text like '%3';
+drop schema vec_cstore_late_qual_engine cascade;
@@ -0,0 +1,36 @@
+/*
+ * This file is used to test decoding delta and RLE values of CUs with vector
+ * instructions, whose results must equal the ones of the scalar decoding
+ */
+drop schema if exists vec_cstore_simd_decode_engine cascade;
+create schema vec_cstore_simd_decode_engine;
+set current_schema = vec_cstore_simd_decode_engine;
+create table vec_cstore_simd_decode_src(
+    col_run     bigint,
+    col_mixed   int,
+    col_delta1  bigint,
+    col_delta2  int,
+    col_delta4  bigint,
+    col_small   smallint,
+    col_neg     int,
+    col_null    int
+);
+insert into vec_cstore_simd_decode_src
+    select i / 50, case when i % 1000 < 500 then 7 else i end, 1000000000000 + i % 200,
+        100000 + (i * 7) % 60000, (i * 7919) % 100000000, i % 300 - 150, -(i % 1000),
+        case when i % 13 = 0 then null else i % 97 end
+    from generate_series(1, 100000) as i;
+-- the CUs of both tables are the same, one is decoded by the scalar path and the other by the vector path
+create table vec_cstore_simd_decode_scalar (like vec_cstore_simd_decode_src) with (orientation = column, compression = low);
+create table vec_cstore_simd_decode_vector (like vec_cstore_simd_decode_src) with (orientation = column, compression = low);
+insert into vec_cstore_simd_decode_scalar select * from vec_cstore_simd_decode_src;
+insert into vec_cstore_simd_decode_vector select * from vec_cstore_simd_decode_src;
+set enable_cstore_simd_decode = off;
+select count(*) from (select * from vec_cstore_simd_decode_scalar except all select * from vec_cstore_simd_decode_src) as d;
+select count(*) from (select * from vec_cstore_simd_decode_src except all select * from vec_cstore_simd_decode_scalar) as d;
+reset enable_cstore_simd_decode;
+select count(*) from (select * from vec_cstore_simd_decode_vector except all select * from vec_cstore_simd_decode_src) as d;
+select count(*) from (select * from vec_cstore_simd_decode_src except all select * from vec_cstore_simd_decode_vector) as d;
+select count(*), sum(col_run), sum(col_mixed), sum(col_delta1), sum(col_delta2), sum(col_delta4),
+    sum(col_small), sum(col_neg), sum(col_null), count(col_null) from vec_cstore_simd_decode_vector;
+drop schema vec_cstore_simd_decode_engine cascade;
@@ -0,0 +1,78 @@
+/*
+ * This file is used to test Z-order clustering of column table
+ */
+drop schema if exists vec_cstore_zorder_engine cascade;
+create schema vec_cstore_zorder_engine;
+set current_schema = vec_cstore_zorder_engine;
+-- invalid cluster order
+create table vec_cstore_zorder_table_00(a int, b int) with (orientation = column, cluster_order = 'hilbert');
+create table vec_cstore_zorder_table_00(a int, b int) with (cluster_order = 'zorder');
+-- rows are Z-ordered by all the partial cluster keys
+create table vec_cstore_zorder_table_01(
+    col_a   int,
+    col_b   bigint,
+    col_c   text,
+    partial cluster key(col_a, col_b)
+) with (orientation = column, cluster_order = 'zorder');
+insert into vec_cstore_zorder_table_01
+    select i % 100, i / 100, 'row_' || i from generate_series(1, 20000) as i;
+select count(*), sum(col_a), sum(col_b), count(distinct col_c) from vec_cstore_zorder_table_01;
+select count(*) from vec_cstore_zorder_table_01
+    where col_a between 10 and 19 and col_b between 50 and 59;
+select * from vec_cstore_zorder_table_01 where col_c in ('row_1', 'row_20000') order by 1;
+-- VACUUM FULL sorts all the rows of relation once
+vacuum full vec_cstore_zorder_table_01;
+select count(*), sum(col_a), sum(col_b), count(distinct col_c) from vec_cstore_zorder_table_01;
+select count(*) from vec_cstore_zorder_table_01
+    where col_a between 10 and 19 and col_b between 50 and 59;
+select * from vec_cstore_zorder_table_01 where col_c in ('row_1', 'row_20000') order by 1;
+-- back to lexical order
+alter table vec_cstore_zorder_table_01 set (cluster_order = 'lexical');
+vacuum full vec_cstore_zorder_table_01;
+select count(*), sum(col_a), sum(col_b), count(distinct col_c) from vec_cstore_zorder_table_01;
+select count(*) from vec_cstore_zorder_table_01
+    where col_a between 10 and 19 and col_b between 50 and 59;
+-- keys of string and NULL
+create table vec_cstore_zorder_table_02(
+    col_a   varchar(20),
+    col_b   float8,
+    col_c   numeric(10, 2),
+    partial cluster key(col_a, col_b, col_c)
+) with (orientation = column, cluster_order = 'zorder')
+partition by range (col_c) (
+    partition p1 values less than (100),
+    partition p2 values less than (maxvalue)
+);
+insert into vec_cstore_zorder_table_02
+    select case when i % 7 = 0 then null else 'key_' || (i % 50) end,
+        case when i % 5 = 0 then null else (i % 30) - 15.5 end, (i % 200) + 0.25
+    from generate_series(1, 6000) as i;
+vacuum full vec_cstore_zorder_table_02;
+select count(*), count(col_a), count(col_b), sum(col_b), sum(col_c) from vec_cstore_zorder_table_02;
+select count(*) from vec_cstore_zorder_table_02 partition (p1);
+select count(*) from vec_cstore_zorder_table_02 where col_a = 'key_1' and col_b < 0;
+-- vacuum re-clusters the CUs overlapping in the partial cluster key online
+create table vec_cstore_zorder_table_03(
+    col_a   int,
+    col_b   int,
+    partial cluster key(col_a)
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_cstore_zorder_table_03 select i * 7919 % 20000, i from generate_series(1, 20000) as i;
+insert into vec_cstore_zorder_table_03 select i * 7919 % 20000, i + 20000 from generate_series(1, 20000) as i;
+insert into vec_cstore_zorder_table_03 select i * 7919 % 20000, i + 40000 from generate_series(1, 20000) as i;
+delete from vec_cstore_zorder_table_03 where col_b = 5;
+vacuum vec_cstore_zorder_table_03;
+select count(distinct split_part(ltrim(ctid::text, '('), ',', 1)) from vec_cstore_zorder_table_03 where col_a < 100;
+set cstore_recluster_cus = 100;
+vacuum vec_cstore_zorder_table_03;
+select count(distinct split_part(ltrim(ctid::text, '('), ',', 1)) from vec_cstore_zorder_table_03 where col_a < 100;
+select count(distinct split_part(ltrim(ctid::text, '('), ',', 1)) from vec_cstore_zorder_table_03;
+select count(*), sum(col_a), sum(col_b), count(distinct col_b) from vec_cstore_zorder_table_03;
+select * from vec_cstore_zorder_table_03 where col_b in (4, 5, 6) order by col_b;
+create table vec_cstore_zorder_ctid_03 as select col_b, ctid as old_ctid from vec_cstore_zorder_table_03;
+-- the CUs do not overlap any more
+vacuum vec_cstore_zorder_table_03;
+select count(*) from vec_cstore_zorder_table_03 t, vec_cstore_zorder_ctid_03 c
+    where t.col_b = c.col_b and t.ctid = c.old_ctid;
+reset cstore_recluster_cus;
+drop schema vec_cstore_zorder_engine cascade;
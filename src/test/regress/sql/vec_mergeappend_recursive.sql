@@ -0,0 +1,70 @@
+/*
+ * This file is used to test vectorized merge append and recursive union
+ */
+drop schema if exists vec_mergeappend_recursive_engine cascade;
+create schema vec_mergeappend_recursive_engine;
+set current_schema = vec_mergeappend_recursive_engine;
+
+-- the merge append and recursive union operators of EXPLAIN (costs off)
+create function vec_mergeappend_recursive_nodes(query text) returns setof text language plpgsql as $$
+declare
+    ln text;
+begin
+    for ln in execute 'explain (costs off) ' || query loop
+        if ln ~ '(Merge Append|Recursive Union|WorkTable Scan)' then
+            return next regexp_replace(ln, '^[ ->]*', '');
+        end if;
+    end loop;
+end;
+$$;
+
+create table vec_recursive_tree_01(
+    id      int,
+    parent  int
+) with (orientation = column);
+
+insert into vec_recursive_tree_01 select i, (i - i % 2) / 2 from generate_series(1, 5000) as i;
+
+-- walk the tree level by level, the recursive term joins the column table with the worktable,
+-- the deepest levels hold more rows than a batch
+select vec_mergeappend_recursive_nodes('with recursive r(id, depth) as (
+    select id, 1 from vec_recursive_tree_01 where parent = 0
+    union all
+    select t.id, r.depth + 1 from vec_recursive_tree_01 t, r where t.parent = r.id
+)
+select depth, count(*), sum(id) from r group by depth order by depth');
+with recursive r(id, depth) as (
+    select id, 1 from vec_recursive_tree_01 where parent = 0
+    union all
+    select t.id, r.depth + 1 from vec_recursive_tree_01 t, r where t.parent = r.id
+)
+select depth, count(*), sum(id) from r group by depth order by depth;
+
+-- a long recursion with a filter and a projection on the worktable
+with recursive s(n) as (
+    select min(id) from vec_recursive_tree_01
+    union all
+    select n + 1 from s where n < 2000
+)
+select count(*), sum(n) from s;
+
+create table vec_mergeappend_01(v int) with (orientation = column);
+create table vec_mergeappend_02(v int) with (orientation = column);
+insert into vec_mergeappend_01 select i * 2 from generate_series(1, 5000) as i;
+insert into vec_mergeappend_02 select i * 3 from generate_series(1, 5000) as i;
+
+-- ordered union all of sorted inputs, interleaved over several batches
+select vec_mergeappend_recursive_nodes('select v from ((select v from vec_mergeappend_01 order by v)
+    union all (select v from vec_mergeappend_02 order by v)) order by v limit 10 offset 4995');
+select v from ((select v from vec_mergeappend_01 order by v)
+    union all (select v from vec_mergeappend_02 order by v)) order by v limit 10 offset 4995;
+
+-- disjoint inputs, the second one sorts first and is copied a run at a time
+create table vec_mergeappend_03(v int) with (orientation = column);
+create table vec_mergeappend_04(v int) with (orientation = column);
+insert into vec_mergeappend_03 select i from generate_series(3001, 6000) as i;
+insert into vec_mergeappend_04 select i from generate_series(1, 3000) as i;
+select v from ((select v from vec_mergeappend_03 order by v)
+    union all (select v from vec_mergeappend_04 order by v)) order by v limit 5 offset 2998;
+
+drop schema vec_mergeappend_recursive_engine cascade;
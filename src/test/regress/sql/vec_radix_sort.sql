@@ -0,0 +1,42 @@
+/*
+ * This file is used to test radix sort of vector sort on integer leading keys
+ */
+drop schema if exists vec_radix_sort_engine cascade;
+create schema vec_radix_sort_engine;
+set current_schema = vec_radix_sort_engine;
+
+create table vec_radix_sort_table_01(
+    col_int     int,
+    col_bint    bigint,
+    col_sint    smallint
+) with (orientation = column);
+
+insert into vec_radix_sort_table_01
+    select case when i % 100 = 0 then null else (i * 37) % 1000 - 500 end,
+           i,
+           (i % 50) - 25
+    from generate_series(1, 2000) as i;
+
+set enable_vector_radix_sort = on;
+
+-- offset + limit keeps the bound above half of the input, so the rows are sorted in memory
+select col_int, col_bint from vec_radix_sort_table_01 order by col_int, col_bint offset 1975 limit 10;
+select col_int, col_bint from vec_radix_sort_table_01 order by col_int desc nulls last, col_bint desc offset 1975 limit 10;
+select col_int, col_bint from vec_radix_sort_table_01 order by col_int nulls first, col_bint desc offset 1000 limit 6;
+select col_sint, col_bint from vec_radix_sort_table_01 order by col_sint desc, col_bint offset 1990 limit 10;
+select col_bint from vec_radix_sort_table_01 order by col_bint desc offset 1995 limit 5;
+
+-- a low rows-per-thread bound splits the input over several threads, the
+-- full outputs must match the ones of the comparator-based sort below
+set vector_sort_threads = 4;
+set vector_sort_rows_per_thread = 256;
+select col_int, col_bint from vec_radix_sort_table_01 order by col_int, col_bint offset 1975 limit 10;
+select md5(string_agg(col_bint::text, ',')) from (select col_bint from vec_radix_sort_table_01 order by col_int, col_bint) s;
+select md5(string_agg(col_bint::text, ',')) from (select col_bint from vec_radix_sort_table_01 order by col_int desc, col_bint desc) s;
+reset vector_sort_rows_per_thread;
+reset vector_sort_threads;
+
+reset enable_vector_radix_sort;
+select md5(string_agg(col_bint::text, ',')) from (select col_bint from vec_radix_sort_table_01 order by col_int, col_bint) s;
+select md5(string_agg(col_bint::text, ',')) from (select col_bint from vec_radix_sort_table_01 order by col_int desc, col_bint desc) s;
+drop schema vec_radix_sort_engine cascade;
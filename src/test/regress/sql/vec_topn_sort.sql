@@ -0,0 +1,56 @@
+/*
+ * This file is used to test top-N sort of vector engine, the boundary of the bounded
+ * heap filters input rows and is pushed down to skip CUs of the column table below
+ */
+drop schema if exists vec_topn_sort_engine cascade;
+create schema vec_topn_sort_engine;
+set current_schema = vec_topn_sort_engine;
+create table vec_topn_sort_table_01(
+    col_int     int,
+    col_text    text,
+    col_mod     int
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_topn_sort_table_01
+    select i, 'val' || lpad(i::text, 5, '0'), i % 7 from generate_series(1, 50000) as i;
+insert into vec_topn_sort_table_01 values (null, null, 0);
+analyze vec_topn_sort_table_01;
+-- CUs of the column table a query of this session finds in cstore buffers or reads from disk
+create function vec_topn_sort_cu_reads(query text) returns bigint language plpgsql as $$
+declare
+    reads_before bigint;
+    reads_after bigint;
+begin
+    select sum(value) into reads_before from gs_session_stat
+        where split_part(sessid, '.', 2) = pg_current_sessid()::text
+        and statname in ('n_cu_mem_hit', 'n_cu_hdd_sync_read', 'n_cu_hdd_asyn_read');
+    execute query;
+    select sum(value) into reads_after from gs_session_stat
+        where split_part(sessid, '.', 2) = pg_current_sessid()::text
+        and statname in ('n_cu_mem_hit', 'n_cu_hdd_sync_read', 'n_cu_hdd_asyn_read');
+    return reads_after - reads_before;
+end;
+$$;
+-- leading sort key in ascending and descending order
+select col_int from vec_topn_sort_table_01 order by col_int limit 5;
+select col_int from vec_topn_sort_table_01 order by col_int desc limit 5;
+-- once the heap is full after the first CU, the 4 other CUs of col_int and the CU of the
+-- null row are skipped by their min/max, a full scan reads the 5 CUs holding values
+select vec_topn_sort_cu_reads('select col_int from vec_topn_sort_table_01 order by col_int limit 5') as topn_reads,
+    vec_topn_sort_cu_reads('select sum(col_int) from vec_topn_sort_table_01') as full_reads;
+-- nulls are kept unless they sort after the boundary
+select col_int from vec_topn_sort_table_01 order by col_int desc nulls last limit 3;
+select col_int from vec_topn_sort_table_01 order by col_int nulls first limit 3;
+select col_text from vec_topn_sort_table_01 where col_text is not null order by col_text desc limit 3;
+-- more sort keys, offset and filter
+select col_mod, col_int from vec_topn_sort_table_01 order by col_mod, col_int limit 5 offset 2;
+select col_int from vec_topn_sort_table_01 where col_mod = 3 order by col_int desc nulls last limit 3;
+select count(*) from (select col_int from vec_topn_sort_table_01 order by col_int limit 30000) as t;
+-- ties on the leading key in every CU, the winners on the second key are in the last CU
+create table vec_topn_sort_table_02(
+    col_key     int,
+    col_seq     int
+) with (orientation = column, max_batchrow = 10000);
+insert into vec_topn_sort_table_02 select i % 3, 30001 - i from generate_series(1, 30000) as i;
+select col_key, col_seq from vec_topn_sort_table_02 order by col_key, col_seq limit 5;
+select col_key, col_seq from vec_topn_sort_table_02 order by col_key desc, col_seq limit 3;
+drop schema vec_topn_sort_engine cascade;